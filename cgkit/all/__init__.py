@@ -70,7 +70,10 @@ from cgkit.boxgeom import BoxGeom
 from cgkit.planegeom import PlaneGeom
 from cgkit.trimeshgeom import TriMeshGeom
 from cgkit.polyhedrongeom import PolyhedronGeom
+from cgkit.subdivisiongeom import SubdivisionGeom
+from cgkit.skingeom import SkinGeom
 from cgkit.drawgeom import DrawGeom
+from cgkit.lodgeom import LODGeom
 from cgkit.beziercurvegeom import BezierCurveGeom, BezierPoint
 
 ### Geometry world objects:
@@ -112,6 +115,7 @@ from cgkit.group import Group
 from cgkit.tunnel import Tunnel
 from cgkit.flockofbirds import FlockOfBirds
 from cgkit.valuetable import ValueTable
+from cgkit.animcurveset import AnimCurveSet
 from cgkit.expression import Expression
 from cgkit.euleradapter import EulerAdapter
 from cgkit.pidcontroller import PIDController
@@ -120,6 +124,7 @@ from cgkit.slideshow import SlideShow, Slide, XFade, XCube
 from cgkit.motionpath import MotionPath
 
 from cgkit.glrenderer import GLRenderInstance
+from cgkit.softrenderer import SoftRenderer
 
 from cgkit.joystick import Joystick
 
@@ -0,0 +1,137 @@
+# ***** BEGIN LICENSE BLOCK *****
+# Version: MPL 1.1/GPL 2.0/LGPL 2.1
+#
+# The contents of this file are subject to the Mozilla Public License Version
+# 1.1 (the "License"); you may not use this file except in compliance with
+# the License. You may obtain a copy of the License at
+# http://www.mozilla.org/MPL/
+#
+# Software distributed under the License is distributed on an "AS IS" basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Original Code is the Python Computer Graphics Kit.
+#
+# The Initial Developer of the Original Code is Matthias Baas.
+# Portions created by the Initial Developer are Copyright (C) 2004
+# the Initial Developer. All Rights Reserved.
+#
+# Contributor(s):
+#
+# Alternatively, the contents of this file may be used under the terms of
+# either the GNU General Public License Version 2 or later (the "GPL"), or
+# the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+# in which case the provisions of the GPL or the LGPL are applicable instead
+# of those above. If you wish to allow use of your version of this file only
+# under the terms of either the GPL or the LGPL, and not to allow others to
+# use your version of this file under the terms of the MPL, indicate your
+# decision by deleting the provisions above and replace them with the notice
+# and other provisions required by the GPL or the LGPL. If you do not delete
+# the provisions above, a recipient may use your version of this file under
+# the terms of any one of the MPL, the GPL or the LGPL.
+#
+# ***** END LICENSE BLOCK *****
+
+## \file animcurveset.py
+## Contains the AnimCurveSet class.
+
+import _core
+import protocols
+from Interfaces import ISceneItem
+from scene import getScene
+from cgtypes import *
+
+# AnimCurveSet
+class AnimCurveSet(_core.AnimCurveSet):
+    """A set of keyframe curves that drive output slots.
+
+    The time slot is connected to the time slot of the timer. channels
+    is a list of (name, type) tuples that are passed to addChannel().
+    """
+
+    protocols.advise(instancesProvide=[ISceneItem])
+
+    def __init__(self,
+                 name = "AnimCurveSet",
+                 channels = [],
+                 modulo = None,
+                 tscale = 1.0,
+                 auto_insert = True):
+        """Constructor.
+
+        \param name (\c str) Component name
+        \param channels A list of tuples (name, type)
+        \param modulo (\c float) Loop duration (None = no loop)
+        \param tscale (\c float) Scaling factor for the time. A value of less than 1.0 makes the animation slower.
+        """
+        _core.AnimCurveSet.__init__(self, name)
+
+        if modulo!=None:
+            self.modulo = modulo
+        self.tscale = tscale
+
+        for chname,chtype in channels:
+            self.addChannel(chname, chtype)
+
+        getScene().timer().time_slot.connect(self.time_slot)
+
+        if auto_insert:
+            getScene().insert(self)
+
+    def protocols(self):
+        return [ISceneItem]
+
+    # setChannelKeys
+    def setChannelKeys(self, name, times, values, interpolation="linear"):
+        """Replace the keys of a channel.
+
+        The values must match the type of the channel (vec3 values
+        are split into the three curves of the channel, the values of
+        quat and mat3 channels may be quats or matrices).
+
+        \param name (\c str) Channel name
+        \param times A sequence of times in ascending order
+        \param values A sequence of values
+        \param interpolation (\c str) "step", "linear" or "hermite"
+        """
+        idx = self._channelIndex(name)
+        curve = self.channelCurve(idx)
+        type = self.channelType(idx)
+        if type=="double":
+            self.setKeys(curve, times, values, interpolation)
+        elif type=="vec3":
+            for i in range(3):
+                self.setKeys(curve+i, times, map(lambda v: v[i], values), interpolation)
+        else:
+            self.setQuatKeys(curve, times, values, interpolation)
+
+    # setChannelSampledKeys
+    def setChannelSampledKeys(self, name, t0, dt, values, interpolation="linear"):
+        """Replace the keys of a channel with equally spaced keys.
+
+        \param name (\c str) Channel name
+        \param t0 (\c float) Time of the first key
+        \param dt (\c float) Time step between two keys
+        \param values A sequence of values
+        \param interpolation (\c str) "step", "linear" or "hermite"
+        \see setChannelKeys()
+        """
+        idx = self._channelIndex(name)
+        curve = self.channelCurve(idx)
+        type = self.channelType(idx)
+        if type=="double":
+            self.setSampledKeys(curve, t0, dt, values, interpolation)
+        elif type=="vec3":
+            for i in range(3):
+                self.setSampledKeys(curve+i, t0, dt, map(lambda v: v[i], values), interpolation)
+        else:
+            self.setSampledQuatKeys(curve, t0, dt, values, interpolation)
+
+    ## protected:
+
+    def _channelIndex(self, name):
+        idx = self.findChannel(name)
+        if idx==-1:
+            raise KeyError, 'Channel "%s" does not exist.'%name
+        return idx
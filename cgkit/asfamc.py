@@ -38,6 +38,11 @@
 ## Contains the ASFReader and AMCReader class.
 
 import string
+try:
+    import _core
+    _AMCParser = getattr(_core, "AMCParser", None)
+except ImportError:
+    _AMCParser = None
 
 # ReaderBase
 class ReaderBase:
@@ -389,6 +394,10 @@ class AMCReader(ReaderBase):
 
     - onFrame(framenr, data)
 
+    If the native parser from the _core module is available, the file
+    is parsed in one go and the motion samples are passed to
+    onMotionData() as a MotionData object (the default implementation
+    calls onFrame() for every frame).
     """
 
     def __init__(self, filename):
@@ -398,8 +407,23 @@ class AMCReader(ReaderBase):
         pass
 #        print framenr, data
 
+    def onMotionData(self, motion, framenumbers):
+        for i in range(motion.numFrames()):
+            values = motion.frame(i)
+            data = []
+            for j in range(motion.numTracks()):
+                c = motion.trackChannel(j)
+                data.append((motion.trackName(j), values[c:c+motion.trackSize(j)]))
+            self.onFrame(framenumbers[i], data)
+
     # read
     def read(self):
+        if _AMCParser!=None:
+            parser = _AMCParser()
+            parser.read(self.filename)
+            self.onMotionData(parser.motion, parser.frameNumbers())
+            return
+        
         self.fhandle = file(self.filename)
 
         while 1:
@@ -34,12 +34,13 @@
 # ***** END LICENSE BLOCK *****
 # $Id: asfamcimport.py,v 1.2 2005/04/21 17:25:45 mbaas Exp $
 
-import os.path, glob
+import os.path, glob, math
 from cgtypes import *
 from quadrics import Sphere
 from joint import Joint
-from valuetable import ValueTable
+from animcurveset import AnimCurveSet
 import asfamc
+import _core
 import pluginmanager
 from sl import *
 
@@ -144,10 +145,13 @@ class AMCReader(asfamc.AMCReader):
     """Specialized AMC reader class.
 
     When reading the AMC file, the content is just read and stored
-    in self.values.
+    in self.motion (or in self.values if the file was parsed in Python).
     Once the data is read, the applyMotion() method has to be called
     which takes an instance of an ASFReader class and the framerate
-    of the data as input.
+    of the data as input. The motion is stored in an AnimCurveSet
+    component (attribute curves) whose output slots are connected to
+    the joints. Each frame is held until the next one (just like the
+    BVH importer does).
     """
 
     def __init__(self, filename):
@@ -155,6 +159,9 @@ class AMCReader(asfamc.AMCReader):
 
         # Key: Bone name  Value: A list of values (one sublist per frame)
         self.values = {}
+        # MotionData object (if the native parser was used)
+        self.motion = None
+        self.curves = None
 
     def onFrame(self, framenr, data):
         for name,values in data:
@@ -162,6 +169,9 @@ class AMCReader(asfamc.AMCReader):
                 self.values[name] = []
             self.values[name].append(values)
 
+    def onMotionData(self, motion, framenumbers):
+        self.motion = motion
+
     def applyMotion(self, asf, framerate=25):
         """Apply the motion to a previously read skeleton.
 
@@ -169,49 +179,38 @@ class AMCReader(asfamc.AMCReader):
         framerate is the rate that was used to record the motion data.
         """
 
-        for name in self.values.keys():
-            track = self.values[name]
+        motion = self.motion
+        if motion==None:
+            motion = self.createMotionData()
+
+        dt = 1.0/framerate
+        total_t = motion.numFrames()*dt
+        self.curves = AnimCurveSet(name="AMC_Motion", modulo=total_t)
+        for i in range(motion.numTracks()):
+            name = motion.trackName(i)
             print name,
             if name=="root":
-                self.applyRootTrack(asf, track, framerate)
+                self.applyRootTrack(asf, motion, i, dt)
             else:
-                self.applyBoneTrack(asf, name, track, framerate)
+                self.applyBoneTrack(asf, motion, i, dt)
         print ""
 
-    def applyBoneTrack(self, asf, name, track, framerate):
+    def applyBoneTrack(self, asf, motion, track, dt):
+        name = motion.trackName(track)
         data = asf.bones[name]
         order = data["dof"]
         order = map(lambda s: s.lower(), order)
-        vtabx = []
-        vtaby = []
-        vtabz = []
-        framenr = 0
-        for vals in track:
-            t = float(framenr)/framerate
-            d = self.valueDict(vals, order)
-            if "rx" in d:
-                vtabx.append((t,d["rx"]))
-            if "ry" in d:
-                vtaby.append((t,d["ry"]))
-            if "rz" in d:
-                vtabz.append((t,d["rz"]))
-            framenr += 1
-
-        total_t = float(framenr)/framerate
+        channels = self.channelDict(motion, track, order)
 
         joint = asf.joints[name]
-        if vtabx!=[]:
-            vt = ValueTable(type="double", values=vtabx, modulo=total_t)
-            vt.output_slot.connect(joint.anglex_slot)
-        if vtaby!=[]:
-            vt = ValueTable(type="double", values=vtaby, modulo=total_t)
-            vt.output_slot.connect(joint.angley_slot)
-        if vtabz!=[]:
-            vt = ValueTable(type="double", values=vtabz, modulo=total_t)
-            vt.output_slot.connect(joint.anglez_slot)
-            
+        for dof in ["rx", "ry", "rz"]:
+            if dof in channels:
+                chname = "%s_angle%s"%(name, dof[1])
+                idx = self.curves.addChannel(chname, "double")
+                self.curves.setMotionKeys(self.curves.channelCurve(idx), motion, channels[dof], 0.0, dt, interpolation="step")
+                self.curves.slot(chname).connect(getattr(joint, "angle%s_slot"%dof[1]))
 
-    def applyRootTrack(self, asf, track, framerate):
+    def applyRootTrack(self, asf, motion, track, dt):
 
         len_scale = asf.len_scale
         data = asf.bones["root"]
@@ -219,29 +218,58 @@ class AMCReader(asfamc.AMCReader):
         order = map(lambda s: s.lower(), order)
         ao = data["axis_order"]
         axis_order = ao[2]+ao[1]+ao[0]
-        vtab = []
-        vtabrot = []
-        framenr = 0
-        for vals in track:
-            t = float(framenr)/framerate
-            d = self.valueDict(vals, order)
-            pos = len_scale*vec3(d["tx"], d["ty"], d["tz"])
-            vtab.append((t, pos))
-            
-            ang = vec3(d["rx"], d["ry"], d["rz"])
-            exec "fromEuler = mat3.fromEuler%s"%axis_order.upper()
-            R = fromEuler(radians(ang.x), radians(ang.y), radians(ang.z))
-            vtabrot.append((t, R))
-            
-            framenr += 1
-
-        total_t = float(framenr)/framerate
+        channels = self.channelDict(motion, track, order)
+
+        root = asf.joints["root"]
+        idx = self.curves.addChannel("root_pos", "vec3")
+        curve = self.curves.channelCurve(idx)
+        for i,dof in enumerate(["tx", "ty", "tz"]):
+            self.curves.setMotionKeys(curve+i, motion, channels[dof], 0.0, dt, len_scale, "step")
+        self.curves.slot("root_pos").connect(root.pos_slot)
+
+        idx = self.curves.addChannel("root_rot", "mat3")
+        angles = (channels["rx"], channels["ry"], channels["rz"])
+        self.curves.setMotionQuatKeys(self.curves.channelCurve(idx), motion, angles, axis_order, 0.0, dt, math.pi/180.0, "step")
+        self.curves.slot("root_rot").connect(root.rot_slot)
+
+    # createMotionData
+    def createMotionData(self):
+        """Create a MotionData object from the values collected by onFrame().
+        """
+        motion = _core.MotionData()
+        names = self.values.keys()
+        numframes = 0
+        for name in names:
+            track = self.values[name]
+            motion.addTrack(name, len(track[0]))
+            numframes = len(track)
+        motion.setNumFrames(numframes)
+        for i in range(len(names)):
+            track = self.values[names[i]]
+            if len(track)!=numframes:
+                raise ValueError, "Bone %s has an invalid number of frames"%names[i]
+            c = motion.trackChannel(i)
+            for j in range(motion.trackSize(i)):
+                motion.setChannel(c+j, map(lambda vals: vals[j], track))
+        return motion
+
+    # channelDict
+    def channelDict(self, motion, track, order):
+        """Return a dictionary with the channel indices of a track.
+
+        order must be a sequence of strings where each string defines
+        the meaning of the corresponding channel in the track.
+        Example: order = ["tx", "ty", "tz"]
+        Result: {"tx":c, "ty":c+1, "tz":c+2}  (c is the first channel of the track)
+        """
+        if len(order)!=motion.trackSize(track):
+            raise ValueError, "Invalid number of values"
 
-        vt = ValueTable(values=vtab, modulo=total_t)
-        vt.output_slot.connect(asf.joints["root"].pos_slot)
-        vr = ValueTable(values=vtabrot, type="mat3", modulo=total_t)
-        vr.output_slot.connect(asf.joints["root"].rot_slot)
-            
+        res = {}
+        c = motion.trackChannel(track)
+        for i in range(len(order)):
+            res[order[i]] = c+i
+        return res
 
     # valueDict
     def valueDict(self, values, order):
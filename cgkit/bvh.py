@@ -38,6 +38,11 @@
 ## Contains the BVHReader class.
 
 import string
+try:
+    import _core
+    _BVHParser = getattr(_core, "BVHParser", None)
+except ImportError:
+    _BVHParser = None
 
 # Node
 class Node:
@@ -58,6 +63,12 @@ class Node:
 # BVHReader
 class BVHReader:
     """Read BioVision Hierarchical (BVH) files.
+
+    If the native parser from the _core module is available, the file
+    is parsed in one go and the motion samples are passed to
+    onMotionData() as a MotionData object (the default implementation
+    calls onFrame() for every frame). Otherwise the file is parsed line
+    by line and onFrame() is called directly.
     """
 
     def __init__(self, filename):
@@ -84,16 +95,51 @@ class BVHReader:
     def onFrame(self, values):
         pass
 
+    def onMotionData(self, motion):
+        for i in range(motion.numFrames()):
+            self.onFrame(motion.frame(i))
+
     # read
     def read(self):
         """Read the entire file.
         """
+        if _BVHParser!=None:
+            self.readNative()
+            return
+        
         self.fhandle = file(self.filename)
 
         self.readHierarchy()
         self.onHierarchy(self._root)
         self.readMotion()
 
+    # readNative
+    def readNative(self):
+        """Read the entire file using the native parser.
+        """
+        parser = _BVHParser()
+        parser.read(self.filename)
+
+        # Create the Node hierarchy (the joints are in depth-first order)
+        nodes = []
+        for i in range(parser.numJoints()):
+            node = Node(root=(i==0))
+            node.name = parser.jointName(i)
+            node.channels = parser.jointChannels(i)
+            node.offset = tuple(parser.jointOffset(i))
+            parent = parser.jointParent(i)
+            if parent!=-1:
+                nodes[parent].children.append(node)
+            nodes.append(node)
+        self._root = nodes[0]
+        self._numchannels = parser.motion.numChannels()
+
+        self.onHierarchy(self._root)
+        if parser.hasMotion():
+            motion = parser.motion
+            self.onMotion(motion.numFrames(), motion.frametime)
+            self.onMotionData(motion)
+
     # readMotion
     def readMotion(self):
         """Read the motion samples.
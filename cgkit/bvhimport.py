@@ -36,7 +36,7 @@
 
 from cgtypes import *
 from joint import Joint
-from valuetable import ValueTable
+from animcurveset import AnimCurveSet
 import bvh
 import pluginmanager
 from sl import *
@@ -46,13 +46,18 @@ class BVHReader(bvh.BVHReader):
     """Specialized BVH reader class.
 
     This class creates a hierarchy of joints and applies the motion to it.
+    The motion is stored in an AnimCurveSet component (attribute curves)
+    whose output slots are connected to the joints. Each frame is held
+    until the next one (the Euler angles must not be interpolated as
+    they may wrap around between two frames).
     """
     
     def __init__(self, filename):
         bvh.BVHReader.__init__(self, filename)
-      
+        self.curves = None
 
     def onHierarchy(self, root):
+        self.curves = AnimCurveSet(name="BVH_Motion")
         self.createSkeleton(root)
         self.root = root
 
@@ -65,6 +70,9 @@ class BVHReader(bvh.BVHReader):
         self.applyMotion(self.root, values)
         self.currentframe += 1
 
+    def onMotionData(self, motion):
+        self.applyMotionData(self.root, motion, 0)
+
     def applyMotion(self, node, values):
         """Apply a motion sample to the skeleton.
 
@@ -76,40 +84,35 @@ class BVHReader(bvh.BVHReader):
         t = self.currentframe*self.dt
         
         nc = len(node.channels)
-        vals = values[:nc]
-        pos = vec3()
-        pos_flag = False
-        for ch,v in zip(node.channels, vals):
-            if ch=="Xrotation":
-                node.vtx.add(t, v)
-            elif ch=="Yrotation":
-                node.vty.add(t, v)
-            elif ch=="Zrotation":
-                node.vtz.add(t, v)
-            elif ch=="Xposition":
-                pos.x = v
-                pos_flag = True
-            elif ch=="Yposition":
-                pos.y = v
-                pos_flag = True
-            elif ch=="Zposition":
-                pos.z = v
-                pos_flag = True
-
-        if pos_flag:
-            node.vtpos.add(t, pos)
+        for ch,v in zip(node.channels, values[:nc]):
+            self.curves.insertKey(node.curves[ch], t, v, "step")
             
         values = values[nc:]
         for c in node.children:
             values = self.applyMotion(c, values)
         return values
 
+    def applyMotionData(self, node, motion, channel):
+        """Apply all motion samples to the skeleton.
+
+        node is the current joint, motion the MotionData object and
+        channel the index of the first channel of node.
+        The method returns the index of the next channel.
+        """
+        for ch in node.channels:
+            self.curves.setMotionKeys(node.curves[ch], motion, channel, 0.0, self.dt, interpolation="step")
+            channel += 1
+
+        for c in node.children:
+            channel = self.applyMotionData(c, motion, channel)
+        return channel
+
     # createSkeleton
     def createSkeleton(self, node, parent=None):
         """Create the skeleton hierarchy.
 
         This method creates the skeleton recursively. Each invocation
-        creates one joint.
+        creates one joint and the animation channels for the joint.
         """
         order = self.rotationOrder(node.channels)
         # Create a new Joint object
@@ -119,24 +122,39 @@ class BVHReader(bvh.BVHReader):
                   parent = parent)
         # Store the joint in the node so that later the motion can be applied
         node.joint = j
-        
-        vtx = ValueTable(type="double")
-        vty = ValueTable(type="double")
-        vtz = ValueTable(type="double")
-        vtx.output_slot.connect(j.anglex_slot)
-        vty.output_slot.connect(j.angley_slot)
-        vtz.output_slot.connect(j.anglez_slot)
-        node.vtx = vtx
-        node.vty = vty
-        node.vtz = vtz
-        if node.isRoot():
-            vtpos = ValueTable(type="vec3")
-            vtpos.output_slot.connect(j.pos_slot)
-            node.vtpos = vtpos
+
+        # Create the animation channels. node.curves maps the BVH channel
+        # names to curve indices.
+        node.curves = {}
+        for axis in "XYZ":
+            if axis+"rotation" in node.channels:
+                chname = self.channelName("%s_angle%s"%(node.name, axis.lower()))
+                idx = self.curves.addChannel(chname, "double")
+                node.curves[axis+"rotation"] = self.curves.channelCurve(idx)
+                self.curves.slot(chname).connect(getattr(j, "angle%s_slot"%axis.lower()))
+        if "Xposition" in node.channels or "Yposition" in node.channels or "Zposition" in node.channels:
+            chname = self.channelName("%s_pos"%node.name)
+            idx = self.curves.addChannel(chname, "vec3")
+            curve = self.curves.channelCurve(idx)
+            node.curves["Xposition"] = curve
+            node.curves["Yposition"] = curve+1
+            node.curves["Zposition"] = curve+2
+            self.curves.slot(chname).connect(j.pos_slot)
             
         for c in node.children:
             self.createSkeleton(c, j)
 
+    # channelName
+    def channelName(self, name):
+        """Return a unique channel name.
+        """
+        res = name
+        i = 1
+        while self.curves.findChannel(res)!=-1:
+            i += 1
+            res = "%s%d"%(name, i)
+        return res
+
     # rotationOrder
     def rotationOrder(self, channels):
         """Determine rotation order string from the channel names.
@@ -935,11 +935,15 @@ def load(filename, **options):
 
     # Import the file
     imp = objdesc.object()
+    tracename = 'load("%s")'%os.path.basename(filename)
+    _core.traceBegin("import", tracename)
     try:
         imp.importFile(os.path.basename(filename), **options)
     except:
+        _core.traceEnd("import", tracename)
         os.chdir(oldpath)
         raise
+    _core.traceEnd("import", tracename)
         
     # Change back to the previous directory
     os.chdir(oldpath)
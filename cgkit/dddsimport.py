@@ -84,10 +84,19 @@ class DDDSImporter:
     description = staticmethod(description)
 
     # importFile
-    def importFile(self, filename, flags=GEOM_INIT_ALL, parent=None):
-        """Import a 3DS file."""
+    def importFile(self, filename, flags=GEOM_INIT_ALL, parent=None, weld=False, optimize=False):
+        """Import a 3DS file.
+
+        If weld is True, the meshes are cleaned up after they were
+        created (identical vertices are merged and degenerate or duplicate
+        faces are removed, see TriMeshGeom.cleanup()). If optimize is
+        True, the faces and vertices are reordered for a better memory
+        locality (see TriMeshGeom.optimizeVertexCache()).
+        """
 
         self.filename = filename
+        self.weld = weld
+        self.optimize = optimize
         self.ddds = _core.File3ds()
         self.ddds.load(filename)
 #        f = self.ddds.current_frame
@@ -119,6 +128,10 @@ class DDDSImporter:
             mesh = self.meshes[n]
             tm = TriMeshGeom()
             mesh.initGeom(tm, flags)
+            if weld:
+                tm.cleanup()
+            if optimize:
+                tm.optimizeVertexCache()
             worldobj = TriMesh(name = mesh.name, parent=parent)
             worldobj.geom = tm
 
@@ -157,6 +170,10 @@ class DDDSImporter:
 #                print mesh.matrix
                 tm = TriMeshGeom()
                 mesh.initGeom(tm, flags)
+                if self.weld:
+                    tm.cleanup()
+                if self.optimize:
+                    tm.optimizeVertexCache()
 
                 if parent==None:
                     PT = mat4().translation(-data.pivot)
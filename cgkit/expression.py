@@ -66,6 +66,13 @@ class Expression(Component):
     possible to animate the parameters. The output value can be accessed via
     the "output" and "output_slot" attributes.
 
+    If all parameters are floats, vec3s, mat3s or mat4s the expression is
+    compiled by the native expression compiler (see _core.ExprProgram)
+    and the output slot evaluates the compiled code. Otherwise, or if the
+    expression uses a feature that is not supported by the compiler, the
+    expression is evaluated by Python. The attribute "compiled" tells
+    which of the two is used.
+
     Example:
 
     \code
@@ -101,6 +108,7 @@ class Expression(Component):
         self.exprtype = exprtype
 
         # Create a parameter slot for every extra key arg...
+        vartypes = {"t":"double"}
         for k in keyargs:
             T = type(keyargs[k])
             if T==float or T==int:
@@ -128,6 +136,7 @@ class Expression(Component):
                 typ = "py"
                 valstr = "keyargs[k]"
 #                raise ValueError, "Unsupported type: %s"%T
+            vartypes[k] = typ
             # Create slot
             exec "self.%s_slot = %sSlot(%s)"%(k, typ.capitalize(), valstr)
             exec "self.addSlot(k, self.%s_slot)"%k
@@ -143,14 +152,16 @@ class Expression(Component):
         if "t" not in self.vars:
             self.vars.append("t")
 
-        if self.exprtype==None:
-            self.exprtype = self._determineReturnType()
-
-        # Create the output slot
-        e = self.exprtype
-        if e.lower()=="float":
-            e = "double"
-        exec "self.output_slot = Procedural%sSlot(self.outProc)"%e.capitalize()
+        # Create the output slot (use the compiled expression if possible)
+        self.output_slot = self._createExpressionSlot(vartypes)
+        self.compiled = self.output_slot!=None
+        if not self.compiled:
+            if self.exprtype==None:
+                self.exprtype = self._determineReturnType()
+            e = self.exprtype
+            if e.lower()=="float":
+                e = "double"
+            exec "self.output_slot = Procedural%sSlot(self.outProc)"%e.capitalize()
         self.addSlot("output", self.output_slot)
 
         # Create dependencies
@@ -172,6 +183,49 @@ class Expression(Component):
     # "output" property...
     exec slotPropertyCode("output")
 
+    def _createExpressionSlot(self, vartypes):
+        """Create an output slot that evaluates the compiled expression.
+
+        Returns None if the expression can't be compiled (because a
+        parameter type or a feature used in the expression is not
+        supported by the expression compiler).
+        """
+        slotclasses = {"float":_core.DoubleExpressionSlot,
+                       "vec3":_core.Vec3ExpressionSlot,
+                       "mat3":_core.Mat3ExpressionSlot,
+                       "mat4":_core.Mat4ExpressionSlot}
+
+        for v in self.vars:
+            if vartypes[v] not in ["double", "vec3", "mat3", "mat4"]:
+                return None
+
+        # Determine the output type...
+        exprtype = self.exprtype
+        if exprtype==None:
+            prog = _core.ExprProgram()
+            for v in self.vars:
+                prog.addVariable(v, vartypes[v])
+            try:
+                prog.compile(self.expr)
+            except ValueError:
+                return None
+            exprtype = prog.resultType()
+        if exprtype.lower()=="double":
+            exprtype = "float"
+        if exprtype.lower() not in slotclasses:
+            return None
+
+        slot = slotclasses[exprtype.lower()]()
+        for v in self.vars:
+            slot.addVariable(v, getattr(self, "%s_slot"%v))
+        try:
+            slot.compile(self.expr)
+        except ValueError:
+            return None
+
+        self.exprtype = exprtype
+        return slot
+
     def _determineReturnType(self):
         """Try to execute the stored expression and return the output type.
         """
@@ -46,6 +46,7 @@ import sys, os, os.path
 import _Image as Image
 import glslangparams
 from slots import *
+from textureloader import getTextureLoader
 
 GLSLANG_VERTEX = _core.GLShader.ShaderType.VERTEX
 GLSLANG_FRAGMENT = _core.GLShader.ShaderType.FRAGMENT
@@ -65,8 +66,13 @@ class GLTexture(_core.GLTexture):
                  texenvcolor = vec4(1),
                  transform = mat4(1),
                  size = None,
-                 environment_map = False):
+                 environment_map = False,
+                 async_load = False):
         """Constructor.
+
+        If async_load is True, the image file is loaded by a background
+        thread (see TextureLoader) and the material is drawn without
+        texture until the image is available.
         """
         
         _core.GLTexture.__init__(self)
@@ -84,8 +90,11 @@ class GLTexture(_core.GLTexture):
         self.mipmap = mipmap
         self.internalformat = internalformat
         self.size = size
+        self.async_load = async_load
 
         self._image = image
+        # Cache key of the image that was requested last
+        self._loadkey = None
         
         # Remember the current working directory
         self._path = os.getcwd()
@@ -97,17 +106,33 @@ class GLTexture(_core.GLTexture):
         # No image data set? Then use the file name and load the image...
         if self.image==None:
             if self.imagename=="":
+                self._loadkey = None
+                self.setTexImage(None)
                 return
-            print 'Loading "%s"...'%self.imagename,
             fullname = os.path.join(self._path, self.imagename)
+            # Is the image already in the cache? (e.g. because another
+            # material uses the same file)
+            key = "%s|%s|%s|%s"%(fullname, self.size, self.mipmap, self.internalformat)
+            self._loadkey = key
+            cache = _core.TextureCache.defaultCache()
+            img = cache.lookup(key)
+            if img!=None:
+                self.setTexImage(img)
+                return
+            if self.async_load:
+                getTextureLoader().load(self, fullname, key)
+                return
+            print 'Loading "%s"...'%self.imagename,
             try:
-                img = Image.open(fullname)
-                self._passPILImage(img)
+                img = self._loadTexImage(fullname)
             except IOError, e:
                 print "failed"
                 print e
                 return
+            cache.insert(key, img)
+            self.setTexImage(img)
         else:
+            self._loadkey = None
             data = self.image
             if type(data)==str:
                 # Raw image data as string
@@ -121,6 +146,23 @@ class GLTexture(_core.GLTexture):
 
     ## protected:
 
+    def _loadTexImage(self, fullname):
+        """Load an image file and return it as TextureImage.
+
+        This method doesn't make any OpenGL calls and is also called
+        by the background threads of the TextureLoader.
+        """
+        img = self._fitPILImage(Image.open(fullname))
+        w,h = img.size
+        if img.mode=="RGB":
+            format = GL_RGB
+        elif img.mode=="RGBA":
+            format = GL_RGBA
+        else:
+            img = img.convert("RGB")
+            format = GL_RGB
+        return _core.TextureImage(w, h, format, img.tostring(), self.mipmap)
+
     def _passPILImage(self, img):
         """Pass a PIL image back to OpenGL.
 
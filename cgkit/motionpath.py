@@ -121,7 +121,14 @@ class MotionPath(Component):
     # arcLenToCurveParam
     def arcLenToCurveParam(self, s, eps=0.0001, maxiter=100):
         """Determine the native curve parameter for a given arc length.
+
+        If the curve provides an arcLenToParam() method (such as
+        BezierCurveGeom) the parameter is taken from there, otherwise
+        it is determined by Newton iterations.
         """
+        if hasattr(self.curve, "arcLenToParam"):
+            return self.curve.arcLenToParam(s)
+
         tmin, tmax = self.curve.paraminterval
         totallen = self.curve.arcLen(tmax)
         # Initial "guess"...
@@ -0,0 +1,125 @@
+# ***** BEGIN LICENSE BLOCK *****
+# Version: MPL 1.1/GPL 2.0/LGPL 2.1
+#
+# The contents of this file are subject to the Mozilla Public License Version
+# 1.1 (the "License"); you may not use this file except in compliance with
+# the License. You may obtain a copy of the License at
+# http://www.mozilla.org/MPL/
+#
+# Software distributed under the License is distributed on an "AS IS" basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Original Code is the Python Computer Graphics Kit.
+#
+# The Initial Developer of the Original Code is Matthias Baas.
+# Portions created by the Initial Developer are Copyright (C) 2004
+# the Initial Developer. All Rights Reserved.
+#
+# Contributor(s):
+#
+# Alternatively, the contents of this file may be used under the terms of
+# either the GNU General Public License Version 2 or later (the "GPL"), or
+# the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+# in which case the provisions of the GPL or the LGPL are applicable instead
+# of those above. If you wish to allow use of your version of this file only
+# under the terms of either the GPL or the LGPL, and not to allow others to
+# use your version of this file under the terms of the MPL, indicate your
+# decision by deleting the provisions above and replace them with the notice
+# and other provisions required by the GPL or the LGPL. If you do not delete
+# the provisions above, a recipient may use your version of this file under
+# the terms of any one of the MPL, the GPL or the LGPL.
+#
+# ***** END LICENSE BLOCK *****
+
+## \file offscreenrenderer.py
+## Contains the OffscreenRenderer class.
+
+from cgtypes import vec4
+from scene import getScene
+from glrenderer import GLRenderInstance
+import _core
+try:
+    import Image
+    _PIL_installed = 1
+except ImportError:
+    _PIL_installed = 0
+
+# OffscreenRenderer
+class OffscreenRenderer:
+    """Render a scene with the OpenGL renderer into an offscreen buffer.
+
+    This class combines an offscreen OpenGL context (EGL or OSMesa) with
+    a GLRenderInstance, so a scene can be rendered with OpenGL without
+    opening a window. It requires that cgkit was compiled with the
+    OFFSCREEN_GL option.
+
+    The renderer attribute is the GLRenderInstance which can be used
+    to change the render options or to read the render statistics.
+    """
+    
+    def __init__(self, width=320, height=240):
+        """Constructor.
+
+        \param width (\c int) Width of the image
+        \param height (\c int) Height of the image
+        """
+        if not hasattr(_core, "OffscreenGLContext"):
+            raise RuntimeError, "cgkit was compiled without offscreen OpenGL support (OFFSCREEN_GL option)"
+        self.context = _core.OffscreenGLContext(width, height)
+        self.renderer = GLRenderInstance()
+        self.renderer.setViewport(0, 0, width, height)
+
+    # getResolution
+    def getResolution(self):
+        """Return the image size.
+
+        \return Tuple (width, height)
+        """
+        return self.context.getResolution()
+
+    # render
+    def render(self, cam, root=None):
+        """Render the current scene as seen from the given camera.
+
+        The method returns after OpenGL has finished rendering, so it
+        can be used to measure the time per frame.
+
+        \param cam (\c Camera) Camera object
+        \param root (\c WorldObject) Only render this subtree (None=entire world).
+        """
+        scene = getScene()
+        width, height = self.context.getResolution()
+        self.context.makeCurrent()
+        r = self.renderer
+        r.left_handed = scene.handedness=='l'
+        r.clearcol = vec4(scene.getGlobal("background", vec4(0.5,0.5,0.6,0)))
+        near, far = cam.getNearFar()
+        r.setProjection(cam.projection(width, height, near, far))
+        r.setViewTransformation(cam.viewTransformation(), 0)
+        if root==None:
+            root = scene.worldRoot()
+        r.paint(root)
+        self.context.finish()
+
+    # readPixels
+    def readPixels(self):
+        """Return the image as a string of 8 bit RGBA values (top row first).
+        """
+        return self.context.readPixels()
+
+    # toImage
+    def toImage(self, mode="RGB"):
+        """Return the rendered image as PIL image.
+
+        \param mode (\c str) Image mode ("RGB" or "RGBA")
+        \return PIL image
+        """
+        if not _PIL_installed:
+            raise ImportError, "the Python Imaging Library (PIL) is not installed"
+        width, height = self.context.getResolution()
+        img = Image.fromstring("RGBA", (width, height), self.readPixels())
+        if mode!="RGBA":
+            img = img.convert(mode)
+        return img
@@ -121,8 +121,11 @@ class Scene(object):
     def clear(self):
         """Clear the entire scene."""
 
-        # Remove all children of the world root...
-        for obj in list(self._worldroot.iterChilds()):
+        # Remove all children of the world root (starting with the last
+        # one which is cheaper for the slot dependencies)...
+        childs = list(self._worldroot.iterChilds())
+        childs.reverse()
+        for obj in childs:
             self._worldroot.removeChild(obj)
             
         self.items = [self._timer, self._worldroot]
@@ -0,0 +1,83 @@
+# ***** BEGIN LICENSE BLOCK *****
+# Version: MPL 1.1/GPL 2.0/LGPL 2.1
+#
+# The contents of this file are subject to the Mozilla Public License Version
+# 1.1 (the "License"); you may not use this file except in compliance with
+# the License. You may obtain a copy of the License at
+# http://www.mozilla.org/MPL/
+#
+# Software distributed under the License is distributed on an "AS IS" basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Original Code is the Python Computer Graphics Kit.
+#
+# The Initial Developer of the Original Code is Matthias Baas.
+# Portions created by the Initial Developer are Copyright (C) 2004
+# the Initial Developer. All Rights Reserved.
+#
+# Contributor(s):
+#
+# Alternatively, the contents of this file may be used under the terms of
+# either the GNU General Public License Version 2 or later (the "GPL"), or
+# the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+# in which case the provisions of the GPL or the LGPL are applicable instead
+# of those above. If you wish to allow use of your version of this file only
+# under the terms of either the GPL or the LGPL, and not to allow others to
+# use your version of this file under the terms of the MPL, indicate your
+# decision by deleting the provisions above and replace them with the notice
+# and other provisions required by the GPL or the LGPL. If you do not delete
+# the provisions above, a recipient may use your version of this file under
+# the terms of any one of the MPL, the GPL or the LGPL.
+#
+# ***** END LICENSE BLOCK *****
+
+## \file skingeom.py
+## Contains the SkinGeom class.
+
+import _core
+from eventmanager import eventManager
+import events
+
+# SkinGeom
+class SkinGeom(_core.SkinGeom):
+    """Skinned triangle mesh.
+
+    bindmesh is a TriMeshGeom in its bind pose that has the varying
+    variables indexvar (int) and weightvar (float) which contain the
+    joint indices and weights of each vertex. joints is a sequence of
+    joints whose current world transforms deform the mesh. mode is
+    either "linear" (linear blend skinning) or "dualquat" (dual
+    quaternion skinning).
+    """
+    def __init__(self, bindmesh=None, joints=[], mode="linear",
+                 indexvar="jointindices", weightvar="jointweights"):
+        _core.SkinGeom.__init__(self)
+        self.mode = mode
+        for joint in joints:
+            self.addJoint(joint)
+        if bindmesh is not None:
+            self.setBindMesh(bindmesh, indexvar, weightvar)
+
+        eventManager().connect(events.STEP_FRAME, self)
+
+    def addJoint(self, joint, bindtransform=None):
+        """Add a joint and return its index.
+
+        joint is either a world object (whose worldtransform slot is
+        connected to the new joint slot) or a mat4 that is used as bind
+        transform. For a world object, the bind transform defaults to
+        its current world transform.
+        """
+        if isinstance(joint, _core.WorldObject):
+            if bindtransform is None:
+                bindtransform = joint.worldtransform
+            idx = _core.SkinGeom.addJoint(self, bindtransform)
+            joint.worldtransform_slot.connect(self.jointSlot(idx))
+        else:
+            idx = _core.SkinGeom.addJoint(self, joint)
+        return idx
+
+    def onStepFrame(self):
+        self.update()
@@ -0,0 +1,171 @@
+# ***** BEGIN LICENSE BLOCK *****
+# Version: MPL 1.1/GPL 2.0/LGPL 2.1
+#
+# The contents of this file are subject to the Mozilla Public License Version
+# 1.1 (the "License"); you may not use this file except in compliance with
+# the License. You may obtain a copy of the License at
+# http://www.mozilla.org/MPL/
+#
+# Software distributed under the License is distributed on an "AS IS" basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Original Code is the Python Computer Graphics Kit.
+#
+# The Initial Developer of the Original Code is Matthias Baas.
+# Portions created by the Initial Developer are Copyright (C) 2004
+# the Initial Developer. All Rights Reserved.
+#
+# Contributor(s):
+#
+# Alternatively, the contents of this file may be used under the terms of
+# either the GNU General Public License Version 2 or later (the "GPL"), or
+# the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+# in which case the provisions of the GPL or the LGPL are applicable instead
+# of those above. If you wish to allow use of your version of this file only
+# under the terms of either the GPL or the LGPL, and not to allow others to
+# use your version of this file under the terms of the MPL, indicate your
+# decision by deleting the provisions above and replace them with the notice
+# and other provisions required by the GPL or the LGPL. If you do not delete
+# the provisions above, a recipient may use your version of this file under
+# the terms of any one of the MPL, the GPL or the LGPL.
+#
+# ***** END LICENSE BLOCK *****
+
+## \file slotprofiler.py
+## Contains functions to evaluate the data of the slot profiler.
+
+import sys
+import _core
+
+# SlotProfileEntry
+class SlotProfileEntry:
+    """Profiler counters of one slot (or of an entire component).
+
+    Attributes:
+
+    - component: Component name
+    - slot: Slot name (empty for component totals)
+    - type: Type name of the slot value
+    - getvalue_calls: Number of getValue() calls
+    - cache_hits: Number of getValue() calls that were served from the cache
+    - evaluations: Number of evaluations (cache misses)
+    - setvalue_calls: Number of setValue() calls
+    - notify_calls: Number of times the dependents were notified
+    - notifications: Total number of notified dependents
+    - num_dependents: Current number of dependents (the static fan-out)
+    - total_time: Evaluation time in seconds (including nested evaluations)
+    - self_time: Evaluation time in seconds without nested evaluations
+    """
+
+    def __init__(self, data=None):
+        if data==None:
+            data = ("", "", "", 0,0,0,0,0,0,0, 0.0, 0.0)
+        (self.component, self.slot, self.type,
+         self.getvalue_calls, self.cache_hits, self.evaluations,
+         self.setvalue_calls, self.notify_calls, self.notifications,
+         self.num_dependents, self.total_time, self.self_time) = data
+
+    def __repr__(self):
+        return "<SlotProfileEntry %s.%s: %d evaluations, %1.6fs>"%(self.component, self.slot, self.evaluations, self.self_time)
+
+    # hitRatio
+    def hitRatio(self):
+        """Return the fraction of getValue() calls that hit the cache.
+        """
+        if self.getvalue_calls==0:
+            return 0.0
+        return float(self.cache_hits)/self.getvalue_calls
+
+    # fanOut
+    def fanOut(self):
+        """Return the average number of dependents notified per change.
+        """
+        if self.notify_calls==0:
+            return 0.0
+        return float(self.notifications)/self.notify_calls
+
+# isAvailable
+def isAvailable():
+    """Check if the profiler was compiled into the library.
+    """
+    return _core.slotProfilerAvailable()
+
+# enable
+def enable(flag=True):
+    """Enable or disable the slot profiler.
+    """
+    _core.setSlotProfilerEnabled(flag)
+
+# reset
+def reset():
+    """Reset all counters.
+    """
+    _core.resetSlotProfiler()
+
+# getSlotProfile
+def getSlotProfile():
+    """Return the counters of all slots that have been accessed.
+
+    \return List of SlotProfileEntry objects.
+    """
+    return map(lambda data: SlotProfileEntry(data), _core.getSlotProfile())
+
+# getHottestSlots
+def getHottestSlots(n=20, key="self_time"):
+    """Return the slots with the highest value of a counter.
+
+    \param n (\c int) Maximum number of slots to return (None = all)
+    \param key (\c str) Attribute name of SlotProfileEntry to sort by
+    \return List of SlotProfileEntry objects (the largest value comes first).
+    """
+    entries = filter(lambda e: e.getvalue_calls+e.setvalue_calls+e.notify_calls>0, getSlotProfile())
+    entries.sort(lambda a,b: cmp(getattr(b,key), getattr(a,key)))
+    if n!=None:
+        entries = entries[:n]
+    return entries
+
+# getComponentProfile
+def getComponentProfile(key="self_time"):
+    """Return the counters accumulated per component.
+
+    The slot, type and num_dependents attributes of the returned entries
+    are empty.
+
+    \param key (\c str) Attribute name of SlotProfileEntry to sort by
+    \return List of SlotProfileEntry objects.
+    """
+    comps = {}
+    for e in getSlotProfile():
+        c = comps.get(e.component)
+        if c==None:
+            c = SlotProfileEntry()
+            c.component = e.component
+            comps[e.component] = c
+        for attr in ["getvalue_calls", "cache_hits", "evaluations",
+                     "setvalue_calls", "notify_calls", "notifications",
+                     "total_time", "self_time"]:
+            setattr(c, attr, getattr(c, attr)+getattr(e, attr))
+    res = comps.values()
+    res.sort(lambda a,b: cmp(getattr(b,key), getattr(a,key)))
+    return res
+
+# printSlotProfile
+def printSlotProfile(n=20, key="self_time", out=None):
+    """Print a table with the hottest slots.
+
+    \param n (\c int) Maximum number of slots to print
+    \param key (\c str) Attribute name of SlotProfileEntry to sort by
+    \param out File object that receives the output (default: stdout)
+    """
+    if out==None:
+        out = sys.stdout
+    if not isAvailable():
+        print >>out, "The slot profiler is not available (compile with CGKIT_SLOT_PROFILING)."
+        return
+    print >>out, "%-28s %9s %6s %8s %8s %7s %6s %10s %10s"%("Slot", "getValue", "hits", "evals", "setValue", "fan-out", "deps", "total[ms]", "self[ms]")
+    print >>out, 100*"-"
+    for e in getHottestSlots(n, key):
+        name = "%s.%s"%(e.component or "?", e.slot or "?")
+        print >>out, "%-28s %9d %5.1f%% %8d %8d %7.2f %6d %10.3f %10.3f"%(name[:28], e.getvalue_calls, 100*e.hitRatio(), e.evaluations, e.setvalue_calls, e.fanOut(), e.num_dependents, 1000*e.total_time, 1000*e.self_time)
@@ -0,0 +1,102 @@
+# ***** BEGIN LICENSE BLOCK *****
+# Version: MPL 1.1/GPL 2.0/LGPL 2.1
+#
+# The contents of this file are subject to the Mozilla Public License Version
+# 1.1 (the "License"); you may not use this file except in compliance with
+# the License. You may obtain a copy of the License at
+# http://www.mozilla.org/MPL/
+#
+# Software distributed under the License is distributed on an "AS IS" basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Original Code is the Python Computer Graphics Kit.
+#
+# The Initial Developer of the Original Code is Matthias Baas.
+# Portions created by the Initial Developer are Copyright (C) 2004
+# the Initial Developer. All Rights Reserved.
+#
+# Contributor(s):
+#
+# Alternatively, the contents of this file may be used under the terms of
+# either the GNU General Public License Version 2 or later (the "GPL"), or
+# the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+# in which case the provisions of the GPL or the LGPL are applicable instead
+# of those above. If you wish to allow use of your version of this file only
+# under the terms of either the GPL or the LGPL, and not to allow others to
+# use your version of this file under the terms of the MPL, indicate your
+# decision by deleting the provisions above and replace them with the notice
+# and other provisions required by the GPL or the LGPL. If you do not delete
+# the provisions above, a recipient may use your version of this file under
+# the terms of any one of the MPL, the GPL or the LGPL.
+#
+# ***** END LICENSE BLOCK *****
+
+## \file softrenderer.py
+## Contains the SoftRenderer class.
+
+from cgtypes import vec4
+from scene import getScene
+import _core
+try:
+    import Image
+    _PIL_installed = 1
+except ImportError:
+    _PIL_installed = 0
+
+# SoftRenderer
+class SoftRenderer(_core.SoftRenderer):
+    """Software renderer for rendering a scene without an OpenGL context.
+
+    The renderer uses the same lighting model as the OpenGL viewer
+    (GLMaterial and the GL light sources), so it can be used to create
+    previews or thumbnails on machines without a display.
+    """
+    
+    def __init__(self, width=320, height=240):
+        _core.SoftRenderer.__init__(self)
+        self.setResolution(width, height)
+
+    # setCamera
+    def setCamera(self, cam):
+        """Take the view and projection matrices from a camera.
+
+        \param cam (\c Camera) Camera object
+        """
+        width, height = self.getResolution()
+        near, far = cam.getNearFar()
+        self.setProjection(cam.projection(width, height, near, far))
+        self.setViewTransformation(cam.viewTransformation())
+
+    # renderScene
+    def renderScene(self, cam, root=None):
+        """Render the current scene as seen from the given camera.
+
+        The handedness and background color are taken from the scene.
+
+        \param cam (\c Camera) Camera object
+        \param root (\c WorldObject) Only render this subtree (None=entire world).
+        """
+        scene = getScene()
+        self.left_handed = scene.handedness=='l'
+        self.clearcol = vec4(scene.getGlobal("background", vec4(0.5,0.5,0.6,0)))
+        self.setCamera(cam)
+        if root==None:
+            root = scene.worldRoot()
+        self.render(root)
+
+    # toImage
+    def toImage(self, mode="RGB"):
+        """Return the rendered image as PIL image.
+
+        \param mode (\c str) Image mode ("RGB" or "RGBA")
+        \return PIL image
+        """
+        if not _PIL_installed:
+            raise ImportError, "the Python Imaging Library (PIL) is not installed"
+        width, height = self.getResolution()
+        img = Image.fromstring("RGBA", (width, height), self.getImageData())
+        if mode!="RGBA":
+            img = img.convert(mode)
+        return img
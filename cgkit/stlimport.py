@@ -181,10 +181,12 @@ class STLReader:
 # STLImport
 class STLImport(STLReader):
     
-    def __init__(self, filename):
+    def __init__(self, filename, weld=False, optimize=False):
         STLReader.__init__(self, filename)
         self.verts = []
         self.numfaces = 0
+        self.weld = weld
+        self.optimize = optimize
 
     # begin
     def begin(self, name):
@@ -195,7 +197,13 @@ class STLImport(STLReader):
         faces = []
         for i in range(self.numfaces):
             faces.append(range(i*3, i*3+3))
-        TriMesh(name=name, verts=self.verts, faces=faces)
+        tm = TriMesh(name=name, verts=self.verts, faces=faces)
+        # STL files store each triangle separately, so merge the
+        # vertices to obtain a connected mesh
+        if self.weld:
+            tm.geom.cleanup()
+        if self.optimize:
+            tm.geom.optimizeVertexCache()
 
     # triangle
     def triangle(self, normal, verts):
@@ -225,10 +233,15 @@ class STLImporter:
     description = staticmethod(description)
 
     # importFile
-    def importFile(self, filename):
-        """Import a STL file."""
+    def importFile(self, filename, weld=False, optimize=False):
+        """Import a STL file.
+
+        If weld is True, identical vertices are merged and degenerate or
+        duplicate triangles are removed. If optimize is True, the faces
+        and vertices are reordered for a better memory locality.
+        """
 
-        reader = STLImport(filename)
+        reader = STLImport(filename, weld=weld, optimize=optimize)
         reader.read()
 
 
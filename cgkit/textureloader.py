@@ -0,0 +1,148 @@
+# ***** BEGIN LICENSE BLOCK *****
+# Version: MPL 1.1/GPL 2.0/LGPL 2.1
+#
+# The contents of this file are subject to the Mozilla Public License Version
+# 1.1 (the "License"); you may not use this file except in compliance with
+# the License. You may obtain a copy of the License at
+# http://www.mozilla.org/MPL/
+#
+# Software distributed under the License is distributed on an "AS IS" basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Original Code is the Python Computer Graphics Kit.
+#
+# The Initial Developer of the Original Code is Matthias Baas.
+# Portions created by the Initial Developer are Copyright (C) 2004
+# the Initial Developer. All Rights Reserved.
+#
+# Contributor(s):
+#
+# Alternatively, the contents of this file may be used under the terms of
+# either the GNU General Public License Version 2 or later (the "GPL"), or
+# the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+# in which case the provisions of the GPL or the LGPL are applicable instead
+# of those above. If you wish to allow use of your version of this file only
+# under the terms of either the GPL or the LGPL, and not to allow others to
+# use your version of this file under the terms of the MPL, indicate your
+# decision by deleting the provisions above and replace them with the notice
+# and other provisions required by the GPL or the LGPL. If you do not delete
+# the provisions above, a recipient may use your version of this file under
+# the terms of any one of the MPL, the GPL or the LGPL.
+#
+# ***** END LICENSE BLOCK *****
+
+## \file textureloader.py
+## Contains the TextureLoader class.
+
+import sys, threading, Queue
+import _core
+
+# TextureLoader
+class TextureLoader:
+    """Loads texture images in background threads.
+
+    The worker threads decode the images and compute the mip maps (see
+    TextureImage). The finished image is stored in the default
+    TextureCache and passed to all textures that have requested the
+    image. The image is uploaded by the texture the next time it is
+    applied, until then the texture is not ready and the material is
+    drawn without texture.
+    """
+
+    def __init__(self, numthreads=2):
+        """Constructor.
+
+        \param numthreads (\c int) Number of worker threads
+        """
+        self._queue = Queue.Queue()
+        self._lock = threading.Lock()
+        # Key: Cache key - Value: List of textures waiting for the image
+        self._pending = {}
+        self._threads = []
+        for i in range(numthreads):
+            t = threading.Thread(target=self._worker, name="TextureLoader%d"%i)
+            t.setDaemon(True)
+            t.start()
+            self._threads.append(t)
+
+    # load
+    def load(self, texture, fullname, key):
+        """Request an image for a texture.
+
+        The method returns immediately. If the same image is already
+        being loaded, the texture will receive that image.
+
+        \param texture (\c GLTexture) Texture that receives the image (via setTexImage())
+        \param fullname (\c str) Image file name
+        \param key (\c str) Cache key of the image
+        """
+        self._lock.acquire()
+        try:
+            waiting = self._pending.get(key)
+            if waiting!=None:
+                waiting.append(texture)
+                return
+            self._pending[key] = [texture]
+        finally:
+            self._lock.release()
+        self._queue.put((texture, fullname, key))
+
+    # numPending
+    def numPending(self):
+        """Return the number of images that are still being loaded.
+        """
+        self._lock.acquire()
+        try:
+            return len(self._pending)
+        finally:
+            self._lock.release()
+
+    # wait
+    def wait(self):
+        """Block until all requested images have been loaded.
+        """
+        self._queue.join()
+
+    ## protected:
+
+    def _worker(self):
+        """Thread function of the worker threads.
+        """
+        while True:
+            texture, fullname, key = self._queue.get()
+            try:
+                try:
+                    img = texture._loadTexImage(fullname)
+                except Exception, e:
+                    print >>sys.stderr, 'Loading "%s" failed: %s'%(fullname, e)
+                    img = None
+                self._lock.acquire()
+                try:
+                    textures = self._pending.pop(key, [])
+                finally:
+                    self._lock.release()
+                if img!=None:
+                    _core.TextureCache.defaultCache().insert(key, img)
+                    for tex in textures:
+                        # Only pass the image if the texture still wants it
+                        if getattr(tex, "_loadkey", None)==key:
+                            tex.setTexImage(img)
+            finally:
+                self._queue.task_done()
+
+######################################################################
+
+_loader = None
+
+# getTextureLoader
+def getTextureLoader():
+    """Return the global texture loader.
+
+    The loader is created on first use.
+    """
+    global _loader
+    if _loader==None:
+        _loader = TextureLoader()
+    return _loader
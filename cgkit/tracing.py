@@ -0,0 +1,115 @@
+# ***** BEGIN LICENSE BLOCK *****
+# Version: MPL 1.1/GPL 2.0/LGPL 2.1
+#
+# The contents of this file are subject to the Mozilla Public License Version
+# 1.1 (the "License"); you may not use this file except in compliance with
+# the License. You may obtain a copy of the License at
+# http://www.mozilla.org/MPL/
+#
+# Software distributed under the License is distributed on an "AS IS" basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Original Code is the Python Computer Graphics Kit.
+#
+# The Initial Developer of the Original Code is Matthias Baas.
+# Portions created by the Initial Developer are Copyright (C) 2004
+# the Initial Developer. All Rights Reserved.
+#
+# Contributor(s):
+#
+# Alternatively, the contents of this file may be used under the terms of
+# either the GNU General Public License Version 2 or later (the "GPL"), or
+# the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+# in which case the provisions of the GPL or the LGPL are applicable instead
+# of those above. If you wish to allow use of your version of this file only
+# under the terms of either the GPL or the LGPL, and not to allow others to
+# use your version of this file under the terms of the MPL, indicate your
+# decision by deleting the provisions above and replace them with the notice
+# and other provisions required by the GPL or the LGPL. If you do not delete
+# the provisions above, a recipient may use your version of this file under
+# the terms of any one of the MPL, the GPL or the LGPL.
+#
+# ***** END LICENSE BLOCK *****
+
+## \file tracing.py
+## Contains functions to record trace events.
+
+import _core
+
+# isAvailable
+def isAvailable():
+    """Check if the library was compiled with tracing support.
+
+    If this returns False, only the events recorded from Python are
+    available.
+    """
+    return _core.tracingAvailable()
+
+# enable
+def enable(flag=True, buffersize=None):
+    """Enable or disable the tracer.
+
+    \param flag (\c bool) True to start recording events
+    \param buffersize (\c int) Number of events stored per thread (None=keep the current size)
+    """
+    if buffersize!=None:
+        _core.setTraceBufferSize(buffersize)
+    _core.setTracingEnabled(flag)
+
+# clear
+def clear():
+    """Remove all recorded events.
+    """
+    _core.clearTrace()
+
+# begin
+def begin(name, category="python"):
+    """Record the beginning of an operation.
+
+    Every call has to be matched by a call to end() with the same
+    arguments.
+    """
+    _core.traceBegin(category, name)
+
+# end
+def end(name, category="python"):
+    """Record the end of an operation.
+    """
+    _core.traceEnd(category, name)
+
+# instant
+def instant(name, category="python", arg=0):
+    """Record an event without duration.
+    """
+    _core.traceInstant(category, name, arg)
+
+# counter
+def counter(name, value, category="python"):
+    """Record the current value of a counter.
+    """
+    _core.traceCounter(category, name, value)
+
+# traceCall
+def traceCall(name, func, *args, **keyargs):
+    """Call a function and record its execution time.
+
+    \param name (\c str) Event name
+    \param func Callable object
+    \return The return value of func
+    """
+    _core.traceBegin("python", name)
+    try:
+        return func(*args, **keyargs)
+    finally:
+        _core.traceEnd("python", name)
+
+# save
+def save(filename):
+    """Save the recorded events as Chrome trace (JSON).
+
+    The file can be loaded into the Chrome trace viewer 
+    (chrome://tracing) or into Perfetto (ui.perfetto.dev).
+    """
+    _core.saveChromeTrace(filename)
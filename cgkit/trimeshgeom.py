@@ -44,3 +44,16 @@ class TriMeshGeom(_core.TriMeshGeom):
     def __init__(self):
         _core.TriMeshGeom.__init__(self)
 
+    # lodChain
+    def lodChain(self, facecounts, maxerror=-1.0):
+        """Create simplified versions of the mesh.
+
+        facecounts is a sequence of target face counts (in descending
+        order). The return value is a list of new TriMeshGeom objects,
+        one for each face count. See decimate() for a description of
+        maxerror.
+        """
+        lods = map(lambda x: TriMeshGeom(), facecounts)
+        self.decimateLODs(lods, facecounts, maxerror)
+        return lods
+
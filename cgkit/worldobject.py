@@ -139,11 +139,13 @@ class WorldObject(_core.WorldObject):
         return [ISceneItem, ISceneItemContainer]
 
     def __getattr__(self, name):
-        if self.geom!=None and name[:2]!="__":
-            if hasattr(self.geom, name):
-                return getattr(self.geom, name)
-            elif self.geom.hasSlot(name):
-                return self.geom.slot(name).getValue()
+        geom = self.geom
+        if geom!=None and name[:2]!="__":
+            if hasattr(geom, name):
+                return getattr(geom, name)
+            slot = geom.findSlot(name)
+            if slot!=None:
+                return slot.getValue()
 #        if self.geom!=None and self.geom.hasSlot(name):
 #            exec "res=self.geom.%s"%name
 #            return res
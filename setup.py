@@ -222,6 +222,11 @@ THREEDXWARE_AVAILABLE = False
 WINTAB_AVAILABLE = False
 GLOVESDK_AVAILABLE = False
 GLOVESDK_BASE = None
+OFFSCREEN_GL = None
+SLOT_PROFILING = False
+TRACING = False
+# Apple's compiler doesn't support OpenMP
+OPENMP = (sys.platform!="darwin")
 BOOST_BASE = None
 BOOST_LIB = "boost_python"
 BOOST_DLL = "boost_python.dll"
@@ -268,6 +273,7 @@ if INSTALL_CGKIT_LIGHT:
     THREEDXWARE_AVAILABLE = False
     WINTAB_AVAILABLE = False
     GLOVESDK_AVAILABLE = False
+    OFFSCREEN_GL = None
     USING_STLPORT = False
     BOOST_BASE = None
 
@@ -333,6 +339,33 @@ if OSG_AVAILABLE:
     MACROS.append(("OSG_AVAILABLE", None))
     scripts += ["viewerOsg.py"]
 
+# Offscreen OpenGL context
+if OFFSCREEN_GL=="egl":
+    LIBS += ["EGL"]
+    MACROS.append(("OFFSCREEN_GL_AVAILABLE", None))
+elif OFFSCREEN_GL=="osmesa":
+    LIBS += ["OSMesa"]
+    MACROS += [("OFFSCREEN_GL_AVAILABLE", None), ("OFFSCREEN_OSMESA", None)]
+elif OFFSCREEN_GL!=None:
+    print ('Invalid value for OFFSCREEN_GL: "%s" (must be "egl" or "osmesa")'%OFFSCREEN_GL)
+    sys.exit(1)
+
+# Slot profiler (the support library must be compiled with the same setting)
+if SLOT_PROFILING:
+    MACROS.append(("CGKIT_SLOT_PROFILING", None))
+
+# Event tracing
+if TRACING:
+    MACROS.append(("CGKIT_TRACING", None))
+
+# OpenMP (the support library should be compiled with the same setting)
+if OPENMP:
+    if sys.platform=="win32":
+        CC_ARGS += ["/openmp"]
+    else:
+        CC_ARGS += ["-fopenmp"]
+        LINK_ARGS += ["-fopenmp"]
+
 
 ######################################################################
 # Do some checks...
@@ -485,14 +518,25 @@ core_src_files = ["wrappers/py_wrapper.cpp",
                   "wrappers/py_torusgeom.cpp",
                   "wrappers/py_boxgeom.cpp",
                   "wrappers/py_planegeom.cpp",
+                  "wrappers/py_meshtopology.cpp",
                   "wrappers/py_trimeshgeom.cpp",
                   "wrappers/py_polyhedrongeom.cpp",
+                  "wrappers/py_subdivisiongeom.cpp",
                   "wrappers/py_drawgeom.cpp",
+                  "wrappers/py_lodgeom.cpp",
                   "wrappers/py_lightsource.cpp",
                   "wrappers/py_glpointlight.cpp",
                   "wrappers/py_glspotlight.cpp",
                   "wrappers/py_gldistantlight.cpp",
                   "wrappers/py_glrenderer.cpp",
+                  "wrappers/py_softrenderer.cpp",
+                  "wrappers/py_texturecache.cpp",
+                  "wrappers/py_tracing.cpp",
+                  "wrappers/py_animcurveset.cpp",
+                  "wrappers/py_exprprogram.cpp",
+                  "wrappers/py_mocapparser.cpp",
+                  "wrappers/py_skingeom.cpp",
+                  "wrappers/py_beziercurvegeom.cpp",
                   "wrappers/py_massproperties.cpp",
                   "wrappers/rply/rply/rply.c",
                   "wrappers/rply/py_rply_read.cpp",
@@ -528,6 +572,12 @@ if OSG_AVAILABLE:
     		       "wrappers/osg/osgwrap.cpp"]		       
 
 
+# Offscreen OpenGL context?
+if OFFSCREEN_GL!=None:
+    INC_DIRS += ["wrappers/offscreen"]
+    core_src_files += ["wrappers/offscreen/offscreencontext.cpp",
+                       "wrappers/offscreen/py_offscreencontext.cpp"]
+
 # Extension modules:
 
 # Core library
@@ -596,6 +646,10 @@ print ("OGRE:              %s"%(enabledStr(OGRE_AVAILABLE)))
 print ("3DXWare:           %s"%(enabledStr(THREEDXWARE_AVAILABLE)))
 print ("Wintab:            %s"%(enabledStr(WINTAB_AVAILABLE)))
 print ("Glove module:      %s"%(enabledStr(GLOVESDK_AVAILABLE)))
+print ("Offscreen GL:      %s"%(OFFSCREEN_GL or "disabled"))
+print ("Slot profiler:     %s"%(enabledStr(SLOT_PROFILING)))
+print ("Tracing:           %s"%(enabledStr(TRACING)))
+print ("OpenMP:            %s"%(enabledStr(OPENMP)))
 print (70*"=")
 
 print ("Include paths (INC_DIRS):\n")
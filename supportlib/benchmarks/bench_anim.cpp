@@ -0,0 +1,152 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file bench_anim.cpp
+ Benchmarks for the keyframe curves.
+ */
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+#include "benchmark.h"
+#include "animcurveset.h"
+
+using namespace support3d;
+
+// Number of keys per curve
+static const int ANIM_KEYS = 1000;
+
+// Create an AnimCurveSet with n double channels (the keys are either
+// equally spaced or not)
+static void createCurves(AnimCurveSet& acs, int n, bool sampled)
+{
+  std::vector<double> times(ANIM_KEYS);
+  std::vector<double> values(ANIM_KEYS);
+  for(int i=0; i<ANIM_KEYS; i++)
+  {
+    times[i] = i/30.0 + ((i%3==1)? 0.01 : 0.0);
+    values[i] = (i*7919)%101;
+  }
+  char name[32];
+  for(int c=0; c<n; c++)
+  {
+    sprintf(name, "c%d", c);
+    int idx = acs.getChannelCurve(acs.addChannel(name, AnimCurveSet::DOUBLE_CHANNEL));
+    if (sampled)
+      acs.curve(idx).setSampledKeys(0.0, 1.0/30.0, ANIM_KEYS, &values[0]);
+    else
+      acs.curve(idx).setKeys(ANIM_KEYS, &times[0], &values[0]);
+  }
+  acs.curvesChanged();
+}
+
+// Evaluating a curve at increasing times (playback)
+static void BM_AnimCurvePlayback(benchmark::State& state)
+{
+  AnimCurveSet acs;
+  createCurves(acs, 1, false);
+  const AnimCurve& curve = acs.curve(0);
+  double t = 0.0;
+  while(state.KeepRunning())
+  {
+    benchmark::DoNotOptimize(curve.eval(t));
+    t += 1.0/24.0;
+    if (t>ANIM_KEYS/30.0)
+      t = 0.0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AnimCurvePlayback);
+
+// Evaluating a curve at random times
+static void BM_AnimCurveRandom(benchmark::State& state)
+{
+  AnimCurveSet acs;
+  createCurves(acs, 1, false);
+  const AnimCurve& curve = acs.curve(0);
+  unsigned int k = 0;
+  while(state.KeepRunning())
+  {
+    benchmark::DoNotOptimize(curve.eval((k%ANIM_KEYS)/30.0));
+    k += 7919;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AnimCurveRandom);
+
+// Changing the time and reading all output slots
+static void BM_AnimCurveSetFrame(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  AnimCurveSet acs;
+  createCurves(acs, n, state.range(1)!=0);
+  std::vector<Slot<double>*> slots;
+  for(int i=0; i<n; i++)
+    slots.push_back(dynamic_cast<Slot<double>*>(&acs.getChannelSlot(i)));
+  double t = 0.0;
+  while(state.KeepRunning())
+  {
+    acs.time.setValue(t);
+    for(int i=0; i<n; i++)
+      benchmark::DoNotOptimize(slots[i]->getValue());
+    t += 1.0/24.0;
+    if (t>ANIM_KEYS/30.0)
+      t = 0.0;
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+  state.SetLabel(state.range(1)? "sampled" : "keyed");
+}
+BENCHMARK(BM_AnimCurveSetFrame)->Args(10, 0)->Args(1000, 0)->Args(1000, 1);
+
+// Creating an AnimCurveSet with n channels (without keys) and deleting it
+static void BM_AnimCurveSetCreate(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  std::vector<std::string> names(n);
+  char name[32];
+  for(int c=0; c<n; c++)
+  {
+    sprintf(name, "c%d", c);
+    names[c] = name;
+  }
+  while(state.KeepRunning())
+  {
+    AnimCurveSet acs;
+    for(int c=0; c<n; c++)
+      acs.addChannel(names[c], AnimCurveSet::DOUBLE_CHANNEL);
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_AnimCurveSetCreate)->Arg(100)->Arg(10000)->Arg(40000);
@@ -0,0 +1,118 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file bench_curve.cpp
+ Benchmarks for the Bezier curve.
+ */
+
+#include <math.h>
+#include <vector>
+#include "benchmark.h"
+#include "beziercurvegeom.h"
+
+using namespace support3d;
+
+// Number of curve points
+static const int CURVE_POINTS = 20;
+
+// Create a closed curve that winds around a cylinder
+static void createCurve(BezierCurveGeom& crv)
+{
+  crv.pnts.resize(CURVE_POINTS);
+  for(int i=0; i<CURVE_POINTS; i++)
+  {
+    double a = 2.0*M_PI*i/CURVE_POINTS;
+    vec3d t(-sin(a), cos(a), 0.2);
+    crv.pnts.setValue(i, vec3d(3*cos(a), 3*sin(a), 0.5*sin(3*a)));
+    crv.intangents.setValue(i, -0.3*t);
+    crv.outtangents.setValue(i, 0.3*t);
+  }
+  crv.setClosed(true);
+}
+
+// Move n objects along the curve at constant speed (one frame per iteration)
+static void BM_CurveMotionPath(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  BezierCurveGeom crv;
+  createCurve(crv);
+  double len = crv.length();
+  std::vector<double> s(n);
+  std::vector<double> t(n);
+  std::vector<vec3d> p(n), dp(n), d2p(n);
+  int frame = 0;
+  while(state.KeepRunning())
+  {
+    for(int i=0; i<n; i++)
+    {
+      s[i] = fmod(0.01*frame + len*i/n, len);
+    }
+    crv.arcLenToParam(&s[0], n, &t[0]);
+    crv.evalFrame(&t[0], n, &p[0], &dp[0], &d2p[0]);
+    frame++;
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_CurveMotionPath)->Arg(1)->Arg(1000);
+
+// Rebuild the arc length table after the curve has been modified
+static void BM_CurveArcLenTable(benchmark::State& state)
+{
+  BezierCurveGeom crv;
+  createCurve(crv);
+  int frame = 0;
+  while(state.KeepRunning())
+  {
+    crv.pnts.setValue(0, vec3d(3, 0.001*(frame%100), 0));
+    benchmark::DoNotOptimize(crv.length());
+    frame++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CurveArcLenTable);
+
+// Flatten the curve
+static void BM_CurveFlatten(benchmark::State& state)
+{
+  BezierCurveGeom crv;
+  createCurve(crv);
+  std::vector<vec3d> res;
+  while(state.KeepRunning())
+  {
+    crv.flatten(0.001, res);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CurveFlatten);
@@ -0,0 +1,108 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file bench_expr.cpp
+ Benchmarks for the expression compiler and VM.
+ */
+
+#include <vector>
+#include "benchmark.h"
+#include "exprprogram.h"
+
+using namespace support3d;
+
+static const char* EXPR_SCALAR = "1.0 + amp*sin(freq*t) + 0.1*noise.noise(t, amp)";
+
+// Compiling an expression
+static void BM_ExprCompile(benchmark::State& state)
+{
+  ExprProgram prog;
+  prog.addVariable("t", ExprProgram::FLOAT);
+  prog.addVariable("amp", ExprProgram::FLOAT);
+  prog.addVariable("freq", ExprProgram::FLOAT);
+  while(state.KeepRunning())
+  {
+    prog.compile(EXPR_SCALAR);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExprCompile);
+
+// Evaluating an expression once (as done by an expression slot)
+static void BM_ExprEvaluate(benchmark::State& state)
+{
+  ExprProgram prog;
+  prog.addVariable("t", ExprProgram::FLOAT);
+  prog.addVariable("amp", ExprProgram::FLOAT);
+  prog.addVariable("freq", ExprProgram::FLOAT);
+  prog.compile(EXPR_SCALAR);
+  double t = 0.0;
+  double amp = 0.2;
+  double freq = 2.0;
+  const double* values[3] = {&t, &amp, &freq};
+  double res;
+  while(state.KeepRunning())
+  {
+    prog.evaluate(values, &res);
+    benchmark::DoNotOptimize(res);
+    t += 0.04;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExprEvaluate);
+
+// Evaluating a vector expression for many instances at once
+static void BM_ExprEvaluateMany(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  ExprProgram prog;
+  prog.addVariable("P", ExprProgram::VEC3);
+  prog.addVariable("M", ExprProgram::MAT3);
+  prog.compile("M*P + noise.vsnoise(P*4)*0.1");
+  std::vector<double> P(3*n);
+  for(int i=0; i<3*n; i++)
+    P[i] = 0.001*i;
+  double M[9] = {1,0,0, 0,2,0, 0,0,3};
+  std::vector<double> res(3*n);
+  const double* values[2] = {&P[0], M};
+  int strides[2] = {3, 0};
+  while(state.KeepRunning())
+  {
+    prog.evaluate(n, values, strides, &res[0]);
+    benchmark::DoNotOptimize(res[0]);
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_ExprEvaluateMany)->Arg(1000)->Arg(100000);
@@ -0,0 +1,144 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file bench_geoms.cpp
+ Benchmarks for the geometry classes.
+ */
+
+#include "benchmark.h"
+#include "trimeshgeom.h"
+#include "polyhedrongeom.h"
+#include "spheregeom.h"
+#include <cmath>
+#include <vector>
+
+using namespace support3d;
+
+// Create a sphere mesh with about numtris triangles
+static void createSphereMesh(TriMeshGeom& tm, int numtris)
+{
+  int segsu = int(std::sqrt(double(numtris)));
+  if (segsu<3)
+    segsu = 3;
+  int segsv = numtris/(2*segsu)+1;
+  if (segsv<2)
+    segsv = 2;
+  SphereGeom sphere(1.0, segsu, segsv);
+  sphere.convert(&tm);
+}
+
+// Bounding box of a mesh whose vertices have been modified
+static void BM_TriMeshBoundingBox(benchmark::State& state)
+{
+  TriMeshGeom tm;
+  createSphereMesh(tm, int(state.range(0)));
+  vec3d v = tm.verts.getValue(0);
+  while(state.KeepRunning())
+  {
+    // Invalidate the cached bounding box
+    tm.verts.setValue(0, v);
+    benchmark::DoNotOptimize(tm.boundingBox());
+  }
+  state.SetItemsProcessed(state.iterations()*tm.verts.size());
+  state.SetLabel("items=verts");
+}
+BENCHMARK(BM_TriMeshBoundingBox)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+// Ray intersection with a mesh
+static void BM_TriMeshIntersectRay(benchmark::State& state)
+{
+  TriMeshGeom tm;
+  createSphereMesh(tm, int(state.range(0)));
+  IntersectInfo info;
+  double x = 0.0;
+  while(state.KeepRunning())
+  {
+    tm.intersectRay(vec3d(x, 0.1, -5.0), vec3d(0, 0, 1), info);
+    benchmark::DoNotOptimize(info);
+    x = (x>0.5)? -0.5 : x+0.01;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TriMeshIntersectRay)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+// Mass properties (volume, cog, inertia tensor) of a mesh
+static void BM_TriMeshMassProperties(benchmark::State& state)
+{
+  TriMeshGeom tm;
+  createSphereMesh(tm, int(state.range(0)));
+  while(state.KeepRunning())
+  {
+    tm.calcMassProperties();
+    benchmark::DoNotOptimize(tm._inertiatensor);
+  }
+  state.SetItemsProcessed(state.iterations()*tm.faces.size());
+  state.SetLabel("items=faces");
+}
+BENCHMARK(BM_TriMeshMassProperties)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+// Triangulating a grid of quads
+static void BM_PolyhedronConvert(benchmark::State& state)
+{
+  int n = int(std::sqrt(double(state.range(0))));
+  PolyhedronGeom poly;
+  poly.verts.resize((n+1)*(n+1));
+  for(int j=0; j<=n; j++)
+  {
+    for(int i=0; i<=n; i++)
+      poly.verts.setValue(j*(n+1)+i, vec3d(i, j, 0.1*((i+j)%3)));
+  }
+  poly.setNumPolys(n*n);
+  std::vector<int> loop(4);
+  for(int j=0; j<n; j++)
+  {
+    for(int i=0; i<n; i++)
+    {
+      loop[0] = j*(n+1)+i;
+      loop[1] = loop[0]+1;
+      loop[2] = loop[1]+n+1;
+      loop[3] = loop[0]+n+1;
+      poly.setLoop(j*n+i, 0, loop);
+    }
+  }
+  while(state.KeepRunning())
+  {
+    TriMeshGeom tm;
+    poly.convert(&tm);
+    benchmark::DoNotOptimize(tm.faces.size());
+  }
+  state.SetItemsProcessed(state.iterations()*n*n);
+  state.SetLabel("items=polys");
+}
+BENCHMARK(BM_PolyhedronConvert)->Arg(100)->Arg(10000)->Arg(100000);
@@ -0,0 +1,89 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file bench_mocap.cpp
+ Benchmarks for the motion capture parsers.
+ */
+
+#include <string>
+#include <sstream>
+#include "benchmark.h"
+#include "mocapparser.h"
+
+using namespace support3d;
+
+// Number of joints in the generated BVH file
+static const int MOCAP_JOINTS = 60;
+
+// Create a BVH file with a chain of joints (3 rotation channels each)
+static std::string createBVH(int frames)
+{
+  std::ostringstream res;
+  res << "HIERARCHY\nROOT j0\n{\n  OFFSET 0 0 0\n  CHANNELS 3 Zrotation Xrotation Yrotation\n";
+  for(int j=1; j<MOCAP_JOINTS; j++)
+  {
+    res << "JOINT j" << j << "\n{\n  OFFSET 0 1 0\n  CHANNELS 3 Zrotation Xrotation Yrotation\n";
+  }
+  res << "End Site\n{\n  OFFSET 0 1 0\n}\n";
+  for(int j=0; j<MOCAP_JOINTS; j++)
+    res << "}\n";
+  res << "MOTION\nFrames: " << frames << "\nFrame Time: 0.008333\n";
+  res.setf(std::ios::fixed);
+  res.precision(6);
+  for(int f=0; f<frames; f++)
+  {
+    for(int c=0; c<3*MOCAP_JOINTS; c++)
+    {
+      res << ((f*31+c*17)%3600)*0.1-180.0 << " ";
+    }
+    res << "\n";
+  }
+  return res.str();
+}
+
+// Parsing a BVH file
+static void BM_BVHParse(benchmark::State& state)
+{
+  int frames = int(state.range(0));
+  std::string bvh = createBVH(frames);
+  BVHParser parser;
+  while(state.KeepRunning())
+  {
+    parser.parse(bvh.data(), int(bvh.size()));
+  }
+  state.SetItemsProcessed(state.iterations()*frames);
+  state.SetBytesProcessed(state.iterations()*bvh.size());
+}
+BENCHMARK(BM_BVHParse)->Arg(1000)->Arg(10000);
@@ -0,0 +1,129 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file bench_noise.cpp
+ Benchmarks for the noise functions.
+ */
+
+#include "benchmark.h"
+#include "noise.h"
+
+using namespace support3d;
+
+// Number of samples per iteration
+static const int NOISE_SAMPLES = 1000;
+
+static void BM_Noise2(benchmark::State& state)
+{
+  while(state.KeepRunning())
+  {
+    for(int i=0; i<NOISE_SAMPLES; i++)
+      benchmark::DoNotOptimize(noise(0.37*i, 0.11*i));
+  }
+  state.SetItemsProcessed(state.iterations()*NOISE_SAMPLES);
+}
+BENCHMARK(BM_Noise2);
+
+static void BM_Noise3(benchmark::State& state)
+{
+  while(state.KeepRunning())
+  {
+    for(int i=0; i<NOISE_SAMPLES; i++)
+      benchmark::DoNotOptimize(noise(0.37*i, 0.11*i, 0.23*i));
+  }
+  state.SetItemsProcessed(state.iterations()*NOISE_SAMPLES);
+}
+BENCHMARK(BM_Noise3);
+
+static void BM_Noise4(benchmark::State& state)
+{
+  while(state.KeepRunning())
+  {
+    for(int i=0; i<NOISE_SAMPLES; i++)
+      benchmark::DoNotOptimize(noise(0.37*i, 0.11*i, 0.23*i, 0.05*i));
+  }
+  state.SetItemsProcessed(state.iterations()*NOISE_SAMPLES);
+}
+BENCHMARK(BM_Noise4);
+
+static void BM_VNoise3(benchmark::State& state)
+{
+  double x, y, z;
+  while(state.KeepRunning())
+  {
+    for(int i=0; i<NOISE_SAMPLES; i++)
+    {
+      vnoise(0.37*i, 0.11*i, 0.23*i, x, y, z);
+      benchmark::DoNotOptimize(x);
+    }
+  }
+  state.SetItemsProcessed(state.iterations()*NOISE_SAMPLES);
+}
+BENCHMARK(BM_VNoise3);
+
+static void BM_CellNoise3(benchmark::State& state)
+{
+  while(state.KeepRunning())
+  {
+    for(int i=0; i<NOISE_SAMPLES; i++)
+      benchmark::DoNotOptimize(cellnoise(vec3d(0.37*i, 0.11*i, 0.23*i)));
+  }
+  state.SetItemsProcessed(state.iterations()*NOISE_SAMPLES);
+}
+BENCHMARK(BM_CellNoise3);
+
+static void BM_PNoise3(benchmark::State& state)
+{
+  while(state.KeepRunning())
+  {
+    for(int i=0; i<NOISE_SAMPLES; i++)
+      benchmark::DoNotOptimize(pnoise(0.37*i, 0.11*i, 0.23*i, 8, 8, 8));
+  }
+  state.SetItemsProcessed(state.iterations()*NOISE_SAMPLES);
+}
+BENCHMARK(BM_PNoise3);
+
+// fBm with the given number of octaves
+static void BM_FBm(benchmark::State& state)
+{
+  int octaves = int(state.range(0));
+  while(state.KeepRunning())
+  {
+    for(int i=0; i<NOISE_SAMPLES; i++)
+      benchmark::DoNotOptimize(fBm(0.37*i, 0.11*i, 0.23*i, octaves, 2.0, 0.5));
+  }
+  state.SetItemsProcessed(state.iterations()*NOISE_SAMPLES);
+}
+BENCHMARK(BM_FBm)->Arg(1)->Arg(4)->Arg(8);
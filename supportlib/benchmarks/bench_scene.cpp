@@ -0,0 +1,231 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file bench_scene.cpp
+ Benchmarks for world object hierarchies.
+ */
+
+#include "benchmark.h"
+#include "worldobject.h"
+#include "spheregeom.h"
+#include <vector>
+
+using namespace support3d;
+
+typedef boost::shared_ptr<WorldObject> WorldObjectPtr;
+
+// Create a root with n children (all children share one sphere geom)
+static WorldObjectPtr buildWideTree(int n, bool withgeom)
+{
+  WorldObjectPtr root(new WorldObject("root"));
+  boost::shared_ptr<GeomObject> geom;
+  if (withgeom)
+    geom = boost::shared_ptr<GeomObject>(new SphereGeom(0.5));
+  for(int i=0; i<n; i++)
+  {
+    WorldObjectPtr obj(new WorldObject(root->makeChildNameUnique("Box")));
+    obj->pos.setValue(vec3d(i, 0, 0));
+    if (withgeom)
+      obj->setGeom(geom);
+    root->addChild(obj);
+  }
+  return root;
+}
+
+// Create a chain of n objects and return the root and the leaf
+static WorldObjectPtr buildDeepTree(int n, bool withgeom, WorldObject*& leaf)
+{
+  WorldObjectPtr root(new WorldObject("root"));
+  boost::shared_ptr<GeomObject> geom;
+  if (withgeom)
+    geom = boost::shared_ptr<GeomObject>(new SphereGeom(0.5));
+  leaf = root.get();
+  for(int i=0; i<n; i++)
+  {
+    WorldObjectPtr obj(new WorldObject("Box"));
+    obj->pos.setValue(vec3d(1, 0, 0));
+    if (withgeom)
+      obj->setGeom(geom);
+    leaf->addChild(obj);
+    leaf = obj.get();
+  }
+  return root;
+}
+
+// Add a "dynamics" slot to all objects below obj so that they are
+// taken into account by the cog computation of their parent
+static void makeRigidBodies(WorldObject* obj)
+{
+  for(WorldObject::ChildIterator it=obj->childsBegin(); it!=obj->childsEnd(); it++)
+  {
+    std::auto_ptr<ISlot> dynamics(new Slot<bool>(true, 0));
+    it->second->addSlot("dynamics", dynamics);
+    makeRigidBodies(it->second.get());
+  }
+}
+
+// Creating and deleting a single world object
+static void BM_WorldObjectCreate(benchmark::State& state)
+{
+  while(state.KeepRunning())
+  {
+    WorldObject* obj = new WorldObject("obj");
+    delete obj;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WorldObjectCreate);
+
+// Building and deleting a flat hierarchy with unique names
+static void BM_BuildWideTree(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  while(state.KeepRunning())
+  {
+    WorldObjectPtr root = buildWideTree(n, false);
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_BuildWideTree)->Arg(10)->Arg(1000)->Arg(10000);
+
+// Building and deleting a chain of objects
+static void BM_BuildDeepTree(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  WorldObject* leaf;
+  while(state.KeepRunning())
+  {
+    WorldObjectPtr root = buildDeepTree(n, false, leaf);
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_BuildDeepTree)->Arg(10)->Arg(100)->Arg(1000);
+
+// Moving the root and reading the world transform of all children
+static void BM_WorldTransformWide(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  WorldObjectPtr root = buildWideTree(n, false);
+  double x = 0.0;
+  while(state.KeepRunning())
+  {
+    root->pos.setValue(vec3d(x, 0, 0));
+    for(WorldObject::ChildIterator it=root->childsBegin(); it!=root->childsEnd(); it++)
+      benchmark::DoNotOptimize(it->second->worldtransform.getValue());
+    x += 1.0;
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_WorldTransformWide)->Arg(10)->Arg(1000)->Arg(10000);
+
+// Moving the root and reading the world transform of the leaf
+static void BM_WorldTransformDeep(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  WorldObject* leaf;
+  WorldObjectPtr root = buildDeepTree(n, false, leaf);
+  double x = 0.0;
+  while(state.KeepRunning())
+  {
+    root->pos.setValue(vec3d(x, 0, 0));
+    benchmark::DoNotOptimize(leaf->worldtransform.getValue());
+    x += 1.0;
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_WorldTransformDeep)->Arg(10)->Arg(100)->Arg(1000);
+
+// Bounding box of a flat hierarchy
+static void BM_BoundingBoxWide(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  WorldObjectPtr root = buildWideTree(n, true);
+  while(state.KeepRunning())
+  {
+    benchmark::DoNotOptimize(root->boundingBox());
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_BoundingBoxWide)->Arg(10)->Arg(1000)->Arg(10000);
+
+// Bounding box of a chain of objects
+static void BM_BoundingBoxDeep(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  WorldObject* leaf;
+  WorldObjectPtr root = buildDeepTree(n, true, leaf);
+  while(state.KeepRunning())
+  {
+    benchmark::DoNotOptimize(root->boundingBox());
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_BoundingBoxDeep)->Arg(10)->Arg(100)->Arg(1000);
+
+// Changing the mass of one children and reading the cog of the root
+static void BM_CogWide(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  WorldObjectPtr root = buildWideTree(n, true);
+  makeRigidBodies(root.get());
+  WorldObject* child = root->childsBegin()->second.get();
+  double m = 1.0;
+  while(state.KeepRunning())
+  {
+    child->mass.setValue(m);
+    benchmark::DoNotOptimize(root->cog.getValue());
+    m = 3.0-m;
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_CogWide)->Arg(10)->Arg(1000)->Arg(10000);
+
+// Changing the mass of the leaf and reading the cog of the root
+static void BM_CogDeep(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  WorldObject* leaf;
+  WorldObjectPtr root = buildDeepTree(n, true, leaf);
+  makeRigidBodies(root.get());
+  double m = 1.0;
+  while(state.KeepRunning())
+  {
+    leaf->mass.setValue(m);
+    benchmark::DoNotOptimize(root->cog.getValue());
+    m = 3.0-m;
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_CogDeep)->Arg(10)->Arg(100)->Arg(1000);
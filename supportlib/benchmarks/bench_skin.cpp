@@ -0,0 +1,126 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+
+/** \file bench_skin.cpp
+ Benchmarks for the SkinGeom.
+ */
+
+#include <math.h>
+#include "benchmark.h"
+#include "skingeom.h"
+
+using namespace support3d;
+
+// Number of joints in the chain
+static const int SKIN_JOINTS = 20;
+// Number of influences per vertex
+static const int SKIN_INFLUENCES = 4;
+
+// Create a skinned grid (verts x verts vertices) along a joint chain
+static void createSkin(SkinGeom& geom, int verts)
+{
+  boost::shared_ptr<TriMeshGeom> bind(new TriMeshGeom());
+  bind->verts.resize(verts*verts);
+  bind->faces.resize(2*(verts-1)*(verts-1));
+  bind->newVariable("jointindices", VARYING, INT, SKIN_INFLUENCES);
+  bind->newVariable("jointweights", VARYING, FLOAT, SKIN_INFLUENCES);
+  ArraySlot<int>* ji = dynamic_cast<ArraySlot<int>*>(bind->findVariable("jointindices")->slot);
+  ArraySlot<double>* jw = dynamic_cast<ArraySlot<double>*>(bind->findVariable("jointweights")->slot);
+  int* J = ji->dataPtr();
+  double* W = jw->dataPtr();
+  for(int i=0; i<verts*verts; i++)
+  {
+    double x = double(i%verts)/(verts-1);
+    bind->verts.setValue(i, vec3d(x*SKIN_JOINTS, double(i/verts)/(verts-1), 0));
+    int j0 = int(x*(SKIN_JOINTS-1));
+    for(int k=0; k<SKIN_INFLUENCES; k++)
+    {
+      J[SKIN_INFLUENCES*i+k] = (j0+k)%SKIN_JOINTS;
+      W[SKIN_INFLUENCES*i+k] = 1.0/(k+1);
+    }
+  }
+  for(int y=0; y<verts-1; y++)
+  {
+    for(int x=0; x<verts-1; x++)
+    {
+      int v = y*verts+x;
+      int f1[3] = {v, v+1, v+verts};
+      int f2[3] = {v+1, v+verts+1, v+verts};
+      bind->faces.setValues(2*(y*(verts-1)+x), f1);
+      bind->faces.setValues(2*(y*(verts-1)+x)+1, f2);
+    }
+  }
+  geom.setBindMesh(bind);
+  for(int j=0; j<SKIN_JOINTS; j++)
+  {
+    mat4d B;
+    geom.addJoint(B.setTranslation(vec3d(j, 0, 0)));
+  }
+}
+
+// Deform the mesh after every joint has been moved
+static void skinBenchmark(benchmark::State& state, SkinGeom::Mode mode)
+{
+  int verts = int(state.range(0));
+  SkinGeom geom;
+  createSkin(geom, verts);
+  geom.setMode(mode);
+  mat4d M, R;
+  int frame = 0;
+  while(state.KeepRunning())
+  {
+    for(int j=0; j<SKIN_JOINTS; j++)
+    {
+      R.setRotation(0.01*((frame+j)%100), vec3d(1,0,0));
+      geom.jointSlot(j).setValue(M.setTranslation(vec3d(j, 0, 0))*R);
+    }
+    geom.update();
+    frame++;
+  }
+  state.SetItemsProcessed(state.iterations()*verts*verts);
+}
+
+static void BM_SkinLinear(benchmark::State& state)
+{
+  skinBenchmark(state, SkinGeom::LINEAR_BLEND);
+}
+BENCHMARK(BM_SkinLinear)->Arg(100)->Arg(300);
+
+static void BM_SkinDualQuat(benchmark::State& state)
+{
+  skinBenchmark(state, SkinGeom::DUAL_QUATERNION);
+}
+BENCHMARK(BM_SkinDualQuat)->Arg(100)->Arg(300);
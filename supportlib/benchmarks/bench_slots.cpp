@@ -0,0 +1,273 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file bench_slots.cpp
+ Benchmarks for the slot system.
+ */
+
+#include "benchmark.h"
+#include "slot.h"
+#include "arrayslot.h"
+#include "worldobject.h"
+#include <vector>
+#include <string>
+#include <sstream>
+
+using namespace support3d;
+
+// Reading a slot with a valid value
+static void BM_SlotGetValue(benchmark::State& state)
+{
+  Slot<double> s(1.0, 0);
+  while(state.KeepRunning())
+  {
+    benchmark::DoNotOptimize(s.getValue());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SlotGetValue);
+
+// Setting a slot that has one dependent
+static void BM_SlotSetValue(benchmark::State& state)
+{
+  Slot<double> s(0.0, 0);
+  Slot<double> dep(0.0, 0);
+  dep.setController(&s);
+  double x = 0.0;
+  while(state.KeepRunning())
+  {
+    s.setValue(x);
+    x += 1.0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SlotSetValue);
+
+// Setting the first slot of a chain and reading the last one
+static void BM_SlotChain(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  std::vector<Slot<double>*> chain;
+  chain.push_back(new Slot<double>(0.0, 0));
+  for(int i=1; i<n; i++)
+  {
+    chain.push_back(new Slot<double>(0.0, 0));
+    chain[i]->setController(chain[i-1]);
+  }
+  double x = 0.0;
+  while(state.KeepRunning())
+  {
+    chain[0]->setValue(x);
+    benchmark::DoNotOptimize(chain[n-1]->getValue());
+    x += 1.0;
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+  for(int i=n-1; i>=0; i--)
+    delete chain[i];
+}
+BENCHMARK(BM_SlotChain)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// Setting a slot with many dependents and reading all of them
+static void BM_SlotFanOut(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  Slot<double> s(0.0, 0);
+  std::vector<Slot<double>*> deps;
+  for(int i=0; i<n; i++)
+  {
+    deps.push_back(new Slot<double>(0.0, 0));
+    deps[i]->setController(&s);
+  }
+  double x = 0.0;
+  while(state.KeepRunning())
+  {
+    s.setValue(x);
+    for(int i=0; i<n; i++)
+      benchmark::DoNotOptimize(deps[i]->getValue());
+    x += 1.0;
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+  for(int i=0; i<n; i++)
+    delete deps[i];
+}
+BENCHMARK(BM_SlotFanOut)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+// Growing an array slot from 0 to n elements and back
+static void BM_ArraySlotResize(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  ArraySlot<vec3d> s;
+  while(state.KeepRunning())
+  {
+    s.resize(n);
+    s.resize(0);
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_ArraySlotResize)->Arg(10)->Arg(1000)->Arg(100000);
+
+// Copying values between two array slots
+static void BM_ArraySlotCopyValues(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  ArraySlot<vec3d> src;
+  ArraySlot<vec3d> dst;
+  src.resize(n);
+  dst.resize(n);
+  for(int i=0; i<n; i++)
+    src.setValue(i, vec3d(i, 2*i, 3*i));
+  while(state.KeepRunning())
+  {
+    src.copyValues(0, n, dst, 0);
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+  state.SetBytesProcessed(state.iterations()*n*sizeof(vec3d));
+}
+BENCHMARK(BM_ArraySlotCopyValues)->Arg(10)->Arg(1000)->Arg(100000);
+
+// Create the slot names "slot0", "slot1", ...
+static std::vector<std::string> slotNames(int n)
+{
+  std::vector<std::string> names(n);
+  for(int i=0; i<n; i++)
+  {
+    std::ostringstream s;
+    s<<"slot"<<i;
+    names[i] = s.str();
+  }
+  return names;
+}
+
+// Adding n dynamic slots to a component (and deleting the component)
+static void BM_ComponentAddSlots(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  std::vector<std::string> names = slotNames(n);
+  while(state.KeepRunning())
+  {
+    Component comp("comp");
+    for(int i=0; i<n; i++)
+    {
+      std::auto_ptr<ISlot> s(new Slot<double>());
+      comp.addSlot(names[i], s);
+    }
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+}
+BENCHMARK(BM_ComponentAddSlots)->Arg(100)->Arg(10000)->Arg(40000);
+
+// Removing n slots from a component in the order they were added
+static void BM_ComponentRemoveSlots(benchmark::State& state)
+{
+  int n = int(state.range(0));
+  std::vector<std::string> names = slotNames(n);
+  std::vector<Slot<double>*> slots;
+  for(int i=0; i<n; i++)
+    slots.push_back(new Slot<double>(0.0, 0));
+  Component comp("comp");
+  while(state.KeepRunning())
+  {
+    state.PauseTiming();
+    for(int i=0; i<n; i++)
+      comp.addSlot(names[i], *slots[i]);
+    state.ResumeTiming();
+    for(int i=0; i<n; i++)
+      comp.removeSlot(names[i]);
+  }
+  state.SetItemsProcessed(state.iterations()*n);
+  for(int i=0; i<n; i++)
+    delete slots[i];
+}
+BENCHMARK(BM_ComponentRemoveSlots)->Arg(100)->Arg(10000)->Arg(40000);
+
+// Setting pos/rot/scale and reading the composed transform
+static void BM_TransformCompose(benchmark::State& state)
+{
+  WorldObject obj("obj");
+  mat3d rot;
+  rot.setRotation(0.5, vec3d(1,1,0));
+  obj.rot.setValue(rot);
+  obj.scale.setValue(vec3d(1,2,3));
+  double x = 0.0;
+  while(state.KeepRunning())
+  {
+    obj.pos.setValue(vec3d(x, 1, 2));
+    benchmark::DoNotOptimize(obj.transform.getValue());
+    x += 1.0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TransformCompose);
+
+// Setting the transform and reading the decomposed pos/rot/scale
+static void BM_TransformDecompose(benchmark::State& state)
+{
+  WorldObject obj("obj");
+  mat4d M;
+  M.setRotation(0.5, vec3d(1,1,0));
+  M.scale(vec3d(1,2,3));
+  double x = 0.0;
+  while(state.KeepRunning())
+  {
+    M.setColumn(3, vec4d(x, 1, 2, 1));
+    obj.transform.setValue(M);
+    benchmark::DoNotOptimize(obj.pos.getValue());
+    benchmark::DoNotOptimize(obj.rot.getValue());
+    benchmark::DoNotOptimize(obj.scale.getValue());
+    x += 1.0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TransformDecompose);
+
+// Animating the rotation only (the scale is taken from the transform)
+static void BM_TransformAnimateRot(benchmark::State& state)
+{
+  WorldObject obj("obj");
+  mat4d M;
+  M.setScaling(vec3d(1,2,3));
+  obj.transform.setValue(M);
+  mat3d rot;
+  double x = 0.0;
+  while(state.KeepRunning())
+  {
+    rot.setRotation(x, vec3d(1,1,0));
+    obj.rot.setValue(rot);
+    benchmark::DoNotOptimize(obj.transform.getValue());
+    x += 0.01;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TransformAnimateRot);
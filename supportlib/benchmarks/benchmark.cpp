@@ -0,0 +1,554 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file benchmark.cpp
+ Benchmark runner and main program.
+ */
+
+#include "benchmark.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#ifdef WIN32
+  #include <windows.h>
+#else
+  #include <unistd.h>
+  #include <sys/time.h>
+  #include <sys/resource.h>
+#endif
+
+namespace benchmark {
+
+// Return the wall clock time in seconds
+static double getWallTime()
+{
+#ifdef WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return double(count.QuadPart)/double(freq.QuadPart);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec+1E-6*tv.tv_usec;
+#endif
+}
+
+// Return the CPU time of the process in seconds
+static double getCPUTime()
+{
+#ifdef WIN32
+  FILETIME creation, exit, kernel, user;
+  GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+  return 1E-7*double(k.QuadPart+u.QuadPart);
+#else
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_utime.tv_sec+ru.ru_stime.tv_sec+1E-6*(ru.ru_utime.tv_usec+ru.ru_stime.tv_usec);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// State
+//////////////////////////////////////////////////////////////////////
+
+State::State(long aiterations, const std::vector<long>& aargs)
+  : maxiterations(aiterations), remaining(aiterations), args(aargs),
+    running(false), realstart(0), cpustart(0), realtime(0), cputime(0),
+    items(0), bytes(0), label()
+{
+}
+
+void State::StartTimer()
+{
+  if (running)
+    return;
+  running = true;
+  realstart = getWallTime();
+  cpustart = getCPUTime();
+}
+
+void State::StopTimer()
+{
+  if (!running)
+    return;
+  running = false;
+  realtime += getWallTime()-realstart;
+  cputime += getCPUTime()-cpustart;
+}
+
+/**
+  Stop the timer (for setup code inside the benchmark loop).
+ */
+void State::PauseTiming()
+{
+  StopTimer();
+}
+
+/**
+  Restart the timer after PauseTiming().
+ */
+void State::ResumeTiming()
+{
+  StartTimer();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Benchmark
+//////////////////////////////////////////////////////////////////////
+
+Benchmark::Benchmark(const char* aname, Function afunc)
+  : name(aname), func(afunc), argslist(), rangemultiplier(8)
+{
+}
+
+/**
+  Add a run with one argument.
+ */
+Benchmark* Benchmark::Arg(long x)
+{
+  std::vector<long> args;
+  args.push_back(x);
+  argslist.push_back(args);
+  return this;
+}
+
+/**
+  Add a run with two arguments.
+ */
+Benchmark* Benchmark::Args(long x, long y)
+{
+  std::vector<long> args;
+  args.push_back(x);
+  args.push_back(y);
+  argslist.push_back(args);
+  return this;
+}
+
+/**
+  Add runs for start, the powers of the range multiplier between start
+  and limit, and limit.
+ */
+Benchmark* Benchmark::Range(long start, long limit)
+{
+  Arg(start);
+  long x = 1;
+  while(x<=start)
+    x *= rangemultiplier;
+  for(; x<limit; x*=rangemultiplier)
+    Arg(x);
+  if (limit>start)
+    Arg(limit);
+  return this;
+}
+
+/**
+  Set the multiplier for subsequent Range() calls (default: 8).
+ */
+Benchmark* Benchmark::RangeMultiplier(int multiplier)
+{
+  rangemultiplier = (multiplier<2)? 2 : multiplier;
+  return this;
+}
+
+// Return the list of registered benchmarks
+static std::vector<Benchmark*>& benchmarks()
+{
+  static std::vector<Benchmark*> res;
+  return res;
+}
+
+/**
+  Register a benchmark function.
+
+  This is called by the BENCHMARK() macro.
+ */
+Benchmark* RegisterBenchmark(const char* name, Function func)
+{
+  Benchmark* bm = new Benchmark(name, func);
+  benchmarks().push_back(bm);
+  return bm;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Running and reporting
+//////////////////////////////////////////////////////////////////////
+
+/// The result of one benchmark run.
+struct Result
+{
+  std::string name;
+  long iterations;
+  /// Real time per iteration in ns
+  double realtime;
+  /// CPU time per iteration in ns
+  double cputime;
+  double itemsPerSecond;
+  double bytesPerSecond;
+  std::string label;
+};
+
+// Run one benchmark with one set of arguments
+static Result runBenchmark(const Benchmark& bm, const std::vector<long>& args, double mintime)
+{
+  Result res;
+  std::ostringstream name;
+  name<<bm.name;
+  for(unsigned int i=0; i<args.size(); i++)
+    name<<"/"<<args[i];
+  res.name = name.str();
+
+  // Increase the number of iterations until the minimum time is reached
+  long iterations = 1;
+  while(1)
+  {
+    State state(iterations, args);
+    bm.func(state);
+    double t = state.realTime();
+    if (t>=mintime || iterations>=1000000000L)
+    {
+      res.iterations = iterations;
+      res.realtime = 1E9*t/iterations;
+      res.cputime = 1E9*state.cpuTime()/iterations;
+      res.itemsPerSecond = (state.itemsProcessed()>0 && t>0)? state.itemsProcessed()/t : 0.0;
+      res.bytesPerSecond = (state.bytesProcessed()>0 && t>0)? state.bytesProcessed()/t : 0.0;
+      res.label = state.getLabel();
+      break;
+    }
+    double mult = 1.4*mintime/((t>1E-9)? t : 1E-9);
+    if (mult>10.0)
+      mult = 10.0;
+    if (mult<2.0)
+      mult = 2.0;
+    iterations = long(iterations*mult);
+  }
+  return res;
+}
+
+// Escape a string for JSON output
+static std::string jsonString(const std::string& s)
+{
+  std::string res = "\"";
+  for(unsigned int i=0; i<s.size(); i++)
+  {
+    char c = s[i];
+    if (c=='"' || c=='\\')
+    {
+      res += '\\';
+      res += c;
+    }
+    else if ((unsigned char)c<0x20)
+    {
+      char buf[8];
+      sprintf(buf, "\\u%04x", (unsigned char)c);
+      res += buf;
+    }
+    else
+      res += c;
+  }
+  return res+"\"";
+}
+
+// Return the host name
+static std::string hostName()
+{
+#ifdef WIN32
+  char buf[256];
+  DWORD size = sizeof(buf);
+  if (GetComputerNameA(buf, &size))
+    return std::string(buf, size);
+  return "";
+#else
+  char buf[256];
+  if (gethostname(buf, sizeof(buf))!=0)
+    return "";
+  buf[sizeof(buf)-1] = 0;
+  return buf;
+#endif
+}
+
+// Return the number of CPUs
+static int numCPUs()
+{
+#ifdef WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return int(info.dwNumberOfProcessors);
+#else
+  return int(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+}
+
+// Write the results as a table
+static void writeConsole(std::ostream& out, const std::vector<Result>& results, bool header)
+{
+  if (header)
+  {
+    out<<std::left<<std::setw(40)<<"Benchmark"<<std::right
+       <<std::setw(17)<<"Time"<<std::setw(17)<<"CPU"<<std::setw(12)<<"Iterations"<<std::endl;
+    out<<std::string(86, '-')<<std::endl;
+  }
+  for(unsigned int i=0; i<results.size(); i++)
+  {
+    const Result& r = results[i];
+    out<<std::left<<std::setw(40)<<r.name<<std::right<<std::fixed<<std::setprecision(1)
+       <<std::setw(14)<<r.realtime<<" ns"<<std::setw(14)<<r.cputime<<" ns"
+       <<std::setw(12)<<r.iterations;
+    if (r.itemsPerSecond>=1E6)
+      out<<"  "<<std::setprecision(3)<<r.itemsPerSecond*1E-6<<"M items/s";
+    else if (r.itemsPerSecond>0)
+      out<<"  "<<std::setprecision(3)<<r.itemsPerSecond*1E-3<<"k items/s";
+    if (r.bytesPerSecond>0)
+      out<<"  "<<std::setprecision(3)<<r.bytesPerSecond/(1024.0*1024.0)<<"MB/s";
+    if (r.label!="")
+      out<<"  "<<r.label;
+    out<<std::endl;
+  }
+}
+
+// Write the results in the JSON format of Google Benchmark
+static void writeJSON(std::ostream& out, const std::vector<Result>& results, const char* executable)
+{
+  char date[64];
+  time_t now = time(0);
+  strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+  out<<"{"<<std::endl;
+  out<<"  \"context\": {"<<std::endl;
+  out<<"    \"date\": "<<jsonString(date)<<","<<std::endl;
+  out<<"    \"host_name\": "<<jsonString(hostName())<<","<<std::endl;
+  out<<"    \"executable\": "<<jsonString(executable)<<","<<std::endl;
+  out<<"    \"num_cpus\": "<<numCPUs()<<","<<std::endl;
+#ifdef NDEBUG
+  out<<"    \"library_build_type\": \"release\","<<std::endl;
+#else
+  out<<"    \"library_build_type\": \"debug\","<<std::endl;
+#endif
+#ifdef _OPENMP
+  out<<"    \"openmp\": true"<<std::endl;
+#else
+  out<<"    \"openmp\": false"<<std::endl;
+#endif
+  out<<"  },"<<std::endl;
+  out<<"  \"benchmarks\": ["<<std::endl;
+  for(unsigned int i=0; i<results.size(); i++)
+  {
+    const Result& r = results[i];
+    out<<"    {"<<std::endl;
+    out<<"      \"name\": "<<jsonString(r.name)<<","<<std::endl;
+    out<<"      \"run_name\": "<<jsonString(r.name)<<","<<std::endl;
+    out<<"      \"run_type\": \"iteration\","<<std::endl;
+    out<<"      \"iterations\": "<<r.iterations<<","<<std::endl;
+    out<<std::setprecision(10);
+    out<<"      \"real_time\": "<<r.realtime<<","<<std::endl;
+    out<<"      \"cpu_time\": "<<r.cputime<<","<<std::endl;
+    if (r.itemsPerSecond>0)
+      out<<"      \"items_per_second\": "<<r.itemsPerSecond<<","<<std::endl;
+    if (r.bytesPerSecond>0)
+      out<<"      \"bytes_per_second\": "<<r.bytesPerSecond<<","<<std::endl;
+    if (r.label!="")
+      out<<"      \"label\": "<<jsonString(r.label)<<","<<std::endl;
+    out<<"      \"time_unit\": \"ns\""<<std::endl;
+    out<<"    }"<<((i+1<results.size())? "," : "")<<std::endl;
+  }
+  out<<"  ]"<<std::endl;
+  out<<"}"<<std::endl;
+}
+
+// Write the results in the CSV format of Google Benchmark
+static void writeCSV(std::ostream& out, const std::vector<Result>& results)
+{
+  out<<"name,iterations,real_time,cpu_time,time_unit,bytes_per_second,items_per_second,label,error_occurred,error_message"<<std::endl;
+  for(unsigned int i=0; i<results.size(); i++)
+  {
+    const Result& r = results[i];
+    out<<"\""<<r.name<<"\","<<r.iterations<<","<<std::setprecision(10)
+       <<r.realtime<<","<<r.cputime<<",ns,";
+    if (r.bytesPerSecond>0)
+      out<<r.bytesPerSecond;
+    out<<",";
+    if (r.itemsPerSecond>0)
+      out<<r.itemsPerSecond;
+    out<<",\""<<r.label<<"\",,"<<std::endl;
+  }
+}
+
+// Write the results in the given format ("console", "json" or "csv")
+static void writeResults(std::ostream& out, const std::string& format, const std::vector<Result>& results, const char* executable)
+{
+  if (format=="json")
+    writeJSON(out, results, executable);
+  else if (format=="csv")
+    writeCSV(out, results);
+  else
+    writeConsole(out, results, true);
+}
+
+// Check if an option has the form --name=value and return the value
+static bool getOption(const char* arg, const char* name, std::string& value)
+{
+  size_t len = strlen(name);
+  if (strncmp(arg, name, len)!=0 || arg[len]!='=')
+    return false;
+  value = arg+len+1;
+  return true;
+}
+
+static void usage(const char* prog)
+{
+  std::cout<<"Usage: "<<prog<<" [options]"<<std::endl<<std::endl;
+  std::cout<<"  --benchmark_list_tests            List the benchmarks and exit"<<std::endl;
+  std::cout<<"  --benchmark_filter=<text>         Only run benchmarks whose name contains <text>"<<std::endl;
+  std::cout<<"  --benchmark_min_time=<seconds>    Minimum time per benchmark (default: 0.5)"<<std::endl;
+  std::cout<<"  --benchmark_format=<format>       Output format: console, json or csv"<<std::endl;
+  std::cout<<"  --benchmark_out=<file>            Write the results into a file as well"<<std::endl;
+  std::cout<<"  --benchmark_out_format=<format>   Format of the output file (default: json)"<<std::endl;
+}
+
+/**
+  Parse the command line options and run the benchmarks.
+
+  \return Exit code for main()
+ */
+int RunSpecifiedBenchmarks(int argc, char** argv)
+{
+  std::string filter = "";
+  std::string format = "console";
+  std::string outfile = "";
+  std::string outformat = "json";
+  std::string value;
+  double mintime = 0.5;
+  bool listonly = false;
+
+  for(int i=1; i<argc; i++)
+  {
+    if (getOption(argv[i], "--benchmark_filter", value))
+      filter = value;
+    else if (getOption(argv[i], "--benchmark_min_time", value))
+      mintime = atof(value.c_str());
+    else if (getOption(argv[i], "--benchmark_format", value))
+      format = value;
+    else if (getOption(argv[i], "--benchmark_out", value))
+      outfile = value;
+    else if (getOption(argv[i], "--benchmark_out_format", value))
+      outformat = value;
+    else if (strcmp(argv[i], "--benchmark_list_tests")==0)
+      listonly = true;
+    else
+    {
+      usage(argv[0]);
+      return (strcmp(argv[i], "--help")==0 || strcmp(argv[i], "-h")==0)? 0 : 1;
+    }
+  }
+  if ((format!="console" && format!="json" && format!="csv") ||
+      (outformat!="console" && outformat!="json" && outformat!="csv"))
+  {
+    std::cerr<<"Unknown output format"<<std::endl;
+    return 1;
+  }
+
+  // Collect the runs
+  std::vector<const Benchmark*> runbm;
+  std::vector<std::vector<long> > runargs;
+  std::vector<Benchmark*>& bms = benchmarks();
+  for(unsigned int i=0; i<bms.size(); i++)
+  {
+    std::vector<std::vector<long> > argslist = bms[i]->argslist;
+    if (argslist.empty())
+      argslist.push_back(std::vector<long>());
+    for(unsigned int j=0; j<argslist.size(); j++)
+    {
+      std::ostringstream name;
+      name<<bms[i]->name;
+      for(unsigned int k=0; k<argslist[j].size(); k++)
+        name<<"/"<<argslist[j][k];
+      if (name.str().find(filter)==std::string::npos)
+        continue;
+      if (listonly)
+      {
+        std::cout<<name.str()<<std::endl;
+        continue;
+      }
+      runbm.push_back(bms[i]);
+      runargs.push_back(argslist[j]);
+    }
+  }
+  if (listonly)
+    return 0;
+
+  // Run the benchmarks (the table is written while the benchmarks are running)
+  std::vector<Result> results;
+  for(unsigned int i=0; i<runbm.size(); i++)
+  {
+    std::vector<Result> res(1, runBenchmark(*runbm[i], runargs[i], mintime));
+    if (format=="console")
+    {
+      writeConsole(std::cout, res, i==0);
+      std::cout.flush();
+    }
+    results.push_back(res[0]);
+  }
+  if (format!="console")
+    writeResults(std::cout, format, results, argv[0]);
+
+  if (outfile!="")
+  {
+    std::ofstream out(outfile.c_str());
+    if (!out)
+    {
+      std::cerr<<"Cannot write \""<<outfile<<"\""<<std::endl;
+      return 1;
+    }
+    writeResults(out, outformat, results, argv[0]);
+  }
+  return 0;
+}
+
+}  // end of namespace
+
+int main(int argc, char** argv)
+{
+  return benchmark::RunSpecifiedBenchmarks(argc, argv);
+}
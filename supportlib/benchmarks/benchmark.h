@@ -0,0 +1,206 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/** \file benchmark.h
+ A minimal benchmark framework for the support library.
+
+ The interface follows Google Benchmark, so the benchmarks could also be
+ compiled against that library. A benchmark is a function that receives
+ a State object and runs the code to measure in a
+ <tt>while(state.KeepRunning())</tt> loop:
+
+ \code
+ static void BM_SlotGetValue(benchmark::State& state)
+ {
+   Slot<double> s;
+   while(state.KeepRunning())
+   {
+     benchmark::DoNotOptimize(s.getValue());
+   }
+ }
+ BENCHMARK(BM_SlotGetValue);
+ BENCHMARK(BM_Chain)->Arg(10)->Arg(100);
+ \endcode
+
+ The number of iterations is increased until a run takes at least
+ the minimum time. The results can be written as a table, as JSON (in
+ the format used by Google Benchmark so that its comparison tools can
+ be used) or as CSV.
+ */
+
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+/**
+  The state of a running benchmark.
+ */
+class State
+{
+  public:
+  State(long aiterations, const std::vector<long>& aargs);
+
+  /**
+    Return true as long as the benchmark loop should continue.
+
+    The timer is started with the first call and stopped with the last one.
+   */
+  bool KeepRunning()
+  {
+    if (remaining>0)
+    {
+      if (remaining==maxiterations)
+        StartTimer();
+      remaining--;
+      return true;
+    }
+    StopTimer();
+    return false;
+  }
+
+  /// Return the argument with the given index.
+  long range(int idx=0) const { return args.at(idx); }
+  /// Return the number of iterations of this run.
+  long iterations() const { return maxiterations; }
+
+  void PauseTiming();
+  void ResumeTiming();
+
+  /// Set the number of processed items (used to report items per second).
+  void SetItemsProcessed(long long n) { items = n; }
+  /// Set the number of processed bytes (used to report bytes per second).
+  void SetBytesProcessed(long long n) { bytes = n; }
+  /// Set an additional label that is written with the result.
+  void SetLabel(const std::string& alabel) { label = alabel; }
+
+  // Results
+  double realTime() const { return realtime; }
+  double cpuTime() const { return cputime; }
+  long long itemsProcessed() const { return items; }
+  long long bytesProcessed() const { return bytes; }
+  const std::string& getLabel() const { return label; }
+
+  protected:
+  void StartTimer();
+  void StopTimer();
+
+  long maxiterations;
+  long remaining;
+  std::vector<long> args;
+  bool running;
+  double realstart;
+  double cpustart;
+  double realtime;
+  double cputime;
+  long long items;
+  long long bytes;
+  std::string label;
+};
+
+typedef void (*Function)(State&);
+
+/**
+  A registered benchmark.
+
+  The methods return the benchmark itself, so they can be chained.
+ */
+class Benchmark
+{
+  public:
+  Benchmark(const char* aname, Function afunc);
+
+  Benchmark* Arg(long x);
+  Benchmark* Args(long x, long y);
+  Benchmark* Range(long start, long limit);
+  Benchmark* RangeMultiplier(int multiplier);
+
+  std::string name;
+  Function func;
+  /// Argument lists (one run per list, no run if empty)
+  std::vector<std::vector<long> > argslist;
+  int rangemultiplier;
+};
+
+Benchmark* RegisterBenchmark(const char* name, Function func);
+int RunSpecifiedBenchmarks(int argc, char** argv);
+
+/**
+  Prevent the compiler from optimizing away a value.
+ */
+template<class T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+/**
+  Prevent the compiler from moving memory accesses across this point.
+ */
+inline void ClobberMemory()
+{
+#if defined(__GNUC__)
+  asm volatile("" : : : "memory");
+#endif
+}
+
+}  // end of namespace
+
+// Helper macros to create a unique variable name
+#define BENCHMARK_CONCAT2(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+
+#if defined(__GNUC__)
+  #define BENCHMARK_UNUSED __attribute__((unused))
+#else
+  #define BENCHMARK_UNUSED
+#endif
+
+/**
+  Register a benchmark function.
+ */
+#define BENCHMARK(func) \
+  static benchmark::Benchmark* BENCHMARK_CONCAT(_benchmark_, __LINE__) BENCHMARK_UNUSED = \
+    benchmark::RegisterBenchmark(#func, func)
+
+#endif
@@ -0,0 +1,179 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef ANIMCURVE_H
+#define ANIMCURVE_H
+
+/** \file animcurve.h
+ Contains the keyframe curve classes.
+ */
+
+#include <vector>
+#include "quat.h"
+
+namespace support3d {
+
+/**
+  Base class for keyframe curves.
+
+  This class stores the key times and the interpolation mode of each
+  key (which determines how the segment that starts at that key is
+  interpolated) and implements the segment lookup that is shared by
+  the scalar and the quaternion curves.
+
+  The segment lookup first checks the segment that was found during the
+  previous lookup and its successor, so evaluating a curve at steadily
+  increasing times (which is the common case during playback) doesn't
+  require a search at all. Otherwise, a binary search is done. If the
+  keys are equally spaced (setSampledKeys()) the segment is computed
+  directly from the time.
+
+  The lookup cache is modified by the const evaluation methods, so a
+  curve must not be evaluated from several threads simultaneously
+  (different curves may be evaluated in parallel).
+ */
+class AnimCurveBase
+{
+  public:
+  /// Interpolation modes (the mode of a key applies to the following segment).
+  enum Interpolation { STEP=0, LINEAR=1, HERMITE=2 };
+
+  protected:
+  /// Key times (sorted in ascending order).
+  std::vector<double> times;
+  /// Interpolation mode of each key.
+  std::vector<unsigned char> interps;
+  /// The segment that was found by the last lookup.
+  mutable int lastseg;
+  /// True if the keys are equally spaced.
+  bool uniform;
+  /// Time of the first key (only valid if uniform is true).
+  double start;
+  /// Inverse of the time step between the keys (only valid if uniform is true).
+  double invdt;
+
+  public:
+  AnimCurveBase() : times(), interps(), lastseg(0), uniform(false), start(0.0), invdt(0.0) {}
+
+  /// Return the number of keys.
+  int numKeys() const { return int(times.size()); }
+  double getTime(int idx) const;
+  Interpolation getInterpolation(int idx) const;
+  void setInterpolation(int idx, Interpolation ip);
+  int findSegment(double t) const { double u; return locate(t, u); }
+
+  protected:
+  int locate(double t, double& u) const;
+  int insertTime(double t, Interpolation ip, bool& replaced);
+  void removeTime(int idx);
+  void setTimes(int n, const double* t, Interpolation ip);
+  void setSampledTimes(double t0, double dt, int n, Interpolation ip);
+  void checkIndex(int idx) const;
+};
+
+/**
+  Scalar keyframe curve.
+
+  Each key has a time, a value and an in and out tangent. The tangents
+  are slopes (value change per time unit) and are only used by HERMITE
+  segments. A Bezier segment whose control points are located at 1/3
+  and 2/3 of the segment duration is identical to a Hermite segment,
+  so Bezier curves can be stored by converting their control values
+  with setBezierControls().
+
+  Before the first key and after the last key the curve is constant.
+ */
+class AnimCurve : public AnimCurveBase
+{
+  protected:
+  /// Key values.
+  std::vector<double> values;
+  /// Incoming tangent of each key.
+  std::vector<double> intangents;
+  /// Outgoing tangent of each key.
+  std::vector<double> outtangents;
+
+  public:
+  AnimCurve() : AnimCurveBase(), values(), intangents(), outtangents() {}
+
+  double getValue(int idx) const;
+  double getInTangent(int idx) const;
+  double getOutTangent(int idx) const;
+
+  void clear();
+  int insertKey(double t, double v, Interpolation ip=LINEAR);
+  void removeKey(int idx);
+  void setKeys(int n, const double* t, const double* v, int vstride=1, Interpolation ip=LINEAR);
+  void setSampledKeys(double t0, double dt, int n, const double* v, int vstride=1, Interpolation ip=LINEAR);
+  void setTangents(int idx, double intangent, double outtangent);
+  void setBezierControls(int idx, double c1, double c2);
+  void computeTangents(int first, int last);
+
+  double eval(double t) const;
+
+  protected:
+  double autoTangent(int idx) const;
+};
+
+/**
+  Quaternion keyframe curve.
+
+  The keys are unit quaternions which are interpolated with spherical
+  linear interpolation (LINEAR and HERMITE segments) along the shortest
+  path or held constant (STEP segments).
+ */
+class QuatAnimCurve : public AnimCurveBase
+{
+  protected:
+  /// Key values (unit quaternions).
+  std::vector<quatd> values;
+
+  public:
+  QuatAnimCurve() : AnimCurveBase(), values() {}
+
+  const quatd& getValue(int idx) const;
+
+  void clear();
+  int insertKey(double t, const quatd& q, Interpolation ip=LINEAR);
+  void removeKey(int idx);
+  void setKeys(int n, const double* t, const quatd* q, Interpolation ip=LINEAR);
+  void setSampledKeys(double t0, double dt, int n, const quatd* q, Interpolation ip=LINEAR);
+
+  quatd eval(double t) const;
+};
+
+}  // end of namespace
+
+#endif
@@ -0,0 +1,192 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef ANIMCURVESET_H
+#define ANIMCURVESET_H
+
+/** \file animcurveset.h
+ Contains the AnimCurveSet component.
+ */
+
+#include <vector>
+#include "component.h"
+#include "slot.h"
+#include "animcurve.h"
+
+namespace support3d {
+
+class AnimCurveSet;
+
+/**
+  Output slot of an AnimCurveSet channel.
+
+  The slot obtains its value from its channel in the owning component.
+ */
+template<class T>
+class AnimCurveSlot : public Slot<T>
+{
+  protected:
+  /// The component that owns the slot.
+  AnimCurveSet* owner;
+  /// Channel index.
+  int channel;
+
+  public:
+  AnimCurveSlot(AnimCurveSet* aowner, int achannel)
+    : Slot<T>(Slot<T>::NO_INPUT_CONNECTIONS), owner(aowner), channel(achannel) {}
+
+  protected:
+  virtual void computeValue();
+};
+
+/**
+  A set of keyframe curves that drive output slots.
+
+  The component stores any number of scalar curves (AnimCurve) and
+  quaternion curves (QuatAnimCurve) which are grouped into channels.
+  Each channel has an output slot that holds the channel value at the
+  time given by the \c time slot:
+
+  - DOUBLE_CHANNEL: 1 scalar curve, Slot<double>
+  - VEC3_CHANNEL: 3 scalar curves, Slot<vec3d>
+  - QUAT_CHANNEL: 1 quaternion curve, Slot<quatd>
+  - MAT3_CHANNEL: 1 quaternion curve, Slot<mat3d> (can be connected to the
+    \c rot slot of a world object)
+
+  When the time changes all output slots are invalidated and as soon as
+  the first output value is requested, all curves are evaluated at once
+  (in parallel when the library is compiled with OpenMP support). The
+  remaining output slots then only pick up the precomputed values.
+
+  The time is multiplied by the time scale and, if the modulo value is
+  greater than 0, wrapped into the range [0, modulo) before the curves
+  are evaluated.
+
+  The curves may be modified directly via curve() and quatCurve(), but
+  then curvesChanged() has to be called afterwards.
+ */
+class AnimCurveSet : public Component
+{
+  public:
+  /// Channel types.
+  enum ChannelType { DOUBLE_CHANNEL, VEC3_CHANNEL, QUAT_CHANNEL, MAT3_CHANNEL };
+
+  /// Input time.
+  Slot<double> time;
+
+  protected:
+  /// Channel information.
+  struct Channel
+  {
+    string name;
+    ChannelType type;
+    /// Index of the (first) curve of the channel.
+    int curve;
+    /// Output slot (owned by the component).
+    ISlot* slot;
+  };
+
+  /// Scalar curves.
+  std::vector<AnimCurve> curves;
+  /// Quaternion curves.
+  std::vector<QuatAnimCurve> quatcurves;
+  /// Channels.
+  std::vector<Channel> channels;
+
+  /// Scalar curve values at evaltime.
+  std::vector<double> curvevalues;
+  /// Quaternion curve values at evaltime.
+  std::vector<quatd> quatvalues;
+  /// The time at which the curves were evaluated (value of the time slot).
+  double evaltime;
+  /// True if curvevalues and quatvalues contain the values at evaltime.
+  bool valuesvalid;
+
+  /// Loop duration (0 = no looping).
+  double modulo;
+  /// Time scale.
+  double tscale;
+  /// Passes changes of the time slot on to the output slots.
+  NotificationForwarder<AnimCurveSet> _on_time_event;
+
+  public:
+  AnimCurveSet(string aname="");
+  virtual ~AnimCurveSet();
+
+  int addChannel(const string& name, ChannelType type);
+  /// Return the number of channels.
+  int numChannels() const { return int(channels.size()); }
+  int findChannel(const string& name) const;
+  const string& getChannelName(int idx) const;
+  ChannelType getChannelType(int idx) const;
+  int getChannelCurve(int idx) const;
+  ISlot& getChannelSlot(int idx) const;
+
+  /// Return the number of scalar curves.
+  int numCurves() const { return int(curves.size()); }
+  /// Return the number of quaternion curves.
+  int numQuatCurves() const { return int(quatcurves.size()); }
+  AnimCurve& curve(int idx);
+  QuatAnimCurve& quatCurve(int idx);
+  void curvesChanged();
+
+  double getModulo() const { return modulo; }
+  void setModulo(double m);
+  double getTScale() const { return tscale; }
+  void setTScale(double s);
+  double localTime(double t) const;
+
+  void evaluate(double t, double* values, quatd* quats) const;
+
+  void getChannelValue(int idx, double& v);
+  void getChannelValue(int idx, vec3d& v);
+  void getChannelValue(int idx, quatd& v);
+  void getChannelValue(int idx, mat3d& v);
+
+  protected:
+  void onTimeChanged();
+  void update();
+  void checkChannel(int idx) const;
+};
+
+template<class T>
+void AnimCurveSlot<T>::computeValue()
+{
+  owner->getChannelValue(channel, Slot<T>::value);
+}
+
+}  // end of namespace
+
+#endif
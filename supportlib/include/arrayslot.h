@@ -413,6 +413,26 @@ class IArraySlot : public ISlot
     \param index Begin of the slice in the target ArraySlot
    */
   virtual void copyValues(int begin, int end, IArraySlot& target, int index) = 0;
+
+  /** Rearrange the values of the array using an index table.
+
+    After the call, value i (0 <= i < \a n) is the value that was stored
+    at position \a indices[i] in the slot \a source (or in this slot if
+    \a source is 0) before the call. The values at positions \a n and
+    above remain unchanged, the size of the array is not modified.
+    An index may appear several times in the table.
+
+    This method can be used to reorder, compact or copy primitive
+    variables without knowing their type (usually followed or preceded
+    by a resize() call). \a source has to be of the same type than this
+    slot. If any index is out of range or \a n is larger than the array
+    size, an exception is thrown.
+
+    \param indices Index table with \a n entries
+    \param n Number of entries in the index table
+    \param source Source slot (0 = this slot)
+   */
+  virtual void gatherValues(const int* indices, int n, IArraySlot* source=0) = 0;
 };
 
 
@@ -430,7 +450,7 @@ class ArraySlot : public IArraySlot
 {
   protected:
   /// Slots that depend on this slot
-  std::vector<Dependent*> dependents;
+  DependentList dependents;
 
   /// Controlling slot
   ArraySlot<T>* controller;
@@ -447,14 +467,14 @@ class ArraySlot : public IArraySlot
 	    boost::shared_ptr<SizeConstraintBase> aconstraint=boost::shared_ptr<SizeConstraintBase>()) 
     : dependents(), controller(0), values(amultiplicity), constraint(aconstraint) 
   {
-    DEBUGINFO3(this, "ArraySlot::ArraySlot(mult=%d, constraint=0x%lx)  (T: %s)", amultiplicity, long(aconstraint.get()), typeid(T).name());
+    TRACE_INSTANT("slot", "ArraySlot::ArraySlot", this, amultiplicity);
     if (constraint.get()!=0)
       constraint->registerSlot(*this);
   }
   // Destructor
   virtual ~ArraySlot() 
   {
-    DEBUGINFO(this, "ArraySlot::~ArraySlot()");
+    TRACE_INSTANT("slot", "ArraySlot::~ArraySlot", this, dependents.size());
     if (constraint.get()!=0)
       constraint->unregisterSlot(*this);
 
@@ -476,8 +496,6 @@ class ArraySlot : public IArraySlot
         removeDependent(d);
       }
     }
-
-    DEBUGINFO(this, "ArraySlot::~ArraySlot() --- end");
   }
   
   virtual bool isSlotCompatible(const ISlot* slot) const
@@ -504,7 +522,7 @@ class ArraySlot : public IArraySlot
 	return false;
 
     // Check if a dependent will veto the operation...
-    std::vector<Dependent*>::const_iterator it;
+    DependentList::const_iterator it;
     for(it=dependents.begin(); it!=dependents.end(); it++)
     {
       if ((*it)->queryResizeVeto(size))
@@ -517,7 +535,7 @@ class ArraySlot : public IArraySlot
   // resize
   virtual void resize(int size) 
   { 
-    DEBUGINFO1(this, "ArraySlot::resize(%d)", size);
+    TRACE_INSTANT("slot", "ArraySlot::resize", this, size);
 
     // If the size does not change then return immediately...
     if (this->size()==size)
@@ -549,6 +567,7 @@ class ArraySlot : public IArraySlot
   virtual short multiplicity() const { return values.multiplicity(); }
 
   virtual void copyValues(int begin, int end, IArraySlot& target, int index);
+  virtual void gatherValues(const int* indices, int n, IArraySlot* source=0);
 
   virtual const T& getValue(int index);
   virtual void setValue(int index, const T& val);
@@ -587,7 +606,7 @@ class ArraySlot : public IArraySlot
 
   void removeDependent(Dependent* d)
   {
-    std::vector<Dependent*>::iterator res = std::remove(dependents.begin(), dependents.end(), d);
+    DependentList::iterator res = std::remove(dependents.begin(), dependents.end(), d);
     dependents.erase(res, dependents.end());
   }
 
@@ -599,6 +618,7 @@ class ArraySlot : public IArraySlot
   };
   virtual void onControllerDeleted() { setController(0); };
   void notifyDependents() { if (values.size()>0) notifyDependentsValue(0, values.size()); }
+  virtual int numDependents() const { return int(dependents.size()); }
   void notifyDependentsValue(int start, int end);
   void notifyDependentsResize(int size);
 
@@ -699,6 +719,51 @@ void ArraySlot<T>::copyValues(int begin, int end, IArraySlot& target, int index)
   }
 }
 
+template<class T>
+void ArraySlot<T>::gatherValues(const int* indices, int n, IArraySlot* source)
+{
+  if (source==0)
+    source = this;
+  if (controller!=0)
+  {
+    controller->gatherValues(indices, n, (source==this)? controller : source);
+    return;
+  }
+
+  // Check if the type of the source is ok...
+  if (!isSlotCompatible(source))
+    throw EValueError("Cannot copy values between incompatible slots");
+  ArraySlot<T>* typedsource = dynamic_cast<ArraySlot<T>* >(source);
+
+  int i, j;
+  int srcsize = typedsource->size();
+  short mult = values.multiplicity();
+  if (n>values.size())
+    throw EIndexError("Index table is larger than the array.");
+  for(i=0; i<n; i++)
+  {
+    if ((indices[i]<0) || (indices[i]>=srcsize))
+      throw EIndexError();
+  }
+  if (n==0)
+    return;
+
+  // Gather into a temporary buffer (the table may reference values
+  // that get overwritten)...
+  std::vector<T> tmp(n*mult);
+  for(i=0; i<n; i++)
+  {
+    const T* src = &(typedsource->values[indices[i]]);
+    for(j=0; j<mult; j++)
+      tmp[i*mult+j] = src[j];
+  }
+  T* dst = &(values[0]);
+  for(i=0; i<n*mult; i++)
+    dst[i] = tmp[i];
+
+  notifyDependentsValue(0, n);
+}
+
 /**
   Return the value at a particular index.
 
@@ -822,7 +887,7 @@ ISlot* ArraySlot<T>::getController() const
 template<class T>
 void ArraySlot<T>::setController(ISlot* ctrl)
 {
-  DEBUGINFO1(this, "ArraySlot::setController(0x%lx)", long(ctrl));
+  TRACE_INSTANT("slot", "ArraySlot::setController", this, ctrl!=0);
   ArraySlot<T>* newctrl = 0;
 
   // If the new and old controller are the same, then there's nothing to do
@@ -867,7 +932,8 @@ void ArraySlot<T>::setController(ISlot* ctrl)
 template<class T>
 void ArraySlot<T>::notifyDependentsValue(int start, int end)
 {
-  std::vector<Dependent*>::iterator it;
+  SLOTPROF_NOTIFY(dependents.size());
+  DependentList::iterator it;
   for(it=dependents.begin(); it!=dependents.end(); it++)
   {
     (*it)->onValueChanged(start, end);
@@ -877,7 +943,7 @@ void ArraySlot<T>::notifyDependentsValue(int start, int end)
 template<class T>
 void ArraySlot<T>::notifyDependentsResize(int size)
 {
-  std::vector<Dependent*>::iterator it;
+  DependentList::iterator it;
   for(it=dependents.begin(); it!=dependents.end(); it++)
   {
     (*it)->onResize(size);
@@ -0,0 +1,158 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef BEZIERCURVEGEOM_H
+#define BEZIERCURVEGEOM_H
+
+/** \file beziercurvegeom.h
+ Contains the BezierCurveGeom class.
+ */
+
+#include <vector>
+#include "geomobject.h"
+#include "arrayslot.h"
+#include "sizeconstraint.h"
+#include "vec3.h"
+#include "boundingbox.h"
+
+namespace support3d {
+
+/**
+  Cubic Bezier curve.
+
+  The curve is defined by a sequence of points that the curve passes
+  through and an incoming and outgoing tangent per point. The tangents
+  are stored relative to their point, so the control points of segment i
+  are pnts[i], pnts[i]+outtangents[i], pnts[i+1]+intangents[i+1] and
+  pnts[i+1]. A closed curve has an additional segment from the last
+  point back to the first point.
+
+  The curve parameter t runs from 0 to numSegs(), the integer part is
+  the segment number and the fractional part the parameter within the
+  segment.
+
+  The arc length is taken from a table that is built on demand whenever
+  the curve has been modified. Each segment is sampled at ARCLEN_SAMPLES
+  equidistant parameter values and the length between two samples is
+  integrated with a 5-point Gauss-Legendre rule. Segments whose control
+  points lie on a line (in monotone order) have the exact chord length.
+  The table is used by arcLen() and arcLenToParam(), the latter is the
+  inverse of the arc length function and can be used to move along the
+  curve at constant speed.
+
+  The batch versions of eval(), evalFrame() and arcLenToParam() run in
+  parallel when the library is compiled with OpenMP support.
+ */
+class BezierCurveGeom : public GeomObject
+{
+  public:
+  /// Number of arc length samples per segment.
+  enum { ARCLEN_SAMPLES = 16 };
+
+  NotificationForwarder<BezierCurveGeom> _on_curve_event;
+
+  /// The end points of the segments (the curve passes through these points).
+  ArraySlot<vec3d> pnts;
+
+  protected:
+  /// Size constraint for varying variables (and the tangent slots).
+  boost::shared_ptr<LinearSizeConstraint> varyingSizeConstraint;
+  /// Size constraint for vertex variables (one value per control point).
+  boost::shared_ptr<LinearSizeConstraint> vertexSizeConstraint;
+
+  public:
+  /// The incoming tangent of each point (relative to the point).
+  ArraySlot<vec3d> intangents;
+  /// The outgoing tangent of each point (relative to the point).
+  ArraySlot<vec3d> outtangents;
+
+  /// Flatness tolerance that is used for drawing the curve.
+  double epsilon;
+  /// Maximum number of subdivisions per segment when drawing the curve.
+  int subdiv;
+  /// Draw the tangents in drawGL()?
+  bool show_tangents;
+
+  protected:
+  /// True if the curve is closed.
+  bool closed;
+  /// True if the arc length table is still valid.
+  bool arclen_valid;
+  /// Accumulated arc length at the start of each segment (numSegs()+1 values).
+  std::vector<double> seglengths;
+  /// Arc length at the samples of each segment (ARCLEN_SAMPLES+1 values per segment, relative to the segment start).
+  std::vector<double> arclentable;
+  /// Flags that mark straight segments.
+  std::vector<char> straightsegs;
+
+  public:
+  BezierCurveGeom();
+
+  virtual BoundingBox boundingBox();
+  virtual void drawGL();
+  virtual boost::shared_ptr<SizeConstraintBase> slotSizeConstraint(VarStorage storage) const;
+
+  bool isClosed() const { return closed; }
+  void setClosed(bool c);
+  int numSegs() const;
+  void segCtrlPoints(int seg, vec3d* b);
+
+  vec3d eval(double t);
+  void evalFrame(double t, vec3d& p, vec3d& dp, vec3d& d2p);
+  vec3d deriv(double t);
+  void eval(const double* t, int n, vec3d* res);
+  void evalFrame(const double* t, int n, vec3d* p, vec3d* dp, vec3d* d2p);
+
+  double arcLen(double t);
+  double length();
+  double arcLenToParam(double s);
+  void arcLenToParam(const double* s, int n, double* t);
+
+  void flatten(double tol, std::vector<vec3d>& res, int maxdepth=16);
+
+  void onCurveChanged(int start, int end);
+  void onCurveResize(int size);
+
+  protected:
+  int splitParam(double t, double& u);
+  void updateArcLen();
+  double segArcLen(int seg, const vec3d* b, double u);
+  double segParam(int seg, const vec3d* b, double s);
+  double lookupParam(double s);
+};
+
+}  // end of namespace
+
+#endif
@@ -42,6 +42,7 @@
 
 #include "geomobject.h"
 #include "proceduralslot.h"
+#include "tessellationcache.h"
 
 namespace support3d {
 
@@ -70,12 +71,20 @@ class BoxGeom : public GeomObject
   Slot<vec3d> cog;
   ProceduralSlot<mat3d, BoxGeom> inertiatensor;
 
+  /// Forwards changes of the parameter slots to onParamChanged().
+  NotificationForwarder<BoxGeom> _on_param_event;
+
+  protected:
+  /// Cached OpenGL tessellation (invalidated when a parameter changes).
+  TessellationCache tesscache;
+
   public:
   BoxGeom(double alx=1.0, double aly=1.0, double alz=1.0, int segsx=1, int segsy=1, int segsz=1);
   ~BoxGeom();
 
   virtual BoundingBox boundingBox();
   virtual void drawGL();
+  void onParamChanged();
 
   //  virtual int uniformCount() const { return 6; }
   //  virtual int varyingCount() const { return 8; }
@@ -88,6 +97,7 @@ class BoxGeom : public GeomObject
   virtual void convert(GeomObject* target);
 
   private:
+  void tessellate();
   int _vertexIndex(int i, int j, int segsx, int segsy, int offset, int topoffset);
 };
 
@@ -65,12 +65,20 @@ class CCylinderGeom : public GeomObject
   Slot<vec3d> cog;
   ProceduralSlot<mat3d, CCylinderGeom> inertiatensor;
 
+  /// Forwards changes of the parameter slots to onParamChanged().
+  NotificationForwarder<CCylinderGeom> _on_param_event;
+
+  protected:
+  /// Cached OpenGL tessellation (invalidated when a parameter changes).
+  TessellationCache tesscache;
+
   public:
   CCylinderGeom(double aradius=1.0, double alength=1.0, int segsu=16, int segsvl=1, int segsvr=3);
   ~CCylinderGeom();
 
   virtual BoundingBox boundingBox();
   virtual void drawGL();
+  void onParamChanged();
 
   virtual boost::shared_ptr<SizeConstraintBase> slotSizeConstraint(VarStorage storage) const;
 
@@ -0,0 +1,177 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef CHILDCONTAINER_H
+#define CHILDCONTAINER_H
+
+/** \file childcontainer.h
+ Contains the ChildContainer class.
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+#include "boost/shared_ptr.hpp"
+
+namespace support3d {
+
+class WorldObject;
+
+/**
+  An entry of a ChildContainer.
+
+  The members are called \a first and \a second so that the entries
+  can be used like the items of the std::map that was used before.
+ */
+struct ChildEntry
+{
+  /// Children name
+  std::string first;
+  /// Children object (null if the entry has been removed)
+  boost::shared_ptr<WorldObject> second;
+  /// Hash value of the name
+  unsigned int hash;
+};
+
+/**
+  Container for the children of a WorldObject.
+
+  The children are stored in a vector in the order in which they were
+  added. A hash table maps names to positions in the vector, so looking
+  up a children by name takes constant time. Removed children leave a
+  hole in the vector which is skipped during iteration. The vector is
+  compacted once there are more holes than children.
+
+  The container also speeds up makeUnique(): For every base name (the
+  name without trailing number) it stores a number n so that all names
+  base1 ... base(n-1) are known to be in use. So when many objects with
+  the same name are added, the next free name is found immediately
+  instead of probing all previous numbers.
+
+  Iterators store a position instead of a pointer, so adding children
+  doesn't invalidate them. Removing children while iterating is allowed
+  (the removed children are skipped), but when the removal triggers a
+  compaction, the iterator may skip or repeat children.
+ */
+class ChildContainer
+{
+  public:
+
+  /// Iterator over the children (the holes are skipped).
+  class iterator
+  {
+    public:
+    iterator() : cont(0), idx(npos) {}
+    iterator(ChildContainer* acont, size_t aidx) : cont(acont), idx(aidx) { skip(); }
+
+    ChildEntry& operator*() const { return cont->entries[idx]; }
+    ChildEntry* operator->() const { return &(cont->entries[idx]); }
+    iterator& operator++() { idx++; skip(); return *this; }
+    iterator operator++(int) { iterator res(*this); idx++; skip(); return res; }
+    bool operator==(const iterator& it) const { return idx==it.idx; }
+    bool operator!=(const iterator& it) const { return idx!=it.idx; }
+
+    /** Move to the next valid entry if the current entry has been removed.
+
+      This has to be called before the iterator is used again when the
+      container might have been modified in the meantime.
+     */
+    iterator& refresh() { if (idx!=npos) skip(); return *this; }
+
+    protected:
+    /// Move to the next valid entry (or to the end).
+    void skip()
+    {
+      while(idx<cont->entries.size() && cont->entries[idx].second.get()==0)
+        idx++;
+      if (idx>=cont->entries.size())
+        idx = npos;
+    }
+
+    ChildContainer* cont;
+    size_t idx;
+  };
+
+  static const size_t npos = size_t(-1);
+
+  protected:
+  /// The children (in insertion order, removed children are null)
+  std::vector<ChildEntry> entries;
+  /// Number of valid entries
+  size_t numchildren;
+  /// Position of the first valid entry (or a position before it)
+  size_t firstvalid;
+  /// Hash table with indices into entries (-1 = empty, -2 = removed)
+  std::vector<int> index;
+  /// Number of used or removed slots in the hash table
+  size_t indexfill;
+  /// The next number that might be free for a base name
+  mutable std::map<std::string, long> nextsuffix;
+
+  public:
+  ChildContainer();
+
+  /// Return the number of children.
+  int size() const { return int(numchildren); }
+  /// Return true if there are no children.
+  bool empty() const { return numchildren==0; }
+
+  iterator begin();
+  iterator end() { return iterator(); }
+
+  const boost::shared_ptr<WorldObject>* find(const std::string& name) const;
+  bool contains(const std::string& name) const { return findEntry(name, hashName(name))!=-1; }
+  void insert(const std::string& name, boost::shared_ptr<WorldObject> obj);
+  bool erase(const std::string& name);
+  bool rename(const std::string& oldname, const std::string& newname);
+
+  std::string makeUnique(const std::string& name) const;
+
+  static unsigned int hashName(const std::string& name);
+
+  protected:
+  int findEntry(const std::string& name, unsigned int hash) const;
+  int findBucket(const std::string& name, unsigned int hash) const;
+  void reserveIndex();
+  void addToIndex(int entryidx);
+  void rebuildIndex(size_t minsize);
+  void compact();
+  void onNameRemoved(const std::string& name);
+  static size_t splitName(const std::string& name, long& num);
+};
+
+}  // end of namespace
+
+#endif
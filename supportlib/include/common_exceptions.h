@@ -205,6 +205,27 @@ class EKeyError : public std::exception
 
 ////////////////////////////////////////////////////////////////
 
+/**
+  Exception: Syntax error (while parsing a file).
+ */
+class ESyntaxError : public std::exception
+{
+  public:
+  std::string msg;
+
+  public:
+  ESyntaxError(std::string amsg) : msg(amsg) {}
+  ~ESyntaxError() throw() {}
+
+  /// Return exception message.
+  const char* what() const throw()
+  {
+    return msg.c_str();
+  }
+};
+
+////////////////////////////////////////////////////////////////
+
 /**
   Exception: Not implemented
  */
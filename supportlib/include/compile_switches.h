@@ -48,4 +48,11 @@
  #endif
 #endif
 
+// Storage class for thread-local variables
+#ifdef _MSC_VER
+ #define CGKIT_THREAD_LOCAL __declspec(thread)
+#else
+ #define CGKIT_THREAD_LOCAL __thread
+#endif
+
 #endif
@@ -41,9 +41,11 @@
  */
 
 #include <map>
+#include <vector>
 #include <string>
 #include <memory>
 #include "slot.h"
+#include "slotname.h"
 #include "boost/shared_ptr.hpp"
 
 // Define the CGKIT_SHARED variable
@@ -67,6 +69,10 @@ struct SlotDescriptor
 {
   virtual ~SlotDescriptor() {}
   virtual ISlot& getSlot() = 0;
+
+  // Descriptors are allocated from a memory pool
+  static void* operator new(size_t size);
+  static void operator delete(void* p, size_t size);
 };
 
 struct DynamicSlotDescriptor : public SlotDescriptor
@@ -88,16 +94,27 @@ struct StaticSlotDescriptor : public SlotDescriptor
 // Component
 ////////////////////////////////////////////////////////////////
 
+/// A slot of a component.
+struct SlotEntry
+{
+  SlotName name;
+  SlotDescriptor* desc;
+
+  SlotEntry(const SlotName& aname, SlotDescriptor* adesc) : name(aname), desc(adesc) {}
+};
+
+/// Iterates over the slots of a component in alphabetical order.
 class CGKIT_SHARED SlotIterator
 {
   private:
-  std::map<string, SlotDescriptor*>::const_iterator it;
+  const std::vector<SlotEntry>* slots;
+  std::vector<int>::const_iterator it;
   std::pair<string, SlotDescriptor*> item;
 
   public:
-  SlotIterator() { }
-  SlotIterator(std::map<string, SlotDescriptor*>::const_iterator ait)
-    : it(ait) 
+  SlotIterator() : slots(0) { }
+  SlotIterator(const std::vector<SlotEntry>& aslots, std::vector<int>::const_iterator ait)
+    : slots(&aslots), it(ait) 
   {}
 
   bool operator==(const SlotIterator& s) { return it==s.it; }
@@ -106,8 +123,9 @@ class CGKIT_SHARED SlotIterator
   void operator++(int) { it++; }
   std::pair<string, SlotDescriptor*>* operator->() 
   { 
-    item.first=it->first; 
-    item.second=it->second; 
+    const SlotEntry& e = (*slots)[*it];
+    item.first=e.name.str(); 
+    item.second=e.desc; 
     return &item; 
   }
 };
@@ -117,7 +135,19 @@ class CGKIT_SHARED SlotIterator
 
   A component is a named container for slots.
 
-  \see ISlot
+  The slots are stored in a vector in the order in which they were
+  added together with an open addressing hash table that maps the hash
+  value of a name to the position of the slot in the vector, so adding
+  and removing a slot takes constant time. Iterating over the slots
+  returns them in alphabetical order (the sorted order is computed on
+  demand and kept until a slot is added or removed).
+
+  A slot can be looked up by a plain string or by a SlotName. In the
+  latter case the hash value is already known and the names are
+  compared by pointer. Code that accesses the same slot repeatedly
+  should use a SlotHandle.
+
+  \see ISlot, SlotName, SlotHandle
  */
 class CGKIT_SHARED Component
 {
@@ -131,8 +161,18 @@ class CGKIT_SHARED Component
 
   protected:
 
-  /// Slot dictionary.
-  std::map<string, SlotDescriptor*> slots;
+  /// Slots (in the order in which they were added).
+  std::vector<SlotEntry> slots;
+  /// Hash table with indices into slots (-1 marks an empty bucket).
+  std::vector<int> slotindex;
+  /// Indices into slots sorted by name (only valid if sortedslots_valid is true).
+  mutable std::vector<int> sortedslots;
+  /// Is sortedslots up to date?
+  mutable bool sortedslots_valid;
+  /// Serial number that changes whenever a slot is added or removed.
+  unsigned long slot_serial;
+  /// Global counter that provides the slot serial numbers.
+  static unsigned long slot_serial_counter;
 
   public:
   Component(string aname="");
@@ -155,6 +195,17 @@ class CGKIT_SHARED Component
   bool hasSlot(const string& name) const;
   int numSlots() const;
   ISlot& slot(const string& name) const;
+  ISlot* findSlot(const string& name) const;
+  ISlot* findSlot(const SlotName& name) const;
+
+  /**
+    Return the serial number of the slot table.
+
+    The number changes whenever a slot is added or removed. Serial
+    numbers are unique among all components, so two components
+    never report the same number.
+   */
+  unsigned long getSlotSerial() const { return slot_serial; }
   
   void addSlot(const string& name, auto_ptr<ISlot> slot);
   void addSlot(const string& name, ISlot& slot);
@@ -163,8 +214,96 @@ class CGKIT_SHARED Component
 
 //  SlotIterator slotsBegin() const { return slots.begin(); }
 //  SlotIterator slotsEnd() const { return slots.end(); }
-  SlotIterator slotsBegin() const { return SlotIterator(slots.begin()); }
-  SlotIterator slotsEnd() const { return SlotIterator(slots.end()); }
+  SlotIterator slotsBegin() const { return SlotIterator(slots, sortedSlots().begin()); }
+  SlotIterator slotsEnd() const { return SlotIterator(slots, sortedSlots().end()); }
+
+  protected:
+  int findSlotIndex(const string& name, unsigned int hash) const;
+  void insertSlotEntry(const SlotName& name, SlotDescriptor* desc);
+  void removeSlotEntry(int idx);
+  unsigned int slotBucket(int idx) const;
+  void rebuildSlotIndex();
+  const std::vector<int>& sortedSlots() const;
+};
+
+
+/**
+  Provides fast access to a slot of a component.
+
+  A handle stores an interned slot name and caches the slot that
+  was found for the last component. As long as the handle is used
+  with the same component and no slot was added or removed in the
+  meantime, get() returns the cached slot without any lookup or
+  dynamic_cast. The handle can be used with different components,
+  in this case the slot is looked up again whenever the component
+  changes.
+
+  Example:
+
+  \code
+  static SlotHandle<vec3d> cog_handle("cog");
+  Slot<vec3d>* cogslot = cog_handle.get(*geom);
+  if (cogslot!=0)
+    cog = cogslot->getValue();
+  \endcode
+
+  T is the type of the slot value and S is the slot class.
+ */
+template<class T, class S = Slot<T> >
+class SlotHandle
+{
+  protected:
+  /// Slot name
+  SlotName name;
+  /// The component that was used for the last lookup
+  const Component* owner;
+  /// The slot serial number of owner at the time of the last lookup
+  unsigned long serial;
+  /// Cached slot (0 if owner has no such slot or the type doesn't match)
+  S* slot;
+
+  public:
+  explicit SlotHandle(const char* aname) : name(aname), owner(0), serial(0), slot(0) {}
+  explicit SlotHandle(const SlotName& aname) : name(aname), owner(0), serial(0), slot(0) {}
+
+  /// Return the slot name.
+  const SlotName& getName() const { return name; }
+
+  /**
+    Return the slot of a component.
+
+    \return The slot or 0 if comp has no slot with the name of the handle or the slot has a different type.
+   */
+  S* get(const Component& comp)
+  {
+    if (&comp!=owner || comp.getSlotSerial()!=serial)
+    {
+      ISlot* s = comp.findSlot(name);
+      slot = (s==0)? 0 : dynamic_cast<S*>(s);
+      owner = &comp;
+      serial = comp.getSlotSerial();
+    }
+    return slot;
+  }
+
+  /**
+    Retrieve the value of the slot of a component.
+
+    \param comp Component
+    \param[out] target Receives the slot value
+    \return True if the value could be retrieved (target is left unchanged otherwise).
+   */
+  bool getVal(const Component& comp, T& target)
+  {
+    S* s = get(comp);
+    if (s==0)
+      return false;
+    target = s->getValue();
+    return true;
+  }
+
+  /// Forget the cached slot.
+  void reset() { owner = 0; slot = 0; }
 };
 
 
@@ -0,0 +1,154 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef DEPENDENTLIST_H
+#define DEPENDENTLIST_H
+
+/** \file dependentlist.h
+ Contains the DependentList class.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include "dependent.h"
+
+namespace support3d {
+
+/**
+  List of the dependents of a slot.
+
+  This is a minimal vector replacement that stores up to two dependents
+  inside the object itself. Most slots have no more than two dependents,
+  so creating and destroying slots usually doesn't touch the heap at
+  all. Once there are more dependents, they are stored in a heap
+  allocated array that grows like a std::vector. The object has the
+  same size as a std::vector.
+
+  The iterators are plain pointers which are invalidated when a
+  dependent is added or removed.
+ */
+class DependentList
+{
+  public:
+  typedef Dependent** iterator;
+  typedef Dependent* const* const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+
+  DependentList() : num(0), capacity(LOCAL_SIZE) {}
+  DependentList(const DependentList& l) : num(0), capacity(LOCAL_SIZE) { append(l); }
+  ~DependentList() { if (capacity>LOCAL_SIZE) delete [] heap; }
+
+  DependentList& operator=(const DependentList& l)
+  {
+    if (this!=&l)
+    {
+      num = 0;
+      append(l);
+    }
+    return *this;
+  }
+
+  iterator begin() { return data(); }
+  iterator end() { return data()+num; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data()+num; }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  /// Return the number of dependents.
+  unsigned int size() const { return num; }
+  /// Return true if there are no dependents.
+  bool empty() const { return num==0; }
+  Dependent* operator[](unsigned int idx) const { return data()[idx]; }
+
+  /// Append a dependent.
+  void push_back(Dependent* d)
+  {
+    if (num==capacity)
+      grow();
+    data()[num++] = d;
+  }
+
+  /// Remove one dependent (the following dependents are moved forward).
+  iterator erase(iterator pos) { return erase(pos, pos+1); }
+
+  /// Remove a range of dependents.
+  iterator erase(iterator first, iterator last)
+  {
+    std::copy(last, end(), first);
+    num -= (unsigned int)(last-first);
+    return first;
+  }
+
+  private:
+  /// Number of dependents that are stored inside the object
+  enum { LOCAL_SIZE = 2 };
+
+  Dependent** data() { return (capacity>LOCAL_SIZE)? heap : local; }
+  Dependent* const* data() const { return (capacity>LOCAL_SIZE)? heap : local; }
+
+  void append(const DependentList& l)
+  {
+    for(const_iterator it=l.begin(); it!=l.end(); it++)
+      push_back(*it);
+  }
+
+  void grow()
+  {
+    unsigned int newcap = 2*capacity;
+    Dependent** p = new Dependent*[newcap];
+    std::copy(begin(), end(), p);
+    if (capacity>LOCAL_SIZE)
+      delete [] heap;
+    heap = p;
+    capacity = newcap;
+  }
+
+  union
+  {
+    /// Inline storage (used as long as capacity is LOCAL_SIZE)
+    Dependent* local[LOCAL_SIZE];
+    /// Heap storage (used when capacity is larger than LOCAL_SIZE)
+    Dependent** heap;
+  };
+  /// Number of dependents
+  unsigned int num;
+  /// Number of dependents that fit into the current storage
+  unsigned int capacity;
+};
+
+}  // end of namespace
+
+#endif
@@ -75,6 +75,13 @@ struct D_Line
   Draw geometry.
 
   This class represents a collection of markers and lines.
+
+  For drawing, all markers and lines are packed into contiguous vertex
+  and color arrays (each marker becomes a small octahedron) that are
+  drawn with one call for the markers and one call for the lines. The
+  arrays are only rebuilt when markers or lines have been added or
+  removed. If the \a markers or \a lines vectors are modified directly,
+  invalidateArrays() has to be called.
  */
 class DrawGeom : public GeomObject
 {
@@ -82,6 +89,20 @@ class DrawGeom : public GeomObject
   std::vector<D_Marker> markers;
   std::vector<D_Line> lines;
 
+  protected:
+  /// Marker vertices (6 per marker, 3 floats each).
+  std::vector<float> markerverts;
+  /// Marker colors (one RGB triple per marker vertex).
+  std::vector<float> markercolors;
+  /// Marker triangles (8 per marker, indices into markerverts).
+  std::vector<unsigned int> markerindices;
+  /// Line vertices (2 per line, 3 floats each).
+  std::vector<float> lineverts;
+  /// Line colors (one RGB triple per line vertex).
+  std::vector<float> linecolors;
+  /// True if the above arrays are up to date.
+  bool arrays_valid;
+
   public:
   DrawGeom();
   virtual ~DrawGeom();
@@ -92,6 +113,14 @@ class DrawGeom : public GeomObject
   void clear();
   void marker(const vec3d& pos, const vec3d& col=vec3d(1,1,1), float size=1.0f);
   void line(const vec3d& pos1, const vec3d& pos2, const vec3d& col=vec3d(1,1,1), float size=1.0f);
+
+  void invalidateArrays() { arrays_valid = false; }
+  void packArrays();
+  const std::vector<float>& getMarkerVerts() const { return markerverts; }
+  const std::vector<float>& getMarkerColors() const { return markercolors; }
+  const std::vector<unsigned int>& getMarkerIndices() const { return markerindices; }
+  const std::vector<float>& getLineVerts() const { return lineverts; }
+  const std::vector<float>& getLineColors() const { return linecolors; }
 };
 
 
@@ -0,0 +1,227 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef EXPRESSIONSLOT_H
+#define EXPRESSIONSLOT_H
+
+/** \file expressionslot.h
+ Contains the ExpressionSlot class.
+ */
+
+#include <vector>
+#include <string>
+#include "slot.h"
+#include "exprprogram.h"
+#include "common_exceptions.h"
+
+namespace support3d {
+
+// Helper functions that map the slot types to the expression types
+inline ExprProgram::Type exprResultType(const double&) { return ExprProgram::FLOAT; }
+inline ExprProgram::Type exprResultType(const vec3d&) { return ExprProgram::VEC3; }
+inline ExprProgram::Type exprResultType(const mat3d&) { return ExprProgram::MAT3; }
+inline ExprProgram::Type exprResultType(const mat4d&) { return ExprProgram::MAT4; }
+
+// Copy a value into an array of doubles (matrices are stored row-major)
+inline void exprStoreValue(const double& v, double* dst) { dst[0] = v; }
+inline void exprStoreValue(const vec3d& v, double* dst) { dst[0] = v.x; dst[1] = v.y; dst[2] = v.z; }
+inline void exprStoreValue(const mat3d& m, double* dst)
+{
+  for(int i=0; i<9; i++)
+    dst[i] = m.at(i/3, i%3);
+}
+inline void exprStoreValue(const mat4d& m, double* dst)
+{
+  for(int i=0; i<4; i++)
+    m.getRow(i, dst[4*i], dst[4*i+1], dst[4*i+2], dst[4*i+3]);
+}
+
+// Copy an array of doubles into a value
+inline void exprLoadValue(const double* src, double& v) { v = src[0]; }
+inline void exprLoadValue(const double* src, vec3d& v) { v.set(src[0], src[1], src[2]); }
+inline void exprLoadValue(const double* src, mat3d& m)
+{
+  for(int i=0; i<9; i++)
+    m.at(i/3, i%3) = src[i];
+}
+inline void exprLoadValue(const double* src, mat4d& m)
+{
+  for(int i=0; i<16; i++)
+    m.at(i/4, i%4) = src[i];
+}
+
+/**
+  A procedural slot whose value is computed by a compiled expression.
+
+  The variables of the expression are bound to other slots via
+  addVariable() (a variable has the type of its slot which must be a
+  double, vec3d, mat3d or mat4d slot). After all variables have been
+  added, the expression is compiled with compile(). Whenever the value
+  of the slot is requested, the expression is evaluated with the
+  current values of the input slots (see ExprProgram).
+
+  The slot does not add itself as a dependent to the input slots, this
+  is up to the owner of the slot (the input slots must also live at
+  least as long as the expression slot).
+
+  Example:
+
+  \code
+  Slot<double> t;
+  Slot<double> amp(0.2, 0);
+  ExpressionSlot<double> output;
+  output.addVariable("t", t);
+  output.addVariable("amp", amp);
+  output.compile("1.0 + amp*sin(t)");
+  t.addDependent(&output);
+  amp.addDependent(&output);
+  \endcode
+ */
+template<class T>
+class ExpressionSlot : public Slot<T>
+{
+  protected:
+  /// The compiled expression.
+  ExprProgram program;
+  /// Input slots (one per variable).
+  std::vector<ISlot*> inputs;
+  /// Variable values (one pointer per variable into varvalues).
+  std::vector<const double*> varptrs;
+  /// Storage for the variable values.
+  std::vector<double> varvalues;
+
+  public:
+  ExpressionSlot()
+    : Slot<T>(Slot<T>::NO_INPUT_CONNECTIONS), program(), inputs(), varptrs(), varvalues() {}
+
+  void addVariable(const std::string& name, ISlot& slot);
+  void compile(const std::string& expr);
+
+  /// Return the compiled program.
+  const ExprProgram& getProgram() const { return program; }
+
+  protected:
+  virtual void computeValue();
+};
+
+/**
+  Add a variable and bind it to a slot.
+
+  \param name Variable name
+  \param slot Slot that provides the value of the variable
+ */
+template<class T>
+void ExpressionSlot<T>::addVariable(const std::string& name, ISlot& slot)
+{
+  ExprProgram::Type type;
+  if (dynamic_cast<Slot<double>*>(&slot)!=0)
+    type = ExprProgram::FLOAT;
+  else if (dynamic_cast<Slot<vec3d>*>(&slot)!=0)
+    type = ExprProgram::VEC3;
+  else if (dynamic_cast<Slot<mat3d>*>(&slot)!=0)
+    type = ExprProgram::MAT3;
+  else if (dynamic_cast<Slot<mat4d>*>(&slot)!=0)
+    type = ExprProgram::MAT4;
+  else
+    throw EValueError("Variable \""+name+"\": unsupported slot type.");
+
+  program.addVariable(name, type);
+  inputs.push_back(&slot);
+}
+
+/**
+  Compile the expression.
+
+  The result type of the expression is the type of the slot.
+
+  \param expr Expression string
+  \exception EValueError The expression can't be compiled
+ */
+template<class T>
+void ExpressionSlot<T>::compile(const std::string& expr)
+{
+  program.compile(expr, exprResultType(Slot<T>::value));
+
+  // Set up the storage for the variable values
+  int size = 0;
+  int i;
+  for(i=0; i<program.numVariables(); i++)
+    size += program.getVariableType(i);
+  varvalues.resize(size);
+  varptrs.resize(program.numVariables());
+  size = 0;
+  for(i=0; i<program.numVariables(); i++)
+  {
+    varptrs[i] = &varvalues[size];
+    size += program.getVariableType(i);
+  }
+
+  // The value has to be recomputed
+  this->onValueChanged();
+}
+
+template<class T>
+void ExpressionSlot<T>::computeValue()
+{
+  double res[16];
+  double* dst = varvalues.empty()? 0 : &varvalues[0];
+
+  for(unsigned int i=0; i<inputs.size(); i++)
+  {
+    switch(program.getVariableType(i))
+    {
+    case ExprProgram::FLOAT:
+      exprStoreValue(static_cast<Slot<double>*>(inputs[i])->getValue(), dst);
+      break;
+    case ExprProgram::VEC3:
+      exprStoreValue(static_cast<Slot<vec3d>*>(inputs[i])->getValue(), dst);
+      break;
+    case ExprProgram::MAT3:
+      exprStoreValue(static_cast<Slot<mat3d>*>(inputs[i])->getValue(), dst);
+      break;
+    case ExprProgram::MAT4:
+      exprStoreValue(static_cast<Slot<mat4d>*>(inputs[i])->getValue(), dst);
+      break;
+    }
+    dst += program.getVariableType(i);
+  }
+
+  program.evaluate(varptrs.empty()? 0 : &varptrs[0], res);
+  exprLoadValue(res, Slot<T>::value);
+}
+
+}  // end of namespace
+
+#endif
@@ -0,0 +1,199 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef EXPRPROGRAM_H
+#define EXPRPROGRAM_H
+
+/** \file exprprogram.h
+ Contains the ExprProgram class.
+ */
+
+#include <vector>
+#include <string>
+#include "vec3.h"
+#include "mat3.h"
+#include "mat4.h"
+
+namespace support3d {
+
+/**
+  A compiled expression.
+
+  An expression is a string using (a subset of) the Python syntax that
+  computes a single value from a number of named input variables. The
+  variables have to be declared with addVariable() before the expression
+  is compiled. compile() translates the expression into a sequence of
+  instructions for a small register machine that can then be evaluated
+  repeatedly without parsing the expression again.
+
+  Values are either floats, vectors (vec3), 3x3 or 4x4 matrices. The type
+  also determines how many doubles a value occupies (the enum values are
+  the sizes). Matrices are stored in row-major order.
+
+  The following constructs are supported:
+
+  - int and float literals, the constants pi, e and PI
+  - the operators + - * / // % ** with the usual Python 2 semantics
+    (the division of two integers is a floor division, vec3*vec3 is the
+    dot product, mat*vec3 and vec3*mat transform a vector), unary + and -
+  - comparisons (may be chained), and, or, not, conditional expressions
+    (<tt>a if cond else b</tt>) on floats
+  - component access v.x, v.y, v.z, v[i] on vectors, and the methods
+    length(), normalize() and cross() on vectors and transpose(),
+    determinant() and inverse() on matrices
+  - the vec3, mat3 and mat4 constructors, the static methods
+    mat3.identity(), mat3.rotation(), mat3.scaling(),
+    mat3.fromEulerXYZ() (and the other orders), mat4.identity(),
+    mat4.translation(), mat4.rotation() and mat4.scaling()
+  - the functions from the math module, the builtins abs(), min(), max(),
+    round(), int() and float() and the sl functions clamp(), mix(),
+    smoothstep(), step(), sign(), mod(), length(), normalize(), distance()
+    and inversesqrt()
+  - the noise functions noise(), snoise(), cellnoise(), scellnoise(),
+    fBm(), turbulence(), vnoise() and vsnoise() (with or without the
+    "noise." prefix) and the sl functions float_noise(),
+    float_cellnoise() and point_noise()
+  - a tuple with 3 floats as result value (which is converted to a vec3)
+
+  Everything else (strings, lists, attribute access on arbitrary
+  objects, lambdas, ...) makes compile() fail with an exception, so
+  the caller can fall back to evaluating the expression in Python.
+  Runtime errors are reported as in Python: divisions by zero raise an
+  EZeroDivisionError, math domain errors (such as sqrt(-1), log(0) or
+  (-8)**(1.0/3)) raise an EValueError. If such an error occurs in a
+  constant subexpression, compile() fails. Unlike in Python, an
+  overflow (such as exp(1000)) doesn't raise an exception but produces
+  an infinite value.
+
+  Constant subexpressions are evaluated once during compilation.
+
+  The program can either be evaluated for a single set of input values
+  or for many instances at once. In the latter case the instructions
+  are executed on blocks of instances, so the cost of dispatching an
+  instruction is shared by all instances in a block. Blocks are
+  processed in parallel when the library was compiled with OpenMP
+  support.
+
+  Example:
+
+  \code
+  ExprProgram prog;
+  prog.addVariable("t", ExprProgram::FLOAT);
+  prog.addVariable("amp", ExprProgram::FLOAT);
+  prog.compile("1.0 + amp*sin(2*t)");
+  const double* vars[2] = {&t, &amp};
+  double res;
+  prog.evaluate(vars, &res);
+  \endcode
+ */
+class ExprProgram
+{
+  public:
+  /// Value types (the value is the number of doubles per value).
+  enum Type { FLOAT=1, VEC3=3, MAT3=9, MAT4=16 };
+
+  /// A single instruction.
+  struct Instr
+  {
+    /// Opcode.
+    short op;
+    /// Immediate integer argument (e.g. the number of components).
+    short imm;
+    /// First destination register.
+    int dst;
+    /// Argument registers.
+    int arg[6];
+  };
+
+  protected:
+  /// An input variable.
+  struct Variable
+  {
+    std::string name;
+    Type type;
+    /// First register of the variable.
+    int reg;
+  };
+
+  /// Input variables.
+  std::vector<Variable> vars;
+  /// The expression string that was compiled last.
+  std::string expr;
+  /// Instructions.
+  std::vector<Instr> code;
+  /// Initial register contents (constants, the remaining registers are 0).
+  std::vector<double> constregs;
+  /// First register of the result value.
+  int resultreg;
+  /// Result type.
+  Type resulttype;
+  /// True if compile() succeeded.
+  bool compiled;
+  /// Registers for single evaluations.
+  mutable std::vector<double> regs;
+
+  public:
+  ExprProgram();
+
+  void clear();
+  int addVariable(const std::string& name, Type type);
+  int numVariables() const { return int(vars.size()); }
+  std::string getVariableName(int idx) const;
+  Type getVariableType(int idx) const;
+  int findVariable(const std::string& name) const;
+
+  void compile(const std::string& aexpr);
+  void compile(const std::string& aexpr, Type restype);
+  bool isCompiled() const { return compiled; }
+  std::string getExpression() const { return expr; }
+  Type getResultType() const { return resulttype; }
+  int numInstructions() const { return int(code.size()); }
+  int numRegisters() const { return int(constregs.size()); }
+
+  void evaluate(const double* const* varvalues, double* result) const;
+  void evaluate(int n, const double* const* varvalues, const int* varstrides, double* result) const;
+
+  static const char* typeName(Type type);
+
+  protected:
+  void checkCompiled() const;
+  void execute(const Instr* begin, const Instr* end, double* r, int lanes, int n) const;
+
+  friend class ExprCompiler;
+};
+
+}  // end of namespace
+
+#endif
@@ -48,6 +48,7 @@
 #include "vec4.h"
 #include "mat4.h"
 #include "slot.h"
+#include "textureimage.h"
 #include <boost/shared_ptr.hpp>
 
 
@@ -65,6 +66,12 @@ namespace support3d {
   a derived class in the loadTexData() method. This method either
   loads an image from disk or creates an image procedurally.
 
+  The data can either be passed via texData() or as a TextureImage
+  via setTexImage(). The latter can also be done after loadTexData()
+  has returned (e.g. by a background thread that loads the image).
+  Until the data is available, texturing is disabled for the material
+  (see isReady()).
+
   \see GLMaterial
  */
 class GLTexture
@@ -104,9 +111,15 @@ class GLTexture
   /// Image file name
   string imagename;
 
-  /// OpenGL texture name
+  /// OpenGL texture name (used for data that is passed to texData() directly)
   int texname;
 
+  /// Texture image (may be shared with other textures)
+  boost::shared_ptr<TextureImage> image;
+
+  /// True if texData() has uploaded data into texname
+  bool hasdata;
+
   /// Update flags
   int flags;
 
@@ -127,6 +140,10 @@ class GLTexture
   void releaseGL();
   void texData(int w, int h, int format, int type, char* data);
 
+  boost::shared_ptr<TextureImage> getTexImage() const { return image; }
+  void setTexImage(boost::shared_ptr<TextureImage> aimage);
+  bool isReady() const;
+
   /**
     Provide the texture data.
 
@@ -216,6 +233,10 @@ class GLMaterial : public Material
   virtual void applyGL();
   bool usesBlending();
 
+  void applyColorsGL();
+  void applyTextureGL();
+  void applyBlendingGL();
+
   int getNumTextures() const;
   void setNumTextures(int num);
   boost::shared_ptr<GLTexture> getTexture(int idx=0) const;
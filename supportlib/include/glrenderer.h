@@ -40,12 +40,50 @@
  OpenGL renderer.
  */
 
+#include <vector>
+#include <map>
 #include "mat4.h"
 #include "worldobject.h"
 #include "glmaterial.h"
+#include "glpointlight.h"
+#include "glspotlight.h"
+#include "gldistantlight.h"
 
 namespace support3d {
 
+/**
+  OpenGL renderer.
+
+  The objects of a scene are drawn from a draw list that is compiled
+  from the hierarchy. Every object that has a geom is put into a bucket
+  for its material. The list is only rebuilt when the structure serial
+  of the root changes (i.e. when objects were added or removed or a geom
+  or material was set, see WorldObject::getStructureSerial()).
+
+  Each frame the objects that use opaque materials are drawn bucket by
+  bucket (and front-to-back inside a bucket), then the objects with
+  blended materials are drawn back-to-front by their view depth. The
+  depth of an object is the depth of its origin. The material, texture
+  and blending state is only changed when it differs from the state
+  that is already set. The number of state changes of the last
+  paint() call is available in the stat_* attributes.
+
+  The light sources are collected together with the draw list, so the
+  per-frame light setup only depends on the number of lights. If there
+  are more enabled lights than OpenGL supports, the lights are selected
+  per object. Each object gets the lights that have the largest
+  influence on its bounding sphere (the light intensity weighted by the
+  attenuation at the distance of the sphere; distant lights are not
+  attenuated). Lights that are already bound to an OpenGL light are
+  kept in place, so objects that are close together usually don't
+  cause any light changes.
+
+  Materials other than GLMaterial are applied with the default material
+  as base and their state is restored with glPushAttrib()/glPopAttrib()
+  after their bucket has been drawn. A geom that changes the lighting or
+  texture state in its drawGL() method has to restore it itself (the
+  diffuse color set by the \c Cs variable is the only exception).
+ */
 class GLRenderInstance
 {
   public:
@@ -93,6 +131,103 @@ class GLRenderInstance
   /// Default material
   GLMaterial defaultmat;  
 
+  /// Number of objects drawn during the last paint() call.
+  int stat_objects;
+  /// Number of material color changes during the last paint() call.
+  int stat_material_changes;
+  /// Number of texture changes during the last paint() call.
+  int stat_texture_changes;
+  /// Number of blending state changes during the last paint() call.
+  int stat_blend_changes;
+  /// Number of times a light source was applied during the last paint() call.
+  int stat_light_changes;
+  /// Number of times the draw list has been rebuilt.
+  int stat_drawlist_rebuilds;
+
+  protected:
+  /// A material bucket of the draw list.
+  struct DrawBucket
+  {
+    /// Material (0 for objects without a material).
+    Material* material;
+    /// The material as GLMaterial (0 if it isn't a plain GLMaterial).
+    GLMaterial* glmaterial;
+    /// Does the material use blending (updated every frame)?
+    bool blending;
+  };
+
+  /// An entry of the draw list.
+  struct DrawItem
+  {
+    WorldObject* obj;
+    GeomObject* geom;
+    /// Index of the material bucket.
+    int bucket;
+    /// Transformation relative to the root (updated every frame).
+    mat4d transform;
+    /// View depth of the object origin (updated every frame).
+    double depth;
+  };
+
+  /// Comparison functor used to sort the draw list indices.
+  struct DrawItemOrder
+  {
+    const std::vector<DrawItem>* items;
+    bool blended;
+    bool operator()(int a, int b) const;
+  };
+
+  /// The material buckets.
+  std::vector<DrawBucket> drawbuckets;
+  /// The draw list (in hierarchy order).
+  std::vector<DrawItem> drawitems;
+  /// Indices of the visible opaque items in the order in which they are drawn.
+  std::vector<int> draworder;
+  /// Indices of the visible blended items in the order in which they are drawn.
+  std::vector<int> blendorder;
+
+  /// A light source of the draw list.
+  struct DrawLight
+  {
+    LightSource* light;
+    /// The light as one of the supported types (the other two pointers are 0).
+    GLPointLight* pointlight;
+    GLSpotLight* spotlight;
+    GLDistantLight* distantlight;
+    /// Transformation relative to the root (updated every frame).
+    mat4d transform;
+    /// Influence of the light without attenuation (updated every frame).
+    double strength;
+  };
+
+  /// The supported light sources in the scene.
+  std::vector<DrawLight> drawlights;
+  /// Indices of the lights that are enabled in the current frame.
+  std::vector<int> activelights;
+  /// Number of lights supported by OpenGL.
+  int max_gl_lights;
+  /// Are the lights selected per object?
+  bool per_object_lights;
+  /// Light (index into drawlights) bound to each OpenGL light (-1=none).
+  std::vector<int> boundlights;
+  /// Buffers used during the light selection.
+  std::vector<int> selectedlights;
+  std::vector<double> lightinfluence;
+  /// The root for which the draw list was built.
+  WorldObject* drawlist_root;
+  /// The structure serial of the root when the draw list was built.
+  unsigned long drawlist_serial;
+
+  /// Material whose colors are currently set (0=unknown).
+  GLMaterial* state_colors;
+  /// Currently active texture (only valid if state_texture_valid is true).
+  GLTexture* state_texture;
+  bool state_texture_valid;
+  /// Current blend factors (-1 if blending is disabled).
+  int state_blend_sfactor;
+  int state_blend_dfactor;
+  bool state_blend_valid;
+
   public:
   GLRenderInstance();
   virtual ~GLRenderInstance() {}
@@ -108,8 +243,16 @@ class GLRenderInstance
 
   protected:
   void drawScene(WorldObject& root, const mat4d& viewmat);
-  bool drawNode(WorldObject& node, bool draw_blends);
-  void applyLights(WorldObject& node);
+  void updateDrawList(WorldObject& root);
+  void collectDrawItems(WorldObject& node, std::map<Material*, int>& bucketmap);
+  void drawItems(const std::vector<int>& order);
+  void drawItem(DrawItem& item);
+  void invalidateState();
+  void applyMaterial(GLMaterial& mat);
+  void resetLights();
+  void setupLights(const mat4d& RWinv, bool root_identity);
+  void selectLights(DrawItem& item);
+  void applyLight(DrawLight& lgt, int idx);
   void drawWireCube(double lx, double ly, double lz);
   void drawCoordSystem();
 };
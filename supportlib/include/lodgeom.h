@@ -0,0 +1,97 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef LODGEOM_H
+#define LODGEOM_H
+
+/** \file lodgeom.h
+ Contains the LODGeom class.
+ */
+
+#include <vector>
+#include "geomobject.h"
+
+// Define the CGKIT_SHARED variable
+#ifdef DLL_EXPORT_LODGEOM
+  #include "shared_export.h"
+#else
+  #include "shared.h"
+#endif
+
+namespace support3d {
+
+/**
+  Level of detail geometry.
+
+  This geom holds several versions of a geometry (usually generated with
+  MeshDecimator) and draws the one that matches the size of the object
+  on screen. Each level has a minimum size (in pixels, measured as
+  the projected diameter of the bounding sphere). The first level
+  whose minimum size is not larger than the current screen size is
+  drawn, if there is no such level the last one is used. So the levels
+  should be added from the most detailed to the coarsest one with
+  decreasing minimum sizes.
+ */
+class CGKIT_SHARED LODGeom : public GeomObject
+{
+  protected:
+  /// The levels of detail.
+  std::vector<boost::shared_ptr<GeomObject> > levels;
+  /// Minimum screen size (in pixels) of each level.
+  std::vector<double> minsizes;
+  /// The level that was drawn last (or -1).
+  int currentlevel;
+
+  public:
+  LODGeom();
+
+  virtual BoundingBox boundingBox();
+  virtual void drawGL();
+  virtual void convert(GeomObject* target);
+
+  void addLevel(boost::shared_ptr<GeomObject> geom, double minsize);
+  void clearLevels();
+  int numLevels() const { return int(levels.size()); }
+  boost::shared_ptr<GeomObject> getLevel(int idx) const;
+  double getMinSize(int idx) const;
+  int getCurrentLevel() const { return currentlevel; }
+  int selectLevel(double screensize) const;
+
+  static double screenSize(const BoundingBox& bb, const double* modelview, const double* projection, int viewportheight);
+};
+
+}  // end of namespace
+
+#endif
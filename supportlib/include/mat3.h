@@ -1405,6 +1405,29 @@ mat3<T> mat3<T>::ortho() const
   return ortho(res);
 }
 
+/**
+  Check if three vectors are mutually orthogonal.
+
+  The vectors must not be (almost) zero and the cosine of the angle
+  between any two of them must not be larger than vec3<T>::epsilon.
+  This is used by the decompose() methods to skip the orthogonalization
+  for the common case of a rotation matrix times a scaling.
+ */
+template<class T> 
+inline bool orthogonalVectors(const vec3<T>& a, const vec3<T>& b, const vec3<T>& c)
+{
+  T eps2 = vec3<T>::epsilon*vec3<T>::epsilon;
+  T aa = a*a;
+  T bb = b*b;
+  T cc = c*c;
+  if (aa<=eps2 || bb<=eps2 || cc<=eps2)
+    return false;
+  T ab = a*b;
+  T ac = a*c;
+  T bc = b*c;
+  return (ab*ab<=eps2*aa*bb) && (ac*ac<=eps2*aa*cc) && (bc*bc<=eps2*bb*cc);
+}
+
 /*---------------------------------decompose-----------------------------*//**
   Decompose the matrix intro a rotation and scaling part.
 
@@ -1420,10 +1443,18 @@ void mat3<T>::decompose(mat3<T>& rot, vec3<T>& scale) const
   vec3<T> a,b,c;
   T al, bl, cl;
 
-  ortho(rot);
-  rot.getColumn(0, a);
-  rot.getColumn(1, b);
-  rot.getColumn(2, c);
+  getColumn(0, a);
+  getColumn(1, b);
+  getColumn(2, c);
+  // Orthogonalize the base vectors (unless they already are orthogonal)
+  if (!orthogonalVectors(a, b, c))
+  {
+    mat3<T> o;
+    ortho(o);
+    o.getColumn(0, a);
+    o.getColumn(1, b);
+    o.getColumn(2, c);
+  }
   // al,bl,cl will be the scaling factors
 
   al = a.length();
@@ -1439,14 +1470,14 @@ void mat3<T>::decompose(mat3<T>& rot, vec3<T>& scale) const
   b /= bl;
   c /= cl;
 
-  rot.setColumn(0, a);
-  rot.setColumn(1, b);
-  rot.setColumn(2, c);
-  if (rot.determinant()<0)
+  if (a*(b^c)<0)
   {
-    rot.setColumn(0, -a);
+    a = -a;
     scale.x = -scale.x;
   }
+  rot.setColumn(0, a);
+  rot.setColumn(1, b);
+  rot.setColumn(2, c);
 }
 
 /**
@@ -1989,19 +1989,20 @@ void mat4<T>::decompose(vec3<T>& t, mat4<T>& rot, vec3<T>& scale) const
   vec3<T> a,b,c;
   T al, bl, cl;
 
-  ortho(rot);
-  rot.m14 = 0;
-  rot.m24 = 0;
-  rot.m34 = 0;
-  rot.m44 = 1;
-  rot.m41 = 0;
-  rot.m42 = 0;
-  rot.m43 = 0;
-
   // a,b,c = Column 0,1,2 of m
-  a.set(rot.m11, rot.m21, rot.m31);
-  b.set(rot.m12, rot.m22, rot.m32);
-  c.set(rot.m13, rot.m23, rot.m33);
+  a.set(m11, m21, m31);
+  b.set(m12, m22, m32);
+  c.set(m13, m23, m33);
+  // Orthogonalize the base vectors (unless they already are orthogonal)
+  if (!orthogonalVectors(a, b, c))
+  {
+    mat4<T> o;
+    ortho(o);
+    a.set(o.m11, o.m21, o.m31);
+    b.set(o.m12, o.m22, o.m32);
+    c.set(o.m13, o.m23, o.m33);
+  }
+  t.set(m14, m24, m34);
 
   // al,bl,cl will be the scaling factors
   al = a.length();
@@ -2017,18 +2018,21 @@ void mat4<T>::decompose(vec3<T>& t, mat4<T>& rot, vec3<T>& scale) const
   b /= bl;
   c /= cl;
 
-  a.get(rot.m11, rot.m21, rot.m31);
-  b.get(rot.m12, rot.m22, rot.m32);
-  c.get(rot.m13, rot.m23, rot.m33);
-  if (rot.determinant()<0)
+  if (a*(b^c)<0)
   {
-    rot.m11 = -rot.m11;
-    rot.m21 = -rot.m21;
-    rot.m31 = -rot.m31;
+    a = -a;
     scale.x = -scale.x;
   }
-
-  t.set(m14, m24, m34);
+  a.get(rot.m11, rot.m21, rot.m31);
+  b.get(rot.m12, rot.m22, rot.m32);
+  c.get(rot.m13, rot.m23, rot.m33);
+  rot.m14 = 0;
+  rot.m24 = 0;
+  rot.m34 = 0;
+  rot.m44 = 1;
+  rot.m41 = 0;
+  rot.m42 = 0;
+  rot.m43 = 0;
 }
 
 
@@ -0,0 +1,167 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef MEMORYPOOL_H
+#define MEMORYPOOL_H
+
+/** \file memorypool.h
+ Contains the MemoryPool and SizeClassPools classes.
+ */
+
+#include <cstddef>
+#include <vector>
+
+namespace support3d {
+
+/**
+  Allocator for memory chunks of a fixed size.
+
+  The chunks are carved out of larger blocks and freed chunks are kept
+  in a free list, so allocating and freeing a chunk is just a pointer
+  operation. The blocks are only returned to the system by release()
+  (when no chunk is in use anymore). This is used for the class
+  specific operator new/delete of objects that are created in large
+  numbers (slot descriptors and world objects), so building and tearing
+  down a large scene doesn't have to go through the general purpose
+  heap for every object.
+
+  The pool is not thread-safe. Just like the slots themselves, the
+  objects that are allocated from a pool may only be created and
+  deleted by one thread at a time.
+ */
+class MemoryPool
+{
+  protected:
+  /// Chunk size in bytes (a multiple of the alignment)
+  size_t chunksize;
+  /// Number of chunks per block
+  size_t chunksperblock;
+  /// First free chunk (each free chunk stores a pointer to the next one)
+  void* freelist;
+  /// Allocated blocks
+  std::vector<char*> blocks;
+  /// Number of chunks that are currently in use
+  size_t numallocated;
+
+  public:
+  MemoryPool(size_t achunksize, size_t achunksperblock=256);
+  ~MemoryPool();
+
+  /**
+    Allocate a chunk.
+
+    A std::bad_alloc exception is thrown if no new block can be allocated.
+   */
+  void* allocate()
+  {
+    if (freelist==0)
+      allocateBlock();
+    void* res = freelist;
+    freelist = *(void**)res;
+    numallocated++;
+    return res;
+  }
+
+  /**
+    Return a chunk to the pool.
+
+    \param p A chunk that was allocated by this pool (or 0).
+   */
+  void deallocate(void* p)
+  {
+    if (p==0)
+      return;
+    *(void**)p = freelist;
+    freelist = p;
+    numallocated--;
+  }
+
+  /// Return the chunk size in bytes.
+  size_t getChunkSize() const { return chunksize; }
+  /// Return the number of chunks that are currently in use.
+  size_t getNumAllocated() const { return numallocated; }
+  /// Return the number of bytes that were allocated from the system.
+  size_t getReservedBytes() const { return blocks.size()*chunksperblock*chunksize; }
+
+  bool release();
+
+  protected:
+  void allocateBlock();
+
+  private:
+  MemoryPool(const MemoryPool&);
+  MemoryPool& operator=(const MemoryPool&);
+};
+
+/**
+  A set of memory pools for objects of different sizes.
+
+  This is used for the operator new/delete of a base class whose derived
+  classes have different sizes. Every size gets its own pool. Requests
+  that are larger than the maximum size are passed on to the global
+  operator new/delete.
+ */
+class SizeClassPools
+{
+  protected:
+  /// The pools (one per chunk size)
+  std::vector<MemoryPool*> pools;
+  /// Maximum object size that is served by the pools
+  size_t maxsize;
+  /// Number of chunks per block for new pools
+  size_t chunksperblock;
+
+  public:
+  SizeClassPools(size_t amaxsize, size_t achunksperblock=64);
+  ~SizeClassPools();
+
+  void* allocate(size_t size);
+  void deallocate(void* p, size_t size);
+
+  size_t getNumAllocated() const;
+  size_t getReservedBytes() const;
+  void release();
+
+  protected:
+  MemoryPool* findPool(size_t size);
+
+  private:
+  SizeClassPools(const SizeClassPools&);
+  SizeClassPools& operator=(const SizeClassPools&);
+};
+
+}  // end of namespace
+
+#endif
@@ -0,0 +1,110 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef MESHCLEANUP_H
+#define MESHCLEANUP_H
+
+/** \file meshcleanup.h
+ Contains the MeshCleanup class.
+ */
+
+#include <vector>
+#include "geomobject.h"
+
+namespace support3d {
+
+class TriMeshGeom;
+
+/**
+  Cleans up the topology of a triangle mesh.
+
+  The class implements the individual stages of a mesh cleanup pipeline
+  that operate on a TriMeshGeom in place:
+
+  - weldVertices(): Merge vertices that lie within a distance eps
+  - removeDegenerateFaces(): Remove faces with repeated vertices or zero area
+  - removeDuplicateFaces(): Remove faces that use the same vertices as a previous face
+  - removeUnusedVerts(): Remove vertices that aren't referenced by any face
+
+  run() executes all stages in the above order. Each stage returns the
+  number of vertices or faces it has merged or removed.
+
+  Additionally, the mesh can be reordered to improve the memory locality:
+
+  - optimizeVertexCache(): Reorder the faces for a post-transform vertex cache
+  - reorderVertices(): Sort the vertices by their first use in the faces
+
+  All primitive variables are kept consistent with the modified mesh.
+  Uniform and facevarying/facevertex variables are compacted along
+  with the faces, varying/vertex variables along with the vertices.
+  When vertices get welded the values of the first vertex are kept, so
+  by default vertices are only welded if their varying and vertex
+  variables match as well (this keeps seams in texture coordinates or
+  normals intact).
+
+  Vertex welding uses a spatial hash with a cell size of eps (only
+  representative vertices are stored in the hash), so all stages
+  run in (expected) linear time except removeDuplicateFaces() which
+  sorts the faces.
+ */
+class MeshCleanup
+{
+  public:
+  MeshCleanup(TriMeshGeom& amesh);
+
+  int weldVertices(double eps=0.0, bool comparevars=true);
+  int removeDegenerateFaces();
+  int removeDuplicateFaces();
+  int removeUnusedVerts();
+  int run(double eps=0.0, bool comparevars=true);
+
+  void optimizeVertexCache(int cachesize=32);
+  void reorderVertices();
+
+  void setFaces(const std::vector<int>& facedata);
+  static bool valuesEqual(const PrimVarInfo& var, int i, int j, double eps=0.0);
+
+  protected:
+  bool varsEqual(const std::vector<PrimVarInfo*>& vars, int i, int j, double eps) const;
+  void collectVariables(VarStorage s1, VarStorage s2, std::vector<PrimVarInfo*>& res) const;
+  void applyFaceSelection(const std::vector<int>& keepfaces);
+
+  /// The mesh that gets modified.
+  TriMeshGeom& mesh;
+};
+
+}  // end of namespace
+
+#endif
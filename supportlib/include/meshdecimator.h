@@ -0,0 +1,167 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef MESHDECIMATOR_H
+#define MESHDECIMATOR_H
+
+/** \file meshdecimator.h
+ Contains the MeshDecimator class.
+ */
+
+#include <vector>
+#include <queue>
+#include "vec3.h"
+
+namespace support3d {
+
+class TriMeshGeom;
+
+/**
+  Simplifies a triangle mesh using quadric error metrics.
+
+  The decimator repeatedly collapses the edge with the smallest quadric
+  error (Garland/Heckbert) until a target face count or an error bound
+  is reached. An edge is always collapsed into one of its end points
+  (half-edge collapse), so the vertices of the result are a subset of
+  the original vertices and all primitive variables can simply be
+  copied from the source mesh (no values have to be interpolated).
+
+  The following features are preserved:
+
+  - Boundaries: Boundary vertices may only move along the boundary and
+    an additional quadric keeps the boundary in place.
+  - Seams of varying/vertex variables (i.e. vertices that were split
+    because they have different texture coordinates, normals, colors,
+    etc. at the same position) are locked.
+  - Vertices where a facevarying or facevertex variable is discontinuous
+    (e.g. creases in a facevarying "N" variable) are locked.
+
+  Collapses that would flip a face, create a degenerate face or
+  violate the link condition (i.e. change the topology) are rejected.
+  Note that unwelded meshes (triangle soups) cannot be simplified because
+  every vertex is a seam vertex, so they should be welded first (see
+  MeshCleanup).
+
+  The source mesh is not modified, the result is written into a separate
+  TriMeshGeom. decimateLODs() produces an entire chain of levels of
+  detail in one single pass.
+
+  Usage:
+
+  \code
+  MeshDecimator dec(mesh);
+  dec.decimate(lowres, 1000);
+  \endcode
+ */
+class MeshDecimator
+{
+  public:
+  MeshDecimator(TriMeshGeom& asource);
+
+  int decimate(TriMeshGeom& target, int targetfaces, double maxerror=-1.0);
+  void decimateLODs(const std::vector<TriMeshGeom*>& targets, const std::vector<int>& facecounts, double maxerror=-1.0);
+
+  /// Return the largest error of all collapses done so far.
+  double getError() const { return error; }
+  /// Return the current number of faces.
+  int getNumFaces() const { return numalive; }
+
+  protected:
+  /// Symmetric 4x4 error quadric (upper triangle).
+  struct Quadric
+  {
+    double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+    Quadric() : a2(0), ab(0), ac(0), ad(0), b2(0), bc(0), bd(0), c2(0), cd(0), d2(0) {}
+    void addPlane(const vec3d& n, double d, double w);
+    void add(const Quadric& q);
+    double eval(const vec3d& p) const;
+  };
+
+  /// Candidate edge collapse.
+  struct Collapse
+  {
+    double cost;
+    int from;
+    int to;
+    int fromversion;
+    int toversion;
+
+    // The priority queue returns the collapse with the smallest cost first
+    bool operator<(const Collapse& c) const { return cost>c.cost; }
+  };
+
+  // Vertex flags
+  enum { BORDER=1, LOCKED=2, DEAD=4 };
+
+  void init();
+  void initQuadrics();
+  void classifyVertices();
+  void run(int targetfaces, double maxerror);
+  void neighbors(int v, std::vector<int>& res);
+  void pushCollapse(int from, int to);
+  bool isValidCollapse(int from, int to);
+  void collapse(int from, int to);
+  void writeMesh(TriMeshGeom& target);
+
+  /// Source mesh.
+  TriMeshGeom& source;
+  /// Copy of the source vertices.
+  std::vector<vec3d> verts;
+  /// Current faces (3 vertex indices per face).
+  std::vector<int> faces;
+  /// Flags whether a face is still alive.
+  std::vector<bool> facealive;
+  /// Number of alive faces.
+  int numalive;
+  /// Unit normals of the original faces.
+  std::vector<vec3d> facenormals;
+  /// Faces around each vertex (may contain dead faces).
+  std::vector<std::vector<int> > vertfaces;
+  std::vector<Quadric> quadrics;
+  std::vector<int> vertflags;
+  /// Version counter per vertex (invalidates queued collapses).
+  std::vector<int> versions;
+  /// Stamps used by neighbors() and isValidCollapse().
+  std::vector<int> marks;
+  int stamp;
+  std::priority_queue<Collapse> queue;
+  /// Largest error so far.
+  double error;
+};
+
+}  // end of namespace
+
+#endif
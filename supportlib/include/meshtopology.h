@@ -0,0 +1,140 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef MESHTOPOLOGY_H
+#define MESHTOPOLOGY_H
+
+/** \file meshtopology.h
+ Contains the MeshTopology class.
+ */
+
+#include <vector>
+
+namespace support3d {
+
+/**
+  Half-edge connectivity of a polygon mesh.
+
+  The topology is stored in flat int arrays. Each face consists of one
+  or more vertex loops (the first loop is the outer boundary, the
+  remaining loops are holes) and every corner of a loop is a half-edge
+  that starts at the corner vertex and ends at the next vertex of the
+  loop. The half-edges are numbered in the order of the corners, so for
+  a triangle mesh half-edge 3*f+k is corner k of face f (which is also
+  the index into a facevarying variable).
+
+  For each half-edge the following information is available:
+
+  - origin(): The start vertex
+  - target(): The end vertex
+  - next()/prev(): The next/previous half-edge of the same loop
+  - twin(): The opposite half-edge of the neighboring face (or -1 if
+    the edge is a boundary edge or if it is non-manifold)
+  - face(): The face the half-edge belongs to
+
+  Additionally, the outgoing half-edges of each vertex are stored
+  (vertex/half-edge incidence table in CSR layout).
+
+  The structure is built in linear time. The twin search is done in
+  parallel when the library is compiled with OpenMP support.
+  TriMeshGeom and PolyhedronGeom keep a cached instance that is rebuilt
+  lazily when their faces change (see TriMeshGeom::getTopology()).
+ */
+class MeshTopology
+{
+  protected:
+  int numverts;
+  int numfaces;
+  /// Origin vertex of each half-edge.
+  std::vector<int> heorigin;
+  std::vector<int> henext;
+  std::vector<int> heprev;
+  std::vector<int> hetwin;
+  std::vector<int> heface;
+  /// First half-edge of each face (first corner of the outer loop).
+  std::vector<int> facehalfedge;
+  /** Outgoing half-edges of each vertex (CSR layout).
+
+    The outgoing half-edges of vertex i are stored in
+    vertout[vertoffsets[i]] ... vertout[vertoffsets[i+1]-1].
+   */
+  std::vector<int> vertoffsets;
+  std::vector<int> vertout;
+
+  public:
+  MeshTopology();
+
+  void buildTriangles(const int* faces, int anumfaces, int anumverts);
+  void buildLoops(const std::vector<int>& loopoffsets, const std::vector<int>& loopverts, const std::vector<int>& loopfaces, int anumfaces, int anumverts);
+  void clear();
+
+  int getNumVerts() const { return numverts; }
+  int getNumFaces() const { return numfaces; }
+  int getNumHalfEdges() const { return int(heorigin.size()); }
+  int getNumEdges() const;
+
+  /// Return the start vertex of a half-edge.
+  int origin(int he) const { return heorigin[he]; }
+  /// Return the end vertex of a half-edge.
+  int target(int he) const { return heorigin[henext[he]]; }
+  /// Return the next half-edge of the same loop.
+  int next(int he) const { return henext[he]; }
+  /// Return the previous half-edge of the same loop.
+  int prev(int he) const { return heprev[he]; }
+  /// Return the opposite half-edge (or -1).
+  int twin(int he) const { return hetwin[he]; }
+  /// Return the face of a half-edge.
+  int face(int he) const { return heface[he]; }
+  /// Return the first half-edge of a face.
+  int faceHalfEdge(int f) const { return facehalfedge[f]; }
+  /// Return the number of outgoing half-edges of a vertex.
+  int numOutgoing(int v) const { return vertoffsets[v+1]-vertoffsets[v]; }
+  /// Return an outgoing half-edge of a vertex.
+  int outgoing(int v, int i) const { return vertout[vertoffsets[v]+i]; }
+
+  bool isBoundaryVertex(int v) const;
+  void vertexRing(int v, std::vector<int>& res) const;
+  void vertexFaces(int v, std::vector<int>& res) const;
+  void faceNeighbors(int f, std::vector<int>& res) const;
+  void boundaryLoops(std::vector<std::vector<int> >& res) const;
+
+  protected:
+  void build(int numhalfedges);
+  int boundaryStart(int v) const;
+};
+
+}  // end of namespace
+
+#endif
@@ -0,0 +1,213 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef MOCAPPARSER_H
+#define MOCAPPARSER_H
+
+/** \file mocapparser.h
+ Contains the MotionData, BVHParser and AMCParser classes.
+ */
+
+#include <string>
+#include <vector>
+#include "vec3.h"
+#include "animcurve.h"
+
+namespace support3d {
+
+using std::string;
+
+class MocapTokenizer;
+
+/**
+  Motion samples of a motion capture file.
+
+  The samples are stored per channel, i.e. all values of one channel
+  are stored contiguously in memory (numFrames() values per channel).
+  Consecutive channels are grouped into tracks where a track holds the
+  channels of one joint (BVH) or bone (AMC).
+
+  The samples are equally spaced in time. The frame time is taken from
+  the file if the format stores it (BVH), otherwise it is 0.
+ */
+class MotionData
+{
+  protected:
+  /// Track information.
+  struct Track
+  {
+    string name;
+    /// Index of the first channel.
+    int channel;
+    /// Number of channels.
+    int size;
+  };
+
+  /// Tracks.
+  std::vector<Track> tracks;
+  /// Total number of channels.
+  int numchannels;
+  /// Number of frames.
+  int numframes;
+  /// Time between two frames.
+  double frametime;
+  /// Samples (numframes values per channel).
+  std::vector<double> values;
+
+  public:
+  MotionData();
+
+  void clear();
+
+  int addTrack(const string& name, int size);
+  /// Return the number of tracks.
+  int numTracks() const { return int(tracks.size()); }
+  int findTrack(const string& name) const;
+  const string& getTrackName(int idx) const;
+  int getTrackChannel(int idx) const;
+  int getTrackSize(int idx) const;
+
+  /// Return the total number of channels.
+  int numChannels() const { return numchannels; }
+  /// Return the number of frames.
+  int numFrames() const { return numframes; }
+  void setNumFrames(int n);
+  /// Return the time between two frames.
+  double getFrameTime() const { return frametime; }
+  /// Set the time between two frames.
+  void setFrameTime(double dt) { frametime = dt; }
+
+  /// Return the samples of a channel (the index is not checked).
+  double* channel(int idx) { return &values[idx*numframes]; }
+  /// Return the samples of a channel (the index is not checked).
+  const double* channel(int idx) const { return &values[idx*numframes]; }
+  double getValue(int channel, int frame) const;
+  void setValue(int channel, int frame, double v);
+  void getFrame(int frame, double* res) const;
+
+  void setCurveKeys(int channel, AnimCurve& curve, double t0, double dt,
+                    double scale=1.0, AnimCurve::Interpolation ip=AnimCurve::LINEAR) const;
+  void setQuatCurveKeys(const int* channels, const string& order, QuatAnimCurve& curve,
+                        double t0, double dt, double scale=1.0,
+                        AnimCurve::Interpolation ip=AnimCurve::LINEAR) const;
+
+  protected:
+  void checkChannel(int idx) const;
+  void checkTrack(int idx) const;
+};
+
+/**
+  Reads BioVision Hierarchical (BVH) files.
+
+  The joints of the skeleton are stored in depth-first order (so a
+  parent always precedes its children) and the motion samples are
+  stored in a MotionData object that contains one track per joint
+  that has channels. The channels of a track are in the order in which
+  they appear in the CHANNELS statement of the joint.
+
+  The frame lines are located in a first pass over the file and then
+  parsed in parallel (when the library is compiled with OpenMP support).
+
+  Syntax errors are reported via an ESyntaxError exception.
+ */
+class BVHParser
+{
+  public:
+  /// Joint information.
+  struct Joint
+  {
+    /// Joint name ("End Site" for end sites).
+    string name;
+    /// Index of the parent joint (-1 for the root).
+    int parent;
+    /// Offset of the joint relative to its parent.
+    vec3d offset;
+    /// Channel names ("Xposition", ..., "Zrotation").
+    std::vector<string> channels;
+    /// Track index in the motion data (-1 if the joint has no channels).
+    int track;
+    /// True if the joint is an end site.
+    bool endsite;
+  };
+
+  /// Skeleton joints.
+  std::vector<Joint> joints;
+  /// Motion samples.
+  MotionData motion;
+  /// True if the file contained a MOTION section.
+  bool hasmotion;
+
+  public:
+  BVHParser();
+
+  void clear();
+  void read(const string& filename);
+  void parse(const char* text, int size);
+
+  protected:
+  void readJoint(MocapTokenizer& tok, int parent);
+};
+
+/**
+  Reads Acclaim Motion Capture (AMC) files.
+
+  The motion samples are stored in a MotionData object that contains
+  one track per bone. The tracks are in the order in which they appear
+  in the first frame and every frame must contain the same bones with
+  the same number of values (the order may vary). The meaning of the
+  values is defined by the "dof" entries of the corresponding ASF file.
+
+  Like the BVHParser, the frames are located in a first pass and then
+  parsed in parallel.
+ */
+class AMCParser
+{
+  public:
+  /// Motion samples.
+  MotionData motion;
+  /// The frame numbers from the file.
+  std::vector<int> framenumbers;
+
+  public:
+  AMCParser();
+
+  void clear();
+  void read(const string& filename);
+  void parse(const char* text, int size);
+};
+
+}  // end of namespace
+
+#endif
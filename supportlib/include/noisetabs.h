@@ -57,7 +57,7 @@ static unsigned char perm[256] = {
    176,  41,  57, 252, 119,  43,   2, 159, 237, 226, 204,   7, 156, 109, 
    213, 180, 191,  95 };
 
-static double uniform[256] = {
+static const double uniform[256] = {
    0.21715864926591522, 0.88494591885164553, 0.8422102044892319, 
    0.76061694491848586, 0.82502952148253805, 0.11135672005140451, 
    0.035584121845477767, 0.42905170691075289, 0.64771494138346597, 
@@ -0,0 +1,135 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef NORMALGENERATOR_H
+#define NORMALGENERATOR_H
+
+/** \file normalgenerator.h
+ Contains the NormalGenerator class.
+ */
+
+#include <vector>
+#include "vec3.h"
+
+namespace support3d {
+
+/**
+  Computes smooth vertex normals or creased corner normals for a triangle mesh.
+
+  The class operates on raw vertex and face arrays (3 vertex indices per
+  face), so it doesn't depend on any particular geom class. It's used by
+  TriMeshGeom::computeNormals().
+
+  Usage: Call setTopology() whenever the faces (or the number of vertices)
+  have changed. This builds the vertex/face incidence table that is
+  required by all subsequent calls. Then call either vertexNormals()
+  (one normal per vertex) or cornerNormals() (one normal per face corner,
+  suitable for a facevarying variable) to compute all normals. If only
+  some vertices have been moved afterwards, updateVertexNormals() or
+  updateCornerNormals() only recompute the normals that are influenced by
+  those vertices.
+
+  A face contributes its normal to a vertex weighted either by its area
+  or by the angle of the face at that vertex. Degenerate faces have a
+  zero normal and don't contribute anything. If a vertex (or corner)
+  only has degenerate faces attached, its normal is (0,0,0).
+
+  All loops either iterate over faces or over vertices and only write
+  to the item they are processing (the vertex normals are gathered
+  from the incidence table instead of being scattered from the faces),
+  so they are run in parallel when the library is compiled with OpenMP
+  support.
+ */
+class NormalGenerator
+{
+  public:
+  /// Determines how a face normal is weighted when accumulated at a vertex.
+  enum Weighting { AREA_WEIGHTED, ANGLE_WEIGHTED };
+
+  /// Weighting mode.
+  Weighting weighting;
+
+  protected:
+  /// Number of faces.
+  int numfaces;
+  /// Number of vertices.
+  int numverts;
+  /// Face vertex indices (3 per face, not owned by this class).
+  const int* faces;
+
+  /** Vertex/face incidence table (CSR layout).
+
+    The corners around vertex i are stored in vertcorners[vertoffsets[i]]
+    ... vertcorners[vertoffsets[i+1]-1]. A corner is encoded as 3*face+k
+    where k is 0, 1 or 2.
+   */
+  std::vector<int> vertoffsets;
+  std::vector<int> vertcorners;
+
+  /// Unit face normals (or (0,0,0) for degenerate faces).
+  std::vector<vec3d> facenormals;
+  /// Face areas.
+  std::vector<double> faceareas;
+  /// Interior angles of the face corners (3 per face).
+  std::vector<double> cornerangles;
+
+  /// Stamps used to mark faces/vertices during an incremental update.
+  std::vector<int> facestamps;
+  std::vector<int> vertstamps;
+  int stamp;
+
+  public:
+  NormalGenerator();
+
+  void setTopology(const int* afaces, int anumfaces, int anumverts);
+  int getNumFaces() const { return numfaces; }
+  int getNumVerts() const { return numverts; }
+
+  void vertexNormals(const vec3d* verts, vec3d* N);
+  void cornerNormals(const vec3d* verts, double creaseangle, vec3d* N);
+  void updateVertexNormals(const vec3d* verts, int vstart, int vend, vec3d* N);
+  void updateCornerNormals(const vec3d* verts, int vstart, int vend, double creaseangle, vec3d* N);
+
+  protected:
+  void computeFaceData(const vec3d* verts, int face);
+  void computeVertexNormal(int vert, vec3d& N) const;
+  void computeCornerNormal(int corner, double mincos, vec3d& N) const;
+  double cornerWeight(int corner) const;
+  int markAffectedFaces(int vstart, int vend, std::vector<int>& affected);
+};
+
+}  // end of namespace
+
+#endif
@@ -41,6 +41,7 @@
  */
 
 #include "geomobject.h"
+#include "tessellationcache.h"
 
 namespace support3d {
 
@@ -63,11 +64,20 @@ class PlaneGeom : public GeomObject
   /// Number of segments in y
   Slot<int> segmentsy;
 
+  /// Forwards changes of the parameter slots to onParamChanged().
+  NotificationForwarder<PlaneGeom> _on_param_event;
+
+  protected:
+  /// Cached OpenGL tessellation (invalidated when a parameter changes).
+  TessellationCache tesscache;
+
   public:
   PlaneGeom(double alx=1.0, double aly=1.0, int segsx=1, int segsy=1);
+  ~PlaneGeom();
   
   virtual BoundingBox boundingBox();
   virtual void drawGL();
+  void onParamChanged();
 
   boost::shared_ptr<SizeConstraintBase> slotSizeConstraint(VarStorage storage) const;
 
@@ -48,6 +48,7 @@
 #include "proceduralslot.h"
 #include "vec3.h"
 #include "boundingbox.h"
+#include "meshtopology.h"
 
 #include "opengl.h"
 
@@ -142,6 +143,11 @@ class PolyhedronGeom : public GeomObject
   /// True if bb_cache is still valid, otherwise it has to be recomputed.
   bool bb_cache_valid;
 
+  /// Cached half-edge connectivity (see getTopology()).
+  MeshTopology topology_cache;
+  /// True if topology_cache is still valid, otherwise it has to be rebuilt.
+  bool topology_valid;
+
   private:
   /// Tesselator object (used by \em every PolyhedronGeom).
   static GLUtesselator* tess;
@@ -178,6 +184,9 @@ class PolyhedronGeom : public GeomObject
   LoopIterator loopBegin(int poly, int loop);
   LoopIterator loopEnd(int poly, int loop);
 
+  const MeshTopology& getTopology();
+  void invalidateTopology() { topology_valid = false; }
+
 
   void onVertsChanged(int start, int end);
   void onVertsResize(int size);
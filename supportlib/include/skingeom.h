@@ -0,0 +1,161 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef SKINGEOM_H
+#define SKINGEOM_H
+
+/** \file skingeom.h
+ Contains the SkinGeom class.
+ */
+
+#include <vector>
+#include "trimeshgeom.h"
+#include "mat4.h"
+
+namespace support3d {
+
+/**
+  A triangle mesh that is a bind mesh deformed by a skeleton.
+
+  The bind mesh is a TriMeshGeom in its bind pose that carries two
+  varying (or vertex) primitive variables with the same multiplicity:
+  an int variable with the joint indices and a float variable with the
+  corresponding weights of each vertex. The weights of a vertex are
+  normalized when the mesh is built, a vertex without any weight keeps
+  its bind position.
+
+  Every joint is represented by an input slot "joint<i>" that receives
+  the current world transform of the joint (usually it is connected to
+  the worldtransform slot of a Joint). The skinning matrix of a joint is
+  the current transform multiplied by the inverse of the bind transform
+  that was passed to addJoint(). Both are world space transforms, so the
+  object that holds the geom should have an identity transform.
+
+  The vertices are either deformed by linear blend skinning or by dual
+  quaternion skinning (which ignores any scaling in the joint transforms
+  but avoids the collapsing joints of the linear blend). If the bind
+  mesh has a varying/vertex or facevarying/facevertex "N" variable,
+  the normals are deformed as well.
+
+  The geom only marks itself as invalid when a joint transform changes.
+  The mesh is actually recomputed by update() which is called by
+  boundingBox() and drawGL() (and once per frame by the Python wrapper).
+  When the topology or the primitive variables of the bind mesh have
+  been modified, rebuild() has to be called.
+ */
+class SkinGeom : public TriMeshGeom
+{
+  public:
+  /// Skinning method.
+  enum Mode { LINEAR_BLEND, DUAL_QUATERNION };
+
+  NotificationForwarder<SkinGeom> _on_joint_event;
+  NotificationForwarder<SkinGeom> _on_bind_verts_event;
+
+  protected:
+  /// The bind mesh (may be 0).
+  boost::shared_ptr<TriMeshGeom> bindmesh;
+  /// Name of the joint index variable.
+  std::string indexvar;
+  /// Name of the joint weight variable.
+  std::string weightvar;
+  /// Skinning method.
+  Mode mode;
+
+  /// Joint input slots (owned by the component).
+  std::vector<Slot<mat4d>*> joints;
+  /// Inverse bind transforms of the joints.
+  std::vector<mat4d> invbind;
+
+  /// Number of influences per vertex.
+  int numinfluences;
+  /// Joint indices (numinfluences per vertex).
+  std::vector<int> infjoints;
+  /// Normalized weights (numinfluences per vertex).
+  std::vector<double> infweights;
+  /// Largest joint index that is referenced by a vertex (-1 if there are none).
+  int maxjoint;
+  /// Bind positions.
+  std::vector<vec3d> bindverts;
+  /// Bind normals (either one per vertex or one per face corner).
+  std::vector<vec3d> bindnormals;
+  /// True if the bind normals are stored per face corner.
+  bool cornernormals;
+  /// The "N" slot that was created by rebuild() (or 0).
+  ArraySlot<vec3d>* skinnormals;
+  /// Blended transform of every vertex (3x4 row-major matrix per vertex).
+  std::vector<double> vertxforms;
+
+  /// True if the vertices have to be recomputed.
+  bool dirty;
+
+  public:
+  SkinGeom();
+  virtual ~SkinGeom();
+
+  virtual BoundingBox boundingBox();
+  virtual void drawGL();
+  virtual void deleteVariable(string name);
+
+  void setBindMesh(boost::shared_ptr<TriMeshGeom> amesh, const std::string& aindexvar="jointindices", const std::string& aweightvar="jointweights");
+  boost::shared_ptr<TriMeshGeom> getBindMesh() const { return bindmesh; }
+  std::string getIndexVar() const { return indexvar; }
+  std::string getWeightVar() const { return weightvar; }
+  Mode getMode() const { return mode; }
+  void setMode(Mode amode);
+
+  int addJoint(const mat4d& bindtransform);
+  int numJoints() const { return int(joints.size()); }
+  Slot<mat4d>& jointSlot(int idx);
+  mat4d getBindTransform(int idx) const;
+  void clearJoints();
+
+  int getNumInfluences() const { return numinfluences; }
+  bool isDirty() const { return dirty; }
+  void rebuild();
+  bool update();
+
+  void onJointChanged();
+  void onBindVertsChanged(int start, int end);
+  void onBindVertsResize(int size);
+
+  protected:
+  void blendLinear(const double* skinmats);
+  void blendDualQuat(const double* dqs);
+};
+
+}  // end of namespace
+
+#endif
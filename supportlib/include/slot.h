@@ -51,8 +51,11 @@
 #include "compile_switches.h"
 #include "common_exceptions.h"
 #include "debuginfo.h"
+#include "slotprofiler.h"
+#include "tracing.h"
 
 #include "dependent.h"
+#include "dependentlist.h"
 
 
 // Define the CGKIT_SHARED variable
@@ -112,6 +115,13 @@ class CGKIT_SHARED ISlot : public Dependent
   public:
   static long _slot_counter;
 
+#ifdef CGKIT_SLOT_PROFILING
+  /// Profiling counters (allocated on first use)
+  SlotStats* _profstats;
+  /// The component that contains this slot (may be 0)
+  const Component* _profowner;
+#endif
+
   public:
   ISlot();
   virtual ~ISlot();
@@ -231,6 +241,13 @@ class CGKIT_SHARED ISlot : public Dependent
    */
   virtual void notifyDependents() = 0;
 
+  /**
+    Return the number of dependent objects.
+
+    \return Number of objects that get notified when the value changes.
+   */
+  virtual int numDependents() const { return 0; }
+
 
   /**
     Helper method for extracting the value of a slot.
@@ -370,7 +387,7 @@ class CGKIT_SHARED Slot : public ISlot
 {
   protected:
   /// Dependent objects (each object usually represents another slot).
-  std::vector<Dependent*> dependents;
+  DependentList dependents;
 
   public:
   /// Controlling slot
@@ -411,6 +428,7 @@ class CGKIT_SHARED Slot : public ISlot
   virtual void onResize(int newsize);
   virtual void onControllerDeleted() { setController(0); };
   void notifyDependents();
+  virtual int numDependents() const { return int(dependents.size()); }
   
   protected:
   /**
@@ -573,7 +591,7 @@ template<class T>
 Slot<T>::Slot(int aflags)
   : dependents(), controller(0), flags(aflags), value(T())
 {
-  DEBUGINFO2(this, "Slot<T>::Slot(aflags=%d)  (%s)", aflags, typeid(T).name());
+  TRACE_INSTANT("slot", "Slot::Slot", this, aflags);
   
   // Set the CACHE_VALID flag to the inverted state ot the NO_INPUT_CONNECTIONS flag
   setFlags(CACHE_VALID, !(flags & NO_INPUT_CONNECTIONS));
@@ -583,7 +601,7 @@ template<class T>
 Slot<T>::Slot(const T& initialvalue, int aflags)
  : dependents(), controller(0), flags(aflags), value(initialvalue)
 {
-  DEBUGINFO2(this, "Slot<T>::Slot(initialvalue, aflags=%d)  (%s)", aflags, typeid(T).name());
+  TRACE_INSTANT("slot", "Slot::Slot", this, aflags);
 
   // Set the CACHE_VALID flag to the inverted state ot the NO_INPUT_CONNECTIONS flag
   setFlags(CACHE_VALID, !(flags & NO_INPUT_CONNECTIONS));
@@ -599,13 +617,13 @@ template<class T>
 Slot<T>::Slot(const Slot<T>& s)
 : dependents(), controller(0), flags(s.flags), value(s.value)
 {
-  DEBUGINFO1(this, "Slot<T>::Slot(const Slot<T>&) (copy constructor) (%s)", typeid(T).name());
+  TRACE_INSTANT("slot", "Slot::Slot", this, flags);
 }
 
 template<class T>
 Slot<T>::~Slot()
 {
-  DEBUGINFO1(this, "Slot<T>::~Slot()  (%s)", typeid(T).name());
+  TRACE_INSTANT("slot", "Slot::~Slot", this, dependents.size());
   
   // Disconnect from the controller...
   //  DEBUGINFO(this, "  disconnect");
@@ -630,8 +648,6 @@ Slot<T>::~Slot()
       removeDependent(d);
     }
   }
-
-  DEBUGINFO1(this, "Slot<T>::~Slot()  (%s) --- end", typeid(T).name());
 }
 
 template<class T>
@@ -654,20 +670,24 @@ bool Slot<T>::isSlotCompatible(const ISlot* slot) const
 template<class T>
 const T& Slot<T>::getValue()
 {
-  DEBUGINFO(this, "Slot<T>::getValue()");
+  SLOTPROF_GETVALUE(flags & CACHE_VALID);
 
   // Is the value in the cache still valid?
   if (flags & CACHE_VALID)
     return value; 
 
   // Obtain a new value and store it in the cache
-  if (controller!=0)
-  {
-    value = controller->getValue();
-  }
-  else
   {
-    computeValue();
+    SLOTPROF_EVALUATE();
+    TRACE_SCOPE("slot", "Slot::evaluate", this);
+    if (controller!=0)
+    {
+      value = controller->getValue();
+    }
+    else
+    {
+      computeValue();
+    }
   }
 
   flags |= CACHE_VALID;
@@ -694,7 +714,8 @@ const T& Slot<T>::getValue()
 template<class T>
 void Slot<T>::setValue(const T& val)
 {
-  DEBUGINFO(this, "Slot<T>::setValue(val)");
+  TRACE_INSTANT("slot", "Slot::setValue", this, 0);
+  SLOTPROF_SETVALUE();
 
   // Is this a procedural slot? then the value cannot be set
   if (flags & NO_INPUT_CONNECTIONS)
@@ -729,7 +750,7 @@ ISlot* Slot<T>::getController() const
 template<class T>
 void Slot<T>::setController(ISlot* ctrl)
 {
-  DEBUGINFO1(this, "Slot<T>::setController(%p)", ctrl);
+  TRACE_INSTANT("slot", "Slot::setController", this, ctrl!=0);
   // Check if this slot can take input connections (but allow setting 0
   // as this can happen during destruction)
   if ((flags & NO_INPUT_CONNECTIONS) && ctrl!=0)
@@ -737,10 +758,7 @@ void Slot<T>::setController(ISlot* ctrl)
 
   // If the new and old controller are the same, then there's nothing to do
   if (controller==ctrl)
-  {
-    DEBUGINFO1(this, "Slot<T>::setController(%p) --- end  (new==old)", ctrl);
     return;
-  }
 
   // Is the new ctrl 0? then disconnect only...
   // Note: If ctrl==0 then controller!=0, otherwise we wouldn't be here
@@ -774,13 +792,12 @@ void Slot<T>::setController(ISlot* ctrl)
     ctrl->addDependent(this);
     notifyDependents();
   }
-  DEBUGINFO1(this, "Slot<T>::setController(%p) --- end", ctrl);
 }
 
 template<class T>
 void Slot<T>::addDependent(Dependent* d)
 {
-  DEBUGINFO1(this, "Slot<T>::addDependent(%p)", d);
+  TRACE_INSTANT("slot", "Slot::addDependent", this, dependents.size());
 
   // Do nothing if the dependent was already added before
   if (std::find(dependents.begin(), dependents.end(), d)!=dependents.end())
@@ -793,24 +810,26 @@ void Slot<T>::addDependent(Dependent* d)
 template<class T>
 void Slot<T>::removeDependent(Dependent* d)
 {
-  DEBUGINFO1(this, "Slot<T>::removeDependent(%p)", d);
+  TRACE_INSTANT("slot", "Slot::removeDependent", this, dependents.size());
 
-  // Remove the element (it is moved to the back)
-  std::vector<Dependent*>::iterator res = std::remove(dependents.begin(), dependents.end(), d);
+  // Search from the back as recently added dependents are usually
+  // removed first (addDependent() ensures there are no duplicates)
+  DependentList::reverse_iterator res = std::find(dependents.rbegin(), dependents.rend(), d);
   // Is d not in the dependent list?
-  if (res==dependents.end())
+  if (res==dependents.rend())
   {
     throw EValueError("Attempt to remove a non-existent slot dependency.");
   }
   // Erase the element from the vector
-  dependents.erase(res, dependents.end());
+  dependents.erase((res+1).base());
 }
 
 
 template<class T>
 void Slot<T>::notifyDependents()
 {
-  std::vector<Dependent*>::iterator it;
+  SLOTPROF_NOTIFY(dependents.size());
+  DependentList::iterator it;
   for(it=dependents.begin(); it!=dependents.end(); it++)
   {
     (*it)->onValueChanged();
@@ -828,7 +847,7 @@ void Slot<T>::notifyDependents()
 template<class T>
 void Slot<T>::onValueChanged()
 {
-  DEBUGINFO(this, "Slot<T>::onValueChanged()");
+  TRACE_INSTANT("slot", "Slot::onValueChanged", this, 0);
 
   // Only notify when the cache was still valid
   // (otherwise the dependents have already been notified before
@@ -0,0 +1,124 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef SLOTNAME_H
+#define SLOTNAME_H
+
+/** \file slotname.h
+ Contains the SlotName class.
+ */
+
+#include <string>
+
+// Define the CGKIT_SHARED variable
+#ifdef DLL_EXPORT_SLOTNAME
+  #include "shared_export.h"
+#else
+  #include "shared.h"
+#endif
+
+namespace support3d {
+
+/**
+  An entry in the global slot name table.
+
+  An entry is deleted when the last SlotName that refers to it is
+  destroyed, so the table only contains the names that are in use.
+ */
+struct SlotNameEntry
+{
+  /// The name
+  std::string str;
+  /// Hash value of the name (see SlotName::hashString())
+  unsigned int hash;
+  /// Number of SlotName objects that refer to this entry
+  mutable int refcount;
+};
+
+/**
+  Interned slot name.
+
+  All SlotName objects that were created from the same string refer to
+  the same entry in a global table. Comparing two names is therefore
+  just a pointer comparison and the hash value is only computed once
+  when the name is created. The intention is that frequently used
+  names (such as "cog") are stored in SlotName (or SlotHandle) objects
+  that are created once and then reused.
+
+  The entries are reference counted and removed from the table when
+  the last SlotName (e.g. the name of a removed slot) is destroyed.
+  Creating, copying or destroying a SlotName is not thread-safe (slots
+  are usually only created by the main thread).
+ */
+class CGKIT_SHARED SlotName
+{
+  protected:
+  const SlotNameEntry* entry;
+
+  public:
+  explicit SlotName(const std::string& name) : entry(intern(name)) {}
+  explicit SlotName(const char* name) : entry(intern(name)) {}
+  SlotName(const SlotName& n) : entry(n.entry) { entry->refcount++; }
+  ~SlotName() { release(entry); }
+
+  SlotName& operator=(const SlotName& n)
+  {
+    n.entry->refcount++;
+    release(entry);
+    entry = n.entry;
+    return *this;
+  }
+
+  /// Return the name as string.
+  const std::string& str() const { return entry->str; }
+  /// Return the hash value of the name.
+  unsigned int hash() const { return entry->hash; }
+  /// Return the entry in the global name table.
+  const SlotNameEntry* getEntry() const { return entry; }
+
+  bool operator==(const SlotName& n) const { return entry==n.entry; }
+  bool operator!=(const SlotName& n) const { return entry!=n.entry; }
+
+  static unsigned int hashString(const std::string& s);
+  static int numNames();
+
+  protected:
+  static const SlotNameEntry* intern(const std::string& name);
+  static void release(const SlotNameEntry* e);
+};
+
+}  // end of namespace
+
+#endif
@@ -0,0 +1,192 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef SLOTPROFILER_H
+#define SLOTPROFILER_H
+
+/** \file slotprofiler.h
+ Contains the optional slot profiler.
+
+ The profiler is only compiled into the library when the symbol
+ CGKIT_SLOT_PROFILING is defined. As the symbol changes the layout
+ of ISlot it must be defined for the support library and for the
+ Python wrappers. Without the symbol all SLOTPROF_* macros expand
+ to nothing and there is no runtime overhead at all.
+ */
+
+#include <vector>
+#include "compile_switches.h"
+
+// Define the CGKIT_SHARED variable
+#ifdef DLL_EXPORT_SLOTPROFILER
+  #include "shared_export.h"
+#else
+  #include "shared.h"
+#endif
+
+namespace support3d {
+
+class ISlot;
+class Component;
+
+/**
+  Profiling counters of one slot.
+
+  An evaluation is either a call to computeValue() or a fetch of the
+  value from the controller (i.e. a getValue() call that missed the
+  cache). The total time includes the evaluation of all slots that were
+  evaluated during the evaluation of this slot, the self time excludes
+  that time.
+ */
+struct SlotStats
+{
+  /// The slot the counters belong to
+  const ISlot* slot;
+  /// The component that contains the slot (may be 0)
+  const Component* owner;
+  /// Position in the list of all stats objects
+  int index;
+
+  /// Number of getValue() calls
+  unsigned long getvalue_calls;
+  /// Number of getValue() calls that could be served from the cache
+  unsigned long cache_hits;
+  /// Number of evaluations (cache misses)
+  unsigned long evaluations;
+  /// Number of setValue() calls
+  unsigned long setvalue_calls;
+  /// Number of notifyDependents() calls
+  unsigned long notify_calls;
+  /// Total number of dependents that were notified
+  unsigned long notifications;
+  /// Total evaluation time in seconds (including nested evaluations)
+  double total_time;
+  /// Evaluation time in seconds excluding nested evaluations
+  double self_time;
+};
+
+/**
+  Slot profiler.
+
+  The profiler counts getValue()/setValue() calls, cache hits, 
+  evaluations and notifications per slot and measures the time spent
+  in slot evaluations. It is disabled at runtime by default and has
+  to be switched on with setEnabled(). While it is disabled, the
+  instrumentation in Slot only costs a test of a global flag.
+
+  The counters are stored per slot and are allocated on first use. 
+  The stack of active evaluations (which is required to compute the
+  self time) is kept per thread. The counters themselves are not
+  updated atomically, so they can be slightly off when the same slot
+  is accessed from several threads at once.
+ */
+class CGKIT_SHARED SlotProfiler
+{
+  public:
+
+  /**
+    Measures the time of one slot evaluation.
+
+    An object of this class has to be created on the stack around
+    the code that evaluates a slot.
+   */
+  class CGKIT_SHARED EvalScope
+  {
+    public:
+    EvalScope(ISlot* slot, SlotStats*& stats) : scopestats(0)
+    {
+      if (SlotProfiler::enabled)
+        begin(slot, stats);
+    }
+    ~EvalScope()
+    {
+      if (scopestats!=0)
+        end();
+    }
+
+    protected:
+    void begin(ISlot* slot, SlotStats*& stats);
+    void end();
+
+    /// Counters of the evaluated slot (0 if the profiler was disabled)
+    SlotStats* scopestats;
+    /// The enclosing evaluation (in the same thread)
+    EvalScope* parent;
+    /// Start time
+    double start;
+    /// Time spent in nested evaluations
+    double childtime;
+  };
+
+  /// Runtime switch (only use the methods to modify this flag)
+  static bool enabled;
+
+  public:
+  static bool isAvailable();
+  static bool isEnabled() { return enabled; }
+  static void setEnabled(bool flag);
+  static void reset();
+  static int numStats();
+  static const SlotStats& getStats(int idx);
+  static double now();
+
+  /// Return the counters of a slot (they are created if necessary).
+  static SlotStats* stats(const ISlot* slot, SlotStats*& s)
+  {
+    if (s==0)
+      s = createStats(slot);
+    return s;
+  }
+  static void releaseStats(SlotStats*& s);
+
+  protected:
+  static SlotStats* createStats(const ISlot* slot);
+};
+
+}  // end of namespace
+
+#ifdef CGKIT_SLOT_PROFILING
+  #define SLOTPROF_GETVALUE(hit) if (support3d::SlotProfiler::enabled) { support3d::SlotStats* _ps = support3d::SlotProfiler::stats(this, this->_profstats); _ps->getvalue_calls++; if (hit) _ps->cache_hits++; }
+  #define SLOTPROF_SETVALUE() if (support3d::SlotProfiler::enabled) { support3d::SlotProfiler::stats(this, this->_profstats)->setvalue_calls++; }
+  #define SLOTPROF_NOTIFY(n) if (support3d::SlotProfiler::enabled) { support3d::SlotStats* _ps = support3d::SlotProfiler::stats(this, this->_profstats); _ps->notify_calls++; _ps->notifications += (n); }
+  #define SLOTPROF_EVALUATE() support3d::SlotProfiler::EvalScope _slotprof_scope(this, this->_profstats);
+#else
+  #define SLOTPROF_GETVALUE(hit)
+  #define SLOTPROF_SETVALUE()
+  #define SLOTPROF_NOTIFY(n)
+  #define SLOTPROF_EVALUATE()
+#endif
+
+#endif
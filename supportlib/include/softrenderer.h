@@ -0,0 +1,264 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef SOFTRENDERER_H
+#define SOFTRENDERER_H
+
+/** \file softrenderer.h
+ Contains the SoftRenderer class.
+ */
+
+#include <vector>
+#include <map>
+#include <boost/shared_ptr.hpp>
+#include "mat3.h"
+#include "mat4.h"
+#include "vec4.h"
+#include "worldobject.h"
+#include "dependent.h"
+#include "glmaterial.h"
+#include "trimeshgeom.h"
+
+namespace support3d {
+
+/**
+  Software renderer for headless rendering.
+
+  This renderer takes the same scene as GLRenderInstance (the world
+  object tree, the GLMaterial parameters and the GL light sources) and
+  renders it into an in-memory image without requiring an OpenGL context.
+  Geoms that aren't a TriMeshGeom are converted into one (geoms that
+  can't be converted are skipped). The converted meshes are kept across
+  render() calls and are only recreated when a slot of the geom changes
+  (meshes of geoms that weren't rendered by the last render() call are
+  released at the end of that call). The result is meant to look like the
+  image in the OpenGL viewer. Vertices are lit like in the OpenGL
+  fixed function pipeline (Gouraud shading, default light when there are
+  no lights, global ambient of 0.2) and blended materials are drawn
+  after the opaque objects back-to-front. Textures, polygon modes and
+  the coordinate system gizmos are not supported.
+
+  The image is split into tiles that are rendered in parallel (if the
+  library was compiled with OpenMP support). The edge functions are
+  evaluated for 4 pixels at a time using SSE2 if available.
+
+  The color buffer contains RGBA floats, the depth buffer contains
+  window depth values between 0 and 1. Both buffers store the rows
+  bottom-up (like OpenGL), i.e. the pixel (0,0) is in the lower left
+  corner.
+ */
+class SoftRenderer
+{
+  public:
+  /// Projection matrix
+  mat4d projectionmatrix;
+  /// View matrix
+  mat4d viewmatrix;
+  /// Background color
+  vec4d clearcol;
+  /// Shall the display be left handed?
+  bool left_handed;
+  /// Gouraud (true) or flat shading (false)?
+  bool smooth_model;
+  /// Backface culling?
+  bool backface_culling;
+  /// Default material
+  GLMaterial defaultmat;
+  /// Tile size in pixels.
+  int tilesize;
+  /// Number of threads (0 = use the OpenMP default).
+  int numthreads;
+
+  /// Number of triangles that were rasterized during the last render() call.
+  int stat_triangles;
+  /// Time (in seconds) that the last render() call took.
+  double stat_render_time;
+
+  protected:
+  /// A lit and projected vertex.
+  struct ClipVertex
+  {
+    /// Clip space position.
+    double pos[4];
+    /// Lit color.
+    float col[4];
+  };
+
+  /// A triangle set up for rasterization.
+  struct RasterTriangle
+  {
+    /// Bounding box in pixels (inclusive).
+    int xmin, ymin, xmax, ymax;
+    /// Reference point of the plane equations.
+    float xref, yref;
+    /// Edge functions (A*x + B*y + C, relative to the reference point).
+    float ea[3], eb[3], ec[3];
+    /// Pixels on an edge are only covered if this flag is set.
+    bool topleft[3];
+    /// Plane equations for the depth, 1/w and color/w.
+    float zp[3];
+    float wp[3];
+    float cp[4][3];
+    /// Blend factors (-1 if the triangle isn't blended).
+    int sfactor, dfactor;
+  };
+
+  /// The material parameters used for lighting.
+  struct ShadeMaterial
+  {
+    vec3d ambient, diffuse, specular, emission;
+    double alpha;
+    double shininess;
+  };
+
+  class ConvertedMesh;
+
+  /// Marks a converted mesh as outdated when a slot of its geom changes.
+  class SlotWatcher : public Dependent
+  {
+    public:
+    ConvertedMesh* owner;
+    /// The watched slot (0 if the slot was deleted).
+    ISlot* slot;
+
+    SlotWatcher(ConvertedMesh* aowner, ISlot* aslot) : owner(aowner), slot(aslot) {}
+    void onValueChanged() { owner->valid = false; }
+    void onValueChanged(int, int) { owner->valid = false; }
+    void onResize(int) { owner->valid = false; }
+    void onControllerDeleted() { slot = 0; owner->valid = false; }
+  };
+
+  /// A mesh created from a geom that isn't a mesh.
+  class ConvertedMesh
+  {
+    public:
+    /// The geom (kept alive as long as the mesh is cached).
+    boost::shared_ptr<GeomObject> geom;
+    /// The converted mesh (0 if the geom can't be converted).
+    boost::shared_ptr<TriMeshGeom> mesh;
+    /// False if the geom has changed since the mesh was created.
+    bool valid;
+    /// True if the mesh was used during the current render() call.
+    bool used;
+    /// The slot serial of the geom when the slots were connected.
+    unsigned long slotserial;
+    /// One watcher per slot of the geom.
+    std::vector<SlotWatcher*> watchers;
+
+    ConvertedMesh(boost::shared_ptr<GeomObject> ageom);
+    ~ConvertedMesh();
+    void watchSlots();
+    void unwatchSlots();
+
+    private:
+    ConvertedMesh(const ConvertedMesh&);
+    ConvertedMesh& operator=(const ConvertedMesh&);
+  };
+
+  /// A light source converted to eye space.
+  struct EyeLight
+  {
+    /// Position (w=0 for distant lights).
+    vec4d pos;
+    /// Spot direction.
+    vec3d spotdir;
+    /// Cosine of the spot cutoff angle (-1 for no spot light).
+    double spotcos;
+    double spotexponent;
+    vec3d ambient, diffuse, specular;
+    double constant_attenuation, linear_attenuation, quadratic_attenuation;
+  };
+
+  int width;
+  int height;
+  /// Color buffer (RGBA).
+  std::vector<float> colorbuffer;
+  /// Depth buffer.
+  std::vector<float> depthbuffer;
+
+  std::vector<EyeLight> eyelights;
+  std::vector<RasterTriangle> triangles;
+  /// Triangle indices per tile.
+  std::vector<std::vector<int> > tilebins;
+  int numtilesx;
+  int numtilesy;
+
+  /// Meshes created from geoms that aren't meshes.
+  std::map<GeomObject*, boost::shared_ptr<ConvertedMesh> > converted;
+
+  // Per-corner buffers used while processing a mesh
+  std::vector<vec3d> cornernormals;
+  std::vector<vec3d> cornercolors;
+  std::vector<char> cornerhascolor;
+  std::vector<ClipVertex> cornerverts;
+  std::vector<ClipVertex> shadedverts;
+
+  public:
+  SoftRenderer();
+  virtual ~SoftRenderer() {}
+
+  void setProjection(const mat4d& P) { projectionmatrix = P; }
+  mat4d getProjection() const { return projectionmatrix; }
+  void setViewTransformation(const mat4d& V) { viewmatrix = V; }
+  mat4d getViewTransformation() const { return viewmatrix; }
+  void setResolution(int w, int h);
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+
+  void render(WorldObject& root);
+
+  const float* getColorBuffer() const { return colorbuffer.empty()? 0 : &colorbuffer[0]; }
+  const float* getDepthBuffer() const { return depthbuffer.empty()? 0 : &depthbuffer[0]; }
+  vec4d getPixel(int x, int y) const;
+  double getDepth(int x, int y) const;
+  void getRGBA8(unsigned char* dest, bool topdown=true) const;
+
+  protected:
+  void clear();
+  void setupLights(WorldObject& root, const mat4d& B, const mat4d& RWinv);
+  void collectLights(WorldObject& node, const mat4d& B, const mat4d& RWinv);
+  void processObject(WorldObject& obj, const mat4d& MV, bool blended, int sfactor, int dfactor);
+  TriMeshGeom* getMesh(const boost::shared_ptr<GeomObject>& geom);
+  void shadeVertex(const vec3d& P, const vec3d& N, const ShadeMaterial& mat, const vec3d* diffuse, float* col) const;
+  void shadeClipVertex(const mat4d& MV, const mat3d& NM, const vec3d& p, const vec3d& N, const ShadeMaterial& mat, const vec3d* diffuse, ClipVertex& v) const;
+  void clipAndSetup(const ClipVertex* v, int sfactor, int dfactor);
+  void setupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, int sfactor, int dfactor);
+  void binTriangles();
+  void rasterizeTile(int tx, int ty);
+};
+
+}  // end of namespace
+
+#endif
@@ -44,6 +44,7 @@
 #include <vector>
 #include "vec3.h"
 #include "trimeshgeom.h"
+#include "tessellationcache.h"
 
 namespace support3d {
 
@@ -86,6 +87,7 @@ class SORTriangulator
   ~SORTriangulator() {}
 
   void drawGL(double startangle, double endangle, int segmentsu, SORVertexList& vlist);
+  void tessellate(double startangle, double endangle, int segmentsu, SORVertexList& vlist, TessellationCache& cache);
   void convertToTriMesh(double startangle, double endangle, int segmentsu,
 			SORVertexList& vlist, TriMeshGeom& tm);
 };
@@ -69,12 +69,20 @@ class CGKIT_SHARED SphereGeom : public GeomObject
   Slot<vec3d> cog;
   ProceduralSlot<mat3d, SphereGeom> inertiatensor;
 
+  /// Forwards changes of the parameter slots to onParamChanged().
+  NotificationForwarder<SphereGeom> _on_param_event;
+
+  protected:
+  /// Cached OpenGL tessellation (invalidated when a parameter changes).
+  TessellationCache tesscache;
+
   public:
   SphereGeom(double aradius=1.0, int segsu=16, int segsv=8);
   ~SphereGeom();
 
   virtual BoundingBox boundingBox();
   virtual void drawGL();
+  void onParamChanged();
 
   //  virtual int uniformCount() const { return 1; }
   //  virtual int varyingCount() const { return 4; }
@@ -86,8 +94,10 @@ class CGKIT_SHARED SphereGeom : public GeomObject
 
   virtual void convert(GeomObject* target);
 
+  static const TessellationCache& unitSphere(int segsu, int segsv);
+
   private:
-  void createSilhouette(SORTriangulator::SORVertexList& vlist);
+  static void createSilhouette(double rad, int segsv, SORTriangulator::SORVertexList& vlist);
 };
 
 
@@ -0,0 +1,169 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef SUBDIVIDER_H
+#define SUBDIVIDER_H
+
+/** \file subdivider.h
+ Contains the Subdivider class.
+ */
+
+#include <vector>
+#include <string>
+#include "vec3.h"
+#include "vec4.h"
+#include "mat4.h"
+
+namespace support3d {
+
+class GeomObject;
+class TriMeshGeom;
+class PolyhedronGeom;
+class MeshTopology;
+
+/**
+  A sparse matrix that computes output values as weighted sums of input values.
+
+  The table is stored in CSR layout: the inputs of output value i are
+  indices[offsets[i]] ... indices[offsets[i+1]-1] with the corresponding
+  weights.
+ */
+class StencilTable
+{
+  public:
+  /// Number of input values.
+  int numsrc;
+  std::vector<int> offsets;
+  std::vector<int> indices;
+  std::vector<double> weights;
+
+  StencilTable() : numsrc(0), offsets(1, 0), indices(), weights() {}
+
+  /// Return the number of output values.
+  int numRows() const { return int(offsets.size())-1; }
+  void identity(int n);
+  void clear() { numsrc = 0; offsets.assign(1, 0); indices.clear(); weights.clear(); }
+
+  void apply(const double* src, double* dst, int mult=1) const;
+  void apply(const vec3d* src, vec3d* dst, int mult=1) const;
+  void apply(const vec4d* src, vec4d* dst, int mult=1) const;
+  void apply(const mat4d* src, mat4d* dst, int mult=1) const;
+  void apply(const int* src, int* dst, int mult=1) const;
+  void apply(const std::string* src, std::string* dst, int mult=1) const;
+};
+
+/**
+  Subdivision surface engine.
+
+  The subdivider refines a control mesh (the cage) a given number of
+  times, either with the Catmull-Clark scheme (PolyhedronGeom cages) or
+  with the Loop scheme (TriMeshGeom cages). The result is always a
+  triangle mesh (the quads produced by Catmull-Clark are split into two
+  triangles).
+
+  The subdivision rules are not applied to the vertex positions directly.
+  Instead, each refined vertex is stored as a weighted sum of cage
+  vertices (a stencil). So once the stencils have been built, the
+  refined vertices can be re-evaluated after the cage vertices have
+  been moved by a sparse matrix-vector product (which runs in parallel
+  when the library is compiled with OpenMP support). If only a few cage
+  vertices have been moved, only the affected refined vertices are
+  updated.
+
+  Edges that are only used by one face (or by more than two faces) are
+  treated as sharp boundary edges that are subdivided as a cubic B-spline
+  curve. Vertices with more than two boundary edges are kept as corners.
+  Only the outer loop of a PolyhedronGeom poly is used, holes are ignored.
+
+  Primitive variables are interpolated as follows: constant variables are
+  copied, uniform variables are taken from the cage face, vertex and
+  varying variables are interpolated with the vertex stencils and
+  facevarying/facevertex variables are interpolated linearly within each
+  cage face. Integer and string values are taken from the input that has
+  the largest weight.
+ */
+class Subdivider
+{
+  protected:
+  /// Refined vertices as weighted sums of cage vertices.
+  StencilTable vertstencils;
+  /// Refined face corners as weighted sums of cage face corners.
+  StencilTable cornerstencils;
+  /// Refined triangles (3 vertex indices per face).
+  std::vector<int> faces;
+  /// Cage face index of each refined triangle.
+  std::vector<int> facesrc;
+  /** Refined vertices that depend on a cage vertex (CSR layout).
+
+    This is the transpose of vertstencils and is used for incremental
+    updates.
+   */
+  std::vector<int> cageoffsets;
+  std::vector<int> cagerows;
+  /// Stamps used to mark refined vertices during an incremental update.
+  mutable std::vector<int> rowstamps;
+  mutable int stamp;
+
+  public:
+  Subdivider();
+
+  void catmullClark(PolyhedronGeom& cage, int levels);
+  void loop(TriMeshGeom& cage, int levels);
+  void build(const std::vector<int>& faceoffsets, const std::vector<int>& faceverts, const std::vector<int>& facecorners, const std::vector<int>& facesources, int numverts, int numcorners, int levels, bool loopscheme);
+
+  /// Return the number of cage vertices.
+  int getNumCageVerts() const { return vertstencils.numsrc; }
+  /// Return the number of refined vertices.
+  int getNumVerts() const { return vertstencils.numRows(); }
+  /// Return the number of refined triangles.
+  int getNumFaces() const { return int(facesrc.size()); }
+  const StencilTable& getVertexStencils() const { return vertstencils; }
+  const StencilTable& getCornerStencils() const { return cornerstencils; }
+  const std::vector<int>& getFaces() const { return faces; }
+  const std::vector<int>& getFaceSources() const { return facesrc; }
+
+  void createMesh(GeomObject& cage, const vec3d* cageverts, TriMeshGeom& target) const;
+  void updateVerts(const vec3d* cageverts, vec3d* verts) const;
+  bool updateVerts(const vec3d* cageverts, int start, int end, vec3d* verts, int& rowbegin, int& rowend) const;
+
+  protected:
+  static void catmullClarkLevel(const MeshTopology& topo, const std::vector<int>& foff, const std::vector<int>& fverts, const StencilTable& verts, const StencilTable& corners, std::vector<int>& newfoff, std::vector<int>& newfverts, StencilTable& newverts, StencilTable& newcorners);
+  static void loopLevel(const MeshTopology& topo, const std::vector<int>& fverts, const StencilTable& verts, const StencilTable& corners, std::vector<int>& newfverts, StencilTable& newverts, StencilTable& newcorners);
+  void buildTranspose();
+};
+
+}  // end of namespace
+
+#endif
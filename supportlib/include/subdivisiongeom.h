@@ -0,0 +1,90 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef SUBDIVISIONGEOM_H
+#define SUBDIVISIONGEOM_H
+
+/** \file subdivisiongeom.h
+ Contains the SubdivisionGeom class.
+ */
+
+#include "trimeshgeom.h"
+#include "subdivider.h"
+
+namespace support3d {
+
+/**
+  A triangle mesh that is the subdivided version of a control mesh.
+
+  The cage is either a PolyhedronGeom (Catmull-Clark subdivision) or a
+  TriMeshGeom (Loop subdivision). The geom listens to the vertices of the
+  cage and updates its own vertices when the cage vertices change (only
+  the affected vertices are recomputed). When the topology or the
+  primitive variables of the cage have been modified, rebuild() has to
+  be called.
+ */
+class SubdivisionGeom : public TriMeshGeom
+{
+  public:
+  NotificationForwarder<SubdivisionGeom> _on_cage_verts_event;
+
+  protected:
+  /// The control mesh (may be 0).
+  boost::shared_ptr<GeomObject> cage;
+  /// The vertex slot of the control mesh (or 0).
+  ArraySlot<vec3d>* cageverts;
+  /// Number of subdivision steps.
+  int levels;
+  /// Stencils of the current cage.
+  Subdivider subdivider;
+
+  public:
+  SubdivisionGeom();
+  virtual ~SubdivisionGeom();
+
+  void setCage(boost::shared_ptr<GeomObject> acage, int alevels);
+  boost::shared_ptr<GeomObject> getCage() const { return cage; }
+  int getLevels() const { return levels; }
+  void setLevels(int alevels);
+  void rebuild();
+  const Subdivider& getSubdivider() const { return subdivider; }
+
+  void onCageVertsChanged(int start, int end);
+  void onCageVertsResize(int size);
+};
+
+}  // end of namespace
+
+#endif
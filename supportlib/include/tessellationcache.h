@@ -0,0 +1,107 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef TESSELLATIONCACHE_H
+#define TESSELLATIONCACHE_H
+
+/** \file tessellationcache.h
+ Contains the TessellationCache class.
+ */
+
+#include <vector>
+
+namespace support3d {
+
+/**
+  Stores a tessellated surface as quad strips for drawing.
+
+  The analytic geoms (SphereGeom, TorusGeom, CCylinderGeom, BoxGeom,
+  PlaneGeom) keep one of these as a cache of their OpenGL tessellation.
+  The cache is invalidated when one of the parameter slots of the geom
+  changes, so as long as the parameters stay the same, drawing the geom
+  doesn't recompute any vertex (the data is drawn using vertex arrays).
+
+  Usage: Call clear(), then call beginStrip() at the beginning of each
+  quad strip and addVertex() for each vertex. Finally, call finish()
+  which marks the cache as valid.
+ */
+class TessellationCache
+{
+  protected:
+  /// Vertex positions (3 floats per vertex).
+  std::vector<float> positions;
+  /// Vertex normals (3 floats per vertex).
+  std::vector<float> normals;
+  /// Texture coordinates (2 floats per vertex).
+  std::vector<float> texcoords;
+  /// Index of the first vertex of each strip.
+  std::vector<int> stripstarts;
+  /// True if the cache contents are up to date.
+  bool valid;
+
+  public:
+  TessellationCache() : positions(), normals(), texcoords(), stripstarts(), valid(false) {}
+
+  /// Return true if the cache contents are up to date.
+  bool isValid() const { return valid; }
+  /// Mark the cache as outdated (the data is kept until clear() is called).
+  void invalidate() { valid = false; }
+
+  void clear();
+  void beginStrip();
+  void finish() { valid = true; }
+
+  /// Add a vertex to the current strip.
+  void addVertex(double px, double py, double pz, double nx, double ny, double nz, double s, double t)
+  {
+    positions.push_back(float(px));
+    positions.push_back(float(py));
+    positions.push_back(float(pz));
+    normals.push_back(float(nx));
+    normals.push_back(float(ny));
+    normals.push_back(float(nz));
+    texcoords.push_back(float(s));
+    texcoords.push_back(float(t));
+  }
+
+  int getNumStrips() const { return int(stripstarts.size()); }
+  int getNumVerts() const { return int(positions.size()/3); }
+
+  void drawGL() const;
+};
+
+}  // end of namespace
+
+#endif
@@ -0,0 +1,119 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+/** \file texturecache.h
+ Contains the TextureCache class.
+ */
+
+#include <string>
+#include <list>
+#include <map>
+#include <boost/shared_ptr.hpp>
+#include "textureimage.h"
+
+namespace support3d {
+
+/**
+  LRU cache for texture images.
+
+  The cache maps a key (usually the image file name together with the
+  load options) to a TextureImage, so textures that reference the same
+  image share the data and the OpenGL texture object. When the total
+  size of the cached images exceeds the budget, the least recently used
+  images are removed from the cache (an image that is still referenced
+  by a texture remains valid and is deleted when the texture releases
+  it).
+
+  The cache is not synchronized. In cgkit, all calls are made while
+  holding the Python interpreter lock.
+
+  \see TextureImage, GLTexture
+ */
+class TextureCache
+{
+  public:
+  /// Number of successful lookups.
+  int stat_hits;
+  /// Number of failed lookups.
+  int stat_misses;
+  /// Number of images that were removed because of the budget.
+  int stat_evictions;
+
+  protected:
+  typedef std::list<std::string> KeyList;
+
+  struct Entry
+  {
+    boost::shared_ptr<TextureImage> image;
+    /// Size of the image when it was inserted
+    unsigned long size;
+    /// Position in the LRU list
+    KeyList::iterator lrupos;
+  };
+
+  /// Memory budget in bytes.
+  unsigned long budget;
+  /// Total size of the cached images.
+  unsigned long memsize;
+  /// Cached images
+  std::map<std::string, Entry> entries;
+  /// Keys sorted by last use (most recently used first)
+  KeyList lru;
+
+  public:
+  TextureCache(unsigned long abudget=256*1024*1024);
+
+  boost::shared_ptr<TextureImage> lookup(const std::string& key);
+  void insert(const std::string& key, boost::shared_ptr<TextureImage> image);
+  void remove(const std::string& key);
+  void clear();
+
+  unsigned long getBudget() const { return budget; }
+  void setBudget(unsigned long abudget);
+  unsigned long getMemSize() const { return memsize; }
+  int size() const { return entries.size(); }
+
+  static TextureCache& defaultCache();
+
+  protected:
+  void evict();
+};
+
+}  // end of namespace
+
+#endif
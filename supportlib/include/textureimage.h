@@ -0,0 +1,115 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef TEXTUREIMAGE_H
+#define TEXTUREIMAGE_H
+
+/** \file textureimage.h
+ Contains the TextureImage class.
+ */
+
+#include <vector>
+
+namespace support3d {
+
+/**
+  Texture image data with its mip map chain.
+
+  The image data (8 bit per channel) is passed to setData() which also
+  computes the mip map levels on the CPU using a 2x2 box filter. This
+  doesn't require an OpenGL context, so it can be done in a background
+  thread. uploadGL() then only has to pass the levels to OpenGL (which
+  has to be done by the thread that owns the context). After the upload
+  the CPU copy of the data is released.
+
+  A %TextureImage can be shared by several GLTexture objects (see
+  TextureCache). The OpenGL texture object is owned by the image. As
+  the destructor may not be called with an OpenGL context made current,
+  the texture objects of deleted images are only deleted in the next
+  call to deleteReleasedGL().
+
+  \see GLTexture, TextureCache
+ */
+class TextureImage
+{
+  protected:
+  /// Pixel format (GL_RGB, GL_RGBA, GL_LUMINANCE, ...)
+  int format;
+  /// Number of components per pixel
+  int components;
+  /// Widths of the mip map levels
+  std::vector<int> widths;
+  /// Heights of the mip map levels
+  std::vector<int> heights;
+  /// Pixel data of the levels (empty after the upload)
+  std::vector<std::vector<unsigned char> > levels;
+  /// Total number of bytes of all levels
+  unsigned long memsize;
+  /// OpenGL texture name (0 = not uploaded yet)
+  unsigned int texname;
+
+  /// Texture names of deleted images
+  static std::vector<unsigned int> releasednames;
+
+  public:
+  TextureImage();
+  ~TextureImage();
+
+  void setData(int w, int h, int aformat, const unsigned char* data, bool mipmap);
+
+  int getFormat() const { return format; }
+  int getWidth() const { return widths.empty()? 0 : widths[0]; }
+  int getHeight() const { return heights.empty()? 0 : heights[0]; }
+  int getNumLevels() const { return widths.size(); }
+  unsigned long getMemSize() const { return memsize; }
+  const unsigned char* getLevelData(int level) const;
+
+  bool isUploaded() const { return texname!=0; }
+  unsigned int getTexName() const { return texname; }
+  void uploadGL(int internalformat);
+
+  static int numComponents(int aformat);
+  static void downsample(const unsigned char* src, int w, int h, int comps, unsigned char* dst);
+  static void deleteReleasedGL();
+
+  private:
+  // Images are not copyable (the texture object is owned by the image)
+  TextureImage(const TextureImage&);
+  TextureImage& operator=(const TextureImage&);
+};
+
+}  // end of namespace
+
+#endif
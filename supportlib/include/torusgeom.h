@@ -71,12 +71,20 @@ class CGKIT_SHARED TorusGeom : public GeomObject
   Slot<vec3d> cog;
   ProceduralSlot<mat3d, TorusGeom> inertiatensor;
 
+  /// Forwards changes of the parameter slots to onParamChanged().
+  NotificationForwarder<TorusGeom> _on_param_event;
+
+  protected:
+  /// Cached OpenGL tessellation (invalidated when a parameter changes).
+  TessellationCache tesscache;
+
   public:
   TorusGeom(double amajor=1.0, double aminor=0.1, int segsu=16, int segsv=8);
   ~TorusGeom();
 
   virtual BoundingBox boundingBox();
   virtual void drawGL();
+  void onParamChanged();
 
   boost::shared_ptr<SizeConstraintBase> slotSizeConstraint(VarStorage storage) const;
 
@@ -0,0 +1,164 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef TRACING_H
+#define TRACING_H
+
+/** \file tracing.h
+ Contains the event tracer.
+
+ The tracer is only compiled into the library when the symbol
+ CGKIT_TRACING is defined. Without the symbol all TRACE_* macros 
+ expand to nothing.
+ */
+
+#include <string>
+#include "compile_switches.h"
+
+// Define the CGKIT_SHARED variable
+#ifdef DLL_EXPORT_TRACING
+  #include "shared_export.h"
+#else
+  #include "shared.h"
+#endif
+
+namespace support3d {
+
+/**
+  A trace event.
+
+  The name and category must point to static strings (or strings
+  that were obtained via Tracer::internString()), so recording an
+  event never allocates or formats anything.
+ */
+struct TraceEvent
+{
+  /// Time stamp in seconds (relative to the start of the trace)
+  double timestamp;
+  /// Event category (such as "slot" or "render")
+  const char* category;
+  /// Event name
+  const char* name;
+  /// The object that generated the event (may be 0)
+  const void* object;
+  /// Additional value (the value of a counter event)
+  long arg;
+  /// Event type ('B'=begin, 'E'=end, 'i'=instant, 'C'=counter)
+  char type;
+};
+
+/**
+  Event tracer.
+
+  The tracer records events into ring buffers, one buffer per thread,
+  so the threads never have to synchronize while recording. When a
+  buffer is full the oldest events are overwritten. The recorded
+  events can be exported in the JSON format of the Chrome trace
+  viewer which can also be read by Perfetto (ui.perfetto.dev).
+
+  The tracer is disabled at runtime by default. While it is disabled,
+  an instrumentation point only costs a test of a global flag.
+
+  clear() and setBufferSize() must not be called while other threads
+  are recording events.
+ */
+class CGKIT_SHARED Tracer
+{
+  public:
+
+  /**
+    Records a begin and an end event for the lifetime of the object.
+   */
+  class Scope
+  {
+    public:
+    Scope(const char* acategory, const char* aname, const void* aobject)
+      : category(0), name(aname), object(aobject)
+    {
+      if (Tracer::enabled)
+      {
+        category = acategory;
+        Tracer::record('B', category, name, object, 0);
+      }
+    }
+    ~Scope()
+    {
+      // Also record the end if the tracer has been disabled in the meantime
+      if (category!=0)
+        Tracer::record('E', category, name, object, 0);
+    }
+
+    protected:
+    const char* category;
+    const char* name;
+    const void* object;
+  };
+
+  /// Runtime switch (only use the methods to modify this flag)
+  static bool enabled;
+
+  public:
+  static bool isAvailable();
+  static bool isEnabled() { return enabled; }
+  static void setEnabled(bool flag);
+  static int getBufferSize();
+  static void setBufferSize(int numevents);
+  static void clear();
+  static int numEvents();
+
+  static void record(char type, const char* category, const char* name, const void* object, long arg);
+  static const char* internString(const std::string& s);
+
+  static std::string chromeTrace();
+  static void saveChromeTrace(const std::string& filename);
+};
+
+}  // end of namespace
+
+#ifdef CGKIT_TRACING
+  #define TRACE_BEGIN(cat, name, obj) if (support3d::Tracer::enabled) { support3d::Tracer::record('B', cat, name, obj, 0); }
+  #define TRACE_END(cat, name, obj) if (support3d::Tracer::enabled) { support3d::Tracer::record('E', cat, name, obj, 0); }
+  #define TRACE_INSTANT(cat, name, obj, arg) if (support3d::Tracer::enabled) { support3d::Tracer::record('i', cat, name, obj, long(arg)); }
+  #define TRACE_COUNTER(cat, name, obj, value) if (support3d::Tracer::enabled) { support3d::Tracer::record('C', cat, name, obj, long(value)); }
+  #define TRACE_SCOPE(cat, name, obj) support3d::Tracer::Scope _trace_scope(cat, name, obj);
+#else
+  #define TRACE_BEGIN(cat, name, obj)
+  #define TRACE_END(cat, name, obj)
+  #define TRACE_INSTANT(cat, name, obj, arg)
+  #define TRACE_COUNTER(cat, name, obj, value)
+  #define TRACE_SCOPE(cat, name, obj)
+#endif
+
+#endif
@@ -46,6 +46,8 @@
 #include "proceduralslot.h"
 #include "vec3.h"
 #include "boundingbox.h"
+#include "normalgenerator.h"
+#include "meshtopology.h"
 
 namespace support3d {
 
@@ -100,6 +102,27 @@ class TriMeshGeom : public GeomObject
   /// True if bb_cache is still valid, otherwise it has to be recomputed.
   bool bb_cache_valid;
 
+  /// Normal generator (keeps the incidence table for incremental updates).
+  NormalGenerator normalgen;
+  /** The "N" slot that was created by computeNormals() (or 0).
+
+    As long as the "N" variable still uses this slot, the normals are
+    kept up to date by updateNormals().
+   */
+  IArraySlot* generated_normals;
+  /// The crease angle that was passed to computeNormals().
+  double normals_creaseangle;
+  /// True if the topology of the normal generator has to be rebuilt.
+  bool normals_topology_dirty;
+  /// Range of modified vertices since the last normal update (begin>=end: no change).
+  int normals_dirty_begin;
+  int normals_dirty_end;
+
+  /// Cached half-edge connectivity (see getTopology()).
+  MeshTopology topology_cache;
+  /// True if topology_cache is still valid, otherwise it has to be rebuilt.
+  bool topology_valid;
+
   public:
   TriMeshGeom();
 
@@ -112,8 +135,12 @@ class TriMeshGeom : public GeomObject
   virtual int faceVaryingCount() const { return 3*faces.size(); }
   virtual int faceVertexCount() const { return 3*faces.size(); }*/
   virtual boost::shared_ptr<SizeConstraintBase> slotSizeConstraint(VarStorage storage) const;
+  virtual void deleteVariable(string name);
 
   void calcMassProperties();
+  void computeNormals(double creaseangle=-1.0, bool angleweighted=true);
+  bool updateNormals();
+  const MeshTopology& getTopology();
   bool intersectRay(const vec3d& origin, const vec3d& direction, IntersectInfo& info, bool earlyexit=false);
 
   void onVertsChanged(int start, int end);
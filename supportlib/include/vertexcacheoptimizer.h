@@ -0,0 +1,89 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef VERTEXCACHEOPTIMIZER_H
+#define VERTEXCACHEOPTIMIZER_H
+
+/** \file vertexcacheoptimizer.h
+ Contains the VertexCacheOptimizer class.
+ */
+
+#include <vector>
+
+namespace support3d {
+
+/**
+  Computes a face order that makes good use of a post-transform vertex cache.
+
+  The class implements Tom Forsyth's "Linear-Speed Vertex Cache
+  Optimisation" algorithm: Each vertex gets a score that depends on its
+  position in a simulated LRU cache and on the number of faces that
+  still use the vertex. The next face is always the one with the highest
+  score among the faces whose vertices are in the cache. When the cache
+  doesn't contain any useful faces anymore, the algorithm continues with
+  the best-scoring remaining face, which is taken from a heap (so the
+  running time is O(n log n)).
+
+  Like the NormalGenerator, the class operates on raw face arrays (3
+  vertex indices per face). Applying the order to a TriMeshGeom is done
+  by MeshCleanup::optimizeVertexCache().
+ */
+class VertexCacheOptimizer
+{
+  public:
+  /// Size of the simulated vertex cache.
+  int cachesize;
+
+  public:
+  VertexCacheOptimizer(int acachesize=32);
+
+  void optimize(const int* faces, int numfaces, int numverts, std::vector<int>& order);
+
+  static double missRatio(const int* faces, int numfaces, int cachesize=16);
+
+  protected:
+  /// Precomputed scores for the cache positions.
+  std::vector<double> cachescores;
+  /// Precomputed valence boost scores for small valences.
+  std::vector<double> valencescores;
+
+  void initScores();
+  double vertexScore(int cachepos, int remaining) const;
+  double outsideScore(const int* face, const std::vector<int>& remaining) const;
+};
+
+}  // end of namespace
+
+#endif
@@ -51,6 +51,7 @@
 #include "mat4.h"
 #include "geomobject.h"
 #include "material.h"
+#include "childcontainer.h"
 
 namespace support3d {
 
@@ -151,6 +152,15 @@ class TransformSlot : public Slot<mat4d>
   RotationSlot* rot;
   ScaleSlot* scale;
 
+  /// The matrix that was decomposed last (only valid if decomp_valid is true).
+  mat4d decomp_source;
+  /// Rotation part of decomp_source.
+  mat3d decomp_rot;
+  /// Scaling part of decomp_source.
+  vec3d decomp_scale;
+  /// True if the decomposition cache is valid.
+  bool decomp_valid;
+
   public:
   TransformSlot(PositionSlot* apos, RotationSlot* arot, ScaleSlot* ascale);
   virtual ~TransformSlot();
@@ -173,6 +183,9 @@ class TransformSlot : public Slot<mat4d>
   void onRotChanged();
   void onScaleChanged();
 
+  protected:
+  void decompose(const mat4d& m, mat3d& r, vec3d& s);
+  void cacheDecomposition(const mat3d& r, const vec3d& s);
 };
 
 /**
@@ -208,9 +221,9 @@ class WorldObject : public Component  //, public boost::enable_shared_from_this<
 
   WorldObject* parent;
 //  boost::shared_ptr<WorldObject> parent;
-  std::map<string, boost::shared_ptr<WorldObject> > childs;
-  typedef std::map<string, boost::shared_ptr<WorldObject> >::iterator ChildIterator;
-  typedef std::map<string, boost::shared_ptr<WorldObject> >::const_iterator ConstChildIterator;
+  /// Children objects (in the order in which they were added).
+  ChildContainer childs;
+  typedef ChildContainer::iterator ChildIterator;
 
   protected:
   /// Associated geometry.
@@ -229,17 +242,46 @@ class WorldObject : public Component  //, public boost::enable_shared_from_this<
   /// The inverse of the current offset transformation.
   mat4d _inverseOffsetTransform;
 
+  /// Serial number of the last structural change in this subtree.
+  unsigned long structure_serial;
+
+  /// Handles for the geom slots that are used by the mass properties.
+  SlotHandle<vec3d> geom_cog;
+  SlotHandle<mat3d> geom_inertiatensor;
+  /// Handle for the "dynamics" slot of this object (if there is one).
+  SlotHandle<bool> dynamics_slot;
+  /// Global counter that provides the structure serial numbers.
+  static unsigned long structure_counter;
+
   ////////////////////////////////////////
   public:
   WorldObject(string aname="");
   virtual ~WorldObject();
 
+  // World objects are allocated from memory pools
+  static void* operator new(size_t size);
+  static void operator delete(void* p, size_t size);
+  static void* operator new(size_t, void* p) { return p; }
+  static void operator delete(void*, void*) {}
+
   virtual void setName(string aname);
 
   virtual BoundingBox boundingBox();
 
   const mat4d& localTransform();
 
+  /**
+    Return the serial number of the last structural change in this subtree.
+
+    The number changes whenever a children is added or removed or a geom
+    or material is set anywhere below (and including) this object. It
+    can be used to check if data derived from the hierarchy (such as the
+    draw list of the OpenGL renderer) has to be rebuilt. Serial numbers
+    are unique among all objects, so two different objects never report
+    the same value.
+   */
+  unsigned long getStructureSerial() const { return structure_serial; }
+
   const mat4d& getOffsetTransform();
   void setOffsetTransform(const mat4d& ot);
 
@@ -279,6 +321,7 @@ class WorldObject : public Component  //, public boost::enable_shared_from_this<
 
   protected:
   void onRenameChild(const WorldObject& child, string newname);
+  void touchStructure();
   void computeCog(vec3d& cog);
   void computeInertiaTensor(mat3d& tensor);
   mat3d _translateI(const vec3d& oldcog, const vec3d& a);
@@ -0,0 +1,595 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <math.h>
+#include <algorithm>
+#include "animcurve.h"
+#include "common_exceptions.h"
+
+namespace support3d {
+
+//////////////////////////////////////////////////////////////////////
+// AnimCurveBase
+//////////////////////////////////////////////////////////////////////
+
+/**
+  Return the time of a key.
+
+  \param idx Key index
+  \return Key time
+ */
+double AnimCurveBase::getTime(int idx) const
+{
+  checkIndex(idx);
+  return times[idx];
+}
+
+/**
+  Return the interpolation mode of a key.
+
+  \param idx Key index
+  \return Interpolation mode of the segment that starts at the key
+ */
+AnimCurveBase::Interpolation AnimCurveBase::getInterpolation(int idx) const
+{
+  checkIndex(idx);
+  return Interpolation(interps[idx]);
+}
+
+/**
+  Set the interpolation mode of a key.
+
+  \param idx Key index
+  \param ip Interpolation mode of the segment that starts at the key
+ */
+void AnimCurveBase::setInterpolation(int idx, Interpolation ip)
+{
+  checkIndex(idx);
+  interps[idx] = (unsigned char)ip;
+}
+
+/**
+  Return the segment that contains a particular time.
+
+  The return value is the index i of the key with times[i] <= t < times[i+1].
+  If t is before the first key, -1 is returned, if t is at or after the
+  last key, numKeys()-1 is returned.
+
+  \param t Time
+  \param[out] u Receives the relative position of t within the segment (0-1)
+  \return Segment index
+ */
+int AnimCurveBase::locate(double t, double& u) const
+{
+  int n = int(times.size());
+  u = 0.0;
+
+  // Equally spaced keys? Then compute the index directly (this doesn't
+  // have to access the key times at all)
+  if (uniform)
+  {
+    double s = (t-start)*invdt;
+    if (s<0.0)
+      return -1;
+    if (s>=double(n-1))
+      return n-1;
+    int i = int(s);
+    u = s-i;
+    return i;
+  }
+
+  if (n==0 || t<times[0])
+    return -1;
+  if (t>=times[n-1])
+    return n-1;
+
+  // Check the segment of the previous lookup and the following segment
+  int i = lastseg;
+  if (i<0 || i>=n-1 || t<times[i])
+  {
+    // Binary search
+    i = int(std::upper_bound(times.begin(), times.end(), t)-times.begin())-1;
+  }
+  else if (t>=times[i+1])
+  {
+    i++;
+    if (t>=times[i+1])
+      i = int(std::upper_bound(times.begin()+i+1, times.end(), t)-times.begin())-1;
+  }
+  lastseg = i;
+  u = (t-times[i])/(times[i+1]-times[i]);
+  return i;
+}
+
+/**
+  Insert a key time.
+
+  If there is already a key at time t, its index is returned and
+  replaced is set to true.
+
+  \param t Key time
+  \param ip Interpolation mode of the key
+  \param[out] replaced Receives true if the key already existed
+  \return Index of the key
+ */
+int AnimCurveBase::insertTime(double t, Interpolation ip, bool& replaced)
+{
+  std::vector<double>::iterator it = std::lower_bound(times.begin(), times.end(), t);
+  int idx = int(it-times.begin());
+  if (it!=times.end() && *it==t)
+  {
+    interps[idx] = (unsigned char)ip;
+    replaced = true;
+    return idx;
+  }
+  times.insert(it, t);
+  interps.insert(interps.begin()+idx, (unsigned char)ip);
+  replaced = false;
+  uniform = false;
+  return idx;
+}
+
+/**
+  Remove a key time.
+
+  \param idx Key index
+ */
+void AnimCurveBase::removeTime(int idx)
+{
+  checkIndex(idx);
+  times.erase(times.begin()+idx);
+  interps.erase(interps.begin()+idx);
+  uniform = false;
+}
+
+/**
+  Replace all key times.
+
+  \param n Number of keys
+  \param t Key times (must be sorted in ascending order)
+  \param ip Interpolation mode of all keys
+ */
+void AnimCurveBase::setTimes(int n, const double* t, Interpolation ip)
+{
+  for(int i=1; i<n; i++)
+  {
+    if (t[i]<=t[i-1])
+      throw EValueError("The key times must be in ascending order.");
+  }
+  times.assign(t, t+n);
+  interps.assign(n, (unsigned char)ip);
+  uniform = false;
+  lastseg = 0;
+}
+
+/**
+  Replace all key times with equally spaced times.
+
+  \param t0 Time of the first key
+  \param dt Time step (must be positive)
+  \param n Number of keys
+  \param ip Interpolation mode of all keys
+ */
+void AnimCurveBase::setSampledTimes(double t0, double dt, int n, Interpolation ip)
+{
+  if (dt<=0.0)
+    throw EValueError("The time step must be positive.");
+  times.resize(n);
+  for(int i=0; i<n; i++)
+    times[i] = t0+i*dt;
+  interps.assign(n, (unsigned char)ip);
+  uniform = true;
+  start = t0;
+  invdt = 1.0/dt;
+  lastseg = 0;
+}
+
+void AnimCurveBase::checkIndex(int idx) const
+{
+  if (idx<0 || idx>=int(times.size()))
+    throw EIndexError("Key index out of range.");
+}
+
+//////////////////////////////////////////////////////////////////////
+// AnimCurve
+//////////////////////////////////////////////////////////////////////
+
+/// Return the value of a key.
+double AnimCurve::getValue(int idx) const
+{
+  checkIndex(idx);
+  return values[idx];
+}
+
+/// Return the incoming tangent of a key.
+double AnimCurve::getInTangent(int idx) const
+{
+  checkIndex(idx);
+  return intangents[idx];
+}
+
+/// Return the outgoing tangent of a key.
+double AnimCurve::getOutTangent(int idx) const
+{
+  checkIndex(idx);
+  return outtangents[idx];
+}
+
+/**
+  Remove all keys.
+ */
+void AnimCurve::clear()
+{
+  times.clear();
+  interps.clear();
+  values.clear();
+  intangents.clear();
+  outtangents.clear();
+  uniform = false;
+  lastseg = 0;
+}
+
+/**
+  Insert a key.
+
+  If there is already a key at time t, it is replaced. The tangents of
+  the new key are initialized with the slope of the neighboring keys
+  (the tangents of the neighbors are not modified).
+
+  \param t Key time
+  \param v Key value
+  \param ip Interpolation mode of the segment that starts at the key
+  \return Index of the key
+ */
+int AnimCurve::insertKey(double t, double v, Interpolation ip)
+{
+  bool replaced;
+  int idx = insertTime(t, ip, replaced);
+  if (replaced)
+  {
+    values[idx] = v;
+  }
+  else
+  {
+    values.insert(values.begin()+idx, v);
+    intangents.insert(intangents.begin()+idx, 0.0);
+    outtangents.insert(outtangents.begin()+idx, 0.0);
+  }
+  double m = autoTangent(idx);
+  intangents[idx] = m;
+  outtangents[idx] = m;
+  return idx;
+}
+
+/**
+  Remove a key.
+
+  \param idx Key index
+ */
+void AnimCurve::removeKey(int idx)
+{
+  removeTime(idx);
+  values.erase(values.begin()+idx);
+  intangents.erase(intangents.begin()+idx);
+  outtangents.erase(outtangents.begin()+idx);
+}
+
+/**
+  Replace all keys.
+
+  The values are read from v[0], v[vstride], v[2*vstride], ... so the
+  values can be taken directly from an array that stores several
+  channels per frame. If the interpolation is HERMITE, the tangents are
+  initialized by computeTangents().
+
+  \param n Number of keys
+  \param t Key times (must be sorted in ascending order)
+  \param v Key values
+  \param vstride Distance between two values in the value array
+  \param ip Interpolation mode of all keys
+ */
+void AnimCurve::setKeys(int n, const double* t, const double* v, int vstride, Interpolation ip)
+{
+  setTimes(n, t, ip);
+  values.resize(n);
+  for(int i=0; i<n; i++)
+    values[i] = v[i*vstride];
+  intangents.assign(n, 0.0);
+  outtangents.assign(n, 0.0);
+  if (ip==HERMITE)
+    computeTangents(0, n-1);
+}
+
+/**
+  Replace all keys with equally spaced keys.
+
+  Evaluating a curve with equally spaced keys doesn't require a search.
+
+  \param t0 Time of the first key
+  \param dt Time step between two keys
+  \param n Number of keys
+  \param v Key values
+  \param vstride Distance between two values in the value array
+  \param ip Interpolation mode of all keys
+  \see setKeys()
+ */
+void AnimCurve::setSampledKeys(double t0, double dt, int n, const double* v, int vstride, Interpolation ip)
+{
+  setSampledTimes(t0, dt, n, ip);
+  values.resize(n);
+  for(int i=0; i<n; i++)
+    values[i] = v[i*vstride];
+  intangents.assign(n, 0.0);
+  outtangents.assign(n, 0.0);
+  if (ip==HERMITE)
+    computeTangents(0, n-1);
+}
+
+/**
+  Set the tangents of a key.
+
+  \param idx Key index
+  \param intangent Incoming slope
+  \param outtangent Outgoing slope
+ */
+void AnimCurve::setTangents(int idx, double intangent, double outtangent)
+{
+  checkIndex(idx);
+  intangents[idx] = intangent;
+  outtangents[idx] = outtangent;
+}
+
+/**
+  Turn a segment into a cubic Bezier segment.
+
+  The two inner control points of the segment between key idx and idx+1
+  are located at 1/3 and 2/3 of the segment duration and have the values
+  c1 and c2. The values are converted into the out tangent of key idx
+  and the in tangent of key idx+1 and the segment is set to HERMITE.
+
+  \param idx Index of the first key of the segment
+  \param c1 Value of the first inner control point
+  \param c2 Value of the second inner control point
+ */
+void AnimCurve::setBezierControls(int idx, double c1, double c2)
+{
+  checkIndex(idx);
+  checkIndex(idx+1);
+  double h = times[idx+1]-times[idx];
+  outtangents[idx] = 3.0*(c1-values[idx])/h;
+  intangents[idx+1] = 3.0*(values[idx+1]-c2)/h;
+  interps[idx] = HERMITE;
+}
+
+/**
+  Initialize the tangents of a range of keys.
+
+  The tangent of a key is the slope between its neighbors (Catmull-Rom),
+  the first and last key use the slope of the adjacent segment.
+
+  \param first Index of the first key
+  \param last Index of the last key (inclusive)
+ */
+void AnimCurve::computeTangents(int first, int last)
+{
+  int n = numKeys();
+  if (first<0)
+    first = 0;
+  if (last>n-1)
+    last = n-1;
+  for(int i=first; i<=last; i++)
+  {
+    double m = autoTangent(i);
+    intangents[i] = m;
+    outtangents[i] = m;
+  }
+}
+
+/**
+  Evaluate the curve.
+
+  \param t Time
+  \return Curve value at time t (0 if the curve has no keys)
+ */
+double AnimCurve::eval(double t) const
+{
+  int n = numKeys();
+  if (n==0)
+    return 0.0;
+  double u;
+  int i = locate(t, u);
+  if (i<0)
+    return values[0];
+  if (i>=n-1)
+    return values[n-1];
+
+  switch(interps[i])
+  {
+  case STEP:
+    return values[i];
+  case LINEAR:
+    return values[i] + u*(values[i+1]-values[i]);
+  default:
+    {
+      double h = times[i+1]-times[i];
+      double u2 = u*u;
+      double u3 = u2*u;
+      double h00 = 2*u3-3*u2+1;
+      double h10 = u3-2*u2+u;
+      double h01 = 3*u2-2*u3;
+      double h11 = u3-u2;
+      return h00*values[i] + h10*h*outtangents[i] + h01*values[i+1] + h11*h*intangents[i+1];
+    }
+  }
+}
+
+// Return the Catmull-Rom slope at a key
+double AnimCurve::autoTangent(int idx) const
+{
+  int n = numKeys();
+  if (n<2)
+    return 0.0;
+  int a = (idx>0)? idx-1 : idx;
+  int b = (idx<n-1)? idx+1 : idx;
+  return (values[b]-values[a])/(times[b]-times[a]);
+}
+
+//////////////////////////////////////////////////////////////////////
+// QuatAnimCurve
+//////////////////////////////////////////////////////////////////////
+
+/// Return the value of a key.
+const quatd& QuatAnimCurve::getValue(int idx) const
+{
+  checkIndex(idx);
+  return values[idx];
+}
+
+/**
+  Remove all keys.
+ */
+void QuatAnimCurve::clear()
+{
+  times.clear();
+  interps.clear();
+  values.clear();
+  uniform = false;
+  lastseg = 0;
+}
+
+/**
+  Insert a key.
+
+  If there is already a key at time t, it is replaced.
+
+  \param t Key time
+  \param q Key value (is normalized)
+  \param ip Interpolation mode of the segment that starts at the key
+  \return Index of the key
+ */
+int QuatAnimCurve::insertKey(double t, const quatd& q, Interpolation ip)
+{
+  quatd nq = q.normalize();
+  bool replaced;
+  int idx = insertTime(t, ip, replaced);
+  if (replaced)
+    values[idx] = nq;
+  else
+    values.insert(values.begin()+idx, nq);
+  return idx;
+}
+
+/**
+  Remove a key.
+
+  \param idx Key index
+ */
+void QuatAnimCurve::removeKey(int idx)
+{
+  removeTime(idx);
+  values.erase(values.begin()+idx);
+}
+
+/**
+  Replace all keys.
+
+  \param n Number of keys
+  \param t Key times (must be sorted in ascending order)
+  \param q Key values (are normalized)
+  \param ip Interpolation mode of all keys
+ */
+void QuatAnimCurve::setKeys(int n, const double* t, const quatd* q, Interpolation ip)
+{
+  setTimes(n, t, ip);
+  values.resize(n);
+  for(int i=0; i<n; i++)
+    values[i] = q[i].normalize();
+}
+
+/**
+  Replace all keys with equally spaced keys.
+
+  \param t0 Time of the first key
+  \param dt Time step between two keys
+  \param n Number of keys
+  \param q Key values (are normalized)
+  \param ip Interpolation mode of all keys
+ */
+void QuatAnimCurve::setSampledKeys(double t0, double dt, int n, const quatd* q, Interpolation ip)
+{
+  setSampledTimes(t0, dt, n, ip);
+  values.resize(n);
+  for(int i=0; i<n; i++)
+    values[i] = q[i].normalize();
+}
+
+/**
+  Evaluate the curve.
+
+  \param t Time
+  \return Curve value at time t (the identity if the curve has no keys)
+ */
+quatd QuatAnimCurve::eval(double t) const
+{
+  int n = numKeys();
+  if (n==0)
+    return quatd(1,0,0,0);
+  double u;
+  int i = locate(t, u);
+  if (i<0)
+    return values[0];
+  if (i>=n-1 || interps[i]==STEP)
+    return values[i];
+
+  const quatd& q0 = values[i];
+  quatd q1 = values[i+1];
+  double ca = q0.dot(q1);
+  // Take the shortest path
+  if (ca<0.0)
+  {
+    ca = -ca;
+    q1 = -q1;
+  }
+  // Use linear interpolation if the keys are (almost) identical (this
+  // also avoids calling acos() with a value slightly larger than 1)
+  if (ca>0.9999)
+  {
+    quatd res = q0*(1.0-u) + q1*u;
+    return res.normalize();
+  }
+  return slerp(u, q0, q1, false);
+}
+
+}  // end of namespace
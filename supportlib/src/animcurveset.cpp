@@ -0,0 +1,352 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <math.h>
+#include "animcurveset.h"
+#include "common_exceptions.h"
+
+namespace support3d {
+
+/**
+  Constructor.
+ */
+AnimCurveSet::AnimCurveSet(string aname)
+  : Component(aname),
+    time(0.0, 0),
+    curves(), quatcurves(), channels(),
+    curvevalues(), quatvalues(),
+    evaltime(0.0), valuesvalid(false),
+    modulo(0.0), tscale(1.0), _on_time_event()
+{
+  _on_time_event.init(this, &AnimCurveSet::onTimeChanged);
+  addSlot("time", time);
+  time.addDependent(&_on_time_event);
+}
+
+AnimCurveSet::~AnimCurveSet()
+{
+  time.removeDependent(&_on_time_event);
+}
+
+/**
+  Add a channel.
+
+  The required curves are appended to the curve lists (a VEC3_CHANNEL
+  uses three consecutive scalar curves) and a new output slot is created
+  whose name is the channel name.
+
+  \param name Channel name (which is also the name of the output slot)
+  \param type Channel type
+  \return Channel index
+ */
+int AnimCurveSet::addChannel(const string& name, ChannelType type)
+{
+  if (hasSlot(name))
+    throw EKeyError("Slot \""+name+"\" already exists.");
+
+  int idx = int(channels.size());
+  Channel ch;
+  ch.name = name;
+  ch.type = type;
+  switch(type)
+  {
+  case DOUBLE_CHANNEL:
+    {
+      ch.curve = int(curves.size());
+      curves.resize(curves.size()+1);
+      std::auto_ptr<ISlot> slot(new AnimCurveSlot<double>(this, idx));
+      ch.slot = slot.get();
+      addSlot(name, slot);
+      break;
+    }
+  case VEC3_CHANNEL:
+    {
+      ch.curve = int(curves.size());
+      curves.resize(curves.size()+3);
+      std::auto_ptr<ISlot> slot(new AnimCurveSlot<vec3d>(this, idx));
+      ch.slot = slot.get();
+      addSlot(name, slot);
+      break;
+    }
+  case QUAT_CHANNEL:
+    {
+      ch.curve = int(quatcurves.size());
+      quatcurves.resize(quatcurves.size()+1);
+      std::auto_ptr<ISlot> slot(new AnimCurveSlot<quatd>(this, idx));
+      ch.slot = slot.get();
+      addSlot(name, slot);
+      break;
+    }
+  case MAT3_CHANNEL:
+    {
+      ch.curve = int(quatcurves.size());
+      quatcurves.resize(quatcurves.size()+1);
+      std::auto_ptr<ISlot> slot(new AnimCurveSlot<mat3d>(this, idx));
+      ch.slot = slot.get();
+      addSlot(name, slot);
+      break;
+    }
+  default:
+    throw EValueError("Invalid channel type.");
+  }
+  channels.push_back(ch);
+  valuesvalid = false;
+  return idx;
+}
+
+/**
+  Return the index of a channel.
+
+  \param name Channel name
+  \return Channel index or -1 if there is no channel with the given name.
+ */
+int AnimCurveSet::findChannel(const string& name) const
+{
+  for(unsigned int i=0; i<channels.size(); i++)
+  {
+    if (channels[i].name==name)
+      return int(i);
+  }
+  return -1;
+}
+
+/// Return the name of a channel.
+const string& AnimCurveSet::getChannelName(int idx) const
+{
+  checkChannel(idx);
+  return channels[idx].name;
+}
+
+/// Return the type of a channel.
+AnimCurveSet::ChannelType AnimCurveSet::getChannelType(int idx) const
+{
+  checkChannel(idx);
+  return channels[idx].type;
+}
+
+/**
+  Return the index of the first curve of a channel.
+
+  For QUAT_CHANNEL and MAT3_CHANNEL channels the index refers to the
+  quaternion curves, otherwise to the scalar curves.
+ */
+int AnimCurveSet::getChannelCurve(int idx) const
+{
+  checkChannel(idx);
+  return channels[idx].curve;
+}
+
+/// Return the output slot of a channel.
+ISlot& AnimCurveSet::getChannelSlot(int idx) const
+{
+  checkChannel(idx);
+  return *channels[idx].slot;
+}
+
+/**
+  Return a scalar curve.
+
+  curvesChanged() has to be called after the curve was modified.
+ */
+AnimCurve& AnimCurveSet::curve(int idx)
+{
+  if (idx<0 || idx>=int(curves.size()))
+    throw EIndexError("Curve index out of range.");
+  return curves[idx];
+}
+
+/**
+  Return a quaternion curve.
+
+  curvesChanged() has to be called after the curve was modified.
+ */
+QuatAnimCurve& AnimCurveSet::quatCurve(int idx)
+{
+  if (idx<0 || idx>=int(quatcurves.size()))
+    throw EIndexError("Quaternion curve index out of range.");
+  return quatcurves[idx];
+}
+
+/**
+  Notify the component that curves have been modified.
+
+  This invalidates all output slots.
+ */
+void AnimCurveSet::curvesChanged()
+{
+  valuesvalid = false;
+  for(unsigned int i=0; i<channels.size(); i++)
+  {
+    channels[i].slot->onValueChanged();
+  }
+}
+
+/**
+  Set the loop duration.
+
+  \param m Loop duration (0 disables looping)
+ */
+void AnimCurveSet::setModulo(double m)
+{
+  if (m<0.0)
+    throw EValueError("The modulo value must not be negative.");
+  modulo = m;
+  curvesChanged();
+}
+
+/**
+  Set the time scale.
+
+  \param s Time scale (a value of less than 1 makes the animation slower)
+ */
+void AnimCurveSet::setTScale(double s)
+{
+  tscale = s;
+  curvesChanged();
+}
+
+/**
+  Convert a global time into the time that is used for evaluating the curves.
+
+  \param t Time (value of the time slot)
+  \return Curve time
+ */
+double AnimCurveSet::localTime(double t) const
+{
+  t *= tscale;
+  if (modulo>0.0)
+  {
+    t = fmod(t, modulo);
+    if (t<0.0)
+      t += modulo;
+  }
+  return t;
+}
+
+/**
+  Evaluate all curves.
+
+  \param t Curve time (localTime() is not applied)
+  \param[out] values Receives the values of the scalar curves (numCurves() values)
+  \param[out] quats Receives the values of the quaternion curves (numQuatCurves() values)
+ */
+void AnimCurveSet::evaluate(double t, double* values, quatd* quats) const
+{
+  int n = int(curves.size());
+  int i;
+#ifdef _OPENMP
+  #pragma omp parallel for if(n>=256)
+#endif
+  for(i=0; i<n; i++)
+  {
+    values[i] = curves[i].eval(t);
+  }
+
+  n = int(quatcurves.size());
+#ifdef _OPENMP
+  #pragma omp parallel for if(n>=256)
+#endif
+  for(i=0; i<n; i++)
+  {
+    quats[i] = quatcurves[i].eval(t);
+  }
+}
+
+/// Return the value of a DOUBLE_CHANNEL channel.
+void AnimCurveSet::getChannelValue(int idx, double& v)
+{
+  update();
+  v = curvevalues[channels[idx].curve];
+}
+
+/// Return the value of a VEC3_CHANNEL channel.
+void AnimCurveSet::getChannelValue(int idx, vec3d& v)
+{
+  update();
+  int c = channels[idx].curve;
+  v.set(curvevalues[c], curvevalues[c+1], curvevalues[c+2]);
+}
+
+/// Return the value of a QUAT_CHANNEL channel.
+void AnimCurveSet::getChannelValue(int idx, quatd& v)
+{
+  update();
+  v = quatvalues[channels[idx].curve];
+}
+
+/// Return the value of a MAT3_CHANNEL channel.
+void AnimCurveSet::getChannelValue(int idx, mat3d& v)
+{
+  update();
+  quatvalues[channels[idx].curve].toMat3(v);
+}
+
+/**
+  Invalidate all output slots when the time has changed.
+
+  The time slot only has this one dependent instead of every output
+  slot, so adding a channel doesn't have to search the dependents.
+ */
+void AnimCurveSet::onTimeChanged()
+{
+  for(unsigned int i=0; i<channels.size(); i++)
+  {
+    channels[i].slot->onValueChanged();
+  }
+}
+
+/**
+  Evaluate all curves at the current time if this hasn't been done yet.
+ */
+void AnimCurveSet::update()
+{
+  double t = time.getValue();
+  if (valuesvalid && t==evaltime)
+    return;
+
+  curvevalues.resize(curves.size());
+  quatvalues.resize(quatcurves.size());
+  evaluate(localTime(t), curvevalues.empty()? 0 : &curvevalues[0], quatvalues.empty()? 0 : &quatvalues[0]);
+  evaltime = t;
+  valuesvalid = true;
+}
+
+void AnimCurveSet::checkChannel(int idx) const
+{
+  if (idx<0 || idx>=int(channels.size()))
+    throw EIndexError("Channel index out of range.");
+}
+
+}  // end of namespace
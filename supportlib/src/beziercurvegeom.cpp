@@ -0,0 +1,711 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <math.h>
+#include <algorithm>
+#include "beziercurvegeom.h"
+#include "fixedsizeconstraints.h"
+#include "common_exceptions.h"
+
+#include "opengl.h"
+
+namespace support3d {
+
+// Abscissas and weights of the 5-point Gauss-Legendre rule on [-1,1]
+static const double gl_x[5] = {-0.9061798459386640, -0.5384693101056831, 0.0,
+                               0.5384693101056831, 0.9061798459386640};
+static const double gl_w[5] = {0.2369268850561891, 0.4786286704993665, 0.5688888888888889,
+                               0.4786286704993665, 0.2369268850561891};
+
+// Return the squared length of a vector
+static inline double sqrLen(const vec3d& v)
+{
+  return v*v;
+}
+
+// Evaluate a segment using the de Casteljau scheme
+static inline vec3d segEval(const vec3d* b, double t)
+{
+  double _t = 1.0-t;
+  vec3d c0 = _t*b[0] + t*b[1];
+  vec3d c1 = _t*b[1] + t*b[2];
+  vec3d c2 = _t*b[2] + t*b[3];
+  vec3d d0 = _t*c0 + t*c1;
+  vec3d d1 = _t*c1 + t*c2;
+  return _t*d0 + t*d1;
+}
+
+// Evaluate a segment and its 1st and 2nd derivative
+static inline void segEvalFrame(const vec3d* b, double t, vec3d& p, vec3d& dp, vec3d& d2p)
+{
+  double _t = 1.0-t;
+  vec3d c0 = _t*b[0] + t*b[1];
+  vec3d c1 = _t*b[1] + t*b[2];
+  vec3d c2 = _t*b[2] + t*b[3];
+  vec3d d0 = _t*c0 + t*c1;
+  vec3d d1 = _t*c1 + t*c2;
+  p = _t*d0 + t*d1;
+  dp = 3.0*(d1-d0);
+  d2p = 6.0*(c2-2.0*c1+c0);
+}
+
+// Return the derivative of a segment
+static inline vec3d segDeriv(const vec3d* b, double t)
+{
+  double _t = 1.0-t;
+  vec3d c0 = _t*b[0] + t*b[1];
+  vec3d c1 = _t*b[1] + t*b[2];
+  vec3d c2 = _t*b[2] + t*b[3];
+  return 3.0*((_t*c1 + t*c2) - (_t*c0 + t*c1));
+}
+
+// Integrate the speed of a segment between the parameters t0 and t1
+static double segIntegrate(const vec3d* b, double t0, double t1)
+{
+  double h = 0.5*(t1-t0);
+  double m = 0.5*(t0+t1);
+  double res = 0.0;
+  for(int i=0; i<5; i++)
+  {
+    res += gl_w[i]*segDeriv(b, m+h*gl_x[i]).length();
+  }
+  return h*res;
+}
+
+/*
+  Check if a segment is straight.
+
+  A segment is straight if the inner control points lie on the line
+  between the end points and if they are in monotone order (then the
+  curve never reverses its direction).
+ */
+static bool segIsStraight(const vec3d* b)
+{
+  vec3d d = b[3]-b[0];
+  double l2 = d*d;
+  if (l2==0.0)
+    return (b[1]==b[0] && b[2]==b[0]);
+  vec3d e1 = b[1]-b[0];
+  vec3d e2 = b[2]-b[0];
+  double eps2 = 1E-24*l2;
+  if (sqrLen(e1^d)>eps2*(e1*e1) || sqrLen(e2^d)>eps2*(e2*e2))
+    return false;
+  double u1 = e1*d;
+  double u2 = e2*d;
+  return (u1>=0.0 && u1<=u2 && u2<=l2);
+}
+
+// Split a segment at t=0.5
+static inline void segSplit(const vec3d* b, vec3d* l, vec3d* r)
+{
+  vec3d c0 = 0.5*(b[0]+b[1]);
+  vec3d c1 = 0.5*(b[1]+b[2]);
+  vec3d c2 = 0.5*(b[2]+b[3]);
+  vec3d d0 = 0.5*(c0+c1);
+  vec3d d1 = 0.5*(c1+c2);
+  vec3d e0 = 0.5*(d0+d1);
+  l[0] = b[0]; l[1] = c0; l[2] = d0; l[3] = e0;
+  r[0] = e0; r[1] = d1; r[2] = c2; r[3] = b[3];
+}
+
+// Return the squared distance of p from the line through a and b
+static inline double sqrLineDist(const vec3d& p, const vec3d& a, const vec3d& b)
+{
+  vec3d d = b-a;
+  vec3d e = p-a;
+  double l2 = d*d;
+  if (l2==0.0)
+    return e*e;
+  return sqrLen(e^d)/l2;
+}
+
+/*
+  Flatten a segment and append the end points of the line pieces to res.
+
+  The segment is subdivided until the inner control points are within
+  tol of the chord (the curve lies within the convex hull of the control
+  points, so this bounds the deviation of the line strip from the curve).
+ */
+static void segFlatten(const vec3d* b, double tol2, int depth, std::vector<vec3d>& res)
+{
+  if (depth<=0 || (sqrLineDist(b[1], b[0], b[3])<=tol2 && sqrLineDist(b[2], b[0], b[3])<=tol2))
+  {
+    res.push_back(b[3]);
+    return;
+  }
+  vec3d l[4];
+  vec3d r[4];
+  segSplit(b, l, r);
+  segFlatten(l, tol2, depth-1, res);
+  segFlatten(r, tol2, depth-1, res);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+BezierCurveGeom::BezierCurveGeom()
+: _on_curve_event(),
+  pnts(),
+  varyingSizeConstraint(new LinearSizeConstraint(pnts,1,0)),
+  vertexSizeConstraint(new LinearSizeConstraint(pnts,3,-2)),
+  intangents(1, varyingSizeConstraint),
+  outtangents(1, varyingSizeConstraint),
+  epsilon(0.01), subdiv(4), show_tangents(false),
+  closed(false), arclen_valid(false),
+  seglengths(), arclentable(), straightsegs()
+{
+  _on_curve_event.init(this, &BezierCurveGeom::onCurveChanged, &BezierCurveGeom::onCurveResize);
+  pnts.addDependent(&_on_curve_event);
+  intangents.addDependent(&_on_curve_event);
+  outtangents.addDependent(&_on_curve_event);
+
+  addSlot("pnts", pnts);
+  addSlot("intangents", intangents);
+  addSlot("outtangents", outtangents);
+}
+
+/**
+  Return the bounding box of the curve.
+
+  The box encloses the control points of all segments. As every segment
+  lies within the convex hull of its control points, the box also
+  encloses the curve. Tangents that don't belong to any segment (the
+  incoming tangent of the first point and the outgoing tangent of the
+  last point of an open curve) are ignored.
+ */
+BoundingBox BezierCurveGeom::boundingBox()
+{
+  BoundingBox bb;
+  int ns = numSegs();
+  vec3d b[4];
+  if (ns==0 && pnts.size()>0)
+    bb.addPoint(pnts.getValue(0));
+  for(int i=0; i<ns; i++)
+  {
+    segCtrlPoints(i, b);
+    for(int j=0; j<4; j++)
+      bb.addPoint(b[j]);
+  }
+  return bb;
+}
+
+/**
+  Draw the curve.
+
+  Each segment is flattened with a tolerance of \a epsilon, but it is
+  subdivided at most \a subdiv times (i.e. a segment is drawn with at
+  most 2^subdiv lines).
+ */
+void BezierCurveGeom::drawGL()
+{
+  int size = pnts.size();
+  if (size==0)
+    return;
+
+  std::vector<vec3d> strip;
+  flatten(epsilon, strip, subdiv);
+
+  glPushAttrib(GL_LIGHTING_BIT);
+  glDisable(GL_LIGHTING);
+  glColor3f(1,1,1);
+
+  glBegin(GL_LINE_STRIP);
+  for(unsigned int i=0; i<strip.size(); i++)
+  {
+    const vec3d& v = strip[i];
+    glVertex3d(v.x, v.y, v.z);
+  }
+  glEnd();
+
+  // Draw the in and out tangents...
+  if (show_tangents)
+  {
+    glBegin(GL_LINES);
+    for(int i=0; i<size; i++)
+    {
+      const vec3d& p = pnts.getValue(i);
+      vec3d pin = p+intangents.getValue(i);
+      vec3d pout = p+outtangents.getValue(i);
+      glColor3f(0,1,0);
+      glVertex3d(pin.x, pin.y, pin.z);
+      glVertex3d(p.x, p.y, p.z);
+      glColor3f(0,0,1);
+      glVertex3d(p.x, p.y, p.z);
+      glVertex3d(pout.x, pout.y, pout.z);
+    }
+    glEnd();
+  }
+
+  glPopAttrib();
+}
+
+// slotSizeConstraint
+boost::shared_ptr<SizeConstraintBase> BezierCurveGeom::slotSizeConstraint(VarStorage storage) const
+{
+  switch(storage)
+  {
+  case UNIFORM:
+    return sizeConstraint_one;
+  case VARYING:
+    return varyingSizeConstraint;
+  case VERTEX:
+    return vertexSizeConstraint;
+  default:
+    return sizeConstraint_zero;
+  }
+}
+
+/**
+  Open or close the curve.
+
+  The size of vertex variables changes accordingly (a closed curve has
+  two more control points than an open one).
+ */
+void BezierCurveGeom::setClosed(bool c)
+{
+  if (c==closed)
+    return;
+  // This may throw an exception (then the curve remains unchanged)
+  vertexSizeConstraint->setCoeffs(3, c? 0 : -2);
+  closed = c;
+  arclen_valid = false;
+}
+
+/**
+  Return the number of segments.
+ */
+int BezierCurveGeom::numSegs() const
+{
+  int size = pnts.size();
+  if (size==0)
+    return 0;
+  return closed? size : size-1;
+}
+
+/**
+  Return the four control points of a segment.
+
+  The segment numbering is cyclic, i.e. \a seg may be any integer.
+
+  \pre The curve has at least one point
+  \param seg Segment number
+  \param[out] b Receives the control points (must have room for 4 points)
+ */
+void BezierCurveGeom::segCtrlPoints(int seg, vec3d* b)
+{
+  int size = pnts.size();
+  int i = seg%size;
+  if (i<0)
+    i += size;
+  int j = (i+1)%size;
+  const vec3d* P = pnts.dataPtr();
+  b[0] = P[i];
+  b[1] = P[i]+outtangents.dataPtr()[i];
+  b[3] = P[j];
+  b[2] = P[j]+intangents.dataPtr()[j];
+}
+
+/**
+  Split a curve parameter into segment number and segment parameter.
+
+  The segment number is the integer part of \a t (truncated towards 0),
+  the segment parameter the fractional part in [0,1).
+ */
+int BezierCurveGeom::splitParam(double t, double& u)
+{
+  u = t-floor(t);
+  return int(t);
+}
+
+/**
+  Evaluate the curve at parameter t and return the curve point.
+ */
+vec3d BezierCurveGeom::eval(double t)
+{
+  if (pnts.size()==0)
+    throw EValueError("The curve has no points.");
+  vec3d b[4];
+  double u;
+  segCtrlPoints(splitParam(t, u), b);
+  return segEval(b, u);
+}
+
+/**
+  Evaluate the curve at parameter t and return the point and its 1st and 2nd derivative.
+ */
+void BezierCurveGeom::evalFrame(double t, vec3d& p, vec3d& dp, vec3d& d2p)
+{
+  if (pnts.size()==0)
+    throw EValueError("The curve has no points.");
+  vec3d b[4];
+  double u;
+  segCtrlPoints(splitParam(t, u), b);
+  segEvalFrame(b, u, p, dp, d2p);
+}
+
+/**
+  Return the 1st derivative at parameter t.
+ */
+vec3d BezierCurveGeom::deriv(double t)
+{
+  if (pnts.size()==0)
+    throw EValueError("The curve has no points.");
+  vec3d b[4];
+  double u;
+  segCtrlPoints(splitParam(t, u), b);
+  return segDeriv(b, u);
+}
+
+/**
+  Evaluate the curve at n parameter values.
+
+  \param t Parameter values (n values)
+  \param n Number of values
+  \param[out] res Receives the curve points (n values)
+ */
+void BezierCurveGeom::eval(const double* t, int n, vec3d* res)
+{
+  if (pnts.size()==0)
+    throw EValueError("The curve has no points.");
+  int i;
+#ifdef _OPENMP
+  #pragma omp parallel for if(n>=256)
+#endif
+  for(i=0; i<n; i++)
+  {
+    vec3d b[4];
+    double u;
+    segCtrlPoints(splitParam(t[i], u), b);
+    res[i] = segEval(b, u);
+  }
+}
+
+/**
+  Evaluate the curve and its 1st and 2nd derivative at n parameter values.
+
+  \param t Parameter values (n values)
+  \param n Number of values
+  \param[out] p Receives the curve points (n values)
+  \param[out] dp Receives the 1st derivatives (n values)
+  \param[out] d2p Receives the 2nd derivatives (n values)
+ */
+void BezierCurveGeom::evalFrame(const double* t, int n, vec3d* p, vec3d* dp, vec3d* d2p)
+{
+  if (pnts.size()==0)
+    throw EValueError("The curve has no points.");
+  int i;
+#ifdef _OPENMP
+  #pragma omp parallel for if(n>=256)
+#endif
+  for(i=0; i<n; i++)
+  {
+    vec3d b[4];
+    double u;
+    segCtrlPoints(splitParam(t[i], u), b);
+    segEvalFrame(b, u, p[i], dp[i], d2p[i]);
+  }
+}
+
+/**
+  Return the arc length from the beginning of the curve up to parameter t.
+
+  t is clamped to the parameter interval.
+ */
+double BezierCurveGeom::arcLen(double t)
+{
+  if (!arclen_valid)
+    updateArcLen();
+
+  int ns = numSegs();
+  if (ns==0 || t<=0.0)
+    return 0.0;
+  double u;
+  int seg = splitParam(t, u);
+  if (seg>=ns)
+    return seglengths[ns];
+
+  vec3d b[4];
+  segCtrlPoints(seg, b);
+  return seglengths[seg] + segArcLen(seg, b, u);
+}
+
+/**
+  Return the length of the entire curve.
+ */
+double BezierCurveGeom::length()
+{
+  if (!arclen_valid)
+    updateArcLen();
+  return seglengths.back();
+}
+
+/**
+  Return the curve parameter where the arc length reaches s.
+
+  This is the inverse of arcLen(). s is clamped to [0, length()].
+ */
+double BezierCurveGeom::arcLenToParam(double s)
+{
+  if (!arclen_valid)
+    updateArcLen();
+  return lookupParam(s);
+}
+
+/**
+  Convert n arc length values into curve parameters.
+
+  \param s Arc length values (n values)
+  \param n Number of values
+  \param[out] t Receives the curve parameters (n values)
+  \see arcLenToParam(double)
+ */
+void BezierCurveGeom::arcLenToParam(const double* s, int n, double* t)
+{
+  if (!arclen_valid)
+    updateArcLen();
+  int i;
+#ifdef _OPENMP
+  #pragma omp parallel for if(n>=256)
+#endif
+  for(i=0; i<n; i++)
+  {
+    t[i] = lookupParam(s[i]);
+  }
+}
+
+/**
+  Flatten the curve into a line strip.
+
+  Every segment is recursively subdivided until its control points
+  deviate at most \a tol from the chord (or until the maximum depth
+  is reached). Straight parts of the curve are therefore represented by
+  a single line whereas curved parts receive more points. The result
+  contains the first point of the curve followed by the end points of
+  all line pieces (a closed curve ends with its first point again).
+
+  \param tol Tolerance (a value <=0 always subdivides up to the maximum depth)
+  \param[out] res Receives the points
+  \param maxdepth Maximum number of subdivisions per segment
+ */
+void BezierCurveGeom::flatten(double tol, std::vector<vec3d>& res, int maxdepth)
+{
+  res.clear();
+  int ns = numSegs();
+  if (pnts.size()==0)
+    return;
+  res.push_back(pnts.getValue(0));
+  double tol2 = (tol>0.0)? tol*tol : -1.0;
+  vec3d b[4];
+  for(int i=0; i<ns; i++)
+  {
+    segCtrlPoints(i, b);
+    segFlatten(b, tol2, maxdepth, res);
+  }
+}
+
+/**
+  This method is called whenever a point or tangent is modified.
+ */
+void BezierCurveGeom::onCurveChanged(int, int)
+{
+  arclen_valid = false;
+}
+
+/**
+  This method is called whenever the number of points is modified.
+ */
+void BezierCurveGeom::onCurveResize(int)
+{
+  arclen_valid = false;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+/**
+  Rebuild the arc length table.
+ */
+void BezierCurveGeom::updateArcLen()
+{
+  const int K = ARCLEN_SAMPLES;
+  int ns = numSegs();
+  seglengths.resize(ns+1);
+  arclentable.resize(ns*(K+1));
+  straightsegs.resize(ns);
+
+  seglengths[0] = 0.0;
+  vec3d b[4];
+  for(int i=0; i<ns; i++)
+  {
+    segCtrlPoints(i, b);
+    double* T = &arclentable[i*(K+1)];
+    bool straight = segIsStraight(b);
+    straightsegs[i] = straight;
+    T[0] = 0.0;
+    if (straight)
+    {
+      // The arc length is the distance from the start point
+      double chord = (b[3]-b[0]).length();
+      for(int k=1; k<K; k++)
+      {
+        T[k] = std::min(std::max((segEval(b, double(k)/K)-b[0]).length(), T[k-1]), chord);
+      }
+      T[K] = chord;
+    }
+    else
+    {
+      for(int k=0; k<K; k++)
+      {
+        T[k+1] = T[k] + segIntegrate(b, double(k)/K, double(k+1)/K);
+      }
+    }
+    seglengths[i+1] = seglengths[i] + T[K];
+  }
+  arclen_valid = true;
+}
+
+/**
+  Return the arc length of a segment from its start up to parameter u.
+
+  \pre The arc length table is valid
+  \param seg Segment number (0..numSegs()-1)
+  \param b The control points of the segment
+  \param u Segment parameter (0..1)
+ */
+double BezierCurveGeom::segArcLen(int seg, const vec3d* b, double u)
+{
+  const int K = ARCLEN_SAMPLES;
+  const double* T = &arclentable[seg*(K+1)];
+  if (straightsegs[seg])
+  {
+    return std::min((segEval(b, u)-b[0]).length(), T[K]);
+  }
+  int k = int(u*K);
+  if (k>=K)
+    return T[K];
+  return T[k] + segIntegrate(b, double(k)/K, u);
+}
+
+/**
+  Return the segment parameter where the arc length of a segment reaches s.
+
+  The table determines the interval that contains the solution which
+  is then refined by Newton iterations (falling back to bisection
+  whenever a Newton step leaves the interval).
+
+  \pre The arc length table is valid
+  \param seg Segment number (0..numSegs()-1)
+  \param b The control points of the segment
+  \param s Arc length relative to the segment start (0..segment length)
+ */
+double BezierCurveGeom::segParam(int seg, const vec3d* b, double s)
+{
+  const int K = ARCLEN_SAMPLES;
+  const double* T = &arclentable[seg*(K+1)];
+  int k = int(std::upper_bound(T, T+K+1, s) - T) - 1;
+  if (k<0)
+    k = 0;
+  if (k>=K)
+    return 1.0;
+  double lo = double(k)/K;
+  double hi = double(k+1)/K;
+  double ds = T[k+1]-T[k];
+  if (ds<=0.0)
+    return lo;
+
+  // Initial guess: Hermite interpolation of the inverse function (its
+  // derivative is the reciprocal of the speed)
+  double h = hi-lo;
+  double x = (s-T[k])/ds;
+  double u = lo + h*x;
+  double v0 = segDeriv(b, lo).length();
+  double v1 = segDeriv(b, hi).length();
+  if (v0*h>1E-3*ds && v1*h>1E-3*ds)
+  {
+    double m0 = ds/(v0*h);
+    double m1 = ds/(v1*h);
+    double x2 = x*x;
+    double x3 = x2*x;
+    double un = lo + h*((x3-2*x2+x)*m0 + (3*x2-2*x3) + (x3-x2)*m1);
+    if (un>lo && un<hi)
+      u = un;
+  }
+
+  double eps = 1E-12*(1.0+T[K]);
+  for(int i=0; i<50; i++)
+  {
+    double f = segArcLen(seg, b, u) - s;
+    if (fabs(f)<=eps)
+      break;
+    if (f<0.0)
+      lo = u;
+    else
+      hi = u;
+    if (hi-lo<=1E-15)
+      break;
+    double d = segDeriv(b, u).length();
+    double un = (d>0.0)? u-f/d : lo;
+    if (un<=lo || un>=hi)
+      un = 0.5*(lo+hi);
+    // Newton converges quadratically, so a tiny step means we're done
+    else if (fabs(un-u)<=1E-12)
+      return un;
+    u = un;
+  }
+  return u;
+}
+
+/**
+  Return the curve parameter where the arc length reaches s.
+
+  \pre The arc length table is valid
+ */
+double BezierCurveGeom::lookupParam(double s)
+{
+  int ns = numSegs();
+  if (ns==0 || s<=0.0)
+    return 0.0;
+  if (s>=seglengths[ns])
+    return double(ns);
+
+  int seg = int(std::upper_bound(seglengths.begin(), seglengths.end(), s) - seglengths.begin()) - 1;
+  if (seg<0)
+    seg = 0;
+  if (seg>=ns)
+    seg = ns-1;
+  vec3d b[4];
+  segCtrlPoints(seg, b);
+  return seg + segParam(seg, b, s-seglengths[seg]);
+}
+
+}  // end of namespace
@@ -45,12 +45,20 @@ BoxGeom::BoxGeom(double alx, double aly, double alz, int segsx, int segsy, int s
 : lx(alx,0), ly(aly,0), lz(alz,0),
   segmentsx(segsx,0), segmentsy(segsy,0), segmentsz(segsz, 0),
   cog(vec3d(0,0,0), Slot<vec3d>::NO_INPUT_CONNECTIONS),
-  inertiatensor()
+  inertiatensor(),
+  _on_param_event(), tesscache()
 {
   inertiatensor.setProcedure(this, &BoxGeom::computeInertiaTensor);
   lx.addDependent(&inertiatensor);
   ly.addDependent(&inertiatensor);
   lz.addDependent(&inertiatensor);
+  _on_param_event.init(this, &BoxGeom::onParamChanged);
+  lx.addDependent(&_on_param_event);
+  ly.addDependent(&_on_param_event);
+  lz.addDependent(&_on_param_event);
+  segmentsx.addDependent(&_on_param_event);
+  segmentsy.addDependent(&_on_param_event);
+  segmentsz.addDependent(&_on_param_event);
 
   addSlot("lx", lx);
   addSlot("ly", ly);
@@ -67,6 +75,12 @@ BoxGeom::~BoxGeom()
   lx.removeDependent(&inertiatensor);
   ly.removeDependent(&inertiatensor);
   lz.removeDependent(&inertiatensor);
+  lx.removeDependent(&_on_param_event);
+  ly.removeDependent(&_on_param_event);
+  lz.removeDependent(&_on_param_event);
+  segmentsx.removeDependent(&_on_param_event);
+  segmentsy.removeDependent(&_on_param_event);
+  segmentsz.removeDependent(&_on_param_event);
 }
 
 BoundingBox BoxGeom::boundingBox()
@@ -79,6 +93,26 @@ BoundingBox BoxGeom::boundingBox()
 }
 
 void BoxGeom::drawGL()
+{
+  if (!tesscache.isValid())
+    tessellate();
+  tesscache.drawGL();
+}
+
+/**
+  Invalidate the tessellation cache.
+
+  This is called whenever one of the parameter slots has changed.
+ */
+void BoxGeom::onParamChanged()
+{
+  tesscache.invalidate();
+}
+
+/**
+  Store the quad strips of the box sides in the tessellation cache.
+ */
+void BoxGeom::tessellate()
 {
   double lenx = lx.getValue();
   double leny = ly.getValue();
@@ -92,9 +126,9 @@ void BoxGeom::drawGL()
   double a,b, x1,y1,y2,z1,z2, u,v1,v2;
   int i,j;
 
-  glPushMatrix();
+  tesscache.clear();
 
-  // Draw the first 4 sides around Z...
+  // The first 4 sides around Z...
   for(j=0; j<segsz; j++)
   {
     a = double(j)/segsz;
@@ -104,64 +138,48 @@ void BoxGeom::drawGL()
     v1 = a;
     v2 = b;
 
-    // Draw side XZ at -Y
-    glBegin(GL_QUAD_STRIP);
-    glNormal3f(0,0,-1.0f);
+    // Side XZ at -Y
+    tesscache.beginStrip();
     for(i=0; i<=segsx; i++)
     {
       u = double(i)/segsx;
       x1 = (u-1.0)*lenx2 + u*lenx2;
-      glTexCoord2d(u,v2);
-      glVertex3d(x1, -leny2, z2);
-      glTexCoord2d(u,v1);
-      glVertex3d(x1, -leny2, z1);
+      tesscache.addVertex(x1, -leny2, z2, 0, -1.0, 0, u, v2);
+      tesscache.addVertex(x1, -leny2, z1, 0, -1.0, 0, u, v1);
     }
-    glEnd();
 
-    // Draw side YZ at X
-    glBegin(GL_QUAD_STRIP);
-    glNormal3f(1.0f,0,0);
+    // Side YZ at X
+    tesscache.beginStrip();
     for(i=0; i<=segsy; i++)
     {
       u = double(i)/segsy;
       y1 = (u-1.0)*leny2 + u*leny2;
-      glTexCoord2d(u,v2);
-      glVertex3d(lenx2, y1, z2);
-      glTexCoord2d(u,v1);
-      glVertex3d(lenx2, y1, z1);
+      tesscache.addVertex(lenx2, y1, z2, 1.0, 0, 0, u, v2);
+      tesscache.addVertex(lenx2, y1, z1, 1.0, 0, 0, u, v1);
     }
-    glEnd();
 
-    // Draw side XZ at Y
-    glBegin(GL_QUAD_STRIP);
-    glNormal3f(0,1.0f,0);
+    // Side XZ at Y
+    tesscache.beginStrip();
     for(i=0; i<=segsx; i++)
     {
       u = double(i)/segsx;
       x1 = (1.0-u)*lenx2 - u*lenx2;
-      glTexCoord2d(u,v2);
-      glVertex3d(x1, leny2, z2);
-      glTexCoord2d(u,v1);
-      glVertex3d(x1, leny2, z1);
+      tesscache.addVertex(x1, leny2, z2, 0, 1.0, 0, u, v2);
+      tesscache.addVertex(x1, leny2, z1, 0, 1.0, 0, u, v1);
     }
-    glEnd();
 
-    // Draw side YZ at -X
-    glBegin(GL_QUAD_STRIP);
-    glNormal3f(-1.0f,0,0);
+    // Side YZ at -X
+    tesscache.beginStrip();
     for(i=0; i<=segsy; i++)
     {
       u = double(i)/segsy;
       y1 = (1.0-u)*leny2 - u*leny2;
-      glTexCoord2d(u,v2);
-      glVertex3d(-lenx2, y1, z2);
-      glTexCoord2d(u,v1);
-      glVertex3d(-lenx2, y1, z1);
+      tesscache.addVertex(-lenx2, y1, z2, -1.0, 0, 0, u, v2);
+      tesscache.addVertex(-lenx2, y1, z1, -1.0, 0, 0, u, v1);
     }
-    glEnd();
   }
 
-  // Draw the "top" (XY side at Z)...
+  // The "top" (XY side at Z)...
   for(j=0; j<segsy; j++)
   {
     a = double(j)/segsy;
@@ -170,21 +188,17 @@ void BoxGeom::drawGL()
     y2 = (b-1.0)*leny2 + b*leny2;
     v1 = a;
     v2 = b;
-    glBegin(GL_QUAD_STRIP);
-    glNormal3f(0,0,1.0f);
+    tesscache.beginStrip();
     for(i=0; i<=segsx; i++)
     {
       u = double(i)/segsx;
       x1 = (u-1.0)*lenx2 + u*lenx2;
-      glTexCoord2d(u,v2);
-      glVertex3d(x1, y2, lenz2);
-      glTexCoord2d(u,v1);
-      glVertex3d(x1, y1, lenz2);
+      tesscache.addVertex(x1, y2, lenz2, 0, 0, 1.0, u, v2);
+      tesscache.addVertex(x1, y1, lenz2, 0, 0, 1.0, u, v1);
     }
-    glEnd();
   }
 
-  // Draw the "bottom" (XY side at -Z)...
+  // The "bottom" (XY side at -Z)...
   for(j=0; j<segsy; j++)
   {
     a = double(j)/segsy;
@@ -193,21 +207,17 @@ void BoxGeom::drawGL()
     y2 = (1.0-b)*leny2 - b*leny2;
     v1 = a;
     v2 = b;
-    glBegin(GL_QUAD_STRIP);
-    glNormal3f(0,0,-1.0f);
+    tesscache.beginStrip();
     for(i=0; i<=segsx; i++)
     {
       u = double(i)/segsx;
       x1 = (u-1.0)*lenx2 + u*lenx2;
-      glTexCoord2d(u,v2);
-      glVertex3d(x1, y2, -lenz2);
-      glTexCoord2d(u,v1);
-      glVertex3d(x1, y1, -lenz2);
+      tesscache.addVertex(x1, y2, -lenz2, 0, 0, -1.0, u, v2);
+      tesscache.addVertex(x1, y1, -lenz2, 0, 0, -1.0, u, v1);
     }
-    glEnd();
   }
 
-  glPopMatrix();
+  tesscache.finish();
 }
 
 // slotSizeConstraint
@@ -45,11 +45,18 @@ CCylinderGeom::CCylinderGeom(double aradius, double alength, int segsu, int segs
 : radius(aradius,0), length(alength,0),
   segmentsu(segsu,0), segmentsvl(segsvl,0), segmentsvr(segsvr,0),
   cog(vec3d(0,0,0), Slot<vec3d>::NO_INPUT_CONNECTIONS),
-  inertiatensor()
+  inertiatensor(),
+  _on_param_event(), tesscache()
 {
   inertiatensor.setProcedure(this, &CCylinderGeom::computeInertiaTensor);
   radius.addDependent(&inertiatensor);
   length.addDependent(&inertiatensor);
+  _on_param_event.init(this, &CCylinderGeom::onParamChanged);
+  radius.addDependent(&_on_param_event);
+  length.addDependent(&_on_param_event);
+  segmentsu.addDependent(&_on_param_event);
+  segmentsvl.addDependent(&_on_param_event);
+  segmentsvr.addDependent(&_on_param_event);
   addSlot("radius", radius);
   addSlot("length", length);
   addSlot("cog", cog);
@@ -63,6 +70,11 @@ CCylinderGeom::~CCylinderGeom()
 {
   radius.removeDependent(&inertiatensor);
   length.removeDependent(&inertiatensor);
+  radius.removeDependent(&_on_param_event);
+  length.removeDependent(&_on_param_event);
+  segmentsu.removeDependent(&_on_param_event);
+  segmentsvl.removeDependent(&_on_param_event);
+  segmentsvr.removeDependent(&_on_param_event);
 }
 
 BoundingBox CCylinderGeom::boundingBox()
@@ -75,15 +87,29 @@ BoundingBox CCylinderGeom::boundingBox()
 
 void CCylinderGeom::drawGL()
 {
-  SORTriangulator sor;
-  SORTriangulator::SORVertexList vlist;
-  int segsu = segmentsu.getValue();
+  if (!tesscache.isValid())
+  {
+    SORTriangulator sor;
+    SORTriangulator::SORVertexList vlist;
+    int segsu = segmentsu.getValue();
 
-  if (segsu<3)
-    segsu=3;
+    if (segsu<3)
+      segsu=3;
 
-  createSilhouette(vlist);
-  sor.drawGL(0.0, 360.0, segsu, vlist);
+    createSilhouette(vlist);
+    sor.tessellate(0.0, 360.0, segsu, vlist, tesscache);
+  }
+  tesscache.drawGL();
+}
+
+/**
+  Invalidate the tessellation cache.
+
+  This is called whenever one of the parameter slots has changed.
+ */
+void CCylinderGeom::onParamChanged()
+{
+  tesscache.invalidate();
 }
 
 // slotSizeConstraint
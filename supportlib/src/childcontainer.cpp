@@ -0,0 +1,379 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file childcontainer.cpp
+ Contains the ChildContainer class.
+ */
+
+#include "childcontainer.h"
+#include "worldobject.h"
+#include "stringhash.h"
+#include <cstdlib>
+#include <cctype>
+#include <sstream>
+
+namespace support3d {
+
+// Marks in the hash table
+static const int INDEX_EMPTY = -1;
+static const int INDEX_REMOVED = -2;
+
+ChildContainer::ChildContainer()
+  : entries(), numchildren(0), firstvalid(0), index(), indexfill(0), nextsuffix()
+{
+}
+
+/**
+  Return an iterator pointing to the first children.
+ */
+ChildContainer::iterator ChildContainer::begin()
+{
+  iterator res(this, firstvalid);
+  // Remember the position so that the holes at the beginning don't
+  // have to be skipped again
+  firstvalid = (res==end())? entries.size() : &(*res)-&entries[0];
+  return res;
+}
+
+/**
+  Return a pointer to the children with the given name.
+
+  \param name Children name
+  \return Pointer to the children or 0 if there is no such children.
+ */
+const boost::shared_ptr<WorldObject>* ChildContainer::find(const std::string& name) const
+{
+  int idx = findEntry(name, hashName(name));
+  if (idx==-1)
+    return 0;
+  return &(entries[idx].second);
+}
+
+/**
+  Add a new children.
+
+  \pre There is no children called \a name yet and obj is not null.
+  \param name Children name
+  \param obj Children object
+ */
+void ChildContainer::insert(const std::string& name, boost::shared_ptr<WorldObject> obj)
+{
+  reserveIndex();
+
+  ChildEntry e;
+  e.first = name;
+  e.hash = hashName(name);
+  entries.push_back(e);
+  entries.back().second = obj;
+  numchildren++;
+  addToIndex(entries.size()-1);
+}
+
+/**
+  Remove a children.
+
+  \param name Children name
+  \return True if the children was removed, false if there is no such children.
+ */
+bool ChildContainer::erase(const std::string& name)
+{
+  int b = findBucket(name, hashName(name));
+  if (b==-1)
+    return false;
+
+  ChildEntry& e = entries[index[b]];
+  index[b] = INDEX_REMOVED;
+  e.second.reset();
+  e.first.clear();
+  numchildren--;
+  onNameRemoved(name);
+
+  if (numchildren==0)
+  {
+    entries.clear();
+    index.clear();
+    indexfill = 0;
+    nextsuffix.clear();
+    firstvalid = 0;
+  }
+  else if (entries.size()-numchildren>numchildren && entries.size()>=32)
+  {
+    compact();
+  }
+  return true;
+}
+
+/**
+  Rename a children.
+
+  The position of the children in the iteration sequence remains the same.
+
+  \param oldname The current name of the children
+  \param newname The new name (must not be used yet)
+  \return True if the children was renamed, false if there is no such children.
+ */
+bool ChildContainer::rename(const std::string& oldname, const std::string& newname)
+{
+  // Make room first as this might move the entries
+  reserveIndex();
+
+  int b = findBucket(oldname, hashName(oldname));
+  if (b==-1)
+    return false;
+
+  int idx = index[b];
+  index[b] = INDEX_REMOVED;
+  entries[idx].first = newname;
+  entries[idx].hash = hashName(newname);
+  addToIndex(idx);
+  onNameRemoved(oldname);
+  return true;
+}
+
+/**
+  Modify a name so that it's unique among the children names.
+
+  If \a name is already used, a trailing number is added or increased
+  until the name is unique. The container remembers the smallest number
+  that might still be free for the base name, so adding many children
+  with the same name doesn't probe all numbers again.
+
+  \param name A name
+  \return The modified name that is unique
+ */
+std::string ChildContainer::makeUnique(const std::string& name) const
+{
+  if (!contains(name))
+    return name;
+
+  long num;
+  size_t numpos = splitName(name, num);
+  std::string base = name.substr(0, numpos);
+
+  // All names base1 ... base(next-1) are known to be in use
+  std::map<std::string, long>::iterator it = nextsuffix.find(base);
+  long next = (it==nextsuffix.end())? 1 : it->second;
+
+  // Skip the numbers that are known to be in use
+  bool contiguous = (num+1<=next);
+  if (contiguous)
+    num = next-1;
+
+  std::ostringstream resstr;
+  std::string res;
+  do
+  {
+    num++;
+    resstr.str("");
+    resstr<<base<<num;
+    res = resstr.str();
+  }
+  while(contains(res));
+
+  // If the search started within the range of used numbers, then all
+  // numbers up to num-1 are in use now
+  if (contiguous)
+  {
+    if (it==nextsuffix.end())
+      nextsuffix[base] = num;
+    else
+      it->second = num;
+  }
+
+  return res;
+}
+
+/**
+  Compute the hash value of a name (FNV-1a).
+ */
+unsigned int ChildContainer::hashName(const std::string& name)
+{
+  return fnvHash(name);
+}
+
+/**
+  Return the position of a children in the entries vector.
+
+  \return Index into entries or -1 if there is no children called \a name.
+ */
+int ChildContainer::findEntry(const std::string& name, unsigned int hash) const
+{
+  int b = findBucket(name, hash);
+  return (b==-1)? -1 : index[b];
+}
+
+/**
+  Return the position of a children in the hash table.
+
+  \return Index into the hash table or -1 if there is no children called \a name.
+ */
+int ChildContainer::findBucket(const std::string& name, unsigned int hash) const
+{
+  if (index.empty())
+    return -1;
+
+  size_t mask = index.size()-1;
+  size_t b = hash & mask;
+  while(1)
+  {
+    int idx = index[b];
+    if (idx==INDEX_EMPTY)
+      return -1;
+    if (idx>=0 && entries[idx].hash==hash && entries[idx].first==name)
+      return int(b);
+    b = (b+1) & mask;
+  }
+}
+
+/**
+  Make sure the hash table stays at most half full after adding an entry.
+
+  Removed slots count as used as they don't terminate a search. If the
+  entries vector has more holes than children, it gets compacted,
+  otherwise the table size is increased.
+ */
+void ChildContainer::reserveIndex()
+{
+  if (2*(indexfill+1)<=index.size())
+    return;
+
+  if (entries.size()>2*numchildren && entries.size()>=16)
+    compact();
+  else
+    rebuildIndex(4*(numchildren+1));
+}
+
+/**
+  Add an entry to the hash table.
+
+  \pre The hash table has at least one free slot.
+ */
+void ChildContainer::addToIndex(int entryidx)
+{
+  size_t mask = index.size()-1;
+  size_t b = entries[entryidx].hash & mask;
+  while(index[b]>=0)
+  {
+    b = (b+1) & mask;
+  }
+  if (index[b]==INDEX_EMPTY)
+    indexfill++;
+  index[b] = entryidx;
+}
+
+/**
+  Rebuild the hash table.
+
+  The table size is a power of 2 that is at least \a minsize and that is
+  large enough to keep the table at most half full.
+ */
+void ChildContainer::rebuildIndex(size_t minsize)
+{
+  size_t size = 16;
+  while(size<minsize || size<2*(numchildren+1))
+    size *= 2;
+
+  index.assign(size, INDEX_EMPTY);
+  indexfill = 0;
+  for(size_t i=0; i<entries.size(); i++)
+  {
+    if (entries[i].second.get()!=0)
+      addToIndex(int(i));
+  }
+}
+
+/**
+  Remove the holes from the entries vector.
+ */
+void ChildContainer::compact()
+{
+  size_t j = 0;
+  for(size_t i=0; i<entries.size(); i++)
+  {
+    if (entries[i].second.get()==0)
+      continue;
+    if (i!=j)
+    {
+      entries[j].first.swap(entries[i].first);
+      entries[j].second.swap(entries[i].second);
+      entries[j].hash = entries[i].hash;
+    }
+    j++;
+  }
+  entries.resize(j);
+  firstvalid = 0;
+  rebuildIndex(0);
+}
+
+/**
+  Update the next suffix table after a name is no longer in use.
+ */
+void ChildContainer::onNameRemoved(const std::string& name)
+{
+  long num;
+  size_t numpos = splitName(name, num);
+  if (numpos==name.size() || num<1)
+    return;
+
+  std::map<std::string, long>::iterator it = nextsuffix.find(name.substr(0, numpos));
+  if (it==nextsuffix.end() || num>=it->second)
+    return;
+
+  // Only names without leading zeros are covered by the table
+  std::ostringstream numstr;
+  numstr<<num;
+  if (numstr.str()==name.substr(numpos))
+    it->second = num;
+}
+
+/**
+  Split a name into a base name and a trailing number.
+
+  \param name The name
+  \param[out] num Receives the trailing number (0 if there is no number)
+  \return The position where the trailing number begins
+ */
+size_t ChildContainer::splitName(const std::string& name, long& num)
+{
+  size_t numpos = name.size();
+  while((numpos>0) && isdigit(name[numpos-1]))
+  {
+    numpos--;
+  }
+  num = atol(name.substr(numpos).c_str());
+  return numpos;
+}
+
+}  // end of namespace
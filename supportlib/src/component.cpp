@@ -36,16 +36,54 @@
 #define DLL_EXPORT_COMPONENT
 #include "component.h"
 #include "common_exceptions.h"
+#include "memorypool.h"
+#include <algorithm>
 
 namespace support3d {
 
+// Return the memory pools for the slot descriptors
+// (the pools are never deleted as descriptors might still be deleted
+// during program shutdown)
+static SizeClassPools& descriptorPools()
+{
+  static SizeClassPools* pools = new SizeClassPools(64, 1024);
+  return *pools;
+}
+
+void* SlotDescriptor::operator new(size_t size)
+{
+  return descriptorPools().allocate(size);
+}
+
+void SlotDescriptor::operator delete(void* p, size_t size)
+{
+  descriptorPools().deallocate(p, size);
+}
+
+// Delete a slot descriptor which will take care of deleting the slot (or not)
+static void deleteSlotDescriptor(SlotDescriptor* desc)
+{
+#ifdef CGKIT_SLOT_PROFILING
+  // A static slot might outlive the component
+  ISlot& slot = desc->getSlot();
+  slot._profowner = 0;
+  if (slot._profstats!=0)
+    slot._profstats->owner = 0;
+#endif
+  delete desc;
+}
+
+/// Global counter that provides the slot serial numbers
+unsigned long Component::slot_serial_counter = 0;
+
 /**
   Constructor.
 
   \param aname The component's name
  */
 Component::Component(string aname)
-: name(aname), slots()
+: name(aname), slots(), slotindex(), sortedslots(), sortedslots_valid(true),
+  slot_serial(++slot_serial_counter)
 {
   DEBUGINFO1(this, "Component::Component(\"%s\")", aname.c_str());
   //addSlot("name", name);
@@ -57,10 +95,17 @@ Component::Component(string aname)
 Component::~Component()
 {
   DEBUGINFO(this, "Component::~Component()  (\""+name+"\")");
-  // Remove all slots...
-  while(slots.begin()!=slots.end())
+  // Remove all slots at once (the slots can't be found anymore while
+  // they are being deleted)...
+  std::vector<SlotEntry> oldslots;
+  oldslots.swap(slots);
+  slotindex.clear();
+  sortedslots.clear();
+  while(!oldslots.empty())
   {
-    removeSlot(slots.begin()->first);
+    SlotDescriptor* desc = oldslots.back().desc;
+    oldslots.pop_back();
+    deleteSlotDescriptor(desc);
   }
 }
 
@@ -72,7 +117,7 @@ Component::~Component()
  */
 bool Component::hasSlot(const string& name) const
 {
-  return slots.find(name)!=slots.end();
+  return findSlotIndex(name, SlotName::hashString(name))!=-1;
 }
 
 /**
@@ -98,15 +143,57 @@ ISlot& Component::slot(const string& name) const
 {
   DEBUGINFO(this, "Component::slot(\""+name+"\")");
   
-  SlotIterator it = slots.find(name);
-  if (it==slots.end())
+  int idx = findSlotIndex(name, SlotName::hashString(name));
+  if (idx==-1)
   {
     throw EKeyError("Slot \""+name+"\" does not exist.");
   }
   else
   {
-    return it->second->getSlot();
+    return slots[idx].desc->getSlot();
+  }
+}
+
+/**
+  Return the slot with the given name or 0.
+
+  This is the same as calling hasSlot() and slot() but only requires
+  one lookup.
+
+  \param name The name of the slot that should be returned.
+  \return Slot or 0 if there is no slot with the specified name.
+ */
+ISlot* Component::findSlot(const string& name) const
+{
+  int idx = findSlotIndex(name, SlotName::hashString(name));
+  if (idx==-1)
+    return 0;
+  return &(slots[idx].desc->getSlot());
+}
+
+/**
+  Return the slot with the given name or 0.
+
+  In contrast to the string version, the name doesn't have to be
+  hashed and the names are compared by pointer.
+
+  \param name The name of the slot that should be returned.
+  \return Slot or 0 if there is no slot with the specified name.
+ */
+ISlot* Component::findSlot(const SlotName& name) const
+{
+  if (slotindex.empty())
+    return 0;
+  unsigned int mask = slotindex.size()-1;
+  unsigned int b = name.hash() & mask;
+  while(slotindex[b]!=-1)
+  {
+    const SlotEntry& e = slots[slotindex[b]];
+    if (e.name==name)
+      return &(e.desc->getSlot());
+    b = (b+1) & mask;
   }
+  return 0;
 }
   
 /**
@@ -127,8 +214,13 @@ void Component::addSlot(const string& name, auto_ptr<ISlot> slot)
   {
     throw EKeyError("Slot \""+name+"\" already exists.");
   }
+#ifdef CGKIT_SLOT_PROFILING
+  slot->_profowner = this;
+  if (slot->_profstats!=0)
+    slot->_profstats->owner = this;
+#endif
   DynamicSlotDescriptor* desc = new DynamicSlotDescriptor(slot);
-  slots[name] = desc;
+  insertSlotEntry(SlotName(name), desc);
 }
 
 /**
@@ -155,8 +247,13 @@ void Component::addSlot(const string& name, ISlot& slot)
   {
     throw EKeyError("Slot \""+name+"\" already exists.");
   }
+#ifdef CGKIT_SLOT_PROFILING
+  slot._profowner = this;
+  if (slot._profstats!=0)
+    slot._profstats->owner = this;
+#endif
   StaticSlotDescriptor* desc = new StaticSlotDescriptor(slot);
-  slots[name] = desc;
+  insertSlotEntry(SlotName(name), desc);
 }
 
 /** 
@@ -171,18 +268,187 @@ void Component::addSlot(const string& name, ISlot& slot)
 void Component::removeSlot(const string& name)
 {
   DEBUGINFO1(this, "Component::removeSlot(\"%s\")", name.c_str());
-  std::map<string, SlotDescriptor*>::iterator it = slots.find(name);
-  if (it==slots.end())
+  int idx = findSlotIndex(name, SlotName::hashString(name));
+  if (idx==-1)
   {
     throw EKeyError("Slot \""+name+"\" does not exist.");
   }
   else
   {
-    // Delete the descriptor which will take care of deleting the slot (or not)
-    delete it->second;
-    // Remove the pointer to the deleted descriptor
-    slots.erase(name);
+    removeSlotEntry(idx);
+  }
+}
+
+/**
+  Return the position of a slot in the slots vector.
+
+  \param name Slot name
+  \param hash Hash value of the name
+  \return Index or -1 if there is no such slot.
+ */
+int Component::findSlotIndex(const string& name, unsigned int hash) const
+{
+  if (slotindex.empty())
+    return -1;
+  unsigned int mask = slotindex.size()-1;
+  unsigned int b = hash & mask;
+  while(slotindex[b]!=-1)
+  {
+    int idx = slotindex[b];
+    const SlotEntry& e = slots[idx];
+    if (e.name.hash()==hash && e.name.str()==name)
+      return idx;
+    b = (b+1) & mask;
+  }
+  return -1;
+}
+
+/**
+  Insert a new slot entry.
+
+  The name must not be in use yet.
+ */
+void Component::insertSlotEntry(const SlotName& name, SlotDescriptor* desc)
+{
+  if (slots.empty())
+    slots.reserve(8);
+  slots.push_back(SlotEntry(name, desc));
+  sortedslots_valid = false;
+
+  // Does the hash table have to grow? Then build a new one...
+  if (slotindex.size() < 2*slots.size())
+  {
+    rebuildSlotIndex();
+    return;
+  }
+
+  // ...otherwise just add the new slot
+  slot_serial = ++slot_serial_counter;
+  unsigned int mask = slotindex.size()-1;
+  unsigned int b = name.hash() & mask;
+  while(slotindex[b]!=-1)
+    b = (b+1) & mask;
+  slotindex[b] = int(slots.size())-1;
+}
+
+/**
+  Remove a slot entry and delete its descriptor.
+
+  The last slot is moved into the free position, so the order of the
+  slots vector changes.
+
+  \param idx Position of the slot in the slots vector
+ */
+void Component::removeSlotEntry(int idx)
+{
+  SlotDescriptor* desc = slots[idx].desc;
+  unsigned int mask = slotindex.size()-1;
+
+  // Remove the entry from the hash table first so that the slot can't be
+  // found anymore while it is being deleted. The following entries of the
+  // probe sequence are shifted back so that no deleted markers are needed.
+  unsigned int i = slotBucket(idx);
+  unsigned int j = i;
+  while(true)
+  {
+    j = (j+1) & mask;
+    if (slotindex[j]==-1)
+      break;
+    // Keep the entry if its home bucket lies cyclically in (i,j]
+    unsigned int k = slots[slotindex[j]].name.hash() & mask;
+    if ((i<=j)? (i<k && k<=j) : (i<k || k<=j))
+      continue;
+    slotindex[i] = slotindex[j];
+    i = j;
+  }
+  slotindex[i] = -1;
+
+  // Move the last slot into the free position
+  int last = int(slots.size())-1;
+  if (idx!=last)
+  {
+    slotindex[slotBucket(last)] = idx;
+    slots[idx] = slots[last];
+  }
+  slots.pop_back();
+  sortedslots_valid = false;
+  slot_serial = ++slot_serial_counter;
+  deleteSlotDescriptor(desc);
+}
+
+/**
+  Return the hash table bucket that refers to a slot.
+
+  \pre \a idx is a valid position in the slots vector
+  \param idx Position of the slot in the slots vector
+ */
+unsigned int Component::slotBucket(int idx) const
+{
+  unsigned int mask = slotindex.size()-1;
+  unsigned int b = slots[idx].name.hash() & mask;
+  while(slotindex[b]!=idx)
+    b = (b+1) & mask;
+  return b;
+}
+
+/**
+  Rebuild the hash table after the slots vector has been modified.
+
+  The table size is a power of 2 and at least twice the number of slots.
+  This also assigns a new slot serial number.
+ */
+void Component::rebuildSlotIndex()
+{
+  slot_serial = ++slot_serial_counter;
+  if (slots.empty())
+  {
+    slotindex.clear();
+    return;
+  }
+
+  unsigned int size = 8;
+  while(size < 2*slots.size())
+    size *= 2;
+  slotindex.assign(size, -1);
+  unsigned int mask = size-1;
+  for(unsigned int i=0; i<slots.size(); i++)
+  {
+    unsigned int b = slots[i].name.hash() & mask;
+    while(slotindex[b]!=-1)
+      b = (b+1) & mask;
+    slotindex[b] = i;
+  }
+}
+
+// Compares two positions in the slots vector by the slot names
+struct SlotNameLess
+{
+  const std::vector<SlotEntry>& slots;
+  SlotNameLess(const std::vector<SlotEntry>& aslots) : slots(aslots) {}
+  bool operator()(int a, int b) const
+  {
+    return slots[a].name.str() < slots[b].name.str();
+  }
+};
+
+/**
+  Return the positions of the slots sorted by name.
+
+  The sorted order is only computed again when a slot has been added or
+  removed since the last call.
+ */
+const std::vector<int>& Component::sortedSlots() const
+{
+  if (!sortedslots_valid)
+  {
+    int n = int(slots.size());
+    sortedslots.resize(n);
+    for(int i=0; i<n; i++)
+      sortedslots[i] = i;
+    std::sort(sortedslots.begin(), sortedslots.end(), SlotNameLess(slots));
+    sortedslots_valid = true;
   }
+  return sortedslots;
 }
 
 
@@ -34,14 +34,15 @@
  * ***** END LICENSE BLOCK ***** */
 
 #include "drawgeom.h"
-#include "sor_triangulator.h"
 
 #include "opengl.h"
 
 namespace support3d {
 
 DrawGeom::DrawGeom()
-: markers(0), lines()
+: markers(0), lines(),
+  markerverts(), markercolors(), markerindices(), lineverts(), linecolors(),
+  arrays_valid(false)
 {
 }
 
@@ -75,51 +76,104 @@ BoundingBox DrawGeom::boundingBox()
 // Draw the objects
 void DrawGeom::drawGL()
 {
-  SORTriangulator sor;
-  SORTriangulator::SORVertexList vlist;
-  SORTriangulator::SORVertex vert(0, -1, 0, 0, 0);
-  vlist.push_back(vert);
-  vert.set(1, 0, 0, 0, 0);
-  vlist.push_back(vert);
-  vert.set(0, 1, 0, 0, 0);
-  vlist.push_back(vert);
+  if (!arrays_valid)
+    packArrays();
 
   glPushAttrib(GL_ENABLE_BIT);
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
   glDisable(GL_LIGHTING);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
 
-  // Draw markers (points)...
-  std::vector<D_Marker>::iterator mit;
-//  glBegin(GL_POINTS);
-  for(mit=markers.begin(); mit!=markers.end(); mit++)
+  // Draw markers...
+  if (markerindices.size()>0)
   {
-    glColor3d(mit->col.x, mit->col.y, mit->col.z);
-//    glPointSize(mit->size);
-//    glVertex3d(mit->pos.x, mit->pos.y, mit->pos.z);
-    glPushMatrix();
-    glTranslated(mit->pos.x, mit->pos.y, mit->pos.z);
-    glScaled(mit->size, mit->size, mit->size);
-    sor.drawGL(0.0, 360.0, 4, vlist);
-    glPopMatrix();
+    glVertexPointer(3, GL_FLOAT, 0, &markerverts[0]);
+    glColorPointer(3, GL_FLOAT, 0, &markercolors[0]);
+    glDrawElements(GL_TRIANGLES, markerindices.size(), GL_UNSIGNED_INT, &markerindices[0]);
   }
-//  glEnd();
 
   // Draw lines...
-  std::vector<D_Line>::iterator lit;
-  glBegin(GL_LINES);
-  for(lit=lines.begin(); lit!=lines.end(); lit++)
+  // (the line width is ignored because glLineWidth() generated an error
+  // which later lead to an Exception if Python OpenGL calls were made)
+  if (lineverts.size()>0)
   {
-    glColor3d(lit->col.x, lit->col.y, lit->col.z);
-    // The following generates an error which later lead to an Exception
-    // if Python OpenGL calls were made (at least on my machine)
-//    glLineWidth(lit->size);
-    glVertex3d(lit->pos1.x, lit->pos1.y, lit->pos1.z);
-    glVertex3d(lit->pos2.x, lit->pos2.y, lit->pos2.z);
+    glVertexPointer(3, GL_FLOAT, 0, &lineverts[0]);
+    glColorPointer(3, GL_FLOAT, 0, &linecolors[0]);
+    glDrawArrays(GL_LINES, 0, lineverts.size()/3);
   }
-  glEnd();
 
+  glPopClientAttrib();
   glPopAttrib();
 }
 
+/**
+  Rebuild the vertex and color arrays that are used for drawing.
+
+  This is called by drawGL() whenever markers or lines have been added
+  or removed. Each marker is turned into an octahedron whose vertices
+  lie at a distance of \a size from the marker position.
+ */
+void DrawGeom::packArrays()
+{
+  // Octahedron (bottom, 4 vertices around the equator, top)
+  static const float octverts[6][3] = {{0,0,-1}, {1,0,0}, {0,1,0}, {-1,0,0}, {0,-1,0}, {0,0,1}};
+  static const unsigned int octtris[8][3] = {{0,2,1}, {1,2,5}, {0,3,2}, {2,3,5},
+                                             {0,4,3}, {3,4,5}, {0,1,4}, {4,1,5}};
+  int nummarkers = int(markers.size());
+  int numlines = int(lines.size());
+  int i, j;
+
+  markerverts.resize(18*nummarkers);
+  markercolors.resize(18*nummarkers);
+  markerindices.resize(24*nummarkers);
+#ifdef _OPENMP
+  #pragma omp parallel for private(j)
+#endif
+  for(i=0; i<nummarkers; i++)
+  {
+    const D_Marker& m = markers[i];
+    float* v = &markerverts[18*i];
+    float* c = &markercolors[18*i];
+    unsigned int* idx = &markerindices[24*i];
+    for(j=0; j<6; j++)
+    {
+      v[3*j] = float(m.pos.x + m.size*octverts[j][0]);
+      v[3*j+1] = float(m.pos.y + m.size*octverts[j][1]);
+      v[3*j+2] = float(m.pos.z + m.size*octverts[j][2]);
+      c[3*j] = float(m.col.x);
+      c[3*j+1] = float(m.col.y);
+      c[3*j+2] = float(m.col.z);
+    }
+    for(j=0; j<8; j++)
+    {
+      idx[3*j] = 6*i+octtris[j][0];
+      idx[3*j+1] = 6*i+octtris[j][1];
+      idx[3*j+2] = 6*i+octtris[j][2];
+    }
+  }
+
+  lineverts.resize(6*numlines);
+  linecolors.resize(6*numlines);
+  for(i=0; i<numlines; i++)
+  {
+    const D_Line& l = lines[i];
+    float* v = &lineverts[6*i];
+    float* c = &linecolors[6*i];
+    v[0] = float(l.pos1.x);
+    v[1] = float(l.pos1.y);
+    v[2] = float(l.pos1.z);
+    v[3] = float(l.pos2.x);
+    v[4] = float(l.pos2.y);
+    v[5] = float(l.pos2.z);
+    c[0] = c[3] = float(l.col.x);
+    c[1] = c[4] = float(l.col.y);
+    c[2] = c[5] = float(l.col.z);
+  }
+
+  arrays_valid = true;
+}
+
 /**
   Clear all stored objects.
  */
@@ -127,6 +181,7 @@ void DrawGeom::clear()
 {
   markers.clear();
   lines.clear();
+  arrays_valid = false;
 }
 
 /**
@@ -136,6 +191,7 @@ void DrawGeom::marker(const vec3d& pos, const vec3d& col, float size)
 {
   D_Marker m(pos, col, size);
   markers.push_back(m);
+  arrays_valid = false;
 }
 
 /**
@@ -145,6 +201,7 @@ void DrawGeom::line(const vec3d& pos1, const vec3d& pos2, const vec3d& col, floa
 {
   D_Line l(pos1, pos2, col, size);
   lines.push_back(l);
+  arrays_valid = false;
 }
 
 
@@ -0,0 +1,2181 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <map>
+#include <algorithm>
+#include "exprprogram.h"
+#include "noise.h"
+#include "common_exceptions.h"
+
+namespace support3d {
+
+/**
+  Opcodes.
+
+  Unless stated otherwise an instruction reads scalar arguments and
+  writes a scalar result. The argument and destination registers of
+  vectors and matrices are the first register of the value.
+ */
+enum ExprOpcode
+{
+  // Scalar arithmetic
+  OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_FLOORDIV, OP_MOD, OP_POW, OP_NEG,
+  // Comparisons and logical operations (a and b / a or b return one of
+  // their arguments just like in Python)
+  OP_LT, OP_LE, OP_GT, OP_GE, OP_EQ, OP_NE, OP_NOT, OP_AND, OP_OR,
+  // Functions with one argument
+  OP_SIN, OP_COS, OP_TAN, OP_ASIN, OP_ACOS, OP_ATAN, OP_SINH, OP_COSH,
+  OP_TANH, OP_EXP, OP_LOG, OP_LOG10, OP_SQRT, OP_INVSQRT, OP_FLOOR,
+  OP_CEIL, OP_FABS, OP_TRUNC, OP_ROUND, OP_DEGREES, OP_RADIANS, OP_SIGN,
+  // Functions with two or three arguments
+  OP_ATAN2, OP_FMOD, OP_HYPOT, OP_LOGB, OP_MIN, OP_MAX, OP_STEP,
+  OP_CLAMP, OP_SMOOTHSTEP,
+  // Noise (the vector versions write a vec3)
+  OP_NOISE2, OP_NOISE3, OP_NOISE4, OP_SNOISE2, OP_SNOISE3, OP_SNOISE4,
+  OP_CELLNOISE, OP_SCELLNOISE, OP_FBM, OP_TURBULENCE,
+  OP_VNOISE3, OP_VNOISE4, OP_VSNOISE3, OP_VSNOISE4,
+  // Component-wise operations (imm: number of components)
+  OP_MOVE, OP_FILL, OP_EADD, OP_ESUB, OP_ENEG, OP_EMULS, OP_EDIVS, OP_SELECT,
+  // Vector operations
+  OP_DOT, OP_CROSS, OP_LENGTH, OP_NORMALIZE,
+  // Matrix operations (imm: matrix dimension (3 or 4))
+  OP_DIAG, OP_MMUL, OP_MMULV, OP_VMULM, OP_TRANSPOSE, OP_DET, OP_INVERSE,
+  OP_ROTATION, OP_SCALING, OP_TRANSLATION,
+  // Euler angle rotation (imm: order XYZ, YZX, ZXY, XZY, YXZ, ZYX)
+  OP_EULER
+};
+
+//////////////////////////////////////////////////////////////////////
+// Matrix helpers
+//////////////////////////////////////////////////////////////////////
+
+// Read a vector from the registers (lane i)
+static inline void loadValue(const double* r, int reg, int lanes, int i, vec3d& v)
+{
+  v.x = r[reg*lanes+i];
+  v.y = r[(reg+1)*lanes+i];
+  v.z = r[(reg+2)*lanes+i];
+}
+
+// Write a vector into the registers (lane i)
+static inline void storeValue(double* r, int reg, int lanes, int i, const vec3d& v)
+{
+  r[reg*lanes+i] = v.x;
+  r[(reg+1)*lanes+i] = v.y;
+  r[(reg+2)*lanes+i] = v.z;
+}
+
+// Read a matrix from the registers (lane i)
+template<class M, int N>
+static inline void loadMatrix(const double* r, int reg, int lanes, int i, M& m)
+{
+  for(int k=0; k<N*N; k++)
+    m.at(k/N, k%N) = r[(reg+k)*lanes+i];
+}
+
+// Write a matrix into the registers (lane i)
+template<class M, int N>
+static inline void storeMatrix(double* r, int reg, int lanes, int i, M& m)
+{
+  for(int k=0; k<N*N; k++)
+    r[(reg+k)*lanes+i] = m.at(k/N, k%N);
+}
+
+// Execute a matrix instruction (M is either mat3d or mat4d, N the dimension)
+template<class M, int N>
+static void executeMatrixOp(const ExprProgram::Instr& in, double* r, int lanes, int n)
+{
+  M A, B;
+  vec3d v;
+  double* d = r + in.dst*lanes;
+  const double* a = r + in.arg[0]*lanes;
+
+  for(int i=0; i<n; i++)
+  {
+    switch(in.op)
+    {
+    case OP_DIAG:
+      B = M(a[i]);
+      break;
+    case OP_MMUL:
+      loadMatrix<M,N>(r, in.arg[0], lanes, i, A);
+      loadMatrix<M,N>(r, in.arg[1], lanes, i, B);
+      B = A*B;
+      break;
+    case OP_MMULV:
+      loadMatrix<M,N>(r, in.arg[0], lanes, i, A);
+      loadValue(r, in.arg[1], lanes, i, v);
+      storeValue(r, in.dst, lanes, i, A*v);
+      continue;
+    case OP_VMULM:
+      loadValue(r, in.arg[0], lanes, i, v);
+      loadMatrix<M,N>(r, in.arg[1], lanes, i, A);
+      storeValue(r, in.dst, lanes, i, v*A);
+      continue;
+    case OP_TRANSPOSE:
+      loadMatrix<M,N>(r, in.arg[0], lanes, i, A);
+      B = A.transpose();
+      break;
+    case OP_DET:
+      loadMatrix<M,N>(r, in.arg[0], lanes, i, A);
+      d[i] = A.determinant();
+      continue;
+    case OP_INVERSE:
+      loadMatrix<M,N>(r, in.arg[0], lanes, i, A);
+      B = A.inverse();
+      break;
+    case OP_ROTATION:
+      loadValue(r, in.arg[1], lanes, i, v);
+      B.setRotation(a[i], v);
+      break;
+    case OP_SCALING:
+      loadValue(r, in.arg[0], lanes, i, v);
+      B.setScaling(v);
+      break;
+    }
+    storeMatrix<M,N>(r, in.dst, lanes, i, B);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+// ExprProgram
+//////////////////////////////////////////////////////////////////////
+
+/**
+  Constructor.
+ */
+ExprProgram::ExprProgram()
+  : vars(), expr(), code(), constregs(), 
+    resultreg(0), resulttype(FLOAT), compiled(false), regs()
+{
+}
+
+/**
+  Remove all variables and the compiled code.
+ */
+void ExprProgram::clear()
+{
+  vars.clear();
+  expr = "";
+  code.clear();
+  constregs.clear();
+  regs.clear();
+  resultreg = 0;
+  resulttype = FLOAT;
+  compiled = false;
+}
+
+/**
+  Declare an input variable.
+
+  The variables have to be declared before the expression is compiled.
+  Adding a variable invalidates a previously compiled program.
+
+  \param name Variable name
+  \param type Variable type
+  \return Variable index (this is the index into the value array passed to evaluate())
+ */
+int ExprProgram::addVariable(const std::string& name, Type type)
+{
+  if (findVariable(name)!=-1)
+    throw EValueError("Variable \""+name+"\" has already been declared.");
+
+  Variable var;
+  var.name = name;
+  var.type = type;
+  var.reg = 0;
+  vars.push_back(var);
+  compiled = false;
+  return int(vars.size())-1;
+}
+
+/**
+  Return the name of a variable.
+ */
+std::string ExprProgram::getVariableName(int idx) const
+{
+  if (idx<0 || idx>=int(vars.size()))
+    throw EIndexError("Variable index out of range.");
+  return vars[idx].name;
+}
+
+/**
+  Return the type of a variable.
+ */
+ExprProgram::Type ExprProgram::getVariableType(int idx) const
+{
+  if (idx<0 || idx>=int(vars.size()))
+    throw EIndexError("Variable index out of range.");
+  return vars[idx].type;
+}
+
+/**
+  Return the index of a variable or -1 if there is no variable with the given name.
+ */
+int ExprProgram::findVariable(const std::string& name) const
+{
+  for(unsigned int i=0; i<vars.size(); i++)
+  {
+    if (vars[i].name==name)
+      return i;
+  }
+  return -1;
+}
+
+/**
+  Return the name of a type ("float", "vec3", "mat3" or "mat4").
+ */
+const char* ExprProgram::typeName(Type type)
+{
+  switch(type)
+  {
+  case FLOAT: return "float";
+  case VEC3: return "vec3";
+  case MAT3: return "mat3";
+  case MAT4: return "mat4";
+  }
+  return "?";
+}
+
+/**
+  Throw an exception if the program hasn't been compiled successfully.
+ */
+void ExprProgram::checkCompiled() const
+{
+  if (!compiled)
+    throw ERuntimeError("The expression has not been compiled.");
+}
+
+/**
+  Evaluate the expression.
+
+  \a varvalues contains one pointer per variable (in the order in which
+  the variables were declared) that points to the value of the variable
+  (1, 3, 9 or 16 doubles depending on the type). \a result must have
+  enough room for a value of the result type.
+
+  This method is not reentrant as the registers are stored in the program.
+
+  \param varvalues Variable values
+  \param result Receives the result value
+ */
+void ExprProgram::evaluate(const double* const* varvalues, double* result) const
+{
+  checkCompiled();
+
+  double* r = &regs[0];
+  for(unsigned int j=0; j<vars.size(); j++)
+  {
+    const Variable& var = vars[j];
+    for(int k=0; k<var.type; k++)
+      r[var.reg+k] = varvalues[j][k];
+  }
+  if (!code.empty())
+    execute(&code[0], &code[0]+code.size(), r, 1, 1);
+  for(int k=0; k<resulttype; k++)
+    result[k] = r[resultreg+k];
+}
+
+/**
+  Evaluate the expression for many instances.
+
+  \a varvalues contains one pointer per variable that points to the
+  values of the variable for all instances. The value of instance i is
+  located at varvalues[j][i*varstrides[j]]. A stride of 0 means the
+  variable has the same value for all instances. If \a varstrides is
+  0 all values are tightly packed (i.e. the stride is the size of the
+  variable type). The results are written consecutively into \a result.
+
+  The instances are processed in blocks, and the blocks are processed
+  in parallel when the library was compiled with OpenMP support.
+
+  \param n Number of instances
+  \param varvalues Variable values
+  \param varstrides Strides (in doubles) or 0
+  \param result Receives the result values (n values)
+ */
+void ExprProgram::evaluate(int n, const double* const* varvalues, const int* varstrides, double* result) const
+{
+  const int blocksize = 64;
+  checkCompiled();
+  if (n<=0)
+    return;
+
+  int numregs = int(constregs.size());
+  int numblocks = (n+blocksize-1)/blocksize;
+  // 0 = no error, 1 = EZeroDivisionError, 2 = EValueError
+  int failed = 0;
+  std::string errmsg;
+
+#ifdef _OPENMP
+  #pragma omp parallel if(numblocks>=4)
+#endif
+  {
+    // Registers for one block of instances
+    std::vector<double> r(numregs*blocksize);
+    for(int k=0; k<numregs; k++)
+      std::fill(r.begin()+k*blocksize, r.begin()+(k+1)*blocksize, constregs[k]);
+
+    int b;
+#ifdef _OPENMP
+    #pragma omp for
+#endif
+    for(b=0; b<numblocks; b++)
+    {
+      int first = b*blocksize;
+      int cnt = std::min(blocksize, n-first);
+      int i, k;
+
+      // Load the variables...
+      for(unsigned int j=0; j<vars.size(); j++)
+      {
+        const Variable& var = vars[j];
+        int stride = (varstrides==0)? int(var.type) : varstrides[j];
+        const double* src = varvalues[j] + first*stride;
+        for(k=0; k<var.type; k++)
+        {
+          double* dst = &r[(var.reg+k)*blocksize];
+          for(i=0; i<cnt; i++)
+            dst[i] = src[i*stride+k];
+        }
+      }
+
+      try
+      {
+        if (!code.empty())
+          execute(&code[0], &code[0]+code.size(), &r[0], blocksize, cnt);
+      }
+      catch(EZeroDivisionError& e)
+      {
+#ifdef _OPENMP
+        #pragma omp critical
+#endif
+        {
+          failed = 1;
+          errmsg = e.msg;
+        }
+        continue;
+      }
+      catch(EValueError& e)
+      {
+#ifdef _OPENMP
+        #pragma omp critical
+#endif
+        {
+          failed = 2;
+          errmsg = e.msg;
+        }
+        continue;
+      }
+
+      // Store the results...
+      double* dst = result + first*int(resulttype);
+      for(k=0; k<resulttype; k++)
+      {
+        const double* src = &r[(resultreg+k)*blocksize];
+        for(i=0; i<cnt; i++)
+          dst[i*int(resulttype)+k] = src[i];
+      }
+    }
+  }
+
+  if (failed==1)
+    throw EZeroDivisionError(errmsg);
+  if (failed==2)
+    throw EValueError(errmsg);
+}
+
+// Helper macros for the instruction loop
+#define EXPR_OP1(OPCODE, EXPR) \
+  case OPCODE: for(i=0; i<n; i++) { double x=a[i]; d[i] = (EXPR); } break;
+#define EXPR_OP2(OPCODE, EXPR) \
+  case OPCODE: for(i=0; i<n; i++) { double x=a[i], y=b[i]; d[i] = (EXPR); } break;
+#define EXPR_OP3(OPCODE, EXPR) \
+  case OPCODE: for(i=0; i<n; i++) { double x=a[i], y=b[i], z=c[i]; d[i] = (EXPR); } break;
+// Same as above but raise a math domain error (like Python) for invalid arguments
+#define EXPR_OP1_DOMAIN(OPCODE, EXPR, INVALID) \
+  case OPCODE: \
+    for(i=0; i<n; i++) { double x=a[i]; if (INVALID) throw EValueError("math domain error"); } \
+    for(i=0; i<n; i++) { double x=a[i]; d[i] = (EXPR); } break;
+
+/**
+  Execute a sequence of instructions.
+
+  Register k of instance i is located at r[k*lanes+i].
+
+  \param begin First instruction
+  \param end Instruction after the last instruction
+  \param r Registers
+  \param lanes Number of instances per register
+  \param n Number of instances to process (<= lanes)
+ */
+void ExprProgram::execute(const Instr* begin, const Instr* end, double* r, int lanes, int n) const
+{
+  int i, k;
+
+  for(const Instr* in=begin; in!=end; in++)
+  {
+    double* d = r + in->dst*lanes;
+    const double* a = r + in->arg[0]*lanes;
+    const double* b = r + in->arg[1]*lanes;
+    const double* c = r + in->arg[2]*lanes;
+    int m = in->imm;
+
+    switch(in->op)
+    {
+    EXPR_OP2(OP_ADD, x+y)
+    EXPR_OP2(OP_SUB, x-y)
+    EXPR_OP2(OP_MUL, x*y)
+    case OP_DIV:
+      for(i=0; i<n; i++)
+      {
+        if (b[i]==0.0)
+          throw EZeroDivisionError("float division by zero");
+        d[i] = a[i]/b[i];
+      }
+      break;
+    case OP_FLOORDIV:
+      for(i=0; i<n; i++)
+      {
+        if (b[i]==0.0)
+          throw EZeroDivisionError("integer division or modulo by zero");
+        d[i] = floor(a[i]/b[i]);
+      }
+      break;
+    case OP_MOD:
+      for(i=0; i<n; i++)
+      {
+        if (b[i]==0.0)
+          throw EZeroDivisionError("integer division or modulo by zero");
+        // The result has the sign of the divisor (like in Python)
+        double res = fmod(a[i], b[i]);
+        if (res!=0.0 && ((res<0.0)!=(b[i]<0.0)))
+          res += b[i];
+        d[i] = res;
+      }
+      break;
+    case OP_POW:
+      for(i=0; i<n; i++)
+      {
+        if (a[i]==0.0 && b[i]<0.0)
+          throw EZeroDivisionError("0.0 cannot be raised to a negative power");
+        if (a[i]<0.0 && b[i]!=floor(b[i]))
+          throw EValueError("negative number cannot be raised to a fractional power");
+      }
+      for(i=0; i<n; i++)
+        d[i] = pow(a[i], b[i]);
+      break;
+    EXPR_OP1(OP_NEG, -x)
+    EXPR_OP2(OP_LT, (x<y)? 1.0 : 0.0)
+    EXPR_OP2(OP_LE, (x<=y)? 1.0 : 0.0)
+    EXPR_OP2(OP_GT, (x>y)? 1.0 : 0.0)
+    EXPR_OP2(OP_GE, (x>=y)? 1.0 : 0.0)
+    EXPR_OP2(OP_EQ, (x==y)? 1.0 : 0.0)
+    EXPR_OP2(OP_NE, (x!=y)? 1.0 : 0.0)
+    EXPR_OP1(OP_NOT, (x==0.0)? 1.0 : 0.0)
+    EXPR_OP2(OP_AND, (x!=0.0)? y : x)
+    EXPR_OP2(OP_OR, (x!=0.0)? x : y)
+    EXPR_OP1(OP_SIN, sin(x))
+    EXPR_OP1(OP_COS, cos(x))
+    EXPR_OP1(OP_TAN, tan(x))
+    EXPR_OP1_DOMAIN(OP_ASIN, asin(x), x<-1.0 || x>1.0)
+    EXPR_OP1_DOMAIN(OP_ACOS, acos(x), x<-1.0 || x>1.0)
+    EXPR_OP1(OP_ATAN, atan(x))
+    EXPR_OP1(OP_SINH, sinh(x))
+    EXPR_OP1(OP_COSH, cosh(x))
+    EXPR_OP1(OP_TANH, tanh(x))
+    EXPR_OP1(OP_EXP, exp(x))
+    EXPR_OP1_DOMAIN(OP_LOG, log(x), x<=0.0)
+    EXPR_OP1_DOMAIN(OP_LOG10, log10(x), x<=0.0)
+    EXPR_OP1_DOMAIN(OP_SQRT, sqrt(x), x<0.0)
+    case OP_INVSQRT:
+      for(i=0; i<n; i++)
+      {
+        if (a[i]<0.0)
+          throw EValueError("math domain error");
+        if (a[i]==0.0)
+          throw EZeroDivisionError("float division by zero");
+      }
+      for(i=0; i<n; i++)
+        d[i] = 1.0/sqrt(a[i]);
+      break;
+    EXPR_OP1(OP_FLOOR, floor(x))
+    EXPR_OP1(OP_CEIL, ceil(x))
+    EXPR_OP1(OP_FABS, fabs(x))
+    EXPR_OP1(OP_TRUNC, (x<0.0)? ceil(x) : floor(x))
+    EXPR_OP1(OP_ROUND, (x<0.0)? ceil(x-0.5) : floor(x+0.5))
+    EXPR_OP1(OP_DEGREES, x*180.0/M_PI)
+    EXPR_OP1(OP_RADIANS, x*M_PI/180.0)
+    EXPR_OP1(OP_SIGN, (x<0.0)? -1.0 : ((x>0.0)? 1.0 : 0.0))
+    EXPR_OP2(OP_ATAN2, atan2(x,y))
+    case OP_FMOD:
+      for(i=0; i<n; i++)
+        if (b[i]==0.0)
+          throw EValueError("math domain error");
+      for(i=0; i<n; i++)
+        d[i] = fmod(a[i], b[i]);
+      break;
+    EXPR_OP2(OP_HYPOT, hypot(x,y))
+    case OP_LOGB:
+      for(i=0; i<n; i++)
+      {
+        if (a[i]<=0.0 || b[i]<=0.0)
+          throw EValueError("math domain error");
+        if (b[i]==1.0)
+          throw EZeroDivisionError("float division by zero");
+      }
+      for(i=0; i<n; i++)
+        d[i] = log(a[i])/log(b[i]);
+      break;
+    EXPR_OP2(OP_MIN, (y<x)? y : x)
+    EXPR_OP2(OP_MAX, (y>x)? y : x)
+    EXPR_OP2(OP_STEP, (y<x)? 0.0 : 1.0)
+    EXPR_OP3(OP_CLAMP, (z<((y>x)? y : x))? z : ((y>x)? y : x))
+    case OP_SMOOTHSTEP:
+      for(i=0; i<n; i++)
+      {
+        double x = c[i];
+        if (x<a[i])
+          d[i] = 0.0;
+        else if (x>b[i])
+          d[i] = 1.0;
+        else
+        {
+          x = (x-a[i])/(b[i]-a[i]);
+          d[i] = x*x*(3.0-2.0*x);
+        }
+      }
+      break;
+    EXPR_OP2(OP_NOISE2, noise(x,y))
+    EXPR_OP3(OP_NOISE3, noise(x,y,z))
+    EXPR_OP2(OP_SNOISE2, snoise(x,y))
+    EXPR_OP3(OP_SNOISE3, snoise(x,y,z))
+    case OP_NOISE4:
+    case OP_SNOISE4:
+    case OP_CELLNOISE:
+    case OP_SCELLNOISE:
+    {
+      const double* t = r + in->arg[3]*lanes;
+      for(i=0; i<n; i++)
+      {
+        switch(in->op)
+        {
+        case OP_NOISE4: d[i] = noise(a[i], b[i], c[i], t[i]); break;
+        case OP_SNOISE4: d[i] = snoise(a[i], b[i], c[i], t[i]); break;
+        case OP_CELLNOISE: d[i] = cellnoise(a[i], b[i], c[i], t[i]); break;
+        default: d[i] = scellnoise(a[i], b[i], c[i], t[i]); break;
+        }
+      }
+      break;
+    }
+    case OP_FBM:
+    case OP_TURBULENCE:
+    {
+      const double* oct = r + in->arg[3]*lanes;
+      const double* lac = r + in->arg[4]*lanes;
+      const double* gain = r + in->arg[5]*lanes;
+      for(i=0; i<n; i++)
+      {
+        if (in->op==OP_FBM)
+          d[i] = fBm(a[i], b[i], c[i], int(oct[i]), lac[i], gain[i]);
+        else
+          d[i] = turbulence(a[i], b[i], c[i], int(oct[i]), lac[i], gain[i]);
+      }
+      break;
+    }
+    case OP_VNOISE3:
+    case OP_VSNOISE3:
+      for(i=0; i<n; i++)
+      {
+        if (in->op==OP_VNOISE3)
+          vnoise(a[i], b[i], c[i], d[i], d[lanes+i], d[2*lanes+i]);
+        else
+          vsnoise(a[i], b[i], c[i], d[i], d[lanes+i], d[2*lanes+i]);
+      }
+      break;
+    case OP_VNOISE4:
+    case OP_VSNOISE4:
+    {
+      const double* t = r + in->arg[3]*lanes;
+      double ot;
+      for(i=0; i<n; i++)
+      {
+        if (in->op==OP_VNOISE4)
+          vnoise(a[i], b[i], c[i], t[i], d[i], d[lanes+i], d[2*lanes+i], ot);
+        else
+          vsnoise(a[i], b[i], c[i], t[i], d[i], d[lanes+i], d[2*lanes+i], ot);
+      }
+      break;
+    }
+    case OP_MOVE:
+      for(k=0; k<m; k++)
+        for(i=0; i<n; i++)
+          d[k*lanes+i] = a[k*lanes+i];
+      break;
+    case OP_FILL:
+      for(k=0; k<m; k++)
+        for(i=0; i<n; i++)
+          d[k*lanes+i] = a[i];
+      break;
+    case OP_EADD:
+      for(k=0; k<m*lanes; k+=lanes)
+        for(i=0; i<n; i++)
+          d[k+i] = a[k+i]+b[k+i];
+      break;
+    case OP_ESUB:
+      for(k=0; k<m*lanes; k+=lanes)
+        for(i=0; i<n; i++)
+          d[k+i] = a[k+i]-b[k+i];
+      break;
+    case OP_ENEG:
+      for(k=0; k<m*lanes; k+=lanes)
+        for(i=0; i<n; i++)
+          d[k+i] = -a[k+i];
+      break;
+    case OP_EMULS:
+      for(k=0; k<m*lanes; k+=lanes)
+        for(i=0; i<n; i++)
+          d[k+i] = a[k+i]*b[i];
+      break;
+    case OP_EDIVS:
+      for(i=0; i<n; i++)
+      {
+        if (fabs(b[i])<=vec3d::epsilon)
+          throw EZeroDivisionError("divide by zero");
+      }
+      for(k=0; k<m*lanes; k+=lanes)
+        for(i=0; i<n; i++)
+          d[k+i] = a[k+i]/b[i];
+      break;
+    case OP_SELECT:
+      for(k=0; k<m*lanes; k+=lanes)
+        for(i=0; i<n; i++)
+          d[k+i] = (a[i]!=0.0)? b[k+i] : c[k+i];
+      break;
+    case OP_DOT:
+      for(i=0; i<n; i++)
+        d[i] = a[i]*b[i] + a[lanes+i]*b[lanes+i] + a[2*lanes+i]*b[2*lanes+i];
+      break;
+    case OP_CROSS:
+      for(i=0; i<n; i++)
+      {
+        double ax=a[i], ay=a[lanes+i], az=a[2*lanes+i];
+        double bx=b[i], by=b[lanes+i], bz=b[2*lanes+i];
+        d[i] = ay*bz-az*by;
+        d[lanes+i] = az*bx-ax*bz;
+        d[2*lanes+i] = ax*by-ay*bx;
+      }
+      break;
+    case OP_LENGTH:
+      for(i=0; i<n; i++)
+        d[i] = sqrt(a[i]*a[i] + a[lanes+i]*a[lanes+i] + a[2*lanes+i]*a[2*lanes+i]);
+      break;
+    case OP_NORMALIZE:
+      for(i=0; i<n; i++)
+      {
+        vec3d v(a[i], a[lanes+i], a[2*lanes+i]);
+        v = v.normalize();
+        d[i] = v.x;
+        d[lanes+i] = v.y;
+        d[2*lanes+i] = v.z;
+      }
+      break;
+    case OP_TRANSLATION:
+      for(i=0; i<n; i++)
+      {
+        vec3d v(a[i], a[lanes+i], a[2*lanes+i]);
+        mat4d M;
+        M.setTranslation(v);
+        storeMatrix<mat4d,4>(r, in->dst, lanes, i, M);
+      }
+      break;
+    case OP_EULER:
+      for(i=0; i<n; i++)
+      {
+        mat3d M;
+        switch(m)
+        {
+        case 0: M.setRotationXYZ(a[i], b[i], c[i]); break;
+        case 1: M.setRotationYZX(a[i], b[i], c[i]); break;
+        case 2: M.setRotationZXY(a[i], b[i], c[i]); break;
+        case 3: M.setRotationXZY(a[i], b[i], c[i]); break;
+        case 4: M.setRotationYXZ(a[i], b[i], c[i]); break;
+        default: M.setRotationZYX(a[i], b[i], c[i]); break;
+        }
+        storeMatrix<mat3d,3>(r, in->dst, lanes, i, M);
+      }
+      break;
+    default:
+      // Matrix operations
+      if (m==3)
+        executeMatrixOp<mat3d,3>(*in, r, lanes, n);
+      else
+        executeMatrixOp<mat4d,4>(*in, r, lanes, n);
+      break;
+    }
+  }
+}
+
+#undef EXPR_OP1
+#undef EXPR_OP2
+#undef EXPR_OP3
+
+//////////////////////////////////////////////////////////////////////
+// ExprCompiler
+//////////////////////////////////////////////////////////////////////
+
+/**
+  A value during compilation.
+
+  Apart from actual values (which are stored in registers) the parser
+  also has to deal with names that are not variables (functions or
+  modules), bound methods and tuples.
+ */
+struct ExprValue
+{
+  enum Kind { VALUE, NAME, METHOD, TUPLE };
+  Kind kind;
+  /// Value type (VALUE) or type of the object (METHOD).
+  ExprProgram::Type type;
+  /// First register of the value (VALUE) or of the object (METHOD).
+  int reg;
+  /// True if the value is a Python int (this matters for divisions).
+  bool isint;
+  /// Function, module or method name.
+  std::string name;
+  /// Registers of the tuple items (TUPLE, the items are always floats).
+  std::vector<int> items;
+
+  ExprValue() : kind(VALUE), type(ExprProgram::FLOAT), reg(0), isint(false), name(), items() {}
+};
+
+/**
+  A token of the expression string.
+ */
+struct ExprToken
+{
+  enum Kind { NUMBER, NAME, OP, END };
+  Kind kind;
+  std::string text;
+  /// Value of a number.
+  double value;
+  /// True if the number is an int literal.
+  bool isint;
+  /// Position within the expression string.
+  int pos;
+};
+
+/**
+  Compiles an expression string into an ExprProgram.
+
+  The compiler is a recursive descent parser that follows the Python
+  grammar. The instructions are emitted directly while parsing, i.e.
+  each parse method returns the value it has computed. An instruction
+  whose arguments are all constant is executed right away and its
+  result becomes a new constant.
+ */
+class ExprCompiler
+{
+  protected:
+  ExprProgram& prog;
+  std::string expr;
+  std::vector<ExprToken> tokens;
+  unsigned int pos;
+  /// Flags that mark the constant registers.
+  std::vector<bool> isconst;
+  /// Registers of the literal constants.
+  std::map<double, int> constants;
+
+  public:
+  ExprCompiler(ExprProgram& aprog, const std::string& aexpr)
+    : prog(aprog), expr(aexpr), tokens(), pos(0), isconst(), constants() {}
+
+  void run(const ExprProgram::Type* restype);
+
+  protected:
+  // Parser
+  void tokenize();
+  const ExprToken& peek() const { return tokens[pos]; }
+  bool isOp(const char* op) const;
+  bool isKeyword(const char* kw) const;
+  void expectOp(const char* op);
+  void error(const std::string& msg) const;
+
+  ExprValue parseTestList();
+  ExprValue parseTest();
+  ExprValue parseOr();
+  ExprValue parseAnd();
+  ExprValue parseNot();
+  ExprValue parseComparison();
+  ExprValue parseArith();
+  ExprValue parseTerm();
+  ExprValue parseFactor();
+  ExprValue parsePower();
+  ExprValue parsePrimary();
+  ExprValue parseAtom();
+  std::vector<ExprValue> parseArgs();
+
+  // Code generation
+  int allocRegs(int n);
+  ExprValue constant(double v, bool isint=false);
+  ExprValue scalar(int reg) const;
+  bool isConstant(const ExprValue& v) const;
+  void requireValue(const ExprValue& v) const;
+  void requireType(const ExprValue& v, ExprProgram::Type type, const std::string& func) const;
+  ExprValue emit(short op, ExprProgram::Type rtype, short imm, const ExprValue* args, int nargs, int dst=-1);
+  ExprValue emit(short op, ExprProgram::Type rtype, const ExprValue& a, short imm=0);
+  ExprValue emit(short op, ExprProgram::Type rtype, const ExprValue& a, const ExprValue& b, short imm=0);
+  ExprValue emit(short op, ExprProgram::Type rtype, const ExprValue& a, const ExprValue& b, const ExprValue& c, short imm=0);
+  ExprValue pack(const std::vector<int>& regs, ExprProgram::Type type);
+  ExprValue convert(const ExprValue& v, ExprProgram::Type type);
+
+  ExprValue unaryOp(const std::string& op, const ExprValue& a);
+  ExprValue binaryOp(const std::string& op, const ExprValue& a, const ExprValue& b);
+  ExprValue logicalOp(short op, const ExprValue& a, const ExprValue& b);
+  ExprValue select(const ExprValue& cond, const ExprValue& a, const ExprValue& b);
+  ExprValue attribute(const ExprValue& v, const std::string& attr);
+  ExprValue subscript(const ExprValue& v, const ExprValue& idx);
+  ExprValue callFunction(const std::string& name, const std::vector<ExprValue>& args);
+  ExprValue callMethod(const ExprValue& self, const std::vector<ExprValue>& args);
+  ExprValue callNoise(const std::string& name, const std::vector<ExprValue>& args);
+};
+
+// Operators consisting of two characters
+static const char* exprOps2[] = {"**", "//", "<=", ">=", "==", "!=", 0};
+
+// Python keywords (they can't be used as names)
+static const char* exprKeywords[] = {"and", "or", "not", "if", "else", "in", "is",
+  "lambda", "for", "None", "print", "yield", "del", "pass", "def", "class",
+  "return", "import", "from", "while", "exec", "global", "assert", 0};
+
+// Math functions with one argument
+static const struct { const char* name; short op; } exprFuncs1[] = {
+  {"sin", OP_SIN}, {"cos", OP_COS}, {"tan", OP_TAN}, {"asin", OP_ASIN},
+  {"acos", OP_ACOS}, {"atan", OP_ATAN}, {"sinh", OP_SINH}, {"cosh", OP_COSH},
+  {"tanh", OP_TANH}, {"exp", OP_EXP}, {"log10", OP_LOG10}, {"sqrt", OP_SQRT},
+  {"floor", OP_FLOOR}, {"ceil", OP_CEIL}, {"fabs", OP_FABS},
+  {"degrees", OP_DEGREES}, {"radians", OP_RADIANS}, {"inversesqrt", OP_INVSQRT},
+  {0, 0}};
+
+// Math functions with two arguments
+static const struct { const char* name; short op; } exprFuncs2[] = {
+  {"atan2", OP_ATAN2}, {"fmod", OP_FMOD}, {"hypot", OP_HYPOT}, {"pow", OP_POW},
+  {"step", OP_STEP}, {0, 0}};
+
+// Euler angle constructors (the index is the imm value of OP_EULER)
+static const char* exprEulerFuncs[] = {"fromEulerXYZ", "fromEulerYZX", "fromEulerZXY",
+  "fromEulerXZY", "fromEulerYXZ", "fromEulerZYX", 0};
+
+/**
+  Compile the expression.
+
+  \param restype Result type or 0 (the type is then determined by the expression)
+ */
+void ExprCompiler::run(const ExprProgram::Type* restype)
+{
+  prog.compiled = false;
+  prog.expr = expr;
+  prog.code.clear();
+  prog.constregs.clear();
+  prog.regs.clear();
+
+  for(unsigned int j=0; j<prog.vars.size(); j++)
+  {
+    prog.vars[j].reg = allocRegs(prog.vars[j].type);
+  }
+
+  ExprValue res;
+  try
+  {
+    tokenize();
+    res = parseTestList();
+    if (peek().kind!=ExprToken::END)
+      error("unexpected '"+peek().text+"'");
+
+    if (restype!=0)
+    {
+      res = convert(res, *restype);
+    }
+    else if (res.kind==ExprValue::TUPLE)
+    {
+      switch(res.items.size())
+      {
+      case 3: res = convert(res, ExprProgram::VEC3); break;
+      case 9: res = convert(res, ExprProgram::MAT3); break;
+      case 16: res = convert(res, ExprProgram::MAT4); break;
+      default: error("unsupported sequence size");
+      }
+    }
+    else
+    {
+      requireValue(res);
+    }
+  }
+  catch(EZeroDivisionError& e)
+  {
+    // A constant subexpression raised an exception
+    prog.code.clear();
+    throw EValueError("Expression \""+expr+"\": "+e.msg);
+  }
+
+  prog.resultreg = res.reg;
+  prog.resulttype = res.type;
+  prog.regs = prog.constregs;
+  prog.compiled = true;
+}
+
+/**
+  Split the expression string into tokens.
+ */
+void ExprCompiler::tokenize()
+{
+  unsigned int i = 0;
+  unsigned int n = expr.size();
+
+  while(1)
+  {
+    while(i<n && isspace(expr[i]))
+      i++;
+
+    ExprToken tok;
+    tok.pos = i;
+    tok.value = 0.0;
+    tok.isint = false;
+    if (i>=n)
+    {
+      tok.kind = ExprToken::END;
+      tokens.push_back(tok);
+      break;
+    }
+
+    char ch = expr[i];
+    unsigned int start = i;
+    // Number?
+    if (isdigit(ch) || (ch=='.' && i+1<n && isdigit(expr[i+1])))
+    {
+      tok.kind = ExprToken::NUMBER;
+      tok.isint = true;
+      if (ch=='0' && i+1<n && (expr[i+1]=='x' || expr[i+1]=='X'))
+      {
+        i += 2;
+        while(i<n && isxdigit(expr[i]))
+          i++;
+        tok.value = double(strtol(expr.substr(start, i-start).c_str(), 0, 16));
+      }
+      else
+      {
+        while(i<n && isdigit(expr[i]))
+          i++;
+        if (i<n && expr[i]=='.')
+        {
+          tok.isint = false;
+          i++;
+          while(i<n && isdigit(expr[i]))
+            i++;
+        }
+        if (i<n && (expr[i]=='e' || expr[i]=='E'))
+        {
+          unsigned int j = i+1;
+          if (j<n && (expr[j]=='+' || expr[j]=='-'))
+            j++;
+          if (j<n && isdigit(expr[j]))
+          {
+            tok.isint = false;
+            i = j;
+            while(i<n && isdigit(expr[i]))
+              i++;
+          }
+        }
+        std::string s = expr.substr(start, i-start);
+        // Python 2 interprets ints with a leading 0 as octal numbers
+        if (tok.isint && s.size()>1 && s[0]=='0')
+          tok.value = double(strtol(s.c_str(), 0, 8));
+        else
+          tok.value = strtod(s.c_str(), 0);
+      }
+      // Long suffix
+      if (tok.isint && i<n && (expr[i]=='l' || expr[i]=='L'))
+        i++;
+      if (i<n && (isalnum(expr[i]) || expr[i]=='_'))
+      {
+        pos = tokens.size();
+        tokens.push_back(tok);
+        error("invalid number");
+      }
+    }
+    // Name?
+    else if (isalpha(ch) || ch=='_')
+    {
+      tok.kind = ExprToken::NAME;
+      while(i<n && (isalnum(expr[i]) || expr[i]=='_'))
+        i++;
+    }
+    // Operator
+    else
+    {
+      tok.kind = ExprToken::OP;
+      i++;
+      for(int k=0; exprOps2[k]!=0; k++)
+      {
+        if (expr.compare(start, 2, exprOps2[k])==0)
+        {
+          i++;
+          break;
+        }
+      }
+      if (i-start==1 && std::string("+-*/%()[],.<>").find(ch)==std::string::npos)
+      {
+        tok.text = expr.substr(start, 1);
+        pos = tokens.size();
+        tokens.push_back(tok);
+        error("unsupported character");
+      }
+    }
+    tok.text = expr.substr(start, i-start);
+    tokens.push_back(tok);
+  }
+}
+
+/**
+  Check if the current token is the given operator.
+ */
+bool ExprCompiler::isOp(const char* op) const
+{
+  const ExprToken& tok = peek();
+  return tok.kind==ExprToken::OP && tok.text==op;
+}
+
+/**
+  Check if the current token is the given keyword.
+ */
+bool ExprCompiler::isKeyword(const char* kw) const
+{
+  const ExprToken& tok = peek();
+  return tok.kind==ExprToken::NAME && tok.text==kw;
+}
+
+/**
+  Skip the given operator or raise an error if the current token is something else.
+ */
+void ExprCompiler::expectOp(const char* op)
+{
+  if (!isOp(op))
+    error(std::string("'")+op+"' expected");
+  pos++;
+}
+
+/**
+  Raise a compile error at the current token.
+ */
+void ExprCompiler::error(const std::string& msg) const
+{
+  std::string s = "Expression \""+expr+"\": "+msg;
+  if (pos<tokens.size() && tokens[pos].kind!=ExprToken::END)
+  {
+    char buf[32];
+    sprintf(buf, " (at position %d)", tokens[pos].pos);
+    s += buf;
+  }
+  throw EValueError(s);
+}
+
+// testlist: test (',' test)* [',']
+ExprValue ExprCompiler::parseTestList()
+{
+  ExprValue v = parseTest();
+  if (!isOp(","))
+    return v;
+
+  ExprValue tup;
+  tup.kind = ExprValue::TUPLE;
+  while(1)
+  {
+    if (v.kind!=ExprValue::VALUE || v.type!=ExprProgram::FLOAT)
+      error("only tuples of floats are supported");
+    tup.items.push_back(v.reg);
+    if (!isOp(","))
+      break;
+    pos++;
+    if (peek().kind==ExprToken::END || isOp(")"))
+      break;
+    v = parseTest();
+  }
+  return tup;
+}
+
+// test: or_test ['if' or_test 'else' test]
+ExprValue ExprCompiler::parseTest()
+{
+  ExprValue v = parseOr();
+  if (isKeyword("if"))
+  {
+    pos++;
+    ExprValue cond = parseOr();
+    if (!isKeyword("else"))
+      error("'else' expected");
+    pos++;
+    ExprValue w = parseTest();
+    return select(cond, v, w);
+  }
+  return v;
+}
+
+// or_test: and_test ('or' and_test)*
+ExprValue ExprCompiler::parseOr()
+{
+  ExprValue v = parseAnd();
+  while(isKeyword("or"))
+  {
+    pos++;
+    ExprValue w = parseAnd();
+    v = logicalOp(OP_OR, v, w);
+  }
+  return v;
+}
+
+// and_test: not_test ('and' not_test)*
+ExprValue ExprCompiler::parseAnd()
+{
+  ExprValue v = parseNot();
+  while(isKeyword("and"))
+  {
+    pos++;
+    ExprValue w = parseNot();
+    v = logicalOp(OP_AND, v, w);
+  }
+  return v;
+}
+
+// not_test: 'not' not_test | comparison
+ExprValue ExprCompiler::parseNot()
+{
+  if (isKeyword("not"))
+  {
+    pos++;
+    ExprValue v = parseNot();
+    requireType(v, ExprProgram::FLOAT, "not");
+    ExprValue res = emit(OP_NOT, ExprProgram::FLOAT, v);
+    res.isint = true;
+    return res;
+  }
+  return parseComparison();
+}
+
+// comparison: expr (comp_op expr)*
+ExprValue ExprCompiler::parseComparison()
+{
+  ExprValue a = parseArith();
+  ExprValue res;
+  bool first = true;
+
+  while(1)
+  {
+    short op;
+    if (isOp("<"))
+      op = OP_LT;
+    else if (isOp("<="))
+      op = OP_LE;
+    else if (isOp(">"))
+      op = OP_GT;
+    else if (isOp(">="))
+      op = OP_GE;
+    else if (isOp("=="))
+      op = OP_EQ;
+    else if (isOp("!="))
+      op = OP_NE;
+    else
+      break;
+    std::string opname = peek().text;
+    pos++;
+    ExprValue b = parseArith();
+    requireType(a, ExprProgram::FLOAT, opname);
+    requireType(b, ExprProgram::FLOAT, opname);
+    ExprValue c = emit(op, ExprProgram::FLOAT, a, b);
+    c.isint = true;
+    // a < b < c is evaluated as (a < b) and (b < c)
+    res = first? c : logicalOp(OP_AND, res, c);
+    first = false;
+    a = b;
+  }
+  return first? a : res;
+}
+
+// arith_expr: term (('+'|'-') term)*
+ExprValue ExprCompiler::parseArith()
+{
+  ExprValue v = parseTerm();
+  while(isOp("+") || isOp("-"))
+  {
+    std::string op = peek().text;
+    pos++;
+    ExprValue w = parseTerm();
+    v = binaryOp(op, v, w);
+  }
+  return v;
+}
+
+// term: factor (('*'|'/'|'%'|'//') factor)*
+ExprValue ExprCompiler::parseTerm()
+{
+  ExprValue v = parseFactor();
+  while(isOp("*") || isOp("/") || isOp("//") || isOp("%"))
+  {
+    std::string op = peek().text;
+    pos++;
+    ExprValue w = parseFactor();
+    v = binaryOp(op, v, w);
+  }
+  return v;
+}
+
+// factor: ('+'|'-') factor | power
+ExprValue ExprCompiler::parseFactor()
+{
+  if (isOp("+") || isOp("-"))
+  {
+    std::string op = peek().text;
+    pos++;
+    ExprValue v = parseFactor();
+    return unaryOp(op, v);
+  }
+  return parsePower();
+}
+
+// power: primary ['**' factor]
+ExprValue ExprCompiler::parsePower()
+{
+  ExprValue v = parsePrimary();
+  if (isOp("**"))
+  {
+    pos++;
+    ExprValue w = parseFactor();
+    return binaryOp("**", v, w);
+  }
+  return v;
+}
+
+// primary: atom trailer*
+ExprValue ExprCompiler::parsePrimary()
+{
+  ExprValue v = parseAtom();
+  while(1)
+  {
+    if (isOp("."))
+    {
+      pos++;
+      if (peek().kind!=ExprToken::NAME)
+        error("attribute name expected");
+      std::string attr = peek().text;
+      pos++;
+      v = attribute(v, attr);
+    }
+    else if (isOp("("))
+    {
+      pos++;
+      std::vector<ExprValue> args = parseArgs();
+      if (v.kind==ExprValue::NAME)
+        v = callFunction(v.name, args);
+      else if (v.kind==ExprValue::METHOD)
+        v = callMethod(v, args);
+      else
+        error("object is not callable");
+    }
+    else if (isOp("["))
+    {
+      pos++;
+      ExprValue idx = parseTest();
+      expectOp("]");
+      v = subscript(v, idx);
+    }
+    else
+      break;
+  }
+  return v;
+}
+
+// atom: '(' [testlist] ')' | NAME | NUMBER
+ExprValue ExprCompiler::parseAtom()
+{
+  const ExprToken& tok = peek();
+
+  if (tok.kind==ExprToken::NUMBER)
+  {
+    pos++;
+    return constant(tok.value, tok.isint);
+  }
+
+  if (tok.kind==ExprToken::NAME)
+  {
+    for(int k=0; exprKeywords[k]!=0; k++)
+    {
+      if (tok.text==exprKeywords[k])
+        error("unexpected '"+tok.text+"'");
+    }
+    pos++;
+    int idx = prog.findVariable(tok.text);
+    if (idx!=-1)
+    {
+      ExprValue v;
+      v.type = prog.vars[idx].type;
+      v.reg = prog.vars[idx].reg;
+      return v;
+    }
+    if (tok.text=="True")
+      return constant(1.0, true);
+    if (tok.text=="False")
+      return constant(0.0, true);
+    if (tok.text=="pi" || tok.text=="PI")
+      return constant(M_PI);
+    if (tok.text=="e")
+      return constant(M_E);
+    ExprValue v;
+    v.kind = ExprValue::NAME;
+    v.name = tok.text;
+    return v;
+  }
+
+  if (isOp("("))
+  {
+    pos++;
+    if (isOp(")"))
+      error("empty tuples are not supported");
+    ExprValue v = parseTestList();
+    expectOp(")");
+    return v;
+  }
+
+  if (tok.kind==ExprToken::END)
+    error("unexpected end of expression");
+  error("unexpected '"+tok.text+"'");
+  return ExprValue();
+}
+
+// Parse the arguments of a call (the opening parenthesis has already been consumed)
+std::vector<ExprValue> ExprCompiler::parseArgs()
+{
+  std::vector<ExprValue> args;
+  if (isOp(")"))
+  {
+    pos++;
+    return args;
+  }
+  while(1)
+  {
+    args.push_back(parseTest());
+    if (isOp(","))
+    {
+      pos++;
+      if (isOp(")"))
+      {
+        pos++;
+        break;
+      }
+      continue;
+    }
+    expectOp(")");
+    break;
+  }
+  return args;
+}
+
+/**
+  Allocate n consecutive registers and return the index of the first one.
+ */
+int ExprCompiler::allocRegs(int n)
+{
+  int res = int(prog.constregs.size());
+  prog.constregs.resize(res+n, 0.0);
+  isconst.resize(res+n, false);
+  return res;
+}
+
+/**
+  Return a constant.
+ */
+ExprValue ExprCompiler::constant(double v, bool isint)
+{
+  ExprValue res;
+  res.isint = isint;
+  std::map<double, int>::iterator it = constants.find(v);
+  if (it!=constants.end())
+  {
+    res.reg = it->second;
+  }
+  else
+  {
+    res.reg = allocRegs(1);
+    prog.constregs[res.reg] = v;
+    isconst[res.reg] = true;
+    constants[v] = res.reg;
+  }
+  return res;
+}
+
+/**
+  Return the float stored in the given register.
+ */
+ExprValue ExprCompiler::scalar(int reg) const
+{
+  ExprValue res;
+  res.reg = reg;
+  return res;
+}
+
+/**
+  Check if a value is constant.
+ */
+bool ExprCompiler::isConstant(const ExprValue& v) const
+{
+  if (v.kind!=ExprValue::VALUE)
+    return false;
+  for(int k=0; k<v.type; k++)
+  {
+    if (!isconst[v.reg+k])
+      return false;
+  }
+  return true;
+}
+
+/**
+  Raise an error if v is not a value.
+ */
+void ExprCompiler::requireValue(const ExprValue& v) const
+{
+  switch(v.kind)
+  {
+  case ExprValue::VALUE:
+    return;
+  case ExprValue::NAME:
+    error("unsupported name '"+v.name+"'");
+    break;
+  case ExprValue::METHOD:
+    error("method '"+v.name+"' must be called");
+    break;
+  case ExprValue::TUPLE:
+    error("tuples are only supported as result value");
+    break;
+  }
+}
+
+/**
+  Raise an error if v is not a value of the given type.
+ */
+void ExprCompiler::requireType(const ExprValue& v, ExprProgram::Type type, const std::string& func) const
+{
+  requireValue(v);
+  if (v.type!=type)
+    error(std::string("'")+func+"' doesn't support type "+ExprProgram::typeName(v.type));
+}
+
+/**
+  Emit an instruction.
+
+  If all arguments are constant, the instruction is executed immediately
+  and the result is a constant.
+
+  \param op Opcode
+  \param rtype Result type
+  \param imm Immediate value
+  \param args Arguments
+  \param nargs Number of arguments (max. 6)
+  \param dst Destination register (-1: allocate new registers)
+ */
+ExprValue ExprCompiler::emit(short op, ExprProgram::Type rtype, short imm, const ExprValue* args, int nargs, int dst)
+{
+  ExprProgram::Instr in;
+  bool allconst = true;
+  int k;
+
+  in.op = op;
+  in.imm = imm;
+  for(k=0; k<6; k++)
+    in.arg[k] = 0;
+  for(k=0; k<nargs; k++)
+  {
+    requireValue(args[k]);
+    in.arg[k] = args[k].reg;
+    if (!isConstant(args[k]))
+      allconst = false;
+  }
+
+  ExprValue res;
+  res.type = rtype;
+  res.reg = (dst<0)? allocRegs(rtype) : dst;
+  in.dst = res.reg;
+
+  if (allconst)
+  {
+    // A math domain error in a constant subexpression is a compile error
+    // (divisions by zero are handled in run())
+    try
+    {
+      prog.execute(&in, &in+1, &prog.constregs[0], 1, 1);
+    }
+    catch(EValueError& e)
+    {
+      error(e.msg);
+    }
+    for(k=0; k<rtype; k++)
+      isconst[res.reg+k] = true;
+  }
+  else
+  {
+    prog.code.push_back(in);
+  }
+  return res;
+}
+
+ExprValue ExprCompiler::emit(short op, ExprProgram::Type rtype, const ExprValue& a, short imm)
+{
+  return emit(op, rtype, imm, &a, 1);
+}
+
+ExprValue ExprCompiler::emit(short op, ExprProgram::Type rtype, const ExprValue& a, const ExprValue& b, short imm)
+{
+  ExprValue args[2] = {a, b};
+  return emit(op, rtype, imm, args, 2);
+}
+
+ExprValue ExprCompiler::emit(short op, ExprProgram::Type rtype, const ExprValue& a, const ExprValue& b, const ExprValue& c, short imm)
+{
+  ExprValue args[3] = {a, b, c};
+  return emit(op, rtype, imm, args, 3);
+}
+
+/**
+  Combine a number of floats into a vector or matrix.
+ */
+ExprValue ExprCompiler::pack(const std::vector<int>& regs, ExprProgram::Type type)
+{
+  int dst = allocRegs(type);
+  for(int k=0; k<type; k++)
+  {
+    ExprValue v = scalar(regs[k]);
+    emit(OP_MOVE, ExprProgram::FLOAT, 1, &v, 1, dst+k);
+  }
+  ExprValue res;
+  res.type = type;
+  res.reg = dst;
+  return res;
+}
+
+/**
+  Convert a value into the given type.
+
+  This corresponds to calling the constructor of the type with the value.
+ */
+ExprValue ExprCompiler::convert(const ExprValue& v, ExprProgram::Type type)
+{
+  if (v.kind==ExprValue::TUPLE)
+  {
+    std::vector<int> regs(v.items);
+    int n = int(regs.size());
+    if (type==ExprProgram::VEC3 && (n==2 || n==3))
+    {
+      if (n==2)
+        regs.push_back(constant(0.0).reg);
+      return pack(regs, type);
+    }
+    if (n!=int(type))
+      error(std::string("a tuple of that size can't be converted to ")+ExprProgram::typeName(type));
+    return pack(regs, type);
+  }
+
+  requireValue(v);
+  if (v.type==type)
+  {
+    ExprValue res = v;
+    res.isint = false;
+    return res;
+  }
+  if (v.type==ExprProgram::FLOAT)
+  {
+    switch(type)
+    {
+    case ExprProgram::VEC3:
+      return emit(OP_FILL, type, v, 3);
+    case ExprProgram::MAT3:
+      return emit(OP_DIAG, type, v, 3);
+    case ExprProgram::MAT4:
+      return emit(OP_DIAG, type, v, 4);
+    default:
+      break;
+    }
+  }
+  error(std::string("can't convert ")+ExprProgram::typeName(v.type)+" to "+ExprProgram::typeName(type));
+  return v;
+}
+
+/**
+  Unary + and -.
+ */
+ExprValue ExprCompiler::unaryOp(const std::string& op, const ExprValue& a)
+{
+  requireValue(a);
+  if (op=="+")
+    return a;
+
+  ExprValue res;
+  if (a.type==ExprProgram::FLOAT)
+  {
+    res = emit(OP_NEG, a.type, a);
+    res.isint = a.isint;
+  }
+  else
+  {
+    res = emit(OP_ENEG, a.type, a, short(a.type));
+  }
+  return res;
+}
+
+/**
+  Binary arithmetic operators.
+ */
+ExprValue ExprCompiler::binaryOp(const std::string& op, const ExprValue& a, const ExprValue& b)
+{
+  requireValue(a);
+  requireValue(b);
+  ExprProgram::Type ta = a.type;
+  ExprProgram::Type tb = b.type;
+  ExprValue res;
+
+  if (ta==ExprProgram::FLOAT && tb==ExprProgram::FLOAT)
+  {
+    bool isint = a.isint && b.isint;
+    if (op=="+")
+      res = emit(OP_ADD, ta, a, b);
+    else if (op=="-")
+      res = emit(OP_SUB, ta, a, b);
+    else if (op=="*")
+      res = emit(OP_MUL, ta, a, b);
+    // The division of two ints is a floor division in Python 2
+    else if (op=="/")
+      res = emit(isint? OP_FLOORDIV : OP_DIV, ta, a, b);
+    else if (op=="//")
+      res = emit(OP_FLOORDIV, ta, a, b);
+    else if (op=="%")
+      res = emit(OP_MOD, ta, a, b);
+    else
+    {
+      res = emit(OP_POW, ta, a, b);
+      // An int to the power of a negative int is a float
+      isint = isint && isConstant(b) && prog.constregs[b.reg]>=0.0;
+    }
+    res.isint = isint;
+    return res;
+  }
+
+  if (op=="+" || op=="-")
+  {
+    if (ta==tb)
+      return emit((op=="+")? OP_EADD : OP_ESUB, ta, a, b, short(ta));
+  }
+  else if (op=="*")
+  {
+    if (ta==ExprProgram::FLOAT)
+      return emit(OP_EMULS, tb, b, a, short(tb));
+    if (tb==ExprProgram::FLOAT)
+      return emit(OP_EMULS, ta, a, b, short(ta));
+    if (ta==ExprProgram::VEC3 && tb==ExprProgram::VEC3)
+      return emit(OP_DOT, ExprProgram::FLOAT, a, b);
+    if (ta==tb)
+      return emit(OP_MMUL, ta, a, b, (ta==ExprProgram::MAT3)? 3 : 4);
+    if (tb==ExprProgram::VEC3)
+      return emit(OP_MMULV, tb, a, b, (ta==ExprProgram::MAT3)? 3 : 4);
+    if (ta==ExprProgram::VEC3)
+      return emit(OP_VMULM, ta, a, b, (tb==ExprProgram::MAT3)? 3 : 4);
+  }
+  else if (op=="/")
+  {
+    if (tb==ExprProgram::FLOAT)
+      return emit(OP_EDIVS, ta, a, b, short(ta));
+  }
+
+  error("unsupported operand types for "+op+": "+ExprProgram::typeName(ta)+" and "+ExprProgram::typeName(tb));
+  return res;
+}
+
+/**
+  'and' and 'or'.
+ */
+ExprValue ExprCompiler::logicalOp(short op, const ExprValue& a, const ExprValue& b)
+{
+  const char* name = (op==OP_AND)? "and" : "or";
+  requireType(a, ExprProgram::FLOAT, name);
+  requireType(b, ExprProgram::FLOAT, name);
+  ExprValue res = emit(op, ExprProgram::FLOAT, a, b);
+  res.isint = a.isint && b.isint;
+  return res;
+}
+
+/**
+  Conditional expression.
+ */
+ExprValue ExprCompiler::select(const ExprValue& cond, const ExprValue& a, const ExprValue& b)
+{
+  requireType(cond, ExprProgram::FLOAT, "if");
+  requireValue(a);
+  requireValue(b);
+  if (a.type!=b.type)
+    error("both branches of a conditional expression must have the same type");
+
+  if (isConstant(cond))
+    return (prog.constregs[cond.reg]!=0.0)? a : b;
+
+  ExprValue res = emit(OP_SELECT, a.type, cond, a, b, short(a.type));
+  res.isint = a.isint && b.isint;
+  return res;
+}
+
+/**
+  Attribute access.
+ */
+ExprValue ExprCompiler::attribute(const ExprValue& v, const std::string& attr)
+{
+  ExprValue res = v;
+
+  if (v.kind==ExprValue::NAME)
+  {
+    res.name = v.name+"."+attr;
+    if (res.name=="math.pi")
+      return constant(M_PI);
+    if (res.name=="math.e")
+      return constant(M_E);
+    return res;
+  }
+
+  requireValue(v);
+  if (v.type==ExprProgram::VEC3 && attr.size()==1 && attr[0]>='x' && attr[0]<='z')
+  {
+    return scalar(v.reg+(attr[0]-'x'));
+  }
+  if (v.type==ExprProgram::FLOAT)
+    error("float object has no attribute '"+attr+"'");
+
+  res.kind = ExprValue::METHOD;
+  res.name = attr;
+  return res;
+}
+
+/**
+  Index operator (only constant indices on vectors are supported).
+ */
+ExprValue ExprCompiler::subscript(const ExprValue& v, const ExprValue& idx)
+{
+  requireType(v, ExprProgram::VEC3, "[]");
+  requireType(idx, ExprProgram::FLOAT, "[]");
+  if (!isConstant(idx) || !idx.isint)
+    error("only constant int indices are supported");
+  int i = int(prog.constregs[idx.reg]);
+  if (i<0)
+    i += 3;
+  if (i<0 || i>2)
+    error("index out of range");
+  return scalar(v.reg+i);
+}
+
+/**
+  Function calls.
+ */
+ExprValue ExprCompiler::callFunction(const std::string& aname, const std::vector<ExprValue>& args)
+{
+  std::string name = aname;
+  int nargs = int(args.size());
+  ExprValue res;
+  unsigned int i;
+  int k;
+
+  if (name.compare(0, 5, "math.")==0)
+    name = name.substr(5);
+  if (name.compare(0, 6, "noise.")==0 || name.find("_noise")!=std::string::npos || name.find("_cellnoise")!=std::string::npos)
+    return callNoise(name, args);
+
+  // Math functions
+  for(k=0; exprFuncs1[k].name!=0; k++)
+  {
+    if (name==exprFuncs1[k].name && nargs==1)
+    {
+      requireType(args[0], ExprProgram::FLOAT, name);
+      return emit(exprFuncs1[k].op, ExprProgram::FLOAT, args[0]);
+    }
+  }
+  for(k=0; exprFuncs2[k].name!=0; k++)
+  {
+    if (name==exprFuncs2[k].name && nargs==2)
+    {
+      requireType(args[0], ExprProgram::FLOAT, name);
+      requireType(args[1], ExprProgram::FLOAT, name);
+      return emit(exprFuncs2[k].op, ExprProgram::FLOAT, args[0], args[1]);
+    }
+  }
+  if (name=="log" && (nargs==1 || nargs==2))
+  {
+    for(k=0; k<nargs; k++)
+      requireType(args[k], ExprProgram::FLOAT, name);
+    if (nargs==1)
+      return emit(OP_LOG, ExprProgram::FLOAT, args[0]);
+    return emit(OP_LOGB, ExprProgram::FLOAT, args[0], args[1]);
+  }
+
+  // Builtins
+  if (name=="abs" && nargs==1)
+  {
+    requireValue(args[0]);
+    if (args[0].type==ExprProgram::VEC3)
+      return emit(OP_LENGTH, ExprProgram::FLOAT, args[0]);
+    requireType(args[0], ExprProgram::FLOAT, name);
+    res = emit(OP_FABS, ExprProgram::FLOAT, args[0]);
+    res.isint = args[0].isint;
+    return res;
+  }
+  if ((name=="min" || name=="max") && nargs>=2)
+  {
+    res = args[0];
+    requireType(res, ExprProgram::FLOAT, name);
+    for(k=1; k<nargs; k++)
+    {
+      requireType(args[k], ExprProgram::FLOAT, name);
+      bool isint = res.isint && args[k].isint;
+      res = emit((name=="min")? OP_MIN : OP_MAX, ExprProgram::FLOAT, res, args[k]);
+      res.isint = isint;
+    }
+    return res;
+  }
+  if (name=="round" && nargs==1)
+  {
+    requireType(args[0], ExprProgram::FLOAT, name);
+    return emit(OP_ROUND, ExprProgram::FLOAT, args[0]);
+  }
+  if (name=="int" && nargs==1)
+  {
+    requireType(args[0], ExprProgram::FLOAT, name);
+    res = emit(OP_TRUNC, ExprProgram::FLOAT, args[0]);
+    res.isint = true;
+    return res;
+  }
+  if (name=="float" && nargs==1)
+  {
+    requireType(args[0], ExprProgram::FLOAT, name);
+    res = args[0];
+    res.isint = false;
+    return res;
+  }
+
+  // sl functions
+  if (name=="sign" && nargs==1)
+  {
+    requireType(args[0], ExprProgram::FLOAT, name);
+    res = emit(OP_SIGN, ExprProgram::FLOAT, args[0]);
+    res.isint = true;
+    return res;
+  }
+  if ((name=="clamp" || name=="smoothstep") && nargs==3)
+  {
+    for(k=0; k<3; k++)
+      requireType(args[k], ExprProgram::FLOAT, name);
+    if (name=="smoothstep")
+      return emit(OP_SMOOTHSTEP, ExprProgram::FLOAT, args[0], args[1], args[2]);
+    res = emit(OP_CLAMP, ExprProgram::FLOAT, args[0], args[1], args[2]);
+    res.isint = args[0].isint && args[1].isint && args[2].isint;
+    return res;
+  }
+  if (name=="mod" && nargs==2)
+  {
+    return binaryOp("%", args[0], args[1]);
+  }
+  if (name=="mix" && nargs==3)
+  {
+    // (1.0-t)*val0 + t*val1
+    ExprValue s = binaryOp("-", constant(1.0), args[2]);
+    return binaryOp("+", binaryOp("*", s, args[0]), binaryOp("*", args[2], args[1]));
+  }
+  if (name=="length" && nargs==1)
+  {
+    requireType(args[0], ExprProgram::VEC3, name);
+    return emit(OP_LENGTH, ExprProgram::FLOAT, args[0]);
+  }
+  if (name=="normalize" && nargs==1)
+  {
+    requireType(args[0], ExprProgram::VEC3, name);
+    return emit(OP_NORMALIZE, ExprProgram::VEC3, args[0]);
+  }
+  if (name=="distance" && nargs==2)
+  {
+    requireType(args[0], ExprProgram::VEC3, name);
+    requireType(args[1], ExprProgram::VEC3, name);
+    return emit(OP_LENGTH, ExprProgram::FLOAT, binaryOp("-", args[1], args[0]));
+  }
+
+  // Constructors
+  if (name=="vec3" || name=="mat3" || name=="mat4")
+  {
+    ExprProgram::Type type = (name=="vec3")? ExprProgram::VEC3 : ((name=="mat3")? ExprProgram::MAT3 : ExprProgram::MAT4);
+    if (nargs==0)
+      return convert(constant(0.0), type);
+    if (nargs==1)
+      return convert(args[0], type);
+    // Individual components
+    std::vector<int> regs;
+    for(i=0; i<args.size(); i++)
+    {
+      requireType(args[i], ExprProgram::FLOAT, name);
+      regs.push_back(args[i].reg);
+    }
+    if (type==ExprProgram::VEC3 && nargs==2)
+      regs.push_back(constant(0.0).reg);
+    if (int(regs.size())!=int(type))
+      error("invalid number of arguments for "+name+"()");
+    return pack(regs, type);
+  }
+
+  // Static matrix methods
+  if (name=="mat3.identity" && nargs==0)
+    return convert(constant(1.0), ExprProgram::MAT3);
+  if (name=="mat4.identity" && nargs==0)
+    return convert(constant(1.0), ExprProgram::MAT4);
+  if ((name=="mat3.rotation" || name=="mat4.rotation") && nargs==2)
+  {
+    requireType(args[0], ExprProgram::FLOAT, name);
+    requireType(args[1], ExprProgram::VEC3, name);
+    if (name[3]=='3')
+      return emit(OP_ROTATION, ExprProgram::MAT3, args[0], args[1], 3);
+    return emit(OP_ROTATION, ExprProgram::MAT4, args[0], args[1], 4);
+  }
+  if ((name=="mat3.scaling" || name=="mat4.scaling") && nargs==1)
+  {
+    requireType(args[0], ExprProgram::VEC3, name);
+    if (name[3]=='3')
+      return emit(OP_SCALING, ExprProgram::MAT3, args[0], 3);
+    return emit(OP_SCALING, ExprProgram::MAT4, args[0], 4);
+  }
+  if (name=="mat4.translation" && nargs==1)
+  {
+    requireType(args[0], ExprProgram::VEC3, name);
+    return emit(OP_TRANSLATION, ExprProgram::MAT4, args[0]);
+  }
+  if (name.compare(0, 5, "mat3.")==0 && nargs==3)
+  {
+    for(k=0; exprEulerFuncs[k]!=0; k++)
+    {
+      if (name.substr(5)==exprEulerFuncs[k])
+      {
+        for(i=0; i<3; i++)
+          requireType(args[i], ExprProgram::FLOAT, name);
+        return emit(OP_EULER, ExprProgram::MAT3, args[0], args[1], args[2], short(k));
+      }
+    }
+  }
+
+  error("unsupported function '"+aname+"' (or invalid number of arguments)");
+  return res;
+}
+
+/**
+  Method calls.
+ */
+ExprValue ExprCompiler::callMethod(const ExprValue& self, const std::vector<ExprValue>& args)
+{
+  ExprValue obj = self;
+  obj.kind = ExprValue::VALUE;
+  const std::string& name = self.name;
+  int nargs = int(args.size());
+
+  if (self.type==ExprProgram::VEC3)
+  {
+    if (name=="length" && nargs==0)
+      return emit(OP_LENGTH, ExprProgram::FLOAT, obj);
+    if (name=="normalize" && nargs==0)
+      return emit(OP_NORMALIZE, ExprProgram::VEC3, obj);
+    if (name=="cross" && nargs==1)
+    {
+      requireType(args[0], ExprProgram::VEC3, name);
+      return emit(OP_CROSS, ExprProgram::VEC3, obj, args[0]);
+    }
+  }
+  else
+  {
+    short dim = (self.type==ExprProgram::MAT3)? 3 : 4;
+    if (name=="transpose" && nargs==0)
+      return emit(OP_TRANSPOSE, self.type, obj, dim);
+    if (name=="determinant" && nargs==0)
+      return emit(OP_DET, ExprProgram::FLOAT, obj, dim);
+    if (name=="inverse" && nargs==0)
+      return emit(OP_INVERSE, self.type, obj, dim);
+    // Static methods can also be called via an instance
+    return callFunction(std::string(ExprProgram::typeName(self.type))+"."+name, args);
+  }
+
+  error(std::string("unsupported method '")+ExprProgram::typeName(self.type)+"."+name+"'");
+  return obj;
+}
+
+/**
+  Noise functions.
+ */
+ExprValue ExprCompiler::callNoise(const std::string& name, const std::vector<ExprValue>& args)
+{
+  // Split the arguments into floats (a point may only be the first argument)...
+  std::vector<ExprValue> comps;
+  bool haspoint = false;
+  unsigned int i;
+  for(i=0; i<args.size(); i++)
+  {
+    requireValue(args[i]);
+    if (args[i].type==ExprProgram::VEC3 && i==0)
+    {
+      haspoint = true;
+      for(int k=0; k<3; k++)
+        comps.push_back(scalar(args[i].reg+k));
+    }
+    else
+    {
+      requireType(args[i], ExprProgram::FLOAT, name);
+      comps.push_back(args[i]);
+    }
+  }
+  int n = int(comps.size());
+  ExprValue zero = constant(0.0);
+
+  if (n==0 || (n>4 && !haspoint) || (haspoint && args.size()>2 && name!="noise.fBm" && name!="noise.turbulence"))
+    error("invalid arguments for "+name+"()");
+
+  // noise(), snoise()
+  if (name=="noise.noise" || name=="noise.snoise" || name=="float_noise")
+  {
+    bool s = (name=="noise.snoise");
+    if (n==1)
+      comps.push_back(zero);
+    switch(comps.size())
+    {
+    case 2: return emit(s? OP_SNOISE2 : OP_NOISE2, ExprProgram::FLOAT, 0, &comps[0], 2);
+    case 3: return emit(s? OP_SNOISE3 : OP_NOISE3, ExprProgram::FLOAT, 0, &comps[0], 3);
+    default: return emit(s? OP_SNOISE4 : OP_NOISE4, ExprProgram::FLOAT, 0, &comps[0], 4);
+    }
+  }
+
+  // cellnoise(), scellnoise()
+  if (name=="noise.cellnoise" || name=="noise.scellnoise" || name=="float_cellnoise")
+  {
+    while(comps.size()<4)
+      comps.push_back(zero);
+    return emit((name=="noise.scellnoise")? OP_SCELLNOISE : OP_CELLNOISE, ExprProgram::FLOAT, 0, &comps[0], 4);
+  }
+
+  // fBm(), turbulence()
+  if (name=="noise.fBm" || name=="noise.turbulence")
+  {
+    if (!haspoint || n<4 || n>6)
+      error(name+"() expects a vec3 and the number of octaves");
+    // octaves must be an int in Python
+    if (!comps[3].isint)
+      error(name+"(): octaves must be an int");
+    if (n<5)
+      comps.push_back(constant(2.0));
+    if (n<6)
+      comps.push_back(constant(0.5));
+    return emit((name=="noise.fBm")? OP_FBM : OP_TURBULENCE, ExprProgram::FLOAT, 0, &comps[0], 6);
+  }
+
+  // vnoise(), vsnoise()
+  if (name=="noise.vnoise" || name=="noise.vsnoise")
+  {
+    bool s = (name=="noise.vsnoise");
+    // A single float returns a float
+    if (n==1)
+    {
+      comps.push_back(zero);
+      return emit(s? OP_SNOISE2 : OP_NOISE2, ExprProgram::FLOAT, 0, &comps[0], 2);
+    }
+    if (n==3)
+      return emit(s? OP_VSNOISE3 : OP_VNOISE3, ExprProgram::VEC3, 0, &comps[0], 3);
+    if (n==4 && haspoint)
+      return emit(s? OP_VSNOISE4 : OP_VNOISE4, ExprProgram::VEC3, 0, &comps[0], 4);
+    error("only the vec3 versions of "+name+"() are supported");
+  }
+
+  // point_noise()
+  if (name=="point_noise" || name=="vector_noise" || name=="color_noise")
+  {
+    if (n==4)
+      return emit(OP_VNOISE4, ExprProgram::VEC3, 0, &comps[0], 4);
+    while(comps.size()<3)
+      comps.push_back(zero);
+    return emit(OP_VNOISE3, ExprProgram::VEC3, 0, &comps[0], 3);
+  }
+
+  error("unsupported function '"+name+"'");
+  return zero;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+/**
+  Compile an expression.
+
+  The result type is determined by the expression. A tuple with 3, 9 or
+  16 floats is converted into a vec3, mat3 or mat4.
+
+  \param aexpr Expression string
+  \exception EValueError The expression is invalid or uses unsupported features
+ */
+void ExprProgram::compile(const std::string& aexpr)
+{
+  ExprCompiler compiler(*this, aexpr);
+  compiler.run(0);
+}
+
+/**
+  Compile an expression with a given result type.
+
+  The expression value is converted into the given type just like the
+  type constructor would do it (e.g. vec3(x) with a float x returns
+  a vector where all components are x and mat3(x) returns a diagonal
+  matrix).
+
+  \param aexpr Expression string
+  \param restype Result type
+  \exception EValueError The expression is invalid or uses unsupported features
+ */
+void ExprProgram::compile(const std::string& aexpr, Type restype)
+{
+  ExprCompiler compiler(*this, aexpr);
+  compiler.run(&restype);
+}
+
+}  // end of namespace
@@ -59,6 +59,8 @@ GLTexture::GLTexture()
   transform(1),
   imagename(),
   texname(0),
+  image(),
+  hasdata(false),
   flags(0)
 {
 }
@@ -98,6 +100,8 @@ void GLTexture::setImageName(string name)
  */
 void GLTexture::applyGL()
 {
+  TextureImage::deleteReleasedGL();
+
   if (texname==0)
   {
     allocGL();
@@ -112,6 +116,15 @@ void GLTexture::applyGL()
     loadTexData();
   }
 
+  // Upload the image if it has become available (the image might have
+  // been passed by a background thread)
+  if (image.get()!=0)
+  {
+    if (!image->isUploaded())
+      image->uploadGL(internalformat);
+    glBindTexture(GL_TEXTURE_2D, image->getTexName());
+  }
+
   glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, mode);
   GLfloat col[4] = {GLfloat(texenvcolor.x), GLfloat(texenvcolor.y),
                     GLfloat(texenvcolor.z), GLfloat(texenvcolor.w)};
@@ -165,7 +178,10 @@ void GLTexture::releaseGL()
 /**
   Pass the texture data to OpenGL.
 
-  This method has to be called by the texData() method.
+  This method has to be called by the loadTexData() method.
+  8 bit data is stored as a TextureImage (whose mip maps are computed
+  on the CPU) and uploaded by applyGL(), other types are passed to
+  OpenGL immediately.
 
   \param w Width of the texture image (must be a power of 2)
   \param h Height of the texture image (must be a power of 2)
@@ -175,11 +191,48 @@ void GLTexture::releaseGL()
  */
 void GLTexture::texData(int w, int h, int format, int type, char* data)
 {
+  // 8 bit data is converted into a TextureImage which computes the
+  // mip maps itself (and is uploaded by applyGL())...
+  if (type==GL_UNSIGNED_BYTE && TextureImage::numComponents(format)>0)
+  {
+    boost::shared_ptr<TextureImage> img(new TextureImage());
+    img->setData(w, h, format, (const unsigned char*)data, mipmap);
+    setTexImage(img);
+    return;
+  }
+
+  image.reset();
+  glBindTexture(GL_TEXTURE_2D, texname);
   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
   if (mipmap)
     gluBuild2DMipmaps(GL_TEXTURE_2D, internalformat, w, h, format, type, data);
   else
     glTexImage2D(GL_TEXTURE_2D, 0, internalformat, w, h, 0, format, type, data);
+  hasdata = true;
+}
+
+/**
+  Set the texture image.
+
+  The image is uploaded in the next call to applyGL() (if it hasn't
+  been uploaded already by another texture that shares the image).
+  This method doesn't make any OpenGL calls.
+
+  \param aimage Texture image (may be empty)
+ */
+void GLTexture::setTexImage(boost::shared_ptr<TextureImage> aimage)
+{
+  image = aimage;
+}
+
+/**
+  Check if the texture has data.
+
+  \return True if either texData() has been called or a texture image has been set.
+ */
+bool GLTexture::isReady() const
+{
+  return hasdata || image.get()!=0;
 }
 
 
@@ -242,10 +295,24 @@ GLMaterial::~GLMaterial()
   Apply the material using OpenGL commands.
 
   The material settings are only applied to the front faces.
+  This is equivalent to calling applyColorsGL(), applyTextureGL() and
+  applyBlendingGL().
 
   \pre The appropriate OpenGL context has been made current
  */
 void GLMaterial::applyGL()
+{
+  applyColorsGL();
+  applyTextureGL();
+  applyBlendingGL();
+}
+
+/**
+  Set the OpenGL material colors and the shininess.
+
+  \pre The appropriate OpenGL context has been made current
+ */
+void GLMaterial::applyColorsGL()
 {
   GLfloat c[4] = {0,0,0,1};
   GLfloat f;
@@ -280,19 +347,39 @@ void GLMaterial::applyGL()
 
   f = GLfloat(shininess.getValue());
   glMaterialf(GL_FRONT, GL_SHININESS, f);
+}
+
+/**
+  Activate the first texture or disable texturing if there is none.
 
+  \pre The appropriate OpenGL context has been made current
+ */
+void GLMaterial::applyTextureGL()
+{
   boost::shared_ptr<GLTexture> texture = getTexture(0);
   if (texture.get()!=0)
   {
     texture->applyGL();
-    glEnable(GL_TEXTURE_2D);
+    // Keep texturing disabled while the image is still being loaded
+    if (texture->isReady())
+      glEnable(GL_TEXTURE_2D);
+    else
+      glDisable(GL_TEXTURE_2D);
   }
   else
   {
     glDisable(GL_TEXTURE_2D);
   }
+}
 
-  // Blending?
+/**
+  Enable and set up blending if the material uses blending, otherwise
+  disable it.
+
+  \pre The appropriate OpenGL context has been made current
+ */
+void GLMaterial::applyBlendingGL()
+{
   if (usesBlending())
   {
     glEnable(GL_BLEND);
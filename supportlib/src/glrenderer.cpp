@@ -33,11 +33,10 @@
  *
  * ***** END LICENSE BLOCK ***** */
 
+#include <algorithm>
+#include <typeinfo>
 #include "glrenderer.h"
-#include "lightsource.h"
-#include "glpointlight.h"
-#include "glspotlight.h"
-#include "gldistantlight.h"
+#include "tracing.h"
 
 #include "opengl.h"
 
@@ -58,8 +57,15 @@ GLRenderInstance::GLRenderInstance()
   draw_coordsys(true), draw_orientation(true),
   smooth_model(true), backface_culling(false),
   separate_specular_color(false), polygon_mode(2),
-  stereo_mode(0), defaultmat()
+  stereo_mode(0), defaultmat(),
+  stat_objects(0), stat_material_changes(0), stat_texture_changes(0),
+  stat_blend_changes(0), stat_light_changes(0), stat_drawlist_rebuilds(0),
+  drawbuckets(), drawitems(), draworder(), blendorder(),
+  drawlights(), activelights(), max_gl_lights(8), per_object_lights(false),
+  boundlights(), selectedlights(), lightinfluence(),
+  drawlist_root(0), drawlist_serial(0)
 {
+  invalidateState();
 }
 
 /**
@@ -148,8 +154,19 @@ void GLRenderInstance::getViewport(int& x, int& y, int& width, int& height) cons
  */
 void GLRenderInstance::paint(WorldObject& root)
 {
+  TRACE_SCOPE("render", "GLRenderInstance::paint", this);
   double M[16];
 
+  stat_objects = 0;
+  stat_material_changes = 0;
+  stat_texture_changes = 0;
+  stat_blend_changes = 0;
+  stat_light_changes = 0;
+
+  GLint maxlights = 8;
+  glGetIntegerv(GL_MAX_LIGHTS, &maxlights);
+  max_gl_lights = maxlights;
+
   if (stereo_mode==2)
   {
     // Switch to both back buffers for initialization...
@@ -289,6 +306,7 @@ void GLRenderInstance::paint(WorldObject& root)
 
 void GLRenderInstance::drawScene(WorldObject& root, const mat4d& viewmat)
 {
+  TRACE_SCOPE("render", "GLRenderInstance::drawScene", this);
   double M[16];
 
   glLoadIdentity();
@@ -297,179 +315,537 @@ void GLRenderInstance::drawScene(WorldObject& root, const mat4d& viewmat)
 
   // Default light source
   // (this is overwritten if there's at least one light in the scene)
-  GLfloat pos[4] = {0,0,1,0};
-  GLfloat diffuse[4] = {1,1,1,1};
-  GLfloat specular[4] = {1,1,1,1};
-  glLightfv(GL_LIGHT0, GL_POSITION, pos);
-  glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuse);
-  glLightfv(GL_LIGHT0, GL_SPECULAR, specular);
-  glEnable(GL_LIGHT0);
+  resetLights();
 
   // View transformation
   glRotated(180,0,1,0);
   viewmat.toList(M, false);
   glMultMatrixd(M);
 
+  updateDrawList(root);
+
+  // The world transforms also contain the transformation of the root
+  // (and its parents) which is not applied here
+  const mat4d& RW = root.worldtransform.getValue();
+  bool root_identity = (RW==mat4d(1));
+  mat4d RWinv(1);
+  if (!root_identity)
+    RWinv = RW.inverse();
+
   // Apply the light sources
-  applyLights(root);
+  setupLights(RWinv, root_identity);
 
   // Draw the scene
   if (draw_coordsys)
     drawCoordSystem();
-  defaultmat.applyGL();
-  if (drawNode(root, false))
+
+  // Check which materials use blending...
+  std::vector<DrawBucket>::iterator bit;
+  for(bit=drawbuckets.begin(); bit!=drawbuckets.end(); bit++)
+  {
+    bit->blending = (bit->material!=0) && bit->material->usesBlending();
+  }
+
+  // Update the transforms and depths of the visible objects...
+  draworder.clear();
+  blendorder.clear();
+  for(int i=0; i<int(drawitems.size()); i++)
   {
-    // There have been objects that use blending, so draw them now...
+    DrawItem& item = drawitems[i];
+    if (!item.obj->visible.getValue())
+      continue;
+    if (root_identity)
+      item.transform = item.obj->worldtransform.getValue();
+    else
+      item.transform = RWinv*item.obj->worldtransform.getValue();
+    vec4d p = item.transform.getColumn(3);
+    item.depth = (viewmat*vec3d(p.x, p.y, p.z)).z;
+    if (drawbuckets[item.bucket].blending)
+      blendorder.push_back(i);
+    else
+      draworder.push_back(i);
+  }
+
+  // ...and sort them
+  DrawItemOrder order;
+  order.items = &drawitems;
+  order.blended = false;
+  std::sort(draworder.begin(), draworder.end(), order);
+  order.blended = true;
+  std::sort(blendorder.begin(), blendorder.end(), order);
+
+  invalidateState();
+  applyMaterial(defaultmat);
+  drawItems(draworder);
+  if (blendorder.size()>0)
+  {
+    // Objects that use blending don't write into the depth buffer
     glDepthMask(GL_FALSE);
-    drawNode(root, true);
+    drawItems(blendorder);
     glDepthMask(GL_TRUE);
   }
+  // Leave the default material active
+  applyMaterial(defaultmat);
 }
 
 /**
-  Draw a tree.
+  Sort order of the draw list.
 
-  \param node Node
-  \param draw_blends If true, only objects that use blending are drawn. Otherwise objects with
-         blending are not drawn.
-  \return True if the tree contained one or more objects that use blending
+  Opaque objects are sorted by material and front-to-back, blended
+  objects are only sorted back-to-front.
  */
-bool GLRenderInstance::drawNode(WorldObject& node, bool draw_blends)
+bool GLRenderInstance::DrawItemOrder::operator()(int a, int b) const
 {
-  double M[16];
-  BoundingBox bb;
-  vec3d bmin, bmax, t, d;
-  bool render_flag = true;
-  bool res = false;
+  const DrawItem& A = (*items)[a];
+  const DrawItem& B = (*items)[b];
+  if (blended)
+    return A.depth>B.depth;
+  if (A.bucket!=B.bucket)
+    return A.bucket<B.bucket;
+  return A.depth<B.depth;
+}
+
+/**
+  Rebuild the draw list if the structure of the scene has changed.
 
+  \param root The root of the scene
+ */
+void GLRenderInstance::updateDrawList(WorldObject& root)
+{
+  if (&root==drawlist_root && root.getStructureSerial()==drawlist_serial)
+    return;
+
+  TRACE_SCOPE("render", "GLRenderInstance::updateDrawList", this);
+  std::map<Material*, int> bucketmap;
+  drawbuckets.clear();
+  drawitems.clear();
+  drawlights.clear();
+  collectDrawItems(root, bucketmap);
+  drawlist_root = &root;
+  drawlist_serial = root.getStructureSerial();
+  stat_drawlist_rebuilds++;
+  TRACE_COUNTER("render", "drawitems", this, drawitems.size());
+}
+
+/**
+  Add all objects below a node to the draw list.
+
+  \param node Node
+  \param bucketmap Maps a material to its bucket index
+ */
+void GLRenderInstance::collectDrawItems(WorldObject& node, std::map<Material*, int>& bucketmap)
+{
   WorldObject::ChildIterator it;
   for(it=node.childsBegin(); it!=node.childsEnd(); it++)
   {
-    glPushMatrix();
-    // Set the local transformation
-    it->second->localTransform().toList(M);
-    glMultMatrixd(M);
-    // Draw the geom (if visible)
-    boost::shared_ptr<GeomObject> geom = it->second->getGeom();
-    if (geom.get()!=0 && (it->second->visible.getValue()))
+    WorldObject* obj = it->second.get();
+
+    // Is the object a supported light source?
+    LightSource* lgt = dynamic_cast<LightSource*>(obj);
+    if (lgt!=0)
     {
-      // Render by default if draw_blends is false
-      render_flag = !draw_blends;
-
-      // Set material
-      boost::shared_ptr<Material> mat = it->second->getMaterial();
-      Material* bmat = dynamic_cast<Material*>(mat.get());
-      // Check if the object should be postponed because blending is used...
-      if (bmat!=0)
+      DrawLight dl;
+      dl.light = lgt;
+      dl.pointlight = dynamic_cast<GLPointLight*>(lgt);
+      dl.spotlight = dynamic_cast<GLSpotLight*>(lgt);
+      dl.distantlight = dynamic_cast<GLDistantLight*>(lgt);
+      dl.strength = 0.0;
+      if (dl.pointlight!=0 || dl.spotlight!=0 || dl.distantlight!=0)
+        drawlights.push_back(dl);
+    }
+
+    GeomObject* geom = obj->getGeom().get();
+    if (geom!=0)
+    {
+      Material* mat = obj->getMaterial().get();
+      std::map<Material*, int>::iterator mit = bucketmap.find(mat);
+      DrawItem item;
+      if (mit==bucketmap.end())
       {
-        if (bmat->usesBlending())
-        {
-          res = true;
-          render_flag = draw_blends;
-        }
+        DrawBucket bucket;
+        bucket.material = mat;
+        // Only a plain GLMaterial may be applied piece by piece (a derived
+        // class might do something else in its applyGL() method)
+        bucket.glmaterial = 0;
+        if (mat!=0 && typeid(*mat)==typeid(GLMaterial))
+          bucket.glmaterial = static_cast<GLMaterial*>(mat);
+        bucket.blending = false;
+        item.bucket = drawbuckets.size();
+        bucketmap[mat] = item.bucket;
+        drawbuckets.push_back(bucket);
       }
-
-      if (render_flag)
+      else
       {
-        // Set material
-        glPushAttrib(GL_LIGHTING_BIT | GL_TEXTURE_BIT);
-        if (bmat!=0)
-        {
-          bmat->applyGL();
-        }
-
-        if (draw_solid)
-        {
-          geom->drawGL();
-        }
-        // Draw bounding box
-        if (draw_bboxes)
-        {
-          bb = geom->boundingBox();
-          if (!bb.isEmpty())
-          {
-            glDisable(GL_LIGHTING);
-            bb.getBounds(bmin, bmax);
-            t = 0.5*(bmax+bmin);
-            d = bmax-bmin;
-            glPushMatrix();
-            glTranslated(t.x, t.y, t.z);
-            drawWireCube(d.x, d.y, d.z);
-            glPopMatrix();
-            glEnable(GL_LIGHTING);
-          }
-        }
-        glPopAttrib();  // restore material
+        item.bucket = mit->second;
       }
+      item.obj = obj;
+      item.geom = geom;
+      item.depth = 0.0;
+      drawitems.push_back(item);
     }
-    // Draw the children
-    res |= drawNode(*(it->second), draw_blends);
-    glPopMatrix();
+    collectDrawItems(*obj, bucketmap);
   }
-  return res;
 }
 
 /**
-  Walk recursively through a node and switch on all lights.
+  Draw a sequence of draw list items.
+
+  Consecutive items that share a material are drawn without changing
+  the material.
 
-  \param node World object to search for lights
+  \param order Indices of the items to draw
  */
-void GLRenderInstance::applyLights(WorldObject& node)
+void GLRenderInstance::drawItems(const std::vector<int>& order)
+{
+  unsigned int i = 0;
+  while(i<order.size())
+  {
+    int bucketidx = drawitems[order[i]].bucket;
+    DrawBucket& bucket = drawbuckets[bucketidx];
+    // Determine the range of items that use the same material
+    unsigned int end = i+1;
+    while(end<order.size() && drawitems[order[end]].bucket==bucketidx)
+      end++;
+
+    if (bucket.glmaterial!=0)
+    {
+      applyMaterial(*bucket.glmaterial);
+      for(; i<end; i++)
+        drawItem(drawitems[order[i]]);
+    }
+    else if (bucket.material==0)
+    {
+      applyMaterial(defaultmat);
+      for(; i<end; i++)
+        drawItem(drawitems[order[i]]);
+    }
+    else
+    {
+      // Apply an arbitrary material on top of the default material
+      applyMaterial(defaultmat);
+      glPushAttrib(GL_LIGHTING_BIT | GL_TEXTURE_BIT);
+      bucket.material->applyGL();
+      stat_material_changes++;
+      for(; i<end; i++)
+        drawItem(drawitems[order[i]]);
+      glPopAttrib();
+      // The blending state is not restored by glPopAttrib()
+      state_blend_valid = false;
+    }
+  }
+}
+
+/**
+  Draw a single object.
+
+  \param item Draw list item
+ */
+void GLRenderInstance::drawItem(DrawItem& item)
 {
   double M[16];
-  int idx=0;
+  BoundingBox bb;
+  vec3d bmin, bmax, t, d;
 
-  WorldObject::ChildIterator it;
-  for(it=node.childsBegin(); it!=node.childsEnd(); it++)
+  if (per_object_lights)
+    selectLights(item);
+
+  glPushMatrix();
+  item.transform.toList(M);
+  glMultMatrixd(M);
+
+  if (draw_solid)
   {
-    glPushMatrix();
-    // Set the local transformation
-    it->second->localTransform().toList(M);
-    glMultMatrixd(M);
+    item.geom->drawGL();
+    // Colors stored in the geom override the diffuse material color
+    if (item.geom->findVariable("Cs")!=0)
+      state_colors = 0;
+  }
+  // Draw bounding box
+  if (draw_bboxes)
+  {
+    bb = item.geom->boundingBox();
+    if (!bb.isEmpty())
+    {
+      glDisable(GL_LIGHTING);
+      bb.getBounds(bmin, bmax);
+      t = 0.5*(bmax+bmin);
+      d = bmax-bmin;
+      glPushMatrix();
+      glTranslated(t.x, t.y, t.z);
+      drawWireCube(d.x, d.y, d.z);
+      glPopMatrix();
+      glEnable(GL_LIGHTING);
+    }
+  }
+  glPopMatrix();
+  stat_objects++;
+}
 
-    // Check if the object is a light source...
-    LightSource* lgt = dynamic_cast<LightSource*>(it->second.get());
-    if (lgt!=0)
+/**
+  Forget the tracked material state.
+
+  The next call to applyMaterial() will set the entire material state.
+ */
+void GLRenderInstance::invalidateState()
+{
+  state_colors = 0;
+  state_texture = 0;
+  state_texture_valid = false;
+  state_blend_sfactor = -1;
+  state_blend_dfactor = -1;
+  state_blend_valid = false;
+}
+
+/**
+  Apply those parts of a material that differ from the current state.
+
+  \param mat Material
+ */
+void GLRenderInstance::applyMaterial(GLMaterial& mat)
+{
+  if (state_colors!=&mat)
+  {
+    mat.applyColorsGL();
+    state_colors = &mat;
+    stat_material_changes++;
+  }
+
+  GLTexture* tex = mat.getTexture(0).get();
+  if (!state_texture_valid || tex!=state_texture)
+  {
+    mat.applyTextureGL();
+    state_texture = tex;
+    state_texture_valid = true;
+    stat_texture_changes++;
+  }
+
+  int sfactor = -1;
+  int dfactor = -1;
+  if (mat.usesBlending())
+  {
+    sfactor = mat.blend_sfactor;
+    dfactor = mat.blend_dfactor;
+  }
+  if (!state_blend_valid || sfactor!=state_blend_sfactor || dfactor!=state_blend_dfactor)
+  {
+    mat.applyBlendingGL();
+    state_blend_sfactor = sfactor;
+    state_blend_dfactor = dfactor;
+    state_blend_valid = true;
+    stat_blend_changes++;
+  }
+}
+
+/**
+  Switch off all OpenGL lights except the default light 0.
+
+  The previous frame may have left any light enabled and any light
+  source parameters in light 0 (e.g. a spot light cutoff if the lights
+  were bound per object), so light 0 is reset completely.
+  The light position is given in eye coordinates, so the modelview
+  matrix must not contain the view transformation yet.
+ */
+void GLRenderInstance::resetLights()
+{
+  GLfloat pos[4] = {0,0,1,0};
+  GLfloat ambient[4] = {0,0,0,1};
+  GLfloat diffuse[4] = {1,1,1,1};
+  GLfloat specular[4] = {1,1,1,1};
+  GLfloat spotdir[3] = {0,0,-1};
+  glLightfv(GL_LIGHT0, GL_POSITION, pos);
+  glLightfv(GL_LIGHT0, GL_AMBIENT, ambient);
+  glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuse);
+  glLightfv(GL_LIGHT0, GL_SPECULAR, specular);
+  glLightfv(GL_LIGHT0, GL_SPOT_DIRECTION, spotdir);
+  glLightf(GL_LIGHT0, GL_SPOT_EXPONENT, 0.0f);
+  glLightf(GL_LIGHT0, GL_SPOT_CUTOFF, 180.0f);
+  glLightf(GL_LIGHT0, GL_CONSTANT_ATTENUATION, 1.0f);
+  glLightf(GL_LIGHT0, GL_LINEAR_ATTENUATION, 0.0f);
+  glLightf(GL_LIGHT0, GL_QUADRATIC_ATTENUATION, 0.0f);
+  glEnable(GL_LIGHT0);
+  for(int i=1; i<max_gl_lights; i++)
+    glDisable(GL_LIGHT0+i);
+  boundlights.assign(max_gl_lights, -1);
+}
+
+/**
+  Update the enabled light sources and switch them on.
+
+  If there are more lights than OpenGL supports, all OpenGL lights are
+  switched off and the lights are bound per object in selectLights().
+
+  \param RWinv Inverse world transform of the root
+  \param root_identity True if the world transform of the root is the identity
+ */
+void GLRenderInstance::setupLights(const mat4d& RWinv, bool root_identity)
+{
+  activelights.clear();
+  for(int i=0; i<int(drawlights.size()); i++)
+  {
+    DrawLight& lgt = drawlights[i];
+    if (!lgt.light->enabled.getValue())
+      continue;
+    if (root_identity)
+      lgt.transform = lgt.light->worldtransform.getValue();
+    else
+      lgt.transform = RWinv*lgt.light->worldtransform.getValue();
+
+    vec3d dc;
+    if (lgt.pointlight!=0)
+      dc = lgt.pointlight->diffuse.getValue();
+    else if (lgt.spotlight!=0)
+      dc = lgt.spotlight->diffuse.getValue();
+    else
+      dc = lgt.distantlight->diffuse.getValue();
+    lgt.strength = lgt.light->intensity.getValue()*dc.max();
+    activelights.push_back(i);
+  }
+
+  int numlights = activelights.size();
+  per_object_lights = (numlights>max_gl_lights);
+  boundlights.assign(max_gl_lights, -1);
+  if (per_object_lights)
+  {
+    for(int i=0; i<max_gl_lights; i++)
+      glDisable(GL_LIGHT0+i);
+    return;
+  }
+
+  for(int i=0; i<numlights; i++)
+  {
+    applyLight(drawlights[activelights[i]], i);
+    boundlights[i] = activelights[i];
+  }
+  // Switch off the remaining lights (the default light 0 remains
+  // active if there are no lights at all)
+  for(int i=(numlights>0)? numlights : 1; i<max_gl_lights; i++)
+    glDisable(GL_LIGHT0+i);
+}
+
+/// Sorts light indices by decreasing influence.
+struct LightInfluenceOrder
+{
+  const std::vector<double>* influence;
+  bool operator()(int a, int b) const { return (*influence)[a]>(*influence)[b]; }
+};
+
+/**
+  Bind the most influential lights for an object.
+
+  Lights that are already bound to an OpenGL light and that are among
+  the selected lights stay where they are, the remaining selected
+  lights replace the lights that are no longer needed.
+
+  \param item The object that is about to be drawn
+ */
+void GLRenderInstance::selectLights(DrawItem& item)
+{
+  // Determine the bounding sphere of the object...
+  vec3d center(0,0,0);
+  double radius = 0.0;
+  BoundingBox bb = item.geom->boundingBox();
+  if (!bb.isEmpty())
+  {
+    vec3d bmin, bmax;
+    bb.getBounds(bmin, bmax);
+    center = 0.5*(bmin+bmax);
+    double scale = 0.0;
+    for(short j=0; j<3; j++)
     {
-      // Is it a point light?
-      GLPointLight* pntlgt = dynamic_cast<GLPointLight*>(lgt);
-      if (pntlgt!=0)
-      {
-        if (pntlgt->enabled.getValue())
-        {
-          pntlgt->applyGL(idx);
-          glEnable(GL_LIGHT0+idx);
-          idx++;
-        }
-      }
-      // Is it a spot light?
-      GLSpotLight* spotlgt = dynamic_cast<GLSpotLight*>(lgt);
-      if (spotlgt!=0)
-      {
-        if (spotlgt->enabled.getValue())
-        {
-          spotlgt->applyGL(idx);
-          glEnable(GL_LIGHT0+idx);
-          idx++;
-        }
-      }
-      // Is it a distant light?
-      GLDistantLight* dstlgt = dynamic_cast<GLDistantLight*>(lgt);
-      if (dstlgt!=0)
-      {
-        if (dstlgt->enabled.getValue())
-        {
-          dstlgt->applyGL(idx);
-          glEnable(GL_LIGHT0+idx);
-          idx++;
-        }
-      }
+      vec4d c = item.transform.getColumn(j);
+      double len = vec3d(c.x, c.y, c.z).length();
+      if (len>scale)
+        scale = len;
     }
+    radius = 0.5*scale*(bmax-bmin).length();
+  }
+  center = item.transform*center;
+
+  // Compute the influence of every light...
+  int numlights = activelights.size();
+  lightinfluence.resize(numlights);
+  selectedlights.resize(numlights);
+  for(int i=0; i<numlights; i++)
+  {
+    DrawLight& lgt = drawlights[activelights[i]];
+    double w = lgt.strength;
+    if (lgt.distantlight==0)
+    {
+      vec4d p = lgt.transform.getColumn(3);
+      double d = (vec3d(p.x, p.y, p.z)-center).length()-radius;
+      if (d<0.0)
+        d = 0.0;
+      double att;
+      if (lgt.pointlight!=0)
+        att = lgt.pointlight->constant_attenuation.getValue()
+          + d*(lgt.pointlight->linear_attenuation.getValue()
+               + d*lgt.pointlight->quadratic_attenuation.getValue());
+      else
+        att = lgt.spotlight->constant_attenuation.getValue()
+          + d*(lgt.spotlight->linear_attenuation.getValue()
+               + d*lgt.spotlight->quadratic_attenuation.getValue());
+      if (att>0.0)
+        w /= att;
+    }
+    lightinfluence[i] = w;
+    selectedlights[i] = i;
+  }
 
-    // Search the children for lights
-    applyLights(*(it->second));
-    glPopMatrix();
+  // ...and pick the strongest ones
+  LightInfluenceOrder order;
+  order.influence = &lightinfluence;
+  std::partial_sort(selectedlights.begin(), selectedlights.begin()+max_gl_lights, selectedlights.end(), order);
+  for(int i=0; i<max_gl_lights; i++)
+    selectedlights[i] = activelights[selectedlights[i]];
+  selectedlights.resize(max_gl_lights);
+
+  // Keep the lights that are already bound...
+  std::vector<int>::iterator sit;
+  for(int j=0; j<max_gl_lights; j++)
+  {
+    if (boundlights[j]==-1)
+      continue;
+    sit = std::find(selectedlights.begin(), selectedlights.end(), boundlights[j]);
+    if (sit!=selectedlights.end())
+      *sit = -1;
+    else
+      boundlights[j] = -1;
   }
+  // ...and bind the others to the free OpenGL lights
+  int j = 0;
+  for(sit=selectedlights.begin(); sit!=selectedlights.end(); sit++)
+  {
+    if (*sit==-1)
+      continue;
+    while(boundlights[j]!=-1)
+      j++;
+    applyLight(drawlights[*sit], j);
+    boundlights[j] = *sit;
+  }
+}
+
+/**
+  Apply a light source and enable the corresponding OpenGL light.
+
+  \param lgt Light source
+  \param idx OpenGL light index
+ */
+void GLRenderInstance::applyLight(DrawLight& lgt, int idx)
+{
+  double M[16];
+
+  glPushMatrix();
+  lgt.transform.toList(M);
+  glMultMatrixd(M);
+  if (lgt.pointlight!=0)
+    lgt.pointlight->applyGL(idx);
+  else if (lgt.spotlight!=0)
+    lgt.spotlight->applyGL(idx);
+  else
+    lgt.distantlight->applyGL(idx);
+  glPopMatrix();
+  glEnable(GL_LIGHT0+idx);
+  stat_light_changes++;
 }
 
 void GLRenderInstance::drawWireCube(double lx, double ly, double lz)
@@ -0,0 +1,208 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#define DLL_EXPORT_LODGEOM
+#include "lodgeom.h"
+#include <cmath>
+
+#include "opengl.h"
+
+namespace support3d {
+
+LODGeom::LODGeom()
+  : levels(), minsizes(), currentlevel(-1)
+{
+}
+
+/**
+  Return the union of the bounding boxes of all levels.
+ */
+BoundingBox LODGeom::boundingBox()
+{
+  BoundingBox res;
+  for(unsigned int i=0; i<levels.size(); i++)
+  {
+    res.addBoundingBox(levels[i]->boundingBox());
+  }
+  return res;
+}
+
+/**
+  Draw the level that matches the current screen size.
+
+  The screen size is computed from the current OpenGL modelview and
+  projection matrices and the viewport.
+ */
+void LODGeom::drawGL()
+{
+  if (levels.empty())
+  {
+    currentlevel = -1;
+    return;
+  }
+
+  GLdouble modelview[16];
+  GLdouble projection[16];
+  GLint viewport[4];
+  glGetDoublev(GL_MODELVIEW_MATRIX, modelview);
+  glGetDoublev(GL_PROJECTION_MATRIX, projection);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  double size = screenSize(boundingBox(), modelview, projection, viewport[3]);
+  currentlevel = selectLevel(size);
+  levels[currentlevel]->drawGL();
+}
+
+/**
+  Convert the most detailed level.
+ */
+void LODGeom::convert(GeomObject* target)
+{
+  if (levels.empty())
+    throw ENotImplementedError("Conversion of an empty LODGeom is not supported.");
+  levels[0]->convert(target);
+}
+
+/**
+  Add a level of detail.
+
+  \param geom The geometry of this level
+  \param minsize Minimum screen size (in pixels) where this level is used
+ */
+void LODGeom::addLevel(boost::shared_ptr<GeomObject> geom, double minsize)
+{
+  if (geom.get()==0)
+    throw EValueError("The geometry of a level must not be None.");
+  levels.push_back(geom);
+  minsizes.push_back(minsize);
+}
+
+/**
+  Remove all levels.
+ */
+void LODGeom::clearLevels()
+{
+  levels.clear();
+  minsizes.clear();
+  currentlevel = -1;
+}
+
+/**
+  Return the geometry of a level.
+ */
+boost::shared_ptr<GeomObject> LODGeom::getLevel(int idx) const
+{
+  if (idx<0)
+    idx += numLevels();
+  if (idx<0 || idx>=numLevels())
+    throw EIndexError();
+  return levels[idx];
+}
+
+/**
+  Return the minimum screen size of a level.
+ */
+double LODGeom::getMinSize(int idx) const
+{
+  if (idx<0)
+    idx += numLevels();
+  if (idx<0 || idx>=numLevels())
+    throw EIndexError();
+  return minsizes[idx];
+}
+
+/**
+  Return the index of the level that is used for a particular screen size.
+
+  \param screensize Size of the object on screen (in pixels)
+  \return Level index (or -1 if there are no levels)
+ */
+int LODGeom::selectLevel(double screensize) const
+{
+  for(int i=0; i<numLevels(); i++)
+  {
+    if (screensize>=minsizes[i])
+      return i;
+  }
+  return numLevels()-1;
+}
+
+/**
+  Compute the projected size of a bounding box in pixels.
+
+  The size is the projected diameter of the bounding sphere of \a bb.
+  The matrices are given in OpenGL layout (column major).
+  If the camera is inside the bounding sphere, a huge value is returned.
+
+  \param bb Bounding box (in the local coordinate system)
+  \param modelview Modelview matrix (16 values)
+  \param projection Projection matrix (16 values)
+  \param viewportheight Height of the viewport in pixels
+  \return Screen size in pixels.
+ */
+double LODGeom::screenSize(const BoundingBox& bb, const double* modelview, const double* projection, int viewportheight)
+{
+  if (bb.isEmpty())
+    return 0.0;
+
+  vec3d bmin, bmax;
+  bb.getBounds(bmin, bmax);
+  vec3d c = 0.5*(bmin+bmax);
+  double r = 0.5*(bmax-bmin).length();
+
+  // Scale the radius by the largest scaling of the modelview matrix
+  double s = 0.0;
+  for(int i=0; i<3; i++)
+  {
+    const double* col = modelview+4*i;
+    double l = sqrt(col[0]*col[0] + col[1]*col[1] + col[2]*col[2]);
+    if (l>s)
+      s = l;
+  }
+  r *= s;
+
+  // Orthographic projection?
+  if (projection[11]==0.0)
+    return r*fabs(projection[5])*viewportheight;
+
+  // Distance of the center in eye space
+  double z = modelview[2]*c.x + modelview[6]*c.y + modelview[10]*c.z + modelview[14];
+  double dist = -z;
+  if (dist<=r)
+    return 1E30;
+  return r*fabs(projection[5])*viewportheight/dist;
+}
+
+}  // end of namespace
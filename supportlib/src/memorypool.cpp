@@ -0,0 +1,222 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file memorypool.cpp
+ Contains the MemoryPool and SizeClassPools classes.
+ */
+
+#include "memorypool.h"
+#include <new>
+
+namespace support3d {
+
+// Chunks are aligned like doubles and pointers
+static const size_t POOL_ALIGNMENT = (sizeof(double)>sizeof(void*))? sizeof(double) : sizeof(void*);
+
+/**
+  Constructor.
+
+  \param achunksize Size of the chunks in bytes
+  \param achunksperblock Number of chunks that are allocated at once
+ */
+MemoryPool::MemoryPool(size_t achunksize, size_t achunksperblock)
+  : chunksize(achunksize), chunksperblock(achunksperblock),
+    freelist(0), blocks(), numallocated(0)
+{
+  if (chunksize<sizeof(void*))
+    chunksize = sizeof(void*);
+  chunksize = (chunksize+POOL_ALIGNMENT-1)/POOL_ALIGNMENT*POOL_ALIGNMENT;
+  if (chunksperblock<1)
+    chunksperblock = 1;
+}
+
+/**
+  Destructor.
+
+  The blocks are only freed if no chunk is in use anymore. Otherwise
+  the memory is leaked on purpose as there are still objects living in
+  it (this can happen for objects that are deleted during program
+  shutdown after the pool has been destroyed).
+ */
+MemoryPool::~MemoryPool()
+{
+  release();
+}
+
+/**
+  Return the memory to the system.
+
+  This is only possible if no chunk is in use.
+
+  \return True if the memory was released.
+ */
+bool MemoryPool::release()
+{
+  if (numallocated!=0)
+    return false;
+
+  for(unsigned int i=0; i<blocks.size(); i++)
+  {
+    ::operator delete(blocks[i]);
+  }
+  blocks.clear();
+  freelist = 0;
+  return true;
+}
+
+/**
+  Allocate a new block and add its chunks to the free list.
+ */
+void MemoryPool::allocateBlock()
+{
+  blocks.reserve(blocks.size()+1);
+  char* block = (char*)::operator new(chunksize*chunksperblock);
+  blocks.push_back(block);
+
+  // Link the chunks (the first chunk will be used first)
+  char* p = block+chunksize*(chunksperblock-1);
+  *(void**)p = freelist;
+  while(p!=block)
+  {
+    char* prev = p-chunksize;
+    *(void**)prev = p;
+    p = prev;
+  }
+  freelist = block;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+/**
+  Constructor.
+
+  \param amaxsize Maximum object size that is allocated from a pool
+  \param achunksperblock Number of chunks per block for each pool
+ */
+SizeClassPools::SizeClassPools(size_t amaxsize, size_t achunksperblock)
+  : pools(), maxsize(amaxsize), chunksperblock(achunksperblock)
+{
+}
+
+SizeClassPools::~SizeClassPools()
+{
+  // The pools are only deleted if they are not used anymore (see
+  // ~MemoryPool())
+  for(unsigned int i=0; i<pools.size(); i++)
+  {
+    if (pools[i]->getNumAllocated()==0)
+      delete pools[i];
+  }
+}
+
+/**
+  Allocate memory for an object of the given size.
+ */
+void* SizeClassPools::allocate(size_t size)
+{
+  if (size>maxsize)
+    return ::operator new(size);
+  return findPool(size)->allocate();
+}
+
+/**
+  Free the memory of an object.
+
+  \param p Pointer returned by allocate()
+  \param size The size that was passed to allocate()
+ */
+void SizeClassPools::deallocate(void* p, size_t size)
+{
+  if (p==0)
+    return;
+  if (size>maxsize)
+    ::operator delete(p);
+  else
+    findPool(size)->deallocate(p);
+}
+
+/**
+  Return the number of objects that are currently allocated from the pools.
+ */
+size_t SizeClassPools::getNumAllocated() const
+{
+  size_t res = 0;
+  for(unsigned int i=0; i<pools.size(); i++)
+    res += pools[i]->getNumAllocated();
+  return res;
+}
+
+/**
+  Return the number of bytes that the pools have allocated from the system.
+ */
+size_t SizeClassPools::getReservedBytes() const
+{
+  size_t res = 0;
+  for(unsigned int i=0; i<pools.size(); i++)
+    res += pools[i]->getReservedBytes();
+  return res;
+}
+
+/**
+  Return the memory of all unused pools to the system.
+ */
+void SizeClassPools::release()
+{
+  for(unsigned int i=0; i<pools.size(); i++)
+    pools[i]->release();
+}
+
+/**
+  Return the pool for objects of the given size.
+
+  A new pool is created if there is none yet. There are usually only a
+  handful of different sizes, so a linear search is used.
+
+  \param size Object size
+ */
+MemoryPool* SizeClassPools::findPool(size_t size)
+{
+  size_t chunksize = (size+POOL_ALIGNMENT-1)/POOL_ALIGNMENT*POOL_ALIGNMENT;
+  for(unsigned int i=0; i<pools.size(); i++)
+  {
+    if (pools[i]->getChunkSize()==chunksize)
+      return pools[i];
+  }
+  MemoryPool* pool = new MemoryPool(chunksize, chunksperblock);
+  pools.push_back(pool);
+  return pool;
+}
+
+}  // end of namespace
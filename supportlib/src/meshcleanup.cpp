@@ -0,0 +1,599 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <math.h>
+#include <algorithm>
+#include "meshcleanup.h"
+#include "trimeshgeom.h"
+#include "vertexcacheoptimizer.h"
+#include "vec4.h"
+#include "mat4.h"
+
+namespace support3d {
+
+// Comparison functions that are used to compare primitive variable values
+static inline bool valueClose(int a, int b, double) { return a==b; }
+static inline bool valueClose(double a, double b, double eps) { return fabs(a-b)<=eps; }
+static inline bool valueClose(const vec3d& a, const vec3d& b, double eps) 
+{ 
+  return fabs(a.x-b.x)<=eps && fabs(a.y-b.y)<=eps && fabs(a.z-b.z)<=eps; 
+}
+static inline bool valueClose(const vec4d& a, const vec4d& b, double eps) 
+{ 
+  return fabs(a.x-b.x)<=eps && fabs(a.y-b.y)<=eps && fabs(a.z-b.z)<=eps && fabs(a.w-b.w)<=eps;
+}
+static inline bool valueClose(const mat4d& a, const mat4d& b, double) { return a==b; }
+static inline bool valueClose(const std::string& a, const std::string& b, double) { return a==b; }
+
+// Compare value i and j of an array slot (all items of a multi-valued slot)
+template<class T>
+static bool slotValuesClose(IArraySlot* slot, int i, int j, double eps)
+{
+  ArraySlot<T>* aslot = dynamic_cast<ArraySlot<T>*>(slot);
+  if (aslot==0)
+    return true;
+  const T* a = aslot->getValues(i);
+  const T* b = aslot->getValues(j);
+  for(int k=0; k<aslot->multiplicity(); k++)
+  {
+    if (!valueClose(a[k], b[k], eps))
+      return false;
+  }
+  return true;
+}
+
+// Face used during duplicate detection (vertices in canonical order)
+struct SortFace
+{
+  int v[3];
+  int face;
+
+  bool operator<(const SortFace& f) const
+  {
+    if (v[0]!=f.v[0]) return v[0]<f.v[0];
+    if (v[1]!=f.v[1]) return v[1]<f.v[1];
+    if (v[2]!=f.v[2]) return v[2]<f.v[2];
+    return face<f.face;
+  }
+  bool sameVerts(const SortFace& f) const
+  {
+    return v[0]==f.v[0] && v[1]==f.v[1] && v[2]==f.v[2];
+  }
+};
+
+// Hash function for the spatial hash
+static inline unsigned long cellHash(long cx, long cy, long cz)
+{
+  return ((unsigned long)cx*73856093UL) ^ ((unsigned long)cy*19349663UL) ^ ((unsigned long)cz*83492791UL);
+}
+
+/**
+  Constructor.
+
+  \param amesh The mesh that will be modified
+ */
+MeshCleanup::MeshCleanup(TriMeshGeom& amesh)
+  : mesh(amesh)
+{
+}
+
+/**
+  Merge vertices that are closer than \a eps.
+
+  Each vertex is either kept as the representative of its neighborhood
+  or it is replaced by the first representative that is within the
+  distance \a eps. If \a comparevars is true, the varying and vertex
+  variables of the two vertices have to match as well (floating point
+  values may differ by at most \a eps).
+
+  Only the faces are modified (the merged vertices remain in the vertex
+  array until removeUnusedVerts() is called).
+
+  \param eps Maximum distance between two vertices that get merged (0 merges only identical vertices)
+  \param comparevars If true, varying and vertex variables have to match as well
+  \return Number of merged vertices.
+ */
+int MeshCleanup::weldVertices(double eps, bool comparevars)
+{
+  int numverts = mesh.verts.size();
+  int numfaces = mesh.faces.size();
+  int i;
+
+  if (numverts==0)
+    return 0;
+
+  std::vector<PrimVarInfo*> vars;
+  if (comparevars)
+    collectVariables(VARYING, VERTEX, vars);
+
+  const vec3d* vertsptr = mesh.verts.getValues(0);
+  if (eps<0.0)
+    eps = 0.0;
+  double eps2 = eps*eps;
+
+  // Determine the cell size of the hash grid...
+  vec3d bmin, bmax;
+  bmin = bmax = vertsptr[0];
+  for(i=1; i<numverts; i++)
+  {
+    const vec3d& v = vertsptr[i];
+    if (v.x<bmin.x) bmin.x = v.x;
+    if (v.y<bmin.y) bmin.y = v.y;
+    if (v.z<bmin.z) bmin.z = v.z;
+    if (v.x>bmax.x) bmax.x = v.x;
+    if (v.y>bmax.y) bmax.y = v.y;
+    if (v.z>bmax.z) bmax.z = v.z;
+  }
+  double extent = std::max(bmax.x-bmin.x, std::max(bmax.y-bmin.y, bmax.z-bmin.z));
+  // With eps=0 only identical vertices are merged, so only the
+  // cell of a vertex has to be searched. Otherwise, the neighboring
+  // cells have to be searched as well.
+  int ring = (eps>0.0)? 1 : 0;
+  double cellsize = eps;
+  if (cellsize<=0.0)
+    cellsize = extent/pow(double(numverts), 1.0/3.0);
+  // Avoid overflows of the cell coordinates
+  if (cellsize<extent*1E-9)
+    cellsize = extent*1E-9;
+  if (cellsize<=0.0)
+    cellsize = 1.0;
+
+  // Hash table (the size is a power of 2)
+  unsigned long tablesize = 1;
+  while(tablesize<2*(unsigned long)numverts)
+    tablesize *= 2;
+  unsigned long mask = tablesize-1;
+  std::vector<int> head(tablesize, -1);
+  std::vector<int> next(numverts, -1);
+  std::vector<int> remap(numverts);
+  int merged = 0;
+
+  for(i=0; i<numverts; i++)
+  {
+    const vec3d& v = vertsptr[i];
+    long cx = long(floor((v.x-bmin.x)/cellsize));
+    long cy = long(floor((v.y-bmin.y)/cellsize));
+    long cz = long(floor((v.z-bmin.z)/cellsize));
+    int rep = -1;
+
+    // Search the neighborhood for a representative...
+    for(long dx=-ring; dx<=ring && rep==-1; dx++)
+    {
+      for(long dy=-ring; dy<=ring && rep==-1; dy++)
+      {
+        for(long dz=-ring; dz<=ring && rep==-1; dz++)
+        {
+          int j = head[cellHash(cx+dx, cy+dy, cz+dz)&mask];
+          for( ; j!=-1; j=next[j])
+          {
+            vec3d d = vertsptr[j]-v;
+            if (d.x*d.x+d.y*d.y+d.z*d.z<=eps2 && (vars.empty() || varsEqual(vars, i, j, eps)))
+            {
+              rep = j;
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    if (rep==-1)
+    {
+      // Vertex i becomes a new representative
+      unsigned long h = cellHash(cx, cy, cz)&mask;
+      next[i] = head[h];
+      head[h] = i;
+      remap[i] = i;
+    }
+    else
+    {
+      remap[i] = rep;
+      merged++;
+    }
+  }
+
+  if (merged==0)
+    return 0;
+
+  // Update the faces...
+  std::vector<int> facedata(3*numfaces);
+  for(i=0; i<numfaces; i++)
+  {
+    const int* f = mesh.faces.getValues(i);
+    for(int k=0; k<3; k++)
+    {
+      if (f[k]<0 || f[k]>=numverts)
+        throw EIndexError("Vertex index out of range.");
+      facedata[3*i+k] = remap[f[k]];
+    }
+  }
+  setFaces(facedata);
+  return merged;
+}
+
+/**
+  Remove degenerate faces.
+
+  A face is degenerate if it references a vertex more than once or if
+  its area is zero. Faces that reference a vertex that is out of
+  range are removed as well.
+
+  \return Number of removed faces.
+ */
+int MeshCleanup::removeDegenerateFaces()
+{
+  int numverts = mesh.verts.size();
+  int numfaces = mesh.faces.size();
+  std::vector<int> keepfaces;
+  keepfaces.reserve(numfaces);
+
+  for(int i=0; i<numfaces; i++)
+  {
+    const int* f = mesh.faces.getValues(i);
+    if (f[0]==f[1] || f[1]==f[2] || f[0]==f[2])
+      continue;
+    if (f[0]<0 || f[0]>=numverts || f[1]<0 || f[1]>=numverts || f[2]<0 || f[2]>=numverts)
+      continue;
+    const vec3d* vertsptr = mesh.verts.getValues(0);
+    vec3d c = (vertsptr[f[1]]-vertsptr[f[0]]).cross(vertsptr[f[2]]-vertsptr[f[0]]);
+    if (c.x==0.0 && c.y==0.0 && c.z==0.0)
+      continue;
+    keepfaces.push_back(i);
+  }
+
+  int removed = numfaces-int(keepfaces.size());
+  if (removed>0)
+    applyFaceSelection(keepfaces);
+  return removed;
+}
+
+/**
+  Remove duplicate faces.
+
+  A face is a duplicate if a previous face references the same
+  vertices in the same cyclic order. Faces with opposite orientation
+  are not considered to be duplicates.
+
+  \return Number of removed faces.
+ */
+int MeshCleanup::removeDuplicateFaces()
+{
+  int numfaces = mesh.faces.size();
+  int i;
+  std::vector<SortFace> sortfaces(numfaces);
+
+  // Rotate the vertices of each face so that the smallest index comes first
+  for(i=0; i<numfaces; i++)
+  {
+    const int* f = mesh.faces.getValues(i);
+    int k = 0;
+    if (f[1]<f[k]) k = 1;
+    if (f[2]<f[k]) k = 2;
+    SortFace& sf = sortfaces[i];
+    sf.v[0] = f[k];
+    sf.v[1] = f[(k+1)%3];
+    sf.v[2] = f[(k+2)%3];
+    sf.face = i;
+  }
+  std::sort(sortfaces.begin(), sortfaces.end());
+
+  // Mark all faces that have the same vertices as their predecessor
+  std::vector<bool> duplicate(numfaces, false);
+  int removed = 0;
+  for(i=1; i<numfaces; i++)
+  {
+    if (sortfaces[i].sameVerts(sortfaces[i-1]))
+    {
+      duplicate[sortfaces[i].face] = true;
+      removed++;
+    }
+  }
+
+  if (removed==0)
+    return 0;
+
+  std::vector<int> keepfaces;
+  keepfaces.reserve(numfaces-removed);
+  for(i=0; i<numfaces; i++)
+  {
+    if (!duplicate[i])
+      keepfaces.push_back(i);
+  }
+  applyFaceSelection(keepfaces);
+  return removed;
+}
+
+/**
+  Remove all vertices that aren't referenced by any face.
+
+  The remaining vertices keep their relative order.
+
+  \return Number of removed vertices.
+ */
+int MeshCleanup::removeUnusedVerts()
+{
+  int numverts = mesh.verts.size();
+  int numfaces = mesh.faces.size();
+  int i;
+  std::vector<int> newindex(numverts, -1);
+  std::vector<int> facedata(3*numfaces);
+
+  for(i=0; i<numfaces; i++)
+  {
+    const int* f = mesh.faces.getValues(i);
+    for(int k=0; k<3; k++)
+    {
+      if (f[k]<0 || f[k]>=numverts)
+        throw EIndexError("Vertex index out of range.");
+      newindex[f[k]] = 0;
+      facedata[3*i+k] = f[k];
+    }
+  }
+
+  std::vector<int> keepverts;
+  keepverts.reserve(numverts);
+  for(i=0; i<numverts; i++)
+  {
+    if (newindex[i]!=-1)
+    {
+      newindex[i] = int(keepverts.size());
+      keepverts.push_back(i);
+    }
+  }
+
+  int removed = numverts-int(keepverts.size());
+  if (removed==0)
+    return 0;
+
+  for(i=0; i<3*numfaces; i++)
+    facedata[i] = newindex[facedata[i]];
+  setFaces(facedata);
+
+  // Compact the vertices and all varying/vertex variables
+  int n = int(keepverts.size());
+  std::vector<PrimVarInfo*> vars;
+  collectVariables(VARYING, VERTEX, vars);
+  if (n>0)
+  {
+    mesh.verts.gatherValues(&keepverts[0], n);
+    for(i=0; i<int(vars.size()); i++)
+      vars[i]->slot->gatherValues(&keepverts[0], n);
+  }
+  mesh.verts.resize(n);
+  return removed;
+}
+
+/**
+  Run the entire cleanup pipeline.
+
+  \param eps Maximum distance between two vertices that get merged
+  \param comparevars If true, varying and vertex variables have to match for two vertices to get merged
+  \return Total number of removed vertices and faces.
+ */
+int MeshCleanup::run(double eps, bool comparevars)
+{
+  weldVertices(eps, comparevars);
+  int res = removeDegenerateFaces();
+  res += removeDuplicateFaces();
+  res += removeUnusedVerts();
+  return res;
+}
+
+/**
+  Reorder the faces and vertices for a better memory locality.
+
+  The faces are reordered using the VertexCacheOptimizer, then the
+  vertices are sorted by their first use (see reorderVertices()).
+  All primitive variables are reordered as well. The geometry of the
+  mesh doesn't change.
+
+  \param cachesize Size of the simulated vertex cache
+ */
+void MeshCleanup::optimizeVertexCache(int cachesize)
+{
+  int numfaces = mesh.faces.size();
+  if (numfaces==0)
+    return;
+
+  std::vector<int> order;
+  VertexCacheOptimizer vco(cachesize);
+  vco.optimize(mesh.faces.getValues(0), numfaces, mesh.verts.size(), order);
+  applyFaceSelection(order);
+  reorderVertices();
+}
+
+/**
+  Sort the vertices by their first use in the faces.
+
+  Vertices that aren't used by any face are moved to the end (in their
+  original order). Varying and vertex variables are reordered as well.
+ */
+void MeshCleanup::reorderVertices()
+{
+  int numverts = mesh.verts.size();
+  int numfaces = mesh.faces.size();
+  int i;
+  std::vector<int> newindex(numverts, -1);
+  std::vector<int> order;
+  std::vector<int> facedata(3*numfaces);
+  order.reserve(numverts);
+
+  const int* fptr = (numfaces>0)? mesh.faces.getValues(0) : 0;
+  for(i=0; i<3*numfaces; i++)
+  {
+    int v = fptr[i];
+    if (v<0 || v>=numverts)
+      throw EIndexError("Vertex index out of range.");
+    if (newindex[v]==-1)
+    {
+      newindex[v] = int(order.size());
+      order.push_back(v);
+    }
+    facedata[i] = newindex[v];
+  }
+  for(i=0; i<numverts; i++)
+  {
+    if (newindex[i]==-1)
+    {
+      newindex[i] = int(order.size());
+      order.push_back(i);
+    }
+  }
+
+  if (numverts==0)
+    return;
+  setFaces(facedata);
+  std::vector<PrimVarInfo*> vars;
+  collectVariables(VARYING, VERTEX, vars);
+  mesh.verts.gatherValues(&order[0], numverts);
+  for(i=0; i<int(vars.size()); i++)
+    vars[i]->slot->gatherValues(&order[0], numverts);
+}
+
+/**
+  Check if the values of two vertices match in all the given variables.
+ */
+bool MeshCleanup::varsEqual(const std::vector<PrimVarInfo*>& vars, int i, int j, double eps) const
+{
+  for(unsigned int k=0; k<vars.size(); k++)
+  {
+    if (!valuesEqual(*vars[k], i, j, eps))
+      return false;
+  }
+  return true;
+}
+
+/**
+  Check if two values of a primitive variable are equal.
+
+  Floating point values may differ by at most \a eps, all other
+  types have to match exactly.
+
+  \param var The primitive variable
+  \param i Index of the first value
+  \param j Index of the second value
+  \param eps Tolerance for floating point values
+ */
+bool MeshCleanup::valuesEqual(const PrimVarInfo& var, int i, int j, double eps)
+{
+  switch(var.type)
+  {
+  case INT: return slotValuesClose<int>(var.slot, i, j, eps);
+  case FLOAT: return slotValuesClose<double>(var.slot, i, j, eps);
+  case COLOR:
+  case POINT:
+  case VECTOR:
+  case NORMAL: return slotValuesClose<vec3d>(var.slot, i, j, eps);
+  case HPOINT: return slotValuesClose<vec4d>(var.slot, i, j, eps);
+  case MATRIX: return slotValuesClose<mat4d>(var.slot, i, j, eps);
+  case STRING: return slotValuesClose<std::string>(var.slot, i, j, eps);
+  }
+  return true;
+}
+
+/**
+  Collect all primitive variables with storage class \a s1 or \a s2.
+ */
+void MeshCleanup::collectVariables(VarStorage s1, VarStorage s2, std::vector<PrimVarInfo*>& res) const
+{
+  GeomObject::VariableIterator it;
+  for(it=mesh.variablesBegin(); it!=mesh.variablesEnd(); it++)
+  {
+    if (it->second.storage==s1 || it->second.storage==s2)
+      res.push_back(const_cast<PrimVarInfo*>(&(it->second)));
+  }
+}
+
+/**
+  Only keep the given faces (and their uniform and facevarying values).
+
+  \param keepfaces Indices of the faces that are kept (in the new order)
+ */
+void MeshCleanup::applyFaceSelection(const std::vector<int>& keepfaces)
+{
+  int n = int(keepfaces.size());
+  unsigned int i;
+
+  if (n>0)
+  {
+    std::vector<PrimVarInfo*> vars;
+    collectVariables(UNIFORM, UNIFORM, vars);
+    for(i=0; i<vars.size(); i++)
+      vars[i]->slot->gatherValues(&keepfaces[0], n);
+
+    vars.clear();
+    collectVariables(FACEVARYING, FACEVERTEX, vars);
+    if (!vars.empty())
+    {
+      std::vector<int> keepcorners(3*n);
+      for(int j=0; j<n; j++)
+      {
+        keepcorners[3*j] = 3*keepfaces[j];
+        keepcorners[3*j+1] = 3*keepfaces[j]+1;
+        keepcorners[3*j+2] = 3*keepfaces[j]+2;
+      }
+      for(i=0; i<vars.size(); i++)
+        vars[i]->slot->gatherValues(&keepcorners[0], 3*n);
+    }
+
+    mesh.faces.gatherValues(&keepfaces[0], n);
+  }
+  mesh.faces.resize(n);
+}
+
+/**
+  Replace the vertex indices of all faces (the number of faces doesn't change).
+ */
+void MeshCleanup::setFaces(const std::vector<int>& facedata)
+{
+  int numfaces = mesh.faces.size();
+  if (numfaces==0)
+    return;
+
+  if (mesh.faces.getController()==0)
+  {
+    int* ptr = mesh.faces.dataPtr();
+    for(int i=0; i<3*numfaces; i++)
+      ptr[i] = facedata[i];
+    mesh.faces.notifyDependents();
+  }
+  else
+  {
+    for(int i=0; i<numfaces; i++)
+      mesh.faces.setValues(i, &facedata[3*i]);
+  }
+}
+
+}  // end of namespace
@@ -0,0 +1,682 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <math.h>
+#include <algorithm>
+#include "meshdecimator.h"
+#include "meshcleanup.h"
+#include "trimeshgeom.h"
+
+namespace support3d {
+
+// Weight of the boundary quadrics (relative to the face quadrics)
+static const double BORDER_WEIGHT = 10.0;
+// Minimum cosine between the old and new normal of a face during a collapse
+static const double MIN_NORMAL_COS = 0.2;
+// Minimum ratio between the (doubled) face area and the sum of the squared edge lengths
+static const double MIN_FACE_QUALITY = 1E-3;
+
+// Edge used for detecting boundary and non-manifold edges
+struct DecimatorEdge
+{
+  int v1, v2;
+  int face;
+
+  bool operator<(const DecimatorEdge& e) const
+  {
+    if (v1!=e.v1) return v1<e.v1;
+    return v2<e.v2;
+  }
+};
+
+// Vertex index sorted by position (used to detect seams)
+struct PositionLess
+{
+  const std::vector<vec3d>& verts;
+  PositionLess(const std::vector<vec3d>& averts) : verts(averts) {}
+  bool operator()(int a, int b) const
+  {
+    const vec3d& p = verts[a];
+    const vec3d& q = verts[b];
+    if (p.x!=q.x) return p.x<q.x;
+    if (p.y!=q.y) return p.y<q.y;
+    return p.z<q.z;
+  }
+};
+
+void MeshDecimator::Quadric::addPlane(const vec3d& n, double d, double w)
+{
+  a2 += w*n.x*n.x; ab += w*n.x*n.y; ac += w*n.x*n.z; ad += w*n.x*d;
+  b2 += w*n.y*n.y; bc += w*n.y*n.z; bd += w*n.y*d;
+  c2 += w*n.z*n.z; cd += w*n.z*d;
+  d2 += w*d*d;
+}
+
+void MeshDecimator::Quadric::add(const Quadric& q)
+{
+  a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+  b2 += q.b2; bc += q.bc; bd += q.bd;
+  c2 += q.c2; cd += q.cd;
+  d2 += q.d2;
+}
+
+double MeshDecimator::Quadric::eval(const vec3d& p) const
+{
+  double x = p.x;
+  double y = p.y;
+  double z = p.z;
+  double res = a2*x*x + 2*ab*x*y + 2*ac*x*z + 2*ad*x
+             + b2*y*y + 2*bc*y*z + 2*bd*y
+             + c2*z*z + 2*cd*z
+             + d2;
+  // Avoid tiny negative values due to rounding errors
+  return (res<0.0)? 0.0 : res;
+}
+
+/**
+  Constructor.
+
+  \param asource Source mesh (it is not modified)
+ */
+MeshDecimator::MeshDecimator(TriMeshGeom& asource)
+  : source(asource), verts(), faces(), facealive(), numalive(0),
+    facenormals(), vertfaces(), quadrics(), vertflags(), versions(), marks(), stamp(0),
+    queue(), error(0.0)
+{
+}
+
+/**
+  Simplify the source mesh and store the result in \a target.
+
+  The mesh is simplified until it has at most \a targetfaces faces or
+  until the next collapse would exceed the error \a maxerror (the
+  error is the sum of the squared distances to the original planes).
+  A negative \a maxerror means there is no error bound. The result
+  may have more faces than requested if no more edges can be collapsed.
+
+  All primitive variables of the source mesh are copied to the target
+  mesh (any existing variables in the target mesh are deleted).
+
+  \param target Target mesh (must not be the source mesh)
+  \param targetfaces Target number of faces
+  \param maxerror Maximum error (or a negative value)
+  \return Number of faces in the result.
+ */
+int MeshDecimator::decimate(TriMeshGeom& target, int targetfaces, double maxerror)
+{
+  init();
+  run(targetfaces, maxerror);
+  writeMesh(target);
+  return numalive;
+}
+
+/**
+  Create several levels of detail in one pass.
+
+  This is equivalent to calling decimate() for each face count but the
+  simplification is only done once. The face counts must be given in
+  descending order. If the error bound stops the simplification, the
+  remaining targets receive the last state.
+
+  \param targets Target meshes (one per face count)
+  \param facecounts Target number of faces for each target mesh
+  \param maxerror Maximum error (or a negative value)
+ */
+void MeshDecimator::decimateLODs(const std::vector<TriMeshGeom*>& targets, const std::vector<int>& facecounts, double maxerror)
+{
+  if (targets.size()!=facecounts.size())
+    throw EValueError("The number of targets and face counts must match.");
+  for(unsigned int i=1; i<facecounts.size(); i++)
+  {
+    if (facecounts[i]>facecounts[i-1])
+      throw EValueError("The face counts must be given in descending order.");
+  }
+
+  init();
+  for(unsigned int i=0; i<targets.size(); i++)
+  {
+    run(facecounts[i], maxerror);
+    writeMesh(*targets[i]);
+  }
+}
+
+/**
+  Copy the source mesh and initialize the quadrics and the queue.
+ */
+void MeshDecimator::init()
+{
+  int numverts = source.verts.size();
+  int numfaces = source.faces.size();
+  int i;
+
+  verts.resize(numverts);
+  if (numverts>0)
+  {
+    const vec3d* vptr = source.verts.getValues(0);
+    std::copy(vptr, vptr+numverts, verts.begin());
+  }
+  faces.resize(3*numfaces);
+  if (numfaces>0)
+  {
+    const int* fptr = source.faces.getValues(0);
+    for(i=0; i<3*numfaces; i++)
+    {
+      if (fptr[i]<0 || fptr[i]>=numverts)
+        throw EIndexError("Vertex index out of range.");
+      faces[i] = fptr[i];
+    }
+  }
+
+  facealive.assign(numfaces, true);
+  numalive = numfaces;
+  vertfaces.assign(numverts, std::vector<int>());
+  for(i=0; i<3*numfaces; i++)
+    vertfaces[faces[i]].push_back(i/3);
+  quadrics.assign(numverts, Quadric());
+  vertflags.assign(numverts, 0);
+  versions.assign(numverts, 0);
+  marks.assign(numverts, 0);
+  stamp = 0;
+  queue = std::priority_queue<Collapse>();
+  error = 0.0;
+
+  classifyVertices();
+  initQuadrics();
+
+  // Fill the queue with all possible collapses...
+  std::vector<int> nb;
+  for(i=0; i<numverts; i++)
+  {
+    if (vertflags[i]&LOCKED)
+      continue;
+    neighbors(i, nb);
+    for(unsigned int j=0; j<nb.size(); j++)
+      pushCollapse(i, nb[j]);
+  }
+}
+
+/**
+  Initialize the quadrics with the face planes and the boundary planes.
+ */
+void MeshDecimator::initQuadrics()
+{
+  int numfaces = int(facealive.size());
+  int i;
+
+  facenormals.assign(numfaces, vec3d(0,0,0));
+
+  for(i=0; i<numfaces; i++)
+  {
+    const vec3d& a = verts[faces[3*i]];
+    const vec3d& b = verts[faces[3*i+1]];
+    const vec3d& c = verts[faces[3*i+2]];
+    vec3d n = (b-a).cross(c-a);
+    double len = n.length();
+    if (len==0.0)
+      continue;
+    n /= len;
+    facenormals[i] = n;
+    double d = -(n*a);
+    for(int k=0; k<3; k++)
+      quadrics[faces[3*i+k]].addPlane(n, d, 1.0);
+  }
+
+  // Add a plane perpendicular to the face for each boundary edge...
+  for(i=0; i<numfaces; i++)
+  {
+    for(int k=0; k<3; k++)
+    {
+      int v1 = faces[3*i+k];
+      int v2 = faces[3*i+(k+1)%3];
+      if (!((vertflags[v1]&BORDER) && (vertflags[v2]&BORDER)))
+        continue;
+      // Is this a boundary edge? (it has only one face)
+      int count = 0;
+      const std::vector<int>& vf = vertfaces[v1];
+      for(unsigned int j=0; j<vf.size(); j++)
+      {
+        const int* f = &faces[3*vf[j]];
+        if (f[0]==v2 || f[1]==v2 || f[2]==v2)
+          count++;
+      }
+      if (count!=1)
+        continue;
+      vec3d e = verts[v2]-verts[v1];
+      vec3d n = e.cross(facenormals[i]);
+      double len = n.length();
+      if (len==0.0)
+        continue;
+      n /= len;
+      double d = -(n*verts[v1]);
+      quadrics[v1].addPlane(n, d, BORDER_WEIGHT);
+      quadrics[v2].addPlane(n, d, BORDER_WEIGHT);
+    }
+  }
+}
+
+/**
+  Mark boundary vertices and lock seam and non-manifold vertices.
+ */
+void MeshDecimator::classifyVertices()
+{
+  int numverts = int(verts.size());
+  int numfaces = int(facealive.size());
+  int i, j;
+
+  // Boundary and non-manifold edges...
+  std::vector<DecimatorEdge> edges(3*numfaces);
+  for(i=0; i<numfaces; i++)
+  {
+    for(int k=0; k<3; k++)
+    {
+      int a = faces[3*i+k];
+      int b = faces[3*i+(k+1)%3];
+      DecimatorEdge& e = edges[3*i+k];
+      e.v1 = std::min(a,b);
+      e.v2 = std::max(a,b);
+      e.face = i;
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  for(i=0; i<int(edges.size()); i=j)
+  {
+    for(j=i+1; j<int(edges.size()) && edges[j].v1==edges[i].v1 && edges[j].v2==edges[i].v2; j++) {}
+    if (j-i==1)
+    {
+      vertflags[edges[i].v1] |= BORDER;
+      vertflags[edges[i].v2] |= BORDER;
+    }
+    else if (j-i>2)
+    {
+      vertflags[edges[i].v1] |= LOCKED;
+      vertflags[edges[i].v2] |= LOCKED;
+    }
+  }
+
+  // Seams of varying/vertex variables (several vertices at the same position)...
+  std::vector<int> order(numverts);
+  for(i=0; i<numverts; i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), PositionLess(verts));
+  for(i=0; i<numverts; i=j)
+  {
+    for(j=i+1; j<numverts && verts[order[j]]==verts[order[i]]; j++) {}
+    if (j-i>1)
+    {
+      for(int k=i; k<j; k++)
+        vertflags[order[k]] |= LOCKED;
+    }
+  }
+
+  // Discontinuities of facevarying/facevertex variables...
+  GeomObject::VariableIterator it;
+  for(it=source.variablesBegin(); it!=source.variablesEnd(); it++)
+  {
+    const PrimVarInfo& info = it->second;
+    if (info.storage!=FACEVARYING && info.storage!=FACEVERTEX)
+      continue;
+    for(i=0; i<numverts; i++)
+    {
+      const std::vector<int>& vf = vertfaces[i];
+      int first = -1;
+      for(j=0; j<int(vf.size()) && !(vertflags[i]&LOCKED); j++)
+      {
+        const int* f = &faces[3*vf[j]];
+        int corner = 3*vf[j] + ((f[0]==i)? 0 : ((f[1]==i)? 1 : 2));
+        if (first==-1)
+          first = corner;
+        else if (!MeshCleanup::valuesEqual(info, first, corner))
+          vertflags[i] |= LOCKED;
+      }
+    }
+  }
+}
+
+/**
+  Do collapses until the target face count or the error bound is reached.
+ */
+void MeshDecimator::run(int targetfaces, double maxerror)
+{
+  while(numalive>targetfaces && !queue.empty())
+  {
+    Collapse c = queue.top();
+    // Outdated entry?
+    if ((vertflags[c.from]&DEAD) || (vertflags[c.to]&DEAD) || versions[c.from]!=c.fromversion || versions[c.to]!=c.toversion)
+    {
+      queue.pop();
+      continue;
+    }
+    // Error bound exceeded? (the collapse remains in the queue)
+    if (maxerror>=0.0 && c.cost>maxerror)
+      break;
+    queue.pop();
+    if (!isValidCollapse(c.from, c.to))
+      continue;
+    collapse(c.from, c.to);
+    if (c.cost>error)
+      error = c.cost;
+  }
+}
+
+/**
+  Collect the neighbors of a vertex (each neighbor is only stored once).
+ */
+void MeshDecimator::neighbors(int v, std::vector<int>& res)
+{
+  res.clear();
+  stamp++;
+  marks[v] = stamp;
+  const std::vector<int>& vf = vertfaces[v];
+  for(unsigned int i=0; i<vf.size(); i++)
+  {
+    if (!facealive[vf[i]])
+      continue;
+    const int* f = &faces[3*vf[i]];
+    for(int k=0; k<3; k++)
+    {
+      if (marks[f[k]]!=stamp)
+      {
+        marks[f[k]] = stamp;
+        res.push_back(f[k]);
+      }
+    }
+  }
+}
+
+/**
+  Add the collapse from->to to the queue.
+ */
+void MeshDecimator::pushCollapse(int from, int to)
+{
+  if (vertflags[from]&(LOCKED|DEAD))
+    return;
+  Quadric q = quadrics[from];
+  q.add(quadrics[to]);
+  Collapse c;
+  c.cost = q.eval(verts[to]);
+  c.from = from;
+  c.to = to;
+  c.fromversion = versions[from];
+  c.toversion = versions[to];
+  queue.push(c);
+}
+
+/**
+  Check if the collapse from->to would keep the mesh intact.
+ */
+bool MeshDecimator::isValidCollapse(int from, int to)
+{
+  if ((vertflags[from]&(LOCKED|DEAD)) || (vertflags[to]&DEAD))
+    return false;
+
+  // Number of faces that share the edge
+  int shared = 0;
+  const std::vector<int>& vf = vertfaces[from];
+  unsigned int i;
+  for(i=0; i<vf.size(); i++)
+  {
+    if (!facealive[vf[i]])
+      continue;
+    const int* f = &faces[3*vf[i]];
+    if (f[0]==to || f[1]==to || f[2]==to)
+      shared++;
+  }
+  if (shared==0)
+    return false;
+  // Boundary vertices may only move along the boundary
+  if ((vertflags[from]&BORDER) && shared!=1)
+    return false;
+  // Don't let a component disappear entirely (i.e. if all faces of
+  // both vertices would be removed)
+  int remaining = 0;
+  const std::vector<int>& tf = vertfaces[to];
+  for(i=0; i<vf.size(); i++)
+  {
+    if (facealive[vf[i]])
+      remaining++;
+  }
+  for(i=0; i<tf.size(); i++)
+  {
+    if (facealive[tf[i]])
+      remaining++;
+  }
+  if (remaining==2*shared)
+    return false;
+
+  // Link condition: The common neighbors of both vertices must be the
+  // vertices opposite to the edge.
+  std::vector<int> nb;
+  neighbors(to, nb);
+  int tostamp = stamp;
+  stamp++;
+  int common = 0;
+  for(i=0; i<vf.size(); i++)
+  {
+    if (!facealive[vf[i]])
+      continue;
+    const int* f = &faces[3*vf[i]];
+    for(int k=0; k<3; k++)
+    {
+      int w = f[k];
+      if (w!=from && w!=to && marks[w]==tostamp)
+      {
+        // Mark the vertex so that it's only counted once
+        marks[w] = stamp;
+        common++;
+      }
+    }
+  }
+  if (common!=shared)
+    return false;
+
+  // Check that no face flips or becomes degenerate
+  const vec3d& pto = verts[to];
+  for(i=0; i<vf.size(); i++)
+  {
+    if (!facealive[vf[i]])
+      continue;
+    const int* f = &faces[3*vf[i]];
+    if (f[0]==to || f[1]==to || f[2]==to)
+      continue;
+    vec3d p[3];
+    for(int k=0; k<3; k++)
+      p[k] = verts[f[k]];
+    vec3d n0 = (p[1]-p[0]).cross(p[2]-p[0]);
+    for(int k=0; k<3; k++)
+    {
+      if (f[k]==from)
+        p[k] = pto;
+    }
+    vec3d n1 = (p[1]-p[0]).cross(p[2]-p[0]);
+    double l0 = n0.length();
+    double l1 = n1.length();
+    // Reject degenerate faces and slivers
+    double e2 = (p[1]-p[0])*(p[1]-p[0]) + (p[2]-p[1])*(p[2]-p[1]) + (p[0]-p[2])*(p[0]-p[2]);
+    if (l1<=MIN_FACE_QUALITY*e2)
+      return false;
+    if (l0>0.0 && (n0*n1)<MIN_NORMAL_COS*l0*l1)
+      return false;
+    // Also compare with the original normal so that faces can't
+    // gradually turn over during several collapses
+    if ((facenormals[vf[i]]*n1)<MIN_NORMAL_COS*l1)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+  Collapse vertex \a from into vertex \a to.
+ */
+void MeshDecimator::collapse(int from, int to)
+{
+  std::vector<int>& vf = vertfaces[from];
+  std::vector<int>& tf = vertfaces[to];
+  unsigned int i;
+
+  for(i=0; i<vf.size(); i++)
+  {
+    int face = vf[i];
+    if (!facealive[face])
+      continue;
+    int* f = &faces[3*face];
+    if (f[0]==to || f[1]==to || f[2]==to)
+    {
+      facealive[face] = false;
+      numalive--;
+    }
+    else
+    {
+      for(int k=0; k<3; k++)
+      {
+        if (f[k]==from)
+          f[k] = to;
+      }
+      tf.push_back(face);
+    }
+  }
+  vf.clear();
+  vertflags[from] |= DEAD;
+
+  // Remove dead faces from the face list of the remaining vertex
+  std::vector<int> alive;
+  alive.reserve(tf.size());
+  for(i=0; i<tf.size(); i++)
+  {
+    if (facealive[tf[i]])
+      alive.push_back(tf[i]);
+  }
+  tf.swap(alive);
+
+  quadrics[to].add(quadrics[from]);
+  versions[to]++;
+
+  // Update the collapses involving the remaining vertex
+  std::vector<int> nb;
+  neighbors(to, nb);
+  for(i=0; i<nb.size(); i++)
+  {
+    if (nb[i]==to)
+      continue;
+    pushCollapse(to, nb[i]);
+    pushCollapse(nb[i], to);
+  }
+}
+
+// Copy the values idx[i] of slot src to position i of slot dst
+static void copyGathered(IArraySlot& src, IArraySlot& dst, const std::vector<int>& idx)
+{
+  if (!idx.empty())
+    dst.gatherValues(&idx[0], int(idx.size()), &src);
+}
+
+/**
+  Write the current state into a mesh.
+ */
+void MeshDecimator::writeMesh(TriMeshGeom& target)
+{
+  if (&target==&source)
+    throw EValueError("The target mesh must not be the source mesh.");
+
+  int numverts = int(verts.size());
+  int numfaces = int(facealive.size());
+  int i;
+
+  std::vector<int> keepfaces;
+  std::vector<int> keepcorners;
+  std::vector<int> newindex(numverts, -1);
+  keepfaces.reserve(numalive);
+  keepcorners.reserve(3*numalive);
+  for(i=0; i<numfaces; i++)
+  {
+    if (!facealive[i])
+      continue;
+    keepfaces.push_back(i);
+    for(int k=0; k<3; k++)
+    {
+      keepcorners.push_back(3*i+k);
+      newindex[faces[3*i+k]] = 0;
+    }
+  }
+  std::vector<int> keepverts;
+  for(i=0; i<numverts; i++)
+  {
+    if (newindex[i]!=-1)
+    {
+      newindex[i] = int(keepverts.size());
+      keepverts.push_back(i);
+    }
+  }
+
+  target.deleteAllVariables();
+  target.faces.resize(0);
+  target.verts.resize(int(keepverts.size()));
+  target.faces.resize(int(keepfaces.size()));
+  copyGathered(source.verts, target.verts, keepverts);
+  std::vector<int> facedata(3*keepfaces.size());
+  for(i=0; i<int(keepcorners.size()); i++)
+    facedata[i] = newindex[faces[keepcorners[i]]];
+  MeshCleanup(target).setFaces(facedata);
+
+  // Copy the primitive variables...
+  GeomObject::VariableIterator it;
+  for(it=source.variablesBegin(); it!=source.variablesEnd(); it++)
+  {
+    const PrimVarInfo& info = it->second;
+    int n = info.slot->size();
+    target.newVariable(it->first, info.storage, info.type, info.multiplicity, (info.storage==USER)? n : 0);
+    IArraySlot& dst = *(target.findVariable(it->first)->slot);
+    switch(info.storage)
+    {
+    case UNIFORM:
+      copyGathered(*info.slot, dst, keepfaces);
+      break;
+    case VARYING:
+    case VERTEX:
+      copyGathered(*info.slot, dst, keepverts);
+      break;
+    case FACEVARYING:
+    case FACEVERTEX:
+      copyGathered(*info.slot, dst, keepcorners);
+      break;
+    default:
+      if (n>0)
+        info.slot->copyValues(0, n, dst, 0);
+      break;
+    }
+  }
+}
+
+}  // end of namespace
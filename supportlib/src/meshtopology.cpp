@@ -0,0 +1,493 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include "meshtopology.h"
+#include "common_exceptions.h"
+
+namespace support3d {
+
+MeshTopology::MeshTopology()
+  : numverts(0), numfaces(0), heorigin(), henext(), heprev(), hetwin(),
+    heface(), facehalfedge(), vertoffsets(1, 0), vertout()
+{
+}
+
+/**
+  Build the topology of a triangle mesh.
+
+  Half-edge 3*f+k corresponds to corner k of face f.
+
+  \param faces Vertex indices (3 per face)
+  \param anumfaces Number of faces
+  \param anumverts Number of vertices
+ */
+void MeshTopology::buildTriangles(const int* faces, int anumfaces, int anumverts)
+{
+  int i;
+  int n = 3*anumfaces;
+
+  numfaces = anumfaces;
+  numverts = anumverts;
+  heorigin.assign(faces, faces+n);
+  henext.resize(n);
+  heprev.resize(n);
+  heface.resize(n);
+  facehalfedge.resize(numfaces);
+
+#ifdef _OPENMP
+  #pragma omp parallel for if(numfaces>=256)
+#endif
+  for(i=0; i<numfaces; i++)
+  {
+    int he = 3*i;
+    henext[he] = he+1;
+    henext[he+1] = he+2;
+    henext[he+2] = he;
+    heprev[he] = he+2;
+    heprev[he+1] = he;
+    heprev[he+2] = he+1;
+    heface[he] = i;
+    heface[he+1] = i;
+    heface[he+2] = i;
+    facehalfedge[i] = he;
+  }
+
+  build(n);
+}
+
+/**
+  Build the topology of a general polygon mesh.
+
+  The loops are given in CSR layout, i.e. the vertices of loop i are
+  stored in loopverts[loopoffsets[i]] ... loopverts[loopoffsets[i+1]-1].
+  The half-edges are numbered like the entries in \a loopverts. The loops
+  of a face must be stored consecutively and the first loop of a face
+  is its outer boundary. Faces without any loop have no half-edge (their
+  faceHalfEdge() value is -1).
+
+  \param loopoffsets Loop offsets (number of loops + 1 items)
+  \param loopverts Vertex indices of all loops
+  \param loopfaces Face index of each loop
+  \param anumfaces Number of faces
+  \param anumverts Number of vertices
+ */
+void MeshTopology::buildLoops(const std::vector<int>& loopoffsets, const std::vector<int>& loopverts, const std::vector<int>& loopfaces, int anumfaces, int anumverts)
+{
+  int i;
+  int numloops = int(loopfaces.size());
+  int n = int(loopverts.size());
+
+  if (int(loopoffsets.size())!=numloops+1 || loopoffsets[numloops]!=n)
+    throw EValueError("Invalid loop offsets.");
+
+  numfaces = anumfaces;
+  numverts = anumverts;
+  heorigin = loopverts;
+  henext.resize(n);
+  heprev.resize(n);
+  heface.resize(n);
+  facehalfedge.assign(numfaces, -1);
+
+  for(i=0; i<numloops; i++)
+  {
+    int start = loopoffsets[i];
+    int end = loopoffsets[i+1];
+    int f = loopfaces[i];
+    if (f<0 || f>=numfaces)
+      throw EIndexError("Loop face index out of range.");
+    if (end<=start)
+      continue;
+    if (facehalfedge[f]==-1)
+      facehalfedge[f] = start;
+    for(int he=start; he<end; he++)
+    {
+      henext[he] = (he+1<end)? he+1 : start;
+      heprev[he] = (he>start)? he-1 : end-1;
+      heface[he] = f;
+    }
+  }
+
+  build(n);
+}
+
+/**
+  Remove all faces and vertices.
+ */
+void MeshTopology::clear()
+{
+  numverts = 0;
+  numfaces = 0;
+  heorigin.clear();
+  henext.clear();
+  heprev.clear();
+  hetwin.clear();
+  heface.clear();
+  facehalfedge.clear();
+  vertoffsets.assign(1, 0);
+  vertout.clear();
+}
+
+/**
+  Build the vertex incidence table and connect the twin half-edges.
+
+  Expects heorigin, henext, heprev and heface to be initialized.
+  Half-edges that reference a vertex that is out of range are not
+  stored in the incidence table and never have a twin.
+
+  Two half-edges are only connected if they are the only two half-edges
+  along their edge and if they have opposite orientations. So edges that
+  are shared by more than two faces or edges between faces that have
+  inconsistent orientations are treated as boundary edges.
+
+  \param numhalfedges Number of half-edges
+ */
+void MeshTopology::build(int numhalfedges)
+{
+  int i;
+
+  // Count the number of outgoing half-edges per vertex...
+  vertoffsets.assign(numverts+1, 0);
+  for(i=0; i<numhalfedges; i++)
+  {
+    int v = heorigin[i];
+    if (v>=0 && v<numverts)
+      vertoffsets[v+1]++;
+  }
+  // ...turn the counts into offsets...
+  for(i=0; i<numverts; i++)
+  {
+    vertoffsets[i+1] += vertoffsets[i];
+  }
+  // ...and fill in the half-edges
+  vertout.resize(vertoffsets[numverts]);
+  std::vector<int> fill(vertoffsets.begin(), vertoffsets.end()-1);
+  for(i=0; i<numhalfedges; i++)
+  {
+    int v = heorigin[i];
+    if (v>=0 && v<numverts)
+    {
+      vertout[fill[v]] = i;
+      fill[v]++;
+    }
+  }
+
+  // Find the opposite half-edge b->a of every half-edge a->b by searching
+  // the outgoing half-edges of b. The candidate is only accepted if it
+  // is unique and if there is no other half-edge a->b.
+  std::vector<int> candidates(numhalfedges);
+#ifdef _OPENMP
+  #pragma omp parallel for if(numfaces>=256)
+#endif
+  for(i=0; i<numhalfedges; i++)
+  {
+    int a = heorigin[i];
+    int b = heorigin[henext[i]];
+    int res = -1;
+    if (a>=0 && a<numverts && b>=0 && b<numverts && a!=b)
+    {
+      int start = vertoffsets[b];
+      int end = vertoffsets[b+1];
+      for(int j=start; j<end; j++)
+      {
+        int he = vertout[j];
+        if (heorigin[henext[he]]==a)
+        {
+          if (res==-1)
+          {
+            res = he;
+          }
+          else
+          {
+            res = -1;
+            break;
+          }
+        }
+      }
+    }
+    candidates[i] = res;
+  }
+
+  hetwin.resize(numhalfedges);
+#ifdef _OPENMP
+  #pragma omp parallel for if(numfaces>=256)
+#endif
+  for(i=0; i<numhalfedges; i++)
+  {
+    int he = candidates[i];
+    hetwin[i] = (he!=-1 && candidates[he]==i)? he : -1;
+  }
+}
+
+/**
+  Return the number of edges.
+
+  Every pair of twin half-edges counts as one edge, every half-edge
+  without a twin counts as one edge as well.
+ */
+int MeshTopology::getNumEdges() const
+{
+  int res = 0;
+  int n = getNumHalfEdges();
+  for(int i=0; i<n; i++)
+  {
+    if (hetwin[i]<i)
+      res++;
+  }
+  return res;
+}
+
+/**
+  Check if a vertex lies on the boundary.
+
+  A vertex is a boundary vertex if any of its outgoing or incoming
+  half-edges has no twin. Isolated vertices are not boundary vertices.
+
+  \param v Vertex index
+ */
+bool MeshTopology::isBoundaryVertex(int v) const
+{
+  if (v<0 || v>=numverts)
+    throw EIndexError("Vertex index out of range.");
+  return boundaryStart(v)!=-1;
+}
+
+/**
+  Return an outgoing half-edge of v that starts a fan of faces.
+
+  This is preferably an outgoing half-edge without twin, otherwise the
+  successor of an incoming half-edge without twin. Returns -1 if v is an interior vertex.
+ */
+int MeshTopology::boundaryStart(int v) const
+{
+  int start = vertoffsets[v];
+  int end = vertoffsets[v+1];
+  int j;
+  for(j=start; j<end; j++)
+  {
+    if (hetwin[vertout[j]]==-1)
+      return vertout[j];
+  }
+  // Only an incoming boundary half-edge (this only happens at
+  // non-manifold vertices)
+  for(j=start; j<end; j++)
+  {
+    if (hetwin[heprev[vertout[j]]]==-1)
+      return vertout[j];
+  }
+  return -1;
+}
+
+/**
+  Return the neighbor vertices of a vertex.
+
+  For manifold vertices the neighbors are returned in the order of
+  the faces around the vertex (which is counter-clockwise for
+  counter-clockwise faces). For boundary vertices the ring starts and
+  ends at a boundary neighbor. For non-manifold vertices the neighbors
+  are returned in no particular order. Each neighbor is only reported
+  once.
+
+  \param v Vertex index
+  \param[out] res Receives the neighbor vertex indices
+ */
+void MeshTopology::vertexRing(int v, std::vector<int>& res) const
+{
+  if (v<0 || v>=numverts)
+    throw EIndexError("Vertex index out of range.");
+
+  res.clear();
+  int numout = numOutgoing(v);
+  if (numout==0)
+    return;
+
+  // Walk around the vertex...
+  int start = boundaryStart(v);
+  bool boundary = (start!=-1);
+  if (!boundary)
+    start = vertout[vertoffsets[v]];
+  int he = start;
+  int steps = 0;
+  while(steps<numout)
+  {
+    res.push_back(target(he));
+    steps++;
+    int prevhe = heprev[he];
+    he = hetwin[prevhe];
+    if (he==-1)
+    {
+      res.push_back(heorigin[prevhe]);
+      break;
+    }
+    if (he==start)
+      break;
+  }
+
+  // Was every face visited exactly once? Then the vertex is manifold.
+  if (steps==numout && (he==-1 || he==start))
+  {
+    // Drop the last vertex again if it was already reported (this
+    // happens at a boundary vertex of a single face)
+    if (res.size()>1 && res.back()==res.front())
+      res.pop_back();
+    return;
+  }
+
+  // Non-manifold vertex: Collect the neighbors without any order
+  res.clear();
+  for(int j=vertoffsets[v]; j<vertoffsets[v+1]; j++)
+  {
+    int outhe = vertout[j];
+    int nbs[2] = {target(outhe), heorigin[heprev[outhe]]};
+    for(int k=0; k<2; k++)
+    {
+      if (nbs[k]==v)
+        continue;
+      bool found = false;
+      for(unsigned int l=0; l<res.size(); l++)
+      {
+        if (res[l]==nbs[k])
+        {
+          found = true;
+          break;
+        }
+      }
+      if (!found)
+        res.push_back(nbs[k]);
+    }
+  }
+}
+
+/**
+  Return the faces that use a vertex.
+
+  A face is reported once per corner that references the vertex.
+
+  \param v Vertex index
+  \param[out] res Receives the face indices
+ */
+void MeshTopology::vertexFaces(int v, std::vector<int>& res) const
+{
+  if (v<0 || v>=numverts)
+    throw EIndexError("Vertex index out of range.");
+
+  res.clear();
+  for(int j=vertoffsets[v]; j<vertoffsets[v+1]; j++)
+  {
+    res.push_back(heface[vertout[j]]);
+  }
+}
+
+/**
+  Return the neighbor faces of a face.
+
+  The result contains one entry per half-edge of the face (in the order
+  of the half-edges, starting with faceHalfEdge()). Half-edges without
+  twin (boundary edges) produce the value -1. The half-edges of holes
+  are included as well.
+
+  \param f Face index
+  \param[out] res Receives the face indices
+ */
+void MeshTopology::faceNeighbors(int f, std::vector<int>& res) const
+{
+  if (f<0 || f>=numfaces)
+    throw EIndexError("Face index out of range.");
+
+  res.clear();
+  int first = facehalfedge[f];
+  if (first==-1)
+    return;
+  // Visit the outer loop and then all hole loops (which directly follow
+  // the outer loop in the half-edge array)
+  int n = getNumHalfEdges();
+  for(int he=first; he<n && heface[he]==f; he++)
+  {
+    int tw = hetwin[he];
+    res.push_back((tw==-1)? -1 : heface[tw]);
+  }
+}
+
+/**
+  Return all boundary loops.
+
+  Each loop is a list of vertex indices. A boundary loop runs along the
+  half-edges that have no twin, so its orientation is the same as the
+  orientation of the adjacent faces.
+
+  \param[out] res Receives the loops
+ */
+void MeshTopology::boundaryLoops(std::vector<std::vector<int> >& res) const
+{
+  int n = getNumHalfEdges();
+  std::vector<char> visited(n, 0);
+
+  res.clear();
+  for(int i=0; i<n; i++)
+  {
+    if (hetwin[i]!=-1 || visited[i])
+      continue;
+    int v = heorigin[i];
+    if (v<0 || v>=numverts)
+      continue;
+
+    res.push_back(std::vector<int>());
+    std::vector<int>& loop = res.back();
+    int he = i;
+    while(!visited[he])
+    {
+      visited[he] = 1;
+      loop.push_back(heorigin[he]);
+      // Rotate around the end vertex until the next boundary half-edge
+      // is found (the number of steps is limited in case the vertex
+      // is non-manifold)
+      int w = target(he);
+      if (w<0 || w>=numverts)
+        break;
+      int maxsteps = numOutgoing(w);
+      int nexthe = henext[he];
+      int steps = 0;
+      while(hetwin[nexthe]!=-1 && steps<maxsteps)
+      {
+        nexthe = henext[hetwin[nexthe]];
+        steps++;
+      }
+      if (hetwin[nexthe]!=-1)
+        break;
+      he = nexthe;
+    }
+  }
+}
+
+}  // end of namespace
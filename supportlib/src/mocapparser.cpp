@@ -0,0 +1,1001 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <map>
+#include "mocapparser.h"
+#include "mat3.h"
+#include "common_exceptions.h"
+
+namespace support3d {
+
+// Exactly representable powers of 10
+static const double mocapPow10[23] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Create a syntax error message
+static string mocapError(int line, const string& msg)
+{
+  char buf[32];
+  sprintf(buf, "%d", line);
+  return "Syntax error in line "+string(buf)+": "+msg;
+}
+
+// Convert a number into a string
+static string mocapStr(int v)
+{
+  char buf[32];
+  sprintf(buf, "%d", v);
+  return string(buf);
+}
+
+// Check if c is a space or tab
+static inline bool mocapBlank(char c)
+{
+  return c==' ' || c=='\t' || c=='\r' || c=='\v' || c=='\f';
+}
+
+// Convert the string [s,e) with strtod() (which requires a terminated string)
+static bool mocapStrtod(const char* s, const char* e, double& res)
+{
+  char buf[64];
+  int n = int(e-s);
+  if (n==0 || n>=int(sizeof(buf)))
+    return false;
+  memcpy(buf, s, n);
+  buf[n] = 0;
+  char* endptr;
+  res = strtod(buf, &endptr);
+  return endptr==buf+n;
+}
+
+/**
+  Convert the string [s,e) into a double.
+
+  Numbers with at most 15 significant digits and a decimal exponent
+  between -22 and 22 (which covers virtually all values in motion capture
+  files) are converted with a single multiplication or division of two
+  exactly representable values, so the result is correctly rounded. All
+  other numbers are converted by strtod().
+
+  \return False if the string is not a number.
+ */
+static bool mocapParseDouble(const char* s, const char* e, double& res)
+{
+  const char* p = s;
+  bool neg = false;
+  if (p<e && (*p=='-' || *p=='+'))
+  {
+    neg = (*p=='-');
+    p++;
+  }
+
+  double mant = 0.0;
+  int ndigits = 0;
+  int exp10 = 0;
+  bool digits = false;
+  while(p<e && *p>='0' && *p<='9')
+  {
+    mant = 10.0*mant + (*p-'0');
+    if (mant!=0.0)
+      ndigits++;
+    digits = true;
+    p++;
+  }
+  if (p<e && *p=='.')
+  {
+    p++;
+    while(p<e && *p>='0' && *p<='9')
+    {
+      mant = 10.0*mant + (*p-'0');
+      if (mant!=0.0)
+        ndigits++;
+      exp10--;
+      digits = true;
+      p++;
+    }
+  }
+  // No digits? (could be inf or nan)
+  if (!digits)
+    return mocapStrtod(s, e, res);
+
+  if (p<e && (*p=='e' || *p=='E'))
+  {
+    p++;
+    bool eneg = false;
+    if (p<e && (*p=='-' || *p=='+'))
+    {
+      eneg = (*p=='-');
+      p++;
+    }
+    if (p==e || *p<'0' || *p>'9')
+      return false;
+    int ex = 0;
+    while(p<e && *p>='0' && *p<='9')
+    {
+      if (ex<100000)
+        ex = 10*ex + (*p-'0');
+      p++;
+    }
+    exp10 += eneg? -ex : ex;
+  }
+  if (p!=e)
+    return false;
+
+  if (ndigits>15 || exp10<-22 || exp10>22)
+    return mocapStrtod(s, e, res);
+
+  res = (exp10<0)? mant/mocapPow10[-exp10] : mant*mocapPow10[exp10];
+  if (neg)
+    res = -res;
+  return true;
+}
+
+// Convert the string [s,e) into an int
+static bool mocapParseInt(const char* s, const char* e, int& res)
+{
+  char buf[32];
+  int n = int(e-s);
+  if (n==0 || n>=int(sizeof(buf)))
+    return false;
+  memcpy(buf, s, n);
+  buf[n] = 0;
+  char* endptr;
+  res = int(strtol(buf, &endptr, 10));
+  return endptr==buf+n;
+}
+
+// Return the end of the line that starts at s
+static const char* mocapLineEnd(const char* s, const char* end)
+{
+  const char* e = (const char*)memchr(s, '\n', end-s);
+  return (e==0)? end : e;
+}
+
+// Return the end of the token that starts at s (the token ends at a blank or newline)
+static inline const char* mocapTokenEnd(const char* s, const char* e)
+{
+  while(s<e && !mocapBlank(*s))
+    s++;
+  return s;
+}
+
+// Skip blanks
+static inline const char* mocapSkipBlanks(const char* s, const char* e)
+{
+  while(s<e && mocapBlank(*s))
+    s++;
+  return s;
+}
+
+/**
+  Parse the floats in the range [s,e) (which is a line or the remainder
+  of a line).
+
+  The values are written to dst[0], dst[stride], ... dst[(n-1)*stride].
+  If report is true, an ESyntaxError exception is thrown if there are
+  not exactly n values or if a value is not a number, otherwise the
+  function just returns false.
+ */
+static bool mocapParseValues(const char* s, const char* e, double* dst, int stride, int n,
+                             bool report, int line)
+{
+  int i = 0;
+  while(1)
+  {
+    s = mocapSkipBlanks(s, e);
+    if (s==e)
+      break;
+    const char* te = mocapTokenEnd(s, e);
+    if (i<n)
+    {
+      if (!mocapParseDouble(s, te, dst[i*stride]))
+      {
+        if (report)
+          throw ESyntaxError(mocapError(line, "Float expected, got '"+string(s, te)+"' instead"));
+        return false;
+      }
+    }
+    i++;
+    s = te;
+  }
+  if (i!=n)
+  {
+    if (report)
+      throw ESyntaxError(mocapError(line, mocapStr(n)+" float values expected, got "+mocapStr(i)+" instead"));
+    return false;
+  }
+  return true;
+}
+
+// Read an entire file into memory
+static void mocapReadFile(const string& filename, std::vector<char>& buf)
+{
+  FILE* f = fopen(filename.c_str(), "rb");
+  if (f==0)
+    throw EIOError("Could not open file \""+filename+"\".");
+  buf.clear();
+  char block[65536];
+  size_t n;
+  while((n = fread(block, 1, sizeof(block), f))>0)
+  {
+    buf.insert(buf.end(), block, block+n);
+  }
+  bool err = ferror(f)!=0;
+  fclose(f);
+  if (err)
+    throw EIOError("Error while reading file \""+filename+"\".");
+}
+
+/**
+  Splits a text buffer into white space separated tokens.
+
+  This is used for the parts of the files that are parsed sequentially
+  (i.e. the BVH hierarchy).
+ */
+class MocapTokenizer
+{
+  public:
+  /// Current position.
+  const char* pos;
+  /// End of the text.
+  const char* end;
+  /// Current line number.
+  int line;
+
+  public:
+  MocapTokenizer(const char* text, int size) : pos(text), end(text+size), line(1) {}
+
+  /// Skip white space (including newlines).
+  void skipSpace()
+  {
+    while(pos<end && isspace((unsigned char)(*pos)))
+    {
+      if (*pos=='\n')
+        line++;
+      pos++;
+    }
+  }
+
+  /// Return true if there are no more tokens.
+  bool atEnd()
+  {
+    skipSpace();
+    return pos>=end;
+  }
+
+  /// Return the next token (or an empty string at the end of the text).
+  string token()
+  {
+    skipSpace();
+    const char* s = pos;
+    while(pos<end && !isspace((unsigned char)(*pos)))
+      pos++;
+    return string(s, pos);
+  }
+
+  /// Read the next token which must be identical to kw.
+  void expect(const string& kw)
+  {
+    string tok = token();
+    if (tok!=kw)
+      error("'"+kw+"' expected, got '"+tok+"' instead");
+  }
+
+  /// Return the next token which must be a float.
+  double floatToken()
+  {
+    string tok = token();
+    double res;
+    if (!mocapParseDouble(tok.data(), tok.data()+tok.size(), res))
+      error("Float expected, got '"+tok+"' instead");
+    return res;
+  }
+
+  /// Return the next token which must be an int.
+  int intToken()
+  {
+    string tok = token();
+    int res;
+    if (!mocapParseInt(tok.data(), tok.data()+tok.size(), res))
+      error("Integer expected, got '"+tok+"' instead");
+    return res;
+  }
+
+  /// Move to the beginning of the next line.
+  void nextLine()
+  {
+    pos = mocapLineEnd(pos, end);
+    if (pos<end)
+    {
+      pos++;
+      line++;
+    }
+  }
+
+  /// Throw a syntax error for the current line.
+  void error(const string& msg) const
+  {
+    throw ESyntaxError(mocapError(line, msg));
+  }
+};
+
+//////////////////////////////////////////////////////////////////////
+// MotionData
+//////////////////////////////////////////////////////////////////////
+
+MotionData::MotionData()
+  : tracks(), numchannels(0), numframes(0), frametime(0.0), values()
+{
+}
+
+/**
+  Remove all tracks and samples.
+ */
+void MotionData::clear()
+{
+  tracks.clear();
+  numchannels = 0;
+  numframes = 0;
+  frametime = 0.0;
+  values.clear();
+}
+
+/**
+  Add a track.
+
+  The new channels are appended to the existing channels and their
+  samples are initialized to 0.
+
+  \param name Track name
+  \param size Number of channels
+  \return Track index
+ */
+int MotionData::addTrack(const string& name, int size)
+{
+  if (size<0)
+    throw EValueError("The number of channels must not be negative.");
+  Track t;
+  t.name = name;
+  t.channel = numchannels;
+  t.size = size;
+  tracks.push_back(t);
+  numchannels += size;
+  values.resize(numchannels*numframes, 0.0);
+  return int(tracks.size())-1;
+}
+
+/**
+  Return the index of a track or -1 if there is no track with that name.
+ */
+int MotionData::findTrack(const string& name) const
+{
+  for(unsigned int i=0; i<tracks.size(); i++)
+  {
+    if (tracks[i].name==name)
+      return int(i);
+  }
+  return -1;
+}
+
+/// Return the name of a track.
+const string& MotionData::getTrackName(int idx) const
+{
+  checkTrack(idx);
+  return tracks[idx].name;
+}
+
+/// Return the index of the first channel of a track.
+int MotionData::getTrackChannel(int idx) const
+{
+  checkTrack(idx);
+  return tracks[idx].channel;
+}
+
+/// Return the number of channels of a track.
+int MotionData::getTrackSize(int idx) const
+{
+  checkTrack(idx);
+  return tracks[idx].size;
+}
+
+/**
+  Set the number of frames.
+
+  All samples are reset to 0.
+ */
+void MotionData::setNumFrames(int n)
+{
+  if (n<0)
+    throw EValueError("The number of frames must not be negative.");
+  numframes = n;
+  values.assign(numchannels*numframes, 0.0);
+}
+
+/// Return a single sample.
+double MotionData::getValue(int channel, int frame) const
+{
+  checkChannel(channel);
+  if (frame<0 || frame>=numframes)
+    throw EIndexError("Frame index out of range.");
+  return values[channel*numframes+frame];
+}
+
+/// Set a single sample.
+void MotionData::setValue(int channel, int frame, double v)
+{
+  checkChannel(channel);
+  if (frame<0 || frame>=numframes)
+    throw EIndexError("Frame index out of range.");
+  values[channel*numframes+frame] = v;
+}
+
+/**
+  Return the values of all channels at one frame.
+
+  \param frame Frame index
+  \param[out] res Receives numChannels() values
+ */
+void MotionData::getFrame(int frame, double* res) const
+{
+  if (frame<0 || frame>=numframes)
+    throw EIndexError("Frame index out of range.");
+  for(int i=0; i<numchannels; i++)
+  {
+    res[i] = values[i*numframes+frame];
+  }
+}
+
+/**
+  Replace the keys of a curve with the samples of a channel.
+
+  Each frame becomes one key, the keys are equally spaced.
+
+  \param channel Channel index
+  \param curve The curve that receives the keys
+  \param t0 Time of the first frame
+  \param dt Time between two frames
+  \param scale Scaling factor that is applied to the samples
+  \param ip Interpolation mode
+ */
+void MotionData::setCurveKeys(int channel, AnimCurve& curve, double t0, double dt,
+                              double scale, AnimCurve::Interpolation ip) const
+{
+  checkChannel(channel);
+  if (numframes==0)
+  {
+    curve.clear();
+    return;
+  }
+  const double* v = &values[channel*numframes];
+  if (scale==1.0)
+  {
+    curve.setSampledKeys(t0, dt, numframes, v, 1, ip);
+  }
+  else
+  {
+    std::vector<double> scaled(numframes);
+    for(int i=0; i<numframes; i++)
+      scaled[i] = scale*v[i];
+    curve.setSampledKeys(t0, dt, numframes, &scaled[0], 1, ip);
+  }
+}
+
+/**
+  Replace the keys of a quaternion curve with rotations given by Euler angles.
+
+  The three channels contain the angles around the x, y and z axis
+  (an index of -1 means the angle is always 0). order determines the
+  order in which the rotations are applied; the rotation matrix is the
+  same as the one returned by mat3.fromEuler<order>() in Python.
+
+  \param channels Three channel indices (x, y and z angle)
+  \param order Rotation order ("XYZ", "YZX", "ZXY", "XZY", "YXZ" or "ZYX", case-insensitive)
+  \param curve The curve that receives the keys
+  \param t0 Time of the first frame
+  \param dt Time between two frames
+  \param scale Scaling factor that is applied to the angles (e.g. to convert degrees to radians)
+  \param ip Interpolation mode
+ */
+void MotionData::setQuatCurveKeys(const int* channels, const string& order,
+                                  QuatAnimCurve& curve, double t0, double dt,
+                                  double scale, AnimCurve::Interpolation ip) const
+{
+  static const char* orders[] = {"XYZ", "YZX", "ZXY", "XZY", "YXZ", "ZYX", 0};
+  string uorder = order;
+  for(unsigned int j=0; j<uorder.size(); j++)
+    uorder[j] = toupper(uorder[j]);
+  int m;
+  for(m=0; orders[m]!=0; m++)
+  {
+    if (uorder==orders[m])
+      break;
+  }
+  if (orders[m]==0)
+    throw EValueError("Invalid rotation order: \""+order+"\"");
+
+  const double* ch[3];
+  for(int j=0; j<3; j++)
+  {
+    if (channels[j]==-1)
+    {
+      ch[j] = 0;
+    }
+    else
+    {
+      checkChannel(channels[j]);
+      ch[j] = &values[channels[j]*numframes];
+    }
+  }
+
+  if (numframes==0)
+  {
+    curve.clear();
+    return;
+  }
+
+  std::vector<quatd> quats(numframes);
+  int i;
+#ifdef _OPENMP
+  #pragma omp parallel for if(numframes>=256)
+#endif
+  for(i=0; i<numframes; i++)
+  {
+    double x = (ch[0]==0)? 0.0 : scale*ch[0][i];
+    double y = (ch[1]==0)? 0.0 : scale*ch[1][i];
+    double z = (ch[2]==0)? 0.0 : scale*ch[2][i];
+    mat3d M;
+    switch(m)
+    {
+    case 0: M.setRotationXYZ(x, y, z); break;
+    case 1: M.setRotationYZX(x, y, z); break;
+    case 2: M.setRotationZXY(x, y, z); break;
+    case 3: M.setRotationXZY(x, y, z); break;
+    case 4: M.setRotationYXZ(x, y, z); break;
+    default: M.setRotationZYX(x, y, z); break;
+    }
+    quats[i].fromMat(M);
+  }
+  curve.setSampledKeys(t0, dt, numframes, &quats[0], ip);
+}
+
+void MotionData::checkChannel(int idx) const
+{
+  if (idx<0 || idx>=numchannels)
+    throw EIndexError("Channel index out of range.");
+}
+
+void MotionData::checkTrack(int idx) const
+{
+  if (idx<0 || idx>=int(tracks.size()))
+    throw EIndexError("Track index out of range.");
+}
+
+//////////////////////////////////////////////////////////////////////
+// BVHParser
+//////////////////////////////////////////////////////////////////////
+
+BVHParser::BVHParser()
+  : joints(), motion(), hasmotion(false)
+{
+}
+
+/**
+  Remove all joints and samples.
+ */
+void BVHParser::clear()
+{
+  joints.clear();
+  motion.clear();
+  hasmotion = false;
+}
+
+/**
+  Read a BVH file.
+
+  \param filename File name
+ */
+void BVHParser::read(const string& filename)
+{
+  std::vector<char> buf;
+  mocapReadFile(filename, buf);
+  parse(buf.empty()? "" : &buf[0], int(buf.size()));
+}
+
+/**
+  Parse the content of a BVH file.
+
+  Any previously read data is discarded.
+
+  \param text The file content
+  \param size The number of characters in text
+ */
+void BVHParser::parse(const char* text, int size)
+{
+  clear();
+  MocapTokenizer tok(text, size);
+  tok.expect("HIERARCHY");
+  tok.expect("ROOT");
+  readJoint(tok, -1);
+
+  for(unsigned int j=0; j<joints.size(); j++)
+  {
+    if (!joints[j].channels.empty())
+      joints[j].track = motion.addTrack(joints[j].name, int(joints[j].channels.size()));
+  }
+
+  // No motion section?
+  if (tok.atEnd())
+    return;
+
+  tok.expect("MOTION");
+  tok.expect("Frames:");
+  int frames = tok.intToken();
+  if (frames<0)
+    tok.error("The number of frames must not be negative");
+  tok.expect("Frame");
+  tok.expect("Time:");
+  motion.setFrameTime(tok.floatToken());
+  tok.nextLine();
+  hasmotion = true;
+
+  // Locate the frame lines (blank lines are ignored)
+  std::vector<const char*> lines;
+  std::vector<int> linenrs;
+  lines.reserve(frames);
+  linenrs.reserve(frames);
+  while(int(lines.size())<frames && tok.pos<tok.end)
+  {
+    const char* e = mocapLineEnd(tok.pos, tok.end);
+    if (mocapSkipBlanks(tok.pos, e)!=e)
+    {
+      lines.push_back(tok.pos);
+      linenrs.push_back(tok.line);
+    }
+    tok.nextLine();
+  }
+  if (int(lines.size())<frames)
+    tok.error(mocapStr(frames)+" frames expected, got only "+mocapStr(int(lines.size())));
+
+  motion.setNumFrames(frames);
+  int nc = motion.numChannels();
+  if (frames==0 || nc==0)
+  {
+    // Each line must still be empty
+    for(int j=0; j<frames; j++)
+      mocapParseValues(lines[j], mocapLineEnd(lines[j], tok.end), 0, 0, 0, true, linenrs[j]);
+    return;
+  }
+
+  // Parse the frames (the values of a frame are written into the channels
+  // with a stride of 'frames')
+  double* dst = motion.channel(0);
+  const char* end = tok.end;
+  int errframe = frames;
+  int f;
+#ifdef _OPENMP
+  #pragma omp parallel for if(frames>=256)
+#endif
+  for(f=0; f<frames; f++)
+  {
+    const char* s = lines[f];
+    if (!mocapParseValues(s, mocapLineEnd(s, end), dst+f, frames, nc, false, 0))
+    {
+#ifdef _OPENMP
+      #pragma omp critical
+#endif
+      {
+        if (f<errframe)
+          errframe = f;
+      }
+    }
+  }
+
+  // Parse the first invalid frame again to generate the error message
+  if (errframe<frames)
+  {
+    const char* s = lines[errframe];
+    mocapParseValues(s, mocapLineEnd(s, end), dst+errframe, frames, nc, true, linenrs[errframe]);
+  }
+}
+
+/**
+  Read a joint (the "ROOT", "JOINT" or "End" keyword has already been read).
+ */
+void BVHParser::readJoint(MocapTokenizer& tok, int parent)
+{
+  int idx = int(joints.size());
+  joints.push_back(Joint());
+  // Note: joints may be reallocated by the recursive calls, so joints[idx]
+  // is always accessed via the index.
+  joints[idx].name = tok.token();
+  joints[idx].parent = parent;
+  joints[idx].offset = vec3d(0,0,0);
+  joints[idx].track = -1;
+  joints[idx].endsite = false;
+  int numchildren = 0;
+
+  tok.expect("{");
+  while(1)
+  {
+    string kw = tok.token();
+    if (kw=="OFFSET")
+    {
+      double x = tok.floatToken();
+      double y = tok.floatToken();
+      double z = tok.floatToken();
+      joints[idx].offset = vec3d(x, y, z);
+    }
+    else if (kw=="CHANNELS")
+    {
+      int n = tok.intToken();
+      std::vector<string> channels;
+      for(int i=0; i<n; i++)
+      {
+        string ch = tok.token();
+        if (ch!="Xposition" && ch!="Yposition" && ch!="Zposition" &&
+            ch!="Xrotation" && ch!="Yrotation" && ch!="Zrotation")
+          tok.error("Invalid channel name: '"+ch+"'");
+        channels.push_back(ch);
+      }
+      joints[idx].channels = channels;
+    }
+    else if (kw=="JOINT" || kw=="End")
+    {
+      numchildren++;
+      readJoint(tok, idx);
+    }
+    else if (kw=="}")
+    {
+      if (numchildren==0)
+      {
+        joints[idx].name = "End Site";
+        joints[idx].endsite = true;
+      }
+      break;
+    }
+    else if (kw=="")
+    {
+      tok.error("Unexpected end of file");
+    }
+    else
+    {
+      tok.error("Unknown keyword '"+kw+"'");
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+// AMCParser
+//////////////////////////////////////////////////////////////////////
+
+/// A data line of an AMC file.
+struct AMCLine
+{
+  /// Start of the line.
+  const char* begin;
+  /// End of the line.
+  const char* end;
+  /// Line number.
+  int nr;
+};
+
+/**
+  Parse one frame of an AMC file.
+
+  \param motion The motion data that receives the values
+  \param trackmap Track indices keyed by bone name
+  \param lines The data lines of the frame
+  \param n Number of lines
+  \param f Frame index
+  \param framelinenr Line number of the frame number
+  \param report If true, an ESyntaxError exception is thrown for invalid data, otherwise false is returned
+ */
+static bool amcParseFrame(MotionData& motion, const std::map<string, int>& trackmap,
+                          const AMCLine* lines, int n, int f, int framelinenr, bool report)
+{
+  int numframes = motion.numFrames();
+  if (n!=motion.numTracks())
+  {
+    if (report)
+      throw ESyntaxError(mocapError(framelinenr, mocapStr(motion.numTracks())+" bones expected in this frame, got "+mocapStr(n)+" instead"));
+    return false;
+  }
+  for(int i=0; i<n; i++)
+  {
+    const char* s = mocapSkipBlanks(lines[i].begin, lines[i].end);
+    const char* te = mocapTokenEnd(s, lines[i].end);
+    int track;
+    // Usually the bones are in the same order in every frame
+    const string& name = motion.getTrackName(i);
+    if (name.size()==size_t(te-s) && name.compare(0, name.size(), s, te-s)==0)
+    {
+      track = i;
+    }
+    else
+    {
+      std::map<string, int>::const_iterator it = trackmap.find(string(s, te));
+      if (it==trackmap.end())
+      {
+        if (report)
+          throw ESyntaxError(mocapError(lines[i].nr, "Unknown bone '"+string(s, te)+"'"));
+        return false;
+      }
+      track = it->second;
+    }
+    double* dst = motion.channel(motion.getTrackChannel(track))+f;
+    if (!mocapParseValues(te, lines[i].end, dst, numframes, motion.getTrackSize(track), report, lines[i].nr))
+      return false;
+  }
+  return true;
+}
+
+AMCParser::AMCParser()
+  : motion(), framenumbers()
+{
+}
+
+/**
+  Remove all samples.
+ */
+void AMCParser::clear()
+{
+  motion.clear();
+  framenumbers.clear();
+}
+
+/**
+  Read an AMC file.
+
+  \param filename File name
+ */
+void AMCParser::read(const string& filename)
+{
+  std::vector<char> buf;
+  mocapReadFile(filename, buf);
+  parse(buf.empty()? "" : &buf[0], int(buf.size()));
+}
+
+/**
+  Parse the content of an AMC file.
+
+  Any previously read data is discarded.
+
+  \param text The file content
+  \param size The number of characters in text
+ */
+void AMCParser::parse(const char* text, int size)
+{
+  clear();
+  MocapTokenizer tok(text, size);
+
+  // Locate the frames and their data lines (comments, blank lines and
+  // the keywords at the beginning are skipped)
+  std::vector<AMCLine> lines;
+  // Index of the first data line of each frame (plus the total number of lines)
+  std::vector<int> framebegin;
+  // Line numbers of the frame numbers
+  std::vector<int> framelinenrs;
+  bool header = true;
+  while(tok.pos<tok.end)
+  {
+    AMCLine line;
+    line.begin = tok.pos;
+    line.end = mocapLineEnd(tok.pos, tok.end);
+    line.nr = tok.line;
+    tok.nextLine();
+    const char* s = mocapSkipBlanks(line.begin, line.end);
+    if (s==line.end || *line.begin=='#')
+      continue;
+    if (header && *s==':')
+      continue;
+    header = false;
+    int framenr;
+    const char* te = mocapTokenEnd(s, line.end);
+    if (mocapParseInt(s, te, framenr))
+    {
+      framenumbers.push_back(framenr);
+      framebegin.push_back(int(lines.size()));
+      framelinenrs.push_back(line.nr);
+      continue;
+    }
+    if (framebegin.empty())
+      throw ESyntaxError(mocapError(line.nr, "Frame number expected, got '"+string(s, te)+"' instead"));
+    lines.push_back(line);
+  }
+  int frames = int(framebegin.size());
+  framebegin.push_back(int(lines.size()));
+
+  if (frames==0)
+    return;
+
+  // Create the tracks from the first frame
+  std::map<string, int> trackmap;
+  for(int i=framebegin[0]; i<framebegin[1]; i++)
+  {
+    const char* s = mocapSkipBlanks(lines[i].begin, lines[i].end);
+    const char* te = mocapTokenEnd(s, lines[i].end);
+    string name(s, te);
+    if (trackmap.find(name)!=trackmap.end())
+      throw ESyntaxError(mocapError(lines[i].nr, "Bone '"+name+"' appears twice in the same frame"));
+    int n = 0;
+    s = te;
+    while(1)
+    {
+      s = mocapSkipBlanks(s, lines[i].end);
+      if (s==lines[i].end)
+        break;
+      s = mocapTokenEnd(s, lines[i].end);
+      n++;
+    }
+    trackmap[name] = motion.addTrack(name, n);
+  }
+  motion.setNumFrames(frames);
+
+  // Parse the frames
+  AMCLine* plines = lines.empty()? 0 : &lines[0];
+  int errframe = frames;
+  int f;
+#ifdef _OPENMP
+  #pragma omp parallel for if(frames>=256)
+#endif
+  for(f=0; f<frames; f++)
+  {
+    int b = framebegin[f];
+    if (!amcParseFrame(motion, trackmap, plines+b, framebegin[f+1]-b, f, framelinenrs[f], false))
+    {
+#ifdef _OPENMP
+      #pragma omp critical
+#endif
+      {
+        if (f<errframe)
+          errframe = f;
+      }
+    }
+  }
+
+  // Parse the first invalid frame again to generate the error message
+  if (errframe<frames)
+  {
+    int b = framebegin[errframe];
+    amcParseFrame(motion, trackmap, plines+b, framebegin[errframe+1]-b, errframe, framelinenrs[errframe], true);
+  }
+}
+
+}  // end of namespace
@@ -0,0 +1,434 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <math.h>
+#include "normalgenerator.h"
+
+namespace support3d {
+
+// Normalize v in place, a zero vector remains zero (no exception is thrown)
+static inline void safeNormalize(vec3d& v)
+{
+  double len = sqrt(v.x*v.x + v.y*v.y + v.z*v.z);
+  if (len>0.0)
+  {
+    v.x /= len;
+    v.y /= len;
+    v.z /= len;
+  }
+  else
+  {
+    v.set(0,0,0);
+  }
+}
+
+// Return the angle between two unit vectors (or 0 if one of them is 0)
+static inline double angleBetween(const vec3d& a, const vec3d& b)
+{
+  double d = a*b;
+  if (d>1.0)
+    d = 1.0;
+  else if (d<-1.0)
+    d = -1.0;
+  return acos(d);
+}
+
+NormalGenerator::NormalGenerator()
+  : weighting(ANGLE_WEIGHTED), numfaces(0), numverts(0), faces(0),
+    vertoffsets(), vertcorners(), facenormals(), faceareas(), cornerangles(),
+    facestamps(), vertstamps(), stamp(0)
+{
+}
+
+/**
+  Set the mesh topology and build the vertex/face incidence table.
+
+  This method runs in linear time. The face array must stay valid as long
+  as the generator is used (it is not copied). Face corners that reference
+  a vertex that is out of range are ignored.
+
+  \param afaces Vertex indices (3 per face)
+  \param anumfaces Number of faces
+  \param anumverts Number of vertices
+ */
+void NormalGenerator::setTopology(const int* afaces, int anumfaces, int anumverts)
+{
+  int i;
+
+  faces = afaces;
+  numfaces = anumfaces;
+  numverts = anumverts;
+
+  // Count the number of corners per vertex...
+  vertoffsets.assign(numverts+1, 0);
+  for(i=0; i<3*numfaces; i++)
+  {
+    int v = faces[i];
+    if (v>=0 && v<numverts)
+      vertoffsets[v+1]++;
+  }
+  // ...turn the counts into offsets...
+  for(i=0; i<numverts; i++)
+  {
+    vertoffsets[i+1] += vertoffsets[i];
+  }
+  // ...and fill in the corners
+  vertcorners.resize(vertoffsets[numverts]);
+  std::vector<int> fill(vertoffsets.begin(), vertoffsets.end()-1);
+  for(i=0; i<3*numfaces; i++)
+  {
+    int v = faces[i];
+    if (v>=0 && v<numverts)
+    {
+      vertcorners[fill[v]] = i;
+      fill[v]++;
+    }
+  }
+
+  facenormals.resize(numfaces);
+  faceareas.resize(numfaces);
+  cornerangles.resize(3*numfaces);
+  facestamps.assign(numfaces, 0);
+  vertstamps.assign(numverts, 0);
+  stamp = 0;
+}
+
+/**
+  Compute a normal for every vertex.
+
+  \param verts Vertex positions (the array must contain getNumVerts() items)
+  \param[out] N Receives the normals (getNumVerts() items)
+ */
+void NormalGenerator::vertexNormals(const vec3d* verts, vec3d* N)
+{
+  int i;
+
+#ifdef _OPENMP
+  #pragma omp parallel for if(numfaces>=256)
+#endif
+  for(i=0; i<numfaces; i++)
+  {
+    computeFaceData(verts, i);
+  }
+
+#ifdef _OPENMP
+  #pragma omp parallel for if(numverts>=256)
+#endif
+  for(i=0; i<numverts; i++)
+  {
+    computeVertexNormal(i, N[i]);
+  }
+}
+
+/**
+  Compute a normal for every face corner.
+
+  The normal of a corner is the weighted average of all faces around the
+  corner vertex whose normals deviate less than \a creaseangle from the
+  normal of the face the corner belongs to. The result can be used as a
+  facevarying normal variable.
+
+  \param verts Vertex positions (the array must contain getNumVerts() items)
+  \param creaseangle Crease angle in radians
+  \param[out] N Receives the normals (3*getNumFaces() items)
+ */
+void NormalGenerator::cornerNormals(const vec3d* verts, double creaseangle, vec3d* N)
+{
+  int i;
+  double mincos = cos(creaseangle);
+
+#ifdef _OPENMP
+  #pragma omp parallel for if(numfaces>=256)
+#endif
+  for(i=0; i<numfaces; i++)
+  {
+    computeFaceData(verts, i);
+  }
+
+#ifdef _OPENMP
+  #pragma omp parallel for if(3*numfaces>=256)
+#endif
+  for(i=0; i<3*numfaces; i++)
+  {
+    computeCornerNormal(i, mincos, N[i]);
+  }
+}
+
+/**
+  Update the vertex normals after the vertices [vstart, vend) have changed.
+
+  \a N must contain the result of a previous call to vertexNormals()
+  (with the same topology). Only the normals that depend on the modified
+  vertices are recomputed.
+
+  \param verts Vertex positions
+  \param vstart First modified vertex
+  \param vend One past the last modified vertex
+  \param[in,out] N Vertex normals
+ */
+void NormalGenerator::updateVertexNormals(const vec3d* verts, int vstart, int vend, vec3d* N)
+{
+  std::vector<int> affected;
+  int n = markAffectedFaces(vstart, vend, affected);
+  int i;
+
+#ifdef _OPENMP
+  #pragma omp parallel for if(n>=256)
+#endif
+  for(i=0; i<n; i++)
+  {
+    computeFaceData(verts, affected[i]);
+  }
+
+  // Collect the vertices of the affected faces (each one only once)...
+  std::vector<int> dirtyverts;
+  for(i=0; i<n; i++)
+  {
+    const int* f = faces+3*affected[i];
+    for(int k=0; k<3; k++)
+    {
+      int v = f[k];
+      if (v>=0 && v<numverts && vertstamps[v]!=stamp)
+      {
+        vertstamps[v] = stamp;
+        dirtyverts.push_back(v);
+      }
+    }
+  }
+
+  n = dirtyverts.size();
+#ifdef _OPENMP
+  #pragma omp parallel for if(n>=256)
+#endif
+  for(i=0; i<n; i++)
+  {
+    computeVertexNormal(dirtyverts[i], N[dirtyverts[i]]);
+  }
+}
+
+/**
+  Update the corner normals after the vertices [vstart, vend) have changed.
+
+  \a N must contain the result of a previous call to cornerNormals()
+  (with the same topology and crease angle).
+
+  \param verts Vertex positions
+  \param vstart First modified vertex
+  \param vend One past the last modified vertex
+  \param creaseangle Crease angle in radians
+  \param[in,out] N Corner normals
+ */
+void NormalGenerator::updateCornerNormals(const vec3d* verts, int vstart, int vend, double creaseangle, vec3d* N)
+{
+  std::vector<int> affected;
+  double mincos = cos(creaseangle);
+  int n = markAffectedFaces(vstart, vend, affected);
+  int i;
+
+#ifdef _OPENMP
+  #pragma omp parallel for if(n>=256)
+#endif
+  for(i=0; i<n; i++)
+  {
+    computeFaceData(verts, affected[i]);
+  }
+
+  // Every corner that shares a vertex with an affected face may have
+  // changed (the face normals around that vertex have changed)
+  std::vector<int> dirtycorners;
+  for(i=0; i<n; i++)
+  {
+    const int* f = faces+3*affected[i];
+    for(int k=0; k<3; k++)
+    {
+      int v = f[k];
+      if (v<0 || v>=numverts || vertstamps[v]==stamp)
+        continue;
+      vertstamps[v] = stamp;
+      for(int j=vertoffsets[v]; j<vertoffsets[v+1]; j++)
+      {
+        dirtycorners.push_back(vertcorners[j]);
+      }
+    }
+  }
+
+  n = dirtycorners.size();
+#ifdef _OPENMP
+  #pragma omp parallel for if(n>=256)
+#endif
+  for(i=0; i<n; i++)
+  {
+    computeCornerNormal(dirtycorners[i], mincos, N[dirtycorners[i]]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+
+/**
+  Compute the unit normal, the area and the corner angles of one face.
+ */
+void NormalGenerator::computeFaceData(const vec3d* verts, int face)
+{
+  const int* f = faces+3*face;
+  vec3d& Ng = facenormals[face];
+  double* angles = &(cornerangles[3*face]);
+
+  if (f[0]<0 || f[0]>=numverts || f[1]<0 || f[1]>=numverts || f[2]<0 || f[2]>=numverts)
+  {
+    Ng.set(0,0,0);
+    faceareas[face] = 0.0;
+    angles[0] = angles[1] = angles[2] = 0.0;
+    return;
+  }
+
+  const vec3d& a = verts[f[0]];
+  const vec3d& b = verts[f[1]];
+  const vec3d& c = verts[f[2]];
+  vec3d ab = b-a;
+  vec3d ac = c-a;
+  vec3d bc = c-b;
+
+  Ng.cross(ab, ac);
+  faceareas[face] = 0.5*Ng.length();
+  safeNormalize(Ng);
+
+  if (weighting==ANGLE_WEIGHTED)
+  {
+    safeNormalize(ab);
+    safeNormalize(ac);
+    safeNormalize(bc);
+    angles[0] = angleBetween(ab, ac);
+    angles[1] = angleBetween(-ab, bc);
+    angles[2] = M_PI - angles[0] - angles[1];
+    if (angles[2]<0.0)
+      angles[2] = 0.0;
+  }
+}
+
+/**
+  Return the weight of a face corner.
+ */
+inline double NormalGenerator::cornerWeight(int corner) const
+{
+  if (weighting==ANGLE_WEIGHTED)
+    return cornerangles[corner];
+  else
+    return faceareas[corner/3];
+}
+
+/**
+  Compute the normal of one vertex from the face normals around it.
+ */
+void NormalGenerator::computeVertexNormal(int vert, vec3d& N) const
+{
+  N.set(0,0,0);
+  for(int j=vertoffsets[vert]; j<vertoffsets[vert+1]; j++)
+  {
+    int corner = vertcorners[j];
+    N += cornerWeight(corner)*facenormals[corner/3];
+  }
+  safeNormalize(N);
+}
+
+/**
+  Compute the normal of one face corner.
+
+  \param corner Corner index (3*face+k)
+  \param mincos Cosine of the crease angle
+  \param[out] N Receives the normal
+ */
+void NormalGenerator::computeCornerNormal(int corner, double mincos, vec3d& N) const
+{
+  int v = faces[corner];
+  const vec3d& Nf = facenormals[corner/3];
+
+  N.set(0,0,0);
+  if (v<0 || v>=numverts)
+    return;
+
+  for(int j=vertoffsets[v]; j<vertoffsets[v+1]; j++)
+  {
+    int c = vertcorners[j];
+    const vec3d& Ng = facenormals[c/3];
+    // The face itself is always included, the neighbors only if they
+    // are within the crease angle
+    if (c==corner || Nf*Ng>=mincos)
+      N += cornerWeight(c)*Ng;
+  }
+  safeNormalize(N);
+}
+
+/**
+  Collect all faces that reference a vertex in [vstart, vend).
+
+  Each face is only stored once. The method begins a new stamp period
+  so that the caller can use vertstamps to mark vertices.
+
+  \return Number of affected faces
+ */
+int NormalGenerator::markAffectedFaces(int vstart, int vend, std::vector<int>& affected)
+{
+  if (vstart<0)
+    vstart = 0;
+  if (vend>numverts)
+    vend = numverts;
+
+  // Begin a new stamp period (reset the stamps in the unlikely case of
+  // an overflow)
+  stamp++;
+  if (stamp<=0)
+  {
+    facestamps.assign(numfaces, 0);
+    vertstamps.assign(numverts, 0);
+    stamp = 1;
+  }
+
+  affected.clear();
+  for(int v=vstart; v<vend; v++)
+  {
+    for(int j=vertoffsets[v]; j<vertoffsets[v+1]; j++)
+    {
+      int face = vertcorners[j]/3;
+      if (facestamps[face]!=stamp)
+      {
+        facestamps[face] = stamp;
+        affected.push_back(face);
+      }
+    }
+  }
+  return affected.size();
+}
+
+}  // end of namespace
@@ -50,14 +50,28 @@ namespace support3d {
   \param segsy Number of segments in y
  */
 PlaneGeom::PlaneGeom(double alx, double aly, int segsx, int segsy)
-: lx(alx,0), ly(aly,0), segmentsx(segsx,0), segmentsy(segsy,0)
+: lx(alx,0), ly(aly,0), segmentsx(segsx,0), segmentsy(segsy,0),
+  _on_param_event(), tesscache()
 {
+  _on_param_event.init(this, &PlaneGeom::onParamChanged);
+  lx.addDependent(&_on_param_event);
+  ly.addDependent(&_on_param_event);
+  segmentsx.addDependent(&_on_param_event);
+  segmentsy.addDependent(&_on_param_event);
   addSlot("lx", lx);
   addSlot("ly", ly);
   addSlot("segmentsx", segmentsx);
   addSlot("segmentsy", segmentsy);
 }
 
+PlaneGeom::~PlaneGeom()
+{
+  lx.removeDependent(&_on_param_event);
+  ly.removeDependent(&_on_param_event);
+  segmentsx.removeDependent(&_on_param_event);
+  segmentsy.removeDependent(&_on_param_event);
+}
+
 BoundingBox PlaneGeom::boundingBox()
 {
   double lenx = lx.getValue()/2.0;
@@ -68,49 +82,48 @@ BoundingBox PlaneGeom::boundingBox()
 
 void PlaneGeom::drawGL()
 {
-  double lenx = lx.getValue();
-  double leny = ly.getValue();
-  double lenx2 = lenx/2.0;
-  double leny2 = leny/2.0;
-  int segsx = segmentsx.getValue();
-  int segsy = segmentsy.getValue();
-  if (segsx<1)
-    segsx=1;
-  if (segsy<1)
-    segsy=1;
-
-  glNormal3f(0.0f, 0.0f, 1.0f);
-  for(int j=0; j<segsy; j++)
+  if (!tesscache.isValid())
   {
-    double y1 = j*leny/segsy - leny2;
-    double y2 = (j+1)*leny/segsy - leny2;
-    double v1 = double(j)/segsy;
-    double v2 = double(j+1)/segsy;
-    glBegin(GL_QUAD_STRIP);
-//    glTexCoord2d(0, v1);
-//    glVertex2d(-lenx2, y1);
-//    glTexCoord2d(0, v2);
-//    glVertex2d(-lenx2, y2);
-    for(int i=0; i<=segsx; i++)
+    double lenx = lx.getValue();
+    double leny = ly.getValue();
+    double lenx2 = lenx/2.0;
+    double leny2 = leny/2.0;
+    int segsx = segmentsx.getValue();
+    int segsy = segmentsy.getValue();
+    if (segsx<1)
+      segsx=1;
+    if (segsy<1)
+      segsy=1;
+
+    tesscache.clear();
+    for(int j=0; j<segsy; j++)
     {
-      double x = i*lenx/segsx - lenx2;
-      double u = double(i)/segsx;
-      glTexCoord2d(u, v1);
-      glVertex2d(x, y1);
-      glTexCoord2d(u, v2);
-      glVertex2d(x, y2);
+      double y1 = j*leny/segsy - leny2;
+      double y2 = (j+1)*leny/segsy - leny2;
+      double v1 = double(j)/segsy;
+      double v2 = double(j+1)/segsy;
+      tesscache.beginStrip();
+      for(int i=0; i<=segsx; i++)
+      {
+        double x = i*lenx/segsx - lenx2;
+        double u = double(i)/segsx;
+        tesscache.addVertex(x, y1, 0, 0, 0, 1.0, u, v1);
+        tesscache.addVertex(x, y2, 0, 0, 0, 1.0, u, v2);
+      }
     }
-    glEnd();
+    tesscache.finish();
   }
+  tesscache.drawGL();
+}
+
+/**
+  Invalidate the tessellation cache.
 
-/*  glBegin(GL_QUADS);
-  glNormal3f(0.0f, 0.0f, 1.0f);
-  glVertex3d(-lenx, -leny, 0);
-  glVertex3d( lenx, -leny, 0);
-  glVertex3d( lenx,  leny, 0);
-  glVertex3d(-lenx,  leny, 0);
-  glEnd();
-  */
+  This is called whenever one of the parameter slots has changed.
+ */
+void PlaneGeom::onParamChanged()
+{
+  tesscache.invalidate();
 }
 
 // slotSizeConstraint
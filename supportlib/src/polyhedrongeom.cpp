@@ -37,6 +37,7 @@
 #include "common_exceptions.h"
 #include "primvaraccess.h"
 #include "trimeshgeom.h"
+#include "meshcleanup.h"
 //#include "massproperties.h"
 
 namespace support3d {
@@ -483,7 +484,8 @@ PolyhedronGeom::PolyhedronGeom()
   //  cog(), inertiatensor(),
   //  _cog(), _inertiatensor(), _volume(),
   bb_cache(), 
-  bb_cache_valid(true)
+  bb_cache_valid(true),
+  topology_cache(), topology_valid(false)
   
 {
   _on_verts_event.init(this, &PolyhedronGeom::onVertsChanged, &PolyhedronGeom::onVertsResize);
@@ -777,6 +779,8 @@ void PolyhedronGeom::setNumPolys(int num)
   int prevsize = polys.size();
   int i;
 
+  topology_valid = false;
+
   // Delete polygons if the number of polys was decreased
   if (num<prevsize)
   {
@@ -825,6 +829,8 @@ void PolyhedronGeom::setNumLoops(int poly, int num)
   int lostverts = 0;
   int i;
 
+  topology_valid = false;
+
   // Delete loops if the number of loops was decreased
   if (num<prevsize)
   {
@@ -886,6 +892,7 @@ void PolyhedronGeom::setLoop(int poly, int loop, const std::vector<int>& vloop)
   constraintdelta = -constraintdelta + vloop.size();
 
   *((*polys[poly])[loop]) = vloop;
+  topology_valid = false;
 
   // Update the size constraint for facevarying variables...
   // Todo: This probably shouldn't be done for every single modification
@@ -912,6 +919,47 @@ PolyhedronGeom::LoopIterator PolyhedronGeom::loopEnd(int poly, int loop)
   return (*polys[poly])[loop]->end(); 
 }
 
+/**
+  Return the half-edge connectivity of the polyhedron.
+
+  The topology is built on first use and cached. It is rebuilt
+  automatically when setNumPolys(), setNumLoops(), setLoop() are called
+  or when the number of vertices changes. If the loops are modified
+  directly (via the loop iterators), invalidateTopology() has to be
+  called.
+
+  The half-edges are numbered by visiting all loops of all polys in
+  order, so they have the same order as the values of a facevarying
+  variable.
+
+  \return Half-edge connectivity
+ */
+const MeshTopology& PolyhedronGeom::getTopology()
+{
+  if (!topology_valid)
+  {
+    int numpolys = getNumPolys();
+    std::vector<int> loopoffsets(1, 0);
+    std::vector<int> loopverts;
+    std::vector<int> loopfaces;
+    loopverts.reserve(faceVaryingCount());
+    for(int i=0; i<numpolys; i++)
+    {
+      Poly* poly = polys[i];
+      for(unsigned int j=0; j<poly->size(); j++)
+      {
+        VertexLoop* loop = (*poly)[j];
+        loopverts.insert(loopverts.end(), loop->begin(), loop->end());
+        loopoffsets.push_back(loopverts.size());
+        loopfaces.push_back(i);
+      }
+    }
+    topology_cache.buildLoops(loopoffsets, loopverts, loopfaces, numpolys, verts.size());
+    topology_valid = true;
+  }
+  return topology_cache;
+}
+
 
 void PolyhedronGeom::onVertsChanged(int start, int end)
 { 
@@ -921,6 +969,7 @@ void PolyhedronGeom::onVertsChanged(int start, int end)
 void PolyhedronGeom::onVertsResize(int size)
 { 
   bb_cache_valid = false;
+  topology_valid = false;
 }
 
 
@@ -1082,6 +1131,9 @@ void PolyhedronGeom::convert(GeomObject* target)
 
   polyTriangulation.initTriMesh(*tm);
 
+  // The tesselator may produce zero area triangles (e.g. for collinear
+  // vertices), so remove them again...
+  MeshCleanup(*tm).removeDegenerateFaces();
 }
 
 
@@ -0,0 +1,586 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <cmath>
+#include <cstdio>
+#include "skingeom.h"
+#include "quat.h"
+#include "common_exceptions.h"
+
+namespace support3d {
+
+// Apply a 3x4 row-major transform to a point
+static inline void transformPoint(const double* m, const vec3d& p, vec3d& res)
+{
+  res.set(m[0]*p.x + m[1]*p.y + m[2]*p.z + m[3],
+          m[4]*p.x + m[5]*p.y + m[6]*p.z + m[7],
+          m[8]*p.x + m[9]*p.y + m[10]*p.z + m[11]);
+}
+
+// Apply the linear part of a 3x4 row-major transform to a normal and normalize the result
+static inline void transformNormal(const double* m, const vec3d& n, vec3d& res)
+{
+  res.set(m[0]*n.x + m[1]*n.y + m[2]*n.z,
+          m[4]*n.x + m[5]*n.y + m[6]*n.z,
+          m[8]*n.x + m[9]*n.y + m[10]*n.z);
+  double len = res.length();
+  if (len>0)
+    res /= len;
+}
+
+static inline void setIdentity(double* m)
+{
+  m[0] = 1; m[1] = 0; m[2] = 0; m[3] = 0;
+  m[4] = 0; m[5] = 1; m[6] = 0; m[7] = 0;
+  m[8] = 0; m[9] = 0; m[10] = 1; m[11] = 0;
+}
+
+SkinGeom::SkinGeom()
+  : TriMeshGeom(), _on_joint_event(), _on_bind_verts_event(),
+    bindmesh(), indexvar("jointindices"), weightvar("jointweights"),
+    mode(LINEAR_BLEND), joints(), invbind(), numinfluences(0),
+    infjoints(), infweights(), maxjoint(-1), bindverts(), bindnormals(),
+    cornernormals(false), skinnormals(0), vertxforms(), dirty(false)
+{
+  _on_joint_event.init(this, &SkinGeom::onJointChanged);
+  _on_bind_verts_event.init(this, &SkinGeom::onBindVertsChanged, &SkinGeom::onBindVertsResize);
+}
+
+SkinGeom::~SkinGeom()
+{
+  if (bindmesh.get()!=0)
+    bindmesh->verts.removeDependent(&_on_bind_verts_event);
+  for(unsigned int i=0; i<joints.size(); i++)
+    joints[i]->removeDependent(&_on_joint_event);
+}
+
+BoundingBox SkinGeom::boundingBox()
+{
+  update();
+  return TriMeshGeom::boundingBox();
+}
+
+void SkinGeom::drawGL()
+{
+  update();
+  TriMeshGeom::drawGL();
+}
+
+void SkinGeom::deleteVariable(string name)
+{
+  if (name=="N")
+    skinnormals = 0;
+  TriMeshGeom::deleteVariable(name);
+}
+
+/**
+  Set the bind mesh.
+
+  The bind mesh must have an int and a float variable with the given
+  names that contain the joint indices and weights of the vertices.
+  Passing a null pointer removes the bind mesh (the current mesh is kept).
+
+  \param amesh The mesh in its bind pose
+  \param aindexvar Name of the joint index variable
+  \param aweightvar Name of the joint weight variable
+ */
+void SkinGeom::setBindMesh(boost::shared_ptr<TriMeshGeom> amesh, const std::string& aindexvar, const std::string& aweightvar)
+{
+  if (amesh.get()==this)
+    throw EValueError("A SkinGeom cannot be its own bind mesh.");
+
+  if (bindmesh.get()!=0)
+    bindmesh->verts.removeDependent(&_on_bind_verts_event);
+  bindmesh = amesh;
+  indexvar = aindexvar;
+  weightvar = aweightvar;
+  try
+  {
+    rebuild();
+  }
+  catch(...)
+  {
+    bindmesh.reset();
+    throw;
+  }
+  if (bindmesh.get()!=0)
+    bindmesh->verts.addDependent(&_on_bind_verts_event);
+}
+
+/**
+  Set the skinning method.
+ */
+void SkinGeom::setMode(Mode amode)
+{
+  if (amode!=mode)
+  {
+    mode = amode;
+    dirty = true;
+  }
+}
+
+/**
+  Add a joint.
+
+  A new input slot "joint<i>" is created that is initialized with the
+  bind transform. The returned index is the index that is used in the
+  joint index variable of the bind mesh.
+
+  \param bindtransform World transform of the joint in the bind pose
+  \return Index of the new joint
+ */
+int SkinGeom::addJoint(const mat4d& bindtransform)
+{
+  int idx = int(joints.size());
+  char name[32];
+  sprintf(name, "joint%d", idx);
+  if (hasSlot(name))
+    throw EKeyError(std::string("Slot \"")+name+"\" already exists.");
+
+  mat4d inv = bindtransform.inverse();
+  std::auto_ptr<ISlot> slot(new Slot<mat4d>(bindtransform, 0));
+  Slot<mat4d>* jslot = dynamic_cast<Slot<mat4d>*>(slot.get());
+  addSlot(name, slot);
+  joints.push_back(jslot);
+  invbind.push_back(inv);
+  jslot->addDependent(&_on_joint_event);
+  dirty = true;
+  return idx;
+}
+
+/**
+  Return the input slot of a joint.
+ */
+Slot<mat4d>& SkinGeom::jointSlot(int idx)
+{
+  if (idx<0 || idx>=numJoints())
+    throw EIndexError("Joint index out of range.");
+  return *joints[idx];
+}
+
+/**
+  Return the bind transform of a joint.
+ */
+mat4d SkinGeom::getBindTransform(int idx) const
+{
+  if (idx<0 || idx>=numJoints())
+    throw EIndexError("Joint index out of range.");
+  return invbind[idx].inverse();
+}
+
+/**
+  Remove all joints (and their input slots).
+ */
+void SkinGeom::clearJoints()
+{
+  char name[32];
+  for(unsigned int i=0; i<joints.size(); i++)
+  {
+    joints[i]->removeDependent(&_on_joint_event);
+    sprintf(name, "joint%d", i);
+    removeSlot(name);
+  }
+  joints.clear();
+  invbind.clear();
+  dirty = true;
+}
+
+/**
+  Rebuild the mesh from the current bind mesh.
+
+  This copies the faces and primitive variables of the bind mesh and
+  reads the joint influences. It has to be called when the faces or the
+  primitive variables of the bind mesh have been modified (vertex
+  modifications are handled automatically).
+ */
+void SkinGeom::rebuild()
+{
+  if (bindmesh.get()==0)
+    return;
+
+  TriMeshGeom& bm = *bindmesh;
+  int numverts = bm.verts.size();
+  int numfaces = bm.faces.size();
+
+  // Read the influences...
+  PrimVarInfo* idxinfo = bm.findVariable(indexvar);
+  PrimVarInfo* wghtinfo = bm.findVariable(weightvar);
+  if (idxinfo==0)
+    throw EValueError("The bind mesh has no variable \""+indexvar+"\".");
+  if (wghtinfo==0)
+    throw EValueError("The bind mesh has no variable \""+weightvar+"\".");
+  if ((idxinfo->storage!=VARYING && idxinfo->storage!=VERTEX) || idxinfo->type!=INT)
+    throw EValueError("The joint indices must be stored in a varying or vertex int variable.");
+  if ((wghtinfo->storage!=VARYING && wghtinfo->storage!=VERTEX) || wghtinfo->type!=FLOAT)
+    throw EValueError("The joint weights must be stored in a varying or vertex float variable.");
+  if (idxinfo->multiplicity!=wghtinfo->multiplicity)
+    throw EValueError("The joint index and weight variables must have the same multiplicity.");
+
+  int k = idxinfo->multiplicity;
+  ArraySlot<int>* idxslot = dynamic_cast<ArraySlot<int>*>(idxinfo->slot);
+  ArraySlot<double>* wghtslot = dynamic_cast<ArraySlot<double>*>(wghtinfo->slot);
+  std::vector<int> newjoints(numverts*k);
+  std::vector<double> newweights(numverts*k);
+  int newmax = -1;
+  if (numverts>0)
+  {
+    const int* ji = idxslot->dataPtr();
+    const double* jw = wghtslot->dataPtr();
+    for(int i=0; i<numverts; i++)
+    {
+      double sum = 0.0;
+      for(int j=i*k; j<(i+1)*k; j++)
+      {
+        if (jw[j]==0.0)
+        {
+          newjoints[j] = 0;
+          newweights[j] = 0.0;
+          continue;
+        }
+        if (ji[j]<0)
+          throw EValueError("Negative joint index in variable \""+indexvar+"\".");
+        if (jw[j]<0)
+          throw EValueError("Negative joint weight in variable \""+weightvar+"\".");
+        newjoints[j] = ji[j];
+        newweights[j] = jw[j];
+        sum += jw[j];
+        if (ji[j]>newmax)
+          newmax = ji[j];
+      }
+      if (sum>0.0)
+      {
+        for(int j=i*k; j<(i+1)*k; j++)
+          newweights[j] /= sum;
+      }
+    }
+  }
+
+  // Copy the mesh...
+  deleteAllVariables();
+  skinnormals = 0;
+  faces.resize(0);
+  verts.resize(numverts);
+  faces.resize(numfaces);
+  if (numfaces>0)
+    bm.faces.copyValues(0, numfaces, faces, 0);
+
+  GeomObject::VariableIterator it;
+  for(it=bm.variablesBegin(); it!=bm.variablesEnd(); it++)
+  {
+    const PrimVarInfo& info = it->second;
+    int n = info.slot->size();
+    newVariable(it->first, info.storage, info.type, info.multiplicity, (info.storage==USER)? n : 0);
+    if (n>0)
+      info.slot->copyValues(0, n, *(findVariable(it->first)->slot), 0);
+  }
+
+  numinfluences = k;
+  infjoints.swap(newjoints);
+  infweights.swap(newweights);
+  maxjoint = newmax;
+  bindverts.resize(numverts);
+  if (numverts>0)
+    bm.verts.copyValues(0, numverts, verts, 0);
+  for(int i=0; i<numverts; i++)
+    bindverts[i] = bm.verts.getValue(i);
+
+  // Deformable normals?
+  bindnormals.clear();
+  cornernormals = false;
+  PrimVarInfo* ninfo = findVariable("N");
+  if (ninfo!=0 && ninfo->type==NORMAL && ninfo->multiplicity==1 &&
+      ninfo->storage!=CONSTANT && ninfo->storage!=UNIFORM && ninfo->storage!=USER)
+  {
+    skinnormals = dynamic_cast<ArraySlot<vec3d>*>(ninfo->slot);
+    cornernormals = (ninfo->storage==FACEVARYING || ninfo->storage==FACEVERTEX);
+    int n = skinnormals->size();
+    bindnormals.resize(n);
+    for(int i=0; i<n; i++)
+      bindnormals[i] = skinnormals->getValue(i);
+  }
+
+  dirty = true;
+}
+
+/**
+  Recompute the mesh if a joint transform has changed.
+
+  An EIndexError exception is thrown if the bind mesh refers to a joint
+  that hasn't been added yet.
+
+  \return True if the mesh was recomputed.
+ */
+bool SkinGeom::update()
+{
+  if (!dirty || bindmesh.get()==0)
+    return false;
+
+  // Has the mesh been modified since the last rebuild()?
+  int numverts = int(bindverts.size());
+  if (verts.size()!=numverts)
+    return false;
+
+  if (maxjoint>=numJoints())
+    throw EIndexError("The bind mesh refers to a joint that doesn't exist.");
+
+  dirty = false;
+
+  // Compute the skinning transforms of the joints
+  // (3x4 matrices for the linear blend, dual quaternions otherwise)...
+  int nj = numJoints();
+  std::vector<double> jointdata((mode==LINEAR_BLEND)? 12*nj : 8*nj);
+  for(int j=0; j<nj; j++)
+  {
+    mat4d S = joints[j]->getValue()*invbind[j];
+    if (mode==LINEAR_BLEND)
+    {
+      double* m = &jointdata[12*j];
+      S.getRow(0, m[0], m[1], m[2], m[3]);
+      S.getRow(1, m[4], m[5], m[6], m[7]);
+      S.getRow(2, m[8], m[9], m[10], m[11]);
+    }
+    else
+    {
+      mat3d rot;
+      vec3d scale;
+      S.getMat3().decompose(rot, scale);
+      quatd q0;
+      q0.fromMat(rot);
+      vec4d t = S.getColumn(3);
+      // qe = 0.5*(0,t)*q0
+      quatd qe = quatd(0, 0.5*t.x, 0.5*t.y, 0.5*t.z)*q0;
+      double* dq = &jointdata[8*j];
+      dq[0] = q0.w; dq[1] = q0.x; dq[2] = q0.y; dq[3] = q0.z;
+      dq[4] = qe.w; dq[5] = qe.x; dq[6] = qe.y; dq[7] = qe.z;
+    }
+  }
+
+  vertxforms.resize(12*numverts);
+  if (numverts>0)
+  {
+    if (mode==LINEAR_BLEND)
+      blendLinear(&jointdata[0]);
+    else
+      blendDualQuat(&jointdata[0]);
+  }
+
+  // Deform the vertices...
+  const double* xf = vertxforms.empty()? 0 : &vertxforms[0];
+  const vec3d* bv = bindverts.empty()? 0 : &bindverts[0];
+  if (verts.getController()==0)
+  {
+    vec3d* V = verts.dataPtr();
+#ifdef _OPENMP
+#pragma omp parallel for if(numverts>=256)
+#endif
+    for(int i=0; i<numverts; i++)
+      transformPoint(xf+12*i, bv[i], V[i]);
+    verts.notifyDependentsValue(0, numverts);
+  }
+  else
+  {
+    vec3d v;
+    for(int i=0; i<numverts; i++)
+    {
+      transformPoint(xf+12*i, bv[i], v);
+      verts.setValue(i, v);
+    }
+  }
+
+  // Deform the normals (unless they have been replaced)...
+  PrimVarInfo* ninfo = findVariable("N");
+  if (skinnormals!=0 && ninfo!=0 && ninfo->slot==skinnormals &&
+      skinnormals->size()==int(bindnormals.size()) &&
+      (!cornernormals || skinnormals->size()==3*faces.size()))
+  {
+    int n = skinnormals->size();
+    const vec3d* bn = bindnormals.empty()? 0 : &bindnormals[0];
+    const int* fc = (cornernormals && n>0)? faces.dataPtr() : 0;
+    std::vector<vec3d> values;
+    vec3d* N;
+    if (skinnormals->getController()==0)
+      N = skinnormals->dataPtr();
+    else
+    {
+      values.resize(n);
+      N = values.empty()? 0 : &values[0];
+    }
+    bool ok = true;
+    if (fc!=0)
+    {
+      for(int i=0; i<n; i++)
+      {
+        if (fc[i]<0 || fc[i]>=numverts)
+          ok = false;
+      }
+    }
+    if (ok)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for if(n>=256)
+#endif
+      for(int i=0; i<n; i++)
+      {
+        int v = (fc!=0)? fc[i] : i;
+        transformNormal(xf+12*v, bn[i], N[i]);
+      }
+      if (skinnormals->getController()==0)
+        skinnormals->notifyDependentsValue(0, n);
+      else
+      {
+        for(int i=0; i<n; i++)
+          skinnormals->setValue(i, values[i]);
+      }
+    }
+  }
+  return true;
+}
+
+/**
+  Compute the blended transform of every vertex by linear blend skinning.
+
+  \param skinmats Skinning matrices of the joints (3x4 row-major)
+ */
+void SkinGeom::blendLinear(const double* skinmats)
+{
+  int numverts = int(bindverts.size());
+  int k = numinfluences;
+  const int* ji = &infjoints[0];
+  const double* jw = &infweights[0];
+  double* xf = &vertxforms[0];
+
+#ifdef _OPENMP
+#pragma omp parallel for if(numverts>=256)
+#endif
+  for(int i=0; i<numverts; i++)
+  {
+    double* m = xf+12*i;
+    double wsum = 0.0;
+    int c;
+    for(c=0; c<12; c++)
+      m[c] = 0.0;
+    for(int j=i*k; j<(i+1)*k; j++)
+    {
+      double w = jw[j];
+      if (w==0.0)
+        continue;
+      const double* s = skinmats+12*ji[j];
+      for(c=0; c<12; c++)
+        m[c] += w*s[c];
+      wsum += w;
+    }
+    if (wsum==0.0)
+      setIdentity(m);
+  }
+}
+
+/**
+  Compute the blended transform of every vertex by dual quaternion skinning.
+
+  \param dqs Unit dual quaternions of the joints (8 values per joint)
+ */
+void SkinGeom::blendDualQuat(const double* dqs)
+{
+  int numverts = int(bindverts.size());
+  int k = numinfluences;
+  const int* ji = &infjoints[0];
+  const double* jw = &infweights[0];
+  double* xf = &vertxforms[0];
+
+#ifdef _OPENMP
+#pragma omp parallel for if(numverts>=256)
+#endif
+  for(int i=0; i<numverts; i++)
+  {
+    double* m = xf+12*i;
+    double b[8] = {0,0,0,0, 0,0,0,0};
+    const double* pivot = 0;
+    int c;
+    for(int j=i*k; j<(i+1)*k; j++)
+    {
+      double w = jw[j];
+      if (w==0.0)
+        continue;
+      const double* dq = dqs+8*ji[j];
+      // Blend along the shortest path (relative to the first influence)
+      if (pivot==0)
+        pivot = dq;
+      else if (pivot[0]*dq[0]+pivot[1]*dq[1]+pivot[2]*dq[2]+pivot[3]*dq[3]<0)
+        w = -w;
+      for(c=0; c<8; c++)
+        b[c] += w*dq[c];
+    }
+
+    double len = sqrt(b[0]*b[0]+b[1]*b[1]+b[2]*b[2]+b[3]*b[3]);
+    if (len<1E-12)
+    {
+      setIdentity(m);
+      continue;
+    }
+    for(c=0; c<8; c++)
+      b[c] /= len;
+
+    double w = b[0], x = b[1], y = b[2], z = b[3];
+    double ew = b[4], ex = b[5], ey = b[6], ez = b[7];
+    m[0] = 1-2*(y*y+z*z); m[1] = 2*(x*y-w*z);   m[2] = 2*(x*z+w*y);
+    m[4] = 2*(x*y+w*z);   m[5] = 1-2*(x*x+z*z); m[6] = 2*(y*z-w*x);
+    m[8] = 2*(x*z-w*y);   m[9] = 2*(y*z+w*x);   m[10] = 1-2*(x*x+y*y);
+    // t = 2*(w*e - ew*v + v x e)
+    m[3] = 2*(w*ex - ew*x + y*ez - z*ey);
+    m[7] = 2*(w*ey - ew*y + z*ex - x*ez);
+    m[11] = 2*(w*ez - ew*z + x*ey - y*ex);
+  }
+}
+
+void SkinGeom::onJointChanged()
+{
+  dirty = true;
+}
+
+void SkinGeom::onBindVertsChanged(int start, int end)
+{
+  if (bindmesh.get()==0 || bindmesh->verts.size()!=int(bindverts.size()))
+    return;
+  for(int i=start; i<end; i++)
+    bindverts[i] = bindmesh->verts.getValue(i);
+  dirty = true;
+}
+
+void SkinGeom::onBindVertsResize(int)
+{
+  // Nothing to do, the mesh is kept until rebuild() is called
+}
+
+}  // end of namespace
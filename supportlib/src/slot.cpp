@@ -47,12 +47,19 @@ ISlot::ISlot()
 { 
 //  std::cout<<"0x"<<std::hex<<(long)this<<std::dec<<": ISlot<T>::ISlot()"<<std::endl;
   _slot_counter+=1; 
+#ifdef CGKIT_SLOT_PROFILING
+  _profstats = 0;
+  _profowner = 0;
+#endif
 }
 
 ISlot::~ISlot()
 { 
 //  std::cout<<"0x"<<std::hex<<(long)this<<std::dec<<": ISlot<T>::~ISlot() begin"<<std::endl;
   _slot_counter-=1; 
+#ifdef CGKIT_SLOT_PROFILING
+  SlotProfiler::releaseStats(_profstats);
+#endif
   if (_slot_counter<0)
   {
     std::cerr<<"BUG-WARNING: _slot_counter is below zero ("<<_slot_counter<<")!"<<std::endl;
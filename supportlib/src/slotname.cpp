@@ -0,0 +1,116 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#define DLL_EXPORT_SLOTNAME
+#include "slotname.h"
+#include "stringhash.h"
+#include <map>
+
+namespace support3d {
+
+// Return the global name table
+// (it's created on first use so that static SlotName objects in other
+// modules can be initialized before this module. It's never destroyed
+// so that static SlotName objects can still release their entries
+// during program exit)
+static std::map<std::string, SlotNameEntry*>& nameTable()
+{
+  static std::map<std::string, SlotNameEntry*>* table = new std::map<std::string, SlotNameEntry*>();
+  return *table;
+}
+
+/**
+  Return the entry for a name.
+
+  A new entry is created if the name isn't in use. The reference count
+  of the returned entry has already been increased.
+ */
+const SlotNameEntry* SlotName::intern(const std::string& name)
+{
+  std::map<std::string, SlotNameEntry*>& table = nameTable();
+  std::map<std::string, SlotNameEntry*>::iterator it = table.find(name);
+  if (it!=table.end())
+  {
+    it->second->refcount++;
+    return it->second;
+  }
+
+  SlotNameEntry* e = new SlotNameEntry();
+  e->str = name;
+  e->hash = hashString(name);
+  e->refcount = 1;
+  table[name] = e;
+  return e;
+}
+
+/**
+  Decrease the reference count of an entry.
+
+  The entry is removed from the table and deleted when it isn't
+  referenced anymore.
+ */
+void SlotName::release(const SlotNameEntry* e)
+{
+  e->refcount--;
+  if (e->refcount>0)
+    return;
+
+  nameTable().erase(e->str);
+  delete e;
+}
+
+/**
+  Compute the hash value of a string (FNV-1a).
+
+  This is the hash that is used by Component to look up slots,
+  so a slot can also be found by a plain string without creating
+  a SlotName.
+ */
+unsigned int SlotName::hashString(const std::string& s)
+{
+  return fnvHash(s);
+}
+
+/**
+  Return the number of names in the global name table.
+
+  This is the number of different names that are currently in use.
+ */
+int SlotName::numNames()
+{
+  return int(nameTable().size());
+}
+
+}  // end of namespace
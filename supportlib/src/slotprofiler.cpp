@@ -0,0 +1,209 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#define DLL_EXPORT_SLOTPROFILER
+#include "slotprofiler.h"
+#include "slot.h"
+#include "common_exceptions.h"
+
+#ifdef WIN32
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+
+namespace support3d {
+
+bool SlotProfiler::enabled = false;
+
+/// All counters that are currently allocated
+static std::vector<SlotStats*> allstats;
+
+/// The innermost active evaluation of the current thread
+static CGKIT_THREAD_LOCAL SlotProfiler::EvalScope* currentscope = 0;
+
+/**
+  Return true if the profiler was compiled into the library.
+
+  If this returns false, the profiler can still be enabled but it
+  won't collect any data.
+ */
+bool SlotProfiler::isAvailable()
+{
+#ifdef CGKIT_SLOT_PROFILING
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+  Enable or disable the profiler.
+
+  Disabling the profiler doesn't clear the collected data.
+ */
+void SlotProfiler::setEnabled(bool flag)
+{
+  enabled = flag;
+}
+
+/**
+  Reset all counters.
+ */
+void SlotProfiler::reset()
+{
+  std::vector<SlotStats*>::iterator it;
+  for(it=allstats.begin(); it!=allstats.end(); it++)
+  {
+    SlotStats* s = *it;
+    s->getvalue_calls = 0;
+    s->cache_hits = 0;
+    s->evaluations = 0;
+    s->setvalue_calls = 0;
+    s->notify_calls = 0;
+    s->notifications = 0;
+    s->total_time = 0.0;
+    s->self_time = 0.0;
+  }
+}
+
+/**
+  Return the number of slots that have counters.
+ */
+int SlotProfiler::numStats()
+{
+  return int(allstats.size());
+}
+
+/**
+  Return the counters with index idx.
+
+  The index is only valid until a slot is created or deleted.
+ */
+const SlotStats& SlotProfiler::getStats(int idx)
+{
+  if (idx<0 || idx>=int(allstats.size()))
+    throw EIndexError("Slot stats index out of range.");
+  return *allstats[idx];
+}
+
+/**
+  Return a time stamp in seconds.
+
+  Only the difference between two time stamps is meaningful.
+ */
+double SlotProfiler::now()
+{
+#ifdef WIN32
+  static double freq = 0.0;
+  LARGE_INTEGER t;
+  if (freq==0.0)
+  {
+    QueryPerformanceFrequency(&t);
+    freq = double(t.QuadPart);
+  }
+  QueryPerformanceCounter(&t);
+  return double(t.QuadPart)/freq;
+#else
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return double(t.tv_sec) + 1E-9*double(t.tv_nsec);
+#endif
+}
+
+/**
+  Allocate the counters for a slot.
+ */
+SlotStats* SlotProfiler::createStats(const ISlot* slot)
+{
+  SlotStats* s = new SlotStats();
+  s->slot = slot;
+#ifdef CGKIT_SLOT_PROFILING
+  s->owner = slot->_profowner;
+#else
+  s->owner = 0;
+#endif
+  s->index = int(allstats.size());
+  allstats.push_back(s);
+  return s;
+}
+
+/**
+  Free the counters of a slot.
+
+  This is called when a slot is deleted. s is set to 0.
+ */
+void SlotProfiler::releaseStats(SlotStats*& s)
+{
+  if (s==0)
+    return;
+  // Move the last item into the free position
+  SlotStats* last = allstats.back();
+  allstats[s->index] = last;
+  last->index = s->index;
+  allstats.pop_back();
+  delete s;
+  s = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+/**
+  Start measuring an evaluation.
+ */
+void SlotProfiler::EvalScope::begin(ISlot* slot, SlotStats*& stats)
+{
+  scopestats = SlotProfiler::stats(slot, stats);
+  scopestats->evaluations++;
+  parent = currentscope;
+  currentscope = this;
+  childtime = 0.0;
+  start = SlotProfiler::now();
+}
+
+/**
+  Stop measuring an evaluation.
+ */
+void SlotProfiler::EvalScope::end()
+{
+  double t = SlotProfiler::now() - start;
+  scopestats->total_time += t;
+  scopestats->self_time += t - childtime;
+  currentscope = parent;
+  if (parent!=0)
+    parent->childtime += t;
+}
+
+}  // end of namespace
@@ -0,0 +1,1112 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <cmath>
+#include <algorithm>
+#if __cplusplus>=201103L || (defined(_MSC_VER) && _MSC_VER>=1700)
+  #define HAVE_STEADY_CLOCK
+  #include <chrono>
+#elif defined(WIN32)
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+#include "softrenderer.h"
+#include "primvaraccess.h"
+#include "lightsource.h"
+#include "glpointlight.h"
+#include "glspotlight.h"
+#include "gldistantlight.h"
+#include "common_exceptions.h"
+#include "tracing.h"
+#include "opengl.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace support3d {
+
+/// Global ambient light (the OpenGL default).
+static const double global_ambient = 0.2;
+
+/**
+  Return the current (wall clock) time in seconds (used for the statistics).
+
+  Only the difference between two time stamps is meaningful. CPU time
+  can't be used here as it adds up the time of all render threads.
+ */
+static double currentTime()
+{
+#if defined(HAVE_STEADY_CLOCK)
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#elif defined(WIN32)
+  static double freq = 0.0;
+  LARGE_INTEGER t;
+  if (freq==0.0)
+  {
+    QueryPerformanceFrequency(&t);
+    freq = double(t.QuadPart);
+  }
+  QueryPerformanceCounter(&t);
+  return double(t.QuadPart)/freq;
+#else
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return double(t.tv_sec) + 1E-9*double(t.tv_nsec);
+#endif
+}
+
+/// Return the OpenGL blend factor for one channel.
+static inline float blendFactor(int factor, const float* src, const float* dst, int channel)
+{
+  switch(factor)
+  {
+   case GL_ZERO: return 0.0f;
+   case GL_ONE: return 1.0f;
+   case GL_SRC_COLOR: return src[channel];
+   case GL_ONE_MINUS_SRC_COLOR: return 1.0f-src[channel];
+   case GL_DST_COLOR: return dst[channel];
+   case GL_ONE_MINUS_DST_COLOR: return 1.0f-dst[channel];
+   case GL_SRC_ALPHA: return src[3];
+   case GL_ONE_MINUS_SRC_ALPHA: return 1.0f-src[3];
+   case GL_DST_ALPHA: return dst[3];
+   case GL_ONE_MINUS_DST_ALPHA: return 1.0f-dst[3];
+   case GL_SRC_ALPHA_SATURATE:
+     if (channel==3)
+       return 1.0f;
+     return std::min(src[3], 1.0f-dst[3]);
+  }
+  return 1.0f;
+}
+
+static inline float clamp01(double v)
+{
+  if (v<0.0)
+    return 0.0f;
+  if (v>1.0)
+    return 1.0f;
+  return float(v);
+}
+
+/// Sorts blended objects back-to-front.
+struct BlendedObjectOrder
+{
+  bool operator()(const std::pair<double, int>& a, const std::pair<double, int>& b) const
+  {
+    return a.first>b.first;
+  }
+};
+
+SoftRenderer::SoftRenderer()
+: projectionmatrix(1), viewmatrix(1),
+  clearcol(0.5,0.5,0.6,0),
+  left_handed(false), smooth_model(true), backface_culling(false),
+  defaultmat(), tilesize(32), numthreads(0),
+  stat_triangles(0), stat_render_time(0.0),
+  width(0), height(0), colorbuffer(), depthbuffer(),
+  eyelights(), triangles(), tilebins(), numtilesx(0), numtilesy(0),
+  converted()
+{
+  setResolution(640, 480);
+}
+
+/**
+  Set the image resolution.
+
+  The buffers are reallocated and cleared.
+
+  \param w Width in pixels
+  \param h Height in pixels
+ */
+void SoftRenderer::setResolution(int w, int h)
+{
+  if (w<1 || h<1)
+    throw EValueError("The resolution must be positive.");
+  width = w;
+  height = h;
+  colorbuffer.resize(4*width*height);
+  depthbuffer.resize(width*height);
+  clear();
+}
+
+/**
+  Return the color of a pixel.
+
+  \param x X coordinate (0 is the left border)
+  \param y Y coordinate (0 is the bottom border)
+  \return RGBA color
+ */
+vec4d SoftRenderer::getPixel(int x, int y) const
+{
+  if (x<0 || x>=width || y<0 || y>=height)
+    throw EIndexError("Pixel position out of range.");
+  const float* c = &colorbuffer[4*(y*width+x)];
+  return vec4d(c[0], c[1], c[2], c[3]);
+}
+
+/**
+  Return the depth value of a pixel.
+
+  \param x X coordinate (0 is the left border)
+  \param y Y coordinate (0 is the bottom border)
+  \return Window depth between 0 and 1
+ */
+double SoftRenderer::getDepth(int x, int y) const
+{
+  if (x<0 || x>=width || y<0 || y>=height)
+    throw EIndexError("Pixel position out of range.");
+  return depthbuffer[y*width+x];
+}
+
+/**
+  Convert the color buffer into 8 bit RGBA values.
+
+  \param dest Destination buffer (must hold 4*width*height bytes)
+  \param topdown If true, the first row in \a dest is the top row of the image
+ */
+void SoftRenderer::getRGBA8(unsigned char* dest, bool topdown) const
+{
+  for(int y=0; y<height; y++)
+  {
+    const float* src = &colorbuffer[4*(y*width)];
+    unsigned char* d = dest + 4*width*(topdown? height-1-y : y);
+    for(int i=0; i<4*width; i++)
+    {
+      d[i] = (unsigned char)(clamp01(src[i])*255.0f+0.5f);
+    }
+  }
+}
+
+/**
+  Fill the color buffer with the background color and reset the depth buffer.
+ */
+void SoftRenderer::clear()
+{
+  float c[4] = {float(clearcol.x), float(clearcol.y), float(clearcol.z), float(clearcol.w)};
+  int n = width*height;
+  for(int i=0; i<n; i++)
+  {
+    colorbuffer[4*i] = c[0];
+    colorbuffer[4*i+1] = c[1];
+    colorbuffer[4*i+2] = c[2];
+    colorbuffer[4*i+3] = c[3];
+    depthbuffer[i] = 1.0f;
+  }
+}
+
+/**
+  Render a scene.
+
+  \param root The root of the scene (its own transformation is not applied)
+ */
+void SoftRenderer::render(WorldObject& root)
+{
+  TRACE_SCOPE("render", "SoftRenderer::render", this);
+  double t0 = currentTime();
+
+  clear();
+  triangles.clear();
+
+  // Base transformation (the same as the modelview matrix used by
+  // GLRenderInstance before an object transformation is applied)
+  mat4d B(1);
+  if (left_handed)
+    B.setRow(0, vec4d(-1,0,0,0));
+  mat4d R180(1);
+  R180.setRow(0, vec4d(-1,0,0,0));
+  R180.setRow(2, vec4d(0,0,-1,0));
+  B = B*R180*viewmatrix;
+
+  const mat4d& RW = root.worldtransform.getValue();
+  mat4d RWinv(1);
+  if (!(RW==mat4d(1)))
+    RWinv = RW.inverse();
+
+  setupLights(root, B, RWinv);
+
+  // Collect the objects (opaque objects are processed immediately,
+  // blended objects are sorted first)...
+  TRACE_BEGIN("render", "SoftRenderer::processObjects", this);
+  std::vector<WorldObject*> stack;
+  std::vector<WorldObject*> blendobjs;
+  std::vector<std::pair<double, int> > blendorder;
+  stack.push_back(&root);
+  while(!stack.empty())
+  {
+    WorldObject* node = stack.back();
+    stack.pop_back();
+    WorldObject::ChildIterator it;
+    for(it=node->childsBegin(); it!=node->childsEnd(); it++)
+      stack.push_back(it->second.get());
+    if (node==&root)
+      continue;
+    if (node->getGeom().get()==0 || !node->visible.getValue())
+      continue;
+
+    GLMaterial* mat = dynamic_cast<GLMaterial*>(node->getMaterial().get());
+    mat4d M = RWinv*node->worldtransform.getValue();
+    if (mat!=0 && mat->usesBlending())
+    {
+      vec4d p = M.getColumn(3);
+      double depth = (viewmatrix*vec3d(p.x, p.y, p.z)).z;
+      blendorder.push_back(std::pair<double, int>(depth, blendobjs.size()));
+      blendobjs.push_back(node);
+    }
+    else
+    {
+      processObject(*node, B*M, false, -1, -1);
+    }
+  }
+
+  std::stable_sort(blendorder.begin(), blendorder.end(), BlendedObjectOrder());
+  for(unsigned int i=0; i<blendorder.size(); i++)
+  {
+    WorldObject* node = blendobjs[blendorder[i].second];
+    GLMaterial* mat = dynamic_cast<GLMaterial*>(node->getMaterial().get());
+    mat4d M = RWinv*node->worldtransform.getValue();
+    processObject(*node, B*M, true, mat->blend_sfactor, mat->blend_dfactor);
+  }
+
+  TRACE_END("render", "SoftRenderer::processObjects", this);
+  TRACE_COUNTER("render", "triangles", this, triangles.size());
+
+  // Rasterize...
+  binTriangles();
+  int numtiles = numtilesx*numtilesy;
+#ifdef _OPENMP
+  int nt = (numthreads>0)? numthreads : omp_get_max_threads();
+  #pragma omp parallel for schedule(dynamic) num_threads(nt)
+#endif
+  for(int t=0; t<numtiles; t++)
+  {
+    rasterizeTile(t%numtilesx, t/numtilesx);
+  }
+
+  stat_triangles = triangles.size();
+
+  // Release the meshes of the geoms that weren't rendered this time
+  std::map<GeomObject*, boost::shared_ptr<ConvertedMesh> >::iterator cit = converted.begin();
+  while(cit!=converted.end())
+  {
+    if (cit->second->used)
+    {
+      cit->second->used = false;
+      cit++;
+    }
+    else
+    {
+      converted.erase(cit++);
+    }
+  }
+
+  stat_render_time = currentTime()-t0;
+}
+
+/**
+  Convert the light sources into eye space.
+
+  If there are no enabled lights, the OpenGL default light is used.
+ */
+void SoftRenderer::setupLights(WorldObject& root, const mat4d& B, const mat4d& RWinv)
+{
+  eyelights.clear();
+  collectLights(root, B, RWinv);
+  if (eyelights.empty())
+  {
+    EyeLight lgt;
+    lgt.pos = vec4d(0,0,1,0);
+    lgt.spotdir = vec3d(0,0,-1);
+    lgt.spotcos = -1.0;
+    lgt.spotexponent = 0.0;
+    lgt.ambient = vec3d(0,0,0);
+    lgt.diffuse = vec3d(1,1,1);
+    lgt.specular = vec3d(1,1,1);
+    lgt.constant_attenuation = 1.0;
+    lgt.linear_attenuation = 0.0;
+    lgt.quadratic_attenuation = 0.0;
+    eyelights.push_back(lgt);
+  }
+}
+
+void SoftRenderer::collectLights(WorldObject& node, const mat4d& B, const mat4d& RWinv)
+{
+  WorldObject::ChildIterator it;
+  for(it=node.childsBegin(); it!=node.childsEnd(); it++)
+  {
+    WorldObject* obj = it->second.get();
+    collectLights(*obj, B, RWinv);
+
+    LightSource* src = dynamic_cast<LightSource*>(obj);
+    if (src==0 || !src->enabled.getValue())
+      continue;
+
+    mat4d MV = B*RWinv*obj->worldtransform.getValue();
+    double I = src->intensity.getValue();
+    EyeLight lgt;
+    lgt.spotcos = -1.0;
+    lgt.spotexponent = 0.0;
+    lgt.constant_attenuation = 1.0;
+    lgt.linear_attenuation = 0.0;
+    lgt.quadratic_attenuation = 0.0;
+    lgt.pos = MV.getColumn(3);
+    vec4d d = MV*vec4d(0,0,1,0);
+    lgt.spotdir = vec3d(d.x, d.y, d.z);
+
+    GLPointLight* pnt = dynamic_cast<GLPointLight*>(src);
+    GLSpotLight* spot = dynamic_cast<GLSpotLight*>(src);
+    GLDistantLight* dist = dynamic_cast<GLDistantLight*>(src);
+    if (pnt!=0)
+    {
+      lgt.ambient = I*pnt->ambient.getValue();
+      lgt.diffuse = I*pnt->diffuse.getValue();
+      lgt.specular = pnt->specular.getValue();
+      lgt.constant_attenuation = pnt->constant_attenuation.getValue();
+      lgt.linear_attenuation = pnt->linear_attenuation.getValue();
+      lgt.quadratic_attenuation = pnt->quadratic_attenuation.getValue();
+    }
+    else if (spot!=0)
+    {
+      lgt.ambient = I*spot->ambient.getValue();
+      lgt.diffuse = I*spot->diffuse.getValue();
+      lgt.specular = spot->specular.getValue();
+      lgt.constant_attenuation = spot->constant_attenuation.getValue();
+      lgt.linear_attenuation = spot->linear_attenuation.getValue();
+      lgt.quadratic_attenuation = spot->quadratic_attenuation.getValue();
+      double cutoff = spot->cutoff.getValue();
+      if (cutoff<180.0)
+        lgt.spotcos = cos(cutoff*M_PI/180.0);
+      lgt.spotexponent = spot->exponent.getValue();
+    }
+    else if (dist!=0)
+    {
+      // Distant lights shine along the negative local z axis
+      lgt.pos = MV*vec4d(0,0,-1,0);
+      lgt.ambient = I*dist->ambient.getValue();
+      lgt.diffuse = I*dist->diffuse.getValue();
+      lgt.specular = dist->specular.getValue();
+    }
+    else
+    {
+      continue;
+    }
+    if (lgt.spotdir.length()>0.0)
+      lgt.spotdir = lgt.spotdir.normalize();
+    eyelights.push_back(lgt);
+  }
+}
+
+/**
+  Return a mesh for a geom.
+
+  Geoms that aren't a TriMeshGeom are converted. The result is kept
+  until a slot of the geom changes or until a render() call doesn't use
+  the geom anymore (so instances are only converted once and unchanged
+  geoms aren't converted again in the next frame).
+
+  \return Mesh or 0 if the geom can't be converted
+ */
+TriMeshGeom* SoftRenderer::getMesh(const boost::shared_ptr<GeomObject>& geom)
+{
+  TriMeshGeom* tm = dynamic_cast<TriMeshGeom*>(geom.get());
+  if (tm!=0)
+    return tm;
+
+  boost::shared_ptr<ConvertedMesh>& cm = converted[geom.get()];
+  if (cm.get()==0)
+    cm = boost::shared_ptr<ConvertedMesh>(new ConvertedMesh(geom));
+  cm->used = true;
+
+  // Connect to the slots again if slots were added or removed
+  if (cm->slotserial!=geom->getSlotSerial())
+  {
+    cm->watchSlots();
+    cm->valid = false;
+  }
+  if (cm->valid)
+    return cm->mesh.get();
+
+  TRACE_SCOPE("render", "SoftRenderer::convert", this);
+  cm->mesh = boost::shared_ptr<TriMeshGeom>(new TriMeshGeom());
+  try
+  {
+    geom->convert(cm->mesh.get());
+  }
+  catch(ENotImplementedError&)
+  {
+    cm->mesh.reset();
+  }
+  cm->valid = true;
+  return cm->mesh.get();
+}
+
+/**
+  Constructor.
+
+  The slots of the geom are connected by the first getMesh() call.
+ */
+SoftRenderer::ConvertedMesh::ConvertedMesh(boost::shared_ptr<GeomObject> ageom)
+  : geom(ageom), mesh(), valid(false), used(false),
+    slotserial(ageom->getSlotSerial()-1), watchers()
+{
+}
+
+SoftRenderer::ConvertedMesh::~ConvertedMesh()
+{
+  unwatchSlots();
+}
+
+/**
+  Add a watcher to every slot of the geom.
+ */
+void SoftRenderer::ConvertedMesh::watchSlots()
+{
+  unwatchSlots();
+  for(Component::SlotIterator it=geom->slotsBegin(); it!=geom->slotsEnd(); it++)
+  {
+    ISlot* slot = &(it->second->getSlot());
+    SlotWatcher* w = new SlotWatcher(this, slot);
+    watchers.push_back(w);
+    slot->addDependent(w);
+  }
+  slotserial = geom->getSlotSerial();
+}
+
+/**
+  Remove the watchers from the slots.
+ */
+void SoftRenderer::ConvertedMesh::unwatchSlots()
+{
+  for(unsigned int i=0; i<watchers.size(); i++)
+  {
+    if (watchers[i]->slot!=0)
+      watchers[i]->slot->removeDependent(watchers[i]);
+    delete watchers[i];
+  }
+  watchers.clear();
+}
+
+/**
+  Compute the color of a vertex using the OpenGL lighting model.
+
+  \param P Eye space position
+  \param N Normalized eye space normal
+  \param mat Material
+  \param diffuse Diffuse color that replaces the material color (may be 0)
+  \param[out] col RGBA color
+ */
+void SoftRenderer::shadeVertex(const vec3d& P, const vec3d& N, const ShadeMaterial& mat, const vec3d* diffuse, float* col) const
+{
+  const vec3d& ma = mat.ambient;
+  const vec3d& ms = mat.specular;
+  const vec3d& me = mat.emission;
+  vec3d md = mat.diffuse;
+  double alpha = mat.alpha;
+  if (diffuse!=0)
+  {
+    md = *diffuse;
+    alpha = 1.0;
+  }
+
+  vec3d c(me.x + global_ambient*ma.x,
+          me.y + global_ambient*ma.y,
+          me.z + global_ambient*ma.z);
+
+  for(unsigned int i=0; i<eyelights.size(); i++)
+  {
+    const EyeLight& lgt = eyelights[i];
+    vec3d L;
+    double att = 1.0;
+    if (lgt.pos.w==0.0)
+    {
+      L = vec3d(lgt.pos.x, lgt.pos.y, lgt.pos.z);
+      double len = L.length();
+      if (len>0.0)
+        L /= len;
+    }
+    else
+    {
+      L = vec3d(lgt.pos.x, lgt.pos.y, lgt.pos.z)/lgt.pos.w - P;
+      double d = L.length();
+      if (d>0.0)
+        L /= d;
+      double a = lgt.constant_attenuation + d*(lgt.linear_attenuation + d*lgt.quadratic_attenuation);
+      if (a>0.0)
+        att = 1.0/a;
+      if (lgt.spotcos>-1.0)
+      {
+        double s = -(L*lgt.spotdir);
+        if (s<lgt.spotcos)
+          att = 0.0;
+        else
+          att *= pow(s, lgt.spotexponent);
+      }
+    }
+    if (att==0.0)
+      continue;
+
+    double NL = N*L;
+    vec3d lc(lgt.ambient.x*ma.x, lgt.ambient.y*ma.y, lgt.ambient.z*ma.z);
+    if (NL>0.0)
+    {
+      lc.x += NL*lgt.diffuse.x*md.x;
+      lc.y += NL*lgt.diffuse.y*md.y;
+      lc.z += NL*lgt.diffuse.z*md.z;
+      vec3d H = L+vec3d(0,0,1);
+      double hlen = H.length();
+      if (hlen>0.0)
+      {
+        double NH = (N*H)/hlen;
+        if (NH>0.0)
+        {
+          double s = pow(NH, mat.shininess);
+          lc.x += s*lgt.specular.x*ms.x;
+          lc.y += s*lgt.specular.y*ms.y;
+          lc.z += s*lgt.specular.z*ms.z;
+        }
+      }
+    }
+    c += att*lc;
+  }
+
+  col[0] = clamp01(c.x);
+  col[1] = clamp01(c.y);
+  col[2] = clamp01(c.z);
+  col[3] = clamp01(alpha);
+}
+
+/**
+  Light and transform a vertex.
+
+  \param MV Modelview matrix
+  \param NM Normal matrix
+  \param p Vertex position
+  \param N Vertex normal
+  \param mat Material
+  \param diffuse Diffuse color that replaces the material color (may be 0)
+  \param[out] v Result
+ */
+void SoftRenderer::shadeClipVertex(const mat4d& MV, const mat3d& NM, const vec3d& p, const vec3d& N, const ShadeMaterial& mat, const vec3d* diffuse, ClipVertex& v) const
+{
+  vec3d P = MV*p;
+  vec3d Ne = NM*N;
+  double len = Ne.length();
+  if (len>0.0)
+    Ne /= len;
+  shadeVertex(P, Ne, mat, diffuse, v.col);
+  vec4d clip = projectionmatrix*vec4d(P.x, P.y, P.z, 1.0);
+  v.pos[0] = clip.x;
+  v.pos[1] = clip.y;
+  v.pos[2] = clip.z;
+  v.pos[3] = clip.w;
+}
+
+/**
+  Light, transform, clip and set up the triangles of one object.
+
+  \param obj The object
+  \param MV Modelview matrix of the object
+  \param blended True if the material uses blending
+  \param sfactor Source blend factor
+  \param dfactor Destination blend factor
+ */
+void SoftRenderer::processObject(WorldObject& obj, const mat4d& MV, bool blended, int sfactor, int dfactor)
+{
+  TriMeshGeom* mesh = getMesh(obj.getGeom());
+  if (mesh==0)
+    return;
+  mesh->updateNormals();
+
+  GLMaterial* glmat = dynamic_cast<GLMaterial*>(obj.getMaterial().get());
+  if (glmat==0)
+    glmat = &defaultmat;
+  // Read the material once (the slots are not accessed from several threads)
+  ShadeMaterial mat;
+  vec4d c = glmat->ambient.getValue();
+  mat.ambient = vec3d(c.x, c.y, c.z);
+  c = glmat->diffuse.getValue();
+  mat.diffuse = vec3d(c.x, c.y, c.z);
+  mat.alpha = c.w;
+  c = glmat->specular.getValue();
+  mat.specular = vec3d(c.x, c.y, c.z);
+  c = glmat->emission.getValue();
+  mat.emission = vec3d(c.x, c.y, c.z);
+  mat.shininess = glmat->shininess.getValue();
+  if (!blended)
+  {
+    sfactor = -1;
+    dfactor = -1;
+  }
+
+  int numfaces = mesh->faces.size();
+  int numverts = mesh->verts.size();
+  const int* faces = mesh->faces.dataPtr();
+  const vec3d* verts = mesh->verts.dataPtr();
+  int numcorners = 3*numfaces;
+
+  // Normal matrix (inverse transpose of the upper 3x3 part of MV)
+  vec4d c0 = MV.getColumn(0);
+  vec4d c1 = MV.getColumn(1);
+  vec4d c2 = MV.getColumn(2);
+  mat3d M3(c0.x, c1.x, c2.x,
+           c0.y, c1.y, c2.y,
+           c0.z, c1.z, c2.z);
+  mat3d NM(1);
+  try
+  {
+    NM = M3.inverse().transpose();
+  }
+  catch(...)
+  {
+    return;
+  }
+
+  for(int i=0; i<numcorners; i++)
+  {
+    if (faces[i]<0 || faces[i]>=numverts)
+      throw EIndexError("Vertex index out of range in the faces of a mesh.");
+  }
+  cornerverts.resize(numcorners);
+
+  PrimVarAccess<vec3d> normals(*mesh, std::string("N"), NORMAL, 1, std::string("Nfaces"), true);
+  PrimVarAccess<vec3d> colors(*mesh, std::string("Cs"), COLOR, 1, std::string("Csfaces"), true);
+
+  // If the normals (and colors) are stored per vertex, every vertex only
+  // has to be lit once, otherwise the face corners are lit individually
+  if (normals.mode==3 && normals.var_size>=numverts &&
+      (colors.mode==0 || (colors.mode==3 && colors.var_size>=numverts)))
+  {
+    const vec3d* vnormals = normals.var_ptr;
+    const vec3d* vcolors = (colors.mode==3)? colors.var_ptr : 0;
+    shadedverts.resize(numverts);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(int i=0; i<numverts; i++)
+    {
+      shadeClipVertex(MV, NM, verts[i], vnormals[i], mat, (vcolors!=0)? vcolors+i : 0, shadedverts[i]);
+    }
+    for(int i=0; i<numcorners; i++)
+      cornerverts[i] = shadedverts[faces[i]];
+  }
+  else
+  {
+    // Gather the normals and colors per corner (this follows the OpenGL
+    // state changes in TriMeshGeom::drawGL())...
+    vec3d* N;
+    vec3d* Cs;
+    vec3d curN(0,0,1);
+    vec3d curCs(0,0,0);
+    char hascolor = 0;
+    cornernormals.resize(numcorners);
+    cornercolors.resize(numcorners);
+    cornerhascolor.resize(numcorners);
+    for(int i=0; i<numfaces; i++)
+    {
+      const int* f = faces+3*i;
+      if (normals.mode==0)
+      {
+        curN.cross(verts[f[1]]-verts[f[0]], verts[f[2]]-verts[f[0]]);
+      }
+      if (normals.onFace(N))
+        curN = *N;
+      if (colors.onFace(Cs))
+      {
+        curCs = *Cs;
+        hascolor = 1;
+      }
+      for(int k=0; k<3; k++)
+      {
+        if (normals.onVertex(f[k], N))
+          curN = *N;
+        if (colors.onVertex(f[k], Cs))
+        {
+          curCs = *Cs;
+          hascolor = 1;
+        }
+        cornernormals[3*i+k] = curN;
+        cornercolors[3*i+k] = curCs;
+        cornerhascolor[3*i+k] = hascolor;
+      }
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(int i=0; i<numcorners; i++)
+    {
+      shadeClipVertex(MV, NM, verts[faces[i]], cornernormals[i], mat, cornerhascolor[i]? &cornercolors[i] : 0, cornerverts[i]);
+    }
+  }
+
+  // Flat shading uses the color of the last vertex
+  if (!smooth_model)
+  {
+    for(int i=0; i<numfaces; i++)
+    {
+      for(int j=0; j<4; j++)
+      {
+        cornerverts[3*i].col[j] = cornerverts[3*i+2].col[j];
+        cornerverts[3*i+1].col[j] = cornerverts[3*i+2].col[j];
+      }
+    }
+  }
+
+  for(int i=0; i<numfaces; i++)
+  {
+    clipAndSetup(&cornerverts[3*i], sfactor, dfactor);
+  }
+}
+
+/**
+  Clip a triangle and pass the resulting triangles to setupTriangle().
+
+  The triangle is clipped against the near and far planes and against
+  a guard band around the viewport.
+
+  \param v The three vertices of the triangle
+ */
+void SoftRenderer::clipAndSetup(const ClipVertex* v, int sfactor, int dfactor)
+{
+  // Plane coefficients (a plane p is "inside" if dot(p, pos)>=0)
+  static const double G = 4.0;
+  static const double planes[6][4] = { {0,0,1,1}, {0,0,-1,1},
+                                       {1,0,0,G}, {-1,0,0,G},
+                                       {0,1,0,G}, {0,-1,0,G} };
+  int outcodes[3] = {0,0,0};
+  for(int i=0; i<3; i++)
+  {
+    for(int p=0; p<6; p++)
+    {
+      const double* pl = planes[p];
+      if (pl[0]*v[i].pos[0]+pl[1]*v[i].pos[1]+pl[2]*v[i].pos[2]+pl[3]*v[i].pos[3]<0.0)
+        outcodes[i] |= (1<<p);
+    }
+  }
+  // Completely outside?
+  if (outcodes[0] & outcodes[1] & outcodes[2])
+    return;
+  // Completely inside?
+  if ((outcodes[0] | outcodes[1] | outcodes[2])==0)
+  {
+    setupTriangle(v[0], v[1], v[2], sfactor, dfactor);
+    return;
+  }
+
+  // Sutherland-Hodgman clipping (a triangle clipped by 6 planes has at most 9 vertices)
+  ClipVertex buf1[12], buf2[12];
+  ClipVertex* in = buf1;
+  ClipVertex* out = buf2;
+  int n = 3;
+  in[0] = v[0];
+  in[1] = v[1];
+  in[2] = v[2];
+  int allcodes = outcodes[0] | outcodes[1] | outcodes[2];
+  for(int p=0; p<6 && n>=3; p++)
+  {
+    if ((allcodes & (1<<p))==0)
+      continue;
+    const double* pl = planes[p];
+    int m = 0;
+    for(int i=0; i<n; i++)
+    {
+      const ClipVertex& a = in[i];
+      const ClipVertex& b = in[(i+1)%n];
+      double da = pl[0]*a.pos[0]+pl[1]*a.pos[1]+pl[2]*a.pos[2]+pl[3]*a.pos[3];
+      double db = pl[0]*b.pos[0]+pl[1]*b.pos[1]+pl[2]*b.pos[2]+pl[3]*b.pos[3];
+      if (da>=0.0)
+        out[m++] = a;
+      if ((da>=0.0)!=(db>=0.0))
+      {
+        double t = da/(da-db);
+        ClipVertex& c = out[m++];
+        for(int j=0; j<4; j++)
+        {
+          c.pos[j] = a.pos[j] + t*(b.pos[j]-a.pos[j]);
+          c.col[j] = float(a.col[j] + t*(b.col[j]-a.col[j]));
+        }
+      }
+    }
+    n = m;
+    std::swap(in, out);
+  }
+
+  for(int i=1; i+1<n; i++)
+  {
+    setupTriangle(in[0], in[i], in[i+1], sfactor, dfactor);
+  }
+}
+
+/**
+  Project a triangle into the window and compute its edge functions and
+  plane equations.
+ */
+void SoftRenderer::setupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, int sfactor, int dfactor)
+{
+  const ClipVertex* v[3] = {&v0, &v1, &v2};
+  double x[3], y[3], z[3], iw[3];
+  for(int i=0; i<3; i++)
+  {
+    double w = v[i]->pos[3];
+    if (w<=0.0)
+      return;
+    iw[i] = 1.0/w;
+    x[i] = (v[i]->pos[0]*iw[i]*0.5+0.5)*width;
+    y[i] = (v[i]->pos[1]*iw[i]*0.5+0.5)*height;
+    z[i] = v[i]->pos[2]*iw[i]*0.5+0.5;
+  }
+
+  double area = (x[1]-x[0])*(y[2]-y[0]) - (x[2]-x[0])*(y[1]-y[0]);
+  if (area==0.0)
+    return;
+  if (backface_culling && area<0.0)
+    return;
+
+  // Bounding box (pixel centers are at +0.5)
+  double bxmin = std::min(x[0], std::min(x[1], x[2]));
+  double bxmax = std::max(x[0], std::max(x[1], x[2]));
+  double bymin = std::min(y[0], std::min(y[1], y[2]));
+  double bymax = std::max(y[0], std::max(y[1], y[2]));
+  RasterTriangle tri;
+  tri.xmin = std::max(0, int(floor(bxmin-0.5)));
+  tri.xmax = std::min(width-1, int(ceil(bxmax-0.5)));
+  tri.ymin = std::max(0, int(floor(bymin-0.5)));
+  tri.ymax = std::min(height-1, int(ceil(bymax-0.5)));
+  if (tri.xmin>tri.xmax || tri.ymin>tri.ymax)
+    return;
+
+  double xref = tri.xmin;
+  double yref = tri.ymin;
+  tri.xref = float(xref);
+  tri.yref = float(yref);
+
+  // Edge functions (edge i is opposite to vertex i and is positive inside)
+  double sign = (area<0.0)? -1.0 : 1.0;
+  double A[3], B[3], C[3];
+  for(int i=0; i<3; i++)
+  {
+    int j = (i+1)%3;
+    int k = (i+2)%3;
+    A[i] = -sign*(y[k]-y[j]);
+    B[i] = sign*(x[k]-x[j]);
+    C[i] = -(A[i]*(x[j]-xref) + B[i]*(y[j]-yref));
+    tri.ea[i] = float(A[i]);
+    tri.eb[i] = float(B[i]);
+    tri.ec[i] = float(C[i]);
+    tri.topleft[i] = (A[i]>0.0) || (A[i]==0.0 && B[i]>0.0);
+  }
+  double invarea = 1.0/(sign*area);
+
+  // Plane equations
+  double wz[3], ww[3];
+  for(int i=0; i<3; i++)
+  {
+    wz[i] = z[i]*invarea;
+    ww[i] = iw[i]*invarea;
+  }
+  tri.zp[0] = float(wz[0]*A[0]+wz[1]*A[1]+wz[2]*A[2]);
+  tri.zp[1] = float(wz[0]*B[0]+wz[1]*B[1]+wz[2]*B[2]);
+  tri.zp[2] = float(wz[0]*C[0]+wz[1]*C[1]+wz[2]*C[2]);
+  tri.wp[0] = float(ww[0]*A[0]+ww[1]*A[1]+ww[2]*A[2]);
+  tri.wp[1] = float(ww[0]*B[0]+ww[1]*B[1]+ww[2]*B[2]);
+  tri.wp[2] = float(ww[0]*C[0]+ww[1]*C[1]+ww[2]*C[2]);
+  for(int c=0; c<4; c++)
+  {
+    double a0 = v0.col[c]*ww[0];
+    double a1 = v1.col[c]*ww[1];
+    double a2 = v2.col[c]*ww[2];
+    tri.cp[c][0] = float(a0*A[0]+a1*A[1]+a2*A[2]);
+    tri.cp[c][1] = float(a0*B[0]+a1*B[1]+a2*B[2]);
+    tri.cp[c][2] = float(a0*C[0]+a1*C[1]+a2*C[2]);
+  }
+  tri.sfactor = sfactor;
+  tri.dfactor = dfactor;
+  triangles.push_back(tri);
+}
+
+/**
+  Sort the triangles into the tiles they overlap.
+
+  The triangles keep their order inside a tile.
+ */
+void SoftRenderer::binTriangles()
+{
+  int ts = std::max(tilesize, 4);
+  numtilesx = (width+ts-1)/ts;
+  numtilesy = (height+ts-1)/ts;
+  tilebins.resize(numtilesx*numtilesy);
+  for(unsigned int i=0; i<tilebins.size(); i++)
+    tilebins[i].clear();
+
+  for(int i=0; i<int(triangles.size()); i++)
+  {
+    const RasterTriangle& tri = triangles[i];
+    int tx1 = tri.xmax/ts;
+    int ty1 = tri.ymax/ts;
+    for(int ty=tri.ymin/ts; ty<=ty1; ty++)
+    {
+      for(int tx=tri.xmin/ts; tx<=tx1; tx++)
+      {
+        tilebins[ty*numtilesx+tx].push_back(i);
+      }
+    }
+  }
+}
+
+/**
+  Rasterize all triangles of one tile.
+
+  \param tx Tile x index
+  \param ty Tile y index
+ */
+void SoftRenderer::rasterizeTile(int tx, int ty)
+{
+  TRACE_SCOPE("render", "SoftRenderer::rasterizeTile", this);
+  int ts = std::max(tilesize, 4);
+  int tx0 = tx*ts;
+  int ty0 = ty*ts;
+  int tx1 = std::min(tx0+ts, width)-1;
+  int ty1 = std::min(ty0+ts, height)-1;
+  const std::vector<int>& bin = tilebins[ty*numtilesx+tx];
+
+  for(unsigned int b=0; b<bin.size(); b++)
+  {
+    const RasterTriangle& tri = triangles[bin[b]];
+    int x0 = std::max(tx0, tri.xmin);
+    int x1 = std::min(tx1, tri.xmax);
+    int y0 = std::max(ty0, tri.ymin);
+    int y1 = std::min(ty1, tri.ymax);
+    bool blended = (tri.sfactor!=-1);
+
+#ifdef __SSE2__
+    __m128 zero = _mm_setzero_ps();
+    __m128 ea[3], tl[3];
+    for(int i=0; i<3; i++)
+    {
+      ea[i] = _mm_set1_ps(tri.ea[i]);
+      tl[i] = _mm_castsi128_ps(_mm_set1_epi32(tri.topleft[i]? -1 : 0));
+    }
+#endif
+
+    for(int y=y0; y<=y1; y++)
+    {
+      float py = float(y)+0.5f-tri.yref;
+      float rowe[3];
+      for(int i=0; i<3; i++)
+        rowe[i] = tri.eb[i]*py + tri.ec[i];
+
+      for(int x=x0; x<=x1; x+=4)
+      {
+        float px = float(x)+0.5f-tri.xref;
+        int mask;
+#ifdef __SSE2__
+        __m128 pxv = _mm_add_ps(_mm_set1_ps(px), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for(int i=0; i<3; i++)
+        {
+          __m128 e = _mm_add_ps(_mm_mul_ps(ea[i], pxv), _mm_set1_ps(rowe[i]));
+          __m128 m = _mm_or_ps(_mm_cmpgt_ps(e, zero),
+                               _mm_and_ps(_mm_cmpeq_ps(e, zero), tl[i]));
+          inside = _mm_and_ps(inside, m);
+        }
+        mask = _mm_movemask_ps(inside);
+#else
+        mask = 0;
+        for(int l=0; l<4; l++)
+        {
+          float lx = px+float(l);
+          bool in = true;
+          for(int i=0; i<3 && in; i++)
+          {
+            float e = tri.ea[i]*lx + rowe[i];
+            in = (e>0.0f) || (e==0.0f && tri.topleft[i]);
+          }
+          if (in)
+            mask |= (1<<l);
+        }
+#endif
+        // Mask out the pixels beyond the end of the span
+        if (x1-x<3)
+          mask &= (1<<(x1-x+1))-1;
+        if (mask==0)
+          continue;
+
+        for(int l=0; l<4; l++)
+        {
+          if ((mask & (1<<l))==0)
+            continue;
+          float lx = px+float(l);
+          float z = tri.zp[0]*lx + tri.zp[1]*py + tri.zp[2];
+          int idx = y*width+x+l;
+          if (!(z<depthbuffer[idx]) || z<0.0f)
+            continue;
+          float iw = tri.wp[0]*lx + tri.wp[1]*py + tri.wp[2];
+          float w = (iw!=0.0f)? 1.0f/iw : 0.0f;
+          float col[4];
+          for(int c=0; c<4; c++)
+          {
+            col[c] = clamp01(w*(tri.cp[c][0]*lx + tri.cp[c][1]*py + tri.cp[c][2]));
+          }
+          float* dst = &colorbuffer[4*idx];
+          if (blended)
+          {
+            float res[4];
+            for(int c=0; c<4; c++)
+            {
+              res[c] = col[c]*blendFactor(tri.sfactor, col, dst, c)
+                       + dst[c]*blendFactor(tri.dfactor, col, dst, c);
+            }
+            for(int c=0; c<4; c++)
+              dst[c] = clamp01(res[c]);
+          }
+          else
+          {
+            dst[0] = col[0];
+            dst[1] = col[1];
+            dst[2] = col[2];
+            dst[3] = col[3];
+            depthbuffer[idx] = z;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // end of namespace
@@ -91,6 +91,67 @@ void SORTriangulator::drawGL(double startangle, double endangle,
   }
 }
 
+/**
+  Store the surface of revolution in a tessellation cache.
+
+  The cache receives the same quad strips that drawGL() would draw.
+  The cache is cleared first and is valid afterwards.
+
+  \param startangle Start angle in degrees
+  \param endangle End angle in degrees
+  \param segmentsu Number of segments in u direction
+  \param vlist Vertex list of the silhouette
+  \param[out] cache Receives the strips
+ */
+void SORTriangulator::tessellate(double startangle, double endangle,
+				 int segmentsu, SORVertexList& vlist,
+				 TessellationCache& cache)
+{
+  int segmentsv = vlist.size()-1;
+  // True if the first silhouette point lies on the rotation axis
+  bool ov_first = fabs(vlist[0].px)<1E-8;
+  // True if the last silhouette point lies on the rotation axis
+  bool ov_last = fabs(vlist[segmentsv].px)<1E-8;
+  int i, j;
+
+  cache.clear();
+
+  // Compute the sines/cosines of all segment boundaries once
+  std::vector<double> sines(segmentsu+1);
+  std::vector<double> cosines(segmentsu+1);
+  for(i=0; i<=segmentsu; i++)
+  {
+    double u = double(i%segmentsu)/segmentsu;
+    double angle = (1.0-u)*startangle + u*endangle;
+    angle *= 3.1415926535897931/180.0;
+    sines[i] = sin(angle);
+    cosines[i] = cos(angle);
+  }
+
+  for(i=0; i<segmentsu; i++)
+  {
+    double u1 = double(i)/segmentsu;
+    double u2 = double(i+1)/segmentsu;
+    double s1 = sines[i];
+    double c1 = cosines[i];
+    double s2 = sines[i+1];
+    double c2 = cosines[i+1];
+
+    cache.beginStrip();
+    for(j=0; j<=segmentsv; j++)
+    {
+      double v = vlist[j].v;
+      bool onaxis = (ov_first && j==0) || (ov_last && j==segmentsv);
+      const SORVertex& sv = vlist[j];
+      cache.addVertex(c1*sv.px, s1*sv.px, sv.py, c1*sv.nx, s1*sv.nx, sv.ny,
+		      onaxis? u1 + 0.5/segmentsu : u1, v);
+      cache.addVertex(c2*sv.px, s2*sv.px, sv.py, c2*sv.nx, s2*sv.nx, sv.ny,
+		      onaxis? u2 - 0.5/segmentsu : u2, v);
+    }
+  }
+  cache.finish();
+}
+
 /**
   Initialize a TriMeshGeom.
 
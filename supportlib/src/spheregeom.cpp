@@ -38,6 +38,7 @@
 #include "trimeshgeom.h"
 #include "fixedsizeconstraints.h"
 #include <cmath>
+#include <map>
 
 #include "opengl.h"
 
@@ -47,10 +48,15 @@ SphereGeom::SphereGeom(double aradius, int segsu, int segsv)
 : radius(aradius,0),
   segmentsu(segsu,0), segmentsv(segsv,0),
   cog(vec3d(0,0,0), Slot<vec3d>::NO_INPUT_CONNECTIONS),
-  inertiatensor()
+  inertiatensor(),
+  _on_param_event(), tesscache()
 {
   inertiatensor.setProcedure(this, &SphereGeom::computeInertiaTensor);
   radius.addDependent(&inertiatensor);
+  _on_param_event.init(this, &SphereGeom::onParamChanged);
+  radius.addDependent(&_on_param_event);
+  segmentsu.addDependent(&_on_param_event);
+  segmentsv.addDependent(&_on_param_event);
   addSlot("radius", radius);
   addSlot("cog", cog);
   addSlot("inertiatensor", inertiatensor);
@@ -61,6 +67,9 @@ SphereGeom::SphereGeom(double aradius, int segsu, int segsv)
 SphereGeom::~SphereGeom()
 {
   radius.removeDependent(&inertiatensor);
+  radius.removeDependent(&_on_param_event);
+  segmentsu.removeDependent(&_on_param_event);
+  segmentsv.removeDependent(&_on_param_event);
 }
 
 BoundingBox SphereGeom::boundingBox()
@@ -72,15 +81,29 @@ BoundingBox SphereGeom::boundingBox()
 
 void SphereGeom::drawGL()
 {
-  SORTriangulator sor;
-  SORTriangulator::SORVertexList vlist;
-  int segsu = segmentsu.getValue();
+  if (!tesscache.isValid())
+  {
+    SORTriangulator sor;
+    SORTriangulator::SORVertexList vlist;
+    int segsu = segmentsu.getValue();
 
-  if (segsu<3)
-    segsu=3;
+    if (segsu<3)
+      segsu=3;
 
-  createSilhouette(vlist);
-  sor.drawGL(0.0, 360.0, segsu, vlist);
+    createSilhouette(radius.getValue(), segmentsv.getValue(), vlist);
+    sor.tessellate(0.0, 360.0, segsu, vlist, tesscache);
+  }
+  tesscache.drawGL();
+}
+
+/**
+  Invalidate the tessellation cache.
+
+  This is called whenever one of the parameter slots has changed.
+ */
+void SphereGeom::onParamChanged()
+{
+  tesscache.invalidate();
 }
 
 // slotSizeConstraint
@@ -136,21 +159,52 @@ void SphereGeom::convert(GeomObject* target)
   if (segsu<3)
     segsu=3;
 
-  createSilhouette(vlist);
+  createSilhouette(radius.getValue(), segmentsv.getValue(), vlist);
   sor.convertToTriMesh(0.0, 360.0, segsu, vlist, *tm);
 }
 
+/**
+  Return a shared tessellation of a unit sphere.
+
+  The tessellations are created on first use and are kept until the
+  program ends, so they can be used for drawing many small spheres
+  (such as the markers of a DrawGeom) without tessellating each one.
+
+  \param segsu Number of segments in u
+  \param segsv Number of segments in v
+  \return Tessellation of a sphere with radius 1
+ */
+const TessellationCache& SphereGeom::unitSphere(int segsu, int segsv)
+{
+  static std::map<std::pair<int,int>, TessellationCache> spheres;
+
+  if (segsu<3)
+    segsu=3;
+  if (segsv<2)
+    segsv=2;
+
+  TessellationCache& res = spheres[std::make_pair(segsu, segsv)];
+  if (!res.isValid())
+  {
+    SORTriangulator sor;
+    SORTriangulator::SORVertexList vlist;
+    createSilhouette(1.0, segsv, vlist);
+    sor.tessellate(0.0, 360.0, segsu, vlist, res);
+  }
+  return res;
+}
+
 /**
   Helper method.
 
   This method creates the silhouette for the SORTriangulator class.
 
+  \param rad Sphere radius
+  \param segsv Number of segments in v
   \param[out] vlist Empty vertex list which will receive the result
  */
-void SphereGeom::createSilhouette(SORTriangulator::SORVertexList& vlist)
+void SphereGeom::createSilhouette(double rad, int segsv, SORTriangulator::SORVertexList& vlist)
 {
-  double rad = radius.getValue();
-  int segsv = segmentsv.getValue();
   int i;
 
   if (segsv<2)
@@ -0,0 +1,942 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <math.h>
+#include <algorithm>
+#include "subdivider.h"
+#include "meshtopology.h"
+#include "meshcleanup.h"
+#include "trimeshgeom.h"
+#include "polyhedrongeom.h"
+#include "common_exceptions.h"
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+namespace support3d {
+
+//////////////////////////////////////////////////////////////////////
+// StencilTable
+//////////////////////////////////////////////////////////////////////
+
+/**
+  Initialize the table so that it maps every input to itself.
+
+  \param n Number of inputs (and outputs)
+ */
+void StencilTable::identity(int n)
+{
+  numsrc = n;
+  offsets.resize(n+1);
+  indices.resize(n);
+  weights.assign(n, 1.0);
+  for(int i=0; i<n; i++)
+  {
+    offsets[i] = i;
+    indices[i] = i;
+  }
+  offsets[n] = n;
+}
+
+// Compute the weighted sums for types that support + and * with a double
+template<class T>
+static void applyWeighted(const StencilTable& st, const T* src, T* dst, int mult)
+{
+  int i;
+  int numrows = st.numRows();
+#ifdef _OPENMP
+  #pragma omp parallel for if(numrows>=256)
+#endif
+  for(i=0; i<numrows; i++)
+  {
+    int start = st.offsets[i];
+    int end = st.offsets[i+1];
+    if (start==end)
+      continue;
+    for(int m=0; m<mult; m++)
+    {
+      T sum = src[st.indices[start]*mult+m]*st.weights[start];
+      for(int j=start+1; j<end; j++)
+      {
+        sum += src[st.indices[j]*mult+m]*st.weights[j];
+      }
+      dst[i*mult+m] = sum;
+    }
+  }
+}
+
+// Take the value of the input with the largest weight (for types that
+// can't be interpolated)
+template<class T>
+static void applyNearest(const StencilTable& st, const T* src, T* dst, int mult)
+{
+  int numrows = st.numRows();
+  for(int i=0; i<numrows; i++)
+  {
+    int start = st.offsets[i];
+    int end = st.offsets[i+1];
+    if (start==end)
+      continue;
+    int best = start;
+    for(int j=start+1; j<end; j++)
+    {
+      if (st.weights[j]>st.weights[best])
+        best = j;
+    }
+    for(int m=0; m<mult; m++)
+    {
+      dst[i*mult+m] = src[st.indices[best]*mult+m];
+    }
+  }
+}
+
+/**
+  Compute the output values.
+
+  \param src Input values (numsrc*mult items)
+  \param[out] dst Output values (numRows()*mult items)
+  \param mult Multiplicity of the values
+ */
+void StencilTable::apply(const double* src, double* dst, int mult) const
+{
+  applyWeighted(*this, src, dst, mult);
+}
+
+void StencilTable::apply(const vec3d* src, vec3d* dst, int mult) const
+{
+  applyWeighted(*this, src, dst, mult);
+}
+
+void StencilTable::apply(const vec4d* src, vec4d* dst, int mult) const
+{
+  applyWeighted(*this, src, dst, mult);
+}
+
+void StencilTable::apply(const mat4d* src, mat4d* dst, int mult) const
+{
+  applyWeighted(*this, src, dst, mult);
+}
+
+void StencilTable::apply(const int* src, int* dst, int mult) const
+{
+  applyNearest(*this, src, dst, mult);
+}
+
+void StencilTable::apply(const std::string* src, std::string* dst, int mult) const
+{
+  applyNearest(*this, src, dst, mult);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Helpers for building the stencils
+//////////////////////////////////////////////////////////////////////
+
+/*
+  Accumulates a weighted sum of rows of a stencil table.
+
+  The rows of the previous subdivision level are expressed in terms of
+  the cage, so adding them with the local subdivision weights yields the
+  row of the new level in terms of the cage.
+ */
+class RowBuilder
+{
+  protected:
+  std::vector<double> acc;
+  std::vector<char> used;
+  std::vector<int> touched;
+
+  public:
+  RowBuilder(int numsrc) : acc(numsrc, 0.0), used(numsrc, 0), touched() {}
+
+  // Add row 'row' of table t with weight w
+  void add(const StencilTable& t, int row, double w)
+  {
+    for(int j=t.offsets[row]; j<t.offsets[row+1]; j++)
+    {
+      int idx = t.indices[j];
+      if (!used[idx])
+      {
+        used[idx] = 1;
+        touched.push_back(idx);
+      }
+      acc[idx] += w*t.weights[j];
+    }
+  }
+
+  // Append the accumulated row to the table and reset the builder
+  void flush(StencilTable& t)
+  {
+    std::sort(touched.begin(), touched.end());
+    for(unsigned int i=0; i<touched.size(); i++)
+    {
+      int idx = touched[i];
+      if (acc[idx]!=0.0)
+      {
+        t.indices.push_back(idx);
+        t.weights.push_back(acc[idx]);
+      }
+      acc[idx] = 0.0;
+      used[idx] = 0;
+    }
+    touched.clear();
+    t.offsets.push_back(int(t.indices.size()));
+  }
+};
+
+// Assign an index to each edge (both half-edges of an edge get the same id)
+static int numberEdges(const MeshTopology& topo, std::vector<int>& edgeid)
+{
+  int n = topo.getNumHalfEdges();
+  int res = 0;
+  edgeid.resize(n);
+  for(int he=0; he<n; he++)
+  {
+    int tw = topo.twin(he);
+    if (tw==-1 || tw>he)
+    {
+      edgeid[he] = res;
+      res++;
+    }
+    else
+    {
+      edgeid[he] = edgeid[tw];
+    }
+  }
+  return res;
+}
+
+/*
+  Classify a vertex for the subdivision rules.
+
+  Returns 0 for interior vertices, 1 for boundary vertices with exactly
+  one incoming and one outgoing boundary edge (bprev and bnext receive
+  the neighbors along the boundary) and 2 for vertices that are kept
+  fixed (corners, non-manifold vertices and isolated vertices).
+ */
+static int classifyVertex(const MeshTopology& topo, int v, int& bprev, int& bnext)
+{
+  int n = topo.numOutgoing(v);
+  int numin = 0;
+  int numout = 0;
+  if (n==0)
+    return 2;
+  for(int i=0; i<n; i++)
+  {
+    int he = topo.outgoing(v, i);
+    if (topo.twin(he)==-1)
+    {
+      numout++;
+      bnext = topo.target(he);
+    }
+    int prevhe = topo.prev(he);
+    if (topo.twin(prevhe)==-1)
+    {
+      numin++;
+      bprev = topo.origin(prevhe);
+    }
+  }
+  if (numin==0 && numout==0)
+    return 0;
+  if (numin==1 && numout==1)
+    return 1;
+  return 2;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Subdivider
+//////////////////////////////////////////////////////////////////////
+
+Subdivider::Subdivider()
+  : vertstencils(), cornerstencils(), faces(), facesrc(),
+    cageoffsets(1, 0), cagerows(), rowstamps(), stamp(0)
+{
+}
+
+/**
+  Build the stencils for Catmull-Clark subdivision of a polyhedron.
+
+  Only the outer loop of each poly is used. Polys with less than 3
+  vertices or with invalid vertex indices are ignored.
+
+  \param cage The control mesh
+  \param levels Number of subdivision steps (0 just triangulates the cage)
+ */
+void Subdivider::catmullClark(PolyhedronGeom& cage, int levels)
+{
+  std::vector<int> faceoffsets(1, 0);
+  std::vector<int> faceverts;
+  std::vector<int> facecorners;
+  std::vector<int> facesources;
+  int numverts = cage.verts.size();
+  int numcorners = 0;
+
+  for(int i=0; i<cage.getNumPolys(); i++)
+  {
+    int numloops = cage.getNumLoops(i);
+    if (numloops>0)
+    {
+      std::vector<int> loop = cage.getLoop(i, 0);
+      bool valid = (loop.size()>=3);
+      for(unsigned int j=0; j<loop.size(); j++)
+      {
+        if (loop[j]<0 || loop[j]>=numverts)
+          valid = false;
+      }
+      if (valid)
+      {
+        for(unsigned int j=0; j<loop.size(); j++)
+        {
+          faceverts.push_back(loop[j]);
+          facecorners.push_back(numcorners+j);
+        }
+        faceoffsets.push_back(int(faceverts.size()));
+        facesources.push_back(i);
+      }
+    }
+    for(int j=0; j<numloops; j++)
+    {
+      numcorners += cage.getNumVerts(i, j);
+    }
+  }
+
+  build(faceoffsets, faceverts, facecorners, facesources, numverts, numcorners, levels, false);
+}
+
+/**
+  Build the stencils for Loop subdivision of a triangle mesh.
+
+  Faces with invalid vertex indices are ignored.
+
+  \param cage The control mesh
+  \param levels Number of subdivision steps (0 just copies the cage)
+ */
+void Subdivider::loop(TriMeshGeom& cage, int levels)
+{
+  std::vector<int> faceoffsets(1, 0);
+  std::vector<int> faceverts;
+  std::vector<int> facecorners;
+  std::vector<int> facesources;
+  int numverts = cage.verts.size();
+  int numfaces = cage.faces.size();
+  const int* cagefaces = cage.faces.dataPtr();
+
+  for(int i=0; i<numfaces; i++)
+  {
+    const int* f = cagefaces+3*i;
+    bool valid = true;
+    for(int k=0; k<3; k++)
+    {
+      if (f[k]<0 || f[k]>=numverts)
+        valid = false;
+    }
+    if (!valid)
+      continue;
+    for(int k=0; k<3; k++)
+    {
+      faceverts.push_back(f[k]);
+      facecorners.push_back(3*i+k);
+    }
+    faceoffsets.push_back(int(faceverts.size()));
+    facesources.push_back(i);
+  }
+
+  build(faceoffsets, faceverts, facecorners, facesources, numverts, 3*numfaces, levels, true);
+}
+
+/**
+  Build the stencils for a general polygon mesh.
+
+  \param faceoffsets Face offsets into faceverts (number of faces + 1 items)
+  \param faceverts Vertex indices of all faces
+  \param facecorners Cage corner index (facevarying index) of each face vertex
+  \param facesources Cage face index of each face
+  \param numverts Number of cage vertices
+  \param numcorners Number of cage corners
+  \param levels Number of subdivision steps
+  \param loopscheme True for Loop subdivision (all faces must be triangles), false for Catmull-Clark
+ */
+void Subdivider::build(const std::vector<int>& faceoffsets, const std::vector<int>& faceverts, const std::vector<int>& facecorners, const std::vector<int>& facesources, int numverts, int numcorners, int levels, bool loopscheme)
+{
+  if (levels<0)
+    throw EValueError("The number of subdivision levels must not be negative.");
+
+  std::vector<int> foff(faceoffsets);
+  std::vector<int> fverts(faceverts);
+  std::vector<int> fsrc(facesources);
+  StencilTable verts;
+  StencilTable corners;
+  int i;
+
+  verts.identity(numverts);
+  corners.numsrc = numcorners;
+  corners.offsets.resize(facecorners.size()+1);
+  corners.indices = facecorners;
+  corners.weights.assign(facecorners.size(), 1.0);
+  for(i=0; i<=int(facecorners.size()); i++)
+    corners.offsets[i] = i;
+
+  for(int level=0; level<levels; level++)
+  {
+    int numfaces = int(fsrc.size());
+    std::vector<int> loopfaces(numfaces);
+    for(i=0; i<numfaces; i++)
+      loopfaces[i] = i;
+    MeshTopology topo;
+    topo.buildLoops(foff, fverts, loopfaces, numfaces, verts.numRows());
+
+    std::vector<int> newfoff;
+    std::vector<int> newfverts;
+    std::vector<int> newfsrc;
+    StencilTable newverts;
+    StencilTable newcorners;
+    if (loopscheme)
+    {
+      loopLevel(topo, fverts, verts, corners, newfverts, newverts, newcorners);
+      newfoff.resize(4*numfaces+1);
+      newfsrc.resize(4*numfaces);
+      for(i=0; i<4*numfaces; i++)
+      {
+        newfoff[i] = 3*i;
+        newfsrc[i] = fsrc[i/4];
+      }
+      newfoff[4*numfaces] = 12*numfaces;
+    }
+    else
+    {
+      catmullClarkLevel(topo, foff, fverts, verts, corners, newfoff, newfverts, newverts, newcorners);
+      newfsrc.resize(fverts.size());
+      for(i=0; i<numfaces; i++)
+      {
+        for(int j=foff[i]; j<foff[i+1]; j++)
+          newfsrc[j] = fsrc[i];
+      }
+    }
+    foff.swap(newfoff);
+    fverts.swap(newfverts);
+    fsrc.swap(newfsrc);
+    verts = newverts;
+    corners = newcorners;
+  }
+
+  // Triangulate the faces of the last level (fan triangulation)
+  vertstencils = verts;
+  cornerstencils.clear();
+  cornerstencils.numsrc = numcorners;
+  faces.clear();
+  facesrc.clear();
+  RowBuilder row(numcorners);
+  for(i=0; i<int(fsrc.size()); i++)
+  {
+    int start = foff[i];
+    int k = foff[i+1]-start;
+    for(int j=1; j<k-1; j++)
+    {
+      int c[3] = {start, start+j, start+j+1};
+      for(int l=0; l<3; l++)
+      {
+        faces.push_back(fverts[c[l]]);
+        row.add(corners, c[l], 1.0);
+        row.flush(cornerstencils);
+      }
+      facesrc.push_back(fsrc[i]);
+    }
+  }
+
+  buildTranspose();
+}
+
+/**
+  Do one Catmull-Clark step.
+
+  The new vertices are ordered as follows: First the vertex points (so
+  the indices of the old vertices remain valid), then the face points
+  and finally the edge points. Each face with k vertices is split into
+  k quads, the new faces have the same order as the old corners.
+ */
+void Subdivider::catmullClarkLevel(const MeshTopology& topo, const std::vector<int>& foff, const std::vector<int>& fverts, const StencilTable& verts, const StencilTable& corners, std::vector<int>& newfoff, std::vector<int>& newfverts, StencilTable& newverts, StencilTable& newcorners)
+{
+  int numverts = topo.getNumVerts();
+  int numfaces = topo.getNumFaces();
+  int numhe = topo.getNumHalfEdges();
+  std::vector<int> edgeid;
+  int numedges = numberEdges(topo, edgeid);
+  RowBuilder row(verts.numsrc);
+  int i, j;
+
+  newverts.clear();
+  newverts.numsrc = verts.numsrc;
+
+  // Vertex points
+  for(i=0; i<numverts; i++)
+  {
+    int bprev = -1;
+    int bnext = -1;
+    switch(classifyVertex(topo, i, bprev, bnext))
+    {
+    case 0:
+      {
+        int n = topo.numOutgoing(i);
+        double nn = double(n)*n;
+        row.add(verts, i, double(n-2)/n);
+        for(j=0; j<n; j++)
+        {
+          int he = topo.outgoing(i, j);
+          row.add(verts, topo.target(he), 1.0/nn);
+          int f = topo.face(he);
+          int k = foff[f+1]-foff[f];
+          for(int l=foff[f]; l<foff[f+1]; l++)
+            row.add(verts, fverts[l], 1.0/(nn*k));
+        }
+      }
+      break;
+    case 1:
+      row.add(verts, i, 0.75);
+      row.add(verts, bprev, 0.125);
+      row.add(verts, bnext, 0.125);
+      break;
+    default:
+      row.add(verts, i, 1.0);
+    }
+    row.flush(newverts);
+  }
+
+  // Face points
+  for(i=0; i<numfaces; i++)
+  {
+    int k = foff[i+1]-foff[i];
+    for(j=foff[i]; j<foff[i+1]; j++)
+      row.add(verts, fverts[j], 1.0/k);
+    row.flush(newverts);
+  }
+
+  // Edge points
+  std::vector<int> edgehe(numedges);
+  for(i=numhe-1; i>=0; i--)
+    edgehe[edgeid[i]] = i;
+  for(i=0; i<numedges; i++)
+  {
+    int he = edgehe[i];
+    int tw = topo.twin(he);
+    if (tw==-1)
+    {
+      row.add(verts, topo.origin(he), 0.5);
+      row.add(verts, topo.target(he), 0.5);
+    }
+    else
+    {
+      row.add(verts, topo.origin(he), 0.25);
+      row.add(verts, topo.target(he), 0.25);
+      int fs[2] = {topo.face(he), topo.face(tw)};
+      for(int l=0; l<2; l++)
+      {
+        int f = fs[l];
+        int k = foff[f+1]-foff[f];
+        for(j=foff[f]; j<foff[f+1]; j++)
+          row.add(verts, fverts[j], 0.25/k);
+      }
+    }
+    row.flush(newverts);
+  }
+
+  // New faces (one quad per corner)
+  RowBuilder crow(corners.numsrc);
+  newcorners.clear();
+  newcorners.numsrc = corners.numsrc;
+  newfoff.resize(numhe+1);
+  newfverts.resize(4*numhe);
+  for(i=0; i<numfaces; i++)
+  {
+    int start = foff[i];
+    int end = foff[i+1];
+    int k = end-start;
+    for(j=start; j<end; j++)
+    {
+      int prevhe = topo.prev(j);
+      int nexthe = topo.next(j);
+      int* q = &newfverts[4*j];
+      q[0] = fverts[j];
+      q[1] = numverts+numfaces+edgeid[j];
+      q[2] = numverts+i;
+      q[3] = numverts+numfaces+edgeid[prevhe];
+      newfoff[j] = 4*j;
+
+      crow.add(corners, j, 1.0);
+      crow.flush(newcorners);
+      crow.add(corners, j, 0.5);
+      crow.add(corners, nexthe, 0.5);
+      crow.flush(newcorners);
+      for(int l=start; l<end; l++)
+        crow.add(corners, l, 1.0/k);
+      crow.flush(newcorners);
+      crow.add(corners, prevhe, 0.5);
+      crow.add(corners, j, 0.5);
+      crow.flush(newcorners);
+    }
+  }
+  newfoff[numhe] = 4*numhe;
+}
+
+/**
+  Do one Loop step.
+
+  The new vertices are ordered as follows: First the vertex points (so
+  the indices of the old vertices remain valid) and then the edge points.
+  Each triangle is split into 4 triangles.
+ */
+void Subdivider::loopLevel(const MeshTopology& topo, const std::vector<int>& fverts, const StencilTable& verts, const StencilTable& corners, std::vector<int>& newfverts, StencilTable& newverts, StencilTable& newcorners)
+{
+  int numverts = topo.getNumVerts();
+  int numfaces = topo.getNumFaces();
+  int numhe = topo.getNumHalfEdges();
+  std::vector<int> edgeid;
+  int numedges = numberEdges(topo, edgeid);
+  RowBuilder row(verts.numsrc);
+  int i, j;
+
+  if (numhe!=3*numfaces)
+    throw EValueError("Loop subdivision requires a triangle mesh.");
+
+  newverts.clear();
+  newverts.numsrc = verts.numsrc;
+
+  // Vertex points
+  for(i=0; i<numverts; i++)
+  {
+    int bprev = -1;
+    int bnext = -1;
+    switch(classifyVertex(topo, i, bprev, bnext))
+    {
+    case 0:
+      {
+        int n = topo.numOutgoing(i);
+        double c = 0.375 + 0.25*cos(2.0*PI/n);
+        double beta = (0.625 - c*c)/n;
+        row.add(verts, i, 1.0-n*beta);
+        for(j=0; j<n; j++)
+          row.add(verts, topo.target(topo.outgoing(i, j)), beta);
+      }
+      break;
+    case 1:
+      row.add(verts, i, 0.75);
+      row.add(verts, bprev, 0.125);
+      row.add(verts, bnext, 0.125);
+      break;
+    default:
+      row.add(verts, i, 1.0);
+    }
+    row.flush(newverts);
+  }
+
+  // Edge points
+  std::vector<int> edgehe(numedges);
+  for(i=numhe-1; i>=0; i--)
+    edgehe[edgeid[i]] = i;
+  for(i=0; i<numedges; i++)
+  {
+    int he = edgehe[i];
+    int tw = topo.twin(he);
+    if (tw==-1)
+    {
+      row.add(verts, topo.origin(he), 0.5);
+      row.add(verts, topo.target(he), 0.5);
+    }
+    else
+    {
+      row.add(verts, topo.origin(he), 0.375);
+      row.add(verts, topo.target(he), 0.375);
+      row.add(verts, topo.origin(topo.prev(he)), 0.125);
+      row.add(verts, topo.origin(topo.prev(tw)), 0.125);
+    }
+    row.flush(newverts);
+  }
+
+  // New faces
+  RowBuilder crow(corners.numsrc);
+  newcorners.clear();
+  newcorners.numsrc = corners.numsrc;
+  newfverts.resize(12*numfaces);
+  for(i=0; i<numfaces; i++)
+  {
+    int v0 = fverts[3*i];
+    int v1 = fverts[3*i+1];
+    int v2 = fverts[3*i+2];
+    int e0 = numverts+edgeid[3*i];
+    int e1 = numverts+edgeid[3*i+1];
+    int e2 = numverts+edgeid[3*i+2];
+    int tris[12] = {v0,e0,e2, v1,e1,e0, v2,e2,e1, e0,e1,e2};
+    for(j=0; j<12; j++)
+      newfverts[12*i+j] = tris[j];
+
+    // Corners (-1: corner of the old face, otherwise the first corner of an
+    // edge (relative to the face))
+    static const int cornerdefs[12][2] = {{0,-1},{0,1},{2,0}, {1,-1},{1,2},{0,1},
+                                          {2,-1},{2,0},{1,2}, {0,1},{1,2},{2,0}};
+    for(j=0; j<12; j++)
+    {
+      int a = 3*i+cornerdefs[j][0];
+      if (cornerdefs[j][1]==-1)
+      {
+        crow.add(corners, a, 1.0);
+      }
+      else
+      {
+        crow.add(corners, a, 0.5);
+        crow.add(corners, 3*i+cornerdefs[j][1], 0.5);
+      }
+      crow.flush(newcorners);
+    }
+  }
+}
+
+// Build the table that contains the refined vertices per cage vertex
+void Subdivider::buildTranspose()
+{
+  int numcage = vertstencils.numsrc;
+  int numrows = vertstencils.numRows();
+  int i, j;
+
+  cageoffsets.assign(numcage+1, 0);
+  for(j=0; j<int(vertstencils.indices.size()); j++)
+    cageoffsets[vertstencils.indices[j]+1]++;
+  for(i=0; i<numcage; i++)
+    cageoffsets[i+1] += cageoffsets[i];
+  cagerows.resize(cageoffsets[numcage]);
+  std::vector<int> fill(cageoffsets.begin(), cageoffsets.end()-1);
+  for(i=0; i<numrows; i++)
+  {
+    for(j=vertstencils.offsets[i]; j<vertstencils.offsets[i+1]; j++)
+    {
+      int c = vertstencils.indices[j];
+      cagerows[fill[c]] = i;
+      fill[c]++;
+    }
+  }
+  rowstamps.assign(numrows, 0);
+  stamp = 0;
+}
+
+/**
+  Compute all refined vertices.
+
+  \param cageverts Cage vertices (getNumCageVerts() items)
+  \param[out] verts Receives the refined vertices (getNumVerts() items)
+ */
+void Subdivider::updateVerts(const vec3d* cageverts, vec3d* verts) const
+{
+  vertstencils.apply(cageverts, verts);
+}
+
+/**
+  Update the refined vertices that depend on a range of cage vertices.
+
+  If the range is large, all vertices are recomputed.
+
+  \param cageverts Cage vertices (getNumCageVerts() items)
+  \param start First modified cage vertex
+  \param end Modified cage vertex after the last one
+  \param[out] verts Refined vertices (getNumVerts() items)
+  \param[out] rowbegin Receives the first refined vertex that was updated
+  \param[out] rowend Receives the refined vertex after the last updated one
+  \return False if no refined vertex was updated.
+ */
+bool Subdivider::updateVerts(const vec3d* cageverts, int start, int end, vec3d* verts, int& rowbegin, int& rowend) const
+{
+  int numcage = vertstencils.numsrc;
+  int numrows = vertstencils.numRows();
+  if (start<0)
+    start = 0;
+  if (end>numcage)
+    end = numcage;
+  if (start>=end || numrows==0)
+    return false;
+
+  // Many modified vertices? Then it's cheaper to recompute everything
+  if (cageoffsets[end]-cageoffsets[start] > numrows/4)
+  {
+    updateVerts(cageverts, verts);
+    rowbegin = 0;
+    rowend = numrows;
+    return true;
+  }
+
+  stamp++;
+  if (stamp==0)
+  {
+    rowstamps.assign(numrows, 0);
+    stamp = 1;
+  }
+  rowbegin = numrows;
+  rowend = 0;
+  for(int j=cageoffsets[start]; j<cageoffsets[end]; j++)
+  {
+    int r = cagerows[j];
+    if (rowstamps[r]==stamp)
+      continue;
+    rowstamps[r] = stamp;
+    int k = vertstencils.offsets[r];
+    vec3d sum = cageverts[vertstencils.indices[k]]*vertstencils.weights[k];
+    for(k=k+1; k<vertstencils.offsets[r+1]; k++)
+      sum += cageverts[vertstencils.indices[k]]*vertstencils.weights[k];
+    verts[r] = sum;
+    if (r<rowbegin)
+      rowbegin = r;
+    if (r>=rowend)
+      rowend = r+1;
+  }
+  return rowbegin<rowend;
+}
+
+// Interpolate the values of a primitive variable with a stencil table
+template<class T>
+static void applyStencilToSlot(const StencilTable& st, IArraySlot& src, IArraySlot& dst)
+{
+  ArraySlot<T>* s = dynamic_cast<ArraySlot<T>*>(&src);
+  ArraySlot<T>* d = dynamic_cast<ArraySlot<T>*>(&dst);
+  if (s==0 || d==0 || src.size()<st.numsrc || dst.size()!=st.numRows())
+    return;
+  if (st.numRows()==0)
+    return;
+  int mult = d->multiplicity();
+  if (d->getController()==0)
+  {
+    st.apply(s->dataPtr(), d->dataPtr(), mult);
+    d->notifyDependents();
+  }
+  else
+  {
+    std::vector<T> values(st.numRows()*mult);
+    st.apply(s->dataPtr(), &values[0], mult);
+    for(int i=0; i<st.numRows(); i++)
+      d->setValues(i, &values[i*mult]);
+  }
+}
+
+static void applyStencilToVariable(const StencilTable& st, const PrimVarInfo& info, IArraySlot& dst)
+{
+  switch(info.type)
+  {
+  case INT:
+    applyStencilToSlot<int>(st, *info.slot, dst);
+    break;
+  case FLOAT:
+    applyStencilToSlot<double>(st, *info.slot, dst);
+    break;
+  case STRING:
+    applyStencilToSlot<std::string>(st, *info.slot, dst);
+    break;
+  case COLOR:
+  case POINT:
+  case VECTOR:
+  case NORMAL:
+    applyStencilToSlot<vec3d>(st, *info.slot, dst);
+    break;
+  case HPOINT:
+    applyStencilToSlot<vec4d>(st, *info.slot, dst);
+    break;
+  case MATRIX:
+    applyStencilToSlot<mat4d>(st, *info.slot, dst);
+    break;
+  }
+}
+
+/**
+  Initialize a triangle mesh with the refined mesh.
+
+  The faces, vertices and all primitive variables of \a target are
+  replaced. The stencils must have been built from \a cage.
+
+  \param cage The cage that was used to build the stencils (the primitive variables are taken from this geom)
+  \param cageverts The cage vertices
+  \param target The mesh that receives the result (must not be the cage)
+ */
+void Subdivider::createMesh(GeomObject& cage, const vec3d* cageverts, TriMeshGeom& target) const
+{
+  if (&target==&cage)
+    throw EValueError("The target mesh must not be the cage.");
+
+  int numfaces = getNumFaces();
+  target.deleteAllVariables();
+  target.faces.resize(0);
+  target.verts.resize(getNumVerts());
+  target.faces.resize(numfaces);
+  MeshCleanup(target).setFaces(faces);
+  if (getNumVerts()>0)
+  {
+    if (target.verts.getController()==0)
+    {
+      updateVerts(cageverts, target.verts.dataPtr());
+      target.verts.notifyDependents();
+    }
+    else
+    {
+      std::vector<vec3d> values(getNumVerts());
+      updateVerts(cageverts, &values[0]);
+      for(int i=0; i<getNumVerts(); i++)
+        target.verts.setValue(i, values[i]);
+    }
+  }
+
+  // Interpolate the primitive variables...
+  GeomObject::VariableIterator it;
+  for(it=cage.variablesBegin(); it!=cage.variablesEnd(); it++)
+  {
+    const PrimVarInfo& info = it->second;
+    int n = info.slot->size();
+    target.newVariable(it->first, info.storage, info.type, info.multiplicity, (info.storage==USER)? n : 0);
+    IArraySlot& dst = *(target.findVariable(it->first)->slot);
+    switch(info.storage)
+    {
+    case UNIFORM:
+      if (numfaces>0)
+        dst.gatherValues(&facesrc[0], numfaces, info.slot);
+      break;
+    case VARYING:
+    case VERTEX:
+      applyStencilToVariable(vertstencils, info, dst);
+      break;
+    case FACEVARYING:
+    case FACEVERTEX:
+      applyStencilToVariable(cornerstencils, info, dst);
+      break;
+    default:
+      if (n>0)
+        info.slot->copyValues(0, n, dst, 0);
+      break;
+    }
+  }
+}
+
+}  // end of namespace
@@ -0,0 +1,156 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include "subdivisiongeom.h"
+#include "polyhedrongeom.h"
+#include "common_exceptions.h"
+
+namespace support3d {
+
+SubdivisionGeom::SubdivisionGeom()
+  : TriMeshGeom(), _on_cage_verts_event(), cage(), cageverts(0), levels(2),
+    subdivider()
+{
+  _on_cage_verts_event.init(this, &SubdivisionGeom::onCageVertsChanged, &SubdivisionGeom::onCageVertsResize);
+}
+
+SubdivisionGeom::~SubdivisionGeom()
+{
+  if (cageverts!=0)
+    cageverts->removeDependent(&_on_cage_verts_event);
+}
+
+/**
+  Set the control mesh.
+
+  The cage must be a PolyhedronGeom or a TriMeshGeom, otherwise an
+  EValueError exception is thrown. Passing a null pointer removes the
+  cage (the current mesh is kept).
+
+  \param acage The control mesh
+  \param alevels Number of subdivision steps
+ */
+void SubdivisionGeom::setCage(boost::shared_ptr<GeomObject> acage, int alevels)
+{
+  if (alevels<0)
+    throw EValueError("The number of subdivision levels must not be negative.");
+  if (acage.get()==this)
+    throw EValueError("A SubdivisionGeom cannot be its own cage.");
+
+  ArraySlot<vec3d>* newverts = 0;
+  if (acage.get()!=0)
+  {
+    PolyhedronGeom* pg = dynamic_cast<PolyhedronGeom*>(acage.get());
+    TriMeshGeom* tm = dynamic_cast<TriMeshGeom*>(acage.get());
+    if (pg!=0)
+      newverts = &pg->verts;
+    else if (tm!=0)
+      newverts = &tm->verts;
+    else
+      throw EValueError("The cage must be a PolyhedronGeom or a TriMeshGeom.");
+  }
+
+  if (cageverts!=0)
+    cageverts->removeDependent(&_on_cage_verts_event);
+  cage = acage;
+  cageverts = newverts;
+  levels = alevels;
+  subdivider = Subdivider();
+  rebuild();
+  if (cageverts!=0)
+    cageverts->addDependent(&_on_cage_verts_event);
+}
+
+/**
+  Set the number of subdivision steps and rebuild the mesh.
+ */
+void SubdivisionGeom::setLevels(int alevels)
+{
+  if (alevels<0)
+    throw EValueError("The number of subdivision levels must not be negative.");
+  levels = alevels;
+  rebuild();
+}
+
+/**
+  Rebuild the stencils and the mesh from the current cage.
+
+  This has to be called when the faces or the primitive variables of
+  the cage have been modified (vertex modifications are handled
+  automatically).
+ */
+void SubdivisionGeom::rebuild()
+{
+  if (cage.get()==0)
+    return;
+
+  PolyhedronGeom* pg = dynamic_cast<PolyhedronGeom*>(cage.get());
+  if (pg!=0)
+    subdivider.catmullClark(*pg, levels);
+  else
+    subdivider.loop(*dynamic_cast<TriMeshGeom*>(cage.get()), levels);
+  subdivider.createMesh(*cage, cageverts->dataPtr(), *this);
+}
+
+void SubdivisionGeom::onCageVertsChanged(int start, int end)
+{
+  // The stencils don't match the cage anymore (rebuild() has to be called)?
+  if (cageverts==0 || cageverts->size()!=subdivider.getNumCageVerts() || verts.size()!=subdivider.getNumVerts())
+    return;
+
+  if (verts.getController()==0)
+  {
+    int rowbegin, rowend;
+    if (subdivider.updateVerts(cageverts->dataPtr(), start, end, verts.dataPtr(), rowbegin, rowend))
+      verts.notifyDependentsValue(rowbegin, rowend);
+  }
+  else
+  {
+    std::vector<vec3d> values(verts.size());
+    if (values.size()>0)
+    {
+      subdivider.updateVerts(cageverts->dataPtr(), &values[0]);
+      for(int i=0; i<verts.size(); i++)
+        verts.setValue(i, values[i]);
+    }
+  }
+}
+
+void SubdivisionGeom::onCageVertsResize(int)
+{
+  // Nothing to do, the mesh is kept until rebuild() is called
+}
+
+}  // end of namespace
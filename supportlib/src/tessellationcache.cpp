@@ -0,0 +1,91 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include "tessellationcache.h"
+
+#include "opengl.h"
+
+namespace support3d {
+
+/**
+  Remove all strips.
+
+  The cache is invalid afterwards.
+ */
+void TessellationCache::clear()
+{
+  positions.clear();
+  normals.clear();
+  texcoords.clear();
+  stripstarts.clear();
+  valid = false;
+}
+
+/**
+  Begin a new quad strip.
+ */
+void TessellationCache::beginStrip()
+{
+  stripstarts.push_back(getNumVerts());
+}
+
+/**
+  Draw the strips using OpenGL.
+ */
+void TessellationCache::drawGL() const
+{
+  int numverts = getNumVerts();
+  int numstrips = getNumStrips();
+  if (numverts==0)
+    return;
+
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_NORMAL_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glVertexPointer(3, GL_FLOAT, 0, &positions[0]);
+  glNormalPointer(GL_FLOAT, 0, &normals[0]);
+  glTexCoordPointer(2, GL_FLOAT, 0, &texcoords[0]);
+  for(int i=0; i<numstrips; i++)
+  {
+    int start = stripstarts[i];
+    int end = (i+1<numstrips)? stripstarts[i+1] : numverts;
+    if (end-start>=4)
+      glDrawArrays(GL_QUAD_STRIP, start, end-start);
+  }
+  glPopClientAttrib();
+}
+
+}  // end of namespace
@@ -0,0 +1,159 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file texturecache.cpp
+ Contains the TextureCache class.
+ */
+
+#include "texturecache.h"
+
+namespace support3d {
+
+/**
+  Constructor.
+
+  \param abudget Memory budget in bytes
+ */
+TextureCache::TextureCache(unsigned long abudget)
+  : stat_hits(0), stat_misses(0), stat_evictions(0),
+    budget(abudget), memsize(0), entries(), lru()
+{
+}
+
+/**
+  Return the image that is stored under a key.
+
+  The image becomes the most recently used image.
+
+  \param key Key
+  \return Image or an empty pointer if the key is not in the cache.
+ */
+boost::shared_ptr<TextureImage> TextureCache::lookup(const std::string& key)
+{
+  std::map<std::string, Entry>::iterator it = entries.find(key);
+  if (it==entries.end())
+  {
+    stat_misses++;
+    return boost::shared_ptr<TextureImage>();
+  }
+  stat_hits++;
+  lru.splice(lru.begin(), lru, it->second.lrupos);
+  return it->second.image;
+}
+
+/**
+  Store an image in the cache.
+
+  A previous image stored under the same key is replaced. If the budget
+  is exceeded afterwards, the least recently used images are removed.
+
+  \param key Key
+  \param image Image
+ */
+void TextureCache::insert(const std::string& key, boost::shared_ptr<TextureImage> image)
+{
+  if (image.get()==0)
+    return;
+  remove(key);
+  Entry& e = entries[key];
+  e.image = image;
+  lru.push_front(key);
+  e.lrupos = lru.begin();
+  e.size = image->getMemSize();
+  memsize += e.size;
+  evict();
+}
+
+/**
+  Remove an image from the cache.
+
+  Nothing happens if the key is not in the cache.
+
+  \param key Key
+ */
+void TextureCache::remove(const std::string& key)
+{
+  std::map<std::string, Entry>::iterator it = entries.find(key);
+  if (it==entries.end())
+    return;
+  memsize -= it->second.size;
+  lru.erase(it->second.lrupos);
+  entries.erase(it);
+}
+
+/**
+  Remove all images from the cache.
+ */
+void TextureCache::clear()
+{
+  entries.clear();
+  lru.clear();
+  memsize = 0;
+}
+
+/**
+  Set a new memory budget.
+
+  \param abudget Memory budget in bytes
+ */
+void TextureCache::setBudget(unsigned long abudget)
+{
+  budget = abudget;
+  evict();
+}
+
+/**
+  Return the cache that is used by the GLTexture objects.
+ */
+TextureCache& TextureCache::defaultCache()
+{
+  static TextureCache cache;
+  return cache;
+}
+
+/**
+  Remove the least recently used images until the budget is met.
+ */
+void TextureCache::evict()
+{
+  while(memsize>budget && !lru.empty())
+  {
+    std::string key = lru.back();
+    remove(key);
+    stat_evictions++;
+  }
+}
+
+}  // end of namespace
@@ -0,0 +1,285 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file textureimage.cpp
+ Contains the TextureImage class.
+ */
+
+#include "textureimage.h"
+#include "common_exceptions.h"
+#include "tracing.h"
+#include "opengl.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace support3d {
+
+std::vector<unsigned int> TextureImage::releasednames;
+
+/**
+  Add the column sums of horizontally adjacent pixels and store the averages.
+
+  Helper for TextureImage::downsample(). The number of components is a
+  template parameter so that the inner loop can be unrolled.
+ */
+template<int C>
+static inline void addPixelPairs(const unsigned short* cs, int w, int w2, unsigned char* d)
+{
+  // All pairs that don't involve the last column of an odd width...
+  int n = (w>1)? w2 : 0;
+  for(int x=0; x<n; x++)
+  {
+    const unsigned short* p = cs+(2*x)*C;
+    for(int k=0; k<C; k++)
+    {
+      d[k] = (unsigned char)((p[k]+p[k+C]+2)>>2);
+    }
+    d += C;
+  }
+  // A width of 1 only averages vertically
+  if (w==1)
+  {
+    for(int k=0; k<C; k++)
+    {
+      d[k] = (unsigned char)((2*cs[k]+2)>>2);
+    }
+  }
+}
+
+/**
+  Constructor.
+ */
+TextureImage::TextureImage()
+  : format(0), components(0), widths(), heights(), levels(),
+    memsize(0), texname(0)
+{
+}
+
+/**
+  Destructor.
+
+  The OpenGL texture object is deleted in the next call to deleteReleasedGL().
+ */
+TextureImage::~TextureImage()
+{
+  if (texname!=0)
+    releasednames.push_back(texname);
+}
+
+/**
+  Return the number of components of a pixel format.
+
+  \param aformat Pixel format (GL_RGB, GL_RGBA, GL_LUMINANCE, ...)
+  \return Number of components or 0 if the format is not supported.
+ */
+int TextureImage::numComponents(int aformat)
+{
+  switch(aformat)
+  {
+  case GL_RGB: return 3;
+  case GL_RGBA: return 4;
+  case GL_LUMINANCE: return 1;
+  case GL_LUMINANCE_ALPHA: return 2;
+  case GL_ALPHA: return 1;
+  case GL_INTENSITY: return 1;
+  default: return 0;
+  }
+}
+
+/**
+  Set the image data and compute the mip map levels.
+
+  This method doesn't make any OpenGL calls, so it can be called from
+  any thread. Any previously uploaded texture object is kept and will
+  receive the new data in the next call to uploadGL().
+
+  \param w Width of the image
+  \param h Height of the image
+  \param aformat Pixel format (GL_RGB, GL_RGBA, GL_LUMINANCE, GL_LUMINANCE_ALPHA, GL_ALPHA or GL_INTENSITY)
+  \param data Pixel data (w*h pixels, 8 bit per component, no padding)
+  \param mipmap If true, all mip map levels down to 1x1 are computed
+ */
+void TextureImage::setData(int w, int h, int aformat, const unsigned char* data, bool mipmap)
+{
+  TRACE_SCOPE("texture", "TextureImage::setData", this);
+  int comps = numComponents(aformat);
+  if (comps==0)
+    throw EValueError("Unsupported texture format.");
+  if (w<1 || h<1)
+    throw EValueError("The texture size must be positive.");
+
+  format = aformat;
+  components = comps;
+  widths.clear();
+  heights.clear();
+  levels.clear();
+  memsize = 0;
+
+  widths.push_back(w);
+  heights.push_back(h);
+  levels.push_back(std::vector<unsigned char>(data, data+w*h*comps));
+  memsize += w*h*comps;
+
+  while(mipmap && (w>1 || h>1))
+  {
+    int w2 = (w>1)? w/2 : 1;
+    int h2 = (h>1)? h/2 : 1;
+    levels.push_back(std::vector<unsigned char>(w2*h2*comps));
+    downsample(&levels[levels.size()-2][0], w, h, comps, &levels.back()[0]);
+    widths.push_back(w2);
+    heights.push_back(h2);
+    memsize += w2*h2*comps;
+    w = w2;
+    h = h2;
+  }
+}
+
+/**
+  Return the pixel data of a mip map level.
+
+  \param level Mip map level (0 is the full resolution image)
+  \return Pixel data or 0 if the data has already been uploaded.
+ */
+const unsigned char* TextureImage::getLevelData(int level) const
+{
+  if (level<0 || level>=int(levels.size()))
+    throw EIndexError("Mip map level out of range.");
+  if (levels[level].empty())
+    return 0;
+  return &levels[level][0];
+}
+
+/**
+  Pass all levels to OpenGL.
+
+  The texture object is created if necessary and remains bound. After
+  the upload the CPU copy of the data is released.
+
+  \param internalformat Internal texture format (GL_RGB, GL_RGBA, ...)
+  \pre The appropriate OpenGL context has been made current
+ */
+void TextureImage::uploadGL(int internalformat)
+{
+  if (levels.empty() || levels[0].empty())
+    return;
+
+  if (texname==0)
+  {
+    GLuint tn[1];
+    glGenTextures(1, tn);
+    texname = tn[0];
+  }
+  glBindTexture(GL_TEXTURE_2D, texname);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  for(unsigned int i=0; i<levels.size(); i++)
+  {
+    glTexImage2D(GL_TEXTURE_2D, i, internalformat, widths[i], heights[i], 0, format, GL_UNSIGNED_BYTE, &levels[i][0]);
+  }
+  levels.assign(levels.size(), std::vector<unsigned char>());
+}
+
+/**
+  Delete the OpenGL texture objects of deleted images.
+
+  \pre The appropriate OpenGL context has been made current
+ */
+void TextureImage::deleteReleasedGL()
+{
+  if (releasednames.empty())
+    return;
+  glDeleteTextures(releasednames.size(), &releasednames[0]);
+  releasednames.clear();
+}
+
+/**
+  Downsample an image to half its size using a 2x2 box filter.
+
+  The new size is rounded down like the mip map sizes in OpenGL, so
+  if the width or height is odd, the last column or row is ignored.
+  If the width or height is 1, the image is only halved in the other
+  direction.
+
+  \param src Source image (w*h pixels)
+  \param w Width of the source image
+  \param h Height of the source image
+  \param comps Number of components per pixel
+  \param dst Receives max(w/2,1) * max(h/2,1) pixels
+ */
+void TextureImage::downsample(const unsigned char* src, int w, int h, int comps, unsigned char* dst)
+{
+  int w2 = (w>1)? w/2 : 1;
+  int h2 = (h>1)? h/2 : 1;
+  int rowsize = w*comps;
+  // Sums of two vertically adjacent components
+  std::vector<unsigned short> colsum(rowsize+16);
+
+  for(int y=0; y<h2; y++)
+  {
+    const unsigned char* row0 = src+(2*y)*rowsize;
+    const unsigned char* row1 = (2*y+1<h)? row0+rowsize : row0;
+    unsigned short* cs = &colsum[0];
+    int i = 0;
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    for(; i+16<=rowsize; i+=16)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i*)(row0+i));
+      __m128i b = _mm_loadu_si128((const __m128i*)(row1+i));
+      __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+      __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+      _mm_storeu_si128((__m128i*)(cs+i), lo);
+      _mm_storeu_si128((__m128i*)(cs+i+8), hi);
+    }
+#endif
+    for(; i<rowsize; i++)
+    {
+      cs[i] = row0[i]+row1[i];
+    }
+
+    // Add horizontally adjacent sums
+    unsigned char* d = dst+y*w2*comps;
+    switch(comps)
+    {
+    case 1: addPixelPairs<1>(cs, w, w2, d); break;
+    case 2: addPixelPairs<2>(cs, w, w2, d); break;
+    case 3: addPixelPairs<3>(cs, w, w2, d); break;
+    default: addPixelPairs<4>(cs, w, w2, d); break;
+    }
+  }
+}
+
+}  // end of namespace
@@ -56,11 +56,17 @@ TorusGeom::TorusGeom(double amajor, double aminor, int segsu, int segsv)
  : major(amajor,0), minor(aminor,0),
   segmentsu(segsu,0), segmentsv(segsv,0),
   cog(vec3d(0,0,0), Slot<vec3d>::NO_INPUT_CONNECTIONS),
-  inertiatensor()
+  inertiatensor(),
+  _on_param_event(), tesscache()
 {
   inertiatensor.setProcedure(this, &TorusGeom::computeInertiaTensor);
   major.addDependent(&inertiatensor);
   minor.addDependent(&inertiatensor);
+  _on_param_event.init(this, &TorusGeom::onParamChanged);
+  major.addDependent(&_on_param_event);
+  minor.addDependent(&_on_param_event);
+  segmentsu.addDependent(&_on_param_event);
+  segmentsv.addDependent(&_on_param_event);
   addSlot("major", major);
   addSlot("minor", minor);
   addSlot("cog", cog);
@@ -73,6 +79,10 @@ TorusGeom::~TorusGeom()
 {
   major.removeDependent(&inertiatensor);
   minor.removeDependent(&inertiatensor);
+  major.removeDependent(&_on_param_event);
+  minor.removeDependent(&_on_param_event);
+  segmentsu.removeDependent(&_on_param_event);
+  segmentsv.removeDependent(&_on_param_event);
 }
 
 BoundingBox TorusGeom::boundingBox()
@@ -85,15 +95,29 @@ BoundingBox TorusGeom::boundingBox()
 
 void TorusGeom::drawGL()
 {
-  SORTriangulator sor;
-  SORTriangulator::SORVertexList vlist;
-  int segsu = segmentsu.getValue();
+  if (!tesscache.isValid())
+  {
+    SORTriangulator sor;
+    SORTriangulator::SORVertexList vlist;
+    int segsu = segmentsu.getValue();
 
-  if (segsu<3)
-    segsu=3;
+    if (segsu<3)
+      segsu=3;
 
-  createSilhouette(vlist);
-  sor.drawGL(0.0, 360.0, segsu, vlist);
+    createSilhouette(vlist);
+    sor.tessellate(0.0, 360.0, segsu, vlist, tesscache);
+  }
+  tesscache.drawGL();
+}
+
+/**
+  Invalidate the tessellation cache.
+
+  This is called whenever one of the parameter slots has changed.
+ */
+void TorusGeom::onParamChanged()
+{
+  tesscache.invalidate();
 }
 
 // slotSizeConstraint
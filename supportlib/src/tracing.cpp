@@ -0,0 +1,332 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#define DLL_EXPORT_TRACING
+#include "tracing.h"
+#include "slotprofiler.h"
+#include "common_exceptions.h"
+#include <vector>
+#include <set>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+
+#ifdef WIN32
+  #include <windows.h>
+#else
+  #include <pthread.h>
+#endif
+
+namespace support3d {
+
+bool Tracer::enabled = false;
+
+/// The event buffer of one thread
+struct TraceBuffer
+{
+  /// Ring buffer
+  std::vector<TraceEvent> events;
+  /// Index of the next event to write
+  int next;
+  /// True if the buffer has been filled completely at least once
+  bool wrapped;
+  /// Thread id that is used in the exported trace
+  int tid;
+};
+
+/// The buffers of all threads that have recorded events
+static std::vector<TraceBuffer*> buffers;
+/// The buffer of the current thread
+static CGKIT_THREAD_LOCAL TraceBuffer* threadbuffer = 0;
+/// Number of events per buffer
+static int buffersize = 65536;
+/// The time (as returned by SlotProfiler::now()) when the trace was started
+static double starttime = 0.0;
+/// Strings that were passed in from outside (e.g. from Python)
+static std::set<std::string> internedstrings;
+
+// Lock that protects the buffer list and the interned strings
+#ifdef WIN32
+class TraceLock
+{
+  public:
+  CRITICAL_SECTION cs;
+  TraceLock() { InitializeCriticalSection(&cs); }
+  ~TraceLock() { DeleteCriticalSection(&cs); }
+  void acquire() { EnterCriticalSection(&cs); }
+  void release() { LeaveCriticalSection(&cs); }
+};
+#else
+class TraceLock
+{
+  public:
+  pthread_mutex_t mutex;
+  TraceLock() { pthread_mutex_init(&mutex, 0); }
+  ~TraceLock() { pthread_mutex_destroy(&mutex); }
+  void acquire() { pthread_mutex_lock(&mutex); }
+  void release() { pthread_mutex_unlock(&mutex); }
+};
+#endif
+
+static TraceLock tracelock;
+
+/**
+  Return true if the tracer was compiled into the library.
+
+  If this returns false, the tracer can still be enabled but it
+  won't record any events from the library.
+ */
+bool Tracer::isAvailable()
+{
+#ifdef CGKIT_TRACING
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+  Enable or disable the tracer.
+
+  The time stamps are relative to the time when the tracer was enabled
+  for the first time after the last clear().
+ */
+void Tracer::setEnabled(bool flag)
+{
+  if (flag && starttime==0.0)
+    starttime = SlotProfiler::now();
+  enabled = flag;
+}
+
+/**
+  Return the number of events that can be stored per thread.
+ */
+int Tracer::getBufferSize()
+{
+  return buffersize;
+}
+
+/**
+  Set the number of events that can be stored per thread.
+
+  This also removes all recorded events.
+ */
+void Tracer::setBufferSize(int numevents)
+{
+  if (numevents<1)
+    throw EValueError("The buffer size must be at least 1.");
+  tracelock.acquire();
+  buffersize = numevents;
+  for(unsigned int i=0; i<buffers.size(); i++)
+  {
+    buffers[i]->events.resize(numevents);
+  }
+  tracelock.release();
+  clear();
+}
+
+/**
+  Remove all recorded events.
+ */
+void Tracer::clear()
+{
+  tracelock.acquire();
+  for(unsigned int i=0; i<buffers.size(); i++)
+  {
+    buffers[i]->next = 0;
+    buffers[i]->wrapped = false;
+  }
+  starttime = enabled? SlotProfiler::now() : 0.0;
+  tracelock.release();
+}
+
+/**
+  Return the number of events that are currently stored.
+ */
+int Tracer::numEvents()
+{
+  int res = 0;
+  tracelock.acquire();
+  for(unsigned int i=0; i<buffers.size(); i++)
+  {
+    res += buffers[i]->wrapped? int(buffers[i]->events.size()) : buffers[i]->next;
+  }
+  tracelock.release();
+  return res;
+}
+
+/**
+  Record an event.
+
+  Usually this method is called via one of the TRACE_* macros.
+  category and name must remain valid until the trace has been
+  exported (see internString()).
+ */
+void Tracer::record(char type, const char* category, const char* name, const void* object, long arg)
+{
+  TraceBuffer* buf = threadbuffer;
+  // Is this the first event of this thread? Then create the buffer
+  if (buf==0)
+  {
+    buf = new TraceBuffer();
+    buf->next = 0;
+    buf->wrapped = false;
+    tracelock.acquire();
+    buf->events.resize(buffersize);
+    buf->tid = int(buffers.size())+1;
+    buffers.push_back(buf);
+    tracelock.release();
+    threadbuffer = buf;
+  }
+
+  TraceEvent& e = buf->events[buf->next];
+  e.timestamp = SlotProfiler::now() - starttime;
+  e.category = category;
+  e.name = name;
+  e.object = object;
+  e.arg = arg;
+  e.type = type;
+
+  buf->next++;
+  if (buf->next==int(buf->events.size()))
+  {
+    buf->next = 0;
+    buf->wrapped = true;
+  }
+}
+
+/**
+  Return a copy of a string that remains valid during the lifetime of the library.
+
+  Identical strings are only stored once. This can be used to pass
+  names to record() that are not static strings.
+ */
+const char* Tracer::internString(const std::string& s)
+{
+  tracelock.acquire();
+  const char* res = internedstrings.insert(s).first->c_str();
+  tracelock.release();
+  return res;
+}
+
+// Write a string as JSON string
+static void writeJSONString(std::ostream& os, const char* s)
+{
+  os<<'"';
+  for(; *s!=0; s++)
+  {
+    unsigned char c = *s;
+    if (c=='"' || c=='\\')
+      os<<'\\'<<c;
+    else if (c<0x20)
+    {
+      char buf[8];
+      sprintf(buf, "\\u%04x", c);
+      os<<buf;
+    }
+    else
+      os<<c;
+  }
+  os<<'"';
+}
+
+/**
+  Return the recorded events in the Chrome trace event format (JSON).
+
+  The result can be loaded into the Chrome trace viewer
+  (chrome://tracing) or into Perfetto.
+ */
+std::string Tracer::chromeTrace()
+{
+  std::ostringstream os;
+  char buf[100];
+
+  tracelock.acquire();
+  os<<"{\"traceEvents\":[";
+  bool first = true;
+  for(unsigned int i=0; i<buffers.size(); i++)
+  {
+    TraceBuffer* tb = buffers[i];
+    // Thread name
+    if (!first)
+      os<<",";
+    first = false;
+    os<<"\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"<<tb->tid<<",\"args\":{\"name\":\"thread "<<tb->tid<<"\"}}";
+
+    int n = int(tb->events.size());
+    int count = tb->wrapped? n : tb->next;
+    int start = tb->wrapped? tb->next : 0;
+    for(int j=0; j<count; j++)
+    {
+      const TraceEvent& e = tb->events[(start+j)%n];
+      os<<",\n{\"name\":";
+      writeJSONString(os, e.name);
+      os<<",\"cat\":";
+      writeJSONString(os, e.category);
+      sprintf(buf, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d", e.type, 1E6*e.timestamp, tb->tid);
+      os<<buf;
+      if (e.type=='C')
+      {
+        os<<",\"args\":{\"value\":"<<e.arg<<"}";
+      }
+      else if (e.type!='E')
+      {
+        if (e.type=='i')
+          os<<",\"s\":\"t\"";
+        sprintf(buf, ",\"args\":{\"object\":\"0x%lx\",\"arg\":%ld}", (unsigned long)(e.object), e.arg);
+        os<<buf;
+      }
+      os<<"}";
+    }
+  }
+  tracelock.release();
+  os<<"\n],\"displayTimeUnit\":\"ms\"}\n";
+  return os.str();
+}
+
+/**
+  Write the recorded events into a file in the Chrome trace event format.
+
+  \param filename Output file name
+ */
+void Tracer::saveChromeTrace(const std::string& filename)
+{
+  std::ofstream f(filename.c_str());
+  if (!f)
+    throw EIOError("Could not open file \""+filename+"\".");
+  f<<chromeTrace();
+}
+
+}  // end of namespace
@@ -33,6 +33,7 @@
  *
  * ***** END LICENSE BLOCK ***** */
 
+#include <math.h>
 #include "trimeshgeom.h"
 #include "massproperties.h"
 #include "primvaraccess.h"
@@ -47,7 +48,10 @@ TriMeshGeom::TriMeshGeom()
   cog(), inertiatensor(),
   _cog(), _inertiatensor(), _volume(),
   bb_cache(),
-  mass_props_valid(false), bb_cache_valid(true)
+  mass_props_valid(false), bb_cache_valid(true),
+  normalgen(), generated_normals(0), normals_creaseangle(-1.0),
+  normals_topology_dirty(true), normals_dirty_begin(0), normals_dirty_end(0),
+  topology_cache(), topology_valid(false)
 
 {
   _on_verts_event.init(this, &TriMeshGeom::onVertsChanged, &TriMeshGeom::onVertsResize);
@@ -104,12 +108,16 @@ BoundingBox TriMeshGeom::boundingBox()
   and "Cs" the colors.
   All type variations are supported: constant, uniform, varying, facevarying
   and user + ...faces slot.
+  If the normals were created by computeNormals() they are updated first
+  (if necessary).
 
   \pre The vertex indices in the face list mustn't be out of range!
   \todo Range checking (Cs, N, Nfaces, ...)
  */
 void TriMeshGeom::drawGL()
 {
+  updateNormals();
+
   PrimVarAccess<vec3d> normals(*this, std::string("N"), NORMAL, 1, std::string("Nfaces"), true);
   PrimVarAccess<double> texcoords(*this, std::string("st"), FLOAT, 2, std::string("stfaces"), true);
   PrimVarAccess<vec3d> colors(*this, std::string("Cs"), COLOR, 1, std::string("Csfaces"), true);
@@ -125,6 +133,7 @@ void TriMeshGeom::drawGL()
   vec3d* b;
   vec3d* c;
   vec3d Ng;
+  double len;
   GLfloat glcol[4] = {0,0,0,1};
 
 
@@ -147,16 +156,12 @@ void TriMeshGeom::drawGL()
     // No normals? Then a face normal has to be calculated...
     if (normals.mode==0)
     {
-      try
-      {
-	Ng.cross((*b)-(*a), (*c)-(*a));
-	Ng.normalize(Ng);
-      }
-      catch(...)
-      {
-	Ng.set(0,0,0);
-      };
-      glNormal3d(Ng.x, Ng.y, Ng.z);
+      // (degenerate triangles get a zero normal)
+      Ng.cross((*b)-(*a), (*c)-(*a));
+      len = Ng.length();
+      if (len>0.0)
+        len = 1.0/len;
+      glNormal3d(len*Ng.x, len*Ng.y, len*Ng.z);
     }
 
     // Normals per face?
@@ -264,8 +269,6 @@ void TriMeshGeom::calcMassProperties()
   int numfaces = faces.size();
   vec3d* v;
 
-  std::cout<<"computing mass properties"<<std::endl;
-
   mp.setMass(1.0);
 
   mp.meshBegin();
@@ -302,6 +305,151 @@ void TriMeshGeom::calcMassProperties()
   mass_props_valid = true;
 }
 
+/**
+  Compute smooth normals and store them in the primitive variable "N".
+
+  If \a creaseangle is negative (or greater or equal than pi) a normal
+  is computed for each vertex and stored as a \em varying variable.
+  Otherwise, one normal is computed for each face corner and stored as
+  a \em facevarying variable. In this case the normal of a corner only
+  averages the faces around the corner vertex whose normals deviate less
+  than \a creaseangle from the normal of the face the corner belongs to,
+  so edges with a larger angle remain sharp.
+
+  An existing "N" variable is replaced if it has a different storage
+  class (or if it's connected to another slot), otherwise the values are
+  overwritten.
+
+  The generated normals are kept up to date: When vertices are
+  modified afterwards, updateNormals() (which is also called by drawGL())
+  only recomputes the normals that are influenced by the modified
+  vertices. This stops as soon as the "N" variable is deleted or
+  replaced.
+
+  \param creaseangle Crease angle in radians (negative: no creases)
+  \param angleweighted If true, the face normals are weighted by the angle at the vertex, otherwise by the face area.
+  \see updateNormals(), NormalGenerator
+ */
+void TriMeshGeom::computeNormals(double creaseangle, bool angleweighted)
+{
+  bool creased = (creaseangle>=0.0 && creaseangle<M_PI);
+  VarStorage storage = creased? FACEVARYING : VARYING;
+  PrimVarInfo* info;
+
+  generated_normals = 0;
+  normalgen.weighting = angleweighted? NormalGenerator::ANGLE_WEIGHTED : NormalGenerator::AREA_WEIGHTED;
+
+  // Check if an existing "N" variable can be reused...
+  info = findVariable("N");
+  if (info!=0)
+  {
+    if (info->storage!=storage || info->type!=NORMAL || info->multiplicity!=1 || info->slot->getController()!=0)
+    {
+      deleteVariable("N");
+      info = 0;
+    }
+  }
+  if (info==0)
+  {
+    newVariable("N", storage, NORMAL, 1);
+    info = findVariable("N");
+  }
+
+  ArraySlot<vec3d>* N = dynamic_cast<ArraySlot<vec3d>*>(info->slot);
+  normalgen.setTopology(faces.dataPtr(), faces.size(), verts.size());
+  if (creased)
+    normalgen.cornerNormals(verts.dataPtr(), creaseangle, N->dataPtr());
+  else
+    normalgen.vertexNormals(verts.dataPtr(), N->dataPtr());
+  N->notifyDependents();
+
+  generated_normals = info->slot;
+  normals_creaseangle = creased? creaseangle : -1.0;
+  normals_topology_dirty = false;
+  normals_dirty_begin = 0;
+  normals_dirty_end = 0;
+}
+
+/**
+  Update the normals that were created by computeNormals().
+
+  If only vertices have been modified since the last update, only the
+  normals that depend on those vertices are recomputed. If the faces
+  have been modified, all normals are recomputed.
+
+  \return True if the "N" variable contains generated normals (which are up to date now).
+  \see computeNormals()
+ */
+bool TriMeshGeom::updateNormals()
+{
+  if (generated_normals==0)
+    return false;
+
+  // Was the variable deleted or replaced in the meantime?
+  PrimVarInfo* info = findVariable("N");
+  if (info==0 || info->slot!=generated_normals)
+  {
+    generated_normals = 0;
+    return false;
+  }
+
+  // Did the topology change? Then everything has to be recomputed
+  if (normals_topology_dirty)
+  {
+    computeNormals(normals_creaseangle, normalgen.weighting==NormalGenerator::ANGLE_WEIGHTED);
+    return true;
+  }
+
+  // Nothing has changed?
+  if (normals_dirty_begin>=normals_dirty_end)
+    return true;
+
+  ArraySlot<vec3d>* N = dynamic_cast<ArraySlot<vec3d>*>(info->slot);
+  if (normals_creaseangle>=0.0)
+    normalgen.updateCornerNormals(verts.dataPtr(), normals_dirty_begin, normals_dirty_end, normals_creaseangle, N->dataPtr());
+  else
+    normalgen.updateVertexNormals(verts.dataPtr(), normals_dirty_begin, normals_dirty_end, N->dataPtr());
+  N->notifyDependents();
+
+  normals_dirty_begin = 0;
+  normals_dirty_end = 0;
+  return true;
+}
+
+/**
+  Return the half-edge connectivity of the mesh.
+
+  The topology is built on first use and cached. It is rebuilt
+  automatically when the faces or the number of vertices have been
+  modified (modifying the vertex positions doesn't invalidate the
+  topology). The returned reference stays valid as long as the mesh
+  exists, but its contents only reflect the faces at the time of the
+  last call.
+
+  \return Half-edge connectivity (half-edge 3*f+k is corner k of face f)
+ */
+const MeshTopology& TriMeshGeom::getTopology()
+{
+  if (!topology_valid)
+  {
+    topology_cache.buildTriangles(faces.dataPtr(), faces.size(), verts.size());
+    topology_valid = true;
+  }
+  return topology_cache;
+}
+
+/**
+  Delete a primitive variable.
+
+  Deleting the "N" variable stops the automatic normal updates.
+ */
+void TriMeshGeom::deleteVariable(string name)
+{
+  if (name=="N")
+    generated_normals = 0;
+  GeomObject::deleteVariable(name);
+}
+
 /**
   Interscet a ray with the mesh.
 
@@ -404,22 +552,41 @@ void TriMeshGeom::onVertsChanged(int start, int end)
 {
   bb_cache_valid = false;
   mass_props_valid = false;
+  // Extend the range of vertices whose normals have to be updated
+  if (normals_dirty_begin>=normals_dirty_end)
+  {
+    normals_dirty_begin = start;
+    normals_dirty_end = end;
+  }
+  else
+  {
+    if (start<normals_dirty_begin)
+      normals_dirty_begin = start;
+    if (end>normals_dirty_end)
+      normals_dirty_end = end;
+  }
 }
 
 void TriMeshGeom::onVertsResize(int size)
 {
   bb_cache_valid = false;
   mass_props_valid = false;
+  normals_topology_dirty = true;
+  topology_valid = false;
 }
 
 void TriMeshGeom::onFacesChanged(int start, int end)
 {
   mass_props_valid = false;
+  normals_topology_dirty = true;
+  topology_valid = false;
 }
 
 void TriMeshGeom::onFacesResize(int size)
 {
   mass_props_valid = false;
+  normals_topology_dirty = true;
+  topology_valid = false;
 }
 
 void TriMeshGeom::computeCog(vec3d& cog)
@@ -0,0 +1,365 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#include <math.h>
+#include <algorithm>
+#include "vertexcacheoptimizer.h"
+#include "common_exceptions.h"
+
+namespace support3d {
+
+// Scoring constants (see Forsyth's article)
+static const double CACHE_DECAY_POWER = 1.5;
+static const double LAST_FACE_SCORE = 0.75;
+static const double VALENCE_BOOST_SCALE = 2.0;
+static const double VALENCE_BOOST_POWER = 0.5;
+// Size of the valence score table
+static const int MAX_TABLE_VALENCE = 64;
+
+// A face and its score (used for the heap of the fallback search)
+typedef std::pair<double, int> FaceScore;
+
+// Heap order: the face with the highest score (and the lowest index
+// among faces with the same score) is at the top
+struct FaceScoreLess
+{
+  bool operator()(const FaceScore& a, const FaceScore& b) const
+  {
+    if (a.first!=b.first)
+      return a.first<b.first;
+    return a.second>b.second;
+  }
+};
+
+/**
+  Constructor.
+
+  \param acachesize Size of the simulated vertex cache (at least 4)
+ */
+VertexCacheOptimizer::VertexCacheOptimizer(int acachesize)
+  : cachesize(acachesize), cachescores(), valencescores()
+{
+}
+
+/**
+  Precompute the score tables (pow() is too expensive to be called for every update).
+ */
+void VertexCacheOptimizer::initScores()
+{
+  int i;
+  cachescores.resize(cachesize);
+  for(i=0; i<cachesize; i++)
+  {
+    // The vertices of the last face get a fixed score so that
+    // it doesn't matter in which order they were added
+    if (i<3)
+      cachescores[i] = LAST_FACE_SCORE;
+    else
+      cachescores[i] = pow(1.0 - double(i-3)/double(cachesize-3), CACHE_DECAY_POWER);
+  }
+  valencescores.resize(MAX_TABLE_VALENCE);
+  valencescores[0] = 0.0;
+  for(i=1; i<MAX_TABLE_VALENCE; i++)
+    valencescores[i] = VALENCE_BOOST_SCALE*pow(double(i), -VALENCE_BOOST_POWER);
+}
+
+/**
+  Return the score of a vertex.
+
+  \param cachepos Position in the cache (-1 if the vertex isn't in the cache)
+  \param remaining Number of faces that still use the vertex
+ */
+double VertexCacheOptimizer::vertexScore(int cachepos, int remaining) const
+{
+  if (remaining==0)
+    return -1.0;
+
+  double score = (cachepos>=0)? cachescores[cachepos] : 0.0;
+  // Prefer vertices that are only used by a few faces
+  if (remaining<MAX_TABLE_VALENCE)
+    score += valencescores[remaining];
+  else
+    score += VALENCE_BOOST_SCALE*pow(double(remaining), -VALENCE_BOOST_POWER);
+  return score;
+}
+
+/**
+  Return the score of a face whose vertices are not in the cache.
+
+  \param face The 3 vertex indices of the face
+  \param remaining Number of remaining faces per vertex
+ */
+double VertexCacheOptimizer::outsideScore(const int* face, const std::vector<int>& remaining) const
+{
+  return vertexScore(-1, remaining[face[0]]) + vertexScore(-1, remaining[face[1]]) + vertexScore(-1, remaining[face[2]]);
+}
+
+/**
+  Compute a new face order.
+
+  \param faces Face vertex indices (3 per face)
+  \param numfaces Number of faces
+  \param numverts Number of vertices
+  \param[out] order Receives the new face order (order[i] is the index of the original face that comes at position i)
+ */
+void VertexCacheOptimizer::optimize(const int* faces, int numfaces, int numverts, std::vector<int>& order)
+{
+  int i, j, k;
+
+  if (cachesize<4)
+    throw EValueError("The cache size must be at least 4.");
+
+  order.clear();
+  order.reserve(numfaces);
+  if (numfaces==0)
+    return;
+  initScores();
+
+  // Number of remaining faces per vertex and the vertex/face table (CSR)
+  std::vector<int> remaining(numverts, 0);
+  for(i=0; i<3*numfaces; i++)
+  {
+    if (faces[i]<0 || faces[i]>=numverts)
+      throw EIndexError("Vertex index out of range.");
+    remaining[faces[i]]++;
+  }
+  std::vector<int> offsets(numverts+1, 0);
+  for(i=0; i<numverts; i++)
+    offsets[i+1] = offsets[i]+remaining[i];
+  std::vector<int> vertfaces(3*numfaces);
+  std::vector<int> fill(offsets.begin(), offsets.end()-1);
+  for(i=0; i<3*numfaces; i++)
+    vertfaces[fill[faces[i]]++] = i/3;
+
+  std::vector<int> cachepos(numverts, -1);
+  std::vector<double> vertscore(numverts);
+  std::vector<double> facescore(numfaces, 0.0);
+  std::vector<bool> added(numfaces, false);
+  for(i=0; i<numverts; i++)
+    vertscore[i] = vertexScore(-1, remaining[i]);
+
+  // Initial face scores and the first face
+  int bestface = 0;
+  for(i=0; i<numfaces; i++)
+  {
+    facescore[i] = vertscore[faces[3*i]] + vertscore[faces[3*i+1]] + vertscore[faces[3*i+2]];
+    if (facescore[i]>facescore[bestface])
+      bestface = i;
+  }
+
+  // Heap with the scores of the faces outside the cache. When the cache
+  // doesn't contain any useful faces anymore, the remaining faces don't
+  // have any vertex in the cache, so their score only depends on the
+  // number of remaining faces of their vertices. This score only changes
+  // for the faces around the vertices of an added face. These vertices
+  // are collected and their faces are only pushed onto the heap when the
+  // heap is actually needed (the heap itself is also only created when
+  // it is needed for the first time). Outdated entries are skipped when
+  // popping.
+  std::vector<FaceScore> heap;
+  bool heapvalid = false;
+  std::vector<int> changed;
+  std::vector<bool> ischanged(numverts, false);
+
+  std::vector<int> cache;
+  std::vector<int> newcache;
+  cache.reserve(cachesize+3);
+  newcache.reserve(cachesize+3);
+
+  for(k=0; k<numfaces; k++)
+  {
+    // No face found in the cache? Then take the best remaining face
+    if (bestface==-1)
+    {
+      // Update the heap (it is rebuilt from the remaining faces when it
+      // contains too many outdated entries)
+      if (!heapvalid || int(heap.size())>2*numfaces)
+      {
+        heap.clear();
+        for(i=0; i<numfaces; i++)
+        {
+          if (!added[i])
+            heap.push_back(FaceScore(outsideScore(faces+3*i, remaining), i));
+        }
+        std::make_heap(heap.begin(), heap.end(), FaceScoreLess());
+        heapvalid = true;
+      }
+      else
+      {
+        for(i=0; i<int(changed.size()); i++)
+        {
+          int v = changed[i];
+          for(j=offsets[v]; j<offsets[v]+remaining[v]; j++)
+          {
+            int face = vertfaces[j];
+            heap.push_back(FaceScore(outsideScore(faces+3*face, remaining), face));
+            std::push_heap(heap.begin(), heap.end(), FaceScoreLess());
+          }
+        }
+      }
+      for(i=0; i<int(changed.size()); i++)
+        ischanged[changed[i]] = false;
+      changed.clear();
+    }
+    while(bestface==-1)
+    {
+      FaceScore top = heap.front();
+      std::pop_heap(heap.begin(), heap.end(), FaceScoreLess());
+      heap.pop_back();
+      if (!added[top.second] && top.first==outsideScore(faces+3*top.second, remaining))
+        bestface = top.second;
+    }
+
+    const int* f = faces+3*bestface;
+    order.push_back(bestface);
+    added[bestface] = true;
+
+    // Remove the face from the active face lists of its vertices
+    // (the active faces are at the beginning of the list)
+    for(j=0; j<3; j++)
+    {
+      int v = f[j];
+      int begin = offsets[v];
+      int end = begin+remaining[v];
+      for(i=begin; i<end; i++)
+      {
+        if (vertfaces[i]==bestface)
+        {
+          std::swap(vertfaces[i], vertfaces[end-1]);
+          remaining[v]--;
+          break;
+        }
+      }
+    }
+
+    // Remember the vertices whose faces have outdated heap entries now
+    for(j=0; j<3; j++)
+    {
+      if (!ischanged[f[j]])
+      {
+        ischanged[f[j]] = true;
+        changed.push_back(f[j]);
+      }
+    }
+
+    // Update the cache (the vertices of the new face move to the front)
+    newcache.clear();
+    for(j=0; j<3; j++)
+    {
+      if (std::find(newcache.begin(), newcache.end(), f[j])==newcache.end())
+        newcache.push_back(f[j]);
+    }
+    for(i=0; i<int(cache.size()); i++)
+    {
+      if (cache[i]!=f[0] && cache[i]!=f[1] && cache[i]!=f[2])
+        newcache.push_back(cache[i]);
+    }
+
+    // Update the vertex scores and the scores of the faces around them
+    bestface = -1;
+    double bestscore = -1E30;
+    for(i=0; i<int(newcache.size()); i++)
+    {
+      int v = newcache[i];
+      cachepos[v] = (i<cachesize)? i : -1;
+      vertscore[v] = vertexScore(cachepos[v], remaining[v]);
+    }
+    for(i=0; i<int(newcache.size()); i++)
+    {
+      int v = newcache[i];
+      for(j=offsets[v]; j<offsets[v]+remaining[v]; j++)
+      {
+        int face = vertfaces[j];
+        const int* g = faces+3*face;
+        double score = vertscore[g[0]] + vertscore[g[1]] + vertscore[g[2]];
+        facescore[face] = score;
+        if (i<cachesize && score>bestscore)
+        {
+          bestscore = score;
+          bestface = face;
+        }
+      }
+    }
+
+    if (int(newcache.size())>cachesize)
+      newcache.resize(cachesize);
+    cache.swap(newcache);
+  }
+}
+
+/**
+  Compute the average cache miss ratio of a face order.
+
+  This simulates a FIFO vertex cache and returns the number of
+  cache misses per face (the optimum is around 0.5 for large regular
+  meshes, the worst value is 3).
+
+  \param faces Face vertex indices (3 per face)
+  \param numfaces Number of faces
+  \param cachesize Size of the simulated FIFO cache
+  \return Average number of cache misses per face
+ */
+double VertexCacheOptimizer::missRatio(const int* faces, int numfaces, int cachesize)
+{
+  if (numfaces==0)
+    return 0.0;
+
+  int maxindex = 0;
+  int i;
+  for(i=0; i<3*numfaces; i++)
+  {
+    if (faces[i]>maxindex)
+      maxindex = faces[i];
+  }
+
+  // A vertex is in the cache if it was inserted less than 'cachesize'
+  // misses ago
+  std::vector<int> inserted(maxindex+1, -cachesize-1);
+  int misses = 0;
+  for(i=0; i<3*numfaces; i++)
+  {
+    int v = faces[i];
+    if (v<0)
+      continue;
+    if (misses-inserted[v]>cachesize)
+    {
+      inserted[v] = misses;
+      misses++;
+    }
+  }
+  return double(misses)/numfaces;
+}
+
+}  // end of namespace
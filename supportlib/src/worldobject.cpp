@@ -35,8 +35,10 @@
 
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sstream>
 #include "worldobject.h"
+#include "memorypool.h"
 #include "debuginfo.h"
 
 namespace support3d {
@@ -243,7 +245,8 @@ void ScaleSlot::onDependentValueChanged()
 ///////////////////////////////////////////////////////////////////////
 
 TransformSlot::TransformSlot(PositionSlot* apos, RotationSlot* arot, ScaleSlot* ascale)
- : Slot<mat4d>(), pos(apos), rot(arot), scale(ascale)
+ : Slot<mat4d>(), pos(apos), rot(arot), scale(ascale),
+   decomp_source(), decomp_rot(), decomp_scale(), decomp_valid(false)
 {
   setFlags(CACHE_VALID, false);
   pos->setDependencyController(this);
@@ -281,11 +284,15 @@ void TransformSlot::disconnectSlots()
 
 const mat4d& TransformSlot::getValue()
 {
+  SLOTPROF_GETVALUE(flags & CACHE_VALID);
+
   // Is the value in the cache still valid?
   if (flags & CACHE_VALID)
     return value; 
 
   // Obtain a new value and store it in the cache
+  SLOTPROF_EVALUATE();
+  TRACE_SCOPE("slot", "TransformSlot::evaluate", this);
   if (controller!=0)
   {
     value = controller->getValue();
@@ -299,6 +306,8 @@ const mat4d& TransformSlot::getValue()
 
 void TransformSlot::setValue(const mat4d& val)
 {
+  SLOTPROF_SETVALUE();
+
   // Check if the new value is really a *new* value
   if ((flags & CACHE_VALID) && value==val)
     return;
@@ -342,10 +351,8 @@ void TransformSlot::onValueChanged()
 void TransformSlot::getTransform()
 {
   DEBUGINFO(this, "TransformSlot::getTransform()");
-  vec3d t;
   vec3d s;
   mat3d r;
-  mat4d r4;
   int tests = 0;
 
   if (rot==0) return;
@@ -376,30 +383,32 @@ void TransformSlot::getTransform()
     case 1: { 
               try
               {
-                value.decompose(t,r4,s);
-                r4.getMat3(r);
+                decompose(value, r, s);
               }
               catch(...)
               {
               };
-              r = rot->getValue();
+              const mat3d& newrot = rot->getValue();
+              r = newrot;
               r.scale(s);
               value.setMat3(r);
+              cacheDecomposition(newrot, s);
 	      break;
             }
     // Only scale has a valid value
     case 2: { 
               try
               {
-                value.decompose(t,r4,s);
-                r4.getMat3(r);
+                decompose(value, r, s);
               }
               catch(...)
               {
               };
+              mat3d oldrot = r;
               s = scale->getValue();
               r.scale(s);
               value.setMat3(r);
+              cacheDecomposition(oldrot, s);
 	      break;
             }
     // Both have valid values
@@ -468,11 +477,8 @@ void TransformSlot::getRot()
   */
 
   const mat4d& m = getValue();
-  vec3d t;
-  mat4d r4;
   vec3d s;
-  m.decompose(t, r4, s);
-  r4.getMat3(rot->value);
+  decompose(m, rot->value, s);
 }
 
 /**
@@ -484,7 +490,6 @@ void TransformSlot::getRot()
   This method stores the updated value in the scale cache (but doesn't
   set the CACHE_VALID flag).
 
-  \todo Ergebnis von decompose() aus rot/scale zwischenspeichern, so dass nicht 2x zerlegt werden muss.
   \todo Statt CACHE_VALID und controller selbst zu testen eine entsprechende Methode aufrufen 
         (damit knnte flags und controller wieder protected werden)
  */
@@ -505,10 +510,69 @@ void TransformSlot::getScale()
   */
 
   const mat4d& m = getValue();
-  vec3d t;
-  mat4d r4;
-  m.decompose(t, r4, scale->value);
+  mat3d r;
+  decompose(m, r, scale->value);
+}
+
+/**
+  Decompose a transform into its rotation and scaling part.
+
+  The result of the last decomposition is cached, so reading both the
+  \a rot and \a scale slot after a transform change only decomposes
+  the matrix once. If the matrix cannot be decomposed, an
+  EZeroDivisionError exception is thrown and \a r and \a s remain
+  unchanged.
+
+  \param m The matrix to decompose
+  \param r Receives the rotation part
+  \param s Receives the scaling part
+ */
+void TransformSlot::decompose(const mat4d& m, mat3d& r, vec3d& s)
+{
+  // The cache is only used if the matrix is bitwise identical
+  if (!decomp_valid || memcmp(&m, &decomp_source, sizeof(mat4d))!=0)
+  {
+    vec3d t;
+    mat4d r4;
+    decomp_valid = false;
+    m.decompose(t, r4, decomp_scale);
+    r4.getMat3(decomp_rot);
+    decomp_source = m;
+    decomp_valid = true;
+  }
+  r = decomp_rot;
+  s = decomp_scale;
+}
+
+/**
+  Store the decomposition of a transform that was just composed.
+
+  If \a r is a rotation matrix and \a s is a scaling that decompose()
+  would return unchanged, then (r, s) is the decomposition of the current
+  transform value and is stored in the cache. This way, animating the
+  rotation or scaling alone doesn't decompose the transform every frame.
 
+  \param r The rotation part that was used to compose the transform
+  \param s The scaling part that was used to compose the transform
+ */
+void TransformSlot::cacheDecomposition(const mat3d& r, const vec3d& s)
+{
+  double eps = vec3d::epsilon;
+  if (fabs(s.x)<=eps || s.y<=eps || s.z<=eps)
+    return;
+
+  vec3d a, b, c;
+  r.getColumn(0, a);
+  r.getColumn(1, b);
+  r.getColumn(2, c);
+  if (!orthogonalVectors(a, b, c) || fabs(a*a-1.0)>eps || fabs(b*b-1.0)>eps ||
+      fabs(c*c-1.0)>eps || a*(b^c)<0)
+    return;
+
+  decomp_source = value;
+  decomp_rot = r;
+  decomp_scale = s;
+  decomp_valid = true;
 }
 
 /**
@@ -603,7 +667,10 @@ WorldObject::WorldObject(string aname)
     linearvel(), angularvel(),
     parent(0), childs(), geom(), materials(), 
     _localTransform(1),
-    _offsetTransform(1), _inverseOffsetTransform(1)
+    _offsetTransform(1), _inverseOffsetTransform(1),
+    structure_serial(++structure_counter),
+    geom_cog("cog"), geom_inertiatensor("inertiatensor"),
+    dynamics_slot("dynamics")
 {
   DEBUGINFO1(this, "WorldObject::WorldObject(\"%s\")", aname.c_str());
 
@@ -650,9 +717,18 @@ WorldObject::~WorldObject()
   }
 
   // Remove children objects (which will reset their parent attribute)...
-  while(childs.size()>0)
+  // (the last children is removed first which is cheaper for the slot
+  // dependencies)
+  std::vector<boost::shared_ptr<WorldObject> > objs;
+  objs.reserve(childs.size());
+  for(ChildIterator it=childsBegin(); it!=childsEnd(); it++)
+  {
+    objs.push_back(it->second);
+  }
+  while(!objs.empty())
   {
-    removeChild(childsBegin()->second);
+    removeChild(objs.back());
+    objs.pop_back();
   }
 
   // Remove the geom object so that any established dependency is removed
@@ -666,6 +742,28 @@ WorldObject::~WorldObject()
   mass.removeDependent(&totalmass);
 }
 
+unsigned long WorldObject::structure_counter = 0;
+
+// Return the memory pools for the world objects (one pool per size, so
+// the derived classes are allocated from pools as well)
+// (the pools are never deleted as objects might still be deleted during
+// program shutdown)
+static SizeClassPools& worldObjectPools()
+{
+  static SizeClassPools* pools = new SizeClassPools(16384, 64);
+  return *pools;
+}
+
+void* WorldObject::operator new(size_t size)
+{
+  return worldObjectPools().allocate(size);
+}
+
+void WorldObject::operator delete(void* p, size_t size)
+{
+  worldObjectPools().deallocate(p, size);
+}
+
 void WorldObject::setName(string aname)
 {
   // Is the new name identical with the current name? Then do nothing.
@@ -823,6 +921,8 @@ void WorldObject::setGeom(boost::shared_ptr<GeomObject> ageom)
       itslot.addDependent(&inertiatensor);
     }
   }
+
+  touchStructure();
 }
 
 /**
@@ -844,7 +944,11 @@ void WorldObject::setNumMaterials(int num)
 {
   if (num<1)
     num=1;
-  materials.resize(num);
+  if (num!=int(materials.size()))
+  {
+    materials.resize(num);
+    touchStructure();
+  }
 }
 
 
@@ -883,6 +987,7 @@ void WorldObject::setMaterial(boost::shared_ptr<Material> amaterial, int idx)
     throw EIndexError();
 
   materials[idx] = amaterial;
+  touchStructure();
 }
 
 /**
@@ -893,7 +998,7 @@ void WorldObject::setMaterial(boost::shared_ptr<Material> amaterial, int idx)
  */
 bool WorldObject::hasChild(string name) const
 {
-  return childs.find(name)!=childs.end();
+  return childs.contains(name);
 }
 
 /**
@@ -905,14 +1010,14 @@ bool WorldObject::hasChild(string name) const
  */
 boost::shared_ptr<WorldObject> WorldObject::child(string name)
 {
-  ConstChildIterator it = childs.find(name);
-  if (it==childs.end())
+  const boost::shared_ptr<WorldObject>* c = childs.find(name);
+  if (c==0)
   {
     throw EKeyError("Object \""+getName()+"\" has no children \""+name+"\".");
   }
   else
   {
-    return it->second;
+    return *c;
   }
 }
 
@@ -934,11 +1039,11 @@ void WorldObject::addChild(boost::shared_ptr<WorldObject> child)
     throw EValueError("Object \""+child->getName()+"\" is already a children of object \""+child->parent->getName()+"\".");
   }
   // Is there already a children with the same name?
-  if (childs.find(child->getName())!=childs.end())
+  if (childs.contains(child->getName()))
   {
     throw EKeyError("Object \""+getName()+"\" already has a children called \""+child->getName()+"\".");
   }
-  childs[child->getName()] = child;
+  childs.insert(child->getName(), child);
   child->parent = this;
 
   // Create the worldtransform dependency
@@ -952,6 +1057,8 @@ void WorldObject::addChild(boost::shared_ptr<WorldObject> child)
   child->inertiatensor.addDependent(&inertiatensor);
   child->transform.addDependent(&cog);
   child->transform.addDependent(&inertiatensor);
+
+  touchStructure();
 }
 
 /**
@@ -963,8 +1070,7 @@ void WorldObject::addChild(boost::shared_ptr<WorldObject> child)
  */
 void WorldObject::removeChild(boost::shared_ptr<WorldObject> child)
 {
-  ChildIterator it = childs.find(child->getName());
-  if (it==childs.end())
+  if (!childs.contains(child->getName()))
   {
     throw EKeyError("Object \""+getName()+"\" has no children called \""+child->getName()+"\".");
   }
@@ -980,6 +1086,8 @@ void WorldObject::removeChild(boost::shared_ptr<WorldObject> child)
   child->inertiatensor.removeDependent(&inertiatensor);
   child->transform.removeDependent(&cog);
   child->transform.removeDependent(&inertiatensor);
+
+  touchStructure();
 }
 
 /**
@@ -991,12 +1099,12 @@ void WorldObject::removeChild(boost::shared_ptr<WorldObject> child)
  */
 void WorldObject::removeChild(string name)
 {
-  ChildIterator it = childs.find(name);
-  if (it==childs.end())
+  const boost::shared_ptr<WorldObject>* c = childs.find(name);
+  if (c==0)
   {
     throw EKeyError("Object \""+getName()+"\" has no children called \""+name+"\".");
   }
-  boost::shared_ptr<WorldObject> child = it->second;
+  boost::shared_ptr<WorldObject> child = *c;
   child->parent = 0;
   childs.erase(name);
   // Remove the worldtransform dependency
@@ -1009,6 +1117,26 @@ void WorldObject::removeChild(string name)
   child->inertiatensor.removeDependent(&inertiatensor);
   child->transform.removeDependent(&cog);
   child->transform.removeDependent(&inertiatensor);
+
+  touchStructure();
+}
+
+/**
+  Mark a structural change in this object.
+
+  A new serial number is assigned to this object and all its parents.
+
+  \see getStructureSerial()
+ */
+void WorldObject::touchStructure()
+{
+  unsigned long serial = ++structure_counter;
+  WorldObject* obj = this;
+  while(obj!=0)
+  {
+    obj->structure_serial = serial;
+    obj = obj->parent;
+  }
 }
 
 /**
@@ -1016,42 +1144,15 @@ void WorldObject::removeChild(string name)
 
   If \a name is already the name of a children object, then it's modified
   by adding/increasing a trailing number, otherwise it's returned unchanged.
+  The numbers that are known to be in use are skipped, so adding many
+  objects with the same name takes constant time per object.
 
   \param name A name
   \return The modified name that is unique
  */
 string WorldObject::makeChildNameUnique(string name) const
 {
-  string base;
-  long num;
-  int numpos = name.size();
-  std::ostringstream resstr;
-  string res;
-
-  // Determine the position where a trailing number begins
-  while((numpos>0) && isdigit(name[numpos-1]))
-  {
-    numpos--;
-  }
-
-  // Copy the first part of the name (without the trailing number)
-  base = name.substr(0, numpos);
-
-  // Convert the trailing number to a long
-  num = atol(name.substr(numpos, name.size()-numpos).c_str()); 
-
-  // Increase the number until the name is unique
-  // (but start with the original name (that might have no number at all))
-  res = name;
-  while(hasChild(res))
-  {
-    num++;
-    resstr.str("");
-    resstr<<base<<num;
-    res = resstr.str();
-  }
-
-  return res;
+  return childs.makeUnique(name);
 }
 
 /**
@@ -1076,9 +1177,7 @@ void WorldObject::onRenameChild(const WorldObject& child, string newname)
     throw EValueError("Object \""+getName()+"\" already has a children called \""+newname+"\".");
   }
   
-  boost::shared_ptr<WorldObject> c = childs.find(child.getName())->second;
-  childs.erase(child.getName());
-  childs[newname] = c;
+  childs.rename(child.getName(), newname);
 }
 
 
@@ -1097,10 +1196,8 @@ void WorldObject::onRenameChild(const WorldObject& child, string newname)
 void WorldObject::computeCog(vec3d& cog)
 {
   // Does the current geom object have a "cog" slot?
-  if ((geom.get()!=0) && (geom->hasSlot("cog")))
+  if ((geom.get()!=0) && geom_cog.getVal(*geom, cog))
   {
-    ISlot& slot = geom->slot("cog");
-    slot.getVal(cog);
     cog = _inverseOffsetTransform*cog;
   }
   else
@@ -1117,13 +1214,11 @@ void WorldObject::computeCog(vec3d& cog)
 
     for(ChildIterator it=childsBegin(); it!=childsEnd(); it++)
     {
+      WorldObject* child = it->second.get();
       bool dynamics = false;
-      // No dynamics slot? Then this is no rigid body anyway
-      if (!it->second->hasSlot("dynamics"))
-	continue;
-      // Only take children into account whose dynamics attribute is true...
-      it->second->slot("dynamics").getVal(dynamics);
-      if (!dynamics)
+      // Only take children into account whose dynamics attribute is true
+      // (no dynamics slot means this is no rigid body anyway)
+      if (!child->dynamics_slot.getVal(*child, dynamics) || !dynamics)
 	continue;
 
       double m = it->second->mass.getValue();
@@ -1151,12 +1246,8 @@ void WorldObject::computeCog(vec3d& cog)
  */
 void WorldObject::computeInertiaTensor(mat3d& tensor)
 {
-  if ((geom.get()!=0) && (geom->hasSlot("inertiatensor")))
+  if ((geom.get()!=0) && geom_inertiatensor.getVal(*geom, tensor))
   {
-    // Get the tensor from the geom
-    ISlot& slot = geom->slot("inertiatensor");
-    slot.getVal(tensor);
-
     // Rotate
     tensor = _rotateI(tensor, _inverseOffsetTransform.getMat3());
 
@@ -1165,8 +1256,7 @@ void WorldObject::computeInertiaTensor(mat3d& tensor)
     vec4d c4;
     _inverseOffsetTransform.getColumn(3, c4);
     vec3d a(c4.x, c4.y, c4.z);
-    ISlot& cogslot = geom->slot("cog");
-    cogslot.getVal(cog);
+    geom_cog.getVal(*geom, cog);
     tensor += _translateI(cog, a);
 
     // Adjust for mass
@@ -1182,13 +1272,11 @@ void WorldObject::computeInertiaTensor(mat3d& tensor)
   {
     for(ChildIterator it=childsBegin(); it!=childsEnd(); it++)
     {
+      WorldObject* child = it->second.get();
       bool dynamics = false;
-      // No dynamics slot? Then this is no rigid body anyway
-      if (!it->second->hasSlot("dynamics"))
-	continue;
-      // Only take children into account whose dynamics attribute is true...
-      it->second->slot("dynamics").getVal(dynamics);
-      if (!dynamics)
+      // Only take children into account whose dynamics attribute is true
+      // (no dynamics slot means this is no rigid body anyway)
+      if (!child->dynamics_slot.getVal(*child, dynamics) || !dynamics)
 	continue;
 
       mat3d childI = it->second->inertiatensor.getValue();
@@ -1270,15 +1358,16 @@ void WorldObject::computeTotalMass(double& massvalue)
  */
 void WorldObject::computeWorldTransform(mat4d& WT)
 {
-  // Start with the local transform of the object itself...
-  WT = localTransform();
-
-  // ...and walk up the hierarchy
-  WorldObject* p = parent;
-  while(p!=0)
+  // Take the world transform of the parent (via its slot so that the
+  // parent's cache becomes valid and any future change gets propagated
+  // down to this object) and append the local transform.
+  if (parent==0)
+  {
+    WT = localTransform();
+  }
+  else
   {
-    WT = p->localTransform()*WT;
-    p = p->parent;
+    WT = parent->worldtransform.getValue()*localTransform();
   }
 }
 
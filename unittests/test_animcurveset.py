@@ -0,0 +1,129 @@
+# Test the AnimCurveSet component
+
+import unittest
+from cgkit.all import *
+from _utils import *
+
+
+class TestAnimCurveSet(unittest.TestCase):
+
+    def setUp(self):
+        getScene().clear()
+
+    def testInterpolation(self):
+        """Check the scalar interpolation modes."""
+        ac = AnimCurveSet(auto_insert=False)
+        ac.addChannel("a")
+        ac.addChannel("b")
+        ac.addChannel("c")
+        ac.setKeys(0, [0, 1, 2], [0, 10, 0], "step")
+        ac.setKeys(1, [0, 1, 2], [0, 10, 0], "linear")
+        ac.setKeys(2, [0, 1, 2], [0, 10, 0], "hermite")
+
+        self.assertEqual(ac.evalCurve(0, 0.5), 0)
+        self.assertEqual(ac.evalCurve(1, 0.5), 5)
+        self.assertEqual(ac.evalCurve(1, 1.5), 5)
+        self.assertAlmostEqual(ac.evalCurve(2, 0.5), 6.25)
+        self.assertEqual(ac.getTangents(2, 1), (0.0, 0.0))
+        # Constant extrapolation
+        self.assertEqual(ac.evalCurve(1, -1), 0)
+        self.assertEqual(ac.evalCurve(1, 5), 0)
+        # Out of order access (no cached segment)
+        self.assertEqual(ac.evalCurve(1, 1.5), 5)
+        self.assertEqual(ac.evalCurve(1, 0.25), 2.5)
+
+        # A Bezier segment with control points on the line is linear
+        ac.setBezierControls(2, 0, 10.0/3, 20.0/3)
+        self.assertAlmostEqual(ac.evalCurve(2, 0.25), 2.5)
+
+        self.assertRaises(ValueError, lambda: ac.setKeys(0, [1, 0], [0, 0]))
+        self.assertRaises(ValueError, lambda: ac.setKeys(0, [0, 1], [0, 0], "cubic"))
+
+    def testInsertKey(self):
+        """Check inserting and removing keys."""
+        ac = AnimCurveSet(auto_insert=False)
+        ac.addChannel("a")
+        ac.insertKey(0, 2.0, 20)
+        ac.insertKey(0, 0.0, 0)
+        ac.insertKey(0, 1.0, 5)
+        ac.insertKey(0, 1.0, 10)
+        self.assertEqual(ac.numKeys(0), 3)
+        self.assertEqual(ac.getKey(0, 1), (1.0, 10.0))
+        self.assertEqual(ac.evalCurve(0, 1.5), 15)
+        ac.removeKey(0, 1)
+        self.assertEqual(ac.evalCurve(0, 1.5), 15)
+        self.assertEqual(ac.evalCurve(0, 0.5), 5)
+
+    def testSampledKeys(self):
+        """Check equally spaced keys."""
+        ac = AnimCurveSet(auto_insert=False)
+        ac.addChannel("a")
+        ac.setSampledKeys(0, 1.0, 0.5, [0, 1, 2, 3, 4])
+        self.assertEqual(ac.numKeys(0), 5)
+        self.assertEqual(ac.getKey(0, 4), (3.0, 4.0))
+        self.assertEqual(ac.evalCurve(0, 0.0), 0)
+        self.assertEqual(ac.evalCurve(0, 1.25), 0.5)
+        self.assertEqual(ac.evalCurve(0, 2.75), 3.5)
+        self.assertEqual(ac.evalCurve(0, 10.0), 4)
+
+    def testQuatCurve(self):
+        """Check quaternion curves."""
+        ac = AnimCurveSet(auto_insert=False)
+        ac.addChannel("q", "quat")
+        q0 = quat(1)
+        q1 = quat().fromAngleAxis(pi/2, vec3(0,0,1))
+        ac.setQuatKeys(0, [0, 1], [q0, q1.toMat3()])
+        q = ac.evalQuatCurve(0, 0.5)
+        angle, axis = q.toAngleAxis()
+        self.assertAlmostEqual(angle, pi/4)
+        # The shortest path is taken
+        ac.setQuatKeys(0, [0, 1], [q0, -q1])
+        angle, axis = ac.evalQuatCurve(0, 0.5).toAngleAxis()
+        self.assertAlmostEqual(angle, pi/4)
+        # Step interpolation
+        ac.setQuatKeys(0, [0, 1], [q0, q1], "step")
+        self.assertEqual(ac.evalQuatCurve(0, 0.9), q0)
+
+    def testSlots(self):
+        """Check the output slots."""
+        ac = AnimCurveSet(channels=[("pos", "vec3"), ("rot", "mat3"), ("w", "double")],
+                          auto_insert=False)
+        self.assertEqual(ac.numChannels(), 3)
+        self.assertEqual(ac.numCurves(), 4)
+        self.assertEqual(ac.numQuatCurves(), 1)
+        self.assertEqual(ac.channelType(1), "mat3")
+        self.assertEqual(ac.channelCurve(2), 3)
+        self.assertEqual(ac.findChannel("w"), 2)
+        self.assertEqual(ac.findChannel("spam"), -1)
+
+        ac.setChannelKeys("pos", [0, 2], [vec3(0), vec3(2,4,6)])
+        ac.setChannelKeys("rot", [0, 2], [mat3(1), mat3.rotation(pi/2, vec3(0,0,1))])
+
+        w = WorldObject(auto_insert=False)
+        ac.slot("pos").connect(w.pos_slot)
+        ac.slot("rot").connect(w.rot_slot)
+
+        ac.time_slot.setValue(1.0)
+        self.assertEqual(w.pos, vec3(1,2,3))
+        self.assertEqual(w.rot*vec3(1,0,0), vec3(0.5*sqrt(2), 0.5*sqrt(2), 0))
+        ac.time_slot.setValue(2.0)
+        self.assertEqual(w.pos, vec3(2,4,6))
+
+        # Modifying the keys updates the outputs
+        ac.setChannelKeys("pos", [0, 2], [vec3(0), vec3(4,4,4)])
+        self.assertEqual(w.pos, vec3(4,4,4))
+
+        # Looping and time scale
+        ac.modulo = 2.0
+        ac.time_slot.setValue(3.0)
+        self.assertEqual(w.pos, vec3(2,2,2))
+        ac.tscale = 0.5
+        self.assertEqual(w.pos, vec3(3,3,3))
+
+        self.assertRaises(KeyError, lambda: ac.addChannel("pos"))
+        self.assertRaises(ValueError, lambda: ac.addChannel("foo", "vec4"))
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
@@ -155,6 +155,103 @@ class TestBezierCurveGeom(unittest.TestCase):
         checkVarResize(self, geom)
 
 
+    def testArcLenToParam(self):
+        """Check the conversion from arc length to curve parameter."""
+
+        crv = BezierCurveGeom(pnts = [BezierPoint((1,0,0), outtangent=(0.5,0.5,0)),
+                                      BezierPoint((2,0,0)),
+                                      BezierPoint((2,1,0), intangent=(0.3,-0.7,0.2)),
+                                      BezierPoint((1,1,0))],
+                              closed = True)
+        L = crv.length()
+        self.assertEqual(crv.arcLenToParam(0.0), 0.0)
+        self.assertEqual(crv.arcLenToParam(L), 4.0)
+        self.assertEqual(crv.arcLenToParam(-1.0), 0.0)
+        self.assertEqual(crv.arcLenToParam(L+1.0), 4.0)
+        for i in range(101):
+            s = L*i/100.0
+            t = crv.arcLenToParam(s)
+            self.failUnless(abs(crv.arcLen(t)-s)<1E-9, "arcLen(%f)=%f != %f"%(t, crv.arcLen(t), s))
+
+        ss = [-1.0, 0.0, 0.3*L, 0.7*L, L]
+        self.assertEqual(crv.arcLenToParamMany(ss), map(crv.arcLenToParam, ss))
+
+        # A segment with evenly spaced control points has a constant speed
+        crv = BezierCurveGeom(pnts = [BezierPoint((0,0,0), outtangent=(2.0/3,0,0)),
+                                      BezierPoint((2,0,0), intangent=(-2.0/3,0,0))])
+        self.assertEqual(crv.length(), 2.0)
+        self.assertAlmostEqual(crv.arcLenToParam(0.5), 0.25, 10)
+        self.assertAlmostEqual(crv.arcLenToParam(1.5), 0.75, 10)
+
+        # The table must be updated when the curve is modified
+        crv.pnts[1] = vec3(4,0,0)
+        self.assertEqual(crv.length(), 4.0)
+        self.assertAlmostEqual(crv.arcLenToParam(2.0), 0.5, 10)
+
+    def testEvalMany(self):
+        """Evaluate the curve at several parameters at once."""
+
+        crv = BezierCurveGeom(pnts = [BezierPoint((1,0,0), outtangent=(0.5,0.5,0)),
+                                      BezierPoint((2,0,0)),
+                                      BezierPoint((2,1,0)),
+                                      BezierPoint((1,1,0))],
+                              closed = False)
+        ts = [0.0, 0.3, 1.2, 2.7, 3.0]
+        ps = crv.evalMany(ts)
+        frames = crv.evalFrameMany(ts)
+        self.assertEqual(len(ps), len(ts))
+        self.assertEqual(len(frames), len(ts))
+        for t,p,f in zip(ts, ps, frames):
+            self.assertEqual(p, crv.eval(t))
+            self.assertEqual(f, crv.evalFrame(t))
+            self.assertEqual(f[1], crv.deriv(t))
+        self.assertEqual(crv.evalMany([]), [])
+
+        # Enough parameters to be evaluated in parallel
+        ts = [3.0*i/999 for i in range(1000)]
+        self.assertEqual(crv.evalMany(ts), map(crv.eval, ts))
+        self.assertEqual(crv.evalFrameMany(ts), map(crv.evalFrame, ts))
+        L = crv.length()
+        ss = [L*i/999 for i in range(1000)]
+        self.assertEqual(crv.arcLenToParamMany(ss), map(crv.arcLenToParam, ss))
+
+    def testFlatten(self):
+        """Check the flattening of a curve."""
+
+        # Straight segments are represented by a single line
+        crv = BezierCurveGeom(pnts = [BezierPoint((1,0,0)),
+                                      BezierPoint((2,0,0)),
+                                      BezierPoint((2,1,0)),
+                                      BezierPoint((1,1,0))],
+                              closed = False)
+        self.assertEqual(crv.flatten(0.01), [vec3(1,0,0), vec3(2,0,0),
+                                             vec3(2,1,0), vec3(1,1,0)])
+
+        # A curved segment receives more points if the tolerance decreases
+        crv.outtangents[0] = vec3(0.5,0.5,0)
+        n1 = len(crv.flatten(0.01))
+        n2 = len(crv.flatten(0.0001))
+        self.failUnless(n2>n1>4, "%d, %d"%(n1,n2))
+        # ...but it is never subdivided more than maxdepth times
+        self.assertEqual(len(crv.flatten(0.0, maxdepth=3)), 1+3*8)
+
+    def testBoundingBox(self):
+        """Check the bounding box."""
+
+        crv = BezierCurveGeom(pnts = [BezierPoint((1,0,0), intangent=(0,0,-5)),
+                                      BezierPoint((2,0,0), outtangent=(0,0,2)),
+                                      BezierPoint((2,1,0), intangent=(0,0,-1)),
+                                      BezierPoint((1,1,0), outtangent=(0,0,5))],
+                              closed = False)
+        # The unused tangents of the end points are ignored
+        bmin, bmax = crv.boundingBox().getBounds()
+        self.assertEqual(bmin, vec3(1,0,-1))
+        self.assertEqual(bmax, vec3(2,1,2))
+        crv.closed = True
+        bmin, bmax = crv.boundingBox().getBounds()
+        self.assertEqual(bmin, vec3(1,0,-5))
+        self.assertEqual(bmax, vec3(2,1,5))
+
 ######################################################################
 
 if __name__=="__main__":
@@ -113,6 +113,53 @@ class TestCompRemoveSlot(unittest.TestCase):
         c = Component()
         self.assertRaises(KeyError, lambda: c.removeSlot("bar"))
 
+class TestCompFindSlot(unittest.TestCase):
+
+    def testFindSlot(self):
+        c = Component()
+        self.assertEqual(c.findSlot("foo"), None)
+        names = []
+        for i in range(30):
+            name = "slot%d"%i
+            c.addSlot(name, DoubleSlot(i))
+            names.append(name)
+        for i in range(30):
+            self.assertEqual(c.findSlot("slot%d"%i).getValue(), i)
+        self.assertEqual(c.findSlot("slot30"), None)
+
+        c.removeSlot("slot7")
+        self.assertEqual(c.findSlot("slot7"), None)
+        self.assertEqual(c.hasSlot("slot7"), False)
+        self.assertEqual(c.findSlot("slot8").getValue(), 8)
+        self.assertRaises(KeyError, lambda: c.slot("slot7"))
+
+        # The slots are returned in alphabetical order
+        names.remove("slot7")
+        names.sort()
+        self.assertEqual(list(c.iterSlots()), names)
+
+    def testAddRemoveMany(self):
+        c = Component()
+        for i in range(1000):
+            c.addSlot("slot%d"%i, DoubleSlot(i))
+        # Remove every third slot (in reverse order, then from the front)
+        removed = range(999, 500, -3)+range(0, 500, 3)
+        for i in removed:
+            c.removeSlot("slot%d"%i)
+        self.assertEqual(c.numSlots(), 1000-len(removed))
+        for i in range(1000):
+            if i in removed:
+                self.assertEqual(c.findSlot("slot%d"%i), None)
+            else:
+                self.assertEqual(c.slot("slot%d"%i).getValue(), i)
+        # Re-added slots are found and iterated in alphabetical order as well
+        for i in removed[:10]:
+            c.addSlot("slot%d"%i, DoubleSlot(-i))
+            self.assertEqual(c.slot("slot%d"%i).getValue(), -i)
+        names = ["slot%d"%i for i in range(1000) if i not in removed[10:]]
+        names.sort()
+        self.assertEqual(list(c.iterSlots()), names)
+
 class TestCompSlotIterator(unittest.TestCase):
 
     def testSlotIterator(self):
@@ -0,0 +1,41 @@
+# Test the DrawGeom
+
+import unittest
+from cgkit import _core
+from cgkit.all import *
+from _utils import *    
+    
+
+class TestDrawGeom(unittest.TestCase):
+    
+    def testPackArrays(self):
+        """Check the packed drawing arrays."""
+
+        geom = DrawGeom()
+        geom.marker((1,2,3), (1,0,0), 0.5)
+        geom.marker((0,0,0), (0,1,0), 2.0)
+        geom.line((0,0,0), (1,1,1), (0,0,1))
+
+        mverts, mcols, mindices, lverts, lcols = geom.packArrays()
+        self.assertEqual(len(mverts), 12)
+        self.assertEqual(len(mcols), 12)
+        self.assertEqual(len(mindices), 48)
+        self.assertEqual(mverts[0], vec3(1,2,2.5))
+        self.assertEqual(mverts[5], vec3(1,2,3.5))
+        self.assertEqual(mverts[7], vec3(2,0,0))
+        self.assertEqual(mcols[5], vec3(1,0,0))
+        self.assertEqual(mcols[6], vec3(0,1,0))
+        self.assertEqual(min(mindices[:24]), 0)
+        self.assertEqual(max(mindices[:24]), 5)
+        self.assertEqual(min(mindices[24:]), 6)
+        self.assertEqual(max(mindices[24:]), 11)
+        self.assertEqual(lverts, [vec3(0,0,0), vec3(1,1,1)])
+        self.assertEqual(lcols, [vec3(0,0,1), vec3(0,0,1)])
+
+        geom.clear()
+        self.assertEqual(geom.packArrays(), ([], [], [], [], []))
+        
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
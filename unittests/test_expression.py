@@ -0,0 +1,129 @@
+# Test the Expression component and the expression compiler
+
+import unittest
+from cgkit.all import *
+from cgkit import _core
+from _utils import *
+import math
+
+
+class TestExpression(unittest.TestCase):
+
+    def setUp(self):
+        getScene().clear()
+
+    def testTimer(self):
+        """Check an expression that depends on the timer."""
+        e = Expression("1.0 + amp*sin(freq*t)", amp=0.2, freq=2.0)
+        self.assertEqual(e.compiled, True)
+        self.assertEqual(e.exprtype, "float")
+        timer = getScene().timer()
+        timer.time = 0.0
+        self.assertAlmostEqual(e.output, 1.0)
+        timer.time = 0.5
+        self.assertAlmostEqual(e.output, 1.0+0.2*math.sin(1.0))
+        e.amp = 1.0
+        self.assertAlmostEqual(e.output, 1.0+math.sin(1.0))
+
+    def testSemantics(self):
+        """Check that the compiled code behaves like Python."""
+        self.assertEqual(Expression("7/2").output, 3.0)
+        self.assertEqual(Expression("-7/2").output, -4.0)
+        self.assertEqual(Expression("-7%3").output, 2.0)
+        self.assertEqual(Expression("7.0/2").output, 3.5)
+        self.assertEqual(Expression("-2**2").output, -4.0)
+        self.assertEqual(Expression("round(-2.5)").output, -3.0)
+        self.assertEqual(Expression("1 if 0<2<3 else 2").output, 1.0)
+
+    def testVectors(self):
+        """Check vector and matrix results."""
+        e = Expression("(1,2,3)")
+        self.assertEqual(e.compiled, True)
+        self.assertEqual(e.output, vec3(1,2,3))
+        e = Expression("M*p*2", M=mat3(2), p=vec3(1,2,3))
+        self.assertEqual(e.output, vec3(4,8,12))
+        e = Expression("vec3(1,0,0).cross(vec3(0,1,0))")
+        self.assertEqual(e.output, vec3(0,0,1))
+        e = Expression("mat3().fromEulerZYX(0.1,0.2,0.3)")
+        self.assertEqual(e.exprtype, "mat3")
+        M = mat3().fromEulerZYX(0.1,0.2,0.3)
+        for i in range(3):
+            for j in range(3):
+                self.assertAlmostEqual(e.output[i,j], M[i,j])
+        e = Expression("mat4.translation(p)", p=vec3(1,2,3))
+        self.assertEqual(e.output, mat4(1).translation(vec3(1,2,3)))
+        e = Expression("1", exprtype="vec3")
+        self.assertEqual(e.output, vec3(1,1,1))
+
+    def testFallback(self):
+        """Check that unsupported expressions are evaluated by Python."""
+        e = Expression("(1,2,3,4)")
+        self.assertEqual(e.compiled, False)
+        self.assertEqual(e.output, vec4(1,2,3,4))
+        e = Expression("len([1,2,3])")
+        self.assertEqual(e.compiled, False)
+        self.assertEqual(e.output, 3.0)
+
+    def testProgram(self):
+        """Check the ExprProgram class."""
+        p = _core.ExprProgram()
+        p.addVariable("x")
+        p.addVariable("v", "vec3")
+        self.assertRaises(ValueError, lambda: p.addVariable("x"))
+        self.assertEqual(p.numVariables(), 2)
+        self.assertEqual(p.findVariable("v"), 1)
+        self.assertEqual(p.variableType(1), "vec3")
+
+        p.compile("v*x + (1,1,1)")
+        self.assertEqual(p.isCompiled(), True)
+        self.assertEqual(p.resultType(), "vec3")
+        self.assertEqual(p.evaluate([2, vec3(1,2,3)]), vec3(3,5,7))
+        res = p.evaluateMany([[0,1,2], vec3(1,2,3)])
+        self.assertEqual(res, [vec3(1,1,1), vec3(2,3,4), vec3(3,5,7)])
+
+        # Constant subexpressions are folded
+        p.compile("x*(2*3+sqrt(16))")
+        self.assertEqual(p.numInstructions(), 1)
+        self.assertEqual(p.evaluate([2, vec3()]), 20.0)
+
+        p.compile("1/x")
+        self.assertRaises(ZeroDivisionError, lambda: p.evaluate([0, vec3()]))
+        self.assertRaises(ZeroDivisionError, lambda: p.evaluateMany([range(-500,500), vec3()]))
+
+        # Math domain errors are reported just like in Python
+        p.compile("sqrt(x)")
+        self.assertEqual(p.evaluate([4, vec3()]), 2.0)
+        self.assertRaises(ValueError, lambda: p.evaluate([-1, vec3()]))
+        self.assertRaises(ValueError, lambda: p.evaluateMany([range(-500,500), vec3()]))
+        p.compile("x**(1.0/3)")
+        self.assertRaises(ValueError, lambda: p.evaluate([-8, vec3()]))
+        p.compile("log(x)")
+        self.assertRaises(ValueError, lambda: p.evaluate([0, vec3()]))
+        p.compile("asin(x)")
+        self.assertRaises(ValueError, lambda: p.evaluate([2, vec3()]))
+        p.compile("x**-1")
+        self.assertRaises(ZeroDivisionError, lambda: p.evaluate([0, vec3()]))
+        self.assertRaises(ValueError, lambda: p.compile("sqrt(-1)"))
+        e = Expression("sqrt(-1)")
+        self.assertEqual(e.compiled, False)
+
+        self.assertRaises(ValueError, lambda: p.compile("x+"))
+        self.assertRaises(ValueError, lambda: p.compile("y"))
+        self.assertRaises(ValueError, lambda: p.compile("v", "float"))
+
+    def testExpressionSlot(self):
+        """Check the expression slot classes."""
+        t = DoubleSlot(2.0)
+        s = _core.DoubleExpressionSlot()
+        s.addVariable("t", t)
+        t.addDependent(s)
+        s.compile("t*t")
+        self.assertEqual(s.getValue(), 4.0)
+        t.setValue(3.0)
+        self.assertEqual(s.getValue(), 9.0)
+        self.assertRaises(ValueError, lambda: s.compile("(t,t,t)"))
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
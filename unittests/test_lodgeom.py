@@ -0,0 +1,42 @@
+# Test the LODGeom
+
+import unittest
+from cgkit import _core
+from cgkit.all import *
+from _utils import *    
+    
+
+class TestLODGeom(unittest.TestCase):
+    
+    def testLevels(self):
+        """Check the level selection."""
+
+        s1 = SphereGeom(radius=1.0)
+        s2 = SphereGeom(radius=2.0)
+        s3 = SphereGeom(radius=3.0)
+        geom = LODGeom([(s1, 100), (s2, 20)])
+        geom.addLevel(s3, 0)
+
+        self.assertEqual(geom.numLevels(), 3)
+        self.assertEqual(geom.getLevel(1), s2)
+        self.assertEqual(geom.getMinSize(-1), 0)
+        self.assertEqual(geom.currentlevel, -1)
+
+        self.assertEqual(geom.selectLevel(500), 0)
+        self.assertEqual(geom.selectLevel(100), 0)
+        self.assertEqual(geom.selectLevel(50), 1)
+        self.assertEqual(geom.selectLevel(1), 2)
+
+        # The bounding box contains all levels
+        bmin,bmax = geom.boundingBox().getBounds()
+        self.assertEqual(bmin, vec3(-3,-3,-3))
+        self.assertEqual(bmax, vec3(3,3,3))
+
+        geom.clearLevels()
+        self.assertEqual(geom.numLevels(), 0)
+        self.assertEqual(geom.selectLevel(10), -1)
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
@@ -0,0 +1,155 @@
+# Test the native motion capture parsers and importers
+
+import unittest
+from cgkit.all import *
+from cgkit import _core
+from _utils import *
+import math
+
+BVH = """HIERARCHY
+ROOT Hips
+{
+  OFFSET 0 0 0
+  CHANNELS 3 Xposition Yposition Zposition
+  JOINT Arm
+  {
+    OFFSET 1 2 3
+    CHANNELS 2 Zrotation Xrotation
+    End Site
+    {
+      OFFSET 0 1 0
+    }
+  }
+}
+MOTION
+Frames: 2
+Frame Time: 0.04
+1 2 3 4 5
+-1.5 2e1 .5 0.1 12345678901234567
+"""
+
+class TestMocapParser(unittest.TestCase):
+
+    def setUp(self):
+        getScene().clear()
+
+    def testBVHParser(self):
+        """Check parsing a BVH file."""
+        p = _core.BVHParser()
+        p.parse(BVH)
+        self.assertEqual(p.numJoints(), 3)
+        self.assertEqual(p.jointName(1), "Arm")
+        self.assertEqual(p.jointName(2), "End Site")
+        self.assertEqual(p.jointParent(0), -1)
+        self.assertEqual(p.jointParent(2), 1)
+        self.assertEqual(p.jointOffset(1), vec3(1,2,3))
+        self.assertEqual(p.jointChannels(1), ["Zrotation", "Xrotation"])
+        self.assertEqual(p.jointTrack(1), 1)
+        self.assertEqual(p.jointTrack(2), -1)
+        self.assertEqual(p.isEndSite(2), True)
+        self.assertEqual(p.hasMotion(), True)
+
+        m = p.motion
+        self.assertEqual(m.numFrames(), 2)
+        self.assertEqual(m.numChannels(), 5)
+        self.assertEqual(m.numTracks(), 2)
+        self.assertEqual(m.trackChannel(1), 3)
+        self.assertEqual(m.trackSize(1), 2)
+        self.assertEqual(m.frametime, 0.04)
+        self.assertEqual(m.frame(0), [1, 2, 3, 4, 5])
+        self.assertEqual(m.channel(1), [2.0, 20.0])
+        self.assertEqual(m.value(3, 1), 0.1)
+        self.assertEqual(m.value(4, 1), float("12345678901234567"))
+
+    def testBVHErrors(self):
+        """Check syntax errors in BVH files."""
+        p = _core.BVHParser()
+        self.assertRaises(SyntaxError, lambda: p.parse("HIERARCHY\nROOT a\n{\n CHANNELS 1 Foo\n}\n"))
+        bvh = "HIERARCHY\nROOT a\n{\n CHANNELS 1 Xrotation\n}\nMOTION\nFrames: 2\nFrame Time: 0.1\n"
+        self.assertRaises(SyntaxError, lambda: p.parse(bvh+"1\n2 3\n"))
+        self.assertRaises(SyntaxError, lambda: p.parse(bvh+"1\nx\n"))
+        self.assertRaises(SyntaxError, lambda: p.parse(bvh+"1\n"))
+        self.assertRaises(IOError, lambda: p.read("data/nonexistent.bvh"))
+        p.parse(bvh+"1\n2\n")
+        self.assertEqual(p.motion.channel(0), [1, 2])
+
+    def testAMCParser(self):
+        """Check parsing an AMC file."""
+        p = _core.AMCParser()
+        p.read("data/mocap.amc")
+        self.assertEqual(p.frameNumbers(), [1, 2, 3])
+        m = p.motion
+        self.assertEqual(m.numFrames(), 3)
+        self.assertEqual(m.numTracks(), 2)
+        self.assertEqual(m.trackName(0), "root")
+        self.assertEqual(m.trackSize(0), 6)
+        self.assertEqual(m.trackName(1), "lfemur")
+        # The bones may appear in any order
+        self.assertEqual(m.frame(2), [2, 4, 6, 0, 0, 0, 30, 0, 0])
+
+        self.assertRaises(SyntaxError, lambda: p.parse("1\nroot 1 2\n2\nfoo 1 2\n"))
+        self.assertRaises(SyntaxError, lambda: p.parse("1\nroot 1 2\n2\nroot 1\n"))
+        self.assertRaises(SyntaxError, lambda: p.parse("root 1 2\n"))
+
+    def testCurves(self):
+        """Check transferring motion data into an AnimCurveSet."""
+        p = _core.BVHParser()
+        p.parse(BVH)
+        ac = AnimCurveSet(auto_insert=False)
+        ac.addChannel("a", "double")
+        ac.addChannel("r", "quat")
+        ac.setMotionKeys(0, p.motion, 1, 0.0, 1.0, scale=2.0)
+        self.assertEqual(ac.numKeys(0), 2)
+        self.assertEqual(ac.evalCurve(0, 0.5), 22.0)
+        ac.setMotionQuatKeys(0, p.motion, (4, -1, 3), "zyx", 0.0, 1.0, math.pi/180)
+        q = quat().fromMat(mat3().fromEulerZYX(math.radians(5), 0, math.radians(4)))
+        r = ac.evalQuatCurve(0, 0.0)
+        self.assertAlmostEqual(r.w, q.w)
+        self.assertAlmostEqual(r.x, q.x)
+        self.assertAlmostEqual(r.y, q.y)
+        self.assertAlmostEqual(r.z, q.z)
+        self.assertRaises(ValueError, lambda: ac.setMotionQuatKeys(0, p.motion, (4, -1, 3), "abc", 0.0, 1.0))
+
+    def testBVHImport(self):
+        """Check importing a BVH file."""
+        load("data/mocap.bvh")
+        hips = getScene().worldObject("Hips")
+        chest = getScene().worldObject("Hips|Chest")
+        timer = getScene().timer()
+        timer.time = 0.5
+        self.assertEqual(hips.pos, vec3(1,1,2))
+        self.assertEqual(hips.anglez, 20)
+        self.assertEqual(chest.anglez, 5)
+        # The frames are held (and not interpolated)
+        timer.time = 0.25
+        self.assertEqual(hips.anglez, 10)
+        self.assertEqual(chest.anglez, 0)
+        timer.time = 0.99
+        self.assertEqual(hips.pos, vec3(1,1,2))
+        self.assertEqual(chest.anglez, 5)
+
+    def testAMCImport(self):
+        """Check importing an ASF/AMC file."""
+        load("data/mocap.amc", framerate=2)
+        root = getScene().worldObject("root")
+        lfemur = getScene().worldObject("root|lfemur")
+        timer = getScene().timer()
+        timer.time = 0.5
+        self.assertEqual(root.pos, vec3(1,2,3))
+        self.assertEqual(lfemur.anglex, 20)
+        R = mat3().fromEulerZYX(0, math.pi/2, 0)
+        for i in range(3):
+            for j in range(3):
+                self.assertAlmostEqual(root.rot[i,j], R[i,j])
+        # The frames are held (and not interpolated)
+        timer.time = 0.75
+        self.assertEqual(root.pos, vec3(1,2,3))
+        self.assertEqual(lfemur.anglex, 20)
+        for i in range(3):
+            for j in range(3):
+                self.assertAlmostEqual(root.rot[i,j], R[i,j])
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
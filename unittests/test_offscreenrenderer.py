@@ -0,0 +1,46 @@
+# Test the OffscreenRenderer
+
+import unittest
+from cgkit import _core
+from cgkit.all import *
+from _utils import *
+
+class TestOffscreenRenderer(unittest.TestCase):
+
+    def testRender(self):
+        """Render a sphere with the OpenGL renderer."""
+
+        # Only available if cgkit was compiled with OFFSCREEN_GL
+        if not hasattr(_core, "OffscreenGLContext"):
+            return
+
+        from cgkit.offscreenrenderer import OffscreenRenderer
+
+        scene = getScene()
+        scene.clear()
+        scene.setGlobal("background", vec4(0,0,1,0))
+        s = Sphere(radius=1.0, material=GLMaterial(diffuse=(1,0,0,1)))
+        cam = TargetCamera(pos=(0,0,5), target=(0,0,0))
+
+        osr = OffscreenRenderer(64, 48)
+        self.assertEqual(osr.getResolution(), (64,48))
+        osr.render(cam)
+        osr.render(cam)
+        self.assertEqual(osr.renderer.stat_objects, 1)
+        self.assertEqual(osr.renderer.stat_drawlist_rebuilds, 1)
+
+        data = osr.readPixels()
+        self.assertEqual(len(data), 4*64*48)
+        # Top left corner
+        self.assertEqual(data[:3], "\x00\x00\xff")
+        # Center
+        i = 4*(24*64+32)
+        self.assertEqual(ord(data[i])>128, True)
+        self.assertEqual(ord(data[i+2])<64, True)
+
+        scene.clear()
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
@@ -71,6 +71,30 @@ class TestPolyhedron(unittest.TestCase):
         self.assertEqual(vx_slot.size(), 6)
         self.assertEqual(fv_slot.size(), 11)
         self.assertEqual(fvx_slot.size(), 11)
+
+    def testTopology(self):
+        pg = PolyhedronGeom()
+        pg.verts.resize(8)
+        pg.setNumPolys(6)
+        pg.setPoly(0, [[0,3,2,1]])
+        pg.setPoly(1, [[4,5,6,7]])
+        pg.setPoly(2, [[0,1,5,4]])
+        pg.setPoly(3, [[1,2,6,5]])
+        pg.setPoly(4, [[2,3,7,6]])
+        pg.setPoly(5, [[3,0,4,7]])
+
+        t = pg.getTopology()
+        self.assertEqual(t.getNumHalfEdges(), 24)
+        self.assertEqual(t.getNumEdges(), 12)
+        self.assertEqual(t.boundaryLoops(), [])
+        self.assertEqual(t.vertexRing(0), [3,1,4])
+        self.assertEqual(t.faceNeighbors(0), [5,4,3,2])
+
+        # Remove the top face
+        pg.setPoly(1, [])
+        t = pg.getTopology()
+        self.assertEqual(t.faceNeighbors(1), [])
+        self.assertEqual(t.boundaryLoops(), [[5,4,7,6]])
         
 
 ######################################################################
@@ -0,0 +1,156 @@
+# Test the SkinGeom
+
+import unittest
+from cgkit.all import *
+from _utils import *
+import math
+
+
+# Create a strip along the x axis that is bound to two joints
+def createStrip(n):
+    tm = TriMeshGeom()
+    tm.verts.resize(2*n)
+    tm.faces.resize(2*(n-1))
+    for i in range(n):
+        tm.verts[2*i] = (i,0,0)
+        tm.verts[2*i+1] = (i,1,0)
+    for i in range(n-1):
+        tm.faces[2*i] = (2*i, 2*i+2, 2*i+1)
+        tm.faces[2*i+1] = (2*i+2, 2*i+3, 2*i+1)
+    tm.newVariable("jointindices", VARYING, INT, 2)
+    tm.newVariable("jointweights", VARYING, FLOAT, 2)
+    tm.newVariable("N", VARYING, NORMAL)
+    ji = tm.slot("jointindices")
+    jw = tm.slot("jointweights")
+    N = tm.slot("N")
+    for i in range(2*n):
+        t = float(i/2)/(n-1)
+        ji[i] = (0,1)
+        jw[i] = (1.0-t, t)
+        N[i] = (0,0,1)
+    return tm
+
+class TestSkinGeom(unittest.TestCase):
+
+    def setUp(self):
+        getScene().clear()
+
+    def testLinearBlend(self):
+        """Check linear blend skinning."""
+        n = 11
+        bind = createStrip(n)
+        geom = SkinGeom(bind, [mat4(1), mat4.translation(vec3(n-1,0,0))])
+        self.assertEqual(geom.numJoints(), 2)
+        self.assertEqual(geom.numinfluences, 2)
+        self.assertEqual(geom.mode, "linear")
+        self.assertEqual(geom.verts.size(), 2*n)
+        self.assertEqual(geom.faces.size(), 2*(n-1))
+        self.assertEqual(geom.update(), True)
+        self.assertEqual(geom.update(), False)
+        for i in range(2*n):
+            self.assertEqual(geom.verts[i], bind.verts[i])
+
+        # Translating both joints translates the mesh
+        T = mat4.translation(vec3(1,2,3))
+        geom.slot("joint0").setValue(T)
+        geom.slot("joint1").setValue(T*geom.getBindTransform(1))
+        self.assertEqual(geom.dirty, True)
+        bmin, bmax = geom.boundingBox().getBounds()
+        self.assertEqual(geom.dirty, False)
+        self.assertEqual(bmin, vec3(1,2,3))
+        self.assertEqual(bmax, vec3(n,3,3))
+        for i in range(2*n):
+            self.assertEqual(geom.verts[i], bind.verts[i]+vec3(1,2,3))
+
+    def testDualQuat(self):
+        """Check dual quaternion skinning."""
+        n = 11
+        bind = createStrip(n)
+        geom = SkinGeom(bind, [mat4(1), mat4.translation(vec3(n-1,0,0))])
+        # Twist the end of the strip by 180 degrees around its center line
+        B = geom.getBindTransform(1)
+        C = mat4.translation(vec3(0,0.5,0))
+        R = mat4.rotation(math.pi, vec3(1,0,0))
+        geom.jointSlot(1).setValue(C*B*R*C.inverse())
+        geom.update()
+        # The linear blend collapses the middle...
+        d = (geom.verts[n]-geom.verts[n-1]).length()
+        self.assertEqual(d<0.01, True)
+        # ...the dual quaternion blend doesn't
+        geom.mode = "dualquat"
+        self.assertEqual(geom.dirty, True)
+        geom.update()
+        d = (geom.verts[n]-geom.verts[n-1]).length()
+        self.assertAlmostEqual(d, 1.0)
+        self.assertEqual(geom.verts[2*n-2], vec3(n-1,1,0))
+        N = geom.slot("N")
+        self.assertEqual(N[0], vec3(0,0,1))
+        self.assertEqual(N[2*n-1], vec3(0,0,-1))
+
+        self.assertRaises(ValueError, lambda: setattr(geom, "mode", "spam"))
+
+    def testLargeMesh(self):
+        """Check a mesh that is large enough to be deformed in parallel."""
+        n = 300
+        bind = createStrip(n)
+        geom = SkinGeom(bind, [mat4(1), mat4.translation(vec3(n-1,0,0))])
+        B = geom.getBindTransform(1)
+        C = mat4.translation(vec3(0,0.5,0))
+        R = mat4.rotation(0.5*math.pi, vec3(1,0,0))
+        J = C*B*R*C.inverse()
+        geom.jointSlot(1).setValue(J)
+        geom.update()
+        M = J*B.inverse()
+        for i in range(2*n):
+            t = float(i/2)/(n-1)
+            v = ((1.0-t)*mat4(1)+t*M)*bind.verts[i]
+            self.failUnless((geom.verts[i]-v).length()<1E-9, "vertex %d: %s != %s"%(i, geom.verts[i], v))
+
+        # The cross sections stay rigid with dual quaternions
+        geom.mode = "dualquat"
+        geom.update()
+        N = geom.slot("N")
+        for i in range(n):
+            d = (geom.verts[2*i+1]-geom.verts[2*i]).length()
+            self.assertAlmostEqual(d, 1.0)
+            self.assertAlmostEqual(N[2*i].length(), 1.0)
+            self.assertEqual(N[2*i], N[2*i+1])
+
+    def testJoints(self):
+        """Check skinning with Joint objects."""
+        bind = createStrip(5)
+        j1 = Joint(pos=(0,0,0))
+        j2 = Joint(pos=(4,0,0), parent=j1)
+        geom = SkinGeom(bind, [j1, j2])
+        self.assertEqual(geom.getBindTransform(1), j2.worldtransform)
+        geom.update()
+        self.assertEqual(geom.dirty, False)
+        # Moving the root joint moves the whole mesh
+        j1.pos = vec3(0,0,2)
+        self.assertEqual(geom.dirty, True)
+        geom.update()
+        for i in range(10):
+            self.assertEqual(geom.verts[i], bind.verts[i]+vec3(0,0,2))
+
+        # Changing the bind mesh vertices also updates the mesh
+        bind.verts[0] = (-1,0,0)
+        geom.update()
+        self.assertEqual(geom.verts[0], vec3(-1,0,2))
+
+        geom.clearJoints()
+        self.assertEqual(geom.numJoints(), 0)
+        self.assertEqual(geom.hasSlot("joint0"), False)
+        self.assertRaises(IndexError, lambda: geom.update())
+
+    def testErrors(self):
+        """Check invalid bind meshes."""
+        bind = createStrip(3)
+        geom = SkinGeom()
+        self.assertRaises(ValueError, lambda: geom.setBindMesh(bind, "spam"))
+        self.assertRaises(ValueError, lambda: geom.setBindMesh(bind, "jointweights", "jointindices"))
+        self.assertEqual(geom.bindmesh, None)
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
@@ -0,0 +1,63 @@
+# Test the slot profiler
+
+import unittest
+from cgkit import _core
+from cgkit.all import *
+from cgkit import slotprofiler
+from _utils import *
+
+class TestSlotProfiler(unittest.TestCase):
+
+    def testNumDependents(self):
+        """Check the number of dependents of a slot."""
+        a = DoubleSlot()
+        b = DoubleSlot()
+        c = DoubleSlot()
+        self.assertEqual(a.numDependents(), 0)
+        a.connect(b)
+        a.connect(c)
+        self.assertEqual(a.numDependents(), 2)
+        a.disconnect(c)
+        self.assertEqual(a.numDependents(), 1)
+
+    def testProfile(self):
+        """Collect statistics about slot evaluations."""
+
+        # Only available if cgkit was compiled with CGKIT_SLOT_PROFILING
+        if not slotprofiler.isAvailable():
+            return
+
+        root = WorldObject(name="prof_root")
+        child = WorldObject(name="prof_child", parent=root)
+
+        slotprofiler.enable()
+        slotprofiler.reset()
+        try:
+            for i in range(10):
+                child.mass = float(i+1)
+                root.totalmass
+                root.totalmass
+        finally:
+            slotprofiler.enable(False)
+
+        entries = slotprofiler.getHottestSlots(None, "evaluations")
+        e = filter(lambda e: e.component=="prof_root" and e.slot=="totalmass", entries)
+        self.assertEqual(len(e), 1)
+        e = e[0]
+        self.assertEqual(e.getvalue_calls, 20)
+        self.assertEqual(e.evaluations, 10)
+        self.assertEqual(e.cache_hits, 10)
+        self.assertAlmostEqual(e.hitRatio(), 0.5)
+        self.assertEqual(e.total_time>=e.self_time, True)
+
+        e = filter(lambda e: e.component=="prof_child" and e.slot=="mass", entries)[0]
+        self.assertEqual(e.setvalue_calls, 10)
+        self.assertEqual(e.notify_calls, 10)
+
+        comps = map(lambda c: c.component, slotprofiler.getComponentProfile())
+        self.assertEqual("prof_root" in comps, True)
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
@@ -0,0 +1,51 @@
+# Test the SoftRenderer
+
+import unittest
+from cgkit.all import *
+from _utils import *
+
+
+class TestSoftRenderer(unittest.TestCase):
+
+    def testRender(self):
+        """Render a red sphere in front of the background."""
+
+        root = WorldObject(name="root", auto_insert=False)
+        obj = WorldObject(name="sphere", auto_insert=False)
+        obj.geom = SphereGeom(radius=1.0)
+        obj.setMaterial(GLMaterial(diffuse=(1,0,0,1)))
+        root.addChild(obj)
+
+        r = SoftRenderer(64, 48)
+        self.assertEqual(r.getResolution(), (64,48))
+        r.clearcol = vec4(0,0,1,0)
+        r.setProjection(mat4.perspective(45, 64.0/48, 0.1, 100))
+        r.setViewTransformation(mat4.translation(vec3(0,0,-5)).inverse())
+        r.render(root)
+
+        self.assertEqual(r.stat_triangles>0, True)
+
+        # The sphere is in the center...
+        c = r.getPixel(32, 24)
+        self.assertEqual(c.x>0.5, True)
+        self.assertEqual(c.y<0.1, True)
+        self.assertAlmostEqual(c.w, 1.0, 5)
+        self.assertEqual(r.getDepth(32, 24)<1.0, True)
+
+        # ...and the corners show the background
+        self.assertEqual(r.getPixel(0, 0), vec4(0,0,1,0))
+        self.assertEqual(r.getPixel(63, 47), vec4(0,0,1,0))
+        self.assertAlmostEqual(r.getDepth(0, 0), 1.0, 5)
+
+        data = r.getImageData()
+        self.assertEqual(len(data), 4*64*48)
+        self.assertEqual(data[:4], "\x00\x00\xff\x00")
+
+        self.assertRaises(IndexError, lambda: r.getPixel(64, 0))
+        self.assertRaises(IndexError, lambda: r.getDepth(0, -1))
+        self.assertRaises(ValueError, lambda: r.setResolution(0, 10))
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
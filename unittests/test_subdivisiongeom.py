@@ -0,0 +1,75 @@
+# Test the SubdivisionGeom
+
+import unittest
+from cgkit import _core
+from cgkit.all import *
+from _utils import *    
+    
+
+class TestSubdivisionGeom(unittest.TestCase):
+    
+    def testCatmullClark(self):
+        """Check Catmull-Clark subdivision of a cube."""
+
+        cage = PolyhedronGeom()
+        cage.verts.resize(8)
+        for i in range(8):
+            cage.verts[i] = (2*(i&1)-1, (i&2)-1, (i&4)/2-1)
+        cage.setNumPolys(6)
+        polys = [[0,2,3,1], [4,5,7,6], [0,1,5,4], [2,6,7,3], [0,4,6,2], [1,3,7,5]]
+        for i in range(6):
+            cage.setPoly(i, [polys[i]])
+        cage.newVariable("id", UNIFORM, INT)
+        for i in range(6):
+            cage.slot("id")[i] = i
+
+        geom = SubdivisionGeom(cage, 2)
+        self.assertEqual(geom.levels, 2)
+        self.assertEqual(geom.verts.size(), 98)
+        self.assertEqual(geom.faces.size(), 192)
+        # The cube is symmetric, so is the result
+        v = geom.verts[0]
+        self.assertAlmostEqual(v.x, v.y)
+        self.assertAlmostEqual(v.x, v.z)
+        bmin, bmax = geom.boundingBox().getBounds()
+        self.assertAlmostEqual(bmin.x, -bmax.x)
+        self.assertEqual(bmax.x<1.0, True)
+        # Each cage face produces 32 triangles
+        id = geom.slot("id")
+        for i in range(192):
+            self.assertEqual(id[i], i/32)
+
+        # Moving a cage vertex updates the mesh
+        cage.verts[7] = (2,2,2)
+        bmin, bmax = geom.boundingBox().getBounds()
+        self.assertEqual(bmax.x>1.0, True)
+        self.assertEqual(geom.verts[0], v)
+
+        geom.levels = 1
+        self.assertEqual(geom.verts.size(), 26)
+        self.assertEqual(geom.faces.size(), 48)
+
+    def testLoop(self):
+        """Check Loop subdivision of a tetrahedron."""
+
+        cage = TriMeshGeom()
+        cage.verts.resize(4)
+        cage.faces.resize(4)
+        cage.verts[0] = (1,1,1)
+        cage.verts[1] = (-1,-1,1)
+        cage.verts[2] = (-1,1,-1)
+        cage.verts[3] = (1,-1,-1)
+        cage.faces[0] = (0,1,2)
+        cage.faces[1] = (0,3,1)
+        cage.faces[2] = (0,2,3)
+        cage.faces[3] = (1,3,2)
+
+        geom = SubdivisionGeom(cage, 3)
+        self.assertEqual(geom.verts.size(), 130)
+        self.assertEqual(geom.faces.size(), 256)
+        self.assertEqual(geom.getTopology().boundaryLoops(), [])
+        
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
@@ -0,0 +1,83 @@
+# Test the TextureImage and TextureCache classes
+
+import unittest
+from cgkit import _core
+from cgkit.all import *
+from _utils import *
+from cgkit._OpenGL.GL import GL_LUMINANCE
+
+class TestTextureCache(unittest.TestCase):
+
+    def testMipMaps(self):
+        """Check the mip map levels of a TextureImage."""
+
+        # 4x2 luminance image
+        data = "".join(map(chr, [0, 100, 200, 255,
+                                 20, 120, 0, 1]))
+        img = _core.TextureImage(4, 2, GL_LUMINANCE, data)
+        self.assertEqual(img.getResolution(), (4,2))
+        self.assertEqual(img.getFormat(), GL_LUMINANCE)
+        # 4x2, 2x1, 1x1
+        self.assertEqual(img.getNumLevels(), 3)
+        self.assertEqual(img.getMemSize(), 8+2+1)
+        self.assertEqual(img.isUploaded(), False)
+
+        img = _core.TextureImage(4, 2, GL_RGB, 3*data, mipmap=False)
+        self.assertEqual(img.getNumLevels(), 1)
+        self.assertEqual(img.getMemSize(), 24)
+
+        self.assertRaises(ValueError, lambda: _core.TextureImage(4, 2, GL_RGB, data))
+        self.assertRaises(ValueError, lambda: _core.TextureImage(0, 2, GL_RGB, data))
+
+    def testCache(self):
+        """Check the LRU eviction."""
+
+        data = 64*"\x80"
+        cache = _core.TextureCache(budget=200)
+        a = _core.TextureImage(4, 4, GL_RGBA, data, mipmap=False)
+        b = _core.TextureImage(4, 4, GL_RGBA, data, mipmap=False)
+        c = _core.TextureImage(4, 4, GL_RGBA, data, mipmap=False)
+        cache.insert("a", a)
+        cache.insert("b", b)
+        cache.insert("c", c)
+        self.assertEqual(len(cache), 3)
+        self.assertEqual(cache.getMemSize(), 192)
+
+        # Use "a" so that "b" becomes the least recently used image
+        self.assertEqual(cache.lookup("a").getMemSize(), 64)
+        self.assertEqual(cache.lookup("x"), None)
+        self.assertEqual(cache.stat_hits, 1)
+        self.assertEqual(cache.stat_misses, 1)
+
+        d = _core.TextureImage(4, 4, GL_RGBA, data, mipmap=False)
+        cache.insert("d", d)
+        self.assertEqual(len(cache), 3)
+        self.assertEqual(cache.stat_evictions, 1)
+        self.assertEqual(cache.lookup("b"), None)
+        self.assertNotEqual(cache.lookup("c"), None)
+
+        cache.budget = 64
+        self.assertEqual(len(cache), 1)
+        self.assertEqual(cache.getMemSize(), 64)
+        self.assertNotEqual(cache.lookup("c"), None)
+
+        cache.clear()
+        self.assertEqual(len(cache), 0)
+        self.assertEqual(cache.getMemSize(), 0)
+
+    def testTexImage(self):
+        """Check passing a TextureImage to a GLTexture."""
+
+        tex = GLTexture()
+        self.assertEqual(tex.isReady(), False)
+        img = _core.TextureImage(2, 2, GL_RGB, 12*"\x00")
+        tex.setTexImage(img)
+        self.assertEqual(tex.isReady(), True)
+        self.assertEqual(tex.getTexImage().getNumLevels(), 2)
+        tex.setTexImage(None)
+        self.assertEqual(tex.isReady(), False)
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
@@ -0,0 +1,54 @@
+# Test the tracer
+
+import unittest
+from cgkit import _core
+from cgkit.all import *
+from cgkit import tracing
+from _utils import *
+
+class TestTracing(unittest.TestCase):
+
+    def testRecord(self):
+        """Record events from Python."""
+        tracing.enable(buffersize=100)
+        try:
+            tracing.begin("outer")
+            tracing.instant("step", arg=5)
+            tracing.counter("items", 42)
+            tracing.end("outer")
+            res = tracing.traceCall("call", lambda x: 2*x, 4)
+        finally:
+            tracing.enable(False)
+        self.assertEqual(res, 8)
+        self.assertEqual(_core.numTraceEvents()>=6, True)
+
+        trace = _core.getChromeTrace()
+        self.assertEqual(trace.startswith('{"traceEvents":['), True)
+        self.assertEqual('"name":"outer","cat":"python","ph":"B"' in trace, True)
+        self.assertEqual('"name":"outer","cat":"python","ph":"E"' in trace, True)
+        self.assertEqual('"name":"items","cat":"python","ph":"C"' in trace, True)
+        self.assertEqual('"args":{"value":42}' in trace, True)
+
+        # Disabled tracer doesn't record anything
+        n = _core.numTraceEvents()
+        tracing.instant("ignored")
+        self.assertEqual(_core.numTraceEvents(), n)
+
+    def testRingBuffer(self):
+        """Check that old events get overwritten."""
+        tracing.enable(buffersize=10)
+        try:
+            for i in range(25):
+                tracing.instant("event%d"%i)
+        finally:
+            tracing.enable(False)
+        self.assertEqual(_core.numTraceEvents()<=10, True)
+        trace = _core.getChromeTrace()
+        self.assertEqual('"event24"' in trace, True)
+        self.assertEqual('"event5"' in trace, False)
+        tracing.enable(False, buffersize=65536)
+
+######################################################################
+
+if __name__=="__main__":
+    unittest.main()
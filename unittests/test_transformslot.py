@@ -37,6 +37,39 @@ class TestWithoutControllers(unittest.TestCase):
         self.assertEqual(w.rot, mat3(1))
         self.assertEqual(w.scale, vec3(2,4,2))
 
+    def testDecompose(self):
+        w = WorldObject()
+        R = mat4.rotation(0.5, vec3(1,0.2,1))
+        S = mat4.scaling(vec3(2,3,4))
+        w.transform = mat4.translation(vec3(1,2,3))*R*S
+        self.assertEqual(w.pos, vec3(1,2,3))
+        self.assertEqual(w.rot, R.getMat3())
+        self.assertEqual(w.scale, vec3(2,3,4))
+        # A new transform must not return the previous decomposition
+        w.transform = R
+        self.assertEqual(w.scale, vec3(1,1,1))
+        self.assertEqual(w.rot, R.getMat3())
+        # Negative scaling
+        w.transform = mat4.scaling(vec3(1,-1,1))
+        self.assertEqual(w.scale, vec3(-1,1,1))
+        self.assertEqual(w.rot, mat3(1,0,0, 0,-1,0, 0,0,1).scale(vec3(-1,1,1)))
+        # Sheared matrix
+        M = mat4(1,1,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1)
+        w.transform = M
+        t,r,s = M.decompose()
+        self.assertEqual(w.rot, r.getMat3())
+        self.assertEqual(w.scale, s)
+
+    def testSetValue_RotKeepsScale(self):
+        w = WorldObject()
+        w.transform = mat4.scaling(vec3(2,3,4))
+        for i in range(5):
+            R = mat3.rotation(0.3*i, vec3(0,0,1))
+            w.rot = R
+            self.assertEqual(w.transform.getMat3(), R*mat3.scaling(vec3(2,3,4)))
+        self.assertEqual(w.scale, vec3(2,3,4))
+        self.assertEqual(w.rot, R)
+
 
 ######################################################################
 
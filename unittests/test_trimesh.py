@@ -34,6 +34,217 @@ class TestTriMesh(unittest.TestCase):
         # Check that slots can't be resized (except user vars)
         checkVarResize(self, tm)
 
+    def testComputeNormals(self):
+
+        # Two triangles with a 90 degree fold along the x axis
+        tm = TriMeshGeom()
+        tm.verts.resize(4)
+        tm.faces.resize(2)
+        tm.verts[0] = (0,0,0)
+        tm.verts[1] = (1,0,0)
+        tm.verts[2] = (0,1,0)
+        tm.verts[3] = (0,0,-1)
+        tm.faces[0] = (0,1,2)
+        tm.faces[1] = (0,3,1)
+
+        # Smooth normals (varying)
+        tm.computeNormals()
+        info = tm.findVariable("N")
+        self.assertEqual(info[1], VARYING)
+        N = tm.slot("N")
+        self.assertEqual(N[0], vec3(0,-1,1).normalize())
+        self.assertEqual(N[1], vec3(0,-1,1).normalize())
+        self.assertEqual(N[2], vec3(0,0,1))
+        self.assertEqual(N[3], vec3(0,-1,0))
+
+        # Creased normals (facevarying)
+        tm.computeNormals(creaseangle=0.5)
+        info = tm.findVariable("N")
+        self.assertEqual(info[1], FACEVARYING)
+        N = tm.slot("N")
+        self.assertEqual(N.size(), 6)
+        for i in range(3):
+            self.assertEqual(N[i], vec3(0,0,1))
+            self.assertEqual(N[3+i], vec3(0,-1,0))
+
+        # Incremental update
+        tm.computeNormals()
+        tm.verts[3] = (0,1,0)
+        self.assertEqual(tm.updateNormals(), True)
+        N = tm.slot("N")
+        self.assertEqual(N[0], vec3(0,0,0))
+        self.assertEqual(N[3], vec3(0,0,-1))
+
+        # No more updates after the variable was deleted
+        tm.deleteVariable("N")
+        self.assertEqual(tm.updateNormals(), False)
+
+    def testCleanup(self):
+
+        # Triangle soup of a quad plus a duplicate and a degenerate face
+        tm = TriMeshGeom()
+        tm.verts.resize(6)
+        tm.faces.resize(4)
+        tm.newVariable("st", VARYING, FLOAT, 2)
+        tm.newVariable("id", UNIFORM, INT)
+        tm.verts[0] = (0,0,0)
+        tm.verts[1] = (1,0,0)
+        tm.verts[2] = (1,1,0)
+        tm.verts[3] = (0,0,0)
+        tm.verts[4] = (1,1.00001,0)
+        tm.verts[5] = (0,1,0)
+        tm.faces[0] = (0,1,2)
+        tm.faces[1] = (3,4,5)
+        tm.faces[2] = (1,2,0)
+        tm.faces[3] = (0,3,5)
+        st = tm.slot("st")
+        for i in range(6):
+            v = tm.verts[i]
+            st[i] = (v.x, v.y)
+        # Vertex 4 has a different texture coordinate (seam)
+        st[4] = (2,2)
+        id = tm.slot("id")
+        for i in range(4):
+            id[i] = i
+
+        # The seam prevents welding vertex 4
+        self.assertEqual(tm.cleanup(eps=0.001), (1,1,1,1))
+        self.assertEqual(tm.verts.size(), 5)
+        self.assertEqual(list(tm.faces), [(0,1,2), (0,3,4)])
+        self.assertEqual(list(id), [0,1])
+        self.assertEqual(st[3], (2,2))
+
+        # Ignore the texture coordinates
+        self.assertEqual(tm.cleanup(eps=0.001, comparevars=False), (1,0,0,1))
+        self.assertEqual(tm.verts.size(), 4)
+        self.assertEqual(list(tm.faces), [(0,1,2), (0,2,3)])
+        self.assertEqual(st[3], (0,1))
+
+    def testDecimate(self):
+
+        # Flat 10x10 grid with texture coordinates
+        n = 10
+        tm = TriMeshGeom()
+        tm.verts.resize((n+1)*(n+1))
+        tm.faces.resize(2*n*n)
+        tm.newVariable("st", VARYING, FLOAT, 2)
+        st = tm.slot("st")
+        for i in range(n+1):
+            for j in range(n+1):
+                tm.verts[i*(n+1)+j] = (i,j,0)
+                st[i*(n+1)+j] = (i,j)
+        f = 0
+        for i in range(n):
+            for j in range(n):
+                a = i*(n+1)+j
+                b = a+n+1
+                tm.faces[f] = (a,b,b+1)
+                tm.faces[f+1] = (a,b+1,a+1)
+                f += 2
+
+        res = TriMeshGeom()
+        self.assertEqual(tm.decimate(res, 20), 19)
+        self.assertEqual(res.faces.size(), 19)
+        # The boundary is preserved
+        bmin,bmax = res.boundingBox().getBounds()
+        self.assertEqual(bmin, vec3(0,0,0))
+        self.assertEqual(bmax, vec3(10,10,0))
+        # The texture coordinates still match the vertices
+        st = res.slot("st")
+        for i in range(res.verts.size()):
+            v = res.verts[i]
+            self.assertEqual(st[i], (v.x, v.y))
+        # The source mesh is unchanged
+        self.assertEqual(tm.faces.size(), 200)
+
+        # Level of detail chain
+        lods = tm.lodChain([100, 50, 2])
+        self.assertEqual(map(lambda x: x.faces.size(), lods), [100, 50, 2])
+        self.assertEqual(lods[2].verts.size(), 4)
+
+        # A zero error bound only removes vertices inside flat regions
+        self.assertEqual(tm.decimate(res, 0, maxerror=0.0), 2)
+
+    def testOptimizeVertexCache(self):
+
+        # 20x20 grid where the faces are stored in a scattered order
+        n = 20
+        tm = TriMeshGeom()
+        tm.verts.resize((n+1)*(n+1))
+        tm.faces.resize(2*n*n)
+        tm.newVariable("st", VARYING, FLOAT, 2)
+        tm.newVariable("id", UNIFORM, INT)
+        st = tm.slot("st")
+        id = tm.slot("id")
+        for i in range(n+1):
+            for j in range(n+1):
+                tm.verts[i*(n+1)+j] = (i,j,0)
+                st[i*(n+1)+j] = (i,j)
+        faces = []
+        for i in range(n):
+            for j in range(n):
+                a = i*(n+1)+j
+                b = a+n+1
+                faces.append((a,b,b+1))
+                faces.append((a,b+1,a+1))
+        for k in range(2*n*n):
+            f = (k*37)%(2*n*n)
+            tm.faces[k] = faces[f]
+            id[k] = f
+
+        acmr = tm.vertexCacheMissRatio()
+        tm.optimizeVertexCache()
+        self.assertEqual(tm.vertexCacheMissRatio()<acmr, True)
+        self.assertEqual(tm.verts.size(), (n+1)*(n+1))
+
+        # The vertices are sorted by first use
+        self.assertEqual(tm.faces[0], (0,1,2))
+        # The faces are still the same
+        for k in range(2*n*n):
+            a,b,c = faces[id[k]]
+            va,vb,vc = tm.faces[k]
+            self.assertEqual(tm.verts[va], vec3(a/(n+1), a%(n+1), 0))
+            self.assertEqual(tm.verts[vb], vec3(b/(n+1), b%(n+1), 0))
+            self.assertEqual(tm.verts[vc], vec3(c/(n+1), c%(n+1), 0))
+            self.assertEqual(st[va], (a/(n+1), a%(n+1)))
+
+    def testTopology(self):
+
+        # 3x3 grid
+        n = 3
+        tm = TriMeshGeom()
+        tm.verts.resize((n+1)*(n+1))
+        tm.faces.resize(2*n*n)
+        k = 0
+        for i in range(n):
+            for j in range(n):
+                a = i*(n+1)+j
+                c = a+n+1
+                tm.faces[k] = (a,a+1,c+1)
+                tm.faces[k+1] = (a,c+1,c)
+                k += 2
+
+        t = tm.getTopology()
+        self.assertEqual(t.getNumHalfEdges(), 54)
+        self.assertEqual(t.getNumEdges(), 33)
+        self.assertEqual(t.origin(4), 1)
+        self.assertEqual(t.target(4), 5)
+        self.assertEqual(t.face(t.twin(4)), 3)
+        self.assertEqual(t.twin(0), -1)
+        self.assertEqual(t.vertexRing(5), [0,1,6,10,9,4])
+        self.assertEqual(t.vertexRing(3), [7,2])
+        self.assertEqual(t.vertexFaces(3), [4])
+        self.assertEqual(t.faceNeighbors(0), [-1,3,1])
+        self.assertEqual(t.isBoundaryVertex(5), False)
+        self.assertEqual(t.isBoundaryVertex(0), True)
+        self.assertEqual(t.boundaryLoops(), [[0,1,2,3,7,11,15,14,13,12,8,4]])
+        self.assertRaises(IndexError, lambda: t.vertexRing(16))
+
+        # Modifying the faces invalidates the topology
+        tm.faces[0] = (0,1,2)
+        t = tm.getTopology()
+        self.assertEqual(t.faceNeighbors(0), [-1,-1,-1])
+
 ######################################################################
 
 if __name__=="__main__":
@@ -37,6 +37,85 @@ class TestChildHandling(unittest.TestCase):
         self.assert_(w.hasChild("eggs"), "renamed object couldn't be found")
         self.failIf(w.hasChild("spam"))
 
+    def testStructureSerial(self):
+        w = WorldObject(auto_insert=False)
+        q = WorldObject(name="spam", auto_insert=False)
+        r = WorldObject(name="eggs", auto_insert=False)
+        s = w.getStructureSerial()
+        self.assertNotEqual(s, q.getStructureSerial())
+
+        w.addChild(q)
+        s2 = w.getStructureSerial()
+        self.assertNotEqual(s, s2)
+        q.addChild(r)
+        self.assertNotEqual(s2, w.getStructureSerial())
+        self.assertEqual(w.getStructureSerial(), q.getStructureSerial())
+
+        s = w.getStructureSerial()
+        r.geom = SphereGeom()
+        self.assertNotEqual(s, w.getStructureSerial())
+        s = w.getStructureSerial()
+        r.setMaterial(GLMaterial())
+        self.assertNotEqual(s, w.getStructureSerial())
+
+        # Changing a transform is not a structural change
+        s = w.getStructureSerial()
+        r.pos = vec3(1,2,3)
+        self.assertEqual(s, w.getStructureSerial())
+
+        q.removeChild(r)
+        self.assertNotEqual(s, w.getStructureSerial())
+
+    def testChildOrder(self):
+        w = WorldObject(auto_insert=False)
+        for name in ["c", "a", "b"]:
+            w.addChild(WorldObject(name=name, auto_insert=False))
+        self.assertEqual(map(lambda x: x.name, w.iterChilds()), ["c", "a", "b"])
+        w.child("a").name = "d"
+        self.assertEqual(map(lambda x: x.name, w.iterChilds()), ["c", "d", "b"])
+        w.removeChild("c")
+        self.assertEqual(map(lambda x: x.name, w.iterChilds()), ["d", "b"])
+        self.assertEqual(w.lenChilds(), 2)
+        self.assertRaises(KeyError, lambda: w.child("c"))
+
+    def testUniqueNames(self):
+        w = WorldObject(auto_insert=False)
+        for i in range(100):
+            w.addChild(WorldObject(name=w.makeChildNameUnique("Box"), auto_insert=False))
+        self.assert_(w.hasChild("Box"))
+        self.assert_(w.hasChild("Box99"))
+        self.assertEqual(w.makeChildNameUnique("Box"), "Box100")
+        self.assertEqual(w.makeChildNameUnique("Box50"), "Box100")
+        self.assertEqual(w.makeChildNameUnique("Spam"), "Spam")
+
+        # Removed names are used again
+        w.removeChild("Box42")
+        self.assertEqual(w.makeChildNameUnique("Box"), "Box42")
+        w.child("Box7").name = "Spam"
+        self.assertEqual(w.makeChildNameUnique("Box"), "Box7")
+        self.assertEqual(w.makeChildNameUnique("Box10"), "Box42")
+
+    def testWorldTransformPropagation(self):
+        # Create a chain root -> o0 -> o1 -> ... -> o4
+        root = WorldObject(name="root", auto_insert=False)
+        objs = []
+        parent = root
+        for i in range(5):
+            parent = WorldObject(name="o%d"%i, parent=parent, auto_insert=False)
+            objs.append(parent)
+        leaf = objs[-1]
+        self.assertEqual(leaf.worldtransform.getColumn(3), vec4(0,0,0,1))
+        # Change the grandparent of the leaf after the first evaluation...
+        objs[2].pos = vec3(5,0,0)
+        self.assertEqual(leaf.worldtransform.getColumn(3), vec4(5,0,0,1))
+        # ...then the root...
+        root.pos = vec3(2,0,0)
+        self.assertEqual(leaf.worldtransform.getColumn(3), vec4(7,0,0,1))
+        self.assertEqual(objs[1].worldtransform.getColumn(3), vec4(2,0,0,1))
+        # ...and the position of an object in the middle
+        objs[3].pos = vec3(0,1,0)
+        self.assertEqual(leaf.worldtransform.getColumn(3), vec4(7,1,0,1))
+
 class TestComparison(unittest.TestCase):
 
     def testComparison(self):
@@ -0,0 +1,216 @@
+#!/usr/bin/env python
+# ***** BEGIN LICENSE BLOCK *****
+# Version: MPL 1.1/GPL 2.0/LGPL 2.1
+#
+# The contents of this file are subject to the Mozilla Public License Version
+# 1.1 (the "License"); you may not use this file except in compliance with
+# the License. You may obtain a copy of the License at
+# http://www.mozilla.org/MPL/
+#
+# Software distributed under the License is distributed on an "AS IS" basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Original Code is the Python Computer Graphics Kit.
+#
+# The Initial Developer of the Original Code is Matthias Baas.
+# Portions created by the Initial Developer are Copyright (C) 2004
+# the Initial Developer. All Rights Reserved.
+#
+# Contributor(s):
+#
+# Alternatively, the contents of this file may be used under the terms of
+# either the GNU General Public License Version 2 or later (the "GPL"), or
+# the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+# in which case the provisions of the GPL or the LGPL are applicable instead
+# of those above. If you wish to allow use of your version of this file only
+# under the terms of either the GPL or the LGPL, and not to allow others to
+# use your version of this file under the terms of the MPL, indicate your
+# decision by deleting the provisions above and replace them with the notice
+# and other provisions required by the GPL or the LGPL. If you do not delete
+# the provisions above, a recipient may use your version of this file under
+# the terms of any one of the MPL, the GPL or the LGPL.
+#
+# ***** END LICENSE BLOCK *****
+
+######################################################################
+# Benchmark the OpenGL renderer using an offscreen context.
+#
+# Usage: glbench [options]
+#
+# The scenes consist of a grid of objects that all share the same
+# geom. Two series of scenes are rendered for every geom type (i.e.
+# for every drawGL() path): one with a growing number of triangles
+# and one with a growing number of objects.
+# cgkit must have been compiled with the OFFSCREEN_GL option.
+######################################################################
+
+import sys, time, math, optparse
+from cgkit.all import *
+from cgkit.offscreenrenderer import OffscreenRenderer
+
+# The geom types that can be benchmarked
+PATHS = ["trimesh", "polyhedron", "sphere", "drawgeom"]
+# Total number of triangles in the triangle series
+TRIANGLE_SIZES = [1000, 10000, 100000, 1000000]
+# Number of objects in the triangle series
+TRIANGLE_OBJECTS = 100
+# Number of objects in the object series
+OBJECT_SIZES = [10, 100, 1000, 10000, 100000]
+# Number of triangles per object in the object series
+OBJECT_TRIANGLES = 32
+
+# sphereSegments
+def sphereSegments(numtris):
+    """Return the sphere segments that produce about numtris triangles.
+    """
+    segsu = max(3, int(round(math.sqrt(numtris))))
+    segsv = max(2, int(round(numtris/(2.0*segsu)))+1)
+    return segsu, segsv
+
+# createGeom
+def createGeom(path, numtris):
+    """Create a geom that has about numtris triangles.
+
+    Returns the geom and its actual number of triangles.
+    """
+    segsu, segsv = sphereSegments(numtris)
+    sphere = SphereGeom(radius=1.0, segmentsu=segsu, segmentsv=segsv)
+    tm = TriMeshGeom()
+    sphere.convert(tm)
+    numfaces = tm.faces.size()
+    if path=="trimesh":
+        return tm, numfaces
+    elif path=="polyhedron":
+        geom = PolyhedronGeom()
+        geom.verts.resize(tm.verts.size())
+        tm.verts.copyValues(0, tm.verts.size(), geom.verts, 0)
+        geom.setNumPolys(numfaces)
+        for i in range(numfaces):
+            geom.setPoly(i, [tm.faces[i]])
+        return geom, numfaces
+    elif path=="sphere":
+        return sphere, numfaces
+    else:
+        raise ValueError, 'Unknown geom type: "%s"'%path
+
+# createScene
+def createScene(path, numobjs, numtris):
+    """Create a benchmark scene and return the camera and triangle count.
+
+    numtris is the number of triangles per object.
+    """
+    scene = getScene()
+    scene.clear()
+    n = int(math.ceil(math.sqrt(numobjs)))
+    spacing = 3.0
+    offset = 0.5*spacing*(n-1)
+    materials = [GLMaterial(diffuse=(1,0.2,0.2,1)),
+                 GLMaterial(diffuse=(0.2,1,0.2,1)),
+                 GLMaterial(diffuse=(0.2,0.2,1,1)),
+                 GLMaterial(diffuse=(1,1,0.2,1))]
+    if path=="drawgeom":
+        # All objects are markers of one DrawGeom
+        segsu, segsv = sphereSegments(numtris)
+        tm = TriMeshGeom()
+        SphereGeom(segmentsu=segsu, segmentsv=segsv).convert(tm)
+        totaltris = numobjs*tm.faces.size()
+        geom = DrawGeom()
+        for i in range(numobjs):
+            p = vec3(spacing*(i%n)-offset, spacing*(i/n)-offset, 0)
+            geom.marker(p, (1,1,1), 1.0)
+        obj = WorldObject(name="markers")
+        obj.geom = geom
+    else:
+        geom, tris = createGeom(path, numtris)
+        totaltris = numobjs*tris
+        for i in range(numobjs):
+            obj = WorldObject(name="obj%d"%i,
+                              pos=(spacing*(i%n)-offset, spacing*(i/n)-offset, 0),
+                              material=materials[i%len(materials)])
+            obj.geom = geom
+    GLPointLight(pos=(0,0,spacing*n))
+    GLTargetDistantLight(pos=(1,1,1), target=(0,0,0), intensity=0.5)
+    dist = spacing*n*1.3+5.0
+    cam = TargetCamera(pos=(0,0,dist), target=(0,0,0), fov=45)
+    return cam, totaltris
+
+# benchmark
+def benchmark(osr, path, numobjs, numtris, options):
+    """Render one scene and return the result tuple.
+    """
+    t0 = time.time()
+    cam, totaltris = createScene(path, numobjs, numtris)
+    t1 = time.time()
+    # The first frame builds the draw list and the geom caches...
+    osr.render(cam)
+    t2 = time.time()
+    for i in range(options.frames):
+        osr.render(cam)
+    t3 = time.time()
+    frametime = (t3-t2)/options.frames
+    return (path, numobjs, totaltris, t1-t0, t2-t1, frametime)
+
+######################################################################
+
+parser = optparse.OptionParser(usage="%prog [options]")
+parser.add_option("-W", "--width", type="int", default=640,
+                  help="Image width")
+parser.add_option("-H", "--height", type="int", default=480,
+                  help="Image height")
+parser.add_option("-f", "--frames", type="int", default=10,
+                  help="Number of frames that are timed per scene")
+parser.add_option("-p", "--paths", default=",".join(PATHS),
+                  help="Comma separated list of the geom types to benchmark (%s)"%(", ".join(PATHS)))
+parser.add_option("-t", "--max-triangles", type="int", default=TRIANGLE_SIZES[-1],
+                  help="Maximum number of triangles in the triangle series")
+parser.add_option("-o", "--max-objects", type="int", default=OBJECT_SIZES[-1],
+                  help="Maximum number of objects in the object series")
+parser.add_option("-c", "--csv", metavar="FILE", default=None,
+                  help="Write the results into a CSV file")
+parser.add_option("-i", "--image", metavar="PREFIX", default=None,
+                  help="Save the last frame of every scene as PREFIX_<path>_<objs>_<tris>.png")
+options, args = parser.parse_args()
+
+paths = options.paths.split(",")
+for path in paths:
+    if path not in PATHS:
+        print 'Unknown geom type: "%s"'%path
+        sys.exit(1)
+
+osr = OffscreenRenderer(options.width, options.height)
+print "Backend : %s (%s)"%(osr.context.getBackend(), osr.context.getRenderer())
+print "Size    : %dx%d, %d frames per scene"%(options.width, options.height, options.frames)
+print
+print "%-10s %8s %9s %9s %10s %10s %8s"%("Geom", "Objects", "Tris", "Build[s]", "First[ms]", "Frame[ms]", "FPS")
+print 70*"-"
+
+results = []
+for path in paths:
+    # Growing number of triangles (the DrawGeom has no triangle series)
+    series = []
+    if path!="drawgeom":
+        for tris in TRIANGLE_SIZES:
+            if tris<=options.max_triangles:
+                series.append((TRIANGLE_OBJECTS, tris/TRIANGLE_OBJECTS))
+    # Growing number of objects
+    for objs in OBJECT_SIZES:
+        if objs<=options.max_objects:
+            series.append((objs, OBJECT_TRIANGLES))
+
+    for numobjs, numtris in series:
+        res = benchmark(osr, path, numobjs, numtris, options)
+        results.append(res)
+        path, objs, tris, build, first, frame = res
+        print "%-10s %8d %9d %9.2f %10.1f %10.2f %8.1f"%(path, objs, tris, build, 1000*first, 1000*frame, 1.0/max(frame, 1E-9))
+        sys.stdout.flush()
+        if options.image!=None:
+            osr.toImage().save("%s_%s_%d_%d.png"%(options.image, path, objs, tris))
+
+if options.csv!=None:
+    f = open(options.csv, "wt")
+    print >>f, "geom,objects,triangles,build_s,first_frame_ms,frame_ms,fps"
+    for path, objs, tris, build, first, frame in results:
+        print >>f, "%s,%d,%d,%f,%f,%f,%f"%(path, objs, tris, build, 1000*first, 1000*frame, 1.0/max(frame, 1E-9))
+    f.close()
@@ -0,0 +1,150 @@
+# ***** BEGIN LICENSE BLOCK *****
+# Version: MPL 1.1/GPL 2.0/LGPL 2.1
+#
+# The contents of this file are subject to the Mozilla Public License Version
+# 1.1 (the "License"); you may not use this file except in compliance with
+# the License. You may obtain a copy of the License at
+# http://www.mozilla.org/MPL/
+#
+# Software distributed under the License is distributed on an "AS IS" basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Original Code is the Python Computer Graphics Kit.
+#
+# The Initial Developer of the Original Code is Matthias Baas.
+# Portions created by the Initial Developer are Copyright (C) 2004
+# the Initial Developer. All Rights Reserved.
+#
+# Contributor(s):
+#
+# Alternatively, the contents of this file may be used under the terms of
+# either the GNU General Public License Version 2 or later (the "GPL"), or
+# the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+# in which case the provisions of the GPL or the LGPL are applicable instead
+# of those above. If you wish to allow use of your version of this file only
+# under the terms of either the GPL or the LGPL, and not to allow others to
+# use your version of this file under the terms of the MPL, indicate your
+# decision by deleting the provisions above and replace them with the notice
+# and other provisions required by the GPL or the LGPL. If you do not delete
+# the provisions above, a recipient may use your version of this file under
+# the terms of any one of the MPL, the GPL or the LGPL.
+#
+# ***** END LICENSE BLOCK *****
+
+######################################################################
+# Benchmark the scene hierarchy operations.
+#
+# Usage: scenebench [options]
+#
+# Builds a scene with a large number of world objects (1 million by
+# default) and times the creation of the objects, the traversal of the
+# hierarchy, looking up children by name and clearing the scene.
+# The objects are distributed over groups and all objects inside a
+# group have the same initial name, so every insertion has to create
+# a unique name ("Box", "Box1", "Box2", ...).
+######################################################################
+
+import sys, time, random, optparse
+from cgkit.all import *
+
+# buildScene
+def buildScene(numobjs, fanout):
+    """Create numobjs objects below the world root.
+
+    If fanout is 0 all objects are direct children of the world root,
+    otherwise they are put into groups of fanout objects.
+    Returns the list of groups (the world root if fanout is 0).
+    """
+    root = getScene().worldRoot()
+    if fanout<=0:
+        groups = [root]
+        fanout = numobjs
+    else:
+        numgroups = (numobjs+fanout-1)/fanout
+        groups = []
+        for i in range(numgroups):
+            groups.append(WorldObject(name="Group", parent=root))
+    n = numobjs
+    for group in groups:
+        for i in range(min(fanout, n)):
+            WorldObject(name="Box", parent=group)
+        n -= fanout
+    return groups
+
+# traverse
+def traverse(obj):
+    """Visit all objects below obj and return their number.
+    """
+    res = 0
+    for child in obj.iterChilds():
+        res += 1+traverse(child)
+    return res
+
+# lookup
+def lookup(groups, numlookups):
+    """Look up random children by name.
+    """
+    names = []
+    for i in range(numlookups):
+        group = random.choice(groups)
+        k = random.randrange(group.lenChilds())
+        if k==0:
+            names.append((group, "Box"))
+        else:
+            names.append((group, "Box%d"%k))
+    t0 = time.time()
+    for group, name in names:
+        group.child(name)
+    return time.time()-t0
+
+######################################################################
+
+parser = optparse.OptionParser(usage="%prog [options]")
+parser.add_option("-n", "--objects", type="int", default=1000000,
+                  help="Number of objects")
+parser.add_option("-f", "--fanout", type="int", default=1000,
+                  help="Number of objects per group (0 puts all objects directly below the world root)")
+parser.add_option("-l", "--lookups", type="int", default=100000,
+                  help="Number of name lookups")
+parser.add_option("-c", "--csv", metavar="FILE", default=None,
+                  help="Write the results into a CSV file")
+options, args = parser.parse_args()
+
+random.seed(1)
+scene = getScene()
+
+print "Objects : %d"%options.objects
+print "Fanout  : %d"%options.fanout
+print
+print "%-10s %10s %12s"%("Phase", "Time[s]", "us/item")
+print 34*"-"
+
+results = []
+def report(phase, t, items):
+    results.append((phase, items, t))
+    print "%-10s %10.2f %12.2f"%(phase, t, 1E6*t/max(items,1))
+    sys.stdout.flush()
+
+t0 = time.time()
+groups = buildScene(options.objects, options.fanout)
+report("build", time.time()-t0, options.objects)
+
+t0 = time.time()
+n = traverse(scene.worldRoot())
+report("traverse", time.time()-t0, n)
+
+report("lookup", lookup(groups, options.lookups), options.lookups)
+
+groups = None
+t0 = time.time()
+scene.clear()
+report("clear", time.time()-t0, n)
+
+if options.csv!=None:
+    f = open(options.csv, "wt")
+    print >>f, "phase,items,time_s,us_per_item"
+    for phase, items, t in results:
+        print >>f, "%s,%d,%f,%f"%(phase, items, t, 1E6*t/max(items,1))
+    f.close()
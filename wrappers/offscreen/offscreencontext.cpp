@@ -0,0 +1,205 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+/** \file offscreencontext.cpp
+ Contains the OffscreenGLContext class.
+ */
+
+#include "offscreencontext.h"
+#include "common_exceptions.h"
+#include "opengl.h"
+#include <cstring>
+#include <vector>
+
+#ifndef OFFSCREEN_OSMESA
+#include <EGL/eglext.h>
+#endif
+
+namespace support3d {
+
+/**
+  Create an offscreen context and make it current.
+
+  \param awidth Width of the buffer
+  \param aheight Height of the buffer
+ */
+OffscreenGLContext::OffscreenGLContext(int awidth, int aheight)
+  : width(awidth), height(aheight)
+{
+  if (width<1 || height<1)
+    throw EValueError("The size of the offscreen buffer must be positive.");
+
+#ifdef OFFSCREEN_OSMESA
+  context = OSMesaCreateContextExt(OSMESA_RGBA, 24, 0, 0, NULL);
+  if (context==NULL)
+    throw ERuntimeError("Could not create an OSMesa context.");
+  buffer.resize(4*width*height);
+#else
+  // Prefer the surfaceless platform (no X server required)...
+  display = EGL_NO_DISPLAY;
+  surface = EGL_NO_SURFACE;
+  context = EGL_NO_CONTEXT;
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+  PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+  if (getPlatformDisplay!=0)
+    display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+#endif
+  if (display==EGL_NO_DISPLAY)
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  EGLint major, minor;
+  if (display==EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    throw ERuntimeError("Could not initialize EGL.");
+
+  EGLint configattrs[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                          EGL_RED_SIZE, 8,
+                          EGL_GREEN_SIZE, 8,
+                          EGL_BLUE_SIZE, 8,
+                          EGL_ALPHA_SIZE, 8,
+                          EGL_DEPTH_SIZE, 24,
+                          EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                          EGL_NONE};
+  EGLConfig config;
+  EGLint numconfigs = 0;
+  if (!eglChooseConfig(display, configattrs, &config, 1, &numconfigs) || numconfigs==0)
+  {
+    eglTerminate(display);
+    throw ERuntimeError("No suitable EGL configuration available.");
+  }
+
+  EGLint pbufferattrs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+  surface = eglCreatePbufferSurface(display, config, pbufferattrs);
+  eglBindAPI(EGL_OPENGL_API);
+  context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+  if (surface==EGL_NO_SURFACE || context==EGL_NO_CONTEXT)
+  {
+    if (context!=EGL_NO_CONTEXT)
+      eglDestroyContext(display, context);
+    if (surface!=EGL_NO_SURFACE)
+      eglDestroySurface(display, surface);
+    eglTerminate(display);
+    throw ERuntimeError("Could not create the EGL context.");
+  }
+#endif
+
+  makeCurrent();
+  glViewport(0, 0, width, height);
+}
+
+OffscreenGLContext::~OffscreenGLContext()
+{
+#ifdef OFFSCREEN_OSMESA
+  OSMesaDestroyContext(context);
+#else
+  eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglDestroyContext(display, context);
+  eglDestroySurface(display, surface);
+  eglTerminate(display);
+#endif
+}
+
+/**
+  Make this context the current OpenGL context.
+ */
+void OffscreenGLContext::makeCurrent()
+{
+#ifdef OFFSCREEN_OSMESA
+  if (!OSMesaMakeCurrent(context, &buffer[0], GL_UNSIGNED_BYTE, width, height))
+    throw ERuntimeError("Could not make the OSMesa context current.");
+#else
+  if (!eglMakeCurrent(display, surface, surface, context))
+    throw ERuntimeError("Could not make the EGL context current.");
+#endif
+}
+
+/**
+  Wait until all pending OpenGL commands have been executed.
+
+  This has to be called before the time of a frame is taken.
+ */
+void OffscreenGLContext::finish()
+{
+  glFinish();
+}
+
+/**
+  Return the name of the backend ("egl" or "osmesa").
+ */
+std::string OffscreenGLContext::getBackend() const
+{
+#ifdef OFFSCREEN_OSMESA
+  return "osmesa";
+#else
+  return "egl";
+#endif
+}
+
+/**
+  Return the OpenGL renderer string (e.g. "llvmpipe").
+ */
+std::string OffscreenGLContext::getRenderer() const
+{
+  const GLubyte* s = glGetString(GL_RENDERER);
+  if (s==0)
+    return "";
+  return std::string((const char*)s);
+}
+
+/**
+  Read the content of the color buffer.
+
+  \param dest Receives width*height RGBA values (8 bit per channel)
+  \param topdown If true, the first row is the top row of the image, otherwise the bottom row
+ */
+void OffscreenGLContext::readPixels(unsigned char* dest, bool topdown)
+{
+  int rowsize = 4*width;
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, dest);
+  // OpenGL returns the bottom row first
+  if (topdown)
+  {
+    std::vector<unsigned char> row(rowsize);
+    for(int y=0; y<height/2; y++)
+    {
+      unsigned char* a = dest+y*rowsize;
+      unsigned char* b = dest+(height-1-y)*rowsize;
+      memcpy(&row[0], a, rowsize);
+      memcpy(a, b, rowsize);
+      memcpy(b, &row[0], rowsize);
+    }
+  }
+}
+
+}  // end of namespace
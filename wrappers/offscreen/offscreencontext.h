@@ -0,0 +1,103 @@
+/* ***** BEGIN LICENSE BLOCK *****
+ * Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ * http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Original Code is the Python Computer Graphics Kit.
+ *
+ * The Initial Developer of the Original Code is Matthias Baas.
+ * Portions created by the Initial Developer are Copyright (C) 2004
+ * the Initial Developer. All Rights Reserved.
+ *
+ * Contributor(s):
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPL"), or
+ * the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+ * in which case the provisions of the GPL or the LGPL are applicable instead
+ * of those above. If you wish to allow use of your version of this file only
+ * under the terms of either the GPL or the LGPL, and not to allow others to
+ * use your version of this file under the terms of the MPL, indicate your
+ * decision by deleting the provisions above and replace them with the notice
+ * and other provisions required by the GPL or the LGPL. If you do not delete
+ * the provisions above, a recipient may use your version of this file under
+ * the terms of any one of the MPL, the GPL or the LGPL.
+ *
+ * ***** END LICENSE BLOCK ***** */
+
+#ifndef OFFSCREENCONTEXT_H
+#define OFFSCREENCONTEXT_H
+
+/** \file offscreencontext.h
+ Contains the OffscreenGLContext class.
+ */
+
+#include <string>
+
+#ifdef OFFSCREEN_OSMESA
+#include <vector>
+#include <GL/osmesa.h>
+#else
+#include <EGL/egl.h>
+#endif
+
+namespace support3d {
+
+/**
+  An OpenGL context that renders into an offscreen buffer.
+
+  The context doesn't require a window or a display, so the OpenGL
+  renderer (GLRenderInstance) can be used on machines without a GPU
+  (e.g. for benchmarks, regression tests or previews). Depending on the
+  compile options the context is either created via EGL (using the
+  surfaceless platform of Mesa if available) or via OSMesa.
+  If OFFSCREEN_OSMESA is defined, OSMesa is used, otherwise EGL.
+
+  The context is made current by the constructor. After rendering,
+  readPixels() can be used to retrieve the image.
+ */
+class OffscreenGLContext
+{
+  protected:
+  int width;
+  int height;
+
+#ifdef OFFSCREEN_OSMESA
+  OSMesaContext context;
+  /// The color buffer that OSMesa renders into
+  std::vector<unsigned char> buffer;
+#else
+  EGLDisplay display;
+  EGLSurface surface;
+  EGLContext context;
+#endif
+
+  public:
+  OffscreenGLContext(int awidth, int aheight);
+  ~OffscreenGLContext();
+
+  void makeCurrent();
+  void finish();
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  std::string getBackend() const;
+  std::string getRenderer() const;
+  void readPixels(unsigned char* dest, bool topdown=true);
+
+  private:
+  // Contexts are not copyable
+  OffscreenGLContext(const OffscreenGLContext&);
+  OffscreenGLContext& operator=(const OffscreenGLContext&);
+};
+
+}  // end of namespace
+
+#endif
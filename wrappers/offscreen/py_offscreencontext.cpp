@@ -0,0 +1,59 @@
+/*
+  OffscreenGLContext wrapper
+ */
+
+#include <vector>
+#include <boost/python.hpp>
+#include "offscreencontext.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+// getResolution wrapper
+static tuple getResolution(OffscreenGLContext* self)
+{
+  return make_tuple(self->getWidth(), self->getHeight());
+}
+
+// readPixels wrapper
+static object readPixels(OffscreenGLContext* self, bool topdown)
+{
+  int size = 4*self->getWidth()*self->getHeight();
+  std::vector<unsigned char> buf(size);
+  self->readPixels(&buf[0], topdown);
+  PyObject* s = PyString_FromStringAndSize((const char*)&buf[0], size);
+  return object(handle<>(s));
+}
+
+
+void class_OffscreenGLContext()
+{
+  class_<OffscreenGLContext, boost::noncopyable>("OffscreenGLContext", 
+    init<int, int>((arg("width"), arg("height"))))
+
+    .def("makeCurrent", &OffscreenGLContext::makeCurrent,
+	 "makeCurrent()\n\n"
+	 "Make this context the current OpenGL context.")
+
+    .def("finish", &OffscreenGLContext::finish,
+	 "finish()\n\n"
+	 "Wait until all pending OpenGL commands have been executed.")
+
+    .def("getResolution", getResolution,
+	 "getResolution() -> (width, height)\n\n"
+	 "Return the size of the offscreen buffer.")
+
+    .def("getBackend", &OffscreenGLContext::getBackend,
+	 "getBackend() -> str\n\n"
+	 "Return the name of the backend (\"egl\" or \"osmesa\").")
+
+    .def("getRenderer", &OffscreenGLContext::getRenderer,
+	 "getRenderer() -> str\n\n"
+	 "Return the OpenGL renderer string.")
+
+    .def("readPixels", readPixels, (arg("topdown")=true),
+	 "readPixels(topdown=True) -> str\n\n"
+	 "Return the content of the color buffer as a string of 8 bit RGBA\n"
+	 "values. If topdown is True the first row is the top row of the image.")
+  ;
+}
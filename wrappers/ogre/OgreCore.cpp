@@ -501,7 +501,7 @@ void OgreCore::buildTree(support3d::WorldObject& VisumRoot, SceneNode *snode)
     	DEBUGOUT( "Calling buildTree with scene node at", snode );
 
 	// Recursive exit condition: there are no children
-	if (childit->second.get() == 0)
+	if (childit == VisumRoot.childsEnd())
 	{
 		return;
 	}	
@@ -479,7 +479,7 @@ void OsgCore::buildTree(support3d::WorldObject& visumRoot, osg::MatrixTransform
 	support3d::WorldObject::ChildIterator childit = visumRoot.childsBegin();
 
 	// Recursive exit condition: there are no children
-	if (childit->second.get() == 0)
+	if (childit == visumRoot.childsEnd())
 	{
 		std::cout << "no VISUM CHILDS left" << std::endl;
 		return;
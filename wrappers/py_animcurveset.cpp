@@ -0,0 +1,363 @@
+/*
+ AnimCurveSet component
+ */
+
+#include <boost/python.hpp>
+#include <vector>
+#include "animcurveset.h"
+#include "mocapparser.h"
+#include "common_exceptions.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+// Convert an interpolation name into the interpolation mode
+static AnimCurve::Interpolation toInterpolation(const std::string& s)
+{
+  if (s=="step")
+    return AnimCurve::STEP;
+  else if (s=="linear")
+    return AnimCurve::LINEAR;
+  else if (s=="hermite")
+    return AnimCurve::HERMITE;
+  throw EValueError("Unknown interpolation: \""+s+"\" (must be \"step\", \"linear\" or \"hermite\").");
+}
+
+// Convert a sequence of floats into a vector
+static void toDoubleVector(object seq, std::vector<double>& res)
+{
+  int n = len(seq);
+  res.resize(n);
+  for(int i=0; i<n; i++)
+    res[i] = extract<double>(seq[i]);
+}
+
+// Convert a quat or mat3 into a quat
+static quatd toQuat(object q)
+{
+  extract<quatd> eq(q);
+  if (eq.check())
+    return eq();
+  quatd res;
+  res.fromMat(extract<mat3d>(q)());
+  return res;
+}
+
+// Convert a sequence of quats/mat3s into a vector
+static void toQuatVector(object seq, std::vector<quatd>& res)
+{
+  int n = len(seq);
+  res.resize(n);
+  for(int i=0; i<n; i++)
+    res[i] = toQuat(seq[i]);
+}
+
+static int addChannel(AnimCurveSet* self, const std::string& name, const std::string& type)
+{
+  if (type=="double")
+    return self->addChannel(name, AnimCurveSet::DOUBLE_CHANNEL);
+  else if (type=="vec3")
+    return self->addChannel(name, AnimCurveSet::VEC3_CHANNEL);
+  else if (type=="quat")
+    return self->addChannel(name, AnimCurveSet::QUAT_CHANNEL);
+  else if (type=="mat3")
+    return self->addChannel(name, AnimCurveSet::MAT3_CHANNEL);
+  throw EValueError("Unknown channel type: \""+type+"\" (must be \"double\", \"vec3\", \"quat\" or \"mat3\").");
+}
+
+static std::string getChannelType(AnimCurveSet* self, int idx)
+{
+  switch(self->getChannelType(idx))
+  {
+  case AnimCurveSet::DOUBLE_CHANNEL: return "double";
+  case AnimCurveSet::VEC3_CHANNEL: return "vec3";
+  case AnimCurveSet::QUAT_CHANNEL: return "quat";
+  default: return "mat3";
+  }
+}
+
+// Scalar curves
+
+static void setKeys(AnimCurveSet* self, int curve, object times, object values, const std::string& ip)
+{
+  std::vector<double> t, v;
+  toDoubleVector(times, t);
+  toDoubleVector(values, v);
+  if (t.size()!=v.size())
+    throw EValueError("The number of times and values must match.");
+  self->curve(curve).setKeys(int(t.size()), t.empty()? 0 : &t[0], v.empty()? 0 : &v[0], 1, toInterpolation(ip));
+  self->curvesChanged();
+}
+
+static void setSampledKeys(AnimCurveSet* self, int curve, double t0, double dt, object values, const std::string& ip)
+{
+  std::vector<double> v;
+  toDoubleVector(values, v);
+  self->curve(curve).setSampledKeys(t0, dt, int(v.size()), v.empty()? 0 : &v[0], 1, toInterpolation(ip));
+  self->curvesChanged();
+}
+
+static int insertKey(AnimCurveSet* self, int curve, double t, double v, const std::string& ip)
+{
+  int res = self->curve(curve).insertKey(t, v, toInterpolation(ip));
+  self->curvesChanged();
+  return res;
+}
+
+static void removeKey(AnimCurveSet* self, int curve, int idx)
+{
+  self->curve(curve).removeKey(idx);
+  self->curvesChanged();
+}
+
+static void setTangents(AnimCurveSet* self, int curve, int idx, double intangent, double outtangent)
+{
+  self->curve(curve).setTangents(idx, intangent, outtangent);
+  self->curvesChanged();
+}
+
+static void setBezierControls(AnimCurveSet* self, int curve, int idx, double c1, double c2)
+{
+  self->curve(curve).setBezierControls(idx, c1, c2);
+  self->curvesChanged();
+}
+
+static int numKeys(AnimCurveSet* self, int curve)
+{
+  return self->curve(curve).numKeys();
+}
+
+static tuple getKey(AnimCurveSet* self, int curve, int idx)
+{
+  AnimCurve& c = self->curve(curve);
+  return make_tuple(c.getTime(idx), c.getValue(idx));
+}
+
+static tuple getTangents(AnimCurveSet* self, int curve, int idx)
+{
+  AnimCurve& c = self->curve(curve);
+  return make_tuple(c.getInTangent(idx), c.getOutTangent(idx));
+}
+
+static double evalCurve(AnimCurveSet* self, int curve, double t)
+{
+  return self->curve(curve).eval(t);
+}
+
+// Quaternion curves
+
+static void setQuatKeys(AnimCurveSet* self, int curve, object times, object values, const std::string& ip)
+{
+  std::vector<double> t;
+  std::vector<quatd> q;
+  toDoubleVector(times, t);
+  toQuatVector(values, q);
+  if (t.size()!=q.size())
+    throw EValueError("The number of times and values must match.");
+  self->quatCurve(curve).setKeys(int(t.size()), t.empty()? 0 : &t[0], q.empty()? 0 : &q[0], toInterpolation(ip));
+  self->curvesChanged();
+}
+
+static void setSampledQuatKeys(AnimCurveSet* self, int curve, double t0, double dt, object values, const std::string& ip)
+{
+  std::vector<quatd> q;
+  toQuatVector(values, q);
+  self->quatCurve(curve).setSampledKeys(t0, dt, int(q.size()), q.empty()? 0 : &q[0], toInterpolation(ip));
+  self->curvesChanged();
+}
+
+// Motion data
+
+static void setMotionKeys(AnimCurveSet* self, int curve, const MotionData& motion, int channel, double t0, double dt, double scale, const std::string& ip)
+{
+  motion.setCurveKeys(channel, self->curve(curve), t0, dt, scale, toInterpolation(ip));
+  self->curvesChanged();
+}
+
+static void setMotionQuatKeys(AnimCurveSet* self, int curve, const MotionData& motion, object channels, const std::string& order, double t0, double dt, double scale, const std::string& ip)
+{
+  if (len(channels)!=3)
+    throw EValueError("Three channel indices expected.");
+  int ch[3];
+  for(int i=0; i<3; i++)
+    ch[i] = extract<int>(channels[i]);
+  motion.setQuatCurveKeys(ch, order, self->quatCurve(curve), t0, dt, scale, toInterpolation(ip));
+  self->curvesChanged();
+}
+
+static int insertQuatKey(AnimCurveSet* self, int curve, double t, object q, const std::string& ip)
+{
+  int res = self->quatCurve(curve).insertKey(t, toQuat(q), toInterpolation(ip));
+  self->curvesChanged();
+  return res;
+}
+
+static void removeQuatKey(AnimCurveSet* self, int curve, int idx)
+{
+  self->quatCurve(curve).removeKey(idx);
+  self->curvesChanged();
+}
+
+static int numQuatKeys(AnimCurveSet* self, int curve)
+{
+  return self->quatCurve(curve).numKeys();
+}
+
+static tuple getQuatKey(AnimCurveSet* self, int curve, int idx)
+{
+  QuatAnimCurve& c = self->quatCurve(curve);
+  return make_tuple(c.getTime(idx), c.getValue(idx));
+}
+
+static quatd evalQuatCurve(AnimCurveSet* self, int curve, double t)
+{
+  return self->quatCurve(curve).eval(t);
+}
+
+// Evaluate all curves
+static tuple evaluate(AnimCurveSet* self, double t)
+{
+  std::vector<double> values(self->numCurves());
+  std::vector<quatd> quats(self->numQuatCurves());
+  self->evaluate(t, values.empty()? 0 : &values[0], quats.empty()? 0 : &quats[0]);
+  list vl, ql;
+  for(unsigned int i=0; i<values.size(); i++)
+    vl.append(values[i]);
+  for(unsigned int i=0; i<quats.size(); i++)
+    ql.append(quats[i]);
+  return make_tuple(vl, ql);
+}
+
+void class_AnimCurveSet()
+{
+  // Register the output slot types so that they can be used in Python
+  class_<AnimCurveSlot<double>, bases<Slot<double> >, boost::noncopyable>("AnimCurveSet_DoubleSlot", no_init);
+  class_<AnimCurveSlot<vec3d>, bases<Slot<vec3d> >, boost::noncopyable>("AnimCurveSet_Vec3Slot", no_init);
+  class_<AnimCurveSlot<quatd>, bases<Slot<quatd> >, boost::noncopyable>("AnimCurveSet_QuatSlot", no_init);
+  class_<AnimCurveSlot<mat3d>, bases<Slot<mat3d> >, boost::noncopyable>("AnimCurveSet_Mat3Slot", no_init);
+
+  class_<AnimCurveSet, bases<Component>, boost::noncopyable>("AnimCurveSet",
+    "A set of keyframe curves that drive output slots.\n\n"
+    "The component stores scalar curves and quaternion curves which are\n"
+    "grouped into channels. Each channel has an output slot (named like the\n"
+    "channel) that holds the channel value at the time given by the time slot.\n"
+    "A \"double\" channel uses one scalar curve, a \"vec3\" channel uses three\n"
+    "consecutive scalar curves and a \"quat\" or \"mat3\" channel uses one\n"
+    "quaternion curve. All curves are evaluated at once when the first output\n"
+    "value is requested after the time has changed.\n\n"
+    "The interpolation mode of a key (\"step\", \"linear\" or \"hermite\")\n"
+    "determines how the segment that starts at the key is interpolated.\n"
+    "Quaternion curves use slerp for linear and hermite segments.",
+    init<optional<std::string> >())
+
+    .def_readonly("time_slot", &AnimCurveSet::time)
+    .add_property("modulo", &AnimCurveSet::getModulo, &AnimCurveSet::setModulo)
+    .add_property("tscale", &AnimCurveSet::getTScale, &AnimCurveSet::setTScale)
+
+    .def("addChannel", addChannel, (arg("name"), arg("type")="double"),
+         "addChannel(name, type=\"double\") -> int\n\n"
+         "Add a channel and create its output slot. type is one of \"double\",\n"
+         "\"vec3\", \"quat\" or \"mat3\". Returns the channel index.")
+    .def("numChannels", &AnimCurveSet::numChannels,
+         "numChannels() -> int\n\n"
+         "Return the number of channels.")
+    .def("findChannel", &AnimCurveSet::findChannel, arg("name"),
+         "findChannel(name) -> int\n\n"
+         "Return the index of a channel or -1 if there is no such channel.")
+    .def("channelName", &AnimCurveSet::getChannelName, arg("idx"), return_value_policy<copy_const_reference>(),
+         "channelName(idx) -> str\n\n"
+         "Return the name of a channel.")
+    .def("channelType", getChannelType, arg("idx"),
+         "channelType(idx) -> str\n\n"
+         "Return the type of a channel.")
+    .def("channelCurve", &AnimCurveSet::getChannelCurve, arg("idx"),
+         "channelCurve(idx) -> int\n\n"
+         "Return the index of the first curve of a channel. For quat and mat3\n"
+         "channels this is a quaternion curve index, otherwise a scalar curve\n"
+         "index.")
+    .def("numCurves", &AnimCurveSet::numCurves,
+         "numCurves() -> int\n\n"
+         "Return the number of scalar curves.")
+    .def("numQuatCurves", &AnimCurveSet::numQuatCurves,
+         "numQuatCurves() -> int\n\n"
+         "Return the number of quaternion curves.")
+    .def("localTime", &AnimCurveSet::localTime, arg("t"),
+         "localTime(t) -> float\n\n"
+         "Apply the time scale and the modulo value to a time.")
+    .def("evaluate", evaluate, arg("t"),
+         "evaluate(t) -> (values, quats)\n\n"
+         "Evaluate all curves at curve time t and return the values of the\n"
+         "scalar curves and of the quaternion curves.")
+
+    .def("setKeys", setKeys, (arg("curve"), arg("times"), arg("values"), arg("interpolation")="linear"),
+         "setKeys(curve, times, values, interpolation=\"linear\")\n\n"
+         "Replace all keys of a scalar curve. times must be in ascending order.\n"
+         "For hermite curves the tangents are initialized with Catmull-Rom slopes.")
+    .def("setSampledKeys", setSampledKeys, (arg("curve"), arg("t0"), arg("dt"), arg("values"), arg("interpolation")="linear"),
+         "setSampledKeys(curve, t0, dt, values, interpolation=\"linear\")\n\n"
+         "Replace all keys of a scalar curve with equally spaced keys starting\n"
+         "at time t0. Such curves are evaluated without searching for the key.")
+    .def("insertKey", insertKey, (arg("curve"), arg("t"), arg("value"), arg("interpolation")="linear"),
+         "insertKey(curve, t, value, interpolation=\"linear\") -> int\n\n"
+         "Insert a key into a scalar curve (an existing key at time t is\n"
+         "replaced) and return the key index.")
+    .def("removeKey", removeKey, (arg("curve"), arg("idx")),
+         "removeKey(curve, idx)\n\n"
+         "Remove a key from a scalar curve.")
+    .def("setTangents", setTangents, (arg("curve"), arg("idx"), arg("intangent"), arg("outtangent")),
+         "setTangents(curve, idx, intangent, outtangent)\n\n"
+         "Set the tangents (slopes) of a key.")
+    .def("getTangents", getTangents, (arg("curve"), arg("idx")),
+         "getTangents(curve, idx) -> (intangent, outtangent)\n\n"
+         "Return the tangents of a key.")
+    .def("setBezierControls", setBezierControls, (arg("curve"), arg("idx"), arg("c1"), arg("c2")),
+         "setBezierControls(curve, idx, c1, c2)\n\n"
+         "Turn the segment between key idx and idx+1 into a cubic Bezier segment\n"
+         "whose inner control points have the values c1 and c2 (and are located\n"
+         "at 1/3 and 2/3 of the segment duration).")
+    .def("numKeys", numKeys, arg("curve"),
+         "numKeys(curve) -> int\n\n"
+         "Return the number of keys of a scalar curve.")
+    .def("getKey", getKey, (arg("curve"), arg("idx")),
+         "getKey(curve, idx) -> (t, value)\n\n"
+         "Return a key of a scalar curve.")
+    .def("evalCurve", evalCurve, (arg("curve"), arg("t")),
+         "evalCurve(curve, t) -> float\n\n"
+         "Evaluate a scalar curve at curve time t.")
+
+    .def("setQuatKeys", setQuatKeys, (arg("curve"), arg("times"), arg("values"), arg("interpolation")="linear"),
+         "setQuatKeys(curve, times, values, interpolation=\"linear\")\n\n"
+         "Replace all keys of a quaternion curve. The values may be quats or\n"
+         "rotation matrices.")
+    .def("setSampledQuatKeys", setSampledQuatKeys, (arg("curve"), arg("t0"), arg("dt"), arg("values"), arg("interpolation")="linear"),
+         "setSampledQuatKeys(curve, t0, dt, values, interpolation=\"linear\")\n\n"
+         "Replace all keys of a quaternion curve with equally spaced keys.")
+    .def("insertQuatKey", insertQuatKey, (arg("curve"), arg("t"), arg("value"), arg("interpolation")="linear"),
+         "insertQuatKey(curve, t, value, interpolation=\"linear\") -> int\n\n"
+         "Insert a key into a quaternion curve and return the key index.")
+    .def("removeQuatKey", removeQuatKey, (arg("curve"), arg("idx")),
+         "removeQuatKey(curve, idx)\n\n"
+         "Remove a key from a quaternion curve.")
+    .def("numQuatKeys", numQuatKeys, arg("curve"),
+         "numQuatKeys(curve) -> int\n\n"
+         "Return the number of keys of a quaternion curve.")
+    .def("getQuatKey", getQuatKey, (arg("curve"), arg("idx")),
+         "getQuatKey(curve, idx) -> (t, quat)\n\n"
+         "Return a key of a quaternion curve.")
+    .def("evalQuatCurve", evalQuatCurve, (arg("curve"), arg("t")),
+         "evalQuatCurve(curve, t) -> quat\n\n"
+         "Evaluate a quaternion curve at curve time t.")
+
+    .def("setMotionKeys", setMotionKeys, (arg("curve"), arg("motion"), arg("channel"), arg("t0"), arg("dt"), arg("scale")=1.0, arg("interpolation")="linear"),
+         "setMotionKeys(curve, motion, channel, t0, dt, scale=1.0, interpolation=\"linear\")\n\n"
+         "Replace all keys of a scalar curve with the samples of a MotionData\n"
+         "channel (one key per frame). The samples are multiplied by scale.")
+    .def("setMotionQuatKeys", setMotionQuatKeys, (arg("curve"), arg("motion"), arg("channels"), arg("order"), arg("t0"), arg("dt"), arg("scale")=1.0, arg("interpolation")="linear"),
+         "setMotionQuatKeys(curve, motion, channels, order, t0, dt, scale=1.0, interpolation=\"linear\")\n\n"
+         "Replace all keys of a quaternion curve with rotations given by Euler\n"
+         "angles in a MotionData object. channels contains the channel indices\n"
+         "of the x, y and z angle (-1 for an angle that is always 0) and order\n"
+         "is the rotation order as used by the mat3.fromEuler*() methods. The\n"
+         "angles are multiplied by scale (use pi/180 for angles in degrees).")
+  ;
+}
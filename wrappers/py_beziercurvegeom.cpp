@@ -0,0 +1,164 @@
+/*
+ BezierCurveGeom
+ */
+
+#include <boost/python.hpp>
+#include <vector>
+#include "beziercurvegeom.h"
+#include "common_exceptions.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+// Convert a sequence of floats into a vector
+static void toDoubles(object seq, std::vector<double>& res)
+{
+  int n = len(seq);
+  res.resize(n);
+  for(int i=0; i<n; i++)
+    res[i] = extract<double>(seq[i]);
+}
+
+static tuple getParamInterval(BezierCurveGeom* self)
+{
+  return make_tuple(0, self->numSegs());
+}
+
+static list segCtrlPoints(BezierCurveGeom* self, int seg)
+{
+  if (self->pnts.size()==0)
+    throw EValueError("The curve has no points.");
+  vec3d b[4];
+  self->segCtrlPoints(seg, b);
+  list res;
+  for(int i=0; i<4; i++)
+    res.append(b[i]);
+  return res;
+}
+
+static tuple evalFrame(BezierCurveGeom* self, double t)
+{
+  vec3d p, dp, d2p;
+  self->evalFrame(t, p, dp, d2p);
+  return make_tuple(p, dp, d2p);
+}
+
+static list evalMany(BezierCurveGeom* self, object ts)
+{
+  std::vector<double> t;
+  toDoubles(ts, t);
+  std::vector<vec3d> p(t.size());
+  list res;
+  if (t.empty())
+    return res;
+  self->eval(&t[0], int(t.size()), &p[0]);
+  for(unsigned int i=0; i<p.size(); i++)
+    res.append(p[i]);
+  return res;
+}
+
+static list evalFrameMany(BezierCurveGeom* self, object ts)
+{
+  std::vector<double> t;
+  toDoubles(ts, t);
+  int n = int(t.size());
+  std::vector<vec3d> p(n), dp(n), d2p(n);
+  list res;
+  if (n==0)
+    return res;
+  self->evalFrame(&t[0], n, &p[0], &dp[0], &d2p[0]);
+  for(int i=0; i<n; i++)
+    res.append(make_tuple(p[i], dp[i], d2p[i]));
+  return res;
+}
+
+static list arcLenToParamMany(BezierCurveGeom* self, object ss)
+{
+  std::vector<double> s;
+  toDoubles(ss, s);
+  std::vector<double> t(s.size());
+  list res;
+  if (s.empty())
+    return res;
+  self->arcLenToParam(&s[0], int(s.size()), &t[0]);
+  for(unsigned int i=0; i<t.size(); i++)
+    res.append(t[i]);
+  return res;
+}
+
+static list flatten(BezierCurveGeom* self, double tol, int maxdepth)
+{
+  std::vector<vec3d> pnts;
+  self->flatten(tol, pnts, maxdepth);
+  list res;
+  for(unsigned int i=0; i<pnts.size(); i++)
+    res.append(pnts[i]);
+  return res;
+}
+
+vec3d (BezierCurveGeom::*eval_single)(double) = &BezierCurveGeom::eval;
+double (BezierCurveGeom::*arcLenToParam_single)(double) = &BezierCurveGeom::arcLenToParam;
+
+void class_BezierCurveGeom()
+{
+  class_<BezierCurveGeom, bases<GeomObject> >("BezierCurveGeom", 
+    "Cubic Bezier curve.\n\n"
+    "The curve passes through the points in pnts. The tangents are stored\n"
+    "relative to their point. The curve parameter runs from 0 to numsegs,\n"
+    "the integer part is the segment number.",
+    init<>())
+
+    .def_readonly("pnts_slot", &BezierCurveGeom::pnts)
+    .def_readonly("pnts", &BezierCurveGeom::pnts)
+    .def_readonly("intangents_slot", &BezierCurveGeom::intangents)
+    .def_readonly("intangents", &BezierCurveGeom::intangents)
+    .def_readonly("outtangents_slot", &BezierCurveGeom::outtangents)
+    .def_readonly("outtangents", &BezierCurveGeom::outtangents)
+
+    .def_readwrite("epsilon", &BezierCurveGeom::epsilon)
+    .def_readwrite("subdiv", &BezierCurveGeom::subdiv)
+    .def_readwrite("show_tangents", &BezierCurveGeom::show_tangents)
+
+    .add_property("closed", &BezierCurveGeom::isClosed, &BezierCurveGeom::setClosed)
+    .add_property("numsegs", &BezierCurveGeom::numSegs)
+    .add_property("paraminterval", &getParamInterval)
+
+    .def("segCtrlPoints", &segCtrlPoints, arg("seg"),
+         "segCtrlPoints(seg) -> list\n\n"
+         "Return the four control points of a segment. The segment numbering\n"
+         "is cyclic.")
+    .def("eval", eval_single, arg("t"),
+         "eval(t) -> vec3\n\n"
+         "Evaluate the curve at parameter t and return the curve point.")
+    .def("evalFrame", &evalFrame, arg("t"),
+         "evalFrame(t) -> (p, dp, d2p)\n\n"
+         "Evaluate the curve at parameter t and return the curve point and\n"
+         "its 1st and 2nd derivative.")
+    .def("deriv", &BezierCurveGeom::deriv, arg("t"),
+         "deriv(t) -> vec3\n\n"
+         "Return the 1st derivative at parameter t.")
+    .def("evalMany", &evalMany, arg("ts"),
+         "evalMany(ts) -> list\n\n"
+         "Evaluate the curve at a sequence of parameters.")
+    .def("evalFrameMany", &evalFrameMany, arg("ts"),
+         "evalFrameMany(ts) -> list\n\n"
+         "Return a list of (p, dp, d2p) tuples for a sequence of parameters.")
+    .def("arcLen", &BezierCurveGeom::arcLen, arg("t"),
+         "arcLen(t) -> float\n\n"
+         "Return the arc length from the start of the curve up to parameter t.")
+    .def("length", &BezierCurveGeom::length,
+         "length() -> float\n\n"
+         "Return the length of the entire curve.")
+    .def("arcLenToParam", arcLenToParam_single, arg("s"),
+         "arcLenToParam(s) -> float\n\n"
+         "Return the curve parameter where the arc length reaches s (the\n"
+         "inverse of arcLen()).")
+    .def("arcLenToParamMany", &arcLenToParamMany, arg("ss"),
+         "arcLenToParamMany(ss) -> list\n\n"
+         "Convert a sequence of arc length values into curve parameters.")
+    .def("flatten", &flatten, (arg("tol"), arg("maxdepth")=16),
+         "flatten(tol, maxdepth=16) -> list\n\n"
+         "Return a line strip that approximates the curve. Each segment is\n"
+         "subdivided until the control points are within tol of the chord.")
+  ;
+}
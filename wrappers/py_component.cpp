@@ -67,6 +67,7 @@ void class_Component()
 {
   //  void (Component::*addSlot)(const string&, auto_ptr<ISlot>) = &Component::addSlot;
   void (Component::*addSlot)(const string&, ISlot&) = &Component::addSlot;
+  ISlot* (Component::*findSlot)(const string&) const = &Component::findSlot;
 
   class_<Component>("Component", 
     "This is the base class for all scene components.\n\n"
@@ -94,6 +95,11 @@ void class_Component()
 	 "Return the slot with the given name. A KeyError exception is thrown\n"
 	 "if there's no slot with the specified name.")
 
+    .def("findSlot", findSlot, arg("name"), return_internal_reference<>(),
+	 "findSlot(name) -> Slot\n\n"
+	 "Return the slot with the given name or None if there is no such slot.\n"
+	 "This is faster than calling hasSlot() and slot().")
+
     .def("addSlot", addSlot, (arg("name"), arg("slot")),
 	 "addSlot(name, slot)\n\n"
 	 "Add a new slot to the component. The first argument specifies the slot\n"
@@ -8,6 +8,34 @@
 using namespace boost::python;
 using namespace support3d;
 
+// Convert a float array (3 floats per item) into a list of vec3s
+static list vec3List(const std::vector<float>& values)
+{
+  list res;
+  for(unsigned int i=0; i+2<values.size(); i+=3)
+  {
+    res.append(vec3d(values[i], values[i+1], values[i+2]));
+  }
+  return res;
+}
+
+// packArrays() wrapper that returns the packed arrays
+tuple packArrays(DrawGeom* self)
+{
+  self->packArrays();
+  list indices;
+  const std::vector<unsigned int>& idx = self->getMarkerIndices();
+  for(unsigned int i=0; i<idx.size(); i++)
+  {
+    indices.append(idx[i]);
+  }
+  return make_tuple(vec3List(self->getMarkerVerts()),
+                    vec3List(self->getMarkerColors()),
+                    indices,
+                    vec3List(self->getLineVerts()),
+                    vec3List(self->getLineColors()));
+}
+
 
 void class_DrawGeom()
 {
@@ -27,6 +55,11 @@ void class_DrawGeom()
 	 (arg("pos1"), arg("pos2"), arg("col")=vec3d(1,1,1), arg("size")=1.0),
 	 "line(pos1, pos2, col=vec3(1,1,1), size=1.0)\n\n"
 	 "Add a line object.")
+    .def("packArrays", packArrays,
+	 "packArrays() -> (markerverts, markercolors, markerindices, lineverts, linecolors)\n\n"
+	 "Rebuild and return the arrays that are used for drawing. Each marker\n"
+	 "is an octahedron with 6 vertices and 8 triangles, each line has 2\n"
+	 "vertices.")
 
   ;
 
@@ -0,0 +1,263 @@
+/*
+ ExprProgram and expression slots
+ */
+
+#include <boost/python.hpp>
+#include <vector>
+#include "exprprogram.h"
+#include "expressionslot.h"
+#include "common_exceptions.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+// Convert a type name into a type
+static ExprProgram::Type toType(const std::string& s)
+{
+  if (s=="float" || s=="double")
+    return ExprProgram::FLOAT;
+  else if (s=="vec3")
+    return ExprProgram::VEC3;
+  else if (s=="mat3")
+    return ExprProgram::MAT3;
+  else if (s=="mat4")
+    return ExprProgram::MAT4;
+  throw EValueError("Unknown type: \""+s+"\" (must be \"float\", \"vec3\", \"mat3\" or \"mat4\").");
+}
+
+// Check if a Python object is a single value of the given type
+static bool isValue(object obj, ExprProgram::Type type)
+{
+  switch(type)
+  {
+  case ExprProgram::FLOAT: return extract<double>(obj).check();
+  case ExprProgram::VEC3: return extract<vec3d>(obj).check();
+  case ExprProgram::MAT3: return extract<mat3d>(obj).check();
+  default: return extract<mat4d>(obj).check();
+  }
+}
+
+// Store a Python value of the given type in an array of doubles
+static void storeValue(object obj, ExprProgram::Type type, double* dst)
+{
+  switch(type)
+  {
+  case ExprProgram::FLOAT: exprStoreValue(extract<double>(obj)(), dst); break;
+  case ExprProgram::VEC3: exprStoreValue(extract<vec3d>(obj)(), dst); break;
+  case ExprProgram::MAT3: exprStoreValue(extract<mat3d>(obj)(), dst); break;
+  default: exprStoreValue(extract<mat4d>(obj)(), dst); break;
+  }
+}
+
+// Convert an array of doubles into a Python value
+static object makeValue(const double* src, ExprProgram::Type type)
+{
+  switch(type)
+  {
+  case ExprProgram::FLOAT:
+    return object(src[0]);
+  case ExprProgram::VEC3:
+  {
+    vec3d v;
+    exprLoadValue(src, v);
+    return object(v);
+  }
+  case ExprProgram::MAT3:
+  {
+    mat3d m;
+    exprLoadValue(src, m);
+    return object(m);
+  }
+  default:
+  {
+    mat4d m;
+    exprLoadValue(src, m);
+    return object(m);
+  }
+  }
+}
+
+static int addVariable(ExprProgram* self, const std::string& name, const std::string& type)
+{
+  return self->addVariable(name, toType(type));
+}
+
+static std::string getVariableType(ExprProgram* self, int idx)
+{
+  return ExprProgram::typeName(self->getVariableType(idx));
+}
+
+static void compile(ExprProgram* self, const std::string& expr, object restype)
+{
+  if (restype.ptr()==Py_None)
+    self->compile(expr);
+  else
+    self->compile(expr, toType(extract<std::string>(restype)));
+}
+
+static std::string getResultType(ExprProgram* self)
+{
+  return ExprProgram::typeName(self->getResultType());
+}
+
+// Check the number of values that were passed to evaluate()
+static void checkNumValues(ExprProgram* self, object values)
+{
+  if (len(values)!=self->numVariables())
+    throw EValueError("The number of values doesn't match the number of variables.");
+}
+
+static object evaluate(ExprProgram* self, object values)
+{
+  checkNumValues(self, values);
+  int n = self->numVariables();
+  std::vector<double> buf(16*n);
+  std::vector<const double*> varvalues(n);
+  for(int j=0; j<n; j++)
+  {
+    storeValue(values[j], self->getVariableType(j), &buf[16*j]);
+    varvalues[j] = &buf[16*j];
+  }
+  double res[16];
+  self->evaluate(varvalues.empty()? 0 : &varvalues[0], res);
+  return makeValue(res, self->getResultType());
+}
+
+static list evaluateMany(ExprProgram* self, object values)
+{
+  checkNumValues(self, values);
+  int numvars = self->numVariables();
+  int j, i;
+
+  // Determine the number of instances...
+  int n = -1;
+  std::vector<bool> uniform(numvars);
+  for(j=0; j<numvars; j++)
+  {
+    uniform[j] = isValue(values[j], self->getVariableType(j));
+    if (!uniform[j])
+    {
+      int len_j = len(values[j]);
+      if (n!=-1 && len_j!=n)
+        throw EValueError("All value sequences must have the same length.");
+      n = len_j;
+    }
+  }
+  if (n==-1)
+    n = 1;
+
+  // Copy the values...
+  std::vector<std::vector<double> > bufs(numvars);
+  std::vector<const double*> varvalues(numvars);
+  std::vector<int> strides(numvars);
+  for(j=0; j<numvars; j++)
+  {
+    ExprProgram::Type type = self->getVariableType(j);
+    if (uniform[j])
+    {
+      bufs[j].resize(type);
+      storeValue(values[j], type, &bufs[j][0]);
+      strides[j] = 0;
+    }
+    else
+    {
+      bufs[j].resize(n*type);
+      for(i=0; i<n; i++)
+        storeValue(values[j][i], type, &bufs[j][i*type]);
+      strides[j] = type;
+    }
+    varvalues[j] = &bufs[j][0];
+  }
+
+  ExprProgram::Type restype = self->getResultType();
+  std::vector<double> res(n*restype);
+  self->evaluate(n, varvalues.empty()? 0 : &varvalues[0], strides.empty()? 0 : &strides[0], &res[0]);
+
+  list reslist;
+  for(i=0; i<n; i++)
+    reslist.append(makeValue(&res[i*restype], restype));
+  return reslist;
+}
+
+// Expression slots
+
+template<class T>
+static std::string getSlotExpression(ExpressionSlot<T>* self)
+{
+  return self->getProgram().getExpression();
+}
+
+template<class T>
+static int getSlotNumInstructions(ExpressionSlot<T>* self)
+{
+  return self->getProgram().numInstructions();
+}
+
+template<class T>
+static void defExpressionSlot(const char* name)
+{
+  class_<ExpressionSlot<T>, bases<Slot<T> >, boost::noncopyable>(name,
+    "A procedural slot whose value is computed by a compiled expression.\n\n"
+    "Add the input slots with addVariable() and then call compile(). The\n"
+    "slot doesn't add itself as a dependent of the input slots.",
+    init<>())
+    .def("addVariable", &ExpressionSlot<T>::addVariable, with_custodian_and_ward<1,3>(),
+         (arg("name"), arg("slot")),
+         "addVariable(name, slot)\n\n"
+         "Add a variable whose value is taken from the given slot (the slot\n"
+         "must be a DoubleSlot, Vec3Slot, Mat3Slot or Mat4Slot).")
+    .def("compile", &ExpressionSlot<T>::compile, arg("expr"),
+         "compile(expr)\n\n"
+         "Compile the expression. A ValueError is raised if the expression\n"
+         "contains an error or uses unsupported features.")
+    .add_property("expression", getSlotExpression<T>)
+    .def("numInstructions", getSlotNumInstructions<T>)
+  ;
+}
+
+void class_ExprProgram()
+{
+  class_<ExprProgram>("ExprProgram",
+    "A compiled expression.\n\n"
+    "The expression is a Python expression string that may use floats,\n"
+    "vec3s, mat3s and mat4s, the usual operators, the math functions, the\n"
+    "most common sl functions and the noise functions. The input variables\n"
+    "have to be declared with addVariable() before the expression is\n"
+    "compiled. compile() raises a ValueError if the expression uses an\n"
+    "unsupported feature.",
+    init<>())
+    .def("clear", &ExprProgram::clear,
+         "clear()\n\n"
+         "Remove all variables and the compiled code.")
+    .def("addVariable", addVariable, (arg("name"), arg("type")="float"),
+         "addVariable(name, type=\"float\") -> int\n\n"
+         "Declare an input variable. type is one of \"float\", \"vec3\", \"mat3\"\n"
+         "or \"mat4\". Returns the variable index.")
+    .def("numVariables", &ExprProgram::numVariables)
+    .def("variableName", &ExprProgram::getVariableName, arg("idx"))
+    .def("variableType", getVariableType, arg("idx"))
+    .def("findVariable", &ExprProgram::findVariable, arg("name"))
+    .def("compile", compile, (arg("expr"), arg("restype")=object()),
+         "compile(expr, restype=None)\n\n"
+         "Compile an expression. If restype is given, the value is converted\n"
+         "into that type, otherwise the type is determined by the expression.")
+    .def("isCompiled", &ExprProgram::isCompiled)
+    .add_property("expression", &ExprProgram::getExpression)
+    .def("resultType", getResultType)
+    .def("numInstructions", &ExprProgram::numInstructions)
+    .def("numRegisters", &ExprProgram::numRegisters)
+    .def("evaluate", evaluate, arg("values"),
+         "evaluate(values) -> value\n\n"
+         "Evaluate the expression. values contains one value per variable.")
+    .def("evaluateMany", evaluateMany, arg("values"),
+         "evaluateMany(values) -> list\n\n"
+         "Evaluate the expression for many instances at once. values contains\n"
+         "one item per variable which is either a single value (that is used\n"
+         "for all instances) or a sequence with one value per instance.")
+  ;
+
+  defExpressionSlot<double>("DoubleExpressionSlot");
+  defExpressionSlot<vec3d>("Vec3ExpressionSlot");
+  defExpressionSlot<mat3d>("Mat3ExpressionSlot");
+  defExpressionSlot<mat4d>("Mat4ExpressionSlot");
+}
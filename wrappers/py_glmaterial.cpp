@@ -119,6 +119,9 @@ void class_GLMaterial()
     .def_readwrite("transform", &GLTexture::transform)
     .def("applyGL", &GLTextureWrapper::applyGL)
     .def("texData", &GLTextureWrapper::texData)
+    .def("getTexImage", &GLTexture::getTexImage)
+    .def("setTexImage", &GLTexture::setTexImage, arg("image"))
+    .def("isReady", &GLTexture::isReady)
   ;
 
   class_GLShader();
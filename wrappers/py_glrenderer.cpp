@@ -33,6 +33,13 @@ void class_GLRenderInstance()
     .def_readwrite("stereo_mode", &GLRenderInstance::stereo_mode)
     .def_readwrite("clearcol", &GLRenderInstance::clearcol)
 
+    .def_readonly("stat_objects", &GLRenderInstance::stat_objects)
+    .def_readonly("stat_material_changes", &GLRenderInstance::stat_material_changes)
+    .def_readonly("stat_texture_changes", &GLRenderInstance::stat_texture_changes)
+    .def_readonly("stat_blend_changes", &GLRenderInstance::stat_blend_changes)
+    .def_readonly("stat_light_changes", &GLRenderInstance::stat_light_changes)
+    .def_readonly("stat_drawlist_rebuilds", &GLRenderInstance::stat_drawlist_rebuilds)
+
     .def("setProjection", &GLRenderInstance::setProjection, arg("P"),
 	 "setProjection(P)\n\n"
 	 "Set the projection matrix (given as mat4).")
@@ -0,0 +1,45 @@
+/*
+ LOD geom
+ */
+
+#include <boost/python.hpp>
+#include "lodgeom.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+
+void class_LODGeom()
+{
+  class_<LODGeom, bases<GeomObject> >("LODGeom", 
+    "Level of detail geometry.\n\n"
+    "This geom holds several geoms and draws the one that matches the size\n"
+    "of the object on screen (the projected diameter of the bounding sphere\n"
+    "in pixels). The first level whose minimum size is not larger than the\n"
+    "screen size is drawn (or the last level if there is no such level).",
+    init<>())
+
+    .add_property("currentlevel", &LODGeom::getCurrentLevel)
+
+    .def("addLevel", &LODGeom::addLevel, (arg("geom"), arg("minsize")),
+         "addLevel(geom, minsize)\n\n"
+         "Add a level of detail. The geom is used when the object is at least\n"
+         "minsize pixels large. Levels should be added from the most detailed\n"
+         "to the coarsest one.")
+    .def("clearLevels", &LODGeom::clearLevels,
+         "clearLevels()\n\n"
+         "Remove all levels.")
+    .def("numLevels", &LODGeom::numLevels,
+         "numLevels() -> int\n\n"
+         "Return the number of levels.")
+    .def("getLevel", &LODGeom::getLevel, (arg("idx")),
+         "getLevel(idx) -> geom\n\n"
+         "Return the geom of a level.")
+    .def("getMinSize", &LODGeom::getMinSize, (arg("idx")),
+         "getMinSize(idx) -> float\n\n"
+         "Return the minimum screen size of a level.")
+    .def("selectLevel", &LODGeom::selectLevel, (arg("screensize")),
+         "selectLevel(screensize) -> int\n\n"
+         "Return the index of the level that is used for the given screen size.")
+  ;
+}
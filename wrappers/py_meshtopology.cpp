@@ -0,0 +1,156 @@
+/*
+ MeshTopology
+ */
+
+#include <boost/python.hpp>
+#include "meshtopology.h"
+#include "common_exceptions.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+static void checkHalfEdge(MeshTopology* self, int he)
+{
+  if (he<0 || he>=self->getNumHalfEdges())
+    throw EIndexError("Half-edge index out of range.");
+}
+
+static list toList(const std::vector<int>& v)
+{
+  list res;
+  for(unsigned int i=0; i<v.size(); i++)
+  {
+    res.append(v[i]);
+  }
+  return res;
+}
+
+int origin(MeshTopology* self, int he) { checkHalfEdge(self, he); return self->origin(he); }
+int target(MeshTopology* self, int he) { checkHalfEdge(self, he); return self->target(he); }
+int next(MeshTopology* self, int he) { checkHalfEdge(self, he); return self->next(he); }
+int prev(MeshTopology* self, int he) { checkHalfEdge(self, he); return self->prev(he); }
+int twin(MeshTopology* self, int he) { checkHalfEdge(self, he); return self->twin(he); }
+int face(MeshTopology* self, int he) { checkHalfEdge(self, he); return self->face(he); }
+
+int faceHalfEdge(MeshTopology* self, int f)
+{
+  if (f<0 || f>=self->getNumFaces())
+    throw EIndexError("Face index out of range.");
+  return self->faceHalfEdge(f);
+}
+
+list outgoing(MeshTopology* self, int v)
+{
+  if (v<0 || v>=self->getNumVerts())
+    throw EIndexError("Vertex index out of range.");
+  list res;
+  int n = self->numOutgoing(v);
+  for(int i=0; i<n; i++)
+  {
+    res.append(self->outgoing(v, i));
+  }
+  return res;
+}
+
+list vertexRing(MeshTopology* self, int v)
+{
+  std::vector<int> res;
+  self->vertexRing(v, res);
+  return toList(res);
+}
+
+list vertexFaces(MeshTopology* self, int v)
+{
+  std::vector<int> res;
+  self->vertexFaces(v, res);
+  return toList(res);
+}
+
+list faceNeighbors(MeshTopology* self, int f)
+{
+  std::vector<int> res;
+  self->faceNeighbors(f, res);
+  return toList(res);
+}
+
+list boundaryLoops(MeshTopology* self)
+{
+  std::vector<std::vector<int> > loops;
+  self->boundaryLoops(loops);
+  list res;
+  for(unsigned int i=0; i<loops.size(); i++)
+  {
+    res.append(toList(loops[i]));
+  }
+  return res;
+}
+
+void class_MeshTopology()
+{
+  class_<MeshTopology>("MeshTopology",
+    "Half-edge connectivity of a polygon mesh.\n\n"
+    "Every face corner is a half-edge that starts at the corner vertex and\n"
+    "ends at the next vertex of the face. The half-edges are numbered like\n"
+    "the values of a facevarying variable. A MeshTopology object is\n"
+    "obtained from TriMeshGeom.getTopology() or PolyhedronGeom.getTopology().",
+    init<>())
+
+    .def("getNumVerts", &MeshTopology::getNumVerts,
+         "getNumVerts() -> int\n\n"
+         "Return the number of vertices.")
+    .def("getNumFaces", &MeshTopology::getNumFaces,
+         "getNumFaces() -> int\n\n"
+         "Return the number of faces.")
+    .def("getNumHalfEdges", &MeshTopology::getNumHalfEdges,
+         "getNumHalfEdges() -> int\n\n"
+         "Return the number of half-edges.")
+    .def("getNumEdges", &MeshTopology::getNumEdges,
+         "getNumEdges() -> int\n\n"
+         "Return the number of edges.")
+
+    .def("origin", origin, arg("he"),
+         "origin(he) -> int\n\n"
+         "Return the start vertex of a half-edge.")
+    .def("target", target, arg("he"),
+         "target(he) -> int\n\n"
+         "Return the end vertex of a half-edge.")
+    .def("next", next, arg("he"),
+         "next(he) -> int\n\n"
+         "Return the next half-edge of the same loop.")
+    .def("prev", prev, arg("he"),
+         "prev(he) -> int\n\n"
+         "Return the previous half-edge of the same loop.")
+    .def("twin", twin, arg("he"),
+         "twin(he) -> int\n\n"
+         "Return the opposite half-edge or -1 if the edge is a boundary edge\n"
+         "(or non-manifold).")
+    .def("face", face, arg("he"),
+         "face(he) -> int\n\n"
+         "Return the face index of a half-edge.")
+    .def("faceHalfEdge", faceHalfEdge, arg("face"),
+         "faceHalfEdge(face) -> int\n\n"
+         "Return the first half-edge of a face.")
+    .def("outgoing", outgoing, arg("vert"),
+         "outgoing(vert) -> list\n\n"
+         "Return the outgoing half-edges of a vertex.")
+
+    .def("isBoundaryVertex", &MeshTopology::isBoundaryVertex, arg("vert"),
+         "isBoundaryVertex(vert) -> bool\n\n"
+         "Return True if a vertex lies on the boundary.")
+    .def("vertexRing", vertexRing, arg("vert"),
+         "vertexRing(vert) -> list\n\n"
+         "Return the neighbor vertices of a vertex. For manifold vertices the\n"
+         "neighbors are ordered around the vertex (starting and ending at the\n"
+         "boundary if the vertex is a boundary vertex).")
+    .def("vertexFaces", vertexFaces, arg("vert"),
+         "vertexFaces(vert) -> list\n\n"
+         "Return the faces that use a vertex.")
+    .def("faceNeighbors", faceNeighbors, arg("face"),
+         "faceNeighbors(face) -> list\n\n"
+         "Return the neighbor face across each edge of a face (-1 for\n"
+         "boundary edges).")
+    .def("boundaryLoops", boundaryLoops,
+         "boundaryLoops() -> list\n\n"
+         "Return all boundary loops as lists of vertex indices.")
+  ;
+}
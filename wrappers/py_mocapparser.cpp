@@ -0,0 +1,218 @@
+/*
+ MotionData, BVHParser and AMCParser
+ */
+
+#include <boost/python.hpp>
+#include <vector>
+#include "mocapparser.h"
+#include "common_exceptions.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+// MotionData
+
+static list getChannel(MotionData* self, int idx)
+{
+  if (idx<0 || idx>=self->numChannels())
+    throw EIndexError("Channel index out of range.");
+  list res;
+  const double* v = (self->numFrames()==0)? 0 : self->channel(idx);
+  for(int i=0; i<self->numFrames(); i++)
+    res.append(v[i]);
+  return res;
+}
+
+static void setChannel(MotionData* self, int idx, object values)
+{
+  if (idx<0 || idx>=self->numChannels())
+    throw EIndexError("Channel index out of range.");
+  if (len(values)!=self->numFrames())
+    throw EValueError("The number of values must match the number of frames.");
+  double* v = (self->numFrames()==0)? 0 : self->channel(idx);
+  for(int i=0; i<self->numFrames(); i++)
+    v[i] = extract<double>(values[i]);
+}
+
+static list getFrame(MotionData* self, int frame)
+{
+  std::vector<double> v(self->numChannels());
+  self->getFrame(frame, v.empty()? 0 : &v[0]);
+  list res;
+  for(unsigned int i=0; i<v.size(); i++)
+    res.append(v[i]);
+  return res;
+}
+
+// BVHParser
+
+static const BVHParser::Joint& getJoint(BVHParser* self, int idx)
+{
+  if (idx<0 || idx>=int(self->joints.size()))
+    throw EIndexError("Joint index out of range.");
+  return self->joints[idx];
+}
+
+static int numJoints(BVHParser* self)
+{
+  return int(self->joints.size());
+}
+
+static std::string getJointName(BVHParser* self, int idx)
+{
+  return getJoint(self, idx).name;
+}
+
+static int getJointParent(BVHParser* self, int idx)
+{
+  return getJoint(self, idx).parent;
+}
+
+static vec3d getJointOffset(BVHParser* self, int idx)
+{
+  return getJoint(self, idx).offset;
+}
+
+static list getJointChannels(BVHParser* self, int idx)
+{
+  const BVHParser::Joint& j = getJoint(self, idx);
+  list res;
+  for(unsigned int i=0; i<j.channels.size(); i++)
+    res.append(j.channels[i]);
+  return res;
+}
+
+static int getJointTrack(BVHParser* self, int idx)
+{
+  return getJoint(self, idx).track;
+}
+
+static bool isEndSite(BVHParser* self, int idx)
+{
+  return getJoint(self, idx).endsite;
+}
+
+static bool hasMotion(BVHParser* self)
+{
+  return self->hasmotion;
+}
+
+static void parseBVH(BVHParser* self, const std::string& text)
+{
+  self->parse(text.data(), int(text.size()));
+}
+
+static MotionData& getBVHMotion(BVHParser* self)
+{
+  return self->motion;
+}
+
+// AMCParser
+
+static void parseAMC(AMCParser* self, const std::string& text)
+{
+  self->parse(text.data(), int(text.size()));
+}
+
+static list getFrameNumbers(AMCParser* self)
+{
+  list res;
+  for(unsigned int i=0; i<self->framenumbers.size(); i++)
+    res.append(self->framenumbers[i]);
+  return res;
+}
+
+static MotionData& getAMCMotion(AMCParser* self)
+{
+  return self->motion;
+}
+
+void class_MocapParser()
+{
+  class_<MotionData>("MotionData",
+    "Motion samples of a motion capture file.\n\n"
+    "The samples of a channel are stored contiguously. Consecutive channels\n"
+    "are grouped into tracks (one track per joint or bone).",
+    init<>())
+    .def("clear", &MotionData::clear)
+    .def("addTrack", &MotionData::addTrack, (arg("name"), arg("size")),
+         "addTrack(name, size) -> int\n\n"
+         "Add a track with size channels and return the track index.")
+    .def("numTracks", &MotionData::numTracks)
+    .def("findTrack", &MotionData::findTrack, arg("name"),
+         "findTrack(name) -> int\n\n"
+         "Return the index of a track or -1 if there is no such track.")
+    .def("trackName", &MotionData::getTrackName, arg("idx"), return_value_policy<copy_const_reference>())
+    .def("trackChannel", &MotionData::getTrackChannel, arg("idx"),
+         "trackChannel(idx) -> int\n\n"
+         "Return the index of the first channel of a track.")
+    .def("trackSize", &MotionData::getTrackSize, arg("idx"),
+         "trackSize(idx) -> int\n\n"
+         "Return the number of channels of a track.")
+    .def("numChannels", &MotionData::numChannels)
+    .def("numFrames", &MotionData::numFrames)
+    .def("setNumFrames", &MotionData::setNumFrames, arg("n"))
+    .add_property("frametime", &MotionData::getFrameTime, &MotionData::setFrameTime)
+    .def("value", &MotionData::getValue, (arg("channel"), arg("frame")))
+    .def("setValue", &MotionData::setValue, (arg("channel"), arg("frame"), arg("v")))
+    .def("channel", getChannel, arg("idx"),
+         "channel(idx) -> list\n\n"
+         "Return the samples of a channel.")
+    .def("setChannel", setChannel, (arg("idx"), arg("values")),
+         "setChannel(idx, values)\n\n"
+         "Set the samples of a channel (values must contain one value per frame).")
+    .def("frame", getFrame, arg("frame"),
+         "frame(frame) -> list\n\n"
+         "Return the values of all channels at one frame.")
+  ;
+
+  class_<BVHParser, boost::noncopyable>("BVHParser",
+    "Reads BioVision Hierarchical (BVH) files.\n\n"
+    "The joints are stored in depth-first order and the motion samples\n"
+    "are stored in the motion attribute (one track per joint that has\n"
+    "channels). Syntax errors raise a SyntaxError exception.",
+    init<>())
+    .def("clear", &BVHParser::clear)
+    .def("read", &BVHParser::read, arg("filename"),
+         "read(filename)\n\n"
+         "Read a BVH file.")
+    .def("parse", parseBVH, arg("text"),
+         "parse(text)\n\n"
+         "Parse the content of a BVH file.")
+    .def("numJoints", numJoints)
+    .def("jointName", getJointName, arg("idx"))
+    .def("jointParent", getJointParent, arg("idx"),
+         "jointParent(idx) -> int\n\n"
+         "Return the index of the parent joint (-1 for the root).")
+    .def("jointOffset", getJointOffset, arg("idx"))
+    .def("jointChannels", getJointChannels, arg("idx"),
+         "jointChannels(idx) -> list\n\n"
+         "Return the channel names of a joint.")
+    .def("jointTrack", getJointTrack, arg("idx"),
+         "jointTrack(idx) -> int\n\n"
+         "Return the motion track of a joint (-1 if the joint has no channels).")
+    .def("isEndSite", isEndSite, arg("idx"))
+    .def("hasMotion", hasMotion,
+         "hasMotion() -> bool\n\n"
+         "Return True if the file contained a MOTION section.")
+    .add_property("motion", make_function(getBVHMotion, return_internal_reference<>()))
+  ;
+
+  class_<AMCParser, boost::noncopyable>("AMCParser",
+    "Reads Acclaim Motion Capture (AMC) files.\n\n"
+    "The motion samples are stored in the motion attribute (one track per\n"
+    "bone, in the order of the first frame).",
+    init<>())
+    .def("clear", &AMCParser::clear)
+    .def("read", &AMCParser::read, arg("filename"),
+         "read(filename)\n\n"
+         "Read an AMC file.")
+    .def("parse", parseAMC, arg("text"),
+         "parse(text)\n\n"
+         "Parse the content of an AMC file.")
+    .def("frameNumbers", getFrameNumbers,
+         "frameNumbers() -> list\n\n"
+         "Return the frame numbers that were stored in the file.")
+    .add_property("motion", make_function(getAMCMotion, return_internal_reference<>()))
+  ;
+}
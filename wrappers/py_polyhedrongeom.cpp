@@ -137,6 +137,12 @@ void class_PolyhedronGeom()
     .def("setPoly", setPoly, (arg("poly"), arg("polydef")),
 	 "setPoly(poly, polydef)\n\n"
 	 "Set a polygon.")
+
+    .def("getTopology", &PolyhedronGeom::getTopology, return_internal_reference<>(),
+	 "getTopology() -> MeshTopology\n\n"
+	 "Return the half-edge connectivity of the polyhedron. The topology is\n"
+	 "cached and rebuilt on demand after the polys have been modified.\n"
+	 "The half-edges are numbered like the values of a facevarying variable.")
   ;
 
 }
@@ -0,0 +1,77 @@
+/*
+ Skin geom
+ */
+
+#include <boost/python.hpp>
+#include "skingeom.h"
+#include "common_exceptions.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+static std::string getMode(SkinGeom* self)
+{
+  if (self->getMode()==SkinGeom::DUAL_QUATERNION)
+    return "dualquat";
+  return "linear";
+}
+
+static void setMode(SkinGeom* self, const std::string& mode)
+{
+  if (mode=="linear")
+    self->setMode(SkinGeom::LINEAR_BLEND);
+  else if (mode=="dualquat")
+    self->setMode(SkinGeom::DUAL_QUATERNION);
+  else
+    throw EValueError("Unknown skinning mode: \""+mode+"\" (must be \"linear\" or \"dualquat\").");
+}
+
+void class_SkinGeom()
+{
+  class_<SkinGeom, bases<TriMeshGeom> >("SkinGeom", 
+    "Skinned triangle mesh.\n\n"
+    "This is a triangle mesh that is obtained by deforming a bind mesh\n"
+    "with a set of joints (linear blend or dual quaternion skinning).\n"
+    "Each joint has an input slot \"joint<i>\" that receives its world\n"
+    "transform. The mesh is only recomputed when a joint transform has\n"
+    "changed, after topology changes of the bind mesh rebuild() has to\n"
+    "be called.",
+    init<>())
+
+    .add_property("bindmesh", &SkinGeom::getBindMesh)
+    .add_property("indexvar", &SkinGeom::getIndexVar)
+    .add_property("weightvar", &SkinGeom::getWeightVar)
+    .add_property("mode", &getMode, &setMode)
+    .add_property("numinfluences", &SkinGeom::getNumInfluences)
+    .add_property("dirty", &SkinGeom::isDirty)
+
+    .def("setBindMesh", &SkinGeom::setBindMesh, (arg("mesh"), arg("indexvar")="jointindices", arg("weightvar")="jointweights"),
+         "setBindMesh(mesh, indexvar=\"jointindices\", weightvar=\"jointweights\")\n\n"
+         "Set the bind mesh and the names of the varying variables that\n"
+         "contain the joint indices (int) and weights (float).")
+    .def("addJoint", &SkinGeom::addJoint, arg("bindtransform"),
+         "addJoint(bindtransform) -> int\n\n"
+         "Add a joint with the given bind pose world transform and return its\n"
+         "index. The transform is set via the slot \"joint<index>\".")
+    .def("numJoints", &SkinGeom::numJoints,
+         "numJoints() -> int\n\n"
+         "Return the number of joints.")
+    .def("jointSlot", &SkinGeom::jointSlot, arg("idx"), return_internal_reference<>(),
+         "jointSlot(idx) -> Mat4Slot\n\n"
+         "Return the input slot of a joint.")
+    .def("getBindTransform", &SkinGeom::getBindTransform, arg("idx"),
+         "getBindTransform(idx) -> mat4\n\n"
+         "Return the bind transform of a joint.")
+    .def("clearJoints", &SkinGeom::clearJoints,
+         "clearJoints()\n\n"
+         "Remove all joints.")
+    .def("rebuild", &SkinGeom::rebuild,
+         "rebuild()\n\n"
+         "Rebuild the mesh after the faces or the primitive variables of the\n"
+         "bind mesh have been modified.")
+    .def("update", &SkinGeom::update,
+         "update() -> bool\n\n"
+         "Recompute the mesh if a joint transform has changed. Returns True\n"
+         "if the mesh was recomputed.")
+  ;
+}
@@ -3,6 +3,8 @@
  */
 
 #include "py_slot.h"
+#include "component.h"
+#include "slotprofiler.h"
 
 
 long _slot_counter()
@@ -10,11 +12,68 @@ long _slot_counter()
   return ISlot::_slot_counter;
 }
 
+// Return the name under which a slot is stored in a component
+static std::string slotName(const ISlot* slot, const Component* owner)
+{
+  if (owner==0)
+    return "";
+  Component::SlotIterator it;
+  for(it=owner->slotsBegin(); it!=owner->slotsEnd(); it++)
+  {
+    if (&(it->second->getSlot())==slot)
+      return it->first;
+  }
+  return "";
+}
+
+// Return the profiler counters of all slots
+list getSlotProfile()
+{
+  list res;
+  for(int i=0; i<SlotProfiler::numStats(); i++)
+  {
+    const SlotStats& s = SlotProfiler::getStats(i);
+    std::string compname;
+    if (s.owner!=0)
+      compname = s.owner->getName();
+    res.append(make_tuple(compname, slotName(s.slot, s.owner), 
+                          std::string(s.slot->typeName()),
+                          s.getvalue_calls, s.cache_hits, s.evaluations,
+                          s.setvalue_calls, s.notify_calls, s.notifications,
+                          s.slot->numDependents(), s.total_time, s.self_time));
+  }
+  return res;
+}
+
 
 void class_Slots()
 {
   def("_slot_counter", _slot_counter);
 
+  // Slot profiler
+  def("slotProfilerAvailable", &SlotProfiler::isAvailable,
+      "slotProfilerAvailable() -> bool\n\n"
+      "Return True if the slot profiler was compiled into the library\n"
+      "(i.e. if CGKIT_SLOT_PROFILING was defined).");
+  def("isSlotProfilerEnabled", &SlotProfiler::isEnabled,
+      "isSlotProfilerEnabled() -> bool\n\n"
+      "Return True if the slot profiler is currently collecting data.");
+  def("setSlotProfilerEnabled", &SlotProfiler::setEnabled, arg("flag"),
+      "setSlotProfilerEnabled(flag)\n\n"
+      "Enable or disable the slot profiler.");
+  def("resetSlotProfiler", &SlotProfiler::reset,
+      "resetSlotProfiler()\n\n"
+      "Reset the counters of all slots.");
+  def("getSlotProfile", getSlotProfile,
+      "getSlotProfile() -> list\n\n"
+      "Return the profiler counters of all slots that have been accessed\n"
+      "while the profiler was enabled. Each item is a tuple (component,\n"
+      "slot, type, getvalue_calls, cache_hits, evaluations, setvalue_calls,\n"
+      "notify_calls, notifications, num_dependents, total_time, self_time).\n"
+      "component and slot are the names of the component and the slot (or\n"
+      "empty strings if the slot isn't part of a component). The times are\n"
+      "given in seconds.");
+
   // Dependent
   class_<Dependent, DependentWrapper, boost::noncopyable>("Dependent")
     .def("onValueChanged", &DependentWrapper::base_onValueChanged)
@@ -32,6 +91,7 @@ void class_Slots()
     .def("addDependent", &ISlot::addDependent)
     .def("removeDependent", &ISlot::removeDependent)
     .def("notifyDependents", &ISlot::notifyDependents)
+    .def("numDependents", &ISlot::numDependents)
     .def("getController", &ISlot::getController, return_internal_reference<>())
     .def("setController", &ISlot::setController)
   ;
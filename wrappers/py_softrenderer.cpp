@@ -0,0 +1,86 @@
+/*
+  SoftRenderer wrapper
+ */
+
+#include <vector>
+#include <boost/python.hpp>
+#include "softrenderer.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+// getResolution wrapper
+tuple getResolution(SoftRenderer* self)
+{
+  return make_tuple(self->getWidth(), self->getHeight());
+}
+
+// getImageData wrapper
+object getImageData(SoftRenderer* self, bool topdown)
+{
+  int size = 4*self->getWidth()*self->getHeight();
+  std::vector<unsigned char> buf(size);
+  if (size>0)
+    self->getRGBA8(&buf[0], topdown);
+  PyObject* s = PyString_FromStringAndSize(size>0? (const char*)&buf[0] : "", size);
+  return object(handle<>(s));
+}
+
+
+void class_SoftRenderer()
+{
+  class_<SoftRenderer>("SoftRenderer", init<>())
+
+    .def_readwrite("left_handed", &SoftRenderer::left_handed)
+    .def_readwrite("smooth_model", &SoftRenderer::smooth_model)
+    .def_readwrite("backface_culling", &SoftRenderer::backface_culling)
+    .def_readwrite("clearcol", &SoftRenderer::clearcol)
+    .def_readwrite("tilesize", &SoftRenderer::tilesize)
+    .def_readwrite("numthreads", &SoftRenderer::numthreads)
+
+    .def_readonly("stat_triangles", &SoftRenderer::stat_triangles)
+    .def_readonly("stat_render_time", &SoftRenderer::stat_render_time)
+
+    .def("setProjection", &SoftRenderer::setProjection, arg("P"),
+	 "setProjection(P)\n\n"
+	 "Set the projection matrix (given as mat4).")
+
+    .def("getProjection", &SoftRenderer::getProjection,
+	 "getProjection() -> mat4\n\n"
+	 "Return the current projection matrix.")
+
+    .def("setViewTransformation", &SoftRenderer::setViewTransformation, arg("V"),
+	 "setViewTransformation(V)\n\n"
+	 "Set the view matrix (given as mat4).")
+
+    .def("getViewTransformation", &SoftRenderer::getViewTransformation,
+	 "getViewTransformation() -> mat4\n\n"
+	 "Return the current view transformation.")
+
+    .def("setResolution", &SoftRenderer::setResolution, 
+	 (arg("width"), arg("height")),
+	 "setResolution(width, height)\n\n"
+	 "Set the size of the image.")
+
+    .def("getResolution", getResolution, 
+	 "getResolution() -> (width, height)\n\n"
+	 "Return the current image size.")
+
+    .def("render", &SoftRenderer::render, arg("root"),
+	 "render(root)\n\n"
+	 "Render the scene starting at root.")
+
+    .def("getPixel", &SoftRenderer::getPixel, (arg("x"), arg("y")),
+	 "getPixel(x, y) -> vec4\n\n"
+	 "Return the RGBA color of a pixel. y=0 is the bottom row.")
+
+    .def("getDepth", &SoftRenderer::getDepth, (arg("x"), arg("y")),
+	 "getDepth(x, y) -> float\n\n"
+	 "Return the depth value (0-1) of a pixel. y=0 is the bottom row.")
+
+    .def("getImageData", getImageData, (arg("topdown")=true),
+	 "getImageData(topdown=True) -> str\n\n"
+	 "Return the image as a string of 8 bit RGBA values. If topdown is\n"
+	 "True the first row is the top row of the image.")
+  ;
+}
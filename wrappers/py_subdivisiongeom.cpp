@@ -0,0 +1,34 @@
+/*
+ Subdivision geom
+ */
+
+#include <boost/python.hpp>
+#include "subdivisiongeom.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+
+void class_SubdivisionGeom()
+{
+  class_<SubdivisionGeom, bases<TriMeshGeom> >("SubdivisionGeom", 
+    "Subdivided control mesh.\n\n"
+    "This is a triangle mesh that is obtained by subdividing a cage. A\n"
+    "PolyhedronGeom cage is refined with the Catmull-Clark scheme, a\n"
+    "TriMeshGeom cage with the Loop scheme. The vertices are updated\n"
+    "automatically when the cage vertices change, after topology changes\n"
+    "rebuild() has to be called.",
+    init<>())
+
+    .add_property("cage", &SubdivisionGeom::getCage)
+    .add_property("levels", &SubdivisionGeom::getLevels, &SubdivisionGeom::setLevels)
+
+    .def("setCage", &SubdivisionGeom::setCage, (arg("cage"), arg("levels")),
+         "setCage(cage, levels)\n\n"
+         "Set the control mesh and the number of subdivision steps.")
+    .def("rebuild", &SubdivisionGeom::rebuild,
+         "rebuild()\n\n"
+         "Rebuild the mesh after the faces or the primitive variables of the\n"
+         "cage have been modified.")
+  ;
+}
@@ -0,0 +1,122 @@
+/*
+  TextureImage and TextureCache wrappers
+ */
+
+#include <boost/python.hpp>
+#include "textureimage.h"
+#include "texturecache.h"
+#include "common_exceptions.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+// TextureImage constructor
+// The mip maps are computed without holding the interpreter lock so
+// that several images can be processed in parallel by Python threads.
+static boost::shared_ptr<TextureImage> createTextureImage(int w, int h, int format, object data, bool mipmap)
+{
+  const void* buf;
+  Py_ssize_t len;
+  if (PyObject_AsReadBuffer(data.ptr(), &buf, &len)!=0)
+    throw_error_already_set();
+
+  int comps = TextureImage::numComponents(format);
+  if (comps==0)
+    throw EValueError("Unsupported texture format.");
+  if (w<1 || h<1)
+    throw EValueError("The texture size must be positive.");
+  if (len<Py_ssize_t(w)*h*comps)
+    throw EValueError("Not enough image data.");
+
+  boost::shared_ptr<TextureImage> img(new TextureImage());
+  bool ok = true;
+  Py_BEGIN_ALLOW_THREADS
+  try
+  {
+    img->setData(w, h, format, (const unsigned char*)buf, mipmap);
+  }
+  catch(...)
+  {
+    ok = false;
+  }
+  Py_END_ALLOW_THREADS
+  if (!ok)
+    throw EMemoryError();
+  return img;
+}
+
+// getResolution wrapper
+static tuple getResolution(TextureImage* self)
+{
+  return make_tuple(self->getWidth(), self->getHeight());
+}
+
+void class_TextureCache()
+{
+  class_<TextureImage, boost::shared_ptr<TextureImage>, boost::noncopyable>("TextureImage", no_init)
+    .def("__init__", make_constructor(createTextureImage, default_call_policies(),
+                     (arg("width"), arg("height"), arg("format"), arg("data"), arg("mipmap")=true)),
+	 "TextureImage(width, height, format, data, mipmap=True)\n\n"
+	 "Create a texture image from 8 bit data (a string) and compute its mip\n"
+	 "map levels. format is the OpenGL pixel format (GL_RGB, GL_RGBA,\n"
+	 "GL_LUMINANCE, GL_LUMINANCE_ALPHA, GL_ALPHA or GL_INTENSITY).\n"
+	 "The data is processed without holding the interpreter lock, so the\n"
+	 "constructor can be called from a background thread.")
+
+    .def("getFormat", &TextureImage::getFormat,
+	 "getFormat() -> int\n\n"
+	 "Return the OpenGL pixel format.")
+
+    .def("getResolution", getResolution,
+	 "getResolution() -> (width, height)\n\n"
+	 "Return the size of the image.")
+
+    .def("getNumLevels", &TextureImage::getNumLevels,
+	 "getNumLevels() -> int\n\n"
+	 "Return the number of mip map levels (including the image itself).")
+
+    .def("getMemSize", &TextureImage::getMemSize,
+	 "getMemSize() -> int\n\n"
+	 "Return the number of bytes of all levels.")
+
+    .def("isUploaded", &TextureImage::isUploaded,
+	 "isUploaded() -> bool\n\n"
+	 "Return True if the image has already been passed to OpenGL.")
+  ;
+
+  class_<TextureCache, boost::noncopyable>("TextureCache", init<optional<unsigned long> >(arg("budget")))
+    .def_readonly("stat_hits", &TextureCache::stat_hits)
+    .def_readonly("stat_misses", &TextureCache::stat_misses)
+    .def_readonly("stat_evictions", &TextureCache::stat_evictions)
+
+    .add_property("budget", &TextureCache::getBudget, &TextureCache::setBudget)
+
+    .def("lookup", &TextureCache::lookup, arg("key"),
+	 "lookup(key) -> TextureImage\n\n"
+	 "Return the image stored under key or None.")
+
+    .def("insert", &TextureCache::insert, (arg("key"), arg("image")),
+	 "insert(key, image)\n\n"
+	 "Store an image in the cache. If the budget is exceeded, the least\n"
+	 "recently used images are removed.")
+
+    .def("remove", &TextureCache::remove, arg("key"),
+	 "remove(key)\n\n"
+	 "Remove an image from the cache.")
+
+    .def("clear", &TextureCache::clear,
+	 "clear()\n\n"
+	 "Remove all images from the cache.")
+
+    .def("getMemSize", &TextureCache::getMemSize,
+	 "getMemSize() -> int\n\n"
+	 "Return the total size of the cached images in bytes.")
+
+    .def("__len__", &TextureCache::size)
+
+    .def("defaultCache", &TextureCache::defaultCache, return_value_policy<reference_existing_object>(),
+	 "defaultCache() -> TextureCache\n\n"
+	 "Return the cache that is shared by all GLTexture objects.")
+    .staticmethod("defaultCache")
+  ;
+}
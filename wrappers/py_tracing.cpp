@@ -0,0 +1,87 @@
+/*
+  Tracer wrappers
+ */
+
+#include <boost/python.hpp>
+#include "tracing.h"
+
+using namespace boost::python;
+using namespace support3d;
+
+// Record a begin event (the strings are interned as they may be temporary)
+static void traceBegin(const std::string& category, const std::string& name)
+{
+  if (Tracer::enabled)
+    Tracer::record('B', Tracer::internString(category), Tracer::internString(name), 0, 0);
+}
+
+// Record an end event
+static void traceEnd(const std::string& category, const std::string& name)
+{
+  if (Tracer::enabled)
+    Tracer::record('E', Tracer::internString(category), Tracer::internString(name), 0, 0);
+}
+
+// Record an instant event
+static void traceInstant(const std::string& category, const std::string& name, long arg)
+{
+  if (Tracer::enabled)
+    Tracer::record('i', Tracer::internString(category), Tracer::internString(name), 0, arg);
+}
+
+// Record a counter value
+static void traceCounter(const std::string& category, const std::string& name, long value)
+{
+  if (Tracer::enabled)
+    Tracer::record('C', Tracer::internString(category), Tracer::internString(name), 0, value);
+}
+
+void class_Tracer()
+{
+  def("tracingAvailable", &Tracer::isAvailable,
+      "tracingAvailable() -> bool\n\n"
+      "Return True if the library was compiled with tracing support\n"
+      "(i.e. if CGKIT_TRACING was defined). Otherwise only the events\n"
+      "that are recorded from Python are available.");
+  def("isTracingEnabled", &Tracer::isEnabled,
+      "isTracingEnabled() -> bool\n\n"
+      "Return True if the tracer is currently recording events.");
+  def("setTracingEnabled", &Tracer::setEnabled, arg("flag"),
+      "setTracingEnabled(flag)\n\n"
+      "Enable or disable the tracer.");
+  def("getTraceBufferSize", &Tracer::getBufferSize,
+      "getTraceBufferSize() -> int\n\n"
+      "Return the number of events that are stored per thread.");
+  def("setTraceBufferSize", &Tracer::setBufferSize, arg("numevents"),
+      "setTraceBufferSize(numevents)\n\n"
+      "Set the number of events that are stored per thread. When a buffer\n"
+      "is full, the oldest events get overwritten. Setting the size removes\n"
+      "all recorded events.");
+  def("clearTrace", &Tracer::clear,
+      "clearTrace()\n\n"
+      "Remove all recorded events.");
+  def("numTraceEvents", &Tracer::numEvents,
+      "numTraceEvents() -> int\n\n"
+      "Return the number of recorded events.");
+  def("traceBegin", traceBegin, (arg("category"), arg("name")),
+      "traceBegin(category, name)\n\n"
+      "Record the beginning of an operation. Each call has to be matched\n"
+      "by a call to traceEnd() in the same thread.");
+  def("traceEnd", traceEnd, (arg("category"), arg("name")),
+      "traceEnd(category, name)\n\n"
+      "Record the end of an operation.");
+  def("traceInstant", traceInstant, (arg("category"), arg("name"), arg("arg")=0),
+      "traceInstant(category, name, arg=0)\n\n"
+      "Record an event without duration.");
+  def("traceCounter", traceCounter, (arg("category"), arg("name"), arg("value")),
+      "traceCounter(category, name, value)\n\n"
+      "Record the current value of a counter.");
+  def("getChromeTrace", &Tracer::chromeTrace,
+      "getChromeTrace() -> str\n\n"
+      "Return the recorded events in the JSON format of the Chrome trace\n"
+      "viewer (which can also be loaded into Perfetto).");
+  def("saveChromeTrace", &Tracer::saveChromeTrace, arg("filename"),
+      "saveChromeTrace(filename)\n\n"
+      "Write the recorded events into a JSON file that can be loaded into\n"
+      "the Chrome trace viewer or Perfetto.");
+}
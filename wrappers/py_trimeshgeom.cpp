@@ -4,6 +4,9 @@
 
 #include <boost/python.hpp>
 #include "trimeshgeom.h"
+#include "meshcleanup.h"
+#include "meshdecimator.h"
+#include "vertexcacheoptimizer.h"
 
 using namespace boost::python;
 using namespace support3d;
@@ -38,6 +41,76 @@ vec3d getCog(TriMeshGeom* self)
   return self->cog.getValue();
 }
 
+// Mesh cleanup stages
+int weldVertices(TriMeshGeom* self, double eps, bool comparevars)
+{
+  return MeshCleanup(*self).weldVertices(eps, comparevars);
+}
+
+int removeDegenerateFaces(TriMeshGeom* self)
+{
+  return MeshCleanup(*self).removeDegenerateFaces();
+}
+
+int removeDuplicateFaces(TriMeshGeom* self)
+{
+  return MeshCleanup(*self).removeDuplicateFaces();
+}
+
+int removeUnusedVerts(TriMeshGeom* self)
+{
+  return MeshCleanup(*self).removeUnusedVerts();
+}
+
+tuple cleanup(TriMeshGeom* self, double eps, bool comparevars)
+{
+  MeshCleanup mc(*self);
+  int welded = mc.weldVertices(eps, comparevars);
+  int degenerate = mc.removeDegenerateFaces();
+  int duplicates = mc.removeDuplicateFaces();
+  int unused = mc.removeUnusedVerts();
+  return make_tuple(welded, degenerate, duplicates, unused);
+}
+
+// Memory locality
+void optimizeVertexCache(TriMeshGeom* self, int cachesize)
+{
+  MeshCleanup(*self).optimizeVertexCache(cachesize);
+}
+
+void reorderVertices(TriMeshGeom* self)
+{
+  MeshCleanup(*self).reorderVertices();
+}
+
+double vertexCacheMissRatio(TriMeshGeom* self, int cachesize)
+{
+  if (self->faces.size()==0)
+    return 0.0;
+  return VertexCacheOptimizer::missRatio(self->faces.getValues(0), self->faces.size(), cachesize);
+}
+
+// Mesh decimation
+int decimate(TriMeshGeom* self, TriMeshGeom& target, int targetfaces, double maxerror)
+{
+  return MeshDecimator(*self).decimate(target, targetfaces, maxerror);
+}
+
+void decimateLODs(TriMeshGeom* self, object targets, object facecounts, double maxerror)
+{
+  std::vector<TriMeshGeom*> targetvec;
+  std::vector<int> countvec;
+  int n = len(targets);
+  if (len(facecounts)!=n)
+    throw EValueError("The number of targets and face counts must match.");
+  for(int i=0; i<n; i++)
+  {
+    TriMeshGeom& tm = extract<TriMeshGeom&>(targets[i]);
+    targetvec.push_back(&tm);
+    countvec.push_back(extract<int>(facecounts[i]));
+  }
+  MeshDecimator(*self).decimateLODs(targetvec, countvec, maxerror);
+}
 
 void class_TriMeshGeom()
 {
@@ -56,6 +129,84 @@ void class_TriMeshGeom()
 
     .def("calcMassProperties", &TriMeshGeom::calcMassProperties)
 
+    .def("computeNormals", &TriMeshGeom::computeNormals, (arg("creaseangle")=-1.0, arg("angleweighted")=true),
+         "computeNormals(creaseangle=-1.0, angleweighted=True)\n\n"
+         "Compute smooth normals and store them in the primitive variable \"N\".\n"
+         "If creaseangle is negative, a varying normal is computed for each\n"
+         "vertex. Otherwise, a facevarying normal is computed for each face\n"
+         "corner where edges whose faces enclose an angle larger than creaseangle\n"
+         "(in radians) remain sharp. The face normals are weighted either by\n"
+         "the angle at the vertex or by the face area.\n\n"
+         "The generated normals are updated incrementally when the vertices\n"
+         "change (see updateNormals()).")
+    .def("updateNormals", &TriMeshGeom::updateNormals,
+         "updateNormals() -> bool\n\n"
+         "Update the normals that were created by computeNormals(). Only the\n"
+         "normals that depend on modified vertices are recomputed. Returns\n"
+         "False if the \"N\" variable doesn't contain generated normals.")
+
+    .def("weldVertices", weldVertices, (arg("eps")=0.0, arg("comparevars")=true),
+         "weldVertices(eps=0.0, comparevars=True) -> int\n\n"
+         "Merge vertices that are closer than eps and return the number of\n"
+         "merged vertices. If comparevars is True, the varying and vertex\n"
+         "variables have to match as well so that seams remain intact.\n"
+         "Only the faces are modified, call removeUnusedVerts() to remove\n"
+         "the merged vertices.")
+    .def("removeDegenerateFaces", removeDegenerateFaces,
+         "removeDegenerateFaces() -> int\n\n"
+         "Remove faces that reference a vertex more than once or that have\n"
+         "a zero area. Returns the number of removed faces.")
+    .def("removeDuplicateFaces", removeDuplicateFaces,
+         "removeDuplicateFaces() -> int\n\n"
+         "Remove faces that use the same vertices (in the same cyclic order)\n"
+         "as a previous face. Returns the number of removed faces.")
+    .def("removeUnusedVerts", removeUnusedVerts,
+         "removeUnusedVerts() -> int\n\n"
+         "Remove vertices that aren't referenced by any face. Returns the\n"
+         "number of removed vertices.")
+    .def("cleanup", cleanup, (arg("eps")=0.0, arg("comparevars")=true),
+         "cleanup(eps=0.0, comparevars=True) -> (welded, degenerate, duplicates, unused)\n\n"
+         "Weld vertices, remove degenerate and duplicate faces and remove unused\n"
+         "vertices. Returns the number of vertices/faces affected by each step.\n"
+         "All primitive variables are updated accordingly.")
+
+    .def("optimizeVertexCache", optimizeVertexCache, (arg("cachesize")=32),
+         "optimizeVertexCache(cachesize=32)\n\n"
+         "Reorder the faces so that they make good use of a post-transform\n"
+         "vertex cache (Forsyth's algorithm) and sort the vertices by their\n"
+         "first use. This improves the memory locality of all operations\n"
+         "that iterate over the faces. All primitive variables are reordered\n"
+         "as well.")
+    .def("reorderVertices", reorderVertices,
+         "reorderVertices()\n\n"
+         "Sort the vertices by their first use in the faces. Unused vertices\n"
+         "are moved to the end. Varying and vertex variables are reordered\n"
+         "as well.")
+    .def("vertexCacheMissRatio", vertexCacheMissRatio, (arg("cachesize")=16),
+         "vertexCacheMissRatio(cachesize=16) -> float\n\n"
+         "Return the average number of vertex cache misses per face for a\n"
+         "simulated FIFO cache (between 0.5 and 3.0 for typical meshes).")
+
+    .def("decimate", decimate, (arg("target"), arg("targetfaces"), arg("maxerror")=-1.0),
+         "decimate(target, targetfaces, maxerror=-1.0) -> int\n\n"
+         "Store a simplified version of the mesh in target (another TriMeshGeom)\n"
+         "and return its number of faces. Edges are collapsed until the mesh\n"
+         "has at most targetfaces faces or the next collapse would exceed the\n"
+         "quadric error maxerror (negative values disable the bound).\n"
+         "Boundaries and seams of primitive variables are preserved. All\n"
+         "primitive variables are copied to the target mesh.")
+    .def("decimateLODs", decimateLODs, (arg("targets"), arg("facecounts"), arg("maxerror")=-1.0),
+         "decimateLODs(targets, facecounts, maxerror=-1.0)\n\n"
+         "Create several levels of detail in one pass. targets is a sequence of\n"
+         "TriMeshGeoms that receive the results and facecounts contains the\n"
+         "corresponding target face counts (in descending order).")
+
+    .def("getTopology", &TriMeshGeom::getTopology, return_internal_reference<>(),
+         "getTopology() -> MeshTopology\n\n"
+         "Return the half-edge connectivity of the mesh. The topology is cached\n"
+         "and rebuilt on demand after the faces have been modified. Half-edge\n"
+         "3*f+k is corner k of face f.")
+
     .def("intersectRay", intersectRay, (arg("origin"), arg("direction"), arg("earlyexit")=false),
 	 "intersectRay(origin, direction, earlyexit=false) -> (hit, t, faceindex, u, v))\n\n"
 	 "Intersect a ray with the mesh. This method tests a ray with all\n"
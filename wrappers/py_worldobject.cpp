@@ -206,6 +206,12 @@ void class_WorldObject()
 	 "The returned transformation L is calculated as follows: L = T*P^-1\n"
 	 "where T is the current transform (taken from the transform slot)\n"
 	 "and P is the offset transform.")
+
+    .def("getStructureSerial", &WorldObject::getStructureSerial,
+	 "getStructureSerial() -> int\n\n"
+	 "Return the serial number of the last structural change in the\n"
+	 "subtree of this object. The number changes when a children is added\n"
+	 "or removed or a geom or material is set anywhere in the subtree.")
     ;
 
   class_WorldObject2(WorldObject_class);
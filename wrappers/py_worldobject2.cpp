@@ -19,6 +19,8 @@ object _WorldObjectChildIterator::__iter__()
 
 boost::shared_ptr<WorldObject> _WorldObjectChildIterator::next()
 {
+  // The children might have been modified since the last call
+  it.refresh();
   if (it==itend)
   {
     throw StopIteration();
@@ -88,15 +88,24 @@ void class_BoxGeom();
 // py_planegeom
 void class_PlaneGeom();
 
+// py_meshtopology
+void class_MeshTopology();
+
 // py_trimeshgeom
 void class_TriMeshGeom();
 
 // py_polyhedrongeom
 void class_PolyhedronGeom();
 
+// py_subdivisiongeom
+void class_SubdivisionGeom();
+
 // py_drawgeom
 void class_DrawGeom();
 
+// py_lodgeom
+void class_LODGeom();
+
 // py_lightsource
 void class_LightSource();
 
@@ -112,6 +121,30 @@ void class_GLDistantLight();
 // py_glrenderer
 void class_GLRenderInstance();
 
+// py_softrenderer
+void class_SoftRenderer();
+
+// py_texturecache
+void class_TextureCache();
+
+// py_tracing
+void class_Tracer();
+
+// py_animcurveset
+void class_AnimCurveSet();
+
+// py_exprprogram
+void class_ExprProgram();
+
+// py_mocapparser
+void class_MocapParser();
+
+// py_skingeom
+void class_SkinGeom();
+
+// py_beziercurvegeom
+void class_BezierCurveGeom();
+
 
 // rply
 void rply_read();
@@ -145,6 +178,11 @@ void class_IrrCore();
 void class_OsgCore();
 #endif
 
+// offscreen OpenGL context
+#ifdef OFFSCREEN_GL_AVAILABLE
+void class_OffscreenGLContext();
+#endif
+
 /**
  */
 void StopIterationTranslator(const StopIteration& exc) 
@@ -208,6 +246,13 @@ void KeyErrorTranslator(const EKeyError& exc)
   PyErr_SetString(PyExc_KeyError, exc.what()); 
 } 
 
+/**
+ */
+void SyntaxErrorTranslator(const ESyntaxError& exc) 
+{ 
+  PyErr_SetString(PyExc_SyntaxError, exc.what()); 
+} 
+
 /**
  */
 void NotImplementedErrorTranslator(const ENotImplementedError& exc) 
@@ -423,6 +468,7 @@ BOOST_PYTHON_MODULE(_core)
   register_exception_translator<ENoInputConnectionsAllowed>(&NoInputConnectionsAllowedTypesTranslator);
   register_exception_translator<EZeroDivisionError>(&ZeroDivisionErrorTranslator);
   register_exception_translator<ENotImplementedError>(&NotImplementedErrorTranslator);
+  register_exception_translator<ESyntaxError>(&SyntaxErrorTranslator);
   
   // noise
   def_noises();
@@ -479,15 +525,24 @@ BOOST_PYTHON_MODULE(_core)
   // PlaneGeom
   class_PlaneGeom();
 
+  // MeshTopology
+  class_MeshTopology();
+
   // TriMeshGeom
   class_TriMeshGeom();
 
   // PolyhedronGeom
   class_PolyhedronGeom();
 
+  // SubdivisionGeom
+  class_SubdivisionGeom();
+
   // DrawGeom
   class_DrawGeom();
 
+  // LODGeom
+  class_LODGeom();
+
   // LightSource
   class_LightSource();
 
@@ -503,6 +558,30 @@ BOOST_PYTHON_MODULE(_core)
   // GLRenderInstance
   class_GLRenderInstance();
 
+  // SoftRenderer
+  class_SoftRenderer();
+
+  // TextureImage/TextureCache
+  class_TextureCache();
+
+  // Tracer
+  class_Tracer();
+
+  // AnimCurveSet
+  class_AnimCurveSet();
+
+  // ExprProgram
+  class_ExprProgram();
+
+  // Motion capture parsers
+  class_MocapParser();
+
+  // SkinGeom
+  class_SkinGeom();
+
+  // BezierCurveGeom
+  class_BezierCurveGeom();
+
   // MassProperties
   class_MassProperties();
 
@@ -534,6 +613,10 @@ BOOST_PYTHON_MODULE(_core)
   class_OsgCore();
   #endif
 
+  #ifdef OFFSCREEN_GL_AVAILABLE
+  class_OffscreenGLContext();
+  #endif
+
   // Type conversion
   vec3_from_sequence();
   vec4_from_sequence();